@@ -0,0 +1,458 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef FOSSIL_TOOL_BITMAP_H
+#define FOSSIL_TOOL_BITMAP_H
+
+/**
+ * @brief Containers for large sets of bits.
+ *
+ * This file provides two containers built on the 64-bit helpers in bitwise.h:
+ *
+ *  - fossil_bitset_t, a dynamic uncompressed bitset addressed by bit index.
+ *  - fossil_bitmap_t, a Roaring-style compressed bitmap of 32-bit values. The
+ *    value space is split into chunks of 2^16 values, and each chunk is stored
+ *    in whichever container is smallest for its contents: a sorted array of
+ *    16-bit values, a 65536-bit bitset, or a list of runs.
+ *
+ * Both containers support set algebra (AND, OR, XOR, ANDNOT), population
+ * count, rank/select and iteration. Word-wise operations use AVX2 or SSE2
+ * when the compiler targets them. The compressed bitmap can be serialized to
+ * a portable little-endian byte buffer and read back.
+ *
+ * Usage:
+ *  1. Include "fossil/core/bitmap.h" in your source code.
+ *  2. Create a container, add values, combine containers, then erase them.
+ *
+ * Example:
+ * ```c
+ * #include "fossil/core/bitmap.h"
+ * #include <stdio.h>
+ *
+ * int main() {
+ *     fossil_bitmap_t *docs_a = fossil_bitmap_create();
+ *     fossil_bitmap_t *docs_b = fossil_bitmap_create();
+ *     fossil_bitmap_add_range(docs_a, 0, 999999);
+ *     fossil_bitmap_add(docs_b, 42);
+ *     fossil_bitmap_add(docs_b, 2000000);
+ *
+ *     fossil_bitmap_t *both = fossil_bitmap_and(docs_a, docs_b);
+ *     printf("Matches: %llu\n", (unsigned long long)fossil_bitmap_cardinality(both));
+ *
+ *     fossil_bitmap_erase(both);
+ *     fossil_bitmap_erase(docs_b);
+ *     fossil_bitmap_erase(docs_a);
+ *     return 0;
+ * }
+ * ```
+ *
+ */
+
+#include "fossil/common/common.h"
+#include "fossil/core/bitwise.h"
+#include <stdbool.h>
+
+// Number of values covered by one compressed bitmap container (2^16).
+#define FOSSIL_BITMAP_CHUNK_BITS 65536
+
+// Number of 64-bit words in a bitset container.
+#define FOSSIL_BITMAP_CHUNK_WORDS 1024
+
+// Largest cardinality stored as a sorted array before promotion to a bitset.
+#define FOSSIL_BITMAP_ARRAY_MAX 4096
+
+// Dynamic uncompressed bitset
+typedef struct {
+    bitwise64 *words;
+    size_t size;     // Number of addressable bits
+    size_t capacity; // Number of allocated 64-bit words
+} fossil_bitset_t;
+
+// Storage kind of a compressed bitmap container
+typedef enum {
+    FOSSIL_BITMAP_ARRAY,
+    FOSSIL_BITMAP_BITSET,
+    FOSSIL_BITMAP_RUN
+} fossil_bitmap_kind_t;
+
+// Run of consecutive values [start, start + length]
+typedef struct {
+    uint16_t start;
+    uint16_t length;
+} fossil_bitmap_run_t;
+
+// Container for the values sharing the same upper 16 bits
+typedef struct {
+    uint16_t key;
+    fossil_bitmap_kind_t kind;
+    uint32_t cardinality;
+    uint32_t size;     // Used array values or runs
+    uint32_t capacity; // Allocated array values or runs
+    union {
+        uint16_t *array;
+        bitwise64 *bitset;
+        fossil_bitmap_run_t *runs;
+    } data;
+} fossil_bitmap_container_t;
+
+// Compressed bitmap, containers sorted by key
+typedef struct {
+    fossil_bitmap_container_t *containers;
+    size_t size;
+    size_t capacity;
+} fossil_bitmap_t;
+
+// Forward iterator over the values of a compressed bitmap
+typedef struct {
+    const fossil_bitmap_t *bitmap;
+    size_t container;
+    uint32_t position;
+    uint32_t offset;
+} fossil_bitmap_iterator_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// =================================================================
+// Bitset functions
+// =================================================================
+
+/**
+ * Create a new bitset with the given number of cleared bits.
+ *
+ * @param size The initial number of bits.
+ * @return     The created bitset, or NULL on allocation failure.
+ */
+fossil_bitset_t* fossil_bitset_create(size_t size);
+
+/**
+ * Erase the bitset and free allocated memory.
+ *
+ * @param bitset The bitset to erase.
+ */
+void fossil_bitset_erase(fossil_bitset_t* bitset);
+
+/**
+ * Resize the bitset. New bits are cleared; bits past the new size are dropped.
+ *
+ * @param bitset The bitset to resize.
+ * @param size   The new number of bits.
+ * @return       0 on success, -1 on allocation failure.
+ */
+int32_t fossil_bitset_resize(fossil_bitset_t* bitset, size_t size);
+
+/**
+ * Set a bit, growing the bitset if the index is past its size.
+ *
+ * @param bitset The bitset to modify.
+ * @param index  The bit to set.
+ * @return       0 on success, -1 on allocation failure.
+ */
+int32_t fossil_bitset_set(fossil_bitset_t* bitset, size_t index);
+
+/**
+ * Clear a bit. Indices past the size are ignored.
+ *
+ * @param bitset The bitset to modify.
+ * @param index  The bit to clear.
+ */
+void fossil_bitset_clear(fossil_bitset_t* bitset, size_t index);
+
+/**
+ * Check whether a bit is set.
+ *
+ * @param bitset The bitset to check.
+ * @param index  The bit to check.
+ * @return       True if the bit is set, false otherwise.
+ */
+bool fossil_bitset_test(const fossil_bitset_t* bitset, size_t index);
+
+/**
+ * Clear every bit while keeping the size.
+ *
+ * @param bitset The bitset to reset.
+ */
+void fossil_bitset_reset(fossil_bitset_t* bitset);
+
+/**
+ * Count the set bits.
+ *
+ * @param bitset The bitset to count.
+ * @return       The number of set bits.
+ */
+size_t fossil_bitset_count(const fossil_bitset_t* bitset);
+
+/**
+ * Intersect dst with src in place.
+ *
+ * @param dst The bitset to modify.
+ * @param src The other operand.
+ * @return    0 on success, -1 on error.
+ */
+int32_t fossil_bitset_and(fossil_bitset_t* dst, const fossil_bitset_t* src);
+
+/**
+ * Union src into dst in place, growing dst to the size of src if needed.
+ *
+ * @param dst The bitset to modify.
+ * @param src The other operand.
+ * @return    0 on success, -1 on error.
+ */
+int32_t fossil_bitset_or(fossil_bitset_t* dst, const fossil_bitset_t* src);
+
+/**
+ * Symmetric difference of dst and src in place, growing dst if needed.
+ *
+ * @param dst The bitset to modify.
+ * @param src The other operand.
+ * @return    0 on success, -1 on error.
+ */
+int32_t fossil_bitset_xor(fossil_bitset_t* dst, const fossil_bitset_t* src);
+
+/**
+ * Remove the bits of src from dst in place.
+ *
+ * @param dst The bitset to modify.
+ * @param src The other operand.
+ * @return    0 on success, -1 on error.
+ */
+int32_t fossil_bitset_andnot(fossil_bitset_t* dst, const fossil_bitset_t* src);
+
+/**
+ * Count the set bits strictly below an index.
+ *
+ * @param bitset The bitset to query.
+ * @param index  The exclusive upper bound.
+ * @return       The number of set bits in [0, index).
+ */
+size_t fossil_bitset_rank(const fossil_bitset_t* bitset, size_t index);
+
+/**
+ * Find the index of the k-th set bit (0-based).
+ *
+ * @param bitset     The bitset to query.
+ * @param k          The rank of the bit to find.
+ * @param[out] index Receives the bit index.
+ * @return           True if found, false if fewer than k + 1 bits are set.
+ */
+bool fossil_bitset_select(const fossil_bitset_t* bitset, size_t k, size_t* index);
+
+/**
+ * Find the first set bit at or after a position. Used for iteration.
+ *
+ * @param bitset     The bitset to scan.
+ * @param from       The first index to consider.
+ * @param[out] index Receives the bit index.
+ * @return           True if a set bit was found, false otherwise.
+ */
+bool fossil_bitset_next(const fossil_bitset_t* bitset, size_t from, size_t* index);
+
+// =================================================================
+// Compressed bitmap functions
+// =================================================================
+
+/**
+ * Create a new empty compressed bitmap.
+ *
+ * @return The created bitmap, or NULL on allocation failure.
+ */
+fossil_bitmap_t* fossil_bitmap_create(void);
+
+/**
+ * Erase the bitmap and free allocated memory.
+ *
+ * @param bitmap The bitmap to erase.
+ */
+void fossil_bitmap_erase(fossil_bitmap_t* bitmap);
+
+/**
+ * Remove every value from the bitmap.
+ *
+ * @param bitmap The bitmap to clear.
+ */
+void fossil_bitmap_clear(fossil_bitmap_t* bitmap);
+
+/**
+ * Create a deep copy of a bitmap.
+ *
+ * @param bitmap The bitmap to copy.
+ * @return       The copy, or NULL on allocation failure.
+ */
+fossil_bitmap_t* fossil_bitmap_copy(const fossil_bitmap_t* bitmap);
+
+/**
+ * Add a value to the bitmap.
+ *
+ * @param bitmap The bitmap to modify.
+ * @param value  The value to add.
+ * @return       0 on success, -1 on allocation failure.
+ */
+int32_t fossil_bitmap_add(fossil_bitmap_t* bitmap, uint32_t value);
+
+/**
+ * Add every value in [min, max] to the bitmap. Full chunks are stored as runs.
+ *
+ * @param bitmap The bitmap to modify.
+ * @param min    The first value to add.
+ * @param max    The last value to add.
+ * @return       0 on success, -1 on error.
+ */
+int32_t fossil_bitmap_add_range(fossil_bitmap_t* bitmap, uint32_t min, uint32_t max);
+
+/**
+ * Remove a value from the bitmap.
+ *
+ * @param bitmap The bitmap to modify.
+ * @param value  The value to remove.
+ * @return       0 if the value was removed, -1 if it was not present.
+ */
+int32_t fossil_bitmap_remove(fossil_bitmap_t* bitmap, uint32_t value);
+
+/**
+ * Check whether a value is in the bitmap.
+ *
+ * @param bitmap The bitmap to check.
+ * @param value  The value to look for.
+ * @return       True if present, false otherwise.
+ */
+bool fossil_bitmap_contains(const fossil_bitmap_t* bitmap, uint32_t value);
+
+/**
+ * Get the number of values in the bitmap.
+ *
+ * @param bitmap The bitmap to count.
+ * @return       The number of values.
+ */
+uint64_t fossil_bitmap_cardinality(const fossil_bitmap_t* bitmap);
+
+/**
+ * Check whether two bitmaps hold the same values.
+ *
+ * @param a The first bitmap.
+ * @param b The second bitmap.
+ * @return  True if equal, false otherwise.
+ */
+bool fossil_bitmap_equals(const fossil_bitmap_t* a, const fossil_bitmap_t* b);
+
+/**
+ * Convert each container to run storage where that is the smallest encoding.
+ *
+ * @param bitmap The bitmap to compact.
+ */
+void fossil_bitmap_run_optimize(fossil_bitmap_t* bitmap);
+
+/**
+ * Compute the intersection of two bitmaps.
+ *
+ * @param a The first operand.
+ * @param b The second operand.
+ * @return  A new bitmap, or NULL on allocation failure.
+ */
+fossil_bitmap_t* fossil_bitmap_and(const fossil_bitmap_t* a, const fossil_bitmap_t* b);
+
+/**
+ * Compute the union of two bitmaps.
+ *
+ * @param a The first operand.
+ * @param b The second operand.
+ * @return  A new bitmap, or NULL on allocation failure.
+ */
+fossil_bitmap_t* fossil_bitmap_or(const fossil_bitmap_t* a, const fossil_bitmap_t* b);
+
+/**
+ * Compute the symmetric difference of two bitmaps.
+ *
+ * @param a The first operand.
+ * @param b The second operand.
+ * @return  A new bitmap, or NULL on allocation failure.
+ */
+fossil_bitmap_t* fossil_bitmap_xor(const fossil_bitmap_t* a, const fossil_bitmap_t* b);
+
+/**
+ * Compute the values of a that are not in b.
+ *
+ * @param a The first operand.
+ * @param b The second operand.
+ * @return  A new bitmap, or NULL on allocation failure.
+ */
+fossil_bitmap_t* fossil_bitmap_andnot(const fossil_bitmap_t* a, const fossil_bitmap_t* b);
+
+/**
+ * Count the values less than or equal to a value.
+ *
+ * @param bitmap The bitmap to query.
+ * @param value  The inclusive upper bound.
+ * @return       The number of values <= value.
+ */
+uint64_t fossil_bitmap_rank(const fossil_bitmap_t* bitmap, uint32_t value);
+
+/**
+ * Find the k-th smallest value (0-based).
+ *
+ * @param bitmap     The bitmap to query.
+ * @param k          The rank of the value to find.
+ * @param[out] value Receives the value.
+ * @return           True if found, false if the bitmap holds k or fewer values.
+ */
+bool fossil_bitmap_select(const fossil_bitmap_t* bitmap, uint64_t k, uint32_t* value);
+
+/**
+ * Create an iterator positioned before the smallest value.
+ *
+ * @param bitmap The bitmap to iterate.
+ * @return       The iterator.
+ */
+fossil_bitmap_iterator_t fossil_bitmap_iterator_create(const fossil_bitmap_t* bitmap);
+
+/**
+ * Advance the iterator in ascending order.
+ *
+ * @param iterator   The iterator to advance.
+ * @param[out] value Receives the next value.
+ * @return           True if a value was produced, false at the end.
+ */
+bool fossil_bitmap_iterator_next(fossil_bitmap_iterator_t* iterator, uint32_t* value);
+
+/**
+ * Get the number of bytes fossil_bitmap_serialize will write.
+ *
+ * @param bitmap The bitmap to measure.
+ * @return       The serialized size in bytes.
+ */
+size_t fossil_bitmap_serialized_size(const fossil_bitmap_t* bitmap);
+
+/**
+ * Serialize the bitmap into a little-endian byte buffer.
+ *
+ * @param bitmap   The bitmap to serialize.
+ * @param buffer   The destination buffer.
+ * @param capacity The size of the destination buffer.
+ * @return         The number of bytes written, or 0 if the buffer is too small.
+ */
+size_t fossil_bitmap_serialize(const fossil_bitmap_t* bitmap, void* buffer, size_t capacity);
+
+/**
+ * Rebuild a bitmap from a buffer written by fossil_bitmap_serialize.
+ *
+ * @param buffer The source buffer.
+ * @param length The size of the source buffer.
+ * @return       The bitmap, or NULL if the buffer is malformed.
+ */
+fossil_bitmap_t* fossil_bitmap_deserialize(const void* buffer, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
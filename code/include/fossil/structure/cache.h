@@ -0,0 +1,350 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef FOSSIL_STRUCTURES_CACHE_H
+#define FOSSIL_STRUCTURES_CACHE_H
+
+/**
+ * @brief Cache Data Structure
+ *
+ * This library provides functions for working with fixed-capacity caches of tofu key-value
+ * pairs. Entries live in a preallocated slab indexed by an open-addressing hash table, so
+ * get, put and evict are O(1) and never allocate after creation.
+ *
+ * The replacement policy is LRU, CLOCK (second chance, a hit only sets a bit) or ARC, which
+ * balances recency against frequency using ghost lists of recently evicted keys. The ghost
+ * lists keep only key hashes, so keys may be freed as soon as they are evicted.
+ *
+ * Besides the entry capacity, a cache can enforce a byte budget measured by a size callback.
+ * An evict callback sees every pair that leaves the cache through eviction, replacement,
+ * clear or erase, which is where owned keys and values should be released.
+ *
+ * fossil_cache_sharded_t spreads keys over independently locked caches for use from
+ * several threads. Callbacks run while the shard lock is held.
+ *
+ * @defgroup create_delete CREATE and DELETE
+ * @defgroup insert_erase Insert and Erase Functions
+ * @defgroup lookup Lookup Functions
+ * @defgroup capacity Capacity Functions
+ * @defgroup utility Utility Functions
+ */
+
+#include "fossil/generic/tofu.h"
+
+// Replacement policy of a cache
+typedef enum {
+    FOSSIL_CACHE_LRU,   // Evict the least recently used entry
+    FOSSIL_CACHE_CLOCK, // Evict the oldest entry not used since the hand last passed
+    FOSSIL_CACHE_ARC    // Adaptive replacement between recency and frequency lists
+} fossil_cache_policy_t;
+
+// Measures the bytes a pair charges against the byte budget
+typedef size_t (*fossil_cache_size_fn)(fossil_tofu_t key, fossil_tofu_t value, void* user_data);
+
+// Called for each pair that leaves the cache
+typedef void (*fossil_cache_evict_fn)(fossil_tofu_t key, fossil_tofu_t value, void* user_data);
+
+// Cache statistics
+typedef struct fossil_cache_stats_t {
+    size_t hits;       // Lookups that found the key
+    size_t misses;     // Lookups that did not find the key
+    size_t insertions; // Puts that added a new key
+    size_t evictions;  // Pairs pushed out by capacity or byte budget
+} fossil_cache_stats_t;
+
+// Entry in the cache slab
+typedef struct fossil_cache_entry_t fossil_cache_entry_t;
+
+// Doubly linked list of slab entries, head first
+typedef struct fossil_cache_list_t {
+    uint32_t head;
+    uint32_t tail;
+    size_t count;
+} fossil_cache_list_t;
+
+// Cache structure
+typedef struct fossil_cache_t {
+    fossil_cache_entry_t* entries;    // Slab of capacity entries, twice that for ARC ghosts
+    uint32_t* table;                  // Open-addressing table of entry indices
+    size_t table_mask;                // Table size minus one
+    uint32_t free_head;               // First unused slab entry
+    fossil_cache_list_t lists[4];     // Resident lists, then ARC ghost lists
+    fossil_cache_policy_t policy;
+    size_t capacity;                  // Maximum number of resident entries
+    size_t target;                    // ARC target size of the recency list
+    size_t bytes;                     // Bytes charged by resident entries
+    size_t max_bytes;                 // Byte budget, 0 for none
+    fossil_cache_size_fn size_fn;
+    void* size_data;
+    fossil_cache_evict_fn evict_fn;
+    void* evict_data;
+    fossil_cache_stats_t stats;
+    char* type;
+} fossil_cache_t;
+
+// Shard of a sharded cache
+typedef struct fossil_cache_shard_t fossil_cache_shard_t;
+
+// Thread-safe cache split into independently locked shards
+typedef struct fossil_cache_sharded_t {
+    fossil_cache_shard_t* shards;
+    size_t shard_count; // Power of two
+    char* type;
+} fossil_cache_sharded_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * Create a new cache with the specified key type, policy and capacity.
+ *
+ * @param type     The type of key the cache will store.
+ * @param policy   The replacement policy.
+ * @param capacity The maximum number of entries, at least 1.
+ * @return         The created cache, or NULL on allocation failure or invalid capacity.
+ */
+fossil_cache_t* fossil_cache_create(char* type, fossil_cache_policy_t policy, size_t capacity);
+
+/**
+ * Erase the cache and free allocated memory. The evict callback sees every remaining pair.
+ *
+ * @param cache The cache to erase.
+ */
+void fossil_cache_erase(fossil_cache_t* cache);
+
+/**
+ * Set a byte budget. Entries are evicted until the charged bytes fit the budget.
+ *
+ * @param cache     The cache to configure.
+ * @param max_bytes The byte budget, or 0 to disable it.
+ * @param size_fn   The callback that measures a pair.
+ * @param user_data User data passed to the callback.
+ * @return          0 on success, -1 if a budget is given without a callback.
+ */
+int32_t fossil_cache_set_budget(fossil_cache_t* cache, size_t max_bytes, fossil_cache_size_fn size_fn, void* user_data);
+
+/**
+ * Set the callback that sees pairs leaving the cache.
+ *
+ * @param cache     The cache to configure.
+ * @param evict_fn  The callback, or NULL to remove it.
+ * @param user_data User data passed to the callback.
+ */
+void fossil_cache_set_evict_callback(fossil_cache_t* cache, fossil_cache_evict_fn evict_fn, void* user_data);
+
+/**
+ * Insert a pair, replacing the value if the key is already cached.
+ *
+ * @param cache The cache to insert into.
+ * @param key   The key.
+ * @param value The value.
+ * @return      0 on success, -1 if the pair alone exceeds the byte budget.
+ */
+int32_t fossil_cache_put(fossil_cache_t* cache, fossil_tofu_t key, fossil_tofu_t value);
+
+/**
+ * Look up a key, marking it as used and counting a hit or miss.
+ *
+ * @param cache The cache to search.
+ * @param key   The key to look up.
+ * @return      A pointer to the cached value, valid until the next put, or NULL on a miss.
+ */
+fossil_tofu_t* fossil_cache_getter(fossil_cache_t* cache, fossil_tofu_t key);
+
+/**
+ * Check if a key is cached without marking it as used.
+ *
+ * @param cache The cache to check.
+ * @param key   The key to look for.
+ * @return      True if cached, false otherwise.
+ */
+bool fossil_cache_contains(const fossil_cache_t* cache, fossil_tofu_t key);
+
+/**
+ * Remove a key and hand its pair back to the caller instead of the evict callback.
+ *
+ * @param cache The cache to remove from.
+ * @param key   The key to remove.
+ * @param value A pointer to store the removed value, or NULL.
+ * @return      0 on success, -1 if the key was not cached.
+ */
+int32_t fossil_cache_remove(fossil_cache_t* cache, fossil_tofu_t key, fossil_tofu_t* value);
+
+/**
+ * Remove every entry and forget the ARC history. The evict callback sees every pair.
+ *
+ * @param cache The cache to clear.
+ */
+void fossil_cache_clear(fossil_cache_t* cache);
+
+/**
+ * Get the number of cached entries.
+ *
+ * @param cache The cache for which to get the size.
+ * @return      The number of entries.
+ */
+size_t fossil_cache_size(const fossil_cache_t* cache);
+
+/**
+ * Get the bytes charged against the byte budget.
+ *
+ * @param cache The cache to inspect.
+ * @return      The charged bytes.
+ */
+size_t fossil_cache_bytes(const fossil_cache_t* cache);
+
+/**
+ * Get the hit, miss, insertion and eviction counters.
+ *
+ * @param cache The cache to inspect.
+ * @return      The statistics.
+ */
+fossil_cache_stats_t fossil_cache_stats(const fossil_cache_t* cache);
+
+/**
+ * Reset the statistics counters to zero.
+ *
+ * @param cache The cache to reset.
+ */
+void fossil_cache_reset_stats(fossil_cache_t* cache);
+
+/**
+ * Hash a tofu consistently with fossil_tofu_equals.
+ *
+ * @param key The tofu to hash.
+ * @return    The hash.
+ */
+uint64_t fossil_cache_hash(fossil_tofu_t key);
+
+/**
+ * Check if the cache is not empty.
+ *
+ * @param cache The cache to check.
+ * @return      True if the cache is not empty, false otherwise.
+ */
+bool fossil_cache_not_empty(const fossil_cache_t* cache);
+
+/**
+ * Check if the cache is not a null pointer.
+ *
+ * @param cache The cache to check.
+ * @return      True if the cache is not a null pointer, false otherwise.
+ */
+bool fossil_cache_not_cnullptr(const fossil_cache_t* cache);
+
+/**
+ * Check if the cache is empty.
+ *
+ * @param cache The cache to check.
+ * @return      True if the cache is empty, false otherwise.
+ */
+bool fossil_cache_is_empty(const fossil_cache_t* cache);
+
+/**
+ * Check if the cache is a null pointer.
+ *
+ * @param cache The cache to check.
+ * @return      True if the cache is a null pointer, false otherwise.
+ */
+bool fossil_cache_is_cnullptr(const fossil_cache_t* cache);
+
+/**
+ * Create a sharded cache. The capacity is split evenly across the shards.
+ *
+ * @param type        The type of key the cache will store.
+ * @param policy      The replacement policy of every shard.
+ * @param capacity    The total number of entries.
+ * @param shard_count The number of shards, rounded up to a power of two.
+ * @return            The created cache, or NULL on allocation failure or invalid sizes.
+ */
+fossil_cache_sharded_t* fossil_cache_sharded_create(char* type, fossil_cache_policy_t policy, size_t capacity, size_t shard_count);
+
+/**
+ * Erase the sharded cache and free allocated memory.
+ *
+ * @param cache The sharded cache to erase.
+ */
+void fossil_cache_sharded_erase(fossil_cache_sharded_t* cache);
+
+/**
+ * Set a byte budget, split evenly across the shards.
+ *
+ * @param cache     The sharded cache to configure.
+ * @param max_bytes The total byte budget, or 0 to disable it.
+ * @param size_fn   The callback that measures a pair.
+ * @param user_data User data passed to the callback.
+ * @return          0 on success, -1 if a budget is given without a callback.
+ */
+int32_t fossil_cache_sharded_set_budget(fossil_cache_sharded_t* cache, size_t max_bytes, fossil_cache_size_fn size_fn, void* user_data);
+
+/**
+ * Set the callback that sees pairs leaving any shard.
+ *
+ * @param cache     The sharded cache to configure.
+ * @param evict_fn  The callback, or NULL to remove it.
+ * @param user_data User data passed to the callback.
+ */
+void fossil_cache_sharded_set_evict_callback(fossil_cache_sharded_t* cache, fossil_cache_evict_fn evict_fn, void* user_data);
+
+/**
+ * Insert a pair, replacing the value if the key is already cached.
+ *
+ * @param cache The sharded cache to insert into.
+ * @param key   The key.
+ * @param value The value.
+ * @return      0 on success, -1 if the pair alone exceeds the shard byte budget.
+ */
+int32_t fossil_cache_sharded_put(fossil_cache_sharded_t* cache, fossil_tofu_t key, fossil_tofu_t value);
+
+/**
+ * Look up a key and copy its value out under the shard lock.
+ *
+ * @param cache The sharded cache to search.
+ * @param key   The key to look up.
+ * @param value A pointer to store the value.
+ * @return      0 on a hit, -1 on a miss.
+ */
+int32_t fossil_cache_sharded_get(fossil_cache_sharded_t* cache, fossil_tofu_t key, fossil_tofu_t* value);
+
+/**
+ * Remove a key and hand its pair back to the caller.
+ *
+ * @param cache The sharded cache to remove from.
+ * @param key   The key to remove.
+ * @param value A pointer to store the removed value, or NULL.
+ * @return      0 on success, -1 if the key was not cached.
+ */
+int32_t fossil_cache_sharded_remove(fossil_cache_sharded_t* cache, fossil_tofu_t key, fossil_tofu_t* value);
+
+/**
+ * Get the number of cached entries across all shards.
+ *
+ * @param cache The sharded cache for which to get the size.
+ * @return      The number of entries.
+ */
+size_t fossil_cache_sharded_size(fossil_cache_sharded_t* cache);
+
+/**
+ * Get the statistics summed across all shards.
+ *
+ * @param cache The sharded cache to inspect.
+ * @return      The statistics.
+ */
+fossil_cache_stats_t fossil_cache_sharded_stats(fossil_cache_sharded_t* cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
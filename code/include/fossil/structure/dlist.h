@@ -20,12 +20,17 @@ Description:
  * Doubly linked lists are a type of linked list where each node contains
  * pointers to both the next and previous nodes.
  *
+ * Lists made with fossil_dlist_create_unrolled store up to FOSSIL_DLIST_BLOCK_SIZE elements per
+ * node, so scans walk contiguous memory instead of chasing one pointer per element. Interior
+ * inserts split full blocks and removals merge underfull neighbours.
+ *
  * @defgroup create_delete CREATE and DELETE
  * @defgroup algorithm Algorithm Functions
  * @defgroup utility Utility Functions
  */
 
 #include "fossil/generic/tofu.h"
+#include "fossil/generic/iterator.h"
 #include "fossil/generic/actionof.h"
 
 // Node structure for the doubly linked list
@@ -35,13 +40,36 @@ typedef struct fossil_dlist_node_t {
     struct fossil_dlist_node_t* next;
 } fossil_dlist_node_t;
 
+// Number of elements stored per block in unrolled mode
+#define FOSSIL_DLIST_BLOCK_SIZE 16
+
+// Block structure for the unrolled doubly linked list
+typedef struct fossil_dlist_block_t {
+    fossil_tofu_t data[FOSSIL_DLIST_BLOCK_SIZE];
+    size_t count;
+    struct fossil_dlist_block_t* prev;
+    struct fossil_dlist_block_t* next;
+} fossil_dlist_block_t;
+
 // Doubly linked list structure
 typedef struct fossil_dlist_t {
     fossil_dlist_node_t* head;
     fossil_dlist_node_t* tail;
+    fossil_dlist_block_t* head_block;  // Unrolled storage, first block
+    fossil_dlist_block_t* tail_block;  // Unrolled storage, last block
+    size_t size;                       // Element count in unrolled mode
+    bool unrolled;
     char* type;
 } fossil_dlist_t;
 
+// Cursor over the elements of a doubly linked list
+typedef struct fossil_dlist_cursor_t {
+    fossil_dlist_t* dlist;
+    fossil_dlist_node_t* node;   // Current node (node mode), null at the end
+    fossil_dlist_block_t* block; // Current block (unrolled mode), null at the end
+    size_t offset;               // Element offset within the block
+} fossil_dlist_cursor_t;
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -55,6 +83,14 @@ extern "C"
  */
 fossil_dlist_t* fossil_dlist_create(char* type);
 
+/**
+ * Create a new doubly linked list that stores its elements in unrolled blocks.
+ *
+ * @param type The type of data the doubly linked list will store.
+ * @return     The created doubly linked list.
+ */
+fossil_dlist_t* fossil_dlist_create_unrolled(char* type);
+
 /**
  * Erase the contents of the doubly linked list and free allocated memory.
  *
@@ -71,6 +107,26 @@ void fossil_dlist_erase(fossil_dlist_t* dlist);
  */
 int32_t fossil_dlist_insert(fossil_dlist_t* dlist, fossil_tofu_t data);
 
+/**
+ * Insert data at the specified position, counted from the head.
+ *
+ * @param dlist The doubly linked list to insert data into.
+ * @param index The position to insert at, from 0 to the size of the list.
+ * @param data  The data to insert.
+ * @return      0 on success, -1 if the position is out of range or allocation failed.
+ */
+int32_t fossil_dlist_insert_at(fossil_dlist_t* dlist, size_t index, fossil_tofu_t data);
+
+/**
+ * Remove the data at the specified position, counted from the head.
+ *
+ * @param dlist The doubly linked list to remove data from.
+ * @param index The position to remove.
+ * @param data  A pointer to store the removed data.
+ * @return      0 on success, -1 if the position is out of range.
+ */
+int32_t fossil_dlist_remove_at(fossil_dlist_t* dlist, size_t index, fossil_tofu_t* data);
+
 /**
  * Remove data from the doubly linked list.
  *
@@ -161,6 +217,79 @@ bool fossil_dlist_is_empty(const fossil_dlist_t* dlist);
  */
 bool fossil_dlist_is_cnullptr(const fossil_dlist_t* dlist);
 
+/**
+ * Get a cursor at the head element of the doubly linked list.
+ *
+ * @param dlist The doubly linked list to walk.
+ * @return      A cursor at the head element, or at the end if the doubly linked list is empty.
+ */
+fossil_dlist_cursor_t fossil_dlist_cursor_begin(fossil_dlist_t* dlist);
+
+/**
+ * Get a cursor past the last element of the doubly linked list.
+ *
+ * @param dlist The doubly linked list to walk.
+ * @return      A cursor at the end.
+ */
+fossil_dlist_cursor_t fossil_dlist_cursor_end(fossil_dlist_t* dlist);
+
+/**
+ * Check if the cursor is at an element rather than at the end.
+ *
+ * @param cursor The cursor to check.
+ * @return       True if the cursor can be dereferenced, false otherwise.
+ */
+bool fossil_dlist_cursor_valid(const fossil_dlist_cursor_t* cursor);
+
+/**
+ * Move the cursor to the next element. A cursor at the end stays there.
+ *
+ * @param cursor The cursor to move.
+ */
+void fossil_dlist_cursor_next(fossil_dlist_cursor_t* cursor);
+
+/**
+ * Move the cursor to the previous element. From the end it moves to the last element,
+ * and from the head element it moves to the end.
+ *
+ * @param cursor The cursor to move.
+ */
+void fossil_dlist_cursor_prev(fossil_dlist_cursor_t* cursor);
+
+/**
+ * Get the element at the cursor.
+ *
+ * @param cursor The cursor to dereference.
+ * @return       A pointer to the element, or NULL at the end.
+ */
+fossil_tofu_t* fossil_dlist_cursor_deref(const fossil_dlist_cursor_t* cursor);
+
+/**
+ * Insert data after the element at the cursor. The cursor stays on its element.
+ *
+ * @param cursor The cursor to insert after.
+ * @param data   The data to insert.
+ * @return       0 on success, -1 at the end or if allocation failed.
+ */
+int32_t fossil_dlist_cursor_insert_after(fossil_dlist_cursor_t* cursor, fossil_tofu_t data);
+
+/**
+ * Remove the element at the cursor and move the cursor to the element that followed it.
+ *
+ * @param cursor The cursor to erase at.
+ * @param data   A pointer to store the removed data.
+ * @return       0 on success, -1 at the end.
+ */
+int32_t fossil_dlist_cursor_erase(fossil_dlist_cursor_t* cursor, fossil_tofu_t* data);
+
+/**
+ * Get the contiguous run of elements starting at the cursor as a tofu iterator.
+ *
+ * @param cursor The cursor to start from.
+ * @return       An iterator over the run, empty at the end.
+ */
+fossil_tofu_iteratorof_t fossil_dlist_cursor_span(const fossil_dlist_cursor_t* cursor);
+
 #ifdef __cplusplus
 }
 #endif
@@ -27,6 +27,7 @@ Description:
  */
 
 #include "fossil/generic/tofu.h"
+#include "fossil/generic/iterator.h"
 #include "fossil/generic/actionof.h"
 
 // Node structure for the double-ended queue
@@ -43,6 +44,12 @@ typedef struct fossil_dqueue_t {
     char *type;
 } fossil_dqueue_t;
 
+// Cursor over the elements of a double-ended queue
+typedef struct fossil_dqueue_cursor_t {
+    fossil_dqueue_t* dqueue;
+    fossil_dqueue_node_t* node; // Current node, null at the end
+} fossil_dqueue_cursor_t;
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -148,6 +155,79 @@ bool fossil_dqueue_is_empty(const fossil_dqueue_t* dqueue);
  */
 bool fossil_dqueue_is_cnullptr(const fossil_dqueue_t* dqueue);
 
+/**
+ * Get a cursor at the front element of the double-ended queue.
+ *
+ * @param dqueue The double-ended queue to walk.
+ * @return       A cursor at the front element, or at the end if the double-ended queue is empty.
+ */
+fossil_dqueue_cursor_t fossil_dqueue_cursor_begin(fossil_dqueue_t* dqueue);
+
+/**
+ * Get a cursor past the last element of the double-ended queue.
+ *
+ * @param dqueue The double-ended queue to walk.
+ * @return       A cursor at the end.
+ */
+fossil_dqueue_cursor_t fossil_dqueue_cursor_end(fossil_dqueue_t* dqueue);
+
+/**
+ * Check if the cursor is at an element rather than at the end.
+ *
+ * @param cursor The cursor to check.
+ * @return       True if the cursor can be dereferenced, false otherwise.
+ */
+bool fossil_dqueue_cursor_valid(const fossil_dqueue_cursor_t* cursor);
+
+/**
+ * Move the cursor to the next element. A cursor at the end stays there.
+ *
+ * @param cursor The cursor to move.
+ */
+void fossil_dqueue_cursor_next(fossil_dqueue_cursor_t* cursor);
+
+/**
+ * Move the cursor to the previous element. From the end it moves to the last element,
+ * and from the front element it moves to the end.
+ *
+ * @param cursor The cursor to move.
+ */
+void fossil_dqueue_cursor_prev(fossil_dqueue_cursor_t* cursor);
+
+/**
+ * Get the element at the cursor.
+ *
+ * @param cursor The cursor to dereference.
+ * @return       A pointer to the element, or NULL at the end.
+ */
+fossil_tofu_t* fossil_dqueue_cursor_deref(const fossil_dqueue_cursor_t* cursor);
+
+/**
+ * Insert data after the element at the cursor. The cursor stays on its element.
+ *
+ * @param cursor The cursor to insert after.
+ * @param data   The data to insert.
+ * @return       0 on success, -1 at the end or if allocation failed.
+ */
+int32_t fossil_dqueue_cursor_insert_after(fossil_dqueue_cursor_t* cursor, fossil_tofu_t data);
+
+/**
+ * Remove the element at the cursor and move the cursor to the element that followed it.
+ *
+ * @param cursor The cursor to erase at.
+ * @param data   A pointer to store the removed data.
+ * @return       0 on success, -1 at the end.
+ */
+int32_t fossil_dqueue_cursor_erase(fossil_dqueue_cursor_t* cursor, fossil_tofu_t* data);
+
+/**
+ * Get the contiguous run of elements starting at the cursor as a tofu iterator.
+ *
+ * @param cursor The cursor to start from.
+ * @return       An iterator over the run, empty at the end.
+ */
+fossil_tofu_iteratorof_t fossil_dqueue_cursor_span(const fossil_dqueue_cursor_t* cursor);
+
 #ifdef __cplusplus
 }
 #endif
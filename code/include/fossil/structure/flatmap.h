@@ -0,0 +1,168 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef FOSSIL_STRUCTURES_FLATMAP_H
+#define FOSSIL_STRUCTURES_FLATMAP_H
+
+/**
+ * @brief Flat Map Data Structure
+ *
+ * This library provides functions for working with flat maps, which store their keys in a
+ * fossil_flatset_t and their values in a parallel fossil_vector_t. Key lookups use the
+ * flat set search (sorted, Eytzinger or SIMD over packed integer keys), and the value
+ * lives at the same index as its key.
+ *
+ * @defgroup create_delete CREATE and DELETE
+ * @defgroup insert_erase Insert and Erase Functions
+ * @defgroup lookup Lookup Functions
+ * @defgroup capacity Capacity Functions
+ * @defgroup utility Utility Functions
+ */
+
+#include "fossil/structure/flatset.h"
+
+// Flat map structure
+typedef struct fossil_flatmap_t {
+    fossil_flatset_t* keys;   // Keys in ascending order
+    fossil_vector_t* values;  // Values, parallel to keys
+    char* type;
+} fossil_flatmap_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * Create a new flat map with the specified key type.
+ *
+ * @param type The type of key the flat map will store.
+ * @return     The created flat map.
+ */
+fossil_flatmap_t* fossil_flatmap_create(char* type);
+
+/**
+ * Create a flat map from unsorted key-value pairs. For duplicate keys the last pair wins.
+ *
+ * @param type   The type of key the flat map will store.
+ * @param keys   The keys to add.
+ * @param values The values to add, parallel to keys.
+ * @param count  The number of pairs.
+ * @return       The created flat map, or NULL on allocation failure.
+ */
+fossil_flatmap_t* fossil_flatmap_create_from(char* type, const fossil_tofu_t* keys, const fossil_tofu_t* values, size_t count);
+
+/**
+ * Erase the contents of the flat map and free allocated memory.
+ *
+ * @param map The flat map to erase.
+ */
+void fossil_flatmap_erase(fossil_flatmap_t* map);
+
+/**
+ * Insert a key-value pair, replacing the value if the key exists.
+ *
+ * @param map   The flat map to insert into.
+ * @param key   The key.
+ * @param value The value.
+ * @return      0 on success, -1 on allocation failure.
+ */
+int32_t fossil_flatmap_insert(fossil_flatmap_t* map, fossil_tofu_t key, fossil_tofu_t value);
+
+/**
+ * Remove the pair with the specified key.
+ *
+ * @param map The flat map to remove from.
+ * @param key The key to remove.
+ * @return    0 on success, -1 if the key was not found.
+ */
+int32_t fossil_flatmap_remove(fossil_flatmap_t* map, fossil_tofu_t key);
+
+/**
+ * Get the value associated with a key.
+ *
+ * @param map The flat map to search.
+ * @param key The key to look up.
+ * @return    A pointer to the value, or NULL if the key was not found.
+ */
+fossil_tofu_t* fossil_flatmap_getter(fossil_flatmap_t* map, fossil_tofu_t key);
+
+/**
+ * Check if the flat map contains the specified key.
+ *
+ * @param map The flat map to check.
+ * @param key The key to look for.
+ * @return    True if found, false otherwise.
+ */
+bool fossil_flatmap_contains(fossil_flatmap_t* map, fossil_tofu_t key);
+
+/**
+ * Get the number of pairs in the flat map.
+ *
+ * @param map The flat map for which to get the size.
+ * @return    The number of pairs.
+ */
+size_t fossil_flatmap_size(const fossil_flatmap_t* map);
+
+/**
+ * Select the key search layout.
+ *
+ * @param map    The flat map to configure.
+ * @param layout The search layout.
+ */
+void fossil_flatmap_set_layout(fossil_flatmap_t* map, fossil_flatset_layout_t layout);
+
+/**
+ * Rebuild the key search index now instead of on the next lookup.
+ *
+ * @param map The flat map to index.
+ * @return    0 on success, -1 on allocation failure.
+ */
+int32_t fossil_flatmap_reindex(fossil_flatmap_t* map);
+
+/**
+ * Check if the flat map is not empty.
+ *
+ * @param map The flat map to check.
+ * @return    True if the flat map is not empty, false otherwise.
+ */
+bool fossil_flatmap_not_empty(const fossil_flatmap_t* map);
+
+/**
+ * Check if the flat map is not a null pointer.
+ *
+ * @param map The flat map to check.
+ * @return    True if the flat map is not a null pointer, false otherwise.
+ */
+bool fossil_flatmap_not_cnullptr(const fossil_flatmap_t* map);
+
+/**
+ * Check if the flat map is empty.
+ *
+ * @param map The flat map to check.
+ * @return    True if the flat map is empty, false otherwise.
+ */
+bool fossil_flatmap_is_empty(const fossil_flatmap_t* map);
+
+/**
+ * Check if the flat map is a null pointer.
+ *
+ * @param map The flat map to check.
+ * @return    True if the flat map is a null pointer, false otherwise.
+ */
+bool fossil_flatmap_is_cnullptr(const fossil_flatmap_t* map);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
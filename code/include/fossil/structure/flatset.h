@@ -0,0 +1,210 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef FOSSIL_STRUCTURES_FLATSET_H
+#define FOSSIL_STRUCTURES_FLATSET_H
+
+/**
+ * @brief Flat Set Data Structure
+ *
+ * This library provides functions for working with flat sets, which keep their unique
+ * elements sorted in a contiguous fossil_vector_t. Lookups are binary searches instead of
+ * linear scans, which suits read-mostly lookup tables.
+ *
+ * Elements are ordered by tofu type first and then by value. When every element is an
+ * integer tofu of the same type, the keys are also packed into a plain int64_t array and
+ * searched with SIMD compares. The search can use the sorted layout or an Eytzinger
+ * (BFS-order) layout; the search index is rebuilt lazily on the first search after a
+ * modification, so call fossil_flatset_reindex before sharing a set with readers.
+ *
+ * @defgroup create_delete CREATE and DELETE
+ * @defgroup insert_erase Insert and Erase Functions
+ * @defgroup lookup Lookup Functions
+ * @defgroup capacity Capacity Functions
+ * @defgroup utility Utility Functions
+ */
+
+#include "fossil/structure/vector.h"
+
+// Search layout of a flat set
+typedef enum {
+    FOSSIL_FLATSET_SORTED,    // Branchless binary search over the sorted elements
+    FOSSIL_FLATSET_EYTZINGER  // Search over a BFS-ordered copy of the elements
+} fossil_flatset_layout_t;
+
+// Flat set structure
+typedef struct fossil_flatset_t {
+    fossil_vector_t* items;         // Elements in ascending order
+    fossil_flatset_layout_t layout; // Search layout
+    bool dirty;                     // Search index must be rebuilt
+    bool packed;                    // Elements are mirrored as packed integer keys
+    int64_t* keys;                  // Packed keys, sorted or BFS order depending on layout
+    fossil_tofu_t* tree;            // Elements in BFS order (Eytzinger, not packed)
+    size_t* ranks;                  // Sorted index of each BFS slot (Eytzinger)
+    char* type;
+} fossil_flatset_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * Create a new flat set with the specified data type.
+ *
+ * @param type The type of data the flat set will store.
+ * @return     The created flat set.
+ */
+fossil_flatset_t* fossil_flatset_create(char* type);
+
+/**
+ * Create a flat set from unsorted elements. Duplicates are dropped.
+ *
+ * @param type     The type of data the flat set will store.
+ * @param elements The elements to add.
+ * @param count    The number of elements.
+ * @return         The created flat set, or NULL on allocation failure.
+ */
+fossil_flatset_t* fossil_flatset_create_from(char* type, const fossil_tofu_t* elements, size_t count);
+
+/**
+ * Erase the contents of the flat set and free allocated memory.
+ *
+ * @param set The flat set to erase.
+ */
+void fossil_flatset_erase(fossil_flatset_t* set);
+
+/**
+ * Insert data into the flat set, keeping it sorted.
+ *
+ * @param set  The flat set to insert data into.
+ * @param data The data to insert.
+ * @return     0 on success, -1 if the data is already present or allocation failed.
+ */
+int32_t fossil_flatset_insert(fossil_flatset_t* set, fossil_tofu_t data);
+
+/**
+ * Remove data from the flat set.
+ *
+ * @param set  The flat set to remove data from.
+ * @param data The data to remove.
+ * @return     0 on success, -1 if the data was not found.
+ */
+int32_t fossil_flatset_remove(fossil_flatset_t* set, fossil_tofu_t data);
+
+/**
+ * Find the first position whose element is not less than the given data. This uses the
+ * search index only when it is current and never rebuilds it, so it is cheap between updates.
+ *
+ * @param set  The flat set to search.
+ * @param data The data to search for.
+ * @return     The position in [0, size].
+ */
+size_t fossil_flatset_lower_bound(fossil_flatset_t* set, fossil_tofu_t data);
+
+/**
+ * Search for data in the flat set.
+ *
+ * @param set  The flat set to search.
+ * @param data The data to search for.
+ * @return     The sorted index of the data, or -1 if not found.
+ */
+int32_t fossil_flatset_search(fossil_flatset_t* set, fossil_tofu_t data);
+
+/**
+ * Check if the flat set contains the specified data.
+ *
+ * @param set  The flat set to check.
+ * @param data The data to look for.
+ * @return     True if found, false otherwise.
+ */
+bool fossil_flatset_contains(fossil_flatset_t* set, fossil_tofu_t data);
+
+/**
+ * Get the element at the specified sorted index.
+ *
+ * @param set   The flat set from which to get the element.
+ * @param index The sorted index.
+ * @return      A pointer to the element, or NULL if out of range.
+ */
+fossil_tofu_t* fossil_flatset_getter(const fossil_flatset_t* set, size_t index);
+
+/**
+ * Get the size of the flat set.
+ *
+ * @param set The flat set for which to get the size.
+ * @return    The number of elements.
+ */
+size_t fossil_flatset_size(const fossil_flatset_t* set);
+
+/**
+ * Select the search layout. The index is rebuilt on the next lookup.
+ *
+ * @param set    The flat set to configure.
+ * @param layout The search layout.
+ */
+void fossil_flatset_set_layout(fossil_flatset_t* set, fossil_flatset_layout_t layout);
+
+/**
+ * Rebuild the search index now instead of on the next lookup.
+ *
+ * @param set The flat set to index.
+ * @return    0 on success, -1 on allocation failure.
+ */
+int32_t fossil_flatset_reindex(fossil_flatset_t* set);
+
+/**
+ * Compare two tofus using the flat set ordering: by type first, then by value.
+ *
+ * @param a The first tofu.
+ * @param b The second tofu.
+ * @return  Negative, zero or positive as a is less than, equal to or greater than b.
+ */
+int32_t fossil_flatset_compare(fossil_tofu_t a, fossil_tofu_t b);
+
+/**
+ * Check if the flat set is not empty.
+ *
+ * @param set The flat set to check.
+ * @return    True if the flat set is not empty, false otherwise.
+ */
+bool fossil_flatset_not_empty(const fossil_flatset_t* set);
+
+/**
+ * Check if the flat set is not a null pointer.
+ *
+ * @param set The flat set to check.
+ * @return    True if the flat set is not a null pointer, false otherwise.
+ */
+bool fossil_flatset_not_cnullptr(const fossil_flatset_t* set);
+
+/**
+ * Check if the flat set is empty.
+ *
+ * @param set The flat set to check.
+ * @return    True if the flat set is empty, false otherwise.
+ */
+bool fossil_flatset_is_empty(const fossil_flatset_t* set);
+
+/**
+ * Check if the flat set is a null pointer.
+ *
+ * @param set The flat set to check.
+ * @return    True if the flat set is a null pointer, false otherwise.
+ */
+bool fossil_flatset_is_cnullptr(const fossil_flatset_t* set);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
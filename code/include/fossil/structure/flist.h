@@ -20,6 +20,10 @@ Description:
  * similar to singly linked lists. Forward lists allow efficient insertion and removal of elements
  * at the beginning and after specified positions.
  *
+ * Lists made with fossil_flist_create_unrolled store up to FOSSIL_FLIST_BLOCK_SIZE elements per
+ * node, so scans walk contiguous memory instead of chasing one pointer per element. Interior
+ * inserts split full blocks and removals merge underfull neighbours.
+ *
  * @defgroup create_delete CREATE and DELETE
  * @defgroup insert_erase Insert and Erase Functions
  * @defgroup lookup Lookup Functions
@@ -29,6 +33,7 @@ Description:
  */
 
 #include "fossil/generic/tofu.h"
+#include "fossil/generic/iterator.h"
 #include "fossil/generic/actionof.h"
 
 // Node structure for the linked list
@@ -37,12 +42,35 @@ typedef struct fossil_flist_node_t {
     struct fossil_flist_node_t* next;
 } fossil_flist_node_t;
 
+// Number of elements stored per block in unrolled mode
+#define FOSSIL_FLIST_BLOCK_SIZE 16
+
+// Block structure for the unrolled linked list
+typedef struct fossil_flist_block_t {
+    fossil_tofu_t data[FOSSIL_FLIST_BLOCK_SIZE];
+    size_t count;
+    struct fossil_flist_block_t* next;
+} fossil_flist_block_t;
+
 // Linked list structure
 typedef struct fossil_flist_t {
     fossil_flist_node_t* head;
+    fossil_flist_block_t* blocks;  // Unrolled storage, head block first
+    size_t size;                   // Element count in unrolled mode
+    bool unrolled;
     char* type;
 } fossil_flist_t;
 
+// Cursor over the elements of a forward list
+typedef struct fossil_flist_cursor_t {
+    fossil_flist_t* flist;
+    fossil_flist_node_t* node;   // Current node (node mode), null at the end
+    fossil_flist_node_t* prev;   // Node before the current one (node mode)
+    fossil_flist_block_t* block; // Current block (unrolled mode), null at the end
+    fossil_flist_block_t* prev_block; // Block before the current one (unrolled mode)
+    size_t offset;               // Element offset within the block
+} fossil_flist_cursor_t;
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -56,6 +84,14 @@ extern "C"
  */
 fossil_flist_t* fossil_flist_create(char* type);
 
+/**
+ * Create a new forward list that stores its elements in unrolled blocks.
+ *
+ * @param type The type of data the forward list will store.
+ * @return     The created forward list.
+ */
+fossil_flist_t* fossil_flist_create_unrolled(char* type);
+
 /**
  * Erase the contents of the forward list and free allocated memory.
  *
@@ -72,6 +108,26 @@ void fossil_flist_erase(fossil_flist_t* flist);
  */
 int32_t fossil_flist_insert(fossil_flist_t* flist, fossil_tofu_t data);
 
+/**
+ * Insert data at the specified position, counted from the head.
+ *
+ * @param flist The forward list to insert data into.
+ * @param index The position to insert at, from 0 to the size of the list.
+ * @param data  The data to insert.
+ * @return      0 on success, -1 if the position is out of range or allocation failed.
+ */
+int32_t fossil_flist_insert_at(fossil_flist_t* flist, size_t index, fossil_tofu_t data);
+
+/**
+ * Remove the data at the specified position, counted from the head.
+ *
+ * @param flist The forward list to remove data from.
+ * @param index The position to remove.
+ * @param data  A pointer to store the removed data.
+ * @return      0 on success, -1 if the position is out of range.
+ */
+int32_t fossil_flist_remove_at(fossil_flist_t* flist, size_t index, fossil_tofu_t* data);
+
 /**
  * Remove data from the forward list.
  *
@@ -162,6 +218,79 @@ bool fossil_flist_is_empty(const fossil_flist_t* flist);
  */
 bool fossil_flist_is_cnullptr(const fossil_flist_t* flist);
 
+/**
+ * Get a cursor at the head element of the forward list.
+ *
+ * @param flist The forward list to walk.
+ * @return      A cursor at the head element, or at the end if the forward list is empty.
+ */
+fossil_flist_cursor_t fossil_flist_cursor_begin(fossil_flist_t* flist);
+
+/**
+ * Get a cursor past the last element of the forward list. This walks from the head, so it is O(n).
+ *
+ * @param flist The forward list to walk.
+ * @return      A cursor at the end.
+ */
+fossil_flist_cursor_t fossil_flist_cursor_end(fossil_flist_t* flist);
+
+/**
+ * Check if the cursor is at an element rather than at the end.
+ *
+ * @param cursor The cursor to check.
+ * @return       True if the cursor can be dereferenced, false otherwise.
+ */
+bool fossil_flist_cursor_valid(const fossil_flist_cursor_t* cursor);
+
+/**
+ * Move the cursor to the next element. A cursor at the end stays there.
+ *
+ * @param cursor The cursor to move.
+ */
+void fossil_flist_cursor_next(fossil_flist_cursor_t* cursor);
+
+/**
+ * Move the cursor to the previous element. From the end it moves to the last element,
+ * and from the head element it moves to the end. This walks from the head, so it is O(n).
+ *
+ * @param cursor The cursor to move.
+ */
+void fossil_flist_cursor_prev(fossil_flist_cursor_t* cursor);
+
+/**
+ * Get the element at the cursor.
+ *
+ * @param cursor The cursor to dereference.
+ * @return       A pointer to the element, or NULL at the end.
+ */
+fossil_tofu_t* fossil_flist_cursor_deref(const fossil_flist_cursor_t* cursor);
+
+/**
+ * Insert data after the element at the cursor. The cursor stays on its element.
+ *
+ * @param cursor The cursor to insert after.
+ * @param data   The data to insert.
+ * @return       0 on success, -1 at the end or if allocation failed.
+ */
+int32_t fossil_flist_cursor_insert_after(fossil_flist_cursor_t* cursor, fossil_tofu_t data);
+
+/**
+ * Remove the element at the cursor and move the cursor to the element that followed it.
+ *
+ * @param cursor The cursor to erase at.
+ * @param data   A pointer to store the removed data.
+ * @return       0 on success, -1 at the end.
+ */
+int32_t fossil_flist_cursor_erase(fossil_flist_cursor_t* cursor, fossil_tofu_t* data);
+
+/**
+ * Get the contiguous run of elements starting at the cursor as a tofu iterator.
+ *
+ * @param cursor The cursor to start from.
+ * @return       An iterator over the run, empty at the end.
+ */
+fossil_tofu_iteratorof_t fossil_flist_cursor_span(const fossil_flist_cursor_t* cursor);
+
 #ifdef __cplusplus
 }
 #endif
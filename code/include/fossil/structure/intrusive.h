@@ -0,0 +1,373 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef FOSSIL_STRUCTURES_INTRUSIVE_H
+#define FOSSIL_STRUCTURES_INTRUSIVE_H
+
+/**
+ * @brief Intrusive Linked Structures
+ *
+ * This library provides forward lists, doubly linked lists and queues that link objects
+ * owned by the caller instead of copying tofus into nodes. The caller embeds a link struct
+ * in its own struct and recovers the object from a link with FOSSIL_CONTAINER_OF, so the
+ * containers never allocate and an element costs no more than its link.
+ *
+ * A link belongs to at most one container at a time and must stay at the same address
+ * while linked. Removing a link from a doubly linked list or queue is O(1) from anywhere,
+ * given only the link. Removed links are reset so a stale link is easy to spot.
+ *
+ * @defgroup create_delete CREATE and DELETE
+ * @defgroup insert_remove Insert and Remove Functions
+ * @defgroup utility Utility Functions
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "fossil/common/common.h"
+
+// Recover the struct that embeds a link from a pointer to the link
+#define FOSSIL_CONTAINER_OF(ptr, type, member) \
+    ((type*)((char*)(ptr) - offsetof(type, member)))
+
+// Link embedded in an element of an intrusive forward list
+typedef struct fossil_iflist_link_t {
+    struct fossil_iflist_link_t* next;
+} fossil_iflist_link_t;
+
+// Intrusive forward list
+typedef struct fossil_iflist_t {
+    fossil_iflist_link_t* head;
+    size_t size;
+} fossil_iflist_t;
+
+// Link embedded in an element of an intrusive doubly linked list or queue
+typedef struct fossil_idlist_link_t {
+    struct fossil_idlist_link_t* prev;
+    struct fossil_idlist_link_t* next;
+} fossil_idlist_link_t;
+
+// Intrusive doubly linked list
+typedef struct fossil_idlist_t {
+    fossil_idlist_link_t* head;
+    fossil_idlist_link_t* tail;
+    size_t size;
+} fossil_idlist_t;
+
+// Intrusive queue, front first
+typedef struct fossil_iqueue_t {
+    fossil_idlist_t list;
+} fossil_iqueue_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// *****************************************************************************
+// Forward list
+// *****************************************************************************
+
+/**
+ * Initialize an empty intrusive forward list.
+ *
+ * @param list The list to initialize.
+ */
+void fossil_iflist_init(fossil_iflist_t* list);
+
+/**
+ * Link an element at the front of the list.
+ *
+ * @param list The list to insert into.
+ * @param link The link of the element.
+ */
+void fossil_iflist_push_front(fossil_iflist_t* list, fossil_iflist_link_t* link);
+
+/**
+ * Unlink the element at the front of the list.
+ *
+ * @param list The list to remove from.
+ * @return     The link of the removed element, or NULL if the list is empty.
+ */
+fossil_iflist_link_t* fossil_iflist_pop_front(fossil_iflist_t* list);
+
+/**
+ * Link an element after another one.
+ *
+ * @param list The list to insert into.
+ * @param pos  The link to insert after, or NULL to insert at the front.
+ * @param link The link of the element.
+ */
+void fossil_iflist_insert_after(fossil_iflist_t* list, fossil_iflist_link_t* pos, fossil_iflist_link_t* link);
+
+/**
+ * Unlink the element after another one in O(1).
+ *
+ * @param list The list to remove from.
+ * @param pos  The link before the element, or NULL to remove the front.
+ * @return     The link of the removed element, or NULL if there is none.
+ */
+fossil_iflist_link_t* fossil_iflist_remove_after(fossil_iflist_t* list, fossil_iflist_link_t* pos);
+
+/**
+ * Unlink an element, searching for its predecessor in O(n).
+ *
+ * @param list The list to remove from.
+ * @param link The link of the element.
+ * @return     0 on success, -1 if the element is not in the list.
+ */
+int32_t fossil_iflist_remove(fossil_iflist_t* list, fossil_iflist_link_t* link);
+
+/**
+ * Reverse the order of the elements.
+ *
+ * @param list The list to reverse.
+ */
+void fossil_iflist_reverse(fossil_iflist_t* list);
+
+/**
+ * Get the number of linked elements.
+ *
+ * @param list The list for which to get the size.
+ * @return     The number of elements.
+ */
+size_t fossil_iflist_size(const fossil_iflist_t* list);
+
+/**
+ * Check if the intrusive forward list is not empty.
+ *
+ * @param list The list to check.
+ * @return     True if the list is not empty, false otherwise.
+ */
+bool fossil_iflist_not_empty(const fossil_iflist_t* list);
+
+/**
+ * Check if the intrusive forward list is not a null pointer.
+ *
+ * @param list The list to check.
+ * @return     True if the list is not a null pointer, false otherwise.
+ */
+bool fossil_iflist_not_cnullptr(const fossil_iflist_t* list);
+
+/**
+ * Check if the intrusive forward list is empty.
+ *
+ * @param list The list to check.
+ * @return     True if the list is empty, false otherwise.
+ */
+bool fossil_iflist_is_empty(const fossil_iflist_t* list);
+
+/**
+ * Check if the intrusive forward list is a null pointer.
+ *
+ * @param list The list to check.
+ * @return     True if the list is a null pointer, false otherwise.
+ */
+bool fossil_iflist_is_cnullptr(const fossil_iflist_t* list);
+
+// *****************************************************************************
+// Doubly linked list
+// *****************************************************************************
+
+/**
+ * Initialize an empty intrusive doubly linked list.
+ *
+ * @param list The list to initialize.
+ */
+void fossil_idlist_init(fossil_idlist_t* list);
+
+/**
+ * Link an element at the front of the list.
+ *
+ * @param list The list to insert into.
+ * @param link The link of the element.
+ */
+void fossil_idlist_push_front(fossil_idlist_t* list, fossil_idlist_link_t* link);
+
+/**
+ * Link an element at the back of the list.
+ *
+ * @param list The list to insert into.
+ * @param link The link of the element.
+ */
+void fossil_idlist_push_back(fossil_idlist_t* list, fossil_idlist_link_t* link);
+
+/**
+ * Unlink the element at the front of the list.
+ *
+ * @param list The list to remove from.
+ * @return     The link of the removed element, or NULL if the list is empty.
+ */
+fossil_idlist_link_t* fossil_idlist_pop_front(fossil_idlist_t* list);
+
+/**
+ * Unlink the element at the back of the list.
+ *
+ * @param list The list to remove from.
+ * @return     The link of the removed element, or NULL if the list is empty.
+ */
+fossil_idlist_link_t* fossil_idlist_pop_back(fossil_idlist_t* list);
+
+/**
+ * Link an element before another one.
+ *
+ * @param list The list to insert into.
+ * @param pos  The link to insert before, or NULL to insert at the back.
+ * @param link The link of the element.
+ */
+void fossil_idlist_insert_before(fossil_idlist_t* list, fossil_idlist_link_t* pos, fossil_idlist_link_t* link);
+
+/**
+ * Link an element after another one.
+ *
+ * @param list The list to insert into.
+ * @param pos  The link to insert after, or NULL to insert at the front.
+ * @param link The link of the element.
+ */
+void fossil_idlist_insert_after(fossil_idlist_t* list, fossil_idlist_link_t* pos, fossil_idlist_link_t* link);
+
+/**
+ * Unlink an element in O(1). The element must be in this list.
+ *
+ * @param list The list to remove from.
+ * @param link The link of the element.
+ */
+void fossil_idlist_remove(fossil_idlist_t* list, fossil_idlist_link_t* link);
+
+/**
+ * Get the number of linked elements.
+ *
+ * @param list The list for which to get the size.
+ * @return     The number of elements.
+ */
+size_t fossil_idlist_size(const fossil_idlist_t* list);
+
+/**
+ * Check if the intrusive doubly linked list is not empty.
+ *
+ * @param list The list to check.
+ * @return     True if the list is not empty, false otherwise.
+ */
+bool fossil_idlist_not_empty(const fossil_idlist_t* list);
+
+/**
+ * Check if the intrusive doubly linked list is not a null pointer.
+ *
+ * @param list The list to check.
+ * @return     True if the list is not a null pointer, false otherwise.
+ */
+bool fossil_idlist_not_cnullptr(const fossil_idlist_t* list);
+
+/**
+ * Check if the intrusive doubly linked list is empty.
+ *
+ * @param list The list to check.
+ * @return     True if the list is empty, false otherwise.
+ */
+bool fossil_idlist_is_empty(const fossil_idlist_t* list);
+
+/**
+ * Check if the intrusive doubly linked list is a null pointer.
+ *
+ * @param list The list to check.
+ * @return     True if the list is a null pointer, false otherwise.
+ */
+bool fossil_idlist_is_cnullptr(const fossil_idlist_t* list);
+
+// *****************************************************************************
+// Queue
+// *****************************************************************************
+
+/**
+ * Initialize an empty intrusive queue.
+ *
+ * @param queue The queue to initialize.
+ */
+void fossil_iqueue_init(fossil_iqueue_t* queue);
+
+/**
+ * Link an element at the rear of the queue.
+ *
+ * @param queue The queue to insert into.
+ * @param link  The link of the element.
+ */
+void fossil_iqueue_insert(fossil_iqueue_t* queue, fossil_idlist_link_t* link);
+
+/**
+ * Unlink the element at the front of the queue.
+ *
+ * @param queue The queue to remove from.
+ * @return      The link of the removed element, or NULL if the queue is empty.
+ */
+fossil_idlist_link_t* fossil_iqueue_remove(fossil_iqueue_t* queue);
+
+/**
+ * Get the element at the front of the queue without unlinking it.
+ *
+ * @param queue The queue to inspect.
+ * @return      The link of the front element, or NULL if the queue is empty.
+ */
+fossil_idlist_link_t* fossil_iqueue_peek(const fossil_iqueue_t* queue);
+
+/**
+ * Unlink an element from anywhere in the queue in O(1). The element must be in this queue.
+ *
+ * @param queue The queue to remove from.
+ * @param link  The link of the element.
+ */
+void fossil_iqueue_unlink(fossil_iqueue_t* queue, fossil_idlist_link_t* link);
+
+/**
+ * Get the number of queued elements.
+ *
+ * @param queue The queue for which to get the size.
+ * @return      The number of elements.
+ */
+size_t fossil_iqueue_size(const fossil_iqueue_t* queue);
+
+/**
+ * Check if the intrusive queue is not empty.
+ *
+ * @param queue The queue to check.
+ * @return      True if the queue is not empty, false otherwise.
+ */
+bool fossil_iqueue_not_empty(const fossil_iqueue_t* queue);
+
+/**
+ * Check if the intrusive queue is not a null pointer.
+ *
+ * @param queue The queue to check.
+ * @return      True if the queue is not a null pointer, false otherwise.
+ */
+bool fossil_iqueue_not_cnullptr(const fossil_iqueue_t* queue);
+
+/**
+ * Check if the intrusive queue is empty.
+ *
+ * @param queue The queue to check.
+ * @return      True if the queue is empty, false otherwise.
+ */
+bool fossil_iqueue_is_empty(const fossil_iqueue_t* queue);
+
+/**
+ * Check if the intrusive queue is a null pointer.
+ *
+ * @param queue The queue to check.
+ * @return      True if the queue is a null pointer, false otherwise.
+ */
+bool fossil_iqueue_is_cnullptr(const fossil_iqueue_t* queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
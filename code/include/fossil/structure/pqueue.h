@@ -27,6 +27,7 @@ Description:
  */
 
 #include "fossil/generic/tofu.h"
+#include "fossil/generic/iterator.h"
 #include "fossil/generic/actionof.h"
 
 typedef struct fossil_pqueue_node_t {
@@ -40,6 +41,13 @@ typedef struct fossil_pqueue_t {
     char* type;
 } fossil_pqueue_t;
 
+// Cursor over the elements of a priority queue
+typedef struct fossil_pqueue_cursor_t {
+    fossil_pqueue_t* pqueue;
+    fossil_pqueue_node_t* node; // Current node, null at the end
+    fossil_pqueue_node_t* prev; // Node before the current one
+} fossil_pqueue_cursor_t;
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -150,6 +158,79 @@ bool fossil_pqueue_is_empty(const fossil_pqueue_t* pqueue);
  */
 bool fossil_pqueue_is_cnullptr(const fossil_pqueue_t* pqueue);
 
+/**
+ * Get a cursor at the front element of the priority queue.
+ *
+ * @param pqueue The priority queue to walk.
+ * @return       A cursor at the front element, or at the end if the priority queue is empty.
+ */
+fossil_pqueue_cursor_t fossil_pqueue_cursor_begin(fossil_pqueue_t* pqueue);
+
+/**
+ * Get a cursor past the last element of the priority queue. This walks from the front, so it is O(n).
+ *
+ * @param pqueue The priority queue to walk.
+ * @return       A cursor at the end.
+ */
+fossil_pqueue_cursor_t fossil_pqueue_cursor_end(fossil_pqueue_t* pqueue);
+
+/**
+ * Check if the cursor is at an element rather than at the end.
+ *
+ * @param cursor The cursor to check.
+ * @return       True if the cursor can be dereferenced, false otherwise.
+ */
+bool fossil_pqueue_cursor_valid(const fossil_pqueue_cursor_t* cursor);
+
+/**
+ * Move the cursor to the next element. A cursor at the end stays there.
+ *
+ * @param cursor The cursor to move.
+ */
+void fossil_pqueue_cursor_next(fossil_pqueue_cursor_t* cursor);
+
+/**
+ * Move the cursor to the previous element. From the end it moves to the last element,
+ * and from the front element it moves to the end. This walks from the front, so it is O(n).
+ *
+ * @param cursor The cursor to move.
+ */
+void fossil_pqueue_cursor_prev(fossil_pqueue_cursor_t* cursor);
+
+/**
+ * Get the element at the cursor.
+ *
+ * @param cursor The cursor to dereference.
+ * @return       A pointer to the element, or NULL at the end.
+ */
+fossil_tofu_t* fossil_pqueue_cursor_deref(const fossil_pqueue_cursor_t* cursor);
+
+/**
+ * Insert data after the element at the cursor. The cursor stays on its element. The new element takes the priority of the current one, keeping the queue ordered.
+ *
+ * @param cursor The cursor to insert after.
+ * @param data   The data to insert.
+ * @return       0 on success, -1 at the end or if allocation failed.
+ */
+int32_t fossil_pqueue_cursor_insert_after(fossil_pqueue_cursor_t* cursor, fossil_tofu_t data);
+
+/**
+ * Remove the element at the cursor and move the cursor to the element that followed it.
+ *
+ * @param cursor The cursor to erase at.
+ * @param data   A pointer to store the removed data.
+ * @return       0 on success, -1 at the end.
+ */
+int32_t fossil_pqueue_cursor_erase(fossil_pqueue_cursor_t* cursor, fossil_tofu_t* data);
+
+/**
+ * Get the contiguous run of elements starting at the cursor as a tofu iterator.
+ *
+ * @param cursor The cursor to start from.
+ * @return       An iterator over the run, empty at the end.
+ */
+fossil_tofu_iteratorof_t fossil_pqueue_cursor_span(const fossil_pqueue_cursor_t* cursor);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,231 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef FOSSIL_STRUCTURES_PVECTOR_H
+#define FOSSIL_STRUCTURES_PVECTOR_H
+
+/**
+ * @brief Persistent Vector Data Structure
+ *
+ * This library provides functions for working with persistent vectors, which are
+ * immutable 32-way tries of tofus. An update returns a new version that shares every
+ * unchanged node with the old one, so taking a snapshot is O(1) and an update copies
+ * only the O(log32 n) nodes on the path to the changed element.
+ *
+ * Nodes are reference counted with atomic counters. Each version is its own handle
+ * that holds one reference; versions can be handed to other threads and erased there.
+ * Elements are stored by value like in fossil_vector_t, so tofus that own memory must
+ * outlive every version that holds them.
+ *
+ * A transient version accepts in-place updates. It still copies nodes that other
+ * versions share, but it updates nodes that only it references in place, so a batch
+ * of updates costs little more than the same batch on a plain vector.
+ *
+ * @defgroup create_delete CREATE and DELETE
+ * @defgroup access Access Functions
+ * @defgroup modify Modify Functions
+ * @defgroup transient Transient Functions
+ * @defgroup utility Utility Functions
+ */
+
+#include "fossil/generic/tofu.h"
+#include "fossil/generic/iterator.h"
+
+#define FOSSIL_PVECTOR_BITS 5
+#define FOSSIL_PVECTOR_WIDTH (1 << FOSSIL_PVECTOR_BITS)
+
+// Trie node, shared between versions
+typedef struct fossil_pvector_node_t fossil_pvector_node_t;
+
+// Persistent vector version
+typedef struct fossil_pvector_t {
+    fossil_pvector_node_t* root; // Trie of full leaves, null while everything fits in the tail
+    fossil_pvector_node_t* tail; // Leaf holding the last 1 to 32 elements
+    size_t size;                 // Number of elements
+    uint32_t shift;              // Bit shift of the root level
+    bool transient;              // Whether in-place updates are allowed
+    char* type;
+} fossil_pvector_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * Create a new, empty persistent vector with the specified data type.
+ *
+ * @param type The type of data the persistent vector will store.
+ * @return     The created persistent vector.
+ */
+fossil_pvector_t* fossil_pvector_create(char* type);
+
+/**
+ * Create a persistent vector holding a copy of the given elements, for example the
+ * data of a fossil_vector_t.
+ *
+ * @param type     The type of data the persistent vector will store.
+ * @param elements The elements to copy.
+ * @param count    The number of elements.
+ * @return         The created persistent vector, or NULL on allocation failure.
+ */
+fossil_pvector_t* fossil_pvector_create_from(char* type, const fossil_tofu_t* elements, size_t count);
+
+/**
+ * Erase a version of the persistent vector. Nodes are freed once no other version shares them.
+ *
+ * @param pvector The version to erase.
+ */
+void fossil_pvector_erase(fossil_pvector_t* pvector);
+
+/**
+ * Take an O(1) snapshot of a version. The snapshot is persistent even if the source is transient.
+ *
+ * @param pvector The version to snapshot.
+ * @return        The new version, or NULL on allocation failure.
+ */
+fossil_pvector_t* fossil_pvector_snapshot(const fossil_pvector_t* pvector);
+
+/**
+ * Get the element at the specified index.
+ *
+ * @param pvector The version to read.
+ * @param index   The index of the element.
+ * @return        A pointer to the element, or NULL if out of range.
+ */
+const fossil_tofu_t* fossil_pvector_getter(const fossil_pvector_t* pvector, size_t index);
+
+/**
+ * Get the contiguous run of elements from the specified index to the end of its leaf as a
+ * tofu iterator. Walking a version leaf by leaf avoids a trie descent per element.
+ *
+ * @param pvector The version to read.
+ * @param index   The index of the first element.
+ * @return        An iterator over at most 32 elements, empty if out of range.
+ */
+fossil_tofu_iteratorof_t fossil_pvector_span(const fossil_pvector_t* pvector, size_t index);
+
+/**
+ * Get the number of elements in a version.
+ *
+ * @param pvector The version for which to get the size.
+ * @return        The number of elements.
+ */
+size_t fossil_pvector_size(const fossil_pvector_t* pvector);
+
+/**
+ * Create a new version with the element at the specified index replaced.
+ *
+ * @param pvector The version to update.
+ * @param index   The index of the element.
+ * @param data    The new element.
+ * @return        The new version, or NULL if out of range or allocation failed.
+ */
+fossil_pvector_t* fossil_pvector_set(const fossil_pvector_t* pvector, size_t index, fossil_tofu_t data);
+
+/**
+ * Create a new version with an element appended.
+ *
+ * @param pvector The version to update.
+ * @param data    The element to append.
+ * @return        The new version, or NULL on allocation failure.
+ */
+fossil_pvector_t* fossil_pvector_push_back(const fossil_pvector_t* pvector, fossil_tofu_t data);
+
+/**
+ * Create a new version with the last element removed.
+ *
+ * @param pvector The version to update.
+ * @return        The new version, or NULL if the version is empty or allocation failed.
+ */
+fossil_pvector_t* fossil_pvector_pop_back(const fossil_pvector_t* pvector);
+
+/**
+ * Create a transient version that accepts in-place updates, starting from the given version.
+ *
+ * @param pvector The version to start from.
+ * @return        The transient version, or NULL on allocation failure.
+ */
+fossil_pvector_t* fossil_pvector_transient(const fossil_pvector_t* pvector);
+
+/**
+ * Make a transient version persistent again. Later updates must create new versions.
+ *
+ * @param pvector The transient version.
+ */
+void fossil_pvector_persistent(fossil_pvector_t* pvector);
+
+/**
+ * Replace the element at the specified index of a transient version in place.
+ *
+ * @param pvector The transient version to update.
+ * @param index   The index of the element.
+ * @param data    The new element.
+ * @return        0 on success, -1 if not transient, out of range or allocation failed.
+ */
+int32_t fossil_pvector_transient_set(fossil_pvector_t* pvector, size_t index, fossil_tofu_t data);
+
+/**
+ * Append an element to a transient version in place.
+ *
+ * @param pvector The transient version to update.
+ * @param data    The element to append.
+ * @return        0 on success, -1 if not transient or allocation failed.
+ */
+int32_t fossil_pvector_transient_push_back(fossil_pvector_t* pvector, fossil_tofu_t data);
+
+/**
+ * Remove the last element of a transient version in place.
+ *
+ * @param pvector The transient version to update.
+ * @param data    A pointer to store the removed element, or NULL.
+ * @return        0 on success, -1 if not transient, empty or allocation failed.
+ */
+int32_t fossil_pvector_transient_pop_back(fossil_pvector_t* pvector, fossil_tofu_t* data);
+
+/**
+ * Check if the persistent vector is not empty.
+ *
+ * @param pvector The version to check.
+ * @return        True if the version is not empty, false otherwise.
+ */
+bool fossil_pvector_not_empty(const fossil_pvector_t* pvector);
+
+/**
+ * Check if the persistent vector is not a null pointer.
+ *
+ * @param pvector The version to check.
+ * @return        True if the version is not a null pointer, false otherwise.
+ */
+bool fossil_pvector_not_cnullptr(const fossil_pvector_t* pvector);
+
+/**
+ * Check if the persistent vector is empty.
+ *
+ * @param pvector The version to check.
+ * @return        True if the version is empty, false otherwise.
+ */
+bool fossil_pvector_is_empty(const fossil_pvector_t* pvector);
+
+/**
+ * Check if the persistent vector is a null pointer.
+ *
+ * @param pvector The version to check.
+ * @return        True if the version is a null pointer, false otherwise.
+ */
+bool fossil_pvector_is_cnullptr(const fossil_pvector_t* pvector);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
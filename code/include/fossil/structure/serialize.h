@@ -0,0 +1,262 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef FOSSIL_STRUCTURES_SERIALIZE_H
+#define FOSSIL_STRUCTURES_SERIALIZE_H
+
+/**
+ * @brief Structure Serialization
+ *
+ * This library provides a compact, versioned binary encoding for tofus and the structure
+ * containers. Each record starts with the magic bytes "FOSL" and a length-prefixed header
+ * holding the format version, the container kind and the element count, so newer writers
+ * can add header fields that older readers skip. The elements follow as a type byte and a
+ * payload each: varints for integers (zigzag for signed), little-endian IEEE floats, and
+ * length-prefixed, NUL-terminated strings.
+ *
+ * Records are saved to and loaded from a fossil_fstream_t, and several records may follow
+ * each other in one stream. Loading copies every string.
+ *
+ * A fossil_serialize_buffer_t reads records from memory, typically a mapped file. The view
+ * functions point string tofus directly into the buffer instead of copying them, so the
+ * buffer must stay mapped while the structure is in use and those strings must not be
+ * erased. Wide strings are always copied because their encoding does not match wchar_t.
+ *
+ * @defgroup buffer Buffer Functions
+ * @defgroup tofu Tofu Functions
+ * @defgroup containers Container Functions
+ */
+
+#include "fossil/io/fstream.h"
+#include "fossil/generic/mapof.h"
+#include "fossil/structure/flatset.h"
+#include "fossil/structure/queue.h"
+#include "fossil/structure/set.h"
+#include "fossil/structure/vector.h"
+
+#define FOSSIL_SERIALIZE_VERSION 1
+
+// Container kind recorded in a header
+typedef enum {
+    FOSSIL_SERIALIZE_TOFU = 1,
+    FOSSIL_SERIALIZE_VECTOR,
+    FOSSIL_SERIALIZE_SET,
+    FOSSIL_SERIALIZE_QUEUE,
+    FOSSIL_SERIALIZE_MAPOF,
+    FOSSIL_SERIALIZE_FLATSET
+} fossil_serialize_kind_t;
+
+// Read-only view of encoded records
+typedef struct fossil_serialize_buffer_t {
+    const uint8_t* data;
+    size_t size;
+    size_t offset;  // Read position, advanced past each loaded record
+    void* mapping;  // Mapping handle when the buffer maps a file
+} fossil_serialize_buffer_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * Point a buffer at encoded records in memory.
+ *
+ * @param buffer The buffer to initialize.
+ * @param data   The encoded records.
+ * @param size   The number of bytes.
+ */
+void fossil_serialize_buffer_init(fossil_serialize_buffer_t* buffer, const void* data, size_t size);
+
+/**
+ * Map a file read-only into a buffer.
+ *
+ * @param buffer   The buffer to initialize.
+ * @param filename The file to map.
+ * @return         0 on success, -1 on failure.
+ */
+int32_t fossil_serialize_buffer_map(fossil_serialize_buffer_t* buffer, const char* filename);
+
+/**
+ * Unmap a buffer created by fossil_serialize_buffer_map. Views into it become invalid.
+ *
+ * @param buffer The buffer to unmap.
+ */
+void fossil_serialize_buffer_unmap(fossil_serialize_buffer_t* buffer);
+
+/**
+ * Save a single tofu as a record.
+ *
+ * @param stream The stream to write to.
+ * @param tofu   The tofu to save.
+ * @return       0 on success, -1 on write failure.
+ */
+int32_t fossil_serialize_save_tofu(fossil_fstream_t* stream, fossil_tofu_t tofu);
+
+/**
+ * Load a single tofu record.
+ *
+ * @param stream The stream to read from.
+ * @param tofu   A pointer to store the tofu.
+ * @return       0 on success, -1 on malformed input or allocation failure.
+ */
+int32_t fossil_serialize_load_tofu(fossil_fstream_t* stream, fossil_tofu_t* tofu);
+
+/**
+ * View a single tofu record in a buffer.
+ *
+ * @param buffer The buffer to read from.
+ * @param tofu   A pointer to store the tofu.
+ * @return       0 on success, -1 on malformed input or allocation failure.
+ */
+int32_t fossil_serialize_view_tofu(fossil_serialize_buffer_t* buffer, fossil_tofu_t* tofu);
+
+/**
+ * Save a vector as a record.
+ *
+ * @param stream The stream to write to.
+ * @param vector The vector to save.
+ * @return       0 on success, -1 on write failure.
+ */
+int32_t fossil_serialize_save_vector(fossil_fstream_t* stream, const fossil_vector_t* vector);
+
+/**
+ * Load a vector record.
+ *
+ * @param stream The stream to read from.
+ * @param type   The type of data the vector will store.
+ * @return       The loaded vector, or NULL on malformed input or allocation failure.
+ */
+fossil_vector_t* fossil_serialize_load_vector(fossil_fstream_t* stream, char* type);
+
+/**
+ * View a vector record in a buffer.
+ *
+ * @param buffer The buffer to read from.
+ * @param type   The type of data the vector will store.
+ * @return       The loaded vector, or NULL on malformed input or allocation failure.
+ */
+fossil_vector_t* fossil_serialize_view_vector(fossil_serialize_buffer_t* buffer, char* type);
+
+/**
+ * Save a set as a record.
+ *
+ * @param stream The stream to write to.
+ * @param set    The set to save.
+ * @return       0 on success, -1 on write failure.
+ */
+int32_t fossil_serialize_save_set(fossil_fstream_t* stream, const fossil_set_t* set);
+
+/**
+ * Load a set record, keeping the saved element order.
+ *
+ * @param stream The stream to read from.
+ * @param type   The type of data the set will store.
+ * @return       The loaded set, or NULL on malformed input or allocation failure.
+ */
+fossil_set_t* fossil_serialize_load_set(fossil_fstream_t* stream, char* type);
+
+/**
+ * View a set record in a buffer.
+ *
+ * @param buffer The buffer to read from.
+ * @param type   The type of data the set will store.
+ * @return       The loaded set, or NULL on malformed input or allocation failure.
+ */
+fossil_set_t* fossil_serialize_view_set(fossil_serialize_buffer_t* buffer, char* type);
+
+/**
+ * Save a queue as a record, front first.
+ *
+ * @param stream The stream to write to.
+ * @param queue  The queue to save.
+ * @return       0 on success, -1 on write failure.
+ */
+int32_t fossil_serialize_save_queue(fossil_fstream_t* stream, const fossil_queue_t* queue);
+
+/**
+ * Load a queue record.
+ *
+ * @param stream The stream to read from.
+ * @param type   The type of data the queue will store.
+ * @return       The loaded queue, or NULL on malformed input or allocation failure.
+ */
+fossil_queue_t* fossil_serialize_load_queue(fossil_fstream_t* stream, char* type);
+
+/**
+ * View a queue record in a buffer.
+ *
+ * @param buffer The buffer to read from.
+ * @param type   The type of data the queue will store.
+ * @return       The loaded queue, or NULL on malformed input or allocation failure.
+ */
+fossil_queue_t* fossil_serialize_view_queue(fossil_serialize_buffer_t* buffer, char* type);
+
+/**
+ * Save a map as a record of key-value pairs.
+ *
+ * @param stream The stream to write to.
+ * @param map    The map to save.
+ * @return       0 on success, -1 on write failure.
+ */
+int32_t fossil_serialize_save_mapof(fossil_fstream_t* stream, const fossil_tofu_mapof_t* map);
+
+/**
+ * Load a map record.
+ *
+ * @param stream The stream to read from.
+ * @param map    A pointer to store the loaded map.
+ * @return       0 on success, -1 on malformed input or allocation failure.
+ */
+int32_t fossil_serialize_load_mapof(fossil_fstream_t* stream, fossil_tofu_mapof_t* map);
+
+/**
+ * View a map record in a buffer.
+ *
+ * @param buffer The buffer to read from.
+ * @param map    A pointer to store the loaded map.
+ * @return       0 on success, -1 on malformed input or allocation failure.
+ */
+int32_t fossil_serialize_view_mapof(fossil_serialize_buffer_t* buffer, fossil_tofu_mapof_t* map);
+
+/**
+ * Save a flat set as a record in sorted order.
+ *
+ * @param stream The stream to write to.
+ * @param set    The flat set to save.
+ * @return       0 on success, -1 on write failure.
+ */
+int32_t fossil_serialize_save_flatset(fossil_fstream_t* stream, const fossil_flatset_t* set);
+
+/**
+ * Load a flat set record. The elements are checked for order instead of sorted again.
+ *
+ * @param stream The stream to read from.
+ * @param type   The type of data the flat set will store.
+ * @return       The loaded flat set, or NULL on malformed input or allocation failure.
+ */
+fossil_flatset_t* fossil_serialize_load_flatset(fossil_fstream_t* stream, char* type);
+
+/**
+ * View a flat set record in a buffer.
+ *
+ * @param buffer The buffer to read from.
+ * @param type   The type of data the flat set will store.
+ * @return       The loaded flat set, or NULL on malformed input or allocation failure.
+ */
+fossil_flatset_t* fossil_serialize_view_flatset(fossil_serialize_buffer_t* buffer, char* type);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -42,6 +42,13 @@ typedef struct fossil_set_t {
     char* type;
 } fossil_set_t;
 
+// Cursor over the elements of a set
+typedef struct fossil_set_cursor_t {
+    fossil_set_t* set;
+    fossil_set_node_t* node; // Current node, null at the end
+    fossil_set_node_t* prev; // Node before the current one
+} fossil_set_cursor_t;
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -156,6 +163,79 @@ bool fossil_set_is_cnullptr(const fossil_set_t* set);
  */
 int32_t fossil_set_contains(const fossil_set_t* set, fossil_tofu_t data);
 
+/**
+ * Get a cursor at the head element of the set.
+ *
+ * @param set The set to walk.
+ * @return    A cursor at the head element, or at the end if the set is empty.
+ */
+fossil_set_cursor_t fossil_set_cursor_begin(fossil_set_t* set);
+
+/**
+ * Get a cursor past the last element of the set. This walks from the head, so it is O(n).
+ *
+ * @param set The set to walk.
+ * @return    A cursor at the end.
+ */
+fossil_set_cursor_t fossil_set_cursor_end(fossil_set_t* set);
+
+/**
+ * Check if the cursor is at an element rather than at the end.
+ *
+ * @param cursor The cursor to check.
+ * @return       True if the cursor can be dereferenced, false otherwise.
+ */
+bool fossil_set_cursor_valid(const fossil_set_cursor_t* cursor);
+
+/**
+ * Move the cursor to the next element. A cursor at the end stays there.
+ *
+ * @param cursor The cursor to move.
+ */
+void fossil_set_cursor_next(fossil_set_cursor_t* cursor);
+
+/**
+ * Move the cursor to the previous element. From the end it moves to the last element,
+ * and from the head element it moves to the end. This walks from the head, so it is O(n).
+ *
+ * @param cursor The cursor to move.
+ */
+void fossil_set_cursor_prev(fossil_set_cursor_t* cursor);
+
+/**
+ * Get the element at the cursor.
+ *
+ * @param cursor The cursor to dereference.
+ * @return       A pointer to the element, or NULL at the end.
+ */
+fossil_tofu_t* fossil_set_cursor_deref(const fossil_set_cursor_t* cursor);
+
+/**
+ * Insert data after the element at the cursor. The cursor stays on its element. Fails if the data is already in the set.
+ *
+ * @param cursor The cursor to insert after.
+ * @param data   The data to insert.
+ * @return       0 on success, -1 at the end or if allocation failed.
+ */
+int32_t fossil_set_cursor_insert_after(fossil_set_cursor_t* cursor, fossil_tofu_t data);
+
+/**
+ * Remove the element at the cursor and move the cursor to the element that followed it.
+ *
+ * @param cursor The cursor to erase at.
+ * @param data   A pointer to store the removed data.
+ * @return       0 on success, -1 at the end.
+ */
+int32_t fossil_set_cursor_erase(fossil_set_cursor_t* cursor, fossil_tofu_t* data);
+
+/**
+ * Get the contiguous run of elements starting at the cursor as a tofu iterator.
+ *
+ * @param cursor The cursor to start from.
+ * @return       An iterator over the run, empty at the end.
+ */
+fossil_tofu_iteratorof_t fossil_set_cursor_span(const fossil_set_cursor_t* cursor);
+
 #ifdef __cplusplus
 }
 #endif
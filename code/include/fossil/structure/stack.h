@@ -19,6 +19,10 @@ Description:
  * This library provides functions for working with stacks, which are linear data structures
  * that follow the Last-In-First-Out (LIFO) principle.
  *
+ * A stack is linked (one node per element) unless it is created with fossil_stack_create_array,
+ * which keeps the elements in one growable array, or fossil_stack_create_fixed, which uses a
+ * buffer of fixed capacity and never allocates on push. All modes share the same API.
+ *
  * @defgroup create_delete CREATE and DELETE
  * @defgroup push_pop Push and Pop Functions
  * @defgroup top Top Function
@@ -27,6 +31,7 @@ Description:
  */
 
 #include "fossil/generic/tofu.h"
+#include "fossil/generic/iterator.h"
 #include "fossil/generic/actionof.h"
 
 // Stack structure
@@ -35,11 +40,34 @@ typedef struct fossil_stack_node_t {
     struct fossil_stack_node_t* next; // Pointer to the next node
 } fossil_stack_node_t;
 
+// Initial capacity of an array-backed stack
+#define FOSSIL_STACK_INITIAL_CAPACITY 16
+
+// Storage used by a stack
+typedef enum {
+    FOSSIL_STACK_LINKED, // One heap node per element
+    FOSSIL_STACK_ARRAY,  // Contiguous array that grows geometrically
+    FOSSIL_STACK_FIXED   // Contiguous buffer of fixed capacity
+} fossil_stack_mode_t;
+
 typedef struct fossil_stack_t {
     char* type; // Type of the stack
     fossil_stack_node_t* top; // Pointer to the top node of the stack
+    fossil_tofu_t* data; // Contiguous storage, bottom first (array and fixed modes)
+    size_t size; // Number of elements (array and fixed modes)
+    size_t capacity; // Allocated elements (array and fixed modes)
+    fossil_stack_mode_t mode; // Storage used by the stack
+    bool owns_data; // Whether data is freed on erase
 } fossil_stack_t;
 
+// Cursor over the elements of a stack, top to bottom
+typedef struct fossil_stack_cursor_t {
+    fossil_stack_t* stack;
+    fossil_stack_node_t* node; // Current node (linked mode), null at the end
+    fossil_stack_node_t* prev; // Node above the current one (linked mode)
+    size_t depth;              // Depth from the top (array and fixed modes), the size at the end
+} fossil_stack_cursor_t;
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -53,6 +81,24 @@ extern "C"
  */
 fossil_stack_t* fossil_stack_create(char* type);
 
+/**
+ * Create a new stack that stores its elements in a contiguous growable array.
+ *
+ * @param type The type of data the stack will store.
+ * @return     The created stack.
+ */
+fossil_stack_t* fossil_stack_create_array(char* type);
+
+/**
+ * Create a new stack with a fixed capacity that never allocates on push.
+ *
+ * @param type     The type of data the stack will store.
+ * @param buffer   Caller-owned storage for capacity elements, or NULL to allocate it once here.
+ * @param capacity The maximum number of elements.
+ * @return         The created stack.
+ */
+fossil_stack_t* fossil_stack_create_fixed(char* type, fossil_tofu_t* buffer, size_t capacity);
+
 /**
  * Erase the contents of the stack and free allocated memory.
  *
@@ -154,6 +200,127 @@ bool fossil_stack_is_cnullptr(const fossil_stack_t* stack);
  */
 fossil_tofu_t fossil_stack_top(fossil_stack_t* stack, fossil_tofu_t default_value);
 
+/**
+ * Get the element at the specified depth without removing it.
+ *
+ * @param stack The stack to peek into.
+ * @param depth The depth from the top, where 0 is the top element.
+ * @param data  A pointer to store the element.
+ * @return      0 on success, -1 if the stack holds fewer elements.
+ */
+int32_t fossil_stack_peek(const fossil_stack_t* stack, size_t depth, fossil_tofu_t* data);
+
+/**
+ * Push a span of elements. The last element of the span ends up on top.
+ *
+ * @param stack    The stack to push onto.
+ * @param elements The elements to push.
+ * @param count    The number of elements.
+ * @return         0 on success, -1 if allocation failed or a fixed stack lacks room (nothing is pushed).
+ */
+int32_t fossil_stack_push_n(fossil_stack_t* stack, const fossil_tofu_t* elements, size_t count);
+
+/**
+ * Pop a span of elements. The former top element is stored first.
+ *
+ * @param stack    The stack to pop from.
+ * @param elements A buffer to store the popped elements.
+ * @param count    The number of elements to pop.
+ * @return         0 on success, -1 if the stack holds fewer elements (nothing is popped).
+ */
+int32_t fossil_stack_pop_n(fossil_stack_t* stack, fossil_tofu_t* elements, size_t count);
+
+/**
+ * Reserve room for at least the specified number of elements.
+ *
+ * @param stack    The stack to reserve room in.
+ * @param capacity The number of elements.
+ * @return         0 on success, -1 if allocation failed or a fixed stack is too small.
+ */
+int32_t fossil_stack_reserve(fossil_stack_t* stack, size_t capacity);
+
+/**
+ * Get the number of elements the stack can hold without allocating.
+ *
+ * @param stack The stack to query.
+ * @return      The capacity, or 0 for a linked stack.
+ */
+size_t fossil_stack_capacity(const fossil_stack_t* stack);
+
+/**
+ * Get a cursor at the top element of the stack.
+ *
+ * @param stack The stack to walk.
+ * @return      A cursor at the top element, or at the end if the stack is empty.
+ */
+fossil_stack_cursor_t fossil_stack_cursor_begin(fossil_stack_t* stack);
+
+/**
+ * Get a cursor past the last element of the stack. In linked mode this walks from the top, so it is O(n).
+ *
+ * @param stack The stack to walk.
+ * @return      A cursor at the end.
+ */
+fossil_stack_cursor_t fossil_stack_cursor_end(fossil_stack_t* stack);
+
+/**
+ * Check if the cursor is at an element rather than at the end.
+ *
+ * @param cursor The cursor to check.
+ * @return       True if the cursor can be dereferenced, false otherwise.
+ */
+bool fossil_stack_cursor_valid(const fossil_stack_cursor_t* cursor);
+
+/**
+ * Move the cursor to the next element. A cursor at the end stays there.
+ *
+ * @param cursor The cursor to move.
+ */
+void fossil_stack_cursor_next(fossil_stack_cursor_t* cursor);
+
+/**
+ * Move the cursor to the previous element. From the end it moves to the last element,
+ * and from the top element it moves to the end. In linked mode this walks from the top, so it is O(n).
+ *
+ * @param cursor The cursor to move.
+ */
+void fossil_stack_cursor_prev(fossil_stack_cursor_t* cursor);
+
+/**
+ * Get the element at the cursor.
+ *
+ * @param cursor The cursor to dereference.
+ * @return       A pointer to the element, or NULL at the end.
+ */
+fossil_tofu_t* fossil_stack_cursor_deref(const fossil_stack_cursor_t* cursor);
+
+/**
+ * Insert data after the element at the cursor. The cursor stays on its element. A fixed stack fails when full.
+ *
+ * @param cursor The cursor to insert after.
+ * @param data   The data to insert.
+ * @return       0 on success, -1 at the end or if allocation failed.
+ */
+int32_t fossil_stack_cursor_insert_after(fossil_stack_cursor_t* cursor, fossil_tofu_t data);
+
+/**
+ * Remove the element at the cursor and move the cursor to the element that followed it.
+ *
+ * @param cursor The cursor to erase at.
+ * @param data   A pointer to store the removed data.
+ * @return       0 on success, -1 at the end.
+ */
+int32_t fossil_stack_cursor_erase(fossil_stack_cursor_t* cursor, fossil_tofu_t* data);
+
+/**
+ * Get the contiguous run of elements starting at the cursor as a tofu iterator. Every mode
+ * stores the element below the cursor elsewhere, so the run is just the cursor element.
+ *
+ * @param cursor The cursor to start from.
+ * @return       An iterator over the run, empty at the end.
+ */
+fossil_tofu_iteratorof_t fossil_stack_cursor_span(const fossil_stack_cursor_t* cursor);
+
 #ifdef __cplusplus
 }
 #endif
@@ -31,14 +31,22 @@ Description:
 #include "fossil/generic/actionof.h"
 
 #define INITIAL_CAPACITY 10
+#define FOSSIL_VECTOR_GROWTH_FACTOR 2.0
 
 typedef struct {
     fossil_tofu_t* data;
     size_t size;
     size_t capacity;
     char* type;
+    double growth_factor; // Capacity multiplier applied when the vector is full
 } fossil_vector_t;
 
+// Cursor over the elements of a vector
+typedef struct fossil_vector_cursor_t {
+    fossil_vector_t* vector;
+    size_t index; // Element index, equal to the size at the end
+} fossil_vector_cursor_t;
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -67,6 +75,63 @@ void fossil_vector_erase(fossil_vector_t* vector);
  */
 void fossil_vector_push_back(fossil_vector_t* vector, fossil_tofu_t element);
 
+/**
+ * Append a span of elements to the end of the vector with a single copy.
+ *
+ * @param vector   The vector to which the elements will be added.
+ * @param elements The elements to add.
+ * @param count    The number of elements to add.
+ * @return         0 on success, -1 on allocation failure.
+ */
+int32_t fossil_vector_append(fossil_vector_t* vector, const fossil_tofu_t* elements, size_t count);
+
+/**
+ * Insert an element before the specified index.
+ *
+ * @param vector  The vector in which to insert.
+ * @param index   The position of the new element (size appends).
+ * @param element The element to insert.
+ * @return        0 on success, -1 if the index is out of range or allocation failed.
+ */
+int32_t fossil_vector_insert(fossil_vector_t* vector, size_t index, fossil_tofu_t element);
+
+/**
+ * Insert a span of elements before the specified index.
+ *
+ * @param vector   The vector in which to insert.
+ * @param index    The position of the first new element (size appends).
+ * @param elements The elements to insert.
+ * @param count    The number of elements to insert.
+ * @return         0 on success, -1 if the index is out of range or allocation failed.
+ */
+int32_t fossil_vector_insert_range(fossil_vector_t* vector, size_t index, const fossil_tofu_t* elements, size_t count);
+
+/**
+ * Remove the element at the specified index, shifting later elements down.
+ *
+ * @param vector The vector from which to remove.
+ * @param index  The index of the element to remove.
+ * @return       0 on success, -1 if the index is out of range.
+ */
+int32_t fossil_vector_remove_at(fossil_vector_t* vector, size_t index);
+
+/**
+ * Remove the elements in [first, first + count), shifting later elements down.
+ *
+ * @param vector The vector from which to remove.
+ * @param first  The index of the first element to remove.
+ * @param count  The number of elements to remove.
+ * @return       0 on success, -1 if the range is out of bounds.
+ */
+int32_t fossil_vector_remove_range(fossil_vector_t* vector, size_t first, size_t count);
+
+/**
+ * Remove all elements while keeping the allocated capacity.
+ *
+ * @param vector The vector to clear.
+ */
+void fossil_vector_clear(fossil_vector_t* vector);
+
 /**
  * Search for a target element in the vector.
  *
@@ -141,6 +206,53 @@ fossil_tofu_t* fossil_vector_getter(const fossil_vector_t* vector, size_t index)
  */
 size_t fossil_vector_size(const fossil_vector_t* vector);
 
+/**
+ * Get the number of elements the vector can hold without reallocating.
+ *
+ * @param vector The vector for which to get the capacity.
+ * @return       The capacity of the vector.
+ */
+size_t fossil_vector_capacity(const fossil_vector_t* vector);
+
+/**
+ * Ensure the vector can hold at least the given number of elements.
+ *
+ * Reserving the final size up front lets a vector be filled with exactly
+ * one allocation.
+ *
+ * @param vector   The vector to reserve space in.
+ * @param capacity The minimum capacity.
+ * @return         0 on success, -1 on allocation failure.
+ */
+int32_t fossil_vector_reserve(fossil_vector_t* vector, size_t capacity);
+
+/**
+ * Change the number of elements, filling new slots with the given value.
+ *
+ * @param vector The vector to resize.
+ * @param size   The new number of elements.
+ * @param value  The value assigned to newly added elements.
+ * @return       0 on success, -1 on allocation failure.
+ */
+int32_t fossil_vector_resize(fossil_vector_t* vector, size_t size, fossil_tofu_t value);
+
+/**
+ * Reduce the capacity of the vector to its size.
+ *
+ * @param vector The vector to shrink.
+ * @return       0 on success, -1 on allocation failure.
+ */
+int32_t fossil_vector_shrink_to_fit(fossil_vector_t* vector);
+
+/**
+ * Set the factor by which the capacity is multiplied when the vector grows.
+ *
+ * @param vector The vector to configure.
+ * @param factor The growth factor, greater than 1.0.
+ * @return       0 on success, -1 if the factor is invalid.
+ */
+int32_t fossil_vector_set_growth_factor(fossil_vector_t* vector, double factor);
+
 /**
  * Display the contents of the vector.
  *
@@ -148,6 +260,79 @@ size_t fossil_vector_size(const fossil_vector_t* vector);
  */
 void fossil_vector_peek(const fossil_vector_t* vector);
 
+/**
+ * Get a cursor at the first element of the vector.
+ *
+ * @param vector The vector to walk.
+ * @return       A cursor at the first element, or at the end if the vector is empty.
+ */
+fossil_vector_cursor_t fossil_vector_cursor_begin(fossil_vector_t* vector);
+
+/**
+ * Get a cursor past the last element of the vector.
+ *
+ * @param vector The vector to walk.
+ * @return       A cursor at the end.
+ */
+fossil_vector_cursor_t fossil_vector_cursor_end(fossil_vector_t* vector);
+
+/**
+ * Check if the cursor is at an element rather than at the end.
+ *
+ * @param cursor The cursor to check.
+ * @return       True if the cursor can be dereferenced, false otherwise.
+ */
+bool fossil_vector_cursor_valid(const fossil_vector_cursor_t* cursor);
+
+/**
+ * Move the cursor to the next element. A cursor at the end stays there.
+ *
+ * @param cursor The cursor to move.
+ */
+void fossil_vector_cursor_next(fossil_vector_cursor_t* cursor);
+
+/**
+ * Move the cursor to the previous element. From the end it moves to the last element,
+ * and from the first element it moves to the end.
+ *
+ * @param cursor The cursor to move.
+ */
+void fossil_vector_cursor_prev(fossil_vector_cursor_t* cursor);
+
+/**
+ * Get the element at the cursor.
+ *
+ * @param cursor The cursor to dereference.
+ * @return       A pointer to the element, or NULL at the end.
+ */
+fossil_tofu_t* fossil_vector_cursor_deref(const fossil_vector_cursor_t* cursor);
+
+/**
+ * Insert data after the element at the cursor. The cursor stays on its element.
+ *
+ * @param cursor The cursor to insert after.
+ * @param data   The data to insert.
+ * @return       0 on success, -1 at the end or if allocation failed.
+ */
+int32_t fossil_vector_cursor_insert_after(fossil_vector_cursor_t* cursor, fossil_tofu_t data);
+
+/**
+ * Remove the element at the cursor and move the cursor to the element that followed it.
+ *
+ * @param cursor The cursor to erase at.
+ * @param data   A pointer to store the removed data.
+ * @return       0 on success, -1 at the end.
+ */
+int32_t fossil_vector_cursor_erase(fossil_vector_cursor_t* cursor, fossil_tofu_t* data);
+
+/**
+ * Get the contiguous run of elements starting at the cursor as a tofu iterator.
+ *
+ * @param cursor The cursor to start from.
+ * @return       An iterator over the run, empty at the end.
+ */
+fossil_tofu_iteratorof_t fossil_vector_cursor_span(const fossil_vector_cursor_t* cursor);
+
 #ifdef __cplusplus
 }
 #endif
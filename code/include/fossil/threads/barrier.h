@@ -24,19 +24,40 @@ Description:
 #include <pthread.h>
 #endif
 
-// Define the barrier structure
+#define FOSSIL_BARRIER_SPIN_LIMIT 4096 /**< Checks a spinning waiter makes before it sleeps. */
+
+/**
+ * @brief How threads wait for the rest of a phase.
+ *
+ * Blocking waiters sleep at once, which suits long phases. Spinning waiters watch the
+ * generation for a bounded number of checks before sleeping, which keeps microsecond
+ * phases off the scheduler when every thread has its own core.
+ */
+typedef enum {
+    FOSSIL_BARRIER_BLOCKING,
+    FOSSIL_BARRIER_SPINNING
+} fossil_xbarrier_mode_t;
+
+/**
+ * @brief Reusable barrier.
+ *
+ * Each phase is a generation. The last thread to arrive resets the count and then advances
+ * the generation, and waiters leave only once the generation they arrived in is over, so
+ * the barrier can be reused at once and spurious wakeups never release a thread early.
+ */
 typedef struct {
 #ifdef _WIN32
-    HANDLE semaphore;   /**< Windows semaphore handle. */
-    atomic_int count;   /**< Count of threads that have reached the barrier. */
-    atomic_int total;   /**< Total number of threads expected to reach the barrier. */
-    CRITICAL_SECTION mutex; /**< Windows critical section for synchronization. */
+    CRITICAL_SECTION mutex;     /**< Windows critical section guarding sleepers. */
+    CONDITION_VARIABLE cond;    /**< Windows condition variable for sleeping waiters. */
 #else
-    pthread_mutex_t mutex;  /**< POSIX mutex for synchronization. */
-    pthread_cond_t cond;    /**< POSIX condition variable for signaling. */
-    atomic_int count;       /**< Count of threads that have reached the barrier. */
-    atomic_int total;       /**< Total number of threads expected to reach the barrier. */
+    pthread_mutex_t mutex;      /**< POSIX mutex guarding sleepers. */
+    pthread_cond_t cond;        /**< POSIX condition variable for sleeping waiters. */
 #endif
+    atomic_int count;           /**< Count of threads that have reached the barrier in this generation. */
+    atomic_int total;           /**< Total number of threads expected to reach the barrier. */
+    atomic_uint generation;     /**< Number of completed phases; its parity is the barrier's sense. */
+    atomic_int sleepers;        /**< Waiters asleep on cond. */
+    fossil_xbarrier_mode_t mode;
 } fossil_xbarrier_t;
 
 #ifdef __cplusplus
@@ -45,7 +66,7 @@ extern "C"
 #endif
 
 /**
- * @brief Initializes a barrier with the specified count.
+ * @brief Initializes a blocking barrier with the specified count.
  *
  * @param barrier Pointer to the barrier to initialize.
  * @param count The count of threads required to reach the barrier.
@@ -53,6 +74,16 @@ extern "C"
  */
 int32_t fossil_barrier_create(fossil_xbarrier_t *barrier, uint32_t count);
 
+/**
+ * @brief Initializes a barrier with the specified count and waiting mode.
+ *
+ * @param barrier Pointer to the barrier to initialize.
+ * @param count The count of threads required to reach the barrier.
+ * @param mode Whether waiters sleep at once or spin first.
+ * @return int32_t 0 if the barrier is successfully initialized, -1 otherwise.
+ */
+int32_t fossil_barrier_create_mode(fossil_xbarrier_t *barrier, uint32_t count, fossil_xbarrier_mode_t mode);
+
 /**
  * @brief Destroys a barrier.
  *
@@ -65,7 +96,7 @@ int32_t fossil_barrier_erase(fossil_xbarrier_t *barrier);
  * @brief Waits for all threads to reach the barrier.
  *
  * @param barrier Pointer to the barrier to wait on.
- * @return int32_t 0 if all threads successfully reach the barrier, -1 otherwise.
+ * @return int32_t 0 for the thread that completed the phase, 1 for the others, -1 on error.
  */
 int32_t fossil_barrier_wait(fossil_xbarrier_t *barrier);
 
@@ -81,8 +112,8 @@ namespace fossil {
 
 class Barrier {
 public:
-    Barrier(uint32_t count) {
-        if (fossil_barrier_create(&barrier_, count) != 0) {
+    Barrier(uint32_t count, fossil_xbarrier_mode_t mode = FOSSIL_BARRIER_BLOCKING) {
+        if (fossil_barrier_create_mode(&barrier_, count, mode) != 0) {
             throw std::runtime_error("Failed to create barrier");
         }
     }
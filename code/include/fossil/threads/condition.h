@@ -54,6 +54,16 @@ int32_t fossil_cond_erase(fossil_xcond_t *cond);
  */
 int32_t fossil_cond_wait(fossil_xcond_t *cond, fossil_xmutex_t *mutex);
 
+/**
+ * @brief Waits for a condition variable to be signaled for at most the given time. The mutex must be locked before calling this function.
+ *
+ * @param cond Pointer to the condition variable to wait on.
+ * @param mutex Pointer to the mutex that is used with the condition variable.
+ * @param milliseconds The longest time to wait.
+ * @return int32_t 0 if the condition variable is signaled (or the wake is spurious), -1 on timeout or error.
+ */
+int32_t fossil_cond_timedwait(fossil_xcond_t *cond, fossil_xmutex_t *mutex, uint32_t milliseconds);
+
 /**
  * @brief Signals a condition variable, waking up one of the threads that are waiting on the condition variable.
  *
@@ -0,0 +1,202 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef FOSSIL_THREADS_EPOCH_H
+#define FOSSIL_THREADS_EPOCH_H
+
+#include "threadlocal.h"
+#include "task.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define FOSSIL_EPOCH_CACHE_LINE 64
+#define FOSSIL_EPOCH_DEFAULT_THRESHOLD 64 // Retirements between attempts to reclaim
+
+/**
+ * @brief Epoch-Based Reclamation
+ *
+ * A lock-free structure cannot free a node it has unlinked while another thread may still be
+ * reading it. With epoch-based reclamation, readers enter a critical section around every access
+ * and writers retire unlinked nodes instead of freeing them. A node retired in epoch e is freed
+ * once the global epoch reaches e + 2, which can only happen after every thread that was inside a
+ * critical section at the time has left it.
+ *
+ * Entering and leaving are a couple of uncontended stores, which makes this the cheapest scheme
+ * for short operations. The catch is that one thread stuck inside a critical section holds up
+ * every retirement in the domain; references held for long should use hazard pointers instead.
+ *
+ * Each thread registers itself on first use through a thread-local key. A thread that exits, or
+ * calls fossil_epoch_unregister, leaves its record and unreclaimed nodes to the next thread that
+ * registers; Windows runs no thread-local destructors, so threads there should unregister.
+ */
+
+// Per-thread state, owned by the domain
+typedef struct fossil_xepoch_record_t fossil_xepoch_record_t;
+
+typedef struct {
+    atomic_uint_fast64_t epoch;                  // Global epoch, moved forward by reclaim
+    char pad[FOSSIL_EPOCH_CACHE_LINE - sizeof(atomic_uint_fast64_t)]; // Keeps the epoch off the line of the fields below
+    _Atomic(fossil_xepoch_record_t *) records;   // Every thread record ever created, never unlinked
+    fossil_xthread_local_t key;                  // The calling thread's record
+    size_t threshold;
+} fossil_xepoch_domain_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Creates an epoch domain.
+ *
+ * @param domain Pointer to the domain to initialize.
+ * @param threshold The number of retirements by a thread between attempts to reclaim, or 0 for FOSSIL_EPOCH_DEFAULT_THRESHOLD.
+ * @return int32_t 0 if the domain is successfully created, -1 otherwise.
+ */
+int32_t fossil_epoch_domain_create(fossil_xepoch_domain_t *domain, size_t threshold);
+
+/**
+ * @brief Destroys an epoch domain, freeing every retired object and every thread record.
+ *
+ * No thread may use the domain during or after the call.
+ *
+ * @param domain Pointer to the domain to destroy.
+ * @return int32_t 0 if the domain is successfully destroyed, -1 otherwise.
+ */
+int32_t fossil_epoch_domain_erase(fossil_xepoch_domain_t *domain);
+
+/**
+ * @brief Enters a critical section. Critical sections nest.
+ *
+ * Objects reached inside the critical section stay valid until it is left, even if they are
+ * retired in the meantime.
+ *
+ * @param domain Pointer to the domain.
+ * @return int32_t 0 on success, -1 if the thread cannot be registered.
+ */
+int32_t fossil_epoch_enter(fossil_xepoch_domain_t *domain);
+
+/**
+ * @brief Leaves a critical section.
+ *
+ * @param domain Pointer to the domain.
+ * @return int32_t 0 on success, -1 if the thread is not inside a critical section.
+ */
+int32_t fossil_epoch_exit(fossil_xepoch_domain_t *domain);
+
+/**
+ * @brief Hands an object that is no longer reachable to the domain, which frees it once no reader can hold it.
+ *
+ * May be called inside or outside a critical section. Every threshold retirements the thread
+ * tries to move the epoch forward and frees what has become safe.
+ *
+ * @param domain Pointer to the domain.
+ * @param ptr The object.
+ * @param free_func The function that frees the object, called with ptr.
+ * @return int32_t 0 on success, -1 if the thread cannot be registered or is out of memory.
+ */
+int32_t fossil_epoch_retire(fossil_xepoch_domain_t *domain, void *ptr, fossil_xtask_func_t free_func);
+
+/**
+ * @brief Tries to move the epoch forward and frees the calling thread's objects that have become safe.
+ *
+ * @param domain Pointer to the domain.
+ * @return size_t The number of objects freed.
+ */
+size_t fossil_epoch_reclaim(fossil_xepoch_domain_t *domain);
+
+/**
+ * @brief Releases the calling thread's record for reuse by another thread.
+ *
+ * The thread must not be inside a critical section. Its unreclaimed objects move with the record.
+ *
+ * @param domain Pointer to the domain.
+ * @return int32_t 0 on success, -1 if the thread is inside a critical section.
+ */
+int32_t fossil_epoch_unregister(fossil_xepoch_domain_t *domain);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+
+#include <stdexcept>
+
+namespace fossil {
+
+class EpochDomain {
+public:
+    explicit EpochDomain(size_t threshold = 0) {
+        if (fossil_epoch_domain_create(&domain_, threshold) != 0) {
+            throw std::runtime_error("Failed to create epoch domain");
+        }
+    }
+
+    ~EpochDomain() {
+        fossil_epoch_domain_erase(&domain_);
+    }
+
+    EpochDomain(const EpochDomain &) = delete;
+    EpochDomain &operator=(const EpochDomain &) = delete;
+
+    // Keeps the calling thread inside a critical section for its lifetime
+    class Guard {
+    public:
+        explicit Guard(EpochDomain &domain) : domain_(domain) {
+            if (fossil_epoch_enter(&domain_.domain_) != 0) {
+                throw std::runtime_error("Failed to enter epoch");
+            }
+        }
+
+        ~Guard() {
+            fossil_epoch_exit(&domain_.domain_);
+        }
+
+        Guard(const Guard &) = delete;
+        Guard &operator=(const Guard &) = delete;
+
+    private:
+        EpochDomain &domain_;
+    };
+
+    template <typename T>
+    void retire(T *ptr) {
+        if (fossil_epoch_retire(&domain_, ptr, &EpochDomain::destroy<T>) != 0) {
+            throw std::runtime_error("Failed to retire object");
+        }
+    }
+
+    size_t reclaim() {
+        return fossil_epoch_reclaim(&domain_);
+    }
+
+    fossil_xepoch_domain_t &get() {
+        return domain_;
+    }
+
+private:
+    template <typename T>
+    static void destroy(void *ptr) {
+        delete static_cast<T *>(ptr);
+    }
+
+    fossil_xepoch_domain_t domain_;
+};
+
+} // namespace fossil
+
+#endif // __cplusplus
+
+#endif
@@ -0,0 +1,474 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef FOSSIL_THREADS_FIBER_H
+#define FOSSIL_THREADS_FIBER_H
+
+#include "mutexs.h"
+#include "condition.h"
+#include "task.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define FOSSIL_FIBER_DEFAULT_STACK (64 * 1024) // Usable stack of a fiber, in bytes
+#define FOSSIL_FIBER_STACK_CACHE 256           // Finished fibers' stacks kept for reuse
+
+/**
+ * @brief Fibers
+ *
+ * A fiber is a task with its own stack that gives up its worker whenever it waits, so thousands
+ * of mostly blocked tasks share a handful of OS threads. A scheduler multiplexes fibers over a
+ * fixed set of worker threads (M:N): a fiber runs until it yields, sleeps, joins or waits on a
+ * fiber mutex, condition or channel, and then the worker switches to the next runnable fiber.
+ * A fiber may resume on a different worker than the one it left.
+ *
+ * Switching saves only the callee-saved registers, with hand-written routines on x86-64 and
+ * AArch64, Windows fibers on Windows and ucontext elsewhere. Stacks are mapped with a guard page
+ * below them, so an overflow faults instead of corrupting memory, and reused across fibers.
+ *
+ * Fibers should block through the calls here: an OS-level blocking call holds its worker until
+ * it returns. Code in a fiber must not rely on thread-local storage across a switch. The fiber
+ * mutex, condition and channel also work from plain threads, which block the usual way.
+ */
+
+typedef struct fossil_xfiber_scheduler_t fossil_xfiber_scheduler_t;
+typedef struct fossil_xfiber_t fossil_xfiber_t;
+
+// Fiber or thread waiting on a fiber mutex, condition or channel, kept on the waiter's stack
+typedef struct fossil_xfiber_waiter_t fossil_xfiber_waiter_t;
+
+typedef struct {
+    fossil_xmutex_t lock;               // Guards the fields below
+    fossil_xcond_t cond;                // Wakes waiting threads
+    int32_t locked;
+    fossil_xfiber_waiter_t *head;       // Waiters, in arrival order
+    fossil_xfiber_waiter_t *tail;
+} fossil_xfiber_mutex_t;
+
+typedef struct {
+    fossil_xmutex_t lock;
+    fossil_xcond_t cond;
+    fossil_xfiber_waiter_t *head;
+    fossil_xfiber_waiter_t *tail;
+} fossil_xfiber_cond_t;
+
+typedef struct {
+    fossil_xfiber_mutex_t mutex;
+    fossil_xfiber_cond_t not_empty;
+    fossil_xfiber_cond_t not_full;
+    void **items;                       // Ring buffer of capacity items
+    size_t capacity;
+    size_t head;
+    size_t count;
+    int32_t closed;
+} fossil_xfiber_channel_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Creates a fiber scheduler and starts its worker threads.
+ *
+ * @param workers The number of worker threads.
+ * @param stack_size The usable stack size of each fiber in bytes, or 0 for FOSSIL_FIBER_DEFAULT_STACK.
+ * @return fossil_xfiber_scheduler_t* The scheduler, or NULL on failure.
+ */
+fossil_xfiber_scheduler_t* fossil_fiber_scheduler_create(int32_t workers, size_t stack_size);
+
+/**
+ * @brief Waits for every fiber to finish, then stops the workers and destroys the scheduler.
+ *
+ * Fibers that were not detached must be joined before the scheduler is destroyed.
+ *
+ * @param scheduler The scheduler.
+ * @return int32_t 0 on success, -1 if the scheduler is NULL or called from one of its fibers.
+ */
+int32_t fossil_fiber_scheduler_erase(fossil_xfiber_scheduler_t *scheduler);
+
+/**
+ * @brief Starts a fiber. May be called from a fiber or from any thread.
+ *
+ * @param scheduler The scheduler that runs the fiber.
+ * @param task_func The function the fiber runs.
+ * @param arg The argument passed to the function.
+ * @return fossil_xfiber_t* The fiber, to be joined or detached, or NULL on failure.
+ */
+fossil_xfiber_t* fossil_fiber_spawn(fossil_xfiber_scheduler_t *scheduler, fossil_xtask_func_t task_func, void *arg);
+
+/**
+ * @brief Waits for a fiber to finish and releases it. A fiber waiting here frees its worker.
+ *
+ * @param fiber The fiber.
+ * @return int32_t 0 on success, -1 if the fiber is NULL or is the caller.
+ */
+int32_t fossil_fiber_join(fossil_xfiber_t *fiber);
+
+/**
+ * @brief Lets a fiber release itself when it finishes.
+ *
+ * @param fiber The fiber.
+ * @return int32_t 0 on success, -1 if the fiber is NULL.
+ */
+int32_t fossil_fiber_detach(fossil_xfiber_t *fiber);
+
+/**
+ * @brief Lets other runnable fibers run; returns at once if none are waiting.
+ *
+ * Outside a fiber this yields the thread.
+ */
+void fossil_fiber_yield(void);
+
+/**
+ * @brief Suspends the calling fiber for at least the given time, freeing its worker.
+ *
+ * Outside a fiber this sleeps the thread.
+ *
+ * @param milliseconds The time to sleep.
+ */
+void fossil_fiber_sleep(uint32_t milliseconds);
+
+/**
+ * @brief Gets the fiber running on the calling thread.
+ *
+ * @return fossil_xfiber_t* The fiber, or NULL outside a fiber.
+ */
+fossil_xfiber_t* fossil_fiber_current(void);
+
+/**
+ * @brief Initializes a fiber mutex.
+ *
+ * @param mutex Pointer to the mutex.
+ * @return int32_t 0 on success, -1 otherwise.
+ */
+int32_t fossil_fiber_mutex_create(fossil_xfiber_mutex_t *mutex);
+
+/**
+ * @brief Destroys a fiber mutex, which must be unlocked with no waiters.
+ *
+ * @param mutex Pointer to the mutex.
+ * @return int32_t 0 on success, -1 otherwise.
+ */
+int32_t fossil_fiber_mutex_erase(fossil_xfiber_mutex_t *mutex);
+
+/**
+ * @brief Locks a fiber mutex. A fiber that has to wait frees its worker; waiters get the mutex in order.
+ *
+ * @param mutex Pointer to the mutex.
+ * @return int32_t 0 on success, -1 otherwise.
+ */
+int32_t fossil_fiber_mutex_lock(fossil_xfiber_mutex_t *mutex);
+
+/**
+ * @brief Locks a fiber mutex if it is free.
+ *
+ * @param mutex Pointer to the mutex.
+ * @return int32_t 0 if the mutex is locked, -1 otherwise.
+ */
+int32_t fossil_fiber_mutex_trylock(fossil_xfiber_mutex_t *mutex);
+
+/**
+ * @brief Unlocks a fiber mutex, handing it to the first waiter if there is one.
+ *
+ * @param mutex Pointer to the mutex.
+ * @return int32_t 0 on success, -1 otherwise.
+ */
+int32_t fossil_fiber_mutex_unlock(fossil_xfiber_mutex_t *mutex);
+
+/**
+ * @brief Initializes a fiber condition variable.
+ *
+ * @param cond Pointer to the condition variable.
+ * @return int32_t 0 on success, -1 otherwise.
+ */
+int32_t fossil_fiber_cond_create(fossil_xfiber_cond_t *cond);
+
+/**
+ * @brief Destroys a fiber condition variable, which must have no waiters.
+ *
+ * @param cond Pointer to the condition variable.
+ * @return int32_t 0 on success, -1 otherwise.
+ */
+int32_t fossil_fiber_cond_erase(fossil_xfiber_cond_t *cond);
+
+/**
+ * @brief Unlocks a fiber mutex, waits for a signal and locks the mutex again.
+ *
+ * Wake-ups only come from signal and broadcast, but the condition should still be checked in a loop.
+ *
+ * @param cond Pointer to the condition variable.
+ * @param mutex Pointer to the fiber mutex, locked by the caller.
+ * @return int32_t 0 on success, -1 otherwise.
+ */
+int32_t fossil_fiber_cond_wait(fossil_xfiber_cond_t *cond, fossil_xfiber_mutex_t *mutex);
+
+/**
+ * @brief Wakes the longest waiting fiber or thread.
+ *
+ * @param cond Pointer to the condition variable.
+ * @return int32_t 0 on success, -1 otherwise.
+ */
+int32_t fossil_fiber_cond_signal(fossil_xfiber_cond_t *cond);
+
+/**
+ * @brief Wakes every waiting fiber and thread.
+ *
+ * @param cond Pointer to the condition variable.
+ * @return int32_t 0 on success, -1 otherwise.
+ */
+int32_t fossil_fiber_cond_broadcast(fossil_xfiber_cond_t *cond);
+
+/**
+ * @brief Initializes a bounded channel of pointers.
+ *
+ * @param channel Pointer to the channel.
+ * @param capacity The number of items the channel holds, at least 1.
+ * @return int32_t 0 on success, -1 otherwise.
+ */
+int32_t fossil_fiber_channel_create(fossil_xfiber_channel_t *channel, size_t capacity);
+
+/**
+ * @brief Destroys a channel. Items still in it are dropped.
+ *
+ * @param channel Pointer to the channel.
+ * @return int32_t 0 on success, -1 otherwise.
+ */
+int32_t fossil_fiber_channel_erase(fossil_xfiber_channel_t *channel);
+
+/**
+ * @brief Sends an item, waiting while the channel is full.
+ *
+ * @param channel Pointer to the channel.
+ * @param item The item.
+ * @return int32_t 0 on success, -1 if the channel is closed.
+ */
+int32_t fossil_fiber_channel_send(fossil_xfiber_channel_t *channel, void *item);
+
+/**
+ * @brief Receives the oldest item, waiting while the channel is empty.
+ *
+ * @param channel Pointer to the channel.
+ * @param item Pointer to store the item.
+ * @return int32_t 0 on success, -1 once the channel is closed and empty.
+ */
+int32_t fossil_fiber_channel_recv(fossil_xfiber_channel_t *channel, void **item);
+
+/**
+ * @brief Closes a channel: sends fail from now on and receivers drain what is left.
+ *
+ * @param channel Pointer to the channel.
+ * @return int32_t 0 on success, -1 otherwise.
+ */
+int32_t fossil_fiber_channel_close(fossil_xfiber_channel_t *channel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+namespace fossil {
+
+class FiberScheduler {
+public:
+    explicit FiberScheduler(int32_t workers, size_t stack_size = 0)
+        : scheduler_(fossil_fiber_scheduler_create(workers, stack_size)) {
+        if (!scheduler_) {
+            throw std::runtime_error("Failed to create fiber scheduler");
+        }
+    }
+
+    ~FiberScheduler() {
+        fossil_fiber_scheduler_erase(scheduler_);
+    }
+
+    FiberScheduler(const FiberScheduler &) = delete;
+    FiberScheduler &operator=(const FiberScheduler &) = delete;
+
+    fossil_xfiber_scheduler_t *get() {
+        return scheduler_;
+    }
+
+private:
+    fossil_xfiber_scheduler_t *scheduler_;
+};
+
+// A fiber running a callable; it is joined on destruction unless joined or detached first
+class Fiber {
+public:
+    Fiber(FiberScheduler &scheduler, std::function<void()> func)
+        : func_(new std::function<void()>(std::move(func))) {
+        fiber_ = fossil_fiber_spawn(scheduler.get(), &Fiber::run, func_);
+        if (!fiber_) {
+            delete func_;
+            throw std::runtime_error("Failed to spawn fiber");
+        }
+    }
+
+    ~Fiber() {
+        if (fiber_) {
+            join();
+        }
+    }
+
+    Fiber(const Fiber &) = delete;
+    Fiber &operator=(const Fiber &) = delete;
+
+    void join() {
+        if (!fiber_ || fossil_fiber_join(fiber_) != 0) {
+            throw std::runtime_error("Failed to join fiber");
+        }
+        fiber_ = nullptr;
+    }
+
+    void detach() {
+        if (!fiber_ || fossil_fiber_detach(fiber_) != 0) {
+            throw std::runtime_error("Failed to detach fiber");
+        }
+        fiber_ = nullptr;
+    }
+
+private:
+    // The fiber owns the callable and frees it when done, so detaching is safe
+    static void run(void *arg) {
+        std::function<void()> *func = static_cast<std::function<void()> *>(arg);
+        (*func)();
+        delete func;
+    }
+
+    std::function<void()> *func_;
+    fossil_xfiber_t *fiber_;
+};
+
+// Meets the Lockable requirements, so std::unique_lock and std::lock_guard work too
+class FiberMutex {
+public:
+    FiberMutex() {
+        if (fossil_fiber_mutex_create(&mutex_) != 0) {
+            throw std::runtime_error("Failed to create fiber mutex");
+        }
+    }
+
+    ~FiberMutex() {
+        fossil_fiber_mutex_erase(&mutex_);
+    }
+
+    FiberMutex(const FiberMutex &) = delete;
+    FiberMutex &operator=(const FiberMutex &) = delete;
+
+    void lock() {
+        fossil_fiber_mutex_lock(&mutex_);
+    }
+
+    bool try_lock() {
+        return fossil_fiber_mutex_trylock(&mutex_) == 0;
+    }
+
+    void unlock() {
+        fossil_fiber_mutex_unlock(&mutex_);
+    }
+
+    fossil_xfiber_mutex_t *get() {
+        return &mutex_;
+    }
+
+private:
+    fossil_xfiber_mutex_t mutex_;
+};
+
+class FiberCond {
+public:
+    FiberCond() {
+        if (fossil_fiber_cond_create(&cond_) != 0) {
+            throw std::runtime_error("Failed to create fiber condition variable");
+        }
+    }
+
+    ~FiberCond() {
+        fossil_fiber_cond_erase(&cond_);
+    }
+
+    FiberCond(const FiberCond &) = delete;
+    FiberCond &operator=(const FiberCond &) = delete;
+
+    void wait(FiberMutex &mutex) {
+        fossil_fiber_cond_wait(&cond_, mutex.get());
+    }
+
+    template <typename Predicate>
+    void wait(FiberMutex &mutex, Predicate predicate) {
+        while (!predicate()) {
+            wait(mutex);
+        }
+    }
+
+    void signal() {
+        fossil_fiber_cond_signal(&cond_);
+    }
+
+    void broadcast() {
+        fossil_fiber_cond_broadcast(&cond_);
+    }
+
+private:
+    fossil_xfiber_cond_t cond_;
+};
+
+// A bounded channel of pointers to T; the channel does not own what the pointers point at
+template <typename T>
+class Channel {
+public:
+    explicit Channel(size_t capacity) {
+        if (fossil_fiber_channel_create(&channel_, capacity) != 0) {
+            throw std::runtime_error("Failed to create channel");
+        }
+    }
+
+    ~Channel() {
+        fossil_fiber_channel_erase(&channel_);
+    }
+
+    Channel(const Channel &) = delete;
+    Channel &operator=(const Channel &) = delete;
+
+    bool send(T *item) {
+        return fossil_fiber_channel_send(&channel_, item) == 0;
+    }
+
+    bool recv(T *&item) {
+        void *raw = nullptr;
+        if (fossil_fiber_channel_recv(&channel_, &raw) != 0) {
+            return false;
+        }
+        item = static_cast<T *>(raw);
+        return true;
+    }
+
+    void close() {
+        fossil_fiber_channel_close(&channel_);
+    }
+
+private:
+    fossil_xfiber_channel_t channel_;
+};
+
+} // namespace fossil
+
+#endif // __cplusplus
+
+#endif
@@ -0,0 +1,310 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef FOSSIL_THREADS_FUTURE_H
+#define FOSSIL_THREADS_FUTURE_H
+
+#include "threadpool.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Result of a task or promise, shared by the submitter and the worker that completes it
+typedef struct fossil_xfuture_t fossil_xfuture_t;
+
+// Task that produces a result
+typedef void* (*fossil_xfuture_func_t)(void *arg);
+
+// Continuation that receives the result of the future it follows
+typedef void* (*fossil_xfuture_then_func_t)(void *result, void *arg);
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Submits a task to a thread pool and returns a future for its result.
+ *
+ * The future and the task share a single allocation. If the pool queue is full the task
+ * runs on the calling thread before this function returns.
+ *
+ * @param pool Pointer to the thread pool.
+ * @param func The task function, whose return value becomes the result.
+ * @param arg The argument passed to the task function.
+ * @return fossil_xfuture_t* The future, or NULL on allocation failure. Release it with fossil_future_erase.
+ */
+fossil_xfuture_t* fossil_thread_pool_submit(fossil_xthread_pool_t *pool, fossil_xfuture_func_t func, void *arg);
+
+/**
+ * @brief Submits a task whose argument is stored inside the future's allocation.
+ *
+ * init constructs the payload before the task is queued; func receives the payload as its
+ * argument; destroy, if not NULL, runs on the payload when the future is freed. The payload
+ * is aligned for any type, which lets wrappers keep a closure and its result in the future.
+ *
+ * @param pool Pointer to the thread pool.
+ * @param func The task function.
+ * @param payload_size The number of payload bytes.
+ * @param init Function that constructs the payload from ctx.
+ * @param ctx The argument passed to init.
+ * @param destroy Function that destroys the payload, or NULL.
+ * @return fossil_xfuture_t* The future, or NULL on allocation failure.
+ */
+fossil_xfuture_t* fossil_thread_pool_submit_payload(fossil_xthread_pool_t *pool, fossil_xfuture_func_t func,
+                                                    size_t payload_size, void (*init)(void *payload, void *ctx),
+                                                    void *ctx, void (*destroy)(void *payload));
+
+/**
+ * @brief Creates a promise: a future completed by calling fossil_future_set.
+ *
+ * @return fossil_xfuture_t* The future, or NULL on allocation failure.
+ */
+fossil_xfuture_t* fossil_future_create(void);
+
+/**
+ * @brief Completes a promise with a result, waking its waiters and starting its continuations.
+ *
+ * @param future Pointer to the future created by fossil_future_create.
+ * @param result The result.
+ * @return int32_t 0 on success, -1 if the future is already complete.
+ */
+int32_t fossil_future_set(fossil_xfuture_t *future, void *result);
+
+/**
+ * @brief Releases the caller's reference to a future. A running task keeps its future alive.
+ *
+ * @param future Pointer to the future.
+ */
+void fossil_future_erase(fossil_xfuture_t *future);
+
+/**
+ * @brief Checks whether a future is complete without blocking.
+ *
+ * @param future Pointer to the future.
+ * @return bool true if the result is available.
+ */
+bool fossil_future_is_ready(const fossil_xfuture_t *future);
+
+/**
+ * @brief Blocks until a future is complete.
+ *
+ * Waiting inside a pool task on a future of the same pool can deadlock if every worker waits.
+ *
+ * @param future Pointer to the future.
+ * @return int32_t 0 on success, -1 if the future is NULL.
+ */
+int32_t fossil_future_wait(fossil_xfuture_t *future);
+
+/**
+ * @brief Blocks until a future is complete or the timeout expires.
+ *
+ * @param future Pointer to the future.
+ * @param milliseconds The longest time to wait.
+ * @return int32_t 0 if the future is complete, -1 on timeout.
+ */
+int32_t fossil_future_wait_for(fossil_xfuture_t *future, uint32_t milliseconds);
+
+/**
+ * @brief Blocks until a future is complete and returns its result.
+ *
+ * @param future Pointer to the future.
+ * @return void* The result, or NULL if the future is NULL.
+ */
+void* fossil_future_get(fossil_xfuture_t *future);
+
+/**
+ * @brief Schedules a continuation on a pool once a future is complete.
+ *
+ * The continuation receives the result of the future. If the future is already complete the
+ * continuation is queued at once.
+ *
+ * @param future Pointer to the future to follow.
+ * @param pool Pointer to the thread pool that runs the continuation.
+ * @param func The continuation, whose return value becomes the result of the new future.
+ * @param arg The second argument passed to the continuation.
+ * @return fossil_xfuture_t* A future for the continuation's result, or NULL on allocation failure.
+ */
+fossil_xfuture_t* fossil_future_then(fossil_xfuture_t *future, fossil_xthread_pool_t *pool,
+                                     fossil_xfuture_then_func_t func, void *arg);
+
+/**
+ * @brief Creates a future that completes when every given future is complete.
+ *
+ * Its result is the number of futures, cast to a pointer; read the individual results from the futures.
+ *
+ * @param futures Array of futures, which the caller keeps owning.
+ * @param count The number of futures. With zero the new future is complete at once.
+ * @return fossil_xfuture_t* The combined future, or NULL on allocation failure.
+ */
+fossil_xfuture_t* fossil_future_when_all(fossil_xfuture_t **futures, size_t count);
+
+/**
+ * @brief Creates a future that completes when any of the given futures is complete.
+ *
+ * Its result is the first future to complete, as a fossil_xfuture_t pointer.
+ *
+ * @param futures Array of futures, which the caller keeps owning.
+ * @param count The number of futures, at least one.
+ * @return fossil_xfuture_t* The combined future, or NULL on allocation failure or if count is zero.
+ */
+fossil_xfuture_t* fossil_future_when_any(fossil_xfuture_t **futures, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace fossil {
+
+namespace detail {
+
+// Outcome of a C++ task, stored in the payload of its future
+template <typename T>
+struct FutureState {
+    std::conditional_t<std::is_void_v<T>, std::monostate, std::optional<T>> value;
+    std::exception_ptr error;
+};
+
+template <typename F, typename T>
+struct FutureTask : FutureState<T> {
+    F func;
+
+    explicit FutureTask(F &&f) : func(std::move(f)) {}
+
+    static void init(void *payload, void *ctx) {
+        new (payload) FutureTask(std::move(*static_cast<F*>(ctx)));
+    }
+
+    static void destroy(void *payload) {
+        static_cast<FutureTask*>(payload)->~FutureTask();
+    }
+
+    static void *run(void *payload) {
+        FutureTask *task = static_cast<FutureTask*>(payload);
+        try {
+            if constexpr (std::is_void_v<T>) {
+                task->func();
+            } else {
+                task->value.emplace(task->func());
+            }
+        } catch (...) {
+            task->error = std::current_exception();
+        }
+        return static_cast<FutureState<T>*>(task);
+    }
+};
+
+} // namespace detail
+
+template <typename T>
+class Future {
+public:
+    Future() = default;
+
+    explicit Future(fossil_xfuture_t *future) : future_(future) {}
+
+    Future(Future &&other) noexcept : future_(std::exchange(other.future_, nullptr)) {}
+
+    Future &operator=(Future &&other) noexcept {
+        if (this != &other) {
+            reset();
+            future_ = std::exchange(other.future_, nullptr);
+        }
+        return *this;
+    }
+
+    Future(const Future &) = delete;
+    Future &operator=(const Future &) = delete;
+
+    ~Future() {
+        reset();
+    }
+
+    bool valid() const {
+        return future_ != nullptr;
+    }
+
+    bool isReady() const {
+        return fossil_future_is_ready(future_);
+    }
+
+    void wait() const {
+        if (fossil_future_wait(future_) != 0) {
+            throw std::runtime_error("Failed to wait on future");
+        }
+    }
+
+    bool waitFor(uint32_t milliseconds) const {
+        return fossil_future_wait_for(future_, milliseconds) == 0;
+    }
+
+    // Waits for the task, rethrows its exception, and returns a reference to its result
+    decltype(auto) get() {
+        auto *state = static_cast<detail::FutureState<T>*>(fossil_future_get(future_));
+        if (!state) {
+            throw std::runtime_error("Failed to get future result");
+        }
+        if (state->error) {
+            std::rethrow_exception(state->error);
+        }
+        if constexpr (!std::is_void_v<T>) {
+            return static_cast<T&>(*state->value);
+        }
+    }
+
+    fossil_xfuture_t *native() const {
+        return future_;
+    }
+
+private:
+    void reset() {
+        if (future_) {
+            fossil_future_erase(future_);
+            future_ = nullptr;
+        }
+    }
+
+    fossil_xfuture_t *future_ = nullptr;
+};
+
+template <typename F>
+auto ThreadPool::submit(F &&func) {
+    using Task = std::decay_t<F>;
+    using Result = std::invoke_result_t<Task&>;
+    using Payload = detail::FutureTask<Task, Result>;
+    static_assert(alignof(Payload) <= alignof(std::max_align_t), "task is over-aligned for a future payload");
+
+    Task callable(std::forward<F>(func));
+    fossil_xfuture_t *future = fossil_thread_pool_submit_payload(&pool_, Payload::run, sizeof(Payload),
+                                                                 Payload::init, &callable, Payload::destroy);
+    if (!future) {
+        throw std::runtime_error("Failed to submit task to thread pool");
+    }
+    return Future<Result>(future);
+}
+
+} // namespace fossil
+
+#endif // __cplusplus
+
+#endif
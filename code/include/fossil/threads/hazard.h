@@ -0,0 +1,199 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef FOSSIL_THREADS_HAZARD_H
+#define FOSSIL_THREADS_HAZARD_H
+
+#include "threadlocal.h"
+#include "task.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define FOSSIL_HAZARD_SLOTS 4              // Hazard pointers per thread
+#define FOSSIL_HAZARD_DEFAULT_THRESHOLD 64 // Smallest number of retired objects that triggers a scan
+
+/**
+ * @brief Hazard Pointers
+ *
+ * A hazard pointer is a slot in which a thread publishes the object it is about to use. An
+ * object retired by a writer is freed only once a scan finds it in no thread's slots, so a
+ * reader can hold a reference for as long as it likes without holding up the reclamation of
+ * anything else, and a stalled thread pins at most FOSSIL_HAZARD_SLOTS objects.
+ *
+ * The price is paid per object: each protected load publishes the pointer behind a full fence
+ * and reads the source again to check that the object was not unlinked in between. For short
+ * operations over many nodes, epoch-based reclamation is cheaper.
+ *
+ * A thread scans once its retired list reaches twice the total number of hazard pointers, and
+ * at least the threshold, so each scan frees a constant fraction of the list. Threads register
+ * like in the epoch domain: on first use, giving their record up on exit or on unregister.
+ */
+
+// Per-thread state, owned by the domain
+typedef struct fossil_xhazard_record_t fossil_xhazard_record_t;
+
+typedef struct {
+    _Atomic(fossil_xhazard_record_t *) records;  // Every thread record ever created, never unlinked
+    atomic_size_t record_count;
+    fossil_xthread_local_t key;                  // The calling thread's record
+    size_t threshold;
+} fossil_xhazard_domain_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Creates a hazard pointer domain.
+ *
+ * @param domain Pointer to the domain to initialize.
+ * @param threshold The smallest number of retired objects that triggers a scan, or 0 for FOSSIL_HAZARD_DEFAULT_THRESHOLD.
+ * @return int32_t 0 if the domain is successfully created, -1 otherwise.
+ */
+int32_t fossil_hazard_domain_create(fossil_xhazard_domain_t *domain, size_t threshold);
+
+/**
+ * @brief Destroys a hazard pointer domain, freeing every retired object and every thread record.
+ *
+ * No thread may use the domain during or after the call.
+ *
+ * @param domain Pointer to the domain to destroy.
+ * @return int32_t 0 if the domain is successfully destroyed, -1 otherwise.
+ */
+int32_t fossil_hazard_domain_erase(fossil_xhazard_domain_t *domain);
+
+/**
+ * @brief Loads a pointer and protects the object it points at until the slot is cleared or reused.
+ *
+ * @param domain Pointer to the domain.
+ * @param slot The hazard pointer to use, below FOSSIL_HAZARD_SLOTS.
+ * @param source The shared pointer to load.
+ * @return void* The protected pointer, or NULL if the source holds NULL or the arguments are invalid.
+ */
+void* fossil_hazard_protect(fossil_xhazard_domain_t *domain, size_t slot, _Atomic(void *) *source);
+
+/**
+ * @brief Publishes a pointer in a slot without checking it.
+ *
+ * The caller must check that the object is still reachable afterwards, as fossil_hazard_protect does.
+ * Copying a pointer from another slot of the same thread is always safe.
+ *
+ * @param domain Pointer to the domain.
+ * @param slot The hazard pointer to use, below FOSSIL_HAZARD_SLOTS.
+ * @param ptr The pointer to publish.
+ * @return int32_t 0 on success, -1 otherwise.
+ */
+int32_t fossil_hazard_set(fossil_xhazard_domain_t *domain, size_t slot, void *ptr);
+
+/**
+ * @brief Clears a slot, giving up the protection of its object.
+ *
+ * @param domain Pointer to the domain.
+ * @param slot The hazard pointer to clear.
+ * @return int32_t 0 on success, -1 otherwise.
+ */
+int32_t fossil_hazard_clear(fossil_xhazard_domain_t *domain, size_t slot);
+
+/**
+ * @brief Hands an object that is no longer reachable to the domain, which frees it once no slot holds it.
+ *
+ * @param domain Pointer to the domain.
+ * @param ptr The object.
+ * @param free_func The function that frees the object, called with ptr.
+ * @return int32_t 0 on success, -1 if the thread cannot be registered or is out of memory.
+ */
+int32_t fossil_hazard_retire(fossil_xhazard_domain_t *domain, void *ptr, fossil_xtask_func_t free_func);
+
+/**
+ * @brief Scans every slot and frees the calling thread's retired objects that no slot holds.
+ *
+ * @param domain Pointer to the domain.
+ * @return size_t The number of objects freed.
+ */
+size_t fossil_hazard_reclaim(fossil_xhazard_domain_t *domain);
+
+/**
+ * @brief Clears the calling thread's slots and releases its record for reuse by another thread.
+ *
+ * Its unreclaimed objects move with the record.
+ *
+ * @param domain Pointer to the domain.
+ * @return int32_t 0 on success, -1 otherwise.
+ */
+int32_t fossil_hazard_unregister(fossil_xhazard_domain_t *domain);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+
+#include <stdexcept>
+
+namespace fossil {
+
+class HazardDomain {
+public:
+    explicit HazardDomain(size_t threshold = 0) {
+        if (fossil_hazard_domain_create(&domain_, threshold) != 0) {
+            throw std::runtime_error("Failed to create hazard pointer domain");
+        }
+    }
+
+    ~HazardDomain() {
+        fossil_hazard_domain_erase(&domain_);
+    }
+
+    HazardDomain(const HazardDomain &) = delete;
+    HazardDomain &operator=(const HazardDomain &) = delete;
+
+    template <typename T>
+    T *protect(size_t slot, _Atomic(void *) &source) {
+        return static_cast<T *>(fossil_hazard_protect(&domain_, slot, &source));
+    }
+
+    void clear(size_t slot) {
+        fossil_hazard_clear(&domain_, slot);
+    }
+
+    template <typename T>
+    void retire(T *ptr) {
+        if (fossil_hazard_retire(&domain_, ptr, &HazardDomain::destroy<T>) != 0) {
+            throw std::runtime_error("Failed to retire object");
+        }
+    }
+
+    size_t reclaim() {
+        return fossil_hazard_reclaim(&domain_);
+    }
+
+    fossil_xhazard_domain_t &get() {
+        return domain_;
+    }
+
+private:
+    template <typename T>
+    static void destroy(void *ptr) {
+        delete static_cast<T *>(ptr);
+    }
+
+    fossil_xhazard_domain_t domain_;
+};
+
+} // namespace fossil
+
+#endif // __cplusplus
+
+#endif
@@ -0,0 +1,282 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef FOSSIL_THREADS_PARALLEL_H
+#define FOSSIL_THREADS_PARALLEL_H
+
+#include "threadpool.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Data-parallel loops over a thread pool.
+ *
+ * A range is split into chunks that the calling thread and up to one helper task per pool
+ * worker claim from a shared counter. The caller always works on the range itself and only
+ * waits for chunks that another thread has already started, so the functions can be called
+ * from inside pool tasks, nested to any depth, without deadlock; on a busy pool they simply
+ * run on the caller.
+ *
+ * Static scheduling cuts the range into one equal chunk per participant. Dynamic scheduling
+ * hands out guided chunks: each claim takes a share of what is left, never less than the grain,
+ * so early chunks are large and the tail balances. Reductions and scans keep their chunks in
+ * range order, so combiners need to be associative but not commutative.
+ */
+
+// How a range is split into chunks
+typedef enum {
+    FOSSIL_PARALLEL_STATIC,
+    FOSSIL_PARALLEL_DYNAMIC
+} fossil_xparallel_schedule_t;
+
+// Loop body over the half-open range [begin, end)
+typedef void (*fossil_xparallel_func_t)(int64_t begin, int64_t end, void *ctx);
+
+// Accumulates the range [begin, end) into partial
+typedef void (*fossil_xparallel_reduce_func_t)(int64_t begin, int64_t end, void *partial, void *ctx);
+
+// Combines value into accum, as accum = accum op value
+typedef void (*fossil_xparallel_combine_func_t)(void *accum, const void *value, void *ctx);
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Runs a loop body over a range with dynamic (guided) scheduling.
+ *
+ * @param pool Pointer to the thread pool that lends helpers, or NULL to run on the caller.
+ * @param begin The first index.
+ * @param end One past the last index.
+ * @param grain The smallest chunk, or 0 to pick one from the range and the pool size.
+ * @param fn The loop body, called once per chunk.
+ * @param ctx The argument passed to the body.
+ * @return int32_t 0 on success, -1 on invalid arguments or allocation failure.
+ */
+int32_t fossil_parallel_for(fossil_xthread_pool_t *pool, int64_t begin, int64_t end, int64_t grain,
+                            fossil_xparallel_func_t fn, void *ctx);
+
+/**
+ * @brief Runs a loop body over a range with the given scheduling.
+ *
+ * @param pool Pointer to the thread pool that lends helpers, or NULL to run on the caller.
+ * @param begin The first index.
+ * @param end One past the last index.
+ * @param grain The smallest chunk, or 0 to pick one from the range and the pool size.
+ * @param schedule Static or dynamic chunking.
+ * @param fn The loop body, called once per chunk.
+ * @param ctx The argument passed to the body.
+ * @return int32_t 0 on success, -1 on invalid arguments or allocation failure.
+ */
+int32_t fossil_parallel_for_schedule(fossil_xthread_pool_t *pool, int64_t begin, int64_t end, int64_t grain,
+                                     fossil_xparallel_schedule_t schedule, fossil_xparallel_func_t fn, void *ctx);
+
+/**
+ * @brief Reduces a range to a single value.
+ *
+ * Every chunk starts from a copy of identity and is accumulated by fn; the chunk results are
+ * then combined into result in range order. Values are copied with memcpy.
+ *
+ * @param pool Pointer to the thread pool that lends helpers, or NULL to run on the caller.
+ * @param begin The first index.
+ * @param end One past the last index.
+ * @param grain The smallest chunk, or 0 to pick one from the range and the pool size.
+ * @param schedule Static or dynamic chunking.
+ * @param result Where to store the reduced value.
+ * @param value_size The size of a value in bytes.
+ * @param identity The identity value of the combiner.
+ * @param fn Accumulates a chunk into a partial value.
+ * @param combine Combines two partial values.
+ * @param ctx The argument passed to fn and combine.
+ * @return int32_t 0 on success, -1 on invalid arguments or allocation failure.
+ */
+int32_t fossil_parallel_reduce(fossil_xthread_pool_t *pool, int64_t begin, int64_t end, int64_t grain,
+                               fossil_xparallel_schedule_t schedule, void *result, size_t value_size,
+                               const void *identity, fossil_xparallel_reduce_func_t fn,
+                               fossil_xparallel_combine_func_t combine, void *ctx);
+
+/**
+ * @brief Computes the inclusive prefix sums of an array: output[i] = input[0] op ... op input[i].
+ *
+ * Runs in two passes, chunk totals then chunk scans. output may be the same array as input.
+ *
+ * @param pool Pointer to the thread pool that lends helpers, or NULL to run on the caller.
+ * @param input The input values.
+ * @param output The output values.
+ * @param count The number of values.
+ * @param value_size The size of a value in bytes.
+ * @param identity The identity value of the combiner.
+ * @param combine The associative operator.
+ * @param ctx The argument passed to combine.
+ * @return int32_t 0 on success, -1 on invalid arguments or allocation failure.
+ */
+int32_t fossil_parallel_inclusive_scan(fossil_xthread_pool_t *pool, const void *input, void *output, size_t count,
+                                       size_t value_size, const void *identity,
+                                       fossil_xparallel_combine_func_t combine, void *ctx);
+
+/**
+ * @brief Computes the exclusive prefix sums of an array: output[0] = identity, output[i] = input[0] op ... op input[i - 1].
+ *
+ * Runs in two passes, chunk totals then chunk scans. output may be the same array as input.
+ *
+ * @param pool Pointer to the thread pool that lends helpers, or NULL to run on the caller.
+ * @param input The input values.
+ * @param output The output values.
+ * @param count The number of values.
+ * @param value_size The size of a value in bytes.
+ * @param identity The identity value of the combiner.
+ * @param combine The associative operator.
+ * @param ctx The argument passed to combine.
+ * @return int32_t 0 on success, -1 on invalid arguments or allocation failure.
+ */
+int32_t fossil_parallel_exclusive_scan(fossil_xthread_pool_t *pool, const void *input, void *output, size_t count,
+                                       size_t value_size, const void *identity,
+                                       fossil_xparallel_combine_func_t combine, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace fossil {
+
+namespace detail {
+
+// Keeps the first exception thrown by a loop body and skips the remaining chunks
+struct ParallelError {
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    std::mutex lock;
+
+    template <typename F>
+    void guard(F &&body) {
+        if (failed.load(std::memory_order_relaxed)) {
+            return;
+        }
+        try {
+            body();
+        } catch (...) {
+            std::lock_guard<std::mutex> hold(lock);
+            if (!error) {
+                error = std::current_exception();
+            }
+            failed.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    void rethrow() {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+inline void checkParallel(int32_t result) {
+    if (result != 0) {
+        throw std::runtime_error("Failed to run parallel loop");
+    }
+}
+
+} // namespace detail
+
+// Calls func(i) for every i in [begin, end)
+template <typename F>
+void parallelFor(ThreadPool &pool, int64_t begin, int64_t end, F &&func, int64_t grain = 0,
+                 fossil_xparallel_schedule_t schedule = FOSSIL_PARALLEL_DYNAMIC) {
+    struct Context {
+        F &func;
+        detail::ParallelError errors;
+    } context{func, {}};
+
+    auto body = [](int64_t first, int64_t last, void *ctx) {
+        Context *context = static_cast<Context*>(ctx);
+        context->errors.guard([&] {
+            for (int64_t i = first; i < last; ++i) {
+                context->func(i);
+            }
+        });
+    };
+    detail::checkParallel(fossil_parallel_for_schedule(&pool.get(), begin, end, grain, schedule, body, &context));
+    context.errors.rethrow();
+}
+
+// Folds func(acc, i) over [begin, end) from identity in each chunk, then joins the chunks with combine(a, b)
+template <typename T, typename F, typename C>
+T parallelReduce(ThreadPool &pool, int64_t begin, int64_t end, T identity, F &&func, C &&combine,
+                 int64_t grain = 0, fossil_xparallel_schedule_t schedule = FOSSIL_PARALLEL_DYNAMIC) {
+    static_assert(std::is_trivially_copyable_v<T>, "parallelReduce copies values with memcpy");
+    struct Context {
+        F &func;
+        C &combine;
+        detail::ParallelError errors;
+    } context{func, combine, {}};
+
+    auto body = [](int64_t first, int64_t last, void *partial, void *ctx) {
+        Context *context = static_cast<Context*>(ctx);
+        context->errors.guard([&] {
+            T &acc = *static_cast<T*>(partial);
+            for (int64_t i = first; i < last; ++i) {
+                context->func(acc, i);
+            }
+        });
+    };
+    auto join = [](void *accum, const void *value, void *ctx) {
+        Context *context = static_cast<Context*>(ctx);
+        context->errors.guard([&] {
+            *static_cast<T*>(accum) = context->combine(*static_cast<T*>(accum), *static_cast<const T*>(value));
+        });
+    };
+
+    T result = identity;
+    detail::checkParallel(fossil_parallel_reduce(&pool.get(), begin, end, grain, schedule, &result, sizeof(T),
+                                                 &identity, body, join, &context));
+    context.errors.rethrow();
+    return result;
+}
+
+// Writes the prefix sums of input[0, count) under op to output, including or excluding each element
+template <typename T, typename Op>
+void parallelScan(ThreadPool &pool, const T *input, T *output, size_t count, T identity, Op &&op, bool inclusive = true) {
+    static_assert(std::is_trivially_copyable_v<T>, "parallelScan copies values with memcpy");
+    struct Context {
+        Op &op;
+        detail::ParallelError errors;
+    } context{op, {}};
+
+    auto join = [](void *accum, const void *value, void *ctx) {
+        Context *context = static_cast<Context*>(ctx);
+        context->errors.guard([&] {
+            *static_cast<T*>(accum) = context->op(*static_cast<T*>(accum), *static_cast<const T*>(value));
+        });
+    };
+
+    int32_t result = inclusive
+        ? fossil_parallel_inclusive_scan(&pool.get(), input, output, count, sizeof(T), &identity, join, &context)
+        : fossil_parallel_exclusive_scan(&pool.get(), input, output, count, sizeof(T), &identity, join, &context);
+    detail::checkParallel(result);
+    context.errors.rethrow();
+}
+
+} // namespace fossil
+
+#endif // __cplusplus
+
+#endif
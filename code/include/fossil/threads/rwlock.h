@@ -0,0 +1,216 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef FOSSIL_THREADS_RWLOCK_H
+#define FOSSIL_THREADS_RWLOCK_H
+
+#include "mutexs.h"
+#include "condition.h"
+#include <stdatomic.h>
+#include <stdint.h>
+
+#define FOSSIL_RWLOCK_STRIPES 16
+#define FOSSIL_RWLOCK_CACHE_LINE 64
+
+/**
+ * @brief Reader-Writer Lock
+ *
+ * Readers count themselves on one of several counters, picked per thread and kept on
+ * separate cache lines, so readers on different cores do not write the same line. A
+ * reader that finds no writer is done after one atomic add.
+ *
+ * The lock prefers writers: once a writer arrives, new readers wait and the writer only
+ * waits for the readers already inside. Writers take turns on a mutex. Read locks are not
+ * recursive, since a nested read would wait behind the pending writer, and a read lock must
+ * be released by the thread that took it.
+ */
+
+typedef struct {
+    atomic_long readers;
+    char pad[FOSSIL_RWLOCK_CACHE_LINE - sizeof(atomic_long)];
+} fossil_xrwlock_stripe_t;
+
+typedef struct {
+    fossil_xrwlock_stripe_t stripes[FOSSIL_RWLOCK_STRIPES];
+    atomic_int writer;              // Set while a writer holds or waits for the lock
+    atomic_int waiting;             // Readers asleep until the writer leaves
+    fossil_xmutex_t write_mutex;    // Held by the writer for its whole turn
+    fossil_xmutex_t mutex;          // Guards sleeping on cond
+    fossil_xcond_t cond;
+} fossil_xrwlock_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Initializes a reader-writer lock.
+ *
+ * @param lock Pointer to the lock to initialize.
+ * @return int32_t 0 if the lock is successfully initialized, -1 otherwise.
+ */
+int32_t fossil_rwlock_create(fossil_xrwlock_t *lock);
+
+/**
+ * @brief Destroys a reader-writer lock.
+ *
+ * @param lock Pointer to the lock to destroy.
+ * @return int32_t 0 if the lock is successfully destroyed, -1 otherwise.
+ */
+int32_t fossil_rwlock_erase(fossil_xrwlock_t *lock);
+
+/**
+ * @brief Acquires a lock for reading, waiting while a writer holds it or waits for it.
+ *
+ * @param lock Pointer to the lock.
+ * @return int32_t 0 if the lock is successfully acquired, -1 otherwise.
+ */
+int32_t fossil_rwlock_rdlock(fossil_xrwlock_t *lock);
+
+/**
+ * @brief Releases a read lock taken by the calling thread.
+ *
+ * @param lock Pointer to the lock.
+ * @return int32_t 0 if the lock is successfully released, -1 otherwise.
+ */
+int32_t fossil_rwlock_rdunlock(fossil_xrwlock_t *lock);
+
+/**
+ * @brief Attempts to acquire a lock for reading without waiting.
+ *
+ * @param lock Pointer to the lock.
+ * @return int32_t 0 if the lock is successfully acquired, -1 otherwise.
+ */
+int32_t fossil_rwlock_tryrdlock(fossil_xrwlock_t *lock);
+
+/**
+ * @brief Acquires a lock for writing, waiting for other writers and the current readers.
+ *
+ * @param lock Pointer to the lock.
+ * @return int32_t 0 if the lock is successfully acquired, -1 otherwise.
+ */
+int32_t fossil_rwlock_wrlock(fossil_xrwlock_t *lock);
+
+/**
+ * @brief Releases a write lock.
+ *
+ * @param lock Pointer to the lock.
+ * @return int32_t 0 if the lock is successfully released, -1 otherwise.
+ */
+int32_t fossil_rwlock_wrunlock(fossil_xrwlock_t *lock);
+
+/**
+ * @brief Attempts to acquire a lock for writing without waiting.
+ *
+ * @param lock Pointer to the lock.
+ * @return int32_t 0 if the lock is successfully acquired, -1 otherwise.
+ */
+int32_t fossil_rwlock_trywrlock(fossil_xrwlock_t *lock);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+
+#include <stdexcept>
+
+namespace fossil {
+
+// Meets the SharedMutex requirements, so std::shared_lock and std::unique_lock work too
+class RWLock {
+public:
+    RWLock() {
+        if (fossil_rwlock_create(&lock_) != 0) {
+            throw std::runtime_error("Failed to create reader-writer lock");
+        }
+    }
+
+    ~RWLock() {
+        fossil_rwlock_erase(&lock_);
+    }
+
+    RWLock(const RWLock &) = delete;
+    RWLock &operator=(const RWLock &) = delete;
+
+    void lock() {
+        if (fossil_rwlock_wrlock(&lock_) != 0) {
+            throw std::runtime_error("Failed to acquire write lock");
+        }
+    }
+
+    void unlock() {
+        fossil_rwlock_wrunlock(&lock_);
+    }
+
+    bool try_lock() {
+        return fossil_rwlock_trywrlock(&lock_) == 0;
+    }
+
+    void lock_shared() {
+        if (fossil_rwlock_rdlock(&lock_) != 0) {
+            throw std::runtime_error("Failed to acquire read lock");
+        }
+    }
+
+    void unlock_shared() {
+        fossil_rwlock_rdunlock(&lock_);
+    }
+
+    bool try_lock_shared() {
+        return fossil_rwlock_tryrdlock(&lock_) == 0;
+    }
+
+private:
+    fossil_xrwlock_t lock_;
+};
+
+class ReadGuard {
+public:
+    explicit ReadGuard(RWLock &lock) : lock_(lock) {
+        lock_.lock_shared();
+    }
+
+    ~ReadGuard() {
+        lock_.unlock_shared();
+    }
+
+    ReadGuard(const ReadGuard &) = delete;
+    ReadGuard &operator=(const ReadGuard &) = delete;
+
+private:
+    RWLock &lock_;
+};
+
+class WriteGuard {
+public:
+    explicit WriteGuard(RWLock &lock) : lock_(lock) {
+        lock_.lock();
+    }
+
+    ~WriteGuard() {
+        lock_.unlock();
+    }
+
+    WriteGuard(const WriteGuard &) = delete;
+    WriteGuard &operator=(const WriteGuard &) = delete;
+
+private:
+    RWLock &lock_;
+};
+
+} // namespace fossil
+
+#endif // __cplusplus
+
+#endif
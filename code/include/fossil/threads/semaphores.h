@@ -18,10 +18,20 @@ Description:
 #include "condition.h"
 #include <stdint.h>
 
+/**
+ * @brief Counting semaphore whose uncontended wait and post are a single atomic operation.
+ *
+ * Blocking goes through a futex on the count itself on Linux, and through a mutex and
+ * condition variable elsewhere; either way the kernel is entered only to sleep or to
+ * wake a sleeper.
+ */
 typedef struct {
     atomic_int value;
+    atomic_int waiters;     // Threads blocked or about to block
+#ifndef __linux__
     fossil_xmutex_t mutex;
     fossil_xcond_t cond;
+#endif
 } fossil_xsem_t;
 
 #ifdef __cplusplus
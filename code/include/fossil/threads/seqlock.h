@@ -0,0 +1,215 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef FOSSIL_THREADS_SEQLOCK_H
+#define FOSSIL_THREADS_SEQLOCK_H
+
+#include "mutexs.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Sequence Lock
+ *
+ * A seqlock protects small plain-data structs that are read far more often than written.
+ * Readers never write shared memory: they copy the data and retry if a writer was active
+ * during the copy, which the sequence number reveals by being odd or having changed.
+ * Writers take turns on a mutex and are never blocked by readers.
+ *
+ * The data must be copied with fossil_seqlock_read and written with fossil_seqlock_write,
+ * or the read_begin and read_retry pair with the fossil_seqlock_load and fossil_seqlock_store
+ * copies, since a reader may copy while a writer stores. The data must hold no pointers
+ * that a writer could free under a reader.
+ */
+
+typedef struct {
+    atomic_uint sequence;   // Odd while a write is in progress
+    fossil_xmutex_t mutex;  // Serializes writers
+} fossil_xseqlock_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Initializes a seqlock.
+ *
+ * @param lock Pointer to the seqlock to initialize.
+ * @return int32_t 0 if the seqlock is successfully initialized, -1 otherwise.
+ */
+int32_t fossil_seqlock_create(fossil_xseqlock_t *lock);
+
+/**
+ * @brief Destroys a seqlock.
+ *
+ * @param lock Pointer to the seqlock to destroy.
+ * @return int32_t 0 if the seqlock is successfully destroyed, -1 otherwise.
+ */
+int32_t fossil_seqlock_erase(fossil_xseqlock_t *lock);
+
+/**
+ * @brief Starts a read, waiting for any write in progress to finish.
+ *
+ * @param lock Pointer to the seqlock.
+ * @return uint32_t The sequence number to pass to fossil_seqlock_read_retry.
+ */
+uint32_t fossil_seqlock_read_begin(const fossil_xseqlock_t *lock);
+
+/**
+ * @brief Checks whether a read must be repeated because a writer was active.
+ *
+ * @param lock Pointer to the seqlock.
+ * @param sequence The value returned by fossil_seqlock_read_begin.
+ * @return bool true if the data read since then may be torn.
+ */
+bool fossil_seqlock_read_retry(const fossil_xseqlock_t *lock, uint32_t sequence);
+
+/**
+ * @brief Starts a write, waiting for other writers.
+ *
+ * @param lock Pointer to the seqlock.
+ * @return int32_t 0 if the write lock is successfully acquired, -1 otherwise.
+ */
+int32_t fossil_seqlock_write_lock(fossil_xseqlock_t *lock);
+
+/**
+ * @brief Ends a write, publishing the new data to readers.
+ *
+ * @param lock Pointer to the seqlock.
+ * @return int32_t 0 if the write lock is successfully released, -1 otherwise.
+ */
+int32_t fossil_seqlock_write_unlock(fossil_xseqlock_t *lock);
+
+/**
+ * @brief Copies protected data that a writer may be storing at the same time.
+ *
+ * @param dst The destination.
+ * @param src The protected data.
+ * @param size The number of bytes.
+ */
+void fossil_seqlock_load(void *dst, const void *src, size_t size);
+
+/**
+ * @brief Stores protected data that readers may be copying at the same time.
+ *
+ * @param dst The protected data.
+ * @param src The source.
+ * @param size The number of bytes.
+ */
+void fossil_seqlock_store(void *dst, const void *src, size_t size);
+
+/**
+ * @brief Reads a consistent copy of protected data, retrying while writers interfere.
+ *
+ * @param lock Pointer to the seqlock.
+ * @param dst Where to copy the data.
+ * @param data The protected data.
+ * @param size The number of bytes.
+ * @return int32_t 0 on success, -1 on invalid arguments.
+ */
+int32_t fossil_seqlock_read(const fossil_xseqlock_t *lock, void *dst, const void *data, size_t size);
+
+/**
+ * @brief Replaces protected data under the write lock.
+ *
+ * @param lock Pointer to the seqlock.
+ * @param data The protected data.
+ * @param src The new value.
+ * @param size The number of bytes.
+ * @return int32_t 0 on success, -1 on invalid arguments.
+ */
+int32_t fossil_seqlock_write(fossil_xseqlock_t *lock, void *data, const void *src, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+
+#include <stdexcept>
+#include <type_traits>
+
+namespace fossil {
+
+// A value of trivially copyable type T behind a seqlock
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock copies its value byte by byte");
+
+public:
+    // Holds the write lock for its lifetime and publishes its working copy on destruction
+    class WriteGuard {
+    public:
+        explicit WriteGuard(SeqLock &lock) : lock_(lock) {
+            if (fossil_seqlock_write_lock(&lock_.lock_) != 0) {
+                throw std::runtime_error("Failed to acquire seqlock");
+            }
+            value_ = lock_.value_; // No other writer can store now
+        }
+
+        ~WriteGuard() {
+            fossil_seqlock_store(&lock_.value_, &value_, sizeof(T));
+            fossil_seqlock_write_unlock(&lock_.lock_);
+        }
+
+        WriteGuard(const WriteGuard &) = delete;
+        WriteGuard &operator=(const WriteGuard &) = delete;
+
+        T &operator*() {
+            return value_;
+        }
+
+        T *operator->() {
+            return &value_;
+        }
+
+    private:
+        SeqLock &lock_;
+        T value_;
+    };
+
+    explicit SeqLock(const T &value = T()) : value_(value) {
+        if (fossil_seqlock_create(&lock_) != 0) {
+            throw std::runtime_error("Failed to create seqlock");
+        }
+    }
+
+    ~SeqLock() {
+        fossil_seqlock_erase(&lock_);
+    }
+
+    SeqLock(const SeqLock &) = delete;
+    SeqLock &operator=(const SeqLock &) = delete;
+
+    T load() const {
+        T value;
+        fossil_seqlock_read(&lock_, &value, &value_, sizeof(T));
+        return value;
+    }
+
+    void store(const T &value) {
+        fossil_seqlock_write(&lock_, &value_, &value, sizeof(T));
+    }
+
+private:
+    mutable fossil_xseqlock_t lock_;
+    T value_;
+};
+
+} // namespace fossil
+
+#endif // __cplusplus
+
+#endif
@@ -13,15 +13,55 @@ Description:
 #ifndef FOSSIL_THREADS_SPINLOCKS_H
 #define FOSSIL_THREADS_SPINLOCKS_H
 
+#include <stdatomic.h>
+#include <stdint.h>
+
 #ifdef _WIN32
 #include <windows.h>
 typedef CRITICAL_SECTION fossil_xspinlock_t;
 #else
 #include <pthread.h>
-#include <stdatomic.h>
-typedef atomic_flag fossil_xspinlock_t;
+typedef atomic_int fossil_xspinlock_t; // Test-and-test-and-set lock with exponential backoff
 #endif
-#include <stdint.h>
+
+#define FOSSIL_SPINLOCK_CACHE_LINE 64
+
+/**
+ * @brief Spinlock Family
+ *
+ * fossil_xspinlock_t spins on a plain load and only attempts the atomic exchange once the
+ * lock looks free, backing off exponentially between attempts, so waiters do not keep the
+ * cache line bouncing while the holder works.
+ *
+ * fossil_xticketlock_t hands the lock out in arrival order. Waiters back off in proportion
+ * to their distance from the front of the line.
+ *
+ * fossil_xmcslock_t queues waiters in a linked list of nodes owned by the waiting threads.
+ * Each waiter spins on a flag in its own node, so a release touches only the next waiter's
+ * cache line. The caller provides the node, usually on its stack, and passes the same node
+ * to unlock.
+ *
+ * All of them pause the CPU while spinning and yield it once a wait grows long, since the
+ * holder may have been descheduled.
+ */
+
+// Fair FIFO spinlock; the counters live on separate cache lines
+typedef struct {
+    atomic_uint next;                                       // Next ticket to hand out
+    char pad[FOSSIL_SPINLOCK_CACHE_LINE - sizeof(atomic_uint)];
+    atomic_uint serving;                                    // Ticket that holds the lock
+} fossil_xticketlock_t;
+
+// Queue node of an MCS lock, in use from lock until unlock returns
+typedef struct fossil_xmcs_node_t {
+    _Atomic(struct fossil_xmcs_node_t*) next;
+    atomic_int locked;
+} fossil_xmcs_node_t;
+
+// MCS queue lock, which points at the last waiting node
+typedef struct {
+    _Atomic(fossil_xmcs_node_t*) tail;
+} fossil_xmcslock_t;
 
 #ifdef __cplusplus
 extern "C"
@@ -68,6 +108,89 @@ int32_t fossil_spinlock_unlock(fossil_xspinlock_t *lock);
  */
 int32_t fossil_spinlock_trylock(fossil_xspinlock_t *lock);
 
+/**
+ * @brief Initializes a ticket lock.
+ *
+ * @param lock Pointer to the ticket lock to initialize.
+ * @return int32_t 0 if the lock is successfully initialized, -1 otherwise.
+ */
+int32_t fossil_ticketlock_create(fossil_xticketlock_t *lock);
+
+/**
+ * @brief Destroys a ticket lock.
+ *
+ * @param lock Pointer to the ticket lock to destroy.
+ * @return int32_t 0 if the lock is successfully destroyed, -1 otherwise.
+ */
+int32_t fossil_ticketlock_erase(fossil_xticketlock_t *lock);
+
+/**
+ * @brief Acquires a ticket lock, waiting behind every thread that asked for it earlier.
+ *
+ * @param lock Pointer to the ticket lock to acquire.
+ * @return int32_t 0 if the lock is successfully acquired, -1 otherwise.
+ */
+int32_t fossil_ticketlock_lock(fossil_xticketlock_t *lock);
+
+/**
+ * @brief Releases a ticket lock to the next thread in line.
+ *
+ * @param lock Pointer to the ticket lock to release.
+ * @return int32_t 0 if the lock is successfully released, -1 otherwise.
+ */
+int32_t fossil_ticketlock_unlock(fossil_xticketlock_t *lock);
+
+/**
+ * @brief Attempts to acquire a ticket lock without waiting.
+ *
+ * @param lock Pointer to the ticket lock to acquire.
+ * @return int32_t 0 if the lock is successfully acquired, -1 otherwise.
+ */
+int32_t fossil_ticketlock_trylock(fossil_xticketlock_t *lock);
+
+/**
+ * @brief Initializes an MCS queue lock.
+ *
+ * @param lock Pointer to the MCS lock to initialize.
+ * @return int32_t 0 if the lock is successfully initialized, -1 otherwise.
+ */
+int32_t fossil_mcslock_create(fossil_xmcslock_t *lock);
+
+/**
+ * @brief Destroys an MCS queue lock.
+ *
+ * @param lock Pointer to the MCS lock to destroy.
+ * @return int32_t 0 if the lock is successfully destroyed, -1 otherwise.
+ */
+int32_t fossil_mcslock_erase(fossil_xmcslock_t *lock);
+
+/**
+ * @brief Acquires an MCS queue lock, spinning only on the caller's node.
+ *
+ * @param lock Pointer to the MCS lock to acquire.
+ * @param node Pointer to a node that stays valid until fossil_mcslock_unlock returns.
+ * @return int32_t 0 if the lock is successfully acquired, -1 otherwise.
+ */
+int32_t fossil_mcslock_lock(fossil_xmcslock_t *lock, fossil_xmcs_node_t *node);
+
+/**
+ * @brief Releases an MCS queue lock to the next queued thread.
+ *
+ * @param lock Pointer to the MCS lock to release.
+ * @param node Pointer to the node passed when the lock was acquired.
+ * @return int32_t 0 if the lock is successfully released, -1 otherwise.
+ */
+int32_t fossil_mcslock_unlock(fossil_xmcslock_t *lock, fossil_xmcs_node_t *node);
+
+/**
+ * @brief Attempts to acquire an MCS queue lock without waiting.
+ *
+ * @param lock Pointer to the MCS lock to acquire.
+ * @param node Pointer to a node that stays valid until fossil_mcslock_unlock returns.
+ * @return int32_t 0 if the lock is successfully acquired, -1 otherwise.
+ */
+int32_t fossil_mcslock_trylock(fossil_xmcslock_t *lock, fossil_xmcs_node_t *node);
+
 #ifdef __cplusplus
 }
 #endif
@@ -112,6 +235,95 @@ private:
     fossil_xspinlock_t lock_;
 };
 
+class TicketLock {
+public:
+    TicketLock() {
+        if (fossil_ticketlock_create(&lock_) != 0) {
+            throw std::runtime_error("Failed to create ticket lock");
+        }
+    }
+
+    ~TicketLock() {
+        fossil_ticketlock_erase(&lock_);
+    }
+
+    TicketLock(const TicketLock &) = delete;
+    TicketLock &operator=(const TicketLock &) = delete;
+
+    void lock() {
+        if (fossil_ticketlock_lock(&lock_) != 0) {
+            throw std::runtime_error("Failed to acquire ticket lock");
+        }
+    }
+
+    void unlock() {
+        if (fossil_ticketlock_unlock(&lock_) != 0) {
+            throw std::runtime_error("Failed to release ticket lock");
+        }
+    }
+
+    bool trylock() {
+        return fossil_ticketlock_trylock(&lock_) == 0;
+    }
+
+private:
+    fossil_xticketlock_t lock_;
+};
+
+class McsLock {
+public:
+    // Holds the lock for its lifetime, with the queue node in the guard itself
+    class Guard {
+    public:
+        explicit Guard(McsLock &lock) : lock_(lock) {
+            lock_.lock(node_);
+        }
+
+        ~Guard() {
+            fossil_mcslock_unlock(&lock_.lock_, &node_);
+        }
+
+        Guard(const Guard &) = delete;
+        Guard &operator=(const Guard &) = delete;
+
+    private:
+        McsLock &lock_;
+        fossil_xmcs_node_t node_;
+    };
+
+    McsLock() {
+        if (fossil_mcslock_create(&lock_) != 0) {
+            throw std::runtime_error("Failed to create MCS lock");
+        }
+    }
+
+    ~McsLock() {
+        fossil_mcslock_erase(&lock_);
+    }
+
+    McsLock(const McsLock &) = delete;
+    McsLock &operator=(const McsLock &) = delete;
+
+    void lock(fossil_xmcs_node_t &node) {
+        if (fossil_mcslock_lock(&lock_, &node) != 0) {
+            throw std::runtime_error("Failed to acquire MCS lock");
+        }
+    }
+
+    void unlock(fossil_xmcs_node_t &node) {
+        if (fossil_mcslock_unlock(&lock_, &node) != 0) {
+            throw std::runtime_error("Failed to release MCS lock");
+        }
+    }
+
+    bool trylock(fossil_xmcs_node_t &node) {
+        return fossil_mcslock_trylock(&lock_, &node) == 0;
+    }
+
+private:
+    fossil_xmcslock_t lock_;
+};
+
 } // namespace fossil
 
 #endif // __cplusplus
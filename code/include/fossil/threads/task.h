@@ -50,39 +50,27 @@ extern "C" {
     void task_name(fossil_xtask_arg_t arg_name)
 
 /**
- * @brief Inline function to provide platform-independent task delay by seconds.
+ * @brief Provides platform-independent task delay by seconds.
  *
  * @param seconds The number of seconds to delay.
  */
-static inline void fossil_task_delay_seconds(uint32_t seconds) {
-#ifdef _WIN32
-    Sleep(seconds * 1000);
-#else
-    sleep(seconds);
-#endif
-}
+void fossil_task_delay_seconds(uint32_t seconds);
 
 /**
- * @brief Inline function to provide platform-independent task delay by minutes.
+ * @brief Provides platform-independent task delay by minutes.
  *
  * @param minutes The number of minutes to delay.
  */
-static inline void fossil_task_delay_minutes(uint32_t minutes) {
-    fossil_task_delay_seconds(minutes * 60);
-}
+void fossil_task_delay_minutes(uint32_t minutes);
 
 /**
- * @brief Inline function to provide platform-independent task delay by milliseconds.
+ * @brief Provides platform-independent task delay by milliseconds.
+ *
+ * To run a task later without blocking a thread, see the timer wheel in timer.h.
  *
  * @param milliseconds The number of milliseconds to delay.
  */
-static inline void fossil_task_delay_milliseconds(uint32_t milliseconds) {
-#ifdef _WIN32
-    Sleep(milliseconds);
-#else
-    sleep(milliseconds * 1000);
-#endif
-}
+void fossil_task_delay_milliseconds(uint32_t milliseconds);
 
 #ifdef __cplusplus
 }
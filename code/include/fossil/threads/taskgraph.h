@@ -0,0 +1,251 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef FOSSIL_THREADS_TASKGRAPH_H
+#define FOSSIL_THREADS_TASKGRAPH_H
+
+#include "threadpool.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Task Graphs
+ *
+ * A task graph is a directed acyclic graph of tasks run on a thread pool. Every node counts
+ * its unfinished inputs, and the node that finishes last starts the dependent at once, on the
+ * same worker when it is the first one to become ready, so no stage waits on a barrier for
+ * unrelated branches.
+ *
+ * A built graph can be run any number of times; each run resets the counters. A node can
+ * also run a whole sub-graph, which finishes asynchronously without holding a worker. The
+ * start and end time of every node in the last run can be exported as JSON together with the
+ * critical path, the chain of dependent nodes with the longest total duration.
+ *
+ * A graph must not be modified or run again while it is running, and a sub-graph belongs to
+ * at most one running node at a time.
+ */
+
+typedef struct fossil_xtask_graph_t fossil_xtask_graph_t;
+typedef struct fossil_xtask_node_t fossil_xtask_node_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Creates an empty task graph.
+ *
+ * @return fossil_xtask_graph_t* The graph, or NULL on allocation failure.
+ */
+fossil_xtask_graph_t* fossil_task_graph_create(void);
+
+/**
+ * @brief Destroys a task graph and its nodes. Sub-graphs are not destroyed.
+ *
+ * @param graph Pointer to the graph.
+ */
+void fossil_task_graph_erase(fossil_xtask_graph_t *graph);
+
+/**
+ * @brief Adds a task node to a graph.
+ *
+ * @param graph Pointer to the graph.
+ * @param name The name used in timing exports, copied, or NULL.
+ * @param task_func The task function.
+ * @param arg The argument passed to the task function.
+ * @return fossil_xtask_node_t* The node, owned by the graph, or NULL on failure.
+ */
+fossil_xtask_node_t* fossil_task_graph_add_node(fossil_xtask_graph_t *graph, const char *name,
+                                                fossil_xtask_func_t task_func, void *arg);
+
+/**
+ * @brief Adds a node that runs another graph and finishes when all of its nodes have finished.
+ *
+ * @param graph Pointer to the graph.
+ * @param name The name used in timing exports, copied, or NULL.
+ * @param subgraph The graph to run, which must outlive this graph and must not contain it.
+ * @return fossil_xtask_node_t* The node, owned by the graph, or NULL on failure.
+ */
+fossil_xtask_node_t* fossil_task_graph_add_subgraph(fossil_xtask_graph_t *graph, const char *name,
+                                                    fossil_xtask_graph_t *subgraph);
+
+/**
+ * @brief Makes one node wait for another.
+ *
+ * @param graph Pointer to the graph holding both nodes.
+ * @param from The node that must finish first.
+ * @param to The node that depends on it.
+ * @return int32_t 0 on success, -1 on invalid arguments or allocation failure.
+ */
+int32_t fossil_task_graph_add_edge(fossil_xtask_graph_t *graph, fossil_xtask_node_t *from, fossil_xtask_node_t *to);
+
+/**
+ * @brief Runs every node of a graph on a pool and waits until all have finished.
+ *
+ * Waiting inside a task of the same pool can deadlock if every worker waits; use a sub-graph node instead.
+ *
+ * @param graph Pointer to the graph.
+ * @param pool Pointer to the thread pool.
+ * @return int32_t 0 on success, -1 if the graph or a sub-graph has a cycle.
+ */
+int32_t fossil_task_graph_run(fossil_xtask_graph_t *graph, fossil_xthread_pool_t *pool);
+
+/**
+ * @brief Gets the number of nodes in a graph.
+ *
+ * @param graph Pointer to the graph.
+ * @return size_t The number of nodes.
+ */
+size_t fossil_task_graph_size(const fossil_xtask_graph_t *graph);
+
+/**
+ * @brief Gets the times of a node in the last run, in nanoseconds since the run started.
+ *
+ * @param node Pointer to the node.
+ * @param start_ns Where to store the start time, or NULL.
+ * @param end_ns Where to store the end time, or NULL.
+ * @return int32_t 0 on success, -1 if the node has not run.
+ */
+int32_t fossil_task_graph_node_time(const fossil_xtask_node_t *node, int64_t *start_ns, int64_t *end_ns);
+
+/**
+ * @brief Writes the node times of the last run and the critical path as JSON.
+ *
+ * @param graph Pointer to the graph.
+ * @param filename The file to write.
+ * @return int32_t 0 on success, -1 if the file cannot be written.
+ */
+int32_t fossil_task_graph_export_json(const fossil_xtask_graph_t *graph, const char *filename);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fossil {
+
+class TaskGraph {
+public:
+    TaskGraph() : graph_(fossil_task_graph_create()) {
+        if (!graph_) {
+            throw std::runtime_error("Failed to create task graph");
+        }
+    }
+
+    ~TaskGraph() {
+        fossil_task_graph_erase(graph_);
+    }
+
+    TaskGraph(const TaskGraph &) = delete;
+    TaskGraph &operator=(const TaskGraph &) = delete;
+
+    fossil_xtask_node_t *node(const std::string &name, std::function<void()> task) {
+        tasks_.push_back({std::move(task), this});
+        fossil_xtask_node_t *node = fossil_task_graph_add_node(graph_, name.c_str(), call, &tasks_.back());
+        if (!node) {
+            tasks_.pop_back();
+            throw std::runtime_error("Failed to add task graph node");
+        }
+        return node;
+    }
+
+    fossil_xtask_node_t *subgraph(const std::string &name, TaskGraph &graph) {
+        fossil_xtask_node_t *node = fossil_task_graph_add_subgraph(graph_, name.c_str(), graph.graph_);
+        if (!node) {
+            throw std::runtime_error("Failed to add task graph node");
+        }
+        subgraphs_.push_back(&graph);
+        return node;
+    }
+
+    void edge(fossil_xtask_node_t *from, fossil_xtask_node_t *to) {
+        if (fossil_task_graph_add_edge(graph_, from, to) != 0) {
+            throw std::runtime_error("Failed to add task graph edge");
+        }
+    }
+
+    // Runs the graph and rethrows the first exception of its tasks; the other tasks still run
+    void run(ThreadPool &pool) {
+        reset();
+        if (fossil_task_graph_run(graph_, &pool.get()) != 0) {
+            throw std::runtime_error("Failed to run task graph");
+        }
+        rethrow();
+    }
+
+    void exportJson(const std::string &filename) const {
+        if (fossil_task_graph_export_json(graph_, filename.c_str()) != 0) {
+            throw std::runtime_error("Failed to export task graph timing");
+        }
+    }
+
+    fossil_xtask_graph_t *get() {
+        return graph_;
+    }
+
+private:
+    struct Task {
+        std::function<void()> func;
+        TaskGraph *owner;
+    };
+
+    static void call(void *arg) {
+        Task *task = static_cast<Task*>(arg);
+        try {
+            task->func();
+        } catch (...) {
+            std::lock_guard<std::mutex> hold(task->owner->lock_);
+            if (!task->owner->error_) {
+                task->owner->error_ = std::current_exception();
+            }
+        }
+    }
+
+    void reset() {
+        error_ = nullptr;
+        for (TaskGraph *graph : subgraphs_) {
+            graph->reset();
+        }
+    }
+
+    void rethrow() {
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+        for (TaskGraph *graph : subgraphs_) {
+            graph->rethrow();
+        }
+    }
+
+    fossil_xtask_graph_t *graph_;
+    std::deque<Task> tasks_; // A deque keeps the tasks at stable addresses
+    std::vector<TaskGraph*> subgraphs_;
+    std::mutex lock_;
+    std::exception_ptr error_;
+};
+
+} // namespace fossil
+
+#endif // __cplusplus
+
+#endif
@@ -21,16 +21,30 @@ typedef HANDLE fossil_xthread_t;
 typedef pthread_t fossil_xthread_t;
 #endif
 #include "task.h"
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
+#define FOSSIL_THREAD_MAX_CPUS 1024 // Highest CPU number a CPU set can hold, plus one
+#define FOSSIL_THREAD_NAME_MAX 16   // Longest thread name, with its terminator, that every platform keeps
+
+// Set of logical CPUs, numbered as the operating system numbers them
+typedef struct {
+    uint64_t bits[FOSSIL_THREAD_MAX_CPUS / 64];
+} fossil_xcpu_set_t;
+
 #ifdef _WIN32
 typedef struct {
     DWORD stack_size;
     int32_t detach_state;
+    DWORD_PTR affinity_mask;            // 0 to leave the affinity alone
+    char name[FOSSIL_THREAD_NAME_MAX];  // Empty to leave the thread unnamed
 } fossil_xthread_attr_t;
 #else
-#include <pthread.h>
-typedef pthread_attr_t fossil_xthread_attr_t;
+typedef struct {
+    pthread_attr_t native;
+    char name[FOSSIL_THREAD_NAME_MAX];  // Empty to leave the thread unnamed
+} fossil_xthread_attr_t;
 #endif
 
 #ifdef __cplusplus
@@ -81,6 +95,123 @@ int32_t fossil_thread_attr_create(fossil_xthread_attr_t *attr);
  */
 int32_t fossil_thread_attr_erase(fossil_xthread_attr_t *attr);
 
+/**
+ * @brief Sets the stack size of threads created with the specified attributes.
+ *
+ * The size is rounded up to the platform's page size and minimum stack size.
+ *
+ * @param attr Pointer to the thread attributes.
+ * @param bytes The stack size in bytes, or 0 for the platform default.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_thread_attr_set_stack_size(fossil_xthread_attr_t *attr, size_t bytes);
+
+/**
+ * @brief Restricts threads created with the specified attributes to a set of CPUs from their first instruction.
+ *
+ * Linux and Windows support affinity; on Windows only the first 64 CPUs can be used. Elsewhere
+ * the call fails and threads run wherever the scheduler puts them.
+ *
+ * @param attr Pointer to the thread attributes.
+ * @param cpus The CPUs the threads may run on, or NULL for the creating thread's CPUs, as by default.
+ * @return int32_t 0 if successful, -1 if the set is empty or affinity is not supported.
+ */
+int32_t fossil_thread_attr_set_affinity(fossil_xthread_attr_t *attr, const fossil_xcpu_set_t *cpus);
+
+/**
+ * @brief Names threads created with the specified attributes, as shown by debuggers and profilers.
+ *
+ * @param attr Pointer to the thread attributes.
+ * @param name The name, cut to FOSSIL_THREAD_NAME_MAX - 1 characters, or NULL to leave threads unnamed.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_thread_attr_set_name(fossil_xthread_attr_t *attr, const char *name);
+
+/**
+ * @brief Restricts the calling thread to a set of CPUs.
+ *
+ * @param cpus The CPUs the thread may run on.
+ * @return int32_t 0 if successful, -1 if the set is empty or affinity is not supported.
+ */
+int32_t fossil_thread_set_affinity(const fossil_xcpu_set_t *cpus);
+
+/**
+ * @brief Gets the CPUs the calling thread may run on.
+ *
+ * Where affinity is not supported this is every online CPU.
+ *
+ * @param cpus Pointer to store the CPU set.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_thread_get_affinity(fossil_xcpu_set_t *cpus);
+
+/**
+ * @brief Names the calling thread.
+ *
+ * @param name The name, cut to FOSSIL_THREAD_NAME_MAX - 1 characters.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_thread_set_name(const char *name);
+
+/**
+ * @brief Gets the number of online logical CPUs.
+ *
+ * @return int32_t The number of CPUs, at least 1.
+ */
+int32_t fossil_thread_cpu_count(void);
+
+/**
+ * @brief Gets the number of NUMA nodes.
+ *
+ * Nodes are read from sysfs on Linux and from the system on Windows; elsewhere the whole
+ * machine counts as one node.
+ *
+ * @return int32_t The number of nodes, at least 1.
+ */
+int32_t fossil_thread_numa_node_count(void);
+
+/**
+ * @brief Gets the CPUs of a NUMA node.
+ *
+ * @param node The node, from 0 to fossil_thread_numa_node_count() - 1.
+ * @param cpus Pointer to store the CPU set.
+ * @return int32_t 0 if successful, -1 if the node does not exist.
+ */
+int32_t fossil_thread_numa_node_cpus(int32_t node, fossil_xcpu_set_t *cpus);
+
+/**
+ * @brief Empties a CPU set.
+ *
+ * @param cpus Pointer to the CPU set.
+ */
+void fossil_cpu_set_zero(fossil_xcpu_set_t *cpus);
+
+/**
+ * @brief Adds a CPU to a CPU set.
+ *
+ * @param cpus Pointer to the CPU set.
+ * @param cpu The CPU number.
+ * @return int32_t 0 if successful, -1 if the CPU number is out of range.
+ */
+int32_t fossil_cpu_set_add(fossil_xcpu_set_t *cpus, int32_t cpu);
+
+/**
+ * @brief Checks whether a CPU set holds a CPU.
+ *
+ * @param cpus Pointer to the CPU set.
+ * @param cpu The CPU number.
+ * @return bool true if the CPU is in the set.
+ */
+bool fossil_cpu_set_has(const fossil_xcpu_set_t *cpus, int32_t cpu);
+
+/**
+ * @brief Counts the CPUs in a CPU set.
+ *
+ * @param cpus Pointer to the CPU set.
+ * @return int32_t The number of CPUs in the set.
+ */
+int32_t fossil_cpu_set_count(const fossil_xcpu_set_t *cpus);
+
 #ifdef __cplusplus
 }
 #endif
@@ -133,6 +264,36 @@ public:
         }
     }
 
+    ThreadAttr &setStackSize(size_t bytes) {
+        if (fossil_thread_attr_set_stack_size(&attr_, bytes) != 0) {
+            throw std::runtime_error("Failed to set thread stack size");
+        }
+        return *this;
+    }
+
+    ThreadAttr &setAffinity(const fossil_xcpu_set_t &cpus) {
+        if (fossil_thread_attr_set_affinity(&attr_, &cpus) != 0) {
+            throw std::runtime_error("Failed to set thread affinity");
+        }
+        return *this;
+    }
+
+    ThreadAttr &pinTo(int32_t cpu) {
+        fossil_xcpu_set_t cpus;
+        fossil_cpu_set_zero(&cpus);
+        if (fossil_cpu_set_add(&cpus, cpu) != 0) {
+            throw std::runtime_error("CPU number out of range");
+        }
+        return setAffinity(cpus);
+    }
+
+    ThreadAttr &setName(const char *name) {
+        if (fossil_thread_attr_set_name(&attr_, name) != 0) {
+            throw std::runtime_error("Failed to set thread name");
+        }
+        return *this;
+    }
+
     fossil_xthread_attr_t *get() {
         return &attr_;
     }
@@ -18,6 +18,7 @@ Description:
 #include "condition.h"
 #include "task.h"
 #include <stdatomic.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 // Macro for defining a task
@@ -27,17 +28,91 @@ Description:
 #define xtask(name) void name(void* arg)
 #endif
 
+// Timeout that makes a blocking submit wait until there is space
+#define FOSSIL_THREAD_POOL_WAIT_FOREVER (-1)
+
+// Worker of a work-stealing pool, with its own task deque
+typedef struct fossil_xthread_worker_t fossil_xthread_worker_t;
+
+// Counters of a pool created with metrics, see fossil_thread_pool_metrics
+typedef struct fossil_xthread_pool_stats_t fossil_xthread_pool_stats_t;
+
+// Latency histogram buckets: 16 exact values, then 16 buckets per power of two up to 2^40 ns (about 18 minutes)
+#define FOSSIL_THREAD_POOL_HISTOGRAM_SUB_BUCKETS 16
+#define FOSSIL_THREAD_POOL_HISTOGRAM_BUCKETS (FOSSIL_THREAD_POOL_HISTOGRAM_SUB_BUCKETS * 37)
+
+// Where the workers of a pool run; placement is skipped where thread affinity is not supported
+typedef enum {
+    FOSSIL_THREAD_POOL_PLACE_NONE,      // Wherever the scheduler puts them
+    FOSSIL_THREAD_POOL_PLACE_COMPACT,   // Worker i is pinned to the i-th CPU the creating thread may use, wrapping around
+    FOSSIL_THREAD_POOL_PLACE_SPREAD     // Workers are dealt in turn to the NUMA nodes and may run on any CPU of their node
+} fossil_xthread_pool_placement_t;
+
+typedef struct {
+    int32_t thread_count;
+    int32_t queue_size;
+    bool stealing;                              // Work-stealing pool, as fossil_thread_pool_create_stealing makes
+    fossil_xthread_pool_placement_t placement;
+    size_t stack_size;                          // Worker stack size, 0 for the platform default
+    const char *name;                           // Workers are named name-<i>, or left unnamed if NULL
+    bool metrics;                               // Time every task and count submissions, see fossil_thread_pool_metrics
+} fossil_xthread_pool_options_t;
+
+/**
+ * @brief Log-linear latency histogram in the style of HdrHistogram.
+ *
+ * Bucket i holds the value i below FOSSIL_THREAD_POOL_HISTOGRAM_SUB_BUCKETS; above, each power of
+ * two is split into FOSSIL_THREAD_POOL_HISTOGRAM_SUB_BUCKETS equal buckets, so a value is known to
+ * within 1/16 of itself. Longer times land in the last bucket.
+ */
+typedef struct {
+    uint64_t count;
+    uint64_t sum_ns;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    uint64_t buckets[FOSSIL_THREAD_POOL_HISTOGRAM_BUCKETS];
+} fossil_xthread_pool_histogram_t;
+
+// Snapshot of the metrics of a whole pool
+typedef struct {
+    uint64_t submitted;                         // Tasks accepted
+    uint64_t rejected;                          // Tasks refused because the queue was full or the wait timed out
+    uint64_t completed;                         // Tasks that finished
+    int32_t queue_depth;                        // Tasks accepted but not yet started
+    int32_t peak_queue_depth;                   // Largest queue depth seen by a submitter
+    uint64_t busy_ns;                           // Time the workers spent running tasks, summed over workers
+    uint64_t idle_ns;                           // Time the workers spent waiting for or looking for tasks
+    fossil_xthread_pool_histogram_t wait;       // Time from submission to start, per task
+    fossil_xthread_pool_histogram_t run;        // Time from start to finish, per task
+} fossil_xthread_pool_metrics_t;
+
+// Snapshot of the metrics of one worker
+typedef struct {
+    uint64_t completed;
+    uint64_t busy_ns;
+    uint64_t idle_ns;
+} fossil_xthread_pool_worker_metrics_t;
+
 typedef struct {
     fossil_xthread_t *threads;
     int32_t thread_count;
     fossil_xmutex_t queue_mutex;
     fossil_xcond_t queue_cond;
+    fossil_xcond_t space_cond;        // Signaled when a worker takes a task from a queue with blocked submitters
     fossil_xtask_t *task_queue;
     int32_t queue_size;
     int32_t queue_front;
     int32_t queue_rear;
     atomic_int shutdown;
     atomic_int task_count;
+    fossil_xthread_worker_t *workers; // Per-worker deques in work-stealing mode, NULL otherwise
+    int32_t space_waiters;            // Submitters waiting on space_cond
+    int32_t growable;                 // Whether a full queue grows instead of rejecting tasks
+    atomic_int sleepers;              // Workers waiting on queue_cond
+    atomic_int next_worker;           // Next worker slot claimed by a starting thread
+    int32_t placed;                   // Whether workers are placed on CPUs, so they allocate their own deques
+    fossil_xthread_pool_stats_t *stats; // Metrics, NULL unless the pool was created with them
+    uint64_t *enqueue_times;          // Submission time of each task_queue slot when metrics are on, NULL otherwise
 } fossil_xthread_pool_t;
 
 #ifdef __cplusplus
@@ -55,6 +130,35 @@ extern "C"
  */
 int32_t fossil_thread_pool_create(fossil_xthread_pool_t *pool, int32_t thread_count, int32_t queue_size);
 
+/**
+ * @brief Creates a work-stealing thread pool with the specified number of threads.
+ *
+ * Each worker owns a Chase-Lev deque. Tasks added from inside a worker go to that worker's
+ * deque and are popped LIFO, so fork/join work stays on the core that created it; idle workers
+ * steal FIFO from randomly chosen victims. Tasks added from other threads go to the shared queue,
+ * which workers drain in batches into their deques. Only submissions from outside the pool take
+ * the queue lock.
+ *
+ * @param pool Pointer to the thread pool structure to initialize.
+ * @param thread_count The number of worker threads to create in the pool.
+ * @param queue_size The size of the shared queue and the initial size of each deque, which grows as needed.
+ * @return int32_t 0 if the thread pool is successfully created, -1 otherwise.
+ */
+int32_t fossil_thread_pool_create_stealing(fossil_xthread_pool_t *pool, int32_t thread_count, int32_t queue_size);
+
+/**
+ * @brief Creates a thread pool from a set of options, placing its workers on CPUs if asked.
+ *
+ * Placed workers of a work-stealing pool allocate their own deques once pinned, so under the usual
+ * first-touch policy the memory lands on the worker's NUMA node. Data that a task allocates and
+ * initializes lands on the node of the worker running it in the same way.
+ *
+ * @param pool Pointer to the thread pool structure to initialize.
+ * @param options The options; unset fields left at zero keep their defaults.
+ * @return int32_t 0 if the thread pool is successfully created, -1 otherwise.
+ */
+int32_t fossil_thread_pool_create_options(fossil_xthread_pool_t *pool, const fossil_xthread_pool_options_t *options);
+
 /**
  * @brief Shuts down and deallocates resources associated with a thread pool.
  *
@@ -70,9 +174,94 @@ int32_t fossil_thread_pool_erase(fossil_xthread_pool_t *pool);
  * @param task_func Pointer to the function to execute as a task.
  * @param arg Pointer to the argument to pass to the task function.
  * @return int32_t 0 if the task is successfully added to the pool, -1 if the task queue is full.
+ *
+ * In a work-stealing pool, a task added from one of the pool's own workers never fails for lack
+ * of space because the worker's deque grows.
  */
 int32_t fossil_thread_pool_add_task(fossil_xthread_pool_t *pool, fossil_xtask_func_t task_func, void *arg);
 
+/**
+ * @brief Adds a task to the thread pool, waiting for space if the task queue is full.
+ *
+ * The caller sleeps until a worker takes a task from the queue, so producers do not spin. Waiting
+ * from inside a task of the same pool can deadlock if every worker waits.
+ *
+ * @param pool Pointer to the thread pool structure.
+ * @param task_func Pointer to the task function to be executed by a worker thread.
+ * @param arg Pointer to the argument to be passed to the task function.
+ * @param milliseconds The longest time to wait, 0 to fail at once, or FOSSIL_THREAD_POOL_WAIT_FOREVER.
+ * @return int32_t 0 if the task is added, -1 on timeout or if the pool is shutting down.
+ */
+int32_t fossil_thread_pool_add_task_wait(fossil_xthread_pool_t *pool, fossil_xtask_func_t task_func, void *arg, int32_t milliseconds);
+
+/**
+ * @brief Adds several tasks to the thread pool in order, locking the queue once per run of tasks that fit.
+ *
+ * Each run wakes at most as many idle workers as it added tasks. When the queue fills, the caller
+ * waits for space as fossil_thread_pool_add_task_wait does.
+ *
+ * @param pool Pointer to the thread pool structure.
+ * @param tasks The tasks to add.
+ * @param count The number of tasks.
+ * @param milliseconds The longest time to wait for space, 0 not to wait, or FOSSIL_THREAD_POOL_WAIT_FOREVER.
+ * @return int32_t The number of tasks added, which is less than count on timeout, or -1 on invalid arguments.
+ */
+int32_t fossil_thread_pool_add_tasks(fossil_xthread_pool_t *pool, const fossil_xtask_t *tasks, int32_t count, int32_t milliseconds);
+
+/**
+ * @brief Chooses whether a full task queue doubles in size instead of rejecting or blocking submitters.
+ *
+ * @param pool Pointer to the thread pool structure.
+ * @param growable true to let the queue grow.
+ * @return int32_t 0 on success, -1 if the pool is NULL.
+ */
+int32_t fossil_thread_pool_set_growable(fossil_xthread_pool_t *pool, bool growable);
+
+/**
+ * @brief Takes a snapshot of the metrics of a pool created with the metrics option.
+ *
+ * Each worker keeps its own counters and histograms, written by that worker alone, so timing a
+ * task costs two clock reads and no shared writes. The snapshot adds them up while the pool runs;
+ * it is not atomic, and a task finishing meanwhile may be counted in some fields and not others.
+ * Time spent in the current task or wait is included.
+ *
+ * @param pool Pointer to the thread pool structure.
+ * @param metrics Pointer to store the snapshot.
+ * @return int32_t 0 on success, -1 if the pool has no metrics.
+ */
+int32_t fossil_thread_pool_metrics(fossil_xthread_pool_t *pool, fossil_xthread_pool_metrics_t *metrics);
+
+/**
+ * @brief Takes a snapshot of the metrics of one worker of a pool created with the metrics option.
+ *
+ * @param pool Pointer to the thread pool structure.
+ * @param worker The worker's index, below the pool's thread count.
+ * @param metrics Pointer to store the snapshot.
+ * @return int32_t 0 on success, -1 if the pool has no metrics or the index is out of range.
+ */
+int32_t fossil_thread_pool_worker_metrics(fossil_xthread_pool_t *pool, int32_t worker, fossil_xthread_pool_worker_metrics_t *metrics);
+
+/**
+ * @brief Estimates a percentile of a histogram.
+ *
+ * @param histogram Pointer to the histogram.
+ * @param percentile The percentile, from 0 to 100.
+ * @return uint64_t The highest value of the bucket holding the percentile, capped at the maximum, or 0 if the histogram is empty.
+ */
+uint64_t fossil_thread_pool_histogram_percentile(const fossil_xthread_pool_histogram_t *histogram, double percentile);
+
+/**
+ * @brief Writes a snapshot of the metrics of a pool as JSON.
+ *
+ * The file holds the counters, the busy and idle time of each worker, and for the wait and run
+ * histograms their count, mean, minimum, maximum, main percentiles and non-empty buckets.
+ *
+ * @param pool Pointer to the thread pool structure.
+ * @param filename The file to write.
+ * @return int32_t 0 on success, -1 if the pool has no metrics or the file cannot be written.
+ */
+int32_t fossil_thread_pool_metrics_export_json(fossil_xthread_pool_t *pool, const char *filename);
+
 #ifdef __cplusplus
 }
 #endif
@@ -80,6 +269,7 @@ int32_t fossil_thread_pool_add_task(fossil_xthread_pool_t *pool, fossil_xtask_fu
 #ifdef __cplusplus
 
 #include <stdexcept>
+#include <string>
 
 namespace fossil
 {
@@ -87,8 +277,16 @@ namespace fossil
 class ThreadPool
 {
 public:
-    ThreadPool(int32_t thread_count, int32_t queue_size) {
-        if (fossil_thread_pool_create(&pool_, thread_count, queue_size) != 0) {
+    ThreadPool(int32_t thread_count, int32_t queue_size, bool stealing = false) {
+        int32_t result = stealing ? fossil_thread_pool_create_stealing(&pool_, thread_count, queue_size)
+                                  : fossil_thread_pool_create(&pool_, thread_count, queue_size);
+        if (result != 0) {
+            throw std::runtime_error("Failed to create thread pool");
+        }
+    }
+
+    explicit ThreadPool(const fossil_xthread_pool_options_t &options) {
+        if (fossil_thread_pool_create_options(&pool_, &options) != 0) {
             throw std::runtime_error("Failed to create thread pool");
         }
     }
@@ -105,6 +303,46 @@ public:
         }
     }
 
+    void addTaskWait(fossil_xtask_func_t task_func, void *arg, int32_t milliseconds = FOSSIL_THREAD_POOL_WAIT_FOREVER) {
+        if (fossil_thread_pool_add_task_wait(&pool_, task_func, arg, milliseconds) != 0) {
+            throw std::runtime_error("Failed to add task to thread pool");
+        }
+    }
+
+    int32_t addTasks(const fossil_xtask_t *tasks, int32_t count, int32_t milliseconds = FOSSIL_THREAD_POOL_WAIT_FOREVER) {
+        int32_t added = fossil_thread_pool_add_tasks(&pool_, tasks, count, milliseconds);
+        if (added < 0) {
+            throw std::runtime_error("Failed to add tasks to thread pool");
+        }
+        return added;
+    }
+
+    void setGrowable(bool growable) {
+        fossil_thread_pool_set_growable(&pool_, growable);
+    }
+
+    fossil_xthread_pool_metrics_t metrics() {
+        fossil_xthread_pool_metrics_t metrics;
+        if (fossil_thread_pool_metrics(&pool_, &metrics) != 0) {
+            throw std::runtime_error("Thread pool has no metrics");
+        }
+        return metrics;
+    }
+
+    void exportMetricsJson(const std::string &filename) {
+        if (fossil_thread_pool_metrics_export_json(&pool_, filename.c_str()) != 0) {
+            throw std::runtime_error("Failed to export thread pool metrics");
+        }
+    }
+
+    fossil_xthread_pool_t &get() {
+        return pool_;
+    }
+
+    // Runs a callable on the pool and returns a fossil::Future for its result, see future.h
+    template <typename F>
+    auto submit(F &&func);
+
 private:
     fossil_xthread_pool_t pool_;
 };
@@ -113,4 +351,7 @@ private:
 
 #endif // __cplusplus
 
+// Futures extend the pool with submit
+#include "future.h"
+
 #endif
@@ -0,0 +1,204 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef FOSSIL_THREADS_TIMER_H
+#define FOSSIL_THREADS_TIMER_H
+
+#include "threadpool.h"
+#include "mutexs.h"
+#include "condition.h"
+#include "thread.h"
+#include "task.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define FOSSIL_TIMER_WHEEL_BITS 8                                // Slots per level, as a power of two
+#define FOSSIL_TIMER_WHEEL_SLOTS (1 << FOSSIL_TIMER_WHEEL_BITS)
+#define FOSSIL_TIMER_WHEEL_LEVELS 4                              // Levels cover 2^32 ticks, longer delays are cascaded again
+#define FOSSIL_TIMER_DEFAULT_TICK_US 1000
+
+/**
+ * @brief Hierarchical Timer Wheel
+ *
+ * A timer wheel runs delayed and periodic tasks on a thread pool without tying up a thread per
+ * delay. Level 0 has one slot per tick; each level above has slots as wide as the whole level
+ * below, and its timers move down a level whenever the level below wraps around. Starting and
+ * cancelling a timer are constant time, and a million pending timers cost no more than their
+ * own storage.
+ *
+ * One timer thread sleeps until the next slot that holds timers, on a timerfd on Linux and on a
+ * condition variable elsewhere, so an idle wheel does not wake up every tick. Due tasks are added
+ * to the pool in batches. Timers fire at the first tick at or after their delay, so a timer is
+ * late by up to one tick plus the wake-up latency of the timer thread.
+ */
+
+// A timer, owned by the caller and linked into a wheel while it is pending
+typedef struct fossil_xtimer_t {
+    struct fossil_xtimer_t *next;
+    struct fossil_xtimer_t **pprev;   // Link pointing at this timer, NULL unless pending
+    uint64_t expires;                 // Tick the timer fires at
+    uint64_t period;                  // Ticks between firings, 0 for a one-shot timer
+    fossil_xtask_t task;
+} fossil_xtimer_t;
+
+typedef struct {
+    fossil_xtimer_t *slots[FOSSIL_TIMER_WHEEL_LEVELS][FOSSIL_TIMER_WHEEL_SLOTS];
+    uint64_t now;                     // Next tick to process
+    uint64_t wake;                    // Tick the timer thread sleeps until, UINT64_MAX when no timer is pending
+    uint64_t tick_ns;
+    uint64_t origin_ns;               // Monotonic time of tick 0
+    size_t pending;
+    fossil_xthread_pool_t *pool;      // Runs the tasks, or NULL to run them on the timer thread
+    fossil_xthread_t thread;
+    fossil_xmutex_t mutex;
+    fossil_xcond_t cond;              // Wakes the timer thread when there is no timerfd
+    int timer_fd;                     // Linux timerfd the timer thread sleeps on, -1 otherwise
+    int32_t shutdown;
+} fossil_xtimer_wheel_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Creates a timer wheel and starts its timer thread.
+ *
+ * @param wheel Pointer to the timer wheel to initialize.
+ * @param pool The pool that runs the tasks, or NULL to run them on the timer thread.
+ * @param tick_us The length of a tick in microseconds, or 0 for FOSSIL_TIMER_DEFAULT_TICK_US.
+ * @return int32_t 0 if the timer wheel is successfully created, -1 otherwise.
+ */
+int32_t fossil_timer_wheel_create(fossil_xtimer_wheel_t *wheel, fossil_xthread_pool_t *pool, uint32_t tick_us);
+
+/**
+ * @brief Stops the timer thread and destroys a timer wheel. Pending timers are dropped without firing.
+ *
+ * @param wheel Pointer to the timer wheel to destroy.
+ * @return int32_t 0 if the timer wheel is successfully destroyed, -1 otherwise.
+ */
+int32_t fossil_timer_wheel_erase(fossil_xtimer_wheel_t *wheel);
+
+/**
+ * @brief Gets the number of pending timers.
+ *
+ * @param wheel Pointer to the timer wheel.
+ * @return size_t The number of pending timers.
+ */
+size_t fossil_timer_wheel_pending(fossil_xtimer_wheel_t *wheel);
+
+/**
+ * @brief Prepares a timer to run a task. Must be called once before the timer is first started.
+ *
+ * @param timer Pointer to the timer.
+ * @param task_func The task function.
+ * @param arg The argument passed to the task function.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_timer_init(fossil_xtimer_t *timer, fossil_xtask_func_t task_func, void *arg);
+
+/**
+ * @brief Starts a timer, or moves it to a new time if it is pending.
+ *
+ * A periodic timer fires at fixed intervals from its first firing rather than from the end of
+ * its task, so a slow task may overlap its next run.
+ *
+ * @param wheel Pointer to the timer wheel.
+ * @param timer Pointer to the timer, which must stay valid while it is pending.
+ * @param delay_ms The delay before the first firing in milliseconds.
+ * @param period_ms The interval between firings in milliseconds, or 0 for a one-shot timer.
+ * @return int32_t 0 if the timer is started, -1 if the wheel is shutting down or the arguments are invalid.
+ */
+int32_t fossil_timer_start(fossil_xtimer_wheel_t *wheel, fossil_xtimer_t *timer, uint32_t delay_ms, uint32_t period_ms);
+
+/**
+ * @brief Cancels a pending timer.
+ *
+ * Once this returns the wheel no longer refers to the timer, which may be freed. A task already
+ * handed to the pool still runs.
+ *
+ * @param wheel Pointer to the timer wheel.
+ * @param timer Pointer to the timer.
+ * @return int32_t 0 if the timer was pending and is cancelled, -1 otherwise.
+ */
+int32_t fossil_timer_cancel(fossil_xtimer_wheel_t *wheel, fossil_xtimer_t *timer);
+
+/**
+ * @brief Checks whether a timer is pending.
+ *
+ * @param wheel Pointer to the timer wheel.
+ * @param timer Pointer to the timer.
+ * @return bool true if the timer will fire unless cancelled.
+ */
+bool fossil_timer_pending(fossil_xtimer_wheel_t *wheel, fossil_xtimer_t *timer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+
+#include <stdexcept>
+
+namespace fossil {
+
+class TimerWheel {
+public:
+    explicit TimerWheel(fossil_xthread_pool_t *pool = nullptr, uint32_t tick_us = FOSSIL_TIMER_DEFAULT_TICK_US) {
+        if (fossil_timer_wheel_create(&wheel_, pool, tick_us) != 0) {
+            throw std::runtime_error("Failed to create timer wheel");
+        }
+    }
+
+    explicit TimerWheel(ThreadPool &pool, uint32_t tick_us = FOSSIL_TIMER_DEFAULT_TICK_US)
+        : TimerWheel(&pool.get(), tick_us) {
+    }
+
+    ~TimerWheel() {
+        fossil_timer_wheel_erase(&wheel_);
+    }
+
+    TimerWheel(const TimerWheel &) = delete;
+    TimerWheel &operator=(const TimerWheel &) = delete;
+
+    void start(fossil_xtimer_t &timer, uint32_t delay_ms, uint32_t period_ms = 0) {
+        if (fossil_timer_start(&wheel_, &timer, delay_ms, period_ms) != 0) {
+            throw std::runtime_error("Failed to start timer");
+        }
+    }
+
+    bool cancel(fossil_xtimer_t &timer) {
+        return fossil_timer_cancel(&wheel_, &timer) == 0;
+    }
+
+    bool pending(fossil_xtimer_t &timer) {
+        return fossil_timer_pending(&wheel_, &timer);
+    }
+
+    size_t pending() {
+        return fossil_timer_wheel_pending(&wheel_);
+    }
+
+    fossil_xtimer_wheel_t &get() {
+        return wheel_;
+    }
+
+private:
+    fossil_xtimer_wheel_t wheel_;
+};
+
+} // namespace fossil
+
+#endif // __cplusplus
+
+#endif
@@ -0,0 +1,1201 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#include "fossil/core/bitmap.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define BITMAP_MAGIC 0x314D4246u // "FBM1"
+#define BITMAP_HEADER_SIZE 8
+#define BITMAP_CONTAINER_HEADER_SIZE 12
+
+typedef enum {
+    BITMAP_OP_AND,
+    BITMAP_OP_OR,
+    BITMAP_OP_XOR,
+    BITMAP_OP_ANDNOT
+} bitmap_op_t;
+
+// =================================================================
+// Word helpers
+// =================================================================
+
+static inline int bitmap_popcount(bitwise64 word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(word);
+#else
+    return fossil_binary_count_set_bits64(word);
+#endif
+}
+
+static inline int bitmap_ctz(bitwise64 word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    int count = 0;
+    while ((word & 1u) == 0) {
+        ++count;
+        word >>= 1;
+    }
+    return count;
+#endif
+}
+
+// Index of the k-th set bit of a word, k < popcount(word)
+static inline int bitmap_select_word(bitwise64 word, size_t k) {
+    while (k--) {
+        word &= word - 1;
+    }
+    return bitmap_ctz(word);
+}
+
+// dst[i] = a[i] op b[i]; dst may alias a
+static void bitmap_words_apply(bitwise64 *dst, const bitwise64 *a, const bitwise64 *b, size_t count, bitmap_op_t op) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 4 <= count; i += 4) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+        __m256i vr;
+        switch (op) {
+            case BITMAP_OP_AND:    vr = _mm256_and_si256(va, vb); break;
+            case BITMAP_OP_OR:     vr = _mm256_or_si256(va, vb); break;
+            case BITMAP_OP_XOR:    vr = _mm256_xor_si256(va, vb); break;
+            default:               vr = _mm256_andnot_si256(vb, va); break;
+        }
+        _mm256_storeu_si256((__m256i *)(dst + i), vr);
+    }
+#elif defined(__SSE2__)
+    for (; i + 2 <= count; i += 2) {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+        __m128i vr;
+        switch (op) {
+            case BITMAP_OP_AND:    vr = _mm_and_si128(va, vb); break;
+            case BITMAP_OP_OR:     vr = _mm_or_si128(va, vb); break;
+            case BITMAP_OP_XOR:    vr = _mm_xor_si128(va, vb); break;
+            default:               vr = _mm_andnot_si128(vb, va); break;
+        }
+        _mm_storeu_si128((__m128i *)(dst + i), vr);
+    }
+#endif
+    for (; i < count; ++i) {
+        switch (op) {
+            case BITMAP_OP_AND:    dst[i] = a[i] & b[i]; break;
+            case BITMAP_OP_OR:     dst[i] = a[i] | b[i]; break;
+            case BITMAP_OP_XOR:    dst[i] = a[i] ^ b[i]; break;
+            default:               dst[i] = a[i] & ~b[i]; break;
+        }
+    }
+}
+
+static size_t bitmap_words_count(const bitwise64 *words, size_t count) {
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        total += (size_t)bitmap_popcount(words[i]);
+    }
+    return total;
+}
+
+// Set bits [first, last] of a word array
+static void bitmap_words_set_range(bitwise64 *words, size_t first, size_t last) {
+    size_t first_word = first / 64;
+    size_t last_word = last / 64;
+    bitwise64 first_mask = ~(bitwise64)0 << (first % 64);
+    bitwise64 last_mask = ~(bitwise64)0 >> (63 - (last % 64));
+
+    if (first_word == last_word) {
+        words[first_word] |= first_mask & last_mask;
+        return;
+    }
+    words[first_word] |= first_mask;
+    for (size_t i = first_word + 1; i < last_word; ++i) {
+        words[i] = ~(bitwise64)0;
+    }
+    words[last_word] |= last_mask;
+}
+
+// =================================================================
+// Bitset
+// =================================================================
+
+static size_t bitset_words_for(size_t size) {
+    return (size + 63) / 64;
+}
+
+// Clear the bits past the logical size in the last used word
+static void bitset_trim_tail(fossil_bitset_t* bitset) {
+    size_t used = bitset_words_for(bitset->size);
+    if (bitset->size % 64 != 0) {
+        bitset->words[used - 1] &= ~(bitwise64)0 >> (64 - bitset->size % 64);
+    }
+}
+
+fossil_bitset_t* fossil_bitset_create(size_t size) {
+    fossil_bitset_t* bitset = (fossil_bitset_t*)malloc(sizeof(fossil_bitset_t));
+    if (!bitset) return cnullptr;
+
+    bitset->words = cnullptr;
+    bitset->size = 0;
+    bitset->capacity = 0;
+    if (size > 0 && fossil_bitset_resize(bitset, size) != FOSSIL_SUCCESS) {
+        free(bitset);
+        return cnullptr;
+    }
+    return bitset;
+}
+
+void fossil_bitset_erase(fossil_bitset_t* bitset) {
+    if (!bitset) return;
+
+    free(bitset->words);
+    free(bitset);
+}
+
+int32_t fossil_bitset_resize(fossil_bitset_t* bitset, size_t size) {
+    if (!bitset) return FOSSIL_ERROR;
+
+    size_t needed = bitset_words_for(size);
+    if (needed > bitset->capacity) {
+        size_t new_capacity = bitset->capacity ? bitset->capacity : 1;
+        while (new_capacity < needed) {
+            new_capacity *= 2;
+        }
+        bitwise64* words = (bitwise64*)realloc(bitset->words, new_capacity * sizeof(bitwise64));
+        if (!words) return FOSSIL_ERROR;
+        memset(words + bitset->capacity, 0, (new_capacity - bitset->capacity) * sizeof(bitwise64));
+        bitset->words = words;
+        bitset->capacity = new_capacity;
+    }
+
+    if (size < bitset->size) {
+        // Drop the truncated bits so that growing again yields cleared bits
+        size_t old_used = bitset_words_for(bitset->size);
+        memset(bitset->words + needed, 0, (old_used - needed) * sizeof(bitwise64));
+        bitset->size = size;
+        if (needed > 0) {
+            bitset_trim_tail(bitset);
+        }
+    } else {
+        bitset->size = size;
+    }
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_bitset_set(fossil_bitset_t* bitset, size_t index) {
+    if (!bitset) return FOSSIL_ERROR;
+
+    if (index >= bitset->size && fossil_bitset_resize(bitset, index + 1) != FOSSIL_SUCCESS) {
+        return FOSSIL_ERROR;
+    }
+    bitset->words[index / 64] |= (bitwise64)1 << (index % 64);
+    return FOSSIL_SUCCESS;
+}
+
+void fossil_bitset_clear(fossil_bitset_t* bitset, size_t index) {
+    if (!bitset || index >= bitset->size) return;
+
+    bitset->words[index / 64] &= ~((bitwise64)1 << (index % 64));
+}
+
+bool fossil_bitset_test(const fossil_bitset_t* bitset, size_t index) {
+    if (!bitset || index >= bitset->size) return false;
+
+    return (bitset->words[index / 64] >> (index % 64)) & 1u;
+}
+
+void fossil_bitset_reset(fossil_bitset_t* bitset) {
+    if (!bitset || !bitset->words) return;
+
+    memset(bitset->words, 0, bitset_words_for(bitset->size) * sizeof(bitwise64));
+}
+
+size_t fossil_bitset_count(const fossil_bitset_t* bitset) {
+    if (!bitset || !bitset->words) return 0;
+
+    return bitmap_words_count(bitset->words, bitset_words_for(bitset->size));
+}
+
+static int32_t bitset_apply(fossil_bitset_t* dst, const fossil_bitset_t* src, bitmap_op_t op) {
+    if (!dst || !src) return FOSSIL_ERROR;
+
+    bool grows = (op == BITMAP_OP_OR || op == BITMAP_OP_XOR);
+    if (grows && src->size > dst->size && fossil_bitset_resize(dst, src->size) != FOSSIL_SUCCESS) {
+        return FOSSIL_ERROR;
+    }
+
+    size_t dst_words = bitset_words_for(dst->size);
+    size_t src_words = bitset_words_for(src->size);
+    size_t common = dst_words < src_words ? dst_words : src_words;
+    if (common > 0) {
+        bitmap_words_apply(dst->words, dst->words, src->words, common, op);
+    }
+    if (op == BITMAP_OP_AND && dst_words > common) {
+        memset(dst->words + common, 0, (dst_words - common) * sizeof(bitwise64));
+    }
+    if (dst_words > 0) {
+        bitset_trim_tail(dst);
+    }
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_bitset_and(fossil_bitset_t* dst, const fossil_bitset_t* src) {
+    return bitset_apply(dst, src, BITMAP_OP_AND);
+}
+
+int32_t fossil_bitset_or(fossil_bitset_t* dst, const fossil_bitset_t* src) {
+    return bitset_apply(dst, src, BITMAP_OP_OR);
+}
+
+int32_t fossil_bitset_xor(fossil_bitset_t* dst, const fossil_bitset_t* src) {
+    return bitset_apply(dst, src, BITMAP_OP_XOR);
+}
+
+int32_t fossil_bitset_andnot(fossil_bitset_t* dst, const fossil_bitset_t* src) {
+    return bitset_apply(dst, src, BITMAP_OP_ANDNOT);
+}
+
+size_t fossil_bitset_rank(const fossil_bitset_t* bitset, size_t index) {
+    if (!bitset || !bitset->words) return 0;
+    if (index > bitset->size) index = bitset->size;
+
+    size_t rank = bitmap_words_count(bitset->words, index / 64);
+    if (index % 64 != 0) {
+        bitwise64 mask = ((bitwise64)1 << (index % 64)) - 1;
+        rank += (size_t)bitmap_popcount(bitset->words[index / 64] & mask);
+    }
+    return rank;
+}
+
+bool fossil_bitset_select(const fossil_bitset_t* bitset, size_t k, size_t* index) {
+    if (!bitset || !index) return false;
+
+    size_t used = bitset_words_for(bitset->size);
+    for (size_t i = 0; i < used; ++i) {
+        size_t count = (size_t)bitmap_popcount(bitset->words[i]);
+        if (k < count) {
+            *index = i * 64 + (size_t)bitmap_select_word(bitset->words[i], k);
+            return true;
+        }
+        k -= count;
+    }
+    return false;
+}
+
+bool fossil_bitset_next(const fossil_bitset_t* bitset, size_t from, size_t* index) {
+    if (!bitset || !index || from >= bitset->size) return false;
+
+    size_t used = bitset_words_for(bitset->size);
+    size_t i = from / 64;
+    bitwise64 word = bitset->words[i] & (~(bitwise64)0 << (from % 64));
+    while (true) {
+        if (word) {
+            *index = i * 64 + (size_t)bitmap_ctz(word);
+            return true;
+        }
+        if (++i >= used) return false;
+        word = bitset->words[i];
+    }
+}
+
+// =================================================================
+// Compressed bitmap containers
+// =================================================================
+
+static void container_free(fossil_bitmap_container_t* c) {
+    switch (c->kind) {
+        case FOSSIL_BITMAP_ARRAY:  free(c->data.array); break;
+        case FOSSIL_BITMAP_BITSET: free(c->data.bitset); break;
+        case FOSSIL_BITMAP_RUN:    free(c->data.runs); break;
+    }
+    c->data.array = cnullptr;
+    c->size = 0;
+    c->capacity = 0;
+    c->cardinality = 0;
+}
+
+static void container_init(fossil_bitmap_container_t* c, uint16_t key) {
+    c->key = key;
+    c->kind = FOSSIL_BITMAP_ARRAY;
+    c->cardinality = 0;
+    c->size = 0;
+    c->capacity = 0;
+    c->data.array = cnullptr;
+}
+
+// Expand any container into a full 1024-word bitset
+static void container_to_words(const fossil_bitmap_container_t* c, bitwise64* words) {
+    switch (c->kind) {
+        case FOSSIL_BITMAP_BITSET:
+            memcpy(words, c->data.bitset, FOSSIL_BITMAP_CHUNK_WORDS * sizeof(bitwise64));
+            break;
+        case FOSSIL_BITMAP_ARRAY:
+            memset(words, 0, FOSSIL_BITMAP_CHUNK_WORDS * sizeof(bitwise64));
+            for (uint32_t i = 0; i < c->size; ++i) {
+                words[c->data.array[i] / 64] |= (bitwise64)1 << (c->data.array[i] % 64);
+            }
+            break;
+        case FOSSIL_BITMAP_RUN:
+            memset(words, 0, FOSSIL_BITMAP_CHUNK_WORDS * sizeof(bitwise64));
+            for (uint32_t i = 0; i < c->size; ++i) {
+                bitmap_words_set_range(words, c->data.runs[i].start,
+                                       (size_t)c->data.runs[i].start + c->data.runs[i].length);
+            }
+            break;
+    }
+}
+
+// Replace the contents of c with words, picking array or bitset storage
+static int32_t container_from_words(fossil_bitmap_container_t* c, const bitwise64* words, uint32_t cardinality) {
+    uint16_t key = c->key;
+    container_free(c);
+    container_init(c, key);
+    if (cardinality == 0) return FOSSIL_SUCCESS;
+
+    if (cardinality <= FOSSIL_BITMAP_ARRAY_MAX) {
+        c->data.array = (uint16_t*)malloc(cardinality * sizeof(uint16_t));
+        if (!c->data.array) return FOSSIL_ERROR;
+        uint32_t n = 0;
+        for (uint32_t i = 0; i < FOSSIL_BITMAP_CHUNK_WORDS; ++i) {
+            bitwise64 word = words[i];
+            while (word) {
+                c->data.array[n++] = (uint16_t)(i * 64 + (uint32_t)bitmap_ctz(word));
+                word &= word - 1;
+            }
+        }
+        c->size = c->capacity = cardinality;
+    } else {
+        c->kind = FOSSIL_BITMAP_BITSET;
+        c->data.bitset = (bitwise64*)malloc(FOSSIL_BITMAP_CHUNK_WORDS * sizeof(bitwise64));
+        if (!c->data.bitset) {
+            c->kind = FOSSIL_BITMAP_ARRAY;
+            return FOSSIL_ERROR;
+        }
+        memcpy(c->data.bitset, words, FOSSIL_BITMAP_CHUNK_WORDS * sizeof(bitwise64));
+        c->size = c->capacity = FOSSIL_BITMAP_CHUNK_WORDS;
+    }
+    c->cardinality = cardinality;
+    return FOSSIL_SUCCESS;
+}
+
+// Convert c in place to bitset storage
+static int32_t container_make_bitset(fossil_bitmap_container_t* c) {
+    if (c->kind == FOSSIL_BITMAP_BITSET) return FOSSIL_SUCCESS;
+
+    bitwise64* words = (bitwise64*)malloc(FOSSIL_BITMAP_CHUNK_WORDS * sizeof(bitwise64));
+    if (!words) return FOSSIL_ERROR;
+    container_to_words(c, words);
+
+    uint32_t cardinality = c->cardinality;
+    uint16_t key = c->key;
+    container_free(c);
+    c->key = key;
+    c->kind = FOSSIL_BITMAP_BITSET;
+    c->data.bitset = words;
+    c->size = c->capacity = FOSSIL_BITMAP_CHUNK_WORDS;
+    c->cardinality = cardinality;
+    return FOSSIL_SUCCESS;
+}
+
+// Convert a run container to array or bitset storage so it can be edited
+static int32_t container_unrun(fossil_bitmap_container_t* c) {
+    if (c->kind != FOSSIL_BITMAP_RUN) return FOSSIL_SUCCESS;
+
+    bitwise64 words[FOSSIL_BITMAP_CHUNK_WORDS];
+    container_to_words(c, words);
+    return container_from_words(c, words, c->cardinality);
+}
+
+static uint32_t array_lower_bound(const uint16_t* array, uint32_t size, uint16_t value) {
+    uint32_t low = 0;
+    uint32_t high = size;
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        if (array[mid] < value) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// Index of the last run starting at or before value, or -1
+static int64_t run_find(const fossil_bitmap_container_t* c, uint16_t value) {
+    int64_t low = 0;
+    int64_t high = (int64_t)c->size - 1;
+    int64_t found = -1;
+    while (low <= high) {
+        int64_t mid = low + (high - low) / 2;
+        if (c->data.runs[mid].start <= value) {
+            found = mid;
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return found;
+}
+
+static bool container_contains(const fossil_bitmap_container_t* c, uint16_t value) {
+    switch (c->kind) {
+        case FOSSIL_BITMAP_ARRAY: {
+            uint32_t i = array_lower_bound(c->data.array, c->size, value);
+            return i < c->size && c->data.array[i] == value;
+        }
+        case FOSSIL_BITMAP_BITSET:
+            return (c->data.bitset[value / 64] >> (value % 64)) & 1u;
+        case FOSSIL_BITMAP_RUN: {
+            int64_t i = run_find(c, value);
+            return i >= 0 && value <= (uint32_t)c->data.runs[i].start + c->data.runs[i].length;
+        }
+    }
+    return false;
+}
+
+static int32_t container_add(fossil_bitmap_container_t* c, uint16_t value) {
+    if (container_unrun(c) != FOSSIL_SUCCESS) return FOSSIL_ERROR;
+
+    if (c->kind == FOSSIL_BITMAP_BITSET) {
+        bitwise64 bit = (bitwise64)1 << (value % 64);
+        if (!(c->data.bitset[value / 64] & bit)) {
+            c->data.bitset[value / 64] |= bit;
+            c->cardinality++;
+        }
+        return FOSSIL_SUCCESS;
+    }
+
+    uint32_t i = array_lower_bound(c->data.array, c->size, value);
+    if (i < c->size && c->data.array[i] == value) return FOSSIL_SUCCESS;
+
+    if (c->size >= FOSSIL_BITMAP_ARRAY_MAX) {
+        if (container_make_bitset(c) != FOSSIL_SUCCESS) return FOSSIL_ERROR;
+        return container_add(c, value);
+    }
+    if (c->size == c->capacity) {
+        uint32_t new_capacity = c->capacity ? c->capacity * 2 : 4;
+        if (new_capacity > FOSSIL_BITMAP_ARRAY_MAX) new_capacity = FOSSIL_BITMAP_ARRAY_MAX;
+        uint16_t* array = (uint16_t*)realloc(c->data.array, new_capacity * sizeof(uint16_t));
+        if (!array) return FOSSIL_ERROR;
+        c->data.array = array;
+        c->capacity = new_capacity;
+    }
+    memmove(c->data.array + i + 1, c->data.array + i, (c->size - i) * sizeof(uint16_t));
+    c->data.array[i] = value;
+    c->size++;
+    c->cardinality++;
+    return FOSSIL_SUCCESS;
+}
+
+static int32_t container_remove(fossil_bitmap_container_t* c, uint16_t value) {
+    if (!container_contains(c, value)) return FOSSIL_ERROR;
+    if (container_unrun(c) != FOSSIL_SUCCESS) return FOSSIL_ERROR;
+
+    if (c->kind == FOSSIL_BITMAP_BITSET) {
+        c->data.bitset[value / 64] &= ~((bitwise64)1 << (value % 64));
+        c->cardinality--;
+        if (c->cardinality <= FOSSIL_BITMAP_ARRAY_MAX / 2) {
+            bitwise64* words = c->data.bitset;
+            c->data.bitset = cnullptr;
+            c->kind = FOSSIL_BITMAP_ARRAY;
+            int32_t status = container_from_words(c, words, c->cardinality);
+            free(words);
+            return status;
+        }
+        return FOSSIL_SUCCESS;
+    }
+
+    uint32_t i = array_lower_bound(c->data.array, c->size, value);
+    memmove(c->data.array + i, c->data.array + i + 1, (c->size - i - 1) * sizeof(uint16_t));
+    c->size--;
+    c->cardinality--;
+    return FOSSIL_SUCCESS;
+}
+
+static int32_t container_copy(fossil_bitmap_container_t* dst, const fossil_bitmap_container_t* src) {
+    size_t bytes = 0;
+    *dst = *src;
+    switch (src->kind) {
+        case FOSSIL_BITMAP_ARRAY:  bytes = src->size * sizeof(uint16_t); break;
+        case FOSSIL_BITMAP_BITSET: bytes = FOSSIL_BITMAP_CHUNK_WORDS * sizeof(bitwise64); break;
+        case FOSSIL_BITMAP_RUN:    bytes = src->size * sizeof(fossil_bitmap_run_t); break;
+    }
+    dst->capacity = src->kind == FOSSIL_BITMAP_BITSET ? FOSSIL_BITMAP_CHUNK_WORDS : src->size;
+    dst->data.array = cnullptr;
+    if (bytes == 0) return FOSSIL_SUCCESS;
+
+    void* data = malloc(bytes);
+    if (!data) return FOSSIL_ERROR;
+    memcpy(data, src->data.array, bytes);
+    dst->data.array = (uint16_t*)data;
+    return FOSSIL_SUCCESS;
+}
+
+// Re-encode a container as runs when that is smaller than array or bitset
+static void container_run_optimize(fossil_bitmap_container_t* c) {
+    if (c->cardinality == 0) return;
+
+    bitwise64 words[FOSSIL_BITMAP_CHUNK_WORDS];
+    container_to_words(c, words);
+
+    uint32_t run_count = 0;
+    bitwise64 carry = 0;
+    for (uint32_t i = 0; i < FOSSIL_BITMAP_CHUNK_WORDS; ++i) {
+        run_count += (uint32_t)bitmap_popcount(words[i] & ~((words[i] << 1) | carry));
+        carry = words[i] >> 63;
+    }
+
+    size_t run_bytes = run_count * sizeof(fossil_bitmap_run_t);
+    size_t other_bytes = c->cardinality <= FOSSIL_BITMAP_ARRAY_MAX
+        ? c->cardinality * sizeof(uint16_t)
+        : FOSSIL_BITMAP_CHUNK_WORDS * sizeof(bitwise64);
+    if (run_bytes >= other_bytes) {
+        if (c->kind == FOSSIL_BITMAP_RUN) {
+            container_from_words(c, words, c->cardinality);
+        }
+        return;
+    }
+
+    fossil_bitmap_run_t* runs = (fossil_bitmap_run_t*)malloc(run_bytes);
+    if (!runs) return;
+    uint32_t n = 0;
+    uint32_t value = 0;
+    while (value < FOSSIL_BITMAP_CHUNK_BITS) {
+        if (!((words[value / 64] >> (value % 64)) & 1u)) {
+            ++value;
+            continue;
+        }
+        uint32_t start = value;
+        while (value < FOSSIL_BITMAP_CHUNK_BITS && ((words[value / 64] >> (value % 64)) & 1u)) {
+            ++value;
+        }
+        runs[n].start = (uint16_t)start;
+        runs[n].length = (uint16_t)(value - start - 1);
+        ++n;
+    }
+
+    uint32_t cardinality = c->cardinality;
+    uint16_t key = c->key;
+    container_free(c);
+    c->key = key;
+    c->kind = FOSSIL_BITMAP_RUN;
+    c->data.runs = runs;
+    c->size = c->capacity = n;
+    c->cardinality = cardinality;
+}
+
+// out = a op b; out is initialised by this function
+static int32_t container_apply(fossil_bitmap_container_t* out, const fossil_bitmap_container_t* a,
+                               const fossil_bitmap_container_t* b, bitmap_op_t op) {
+    container_init(out, a->key);
+
+    // Intersections and differences of a small array only need membership tests
+    if (a->kind == FOSSIL_BITMAP_ARRAY && (op == BITMAP_OP_AND || op == BITMAP_OP_ANDNOT)) {
+        if (a->size == 0) return FOSSIL_SUCCESS;
+        out->data.array = (uint16_t*)malloc(a->size * sizeof(uint16_t));
+        if (!out->data.array) return FOSSIL_ERROR;
+        for (uint32_t i = 0; i < a->size; ++i) {
+            bool present = container_contains(b, a->data.array[i]);
+            if (present == (op == BITMAP_OP_AND)) {
+                out->data.array[out->size++] = a->data.array[i];
+            }
+        }
+        out->capacity = a->size;
+        out->cardinality = out->size;
+        return FOSSIL_SUCCESS;
+    }
+    if (b->kind == FOSSIL_BITMAP_ARRAY && op == BITMAP_OP_AND) {
+        return container_apply(out, b, a, op);
+    }
+
+    bitwise64 wa[FOSSIL_BITMAP_CHUNK_WORDS];
+    bitwise64 wb[FOSSIL_BITMAP_CHUNK_WORDS];
+    container_to_words(a, wa);
+    container_to_words(b, wb);
+    bitmap_words_apply(wa, wa, wb, FOSSIL_BITMAP_CHUNK_WORDS, op);
+    return container_from_words(out, wa, (uint32_t)bitmap_words_count(wa, FOSSIL_BITMAP_CHUNK_WORDS));
+}
+
+// =================================================================
+// Compressed bitmap
+// =================================================================
+
+// Binary search for a key; returns true if found, *index is the insert position
+static bool bitmap_find(const fossil_bitmap_t* bitmap, uint16_t key, size_t* index) {
+    size_t low = 0;
+    size_t high = bitmap->size;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (bitmap->containers[mid].key < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    *index = low;
+    return low < bitmap->size && bitmap->containers[low].key == key;
+}
+
+static int32_t bitmap_reserve(fossil_bitmap_t* bitmap, size_t count) {
+    if (count <= bitmap->capacity) return FOSSIL_SUCCESS;
+
+    size_t new_capacity = bitmap->capacity ? bitmap->capacity * 2 : 4;
+    while (new_capacity < count) {
+        new_capacity *= 2;
+    }
+    fossil_bitmap_container_t* containers = (fossil_bitmap_container_t*)realloc(
+        bitmap->containers, new_capacity * sizeof(fossil_bitmap_container_t));
+    if (!containers) return FOSSIL_ERROR;
+    bitmap->containers = containers;
+    bitmap->capacity = new_capacity;
+    return FOSSIL_SUCCESS;
+}
+
+// Get the container for a key, inserting an empty one if it does not exist
+static fossil_bitmap_container_t* bitmap_get_or_insert(fossil_bitmap_t* bitmap, uint16_t key) {
+    size_t index;
+    if (bitmap_find(bitmap, key, &index)) {
+        return &bitmap->containers[index];
+    }
+    if (bitmap_reserve(bitmap, bitmap->size + 1) != FOSSIL_SUCCESS) return cnullptr;
+
+    memmove(bitmap->containers + index + 1, bitmap->containers + index,
+            (bitmap->size - index) * sizeof(fossil_bitmap_container_t));
+    container_init(&bitmap->containers[index], key);
+    bitmap->size++;
+    return &bitmap->containers[index];
+}
+
+static void bitmap_remove_at(fossil_bitmap_t* bitmap, size_t index) {
+    container_free(&bitmap->containers[index]);
+    memmove(bitmap->containers + index, bitmap->containers + index + 1,
+            (bitmap->size - index - 1) * sizeof(fossil_bitmap_container_t));
+    bitmap->size--;
+}
+
+// Append a non-empty container (taking ownership) or drop an empty one
+static int32_t bitmap_append(fossil_bitmap_t* bitmap, fossil_bitmap_container_t* c) {
+    if (c->cardinality == 0) {
+        container_free(c);
+        return FOSSIL_SUCCESS;
+    }
+    if (bitmap_reserve(bitmap, bitmap->size + 1) != FOSSIL_SUCCESS) {
+        container_free(c);
+        return FOSSIL_ERROR;
+    }
+    bitmap->containers[bitmap->size++] = *c;
+    return FOSSIL_SUCCESS;
+}
+
+fossil_bitmap_t* fossil_bitmap_create(void) {
+    fossil_bitmap_t* bitmap = (fossil_bitmap_t*)malloc(sizeof(fossil_bitmap_t));
+    if (bitmap) {
+        bitmap->containers = cnullptr;
+        bitmap->size = 0;
+        bitmap->capacity = 0;
+    }
+    return bitmap;
+}
+
+void fossil_bitmap_erase(fossil_bitmap_t* bitmap) {
+    if (!bitmap) return;
+
+    fossil_bitmap_clear(bitmap);
+    free(bitmap->containers);
+    free(bitmap);
+}
+
+void fossil_bitmap_clear(fossil_bitmap_t* bitmap) {
+    if (!bitmap) return;
+
+    for (size_t i = 0; i < bitmap->size; ++i) {
+        container_free(&bitmap->containers[i]);
+    }
+    bitmap->size = 0;
+}
+
+fossil_bitmap_t* fossil_bitmap_copy(const fossil_bitmap_t* bitmap) {
+    if (!bitmap) return cnullptr;
+
+    fossil_bitmap_t* copy = fossil_bitmap_create();
+    if (!copy) return cnullptr;
+    if (bitmap_reserve(copy, bitmap->size) != FOSSIL_SUCCESS) {
+        fossil_bitmap_erase(copy);
+        return cnullptr;
+    }
+    for (size_t i = 0; i < bitmap->size; ++i) {
+        if (container_copy(&copy->containers[i], &bitmap->containers[i]) != FOSSIL_SUCCESS) {
+            fossil_bitmap_erase(copy);
+            return cnullptr;
+        }
+        copy->size++;
+    }
+    return copy;
+}
+
+int32_t fossil_bitmap_add(fossil_bitmap_t* bitmap, uint32_t value) {
+    if (!bitmap) return FOSSIL_ERROR;
+
+    fossil_bitmap_container_t* c = bitmap_get_or_insert(bitmap, (uint16_t)(value >> 16));
+    if (!c) return FOSSIL_ERROR;
+    return container_add(c, (uint16_t)(value & 0xFFFF));
+}
+
+int32_t fossil_bitmap_add_range(fossil_bitmap_t* bitmap, uint32_t min, uint32_t max) {
+    if (!bitmap || min > max) return FOSSIL_ERROR;
+
+    for (uint32_t key = min >> 16; key <= (max >> 16); ++key) {
+        fossil_bitmap_container_t* c = bitmap_get_or_insert(bitmap, (uint16_t)key);
+        if (!c || container_make_bitset(c) != FOSSIL_SUCCESS) return FOSSIL_ERROR;
+
+        uint32_t first = key == (min >> 16) ? (min & 0xFFFF) : 0;
+        uint32_t last = key == (max >> 16) ? (max & 0xFFFF) : 0xFFFF;
+        bitmap_words_set_range(c->data.bitset, first, last);
+        c->cardinality = (uint32_t)bitmap_words_count(c->data.bitset, FOSSIL_BITMAP_CHUNK_WORDS);
+        container_run_optimize(c);
+        if (key == 0xFFFF) break;
+    }
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_bitmap_remove(fossil_bitmap_t* bitmap, uint32_t value) {
+    if (!bitmap) return FOSSIL_ERROR;
+
+    size_t index;
+    if (!bitmap_find(bitmap, (uint16_t)(value >> 16), &index)) return FOSSIL_ERROR;
+
+    fossil_bitmap_container_t* c = &bitmap->containers[index];
+    if (container_remove(c, (uint16_t)(value & 0xFFFF)) != FOSSIL_SUCCESS) return FOSSIL_ERROR;
+    if (c->cardinality == 0) {
+        bitmap_remove_at(bitmap, index);
+    }
+    return FOSSIL_SUCCESS;
+}
+
+bool fossil_bitmap_contains(const fossil_bitmap_t* bitmap, uint32_t value) {
+    if (!bitmap) return false;
+
+    size_t index;
+    if (!bitmap_find(bitmap, (uint16_t)(value >> 16), &index)) return false;
+    return container_contains(&bitmap->containers[index], (uint16_t)(value & 0xFFFF));
+}
+
+uint64_t fossil_bitmap_cardinality(const fossil_bitmap_t* bitmap) {
+    if (!bitmap) return 0;
+
+    uint64_t total = 0;
+    for (size_t i = 0; i < bitmap->size; ++i) {
+        total += bitmap->containers[i].cardinality;
+    }
+    return total;
+}
+
+bool fossil_bitmap_equals(const fossil_bitmap_t* a, const fossil_bitmap_t* b) {
+    if (!a || !b) return a == b;
+    if (a->size != b->size) return false;
+
+    bitwise64 wa[FOSSIL_BITMAP_CHUNK_WORDS];
+    bitwise64 wb[FOSSIL_BITMAP_CHUNK_WORDS];
+    for (size_t i = 0; i < a->size; ++i) {
+        const fossil_bitmap_container_t* ca = &a->containers[i];
+        const fossil_bitmap_container_t* cb = &b->containers[i];
+        if (ca->key != cb->key || ca->cardinality != cb->cardinality) return false;
+        container_to_words(ca, wa);
+        container_to_words(cb, wb);
+        if (memcmp(wa, wb, sizeof(wa)) != 0) return false;
+    }
+    return true;
+}
+
+void fossil_bitmap_run_optimize(fossil_bitmap_t* bitmap) {
+    if (!bitmap) return;
+
+    for (size_t i = 0; i < bitmap->size; ++i) {
+        container_run_optimize(&bitmap->containers[i]);
+    }
+}
+
+static fossil_bitmap_t* bitmap_apply(const fossil_bitmap_t* a, const fossil_bitmap_t* b, bitmap_op_t op) {
+    if (!a || !b) return cnullptr;
+
+    fossil_bitmap_t* result = fossil_bitmap_create();
+    if (!result) return cnullptr;
+
+    // Containers present in only one operand are kept for OR/XOR (either side)
+    // and for ANDNOT (left side only); AND drops them.
+    bool keep_left = op != BITMAP_OP_AND;
+    bool keep_right = op == BITMAP_OP_OR || op == BITMAP_OP_XOR;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < a->size || j < b->size) {
+        fossil_bitmap_container_t c;
+        int32_t status = FOSSIL_SUCCESS;
+
+        if (j >= b->size || (i < a->size && a->containers[i].key < b->containers[j].key)) {
+            if (keep_left) {
+                status = container_copy(&c, &a->containers[i]);
+                if (status == FOSSIL_SUCCESS) status = bitmap_append(result, &c);
+            }
+            ++i;
+        } else if (i >= a->size || b->containers[j].key < a->containers[i].key) {
+            if (keep_right) {
+                status = container_copy(&c, &b->containers[j]);
+                if (status == FOSSIL_SUCCESS) status = bitmap_append(result, &c);
+            }
+            ++j;
+        } else {
+            status = container_apply(&c, &a->containers[i], &b->containers[j], op);
+            if (status == FOSSIL_SUCCESS) {
+                status = bitmap_append(result, &c);
+            } else {
+                container_free(&c);
+            }
+            ++i;
+            ++j;
+        }
+
+        if (status != FOSSIL_SUCCESS) {
+            fossil_bitmap_erase(result);
+            return cnullptr;
+        }
+    }
+    return result;
+}
+
+fossil_bitmap_t* fossil_bitmap_and(const fossil_bitmap_t* a, const fossil_bitmap_t* b) {
+    return bitmap_apply(a, b, BITMAP_OP_AND);
+}
+
+fossil_bitmap_t* fossil_bitmap_or(const fossil_bitmap_t* a, const fossil_bitmap_t* b) {
+    return bitmap_apply(a, b, BITMAP_OP_OR);
+}
+
+fossil_bitmap_t* fossil_bitmap_xor(const fossil_bitmap_t* a, const fossil_bitmap_t* b) {
+    return bitmap_apply(a, b, BITMAP_OP_XOR);
+}
+
+fossil_bitmap_t* fossil_bitmap_andnot(const fossil_bitmap_t* a, const fossil_bitmap_t* b) {
+    return bitmap_apply(a, b, BITMAP_OP_ANDNOT);
+}
+
+// Number of values <= value inside one container
+static uint32_t container_rank(const fossil_bitmap_container_t* c, uint16_t value) {
+    switch (c->kind) {
+        case FOSSIL_BITMAP_ARRAY: {
+            uint32_t i = array_lower_bound(c->data.array, c->size, value);
+            return (i < c->size && c->data.array[i] == value) ? i + 1 : i;
+        }
+        case FOSSIL_BITMAP_BITSET: {
+            uint32_t rank = (uint32_t)bitmap_words_count(c->data.bitset, value / 64);
+            bitwise64 mask = ~(bitwise64)0 >> (63 - (value % 64));
+            return rank + (uint32_t)bitmap_popcount(c->data.bitset[value / 64] & mask);
+        }
+        case FOSSIL_BITMAP_RUN: {
+            uint32_t rank = 0;
+            for (uint32_t i = 0; i < c->size && c->data.runs[i].start <= value; ++i) {
+                uint32_t end = (uint32_t)c->data.runs[i].start + c->data.runs[i].length;
+                rank += (value < end ? value : end) - c->data.runs[i].start + 1;
+            }
+            return rank;
+        }
+    }
+    return 0;
+}
+
+uint64_t fossil_bitmap_rank(const fossil_bitmap_t* bitmap, uint32_t value) {
+    if (!bitmap) return 0;
+
+    uint16_t key = (uint16_t)(value >> 16);
+    uint64_t rank = 0;
+    for (size_t i = 0; i < bitmap->size && bitmap->containers[i].key <= key; ++i) {
+        if (bitmap->containers[i].key < key) {
+            rank += bitmap->containers[i].cardinality;
+        } else {
+            rank += container_rank(&bitmap->containers[i], (uint16_t)(value & 0xFFFF));
+        }
+    }
+    return rank;
+}
+
+bool fossil_bitmap_select(const fossil_bitmap_t* bitmap, uint64_t k, uint32_t* value) {
+    if (!bitmap || !value) return false;
+
+    for (size_t i = 0; i < bitmap->size; ++i) {
+        const fossil_bitmap_container_t* c = &bitmap->containers[i];
+        if (k >= c->cardinality) {
+            k -= c->cardinality;
+            continue;
+        }
+
+        uint32_t low = 0;
+        switch (c->kind) {
+            case FOSSIL_BITMAP_ARRAY:
+                low = c->data.array[k];
+                break;
+            case FOSSIL_BITMAP_BITSET:
+                for (uint32_t w = 0; w < FOSSIL_BITMAP_CHUNK_WORDS; ++w) {
+                    uint32_t count = (uint32_t)bitmap_popcount(c->data.bitset[w]);
+                    if (k < count) {
+                        low = w * 64 + (uint32_t)bitmap_select_word(c->data.bitset[w], (size_t)k);
+                        break;
+                    }
+                    k -= count;
+                }
+                break;
+            case FOSSIL_BITMAP_RUN:
+                for (uint32_t r = 0; r < c->size; ++r) {
+                    uint32_t count = (uint32_t)c->data.runs[r].length + 1;
+                    if (k < count) {
+                        low = c->data.runs[r].start + (uint32_t)k;
+                        break;
+                    }
+                    k -= count;
+                }
+                break;
+        }
+        *value = ((uint32_t)c->key << 16) | low;
+        return true;
+    }
+    return false;
+}
+
+fossil_bitmap_iterator_t fossil_bitmap_iterator_create(const fossil_bitmap_t* bitmap) {
+    fossil_bitmap_iterator_t iterator;
+    iterator.bitmap = bitmap;
+    iterator.container = 0;
+    iterator.position = 0;
+    iterator.offset = 0;
+    return iterator;
+}
+
+bool fossil_bitmap_iterator_next(fossil_bitmap_iterator_t* iterator, uint32_t* value) {
+    if (!iterator || !iterator->bitmap || !value) return false;
+
+    const fossil_bitmap_t* bitmap = iterator->bitmap;
+    while (iterator->container < bitmap->size) {
+        const fossil_bitmap_container_t* c = &bitmap->containers[iterator->container];
+        uint32_t high = (uint32_t)c->key << 16;
+
+        switch (c->kind) {
+            case FOSSIL_BITMAP_ARRAY:
+                if (iterator->position < c->size) {
+                    *value = high | c->data.array[iterator->position++];
+                    return true;
+                }
+                break;
+            case FOSSIL_BITMAP_BITSET:
+                // position is the next bit to examine
+                while (iterator->position < FOSSIL_BITMAP_CHUNK_BITS) {
+                    uint32_t w = iterator->position / 64;
+                    bitwise64 word = c->data.bitset[w] & (~(bitwise64)0 << (iterator->position % 64));
+                    if (word) {
+                        uint32_t bit = w * 64 + (uint32_t)bitmap_ctz(word);
+                        iterator->position = bit + 1;
+                        *value = high | bit;
+                        return true;
+                    }
+                    iterator->position = (w + 1) * 64;
+                }
+                break;
+            case FOSSIL_BITMAP_RUN:
+                // position is the run index, offset the distance into the run
+                if (iterator->position < c->size) {
+                    const fossil_bitmap_run_t* run = &c->data.runs[iterator->position];
+                    *value = high | (run->start + iterator->offset);
+                    if (iterator->offset++ == run->length) {
+                        iterator->position++;
+                        iterator->offset = 0;
+                    }
+                    return true;
+                }
+                break;
+        }
+
+        iterator->container++;
+        iterator->position = 0;
+        iterator->offset = 0;
+    }
+    return false;
+}
+
+// =================================================================
+// Serialization
+// =================================================================
+
+static void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; ++i) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static void put_u64(uint8_t* p, uint64_t v) {
+    for (int i = 0; i < 8; ++i) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint16_t get_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t* p) {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; ++i) v |= (uint32_t)p[i] << (8 * i);
+    return v;
+}
+
+static uint64_t get_u64(const uint8_t* p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) v |= (uint64_t)p[i] << (8 * i);
+    return v;
+}
+
+static size_t container_payload_size(fossil_bitmap_kind_t kind, uint32_t size) {
+    switch (kind) {
+        case FOSSIL_BITMAP_ARRAY:  return (size_t)size * 2;
+        case FOSSIL_BITMAP_BITSET: return FOSSIL_BITMAP_CHUNK_WORDS * 8;
+        case FOSSIL_BITMAP_RUN:    return (size_t)size * 4;
+    }
+    return 0;
+}
+
+size_t fossil_bitmap_serialized_size(const fossil_bitmap_t* bitmap) {
+    if (!bitmap) return 0;
+
+    size_t total = BITMAP_HEADER_SIZE;
+    for (size_t i = 0; i < bitmap->size; ++i) {
+        total += BITMAP_CONTAINER_HEADER_SIZE +
+                 container_payload_size(bitmap->containers[i].kind, bitmap->containers[i].size);
+    }
+    return total;
+}
+
+size_t fossil_bitmap_serialize(const fossil_bitmap_t* bitmap, void* buffer, size_t capacity) {
+    size_t total = fossil_bitmap_serialized_size(bitmap);
+    if (!bitmap || !buffer || total > capacity || bitmap->size > UINT32_MAX) return 0;
+
+    uint8_t* p = (uint8_t*)buffer;
+    put_u32(p, BITMAP_MAGIC);
+    put_u32(p + 4, (uint32_t)bitmap->size);
+    p += BITMAP_HEADER_SIZE;
+
+    for (size_t i = 0; i < bitmap->size; ++i) {
+        const fossil_bitmap_container_t* c = &bitmap->containers[i];
+        put_u16(p, c->key);
+        p[2] = (uint8_t)c->kind;
+        p[3] = 0;
+        put_u32(p + 4, c->cardinality);
+        put_u32(p + 8, c->size);
+        p += BITMAP_CONTAINER_HEADER_SIZE;
+
+        switch (c->kind) {
+            case FOSSIL_BITMAP_ARRAY:
+                for (uint32_t j = 0; j < c->size; ++j, p += 2) put_u16(p, c->data.array[j]);
+                break;
+            case FOSSIL_BITMAP_BITSET:
+                for (uint32_t j = 0; j < FOSSIL_BITMAP_CHUNK_WORDS; ++j, p += 8) put_u64(p, c->data.bitset[j]);
+                break;
+            case FOSSIL_BITMAP_RUN:
+                for (uint32_t j = 0; j < c->size; ++j, p += 4) {
+                    put_u16(p, c->data.runs[j].start);
+                    put_u16(p + 2, c->data.runs[j].length);
+                }
+                break;
+        }
+    }
+    return total;
+}
+
+fossil_bitmap_t* fossil_bitmap_deserialize(const void* buffer, size_t length) {
+    const uint8_t* p = (const uint8_t*)buffer;
+    if (!p || length < BITMAP_HEADER_SIZE || get_u32(p) != BITMAP_MAGIC) return cnullptr;
+
+    uint32_t count = get_u32(p + 4);
+    const uint8_t* end = p + length;
+    p += BITMAP_HEADER_SIZE;
+
+    fossil_bitmap_t* bitmap = fossil_bitmap_create();
+    if (!bitmap) return cnullptr;
+    if (bitmap_reserve(bitmap, count) != FOSSIL_SUCCESS) goto fail;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        if ((size_t)(end - p) < BITMAP_CONTAINER_HEADER_SIZE) goto fail;
+
+        fossil_bitmap_container_t c;
+        container_init(&c, get_u16(p));
+        fossil_bitmap_kind_t kind = (fossil_bitmap_kind_t)p[2];
+        uint32_t cardinality = get_u32(p + 4);
+        uint32_t size = get_u32(p + 8);
+        p += BITMAP_CONTAINER_HEADER_SIZE;
+
+        if (kind > FOSSIL_BITMAP_RUN || (kind == FOSSIL_BITMAP_ARRAY && size > FOSSIL_BITMAP_ARRAY_MAX) ||
+            (kind == FOSSIL_BITMAP_RUN && size > FOSSIL_BITMAP_CHUNK_BITS / 2) ||
+            (bitmap->size > 0 && bitmap->containers[bitmap->size - 1].key >= c.key)) {
+            goto fail;
+        }
+        size_t payload = container_payload_size(kind, size);
+        if ((size_t)(end - p) < payload) goto fail;
+
+        c.kind = kind;
+        c.cardinality = cardinality;
+        c.size = c.capacity = kind == FOSSIL_BITMAP_BITSET ? FOSSIL_BITMAP_CHUNK_WORDS : size;
+        if (payload > 0) {
+            c.data.array = (uint16_t*)malloc(payload);
+            if (!c.data.array) goto fail;
+        }
+        switch (kind) {
+            case FOSSIL_BITMAP_ARRAY:
+                for (uint32_t j = 0; j < size; ++j, p += 2) c.data.array[j] = get_u16(p);
+                break;
+            case FOSSIL_BITMAP_BITSET:
+                for (uint32_t j = 0; j < FOSSIL_BITMAP_CHUNK_WORDS; ++j, p += 8) c.data.bitset[j] = get_u64(p);
+                break;
+            case FOSSIL_BITMAP_RUN:
+                for (uint32_t j = 0; j < size; ++j, p += 4) {
+                    c.data.runs[j].start = get_u16(p);
+                    c.data.runs[j].length = get_u16(p + 2);
+                }
+                break;
+        }
+
+        // Never trust the stored cardinality; rank/select index by it
+        bitwise64 words[FOSSIL_BITMAP_CHUNK_WORDS];
+        bool valid = true;
+        for (uint32_t j = 1; kind == FOSSIL_BITMAP_ARRAY && j < size; ++j) {
+            valid = valid && c.data.array[j - 1] < c.data.array[j];
+        }
+        for (uint32_t j = 0; kind == FOSSIL_BITMAP_RUN && j < size; ++j) {
+            uint32_t run_end = (uint32_t)c.data.runs[j].start + c.data.runs[j].length;
+            valid = valid && run_end < FOSSIL_BITMAP_CHUNK_BITS &&
+                    (j == 0 || (uint32_t)c.data.runs[j - 1].start + c.data.runs[j - 1].length + 1 < c.data.runs[j].start);
+        }
+        if (valid) {
+            container_to_words(&c, words);
+            valid = bitmap_words_count(words, FOSSIL_BITMAP_CHUNK_WORDS) == cardinality && cardinality > 0;
+        }
+        if (!valid) {
+            container_free(&c);
+            goto fail;
+        }
+        bitmap->containers[bitmap->size++] = c;
+    }
+    return bitmap;
+
+fail:
+    fossil_bitmap_erase(bitmap);
+    return cnullptr;
+}
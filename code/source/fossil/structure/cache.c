@@ -0,0 +1,698 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#include "fossil/structure/cache.h"
+#include "fossil/threads/mutexs.h"
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#define FOSSIL_CACHE_NIL UINT32_MAX
+#define FOSSIL_CACHE_MAX_CAPACITY (UINT32_MAX / 8)
+
+// Lists an entry can be on. LRU and CLOCK only use T1.
+enum {
+    FOSSIL_CACHE_T1,   // Resident, seen once recently (ARC) or all entries
+    FOSSIL_CACHE_T2,   // Resident, seen at least twice recently (ARC)
+    FOSSIL_CACHE_B1,   // Ghost hashes evicted from T1 (ARC)
+    FOSSIL_CACHE_B2,   // Ghost hashes evicted from T2 (ARC)
+    FOSSIL_CACHE_FREE  // Unused slab entry
+};
+
+struct fossil_cache_entry_t {
+    fossil_tofu_t key;
+    fossil_tofu_t value;
+    uint64_t hash;
+    size_t bytes;     // Bytes charged against the budget
+    uint32_t prev;
+    uint32_t next;    // Next entry in the list, or in the free list
+    uint8_t list;
+    bool referenced;  // CLOCK second chance bit
+};
+
+struct fossil_cache_shard_t {
+    fossil_xmutex_t lock;
+    fossil_cache_t* cache;
+    char padding[64]; // Keep neighbouring shard locks off the same cache line
+};
+
+static inline bool fossil_cache_resident(const fossil_cache_entry_t* entry) {
+    return entry->list == FOSSIL_CACHE_T1 || entry->list == FOSSIL_CACHE_T2;
+}
+
+static inline size_t fossil_cache_resident_count(const fossil_cache_t* cache) {
+    return cache->lists[FOSSIL_CACHE_T1].count + cache->lists[FOSSIL_CACHE_T2].count;
+}
+
+static inline uint64_t fossil_cache_mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= UINT64_C(0xbf58476d1ce4e5b9);
+    x ^= x >> 27;
+    x *= UINT64_C(0x94d049bb133111eb);
+    return x ^ (x >> 31);
+}
+
+static uint64_t fossil_cache_hash_bytes(const void* data, size_t length, uint64_t seed) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    uint64_t hash = UINT64_C(0xcbf29ce484222325) ^ seed;
+    for (size_t i = 0; i < length; ++i) {
+        hash = (hash ^ bytes[i]) * UINT64_C(0x100000001b3);
+    }
+    return fossil_cache_mix(hash);
+}
+
+uint64_t fossil_cache_hash(fossil_tofu_t key) {
+    uint64_t seed = (uint64_t)key.type;
+    switch (key.type) {
+        case FOSSIL_TOFU_TYPE_INT:
+            return fossil_cache_mix((uint64_t)key.value.int_val ^ (seed << 56));
+        case FOSSIL_TOFU_TYPE_UINT:
+        case FOSSIL_TOFU_TYPE_HEX:
+        case FOSSIL_TOFU_TYPE_OCTAL:
+            return fossil_cache_mix(key.value.uint_val ^ (seed << 56));
+        case FOSSIL_TOFU_TYPE_FLOAT: {
+            float value = key.value.float_val == 0.0f ? 0.0f : key.value.float_val; // -0 equals 0
+            uint32_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            return fossil_cache_mix(bits ^ (seed << 56));
+        }
+        case FOSSIL_TOFU_TYPE_DOUBLE: {
+            double value = key.value.double_val == 0.0 ? 0.0 : key.value.double_val;
+            uint64_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            return fossil_cache_mix(bits ^ (seed << 56));
+        }
+        case FOSSIL_TOFU_TYPE_BSTR:
+            return fossil_cache_hash_bytes(key.value.byte_string_val, strlen(key.value.byte_string_val), seed);
+        case FOSSIL_TOFU_TYPE_CSTR:
+            return fossil_cache_hash_bytes(key.value.c_string_val, strlen(key.value.c_string_val), seed);
+        case FOSSIL_TOFU_TYPE_BCHAR:
+            return fossil_cache_hash_bytes(key.value.byte_val, strlen((const char*)key.value.byte_val), seed);
+        case FOSSIL_TOFU_TYPE_WSTR:
+            return fossil_cache_hash_bytes(key.value.wide_string_val, wcslen(key.value.wide_string_val) * sizeof(wchar_t), seed);
+        case FOSSIL_TOFU_TYPE_CCHAR:
+            return fossil_cache_mix((uint64_t)(unsigned char)key.value.char_val ^ (seed << 56));
+        case FOSSIL_TOFU_TYPE_WCHAR:
+            return fossil_cache_mix((uint64_t)key.value.wchar_val ^ (seed << 56));
+        case FOSSIL_TOFU_TYPE_BOOL:
+            return fossil_cache_mix((uint64_t)key.value.bool_val ^ (seed << 56));
+        default:
+            return fossil_cache_mix(seed << 56);
+    }
+}
+
+// *****************************************************************************
+// Lists and table
+// *****************************************************************************
+
+static void fossil_cache_unlink(fossil_cache_t* cache, uint32_t index) {
+    fossil_cache_entry_t* entry = &cache->entries[index];
+    fossil_cache_list_t* list = &cache->lists[entry->list];
+    if (entry->prev != FOSSIL_CACHE_NIL) {
+        cache->entries[entry->prev].next = entry->next;
+    } else {
+        list->head = entry->next;
+    }
+    if (entry->next != FOSSIL_CACHE_NIL) {
+        cache->entries[entry->next].prev = entry->prev;
+    } else {
+        list->tail = entry->prev;
+    }
+    list->count--;
+}
+
+static void fossil_cache_push_front(fossil_cache_t* cache, uint8_t which, uint32_t index) {
+    fossil_cache_entry_t* entry = &cache->entries[index];
+    fossil_cache_list_t* list = &cache->lists[which];
+    entry->list = which;
+    entry->prev = FOSSIL_CACHE_NIL;
+    entry->next = list->head;
+    if (list->head != FOSSIL_CACHE_NIL) {
+        cache->entries[list->head].prev = index;
+    } else {
+        list->tail = index;
+    }
+    list->head = index;
+    list->count++;
+}
+
+static void fossil_cache_push_back(fossil_cache_t* cache, uint8_t which, uint32_t index) {
+    fossil_cache_entry_t* entry = &cache->entries[index];
+    fossil_cache_list_t* list = &cache->lists[which];
+    entry->list = which;
+    entry->next = FOSSIL_CACHE_NIL;
+    entry->prev = list->tail;
+    if (list->tail != FOSSIL_CACHE_NIL) {
+        cache->entries[list->tail].next = index;
+    } else {
+        list->head = index;
+    }
+    list->tail = index;
+    list->count++;
+}
+
+// Find a resident entry by key, or a ghost entry by hash alone.
+static uint32_t fossil_cache_find(const fossil_cache_t* cache, fossil_tofu_t key, uint64_t hash, bool ghost) {
+    for (size_t slot = hash & cache->table_mask;; slot = (slot + 1) & cache->table_mask) {
+        uint32_t index = cache->table[slot];
+        if (index == FOSSIL_CACHE_NIL) {
+            return FOSSIL_CACHE_NIL;
+        }
+        const fossil_cache_entry_t* entry = &cache->entries[index];
+        if (entry->hash == hash && fossil_cache_resident(entry) != ghost &&
+            (ghost || fossil_tofu_equals(entry->key, key))) {
+            return index;
+        }
+    }
+}
+
+static void fossil_cache_table_insert(fossil_cache_t* cache, uint32_t index) {
+    size_t slot = cache->entries[index].hash & cache->table_mask;
+    while (cache->table[slot] != FOSSIL_CACHE_NIL) {
+        slot = (slot + 1) & cache->table_mask;
+    }
+    cache->table[slot] = index;
+}
+
+// Remove an entry from the table, shifting later probes back so lookups need no tombstones.
+static void fossil_cache_table_remove(fossil_cache_t* cache, uint32_t index) {
+    size_t hole = cache->entries[index].hash & cache->table_mask;
+    while (cache->table[hole] != index) {
+        hole = (hole + 1) & cache->table_mask;
+    }
+
+    for (size_t slot = (hole + 1) & cache->table_mask; cache->table[slot] != FOSSIL_CACHE_NIL; slot = (slot + 1) & cache->table_mask) {
+        size_t home = cache->entries[cache->table[slot]].hash & cache->table_mask;
+        // Move the entry if its home does not lie cyclically in (hole, slot].
+        if (((slot - home) & cache->table_mask) >= ((slot - hole) & cache->table_mask)) {
+            cache->table[hole] = cache->table[slot];
+            hole = slot;
+        }
+    }
+    cache->table[hole] = FOSSIL_CACHE_NIL;
+}
+
+static void fossil_cache_free_entry(fossil_cache_t* cache, uint32_t index) {
+    fossil_cache_table_remove(cache, index);
+    fossil_cache_unlink(cache, index);
+    cache->entries[index].list = FOSSIL_CACHE_FREE;
+    cache->entries[index].next = cache->free_head;
+    cache->free_head = index;
+}
+
+// *****************************************************************************
+// Replacement
+// *****************************************************************************
+
+// Hand a resident pair to the evict callback and stop charging its bytes.
+static void fossil_cache_release_pair(fossil_cache_t* cache, fossil_cache_entry_t* entry) {
+    cache->bytes -= entry->bytes;
+    entry->bytes = 0;
+    if (cache->evict_fn) {
+        cache->evict_fn(entry->key, entry->value, cache->evict_data);
+    }
+}
+
+// ARC REPLACE: demote the LRU entry of T1 or T2 to the matching ghost list, never the keep entry.
+static void fossil_cache_arc_replace(fossil_cache_t* cache, bool in_b2, uint32_t keep) {
+    size_t t1 = cache->lists[FOSSIL_CACHE_T1].count;
+    uint8_t from = FOSSIL_CACHE_T2;
+    if (t1 > 0 && (t1 > cache->target || (in_b2 && t1 == cache->target) || cache->lists[FOSSIL_CACHE_T2].count == 0)) {
+        from = FOSSIL_CACHE_T1;
+    }
+    if (keep != FOSSIL_CACHE_NIL && cache->lists[from].tail == keep) {
+        // The keep entry sits at the front, so it is the tail only when alone in its list
+        from = from == FOSSIL_CACHE_T1 ? FOSSIL_CACHE_T2 : FOSSIL_CACHE_T1;
+    }
+
+    uint32_t victim = cache->lists[from].tail;
+    fossil_cache_release_pair(cache, &cache->entries[victim]);
+    cache->stats.evictions++;
+    fossil_cache_unlink(cache, victim);
+    fossil_cache_push_front(cache, from == FOSSIL_CACHE_T1 ? FOSSIL_CACHE_B1 : FOSSIL_CACHE_B2, victim);
+}
+
+// Evict one resident entry according to the policy. The keep entry, if any, is passed over,
+// so there must be another resident entry.
+static void fossil_cache_evict_one(fossil_cache_t* cache, uint32_t keep) {
+    if (cache->policy == FOSSIL_CACHE_ARC) {
+        fossil_cache_arc_replace(cache, false, keep);
+        return;
+    }
+
+    fossil_cache_list_t* list = &cache->lists[FOSSIL_CACHE_T1];
+    if (cache->policy == FOSSIL_CACHE_CLOCK) {
+        // The head is the clock hand; referenced entries and the keep entry go round again at the back.
+        while (cache->entries[list->head].referenced || list->head == keep) {
+            uint32_t index = list->head;
+            cache->entries[index].referenced = false;
+            fossil_cache_unlink(cache, index);
+            fossil_cache_push_back(cache, FOSSIL_CACHE_T1, index);
+        }
+        uint32_t victim = list->head;
+        fossil_cache_release_pair(cache, &cache->entries[victim]);
+        cache->stats.evictions++;
+        fossil_cache_free_entry(cache, victim);
+        return;
+    }
+
+    uint32_t victim = list->tail == keep ? cache->entries[keep].prev : list->tail;
+    fossil_cache_release_pair(cache, &cache->entries[victim]);
+    cache->stats.evictions++;
+    fossil_cache_free_entry(cache, victim);
+}
+
+// Mark a resident entry as used.
+static void fossil_cache_touch(fossil_cache_t* cache, uint32_t index) {
+    switch (cache->policy) {
+        case FOSSIL_CACHE_LRU:
+            fossil_cache_unlink(cache, index);
+            fossil_cache_push_front(cache, FOSSIL_CACHE_T1, index);
+            break;
+        case FOSSIL_CACHE_CLOCK:
+            cache->entries[index].referenced = true;
+            break;
+        case FOSSIL_CACHE_ARC:
+            fossil_cache_unlink(cache, index);
+            fossil_cache_push_front(cache, FOSSIL_CACHE_T2, index);
+            break;
+    }
+}
+
+// Make room for a new key under ARC. Returns a ghost entry to reuse, or NIL for a fresh entry.
+static uint32_t fossil_cache_arc_admit(fossil_cache_t* cache, fossil_tofu_t key, uint64_t hash, uint8_t* list) {
+    size_t c = cache->capacity;
+    size_t t1 = cache->lists[FOSSIL_CACHE_T1].count;
+    size_t b1 = cache->lists[FOSSIL_CACHE_B1].count;
+    size_t b2 = cache->lists[FOSSIL_CACHE_B2].count;
+    bool full = fossil_cache_resident_count(cache) >= c;
+
+    uint32_t ghost = fossil_cache_find(cache, key, hash, true);
+    if (ghost != FOSSIL_CACHE_NIL) {
+        // A ghost hit means the list it was evicted from was too small.
+        bool in_b2 = cache->entries[ghost].list == FOSSIL_CACHE_B2;
+        if (in_b2) {
+            size_t delta = b1 > b2 ? b1 / b2 : 1;
+            cache->target = cache->target > delta ? cache->target - delta : 0;
+        } else {
+            size_t delta = b2 > b1 ? b2 / b1 : 1;
+            cache->target = cache->target + delta < c ? cache->target + delta : c;
+        }
+        if (full) {
+            fossil_cache_arc_replace(cache, in_b2, FOSSIL_CACHE_NIL);
+        }
+        fossil_cache_unlink(cache, ghost);
+        *list = FOSSIL_CACHE_T2;
+        return ghost;
+    }
+
+    *list = FOSSIL_CACHE_T1;
+    if (t1 + b1 >= c) {
+        if (t1 < c) {
+            fossil_cache_free_entry(cache, cache->lists[FOSSIL_CACHE_B1].tail);
+            if (full) {
+                fossil_cache_arc_replace(cache, false, FOSSIL_CACHE_NIL);
+            }
+        } else {
+            uint32_t victim = cache->lists[FOSSIL_CACHE_T1].tail;
+            fossil_cache_release_pair(cache, &cache->entries[victim]);
+            cache->stats.evictions++;
+            fossil_cache_free_entry(cache, victim);
+        }
+    } else {
+        if (fossil_cache_resident_count(cache) + b1 + b2 >= 2 * c) {
+            fossil_cache_free_entry(cache, cache->lists[FOSSIL_CACHE_B2].tail);
+        }
+        if (full) {
+            fossil_cache_arc_replace(cache, false, FOSSIL_CACHE_NIL);
+        }
+    }
+    return FOSSIL_CACHE_NIL;
+}
+
+// *****************************************************************************
+// Cache
+// *****************************************************************************
+
+static void fossil_cache_reset(fossil_cache_t* cache) {
+    size_t slab = cache->policy == FOSSIL_CACHE_ARC ? 2 * cache->capacity : cache->capacity;
+    for (size_t i = 0; i <= cache->table_mask; ++i) {
+        cache->table[i] = FOSSIL_CACHE_NIL;
+    }
+    for (size_t i = 0; i < slab; ++i) {
+        cache->entries[i].list = FOSSIL_CACHE_FREE;
+        cache->entries[i].next = i + 1 < slab ? (uint32_t)(i + 1) : FOSSIL_CACHE_NIL;
+    }
+    for (size_t i = 0; i < 4; ++i) {
+        cache->lists[i].head = FOSSIL_CACHE_NIL;
+        cache->lists[i].tail = FOSSIL_CACHE_NIL;
+        cache->lists[i].count = 0;
+    }
+    cache->free_head = 0;
+    cache->target = 0;
+    cache->bytes = 0;
+}
+
+fossil_cache_t* fossil_cache_create(char* type, fossil_cache_policy_t policy, size_t capacity) {
+    if (capacity == 0 || capacity > FOSSIL_CACHE_MAX_CAPACITY) {
+        return cnullptr;
+    }
+
+    fossil_cache_t* cache = (fossil_cache_t*)malloc(sizeof(fossil_cache_t));
+    if (!cache) {
+        return cnullptr;
+    }
+
+    // Keep the table at most half full, ghosts included.
+    size_t slab = policy == FOSSIL_CACHE_ARC ? 2 * capacity : capacity;
+    size_t table_size = 16;
+    while (table_size < 2 * slab) {
+        table_size <<= 1;
+    }
+
+    cache->entries = (fossil_cache_entry_t*)malloc(slab * sizeof(fossil_cache_entry_t));
+    cache->table = (uint32_t*)malloc(table_size * sizeof(uint32_t));
+    if (!cache->entries || !cache->table) {
+        free(cache->entries);
+        free(cache->table);
+        free(cache);
+        return cnullptr;
+    }
+
+    cache->table_mask = table_size - 1;
+    cache->policy = policy;
+    cache->capacity = capacity;
+    cache->max_bytes = 0;
+    cache->size_fn = cnullptr;
+    cache->size_data = cnullptr;
+    cache->evict_fn = cnullptr;
+    cache->evict_data = cnullptr;
+    memset(&cache->stats, 0, sizeof(cache->stats));
+    cache->type = type;
+    fossil_cache_reset(cache);
+    return cache;
+}
+
+void fossil_cache_erase(fossil_cache_t* cache) {
+    if (!cache) return;
+
+    fossil_cache_clear(cache);
+    free(cache->entries);
+    free(cache->table);
+    free(cache);
+}
+
+int32_t fossil_cache_set_budget(fossil_cache_t* cache, size_t max_bytes, fossil_cache_size_fn size_fn, void* user_data) {
+    if (max_bytes != 0 && !size_fn) {
+        return -1;
+    }
+
+    cache->max_bytes = max_bytes;
+    cache->size_fn = size_fn;
+    cache->size_data = user_data;
+    while (cache->max_bytes && cache->bytes > cache->max_bytes) {
+        fossil_cache_evict_one(cache, FOSSIL_CACHE_NIL);
+    }
+    return 0;
+}
+
+void fossil_cache_set_evict_callback(fossil_cache_t* cache, fossil_cache_evict_fn evict_fn, void* user_data) {
+    cache->evict_fn = evict_fn;
+    cache->evict_data = user_data;
+}
+
+static int32_t fossil_cache_put_hashed(fossil_cache_t* cache, fossil_tofu_t key, fossil_tofu_t value, uint64_t hash) {
+    size_t bytes = cache->size_fn ? cache->size_fn(key, value, cache->size_data) : 0;
+    if (cache->max_bytes && bytes > cache->max_bytes) {
+        return -1; // Can never fit
+    }
+
+    uint32_t index = fossil_cache_find(cache, key, hash, false);
+    if (index != FOSSIL_CACHE_NIL) {
+        fossil_cache_entry_t* entry = &cache->entries[index];
+        fossil_cache_release_pair(cache, entry);
+        entry->key = key;
+        entry->value = value;
+        entry->bytes = bytes;
+        cache->bytes += bytes;
+        fossil_cache_touch(cache, index);
+    } else {
+        uint8_t list = FOSSIL_CACHE_T1;
+        if (cache->policy == FOSSIL_CACHE_ARC) {
+            index = fossil_cache_arc_admit(cache, key, hash, &list);
+        } else if (fossil_cache_resident_count(cache) >= cache->capacity) {
+            fossil_cache_evict_one(cache, FOSSIL_CACHE_NIL);
+        }
+
+        if (index == FOSSIL_CACHE_NIL) {
+            index = cache->free_head;
+            cache->free_head = cache->entries[index].next;
+            cache->entries[index].hash = hash;
+            fossil_cache_table_insert(cache, index);
+        }
+
+        fossil_cache_entry_t* entry = &cache->entries[index];
+        entry->key = key;
+        entry->value = value;
+        entry->bytes = bytes;
+        entry->referenced = false;
+        cache->bytes += bytes;
+        cache->stats.insertions++;
+        if (cache->policy == FOSSIL_CACHE_CLOCK) {
+            fossil_cache_push_back(cache, list, index);
+        } else {
+            fossil_cache_push_front(cache, list, index);
+        }
+    }
+
+    // Shed other pairs until the new one fits; it alone is within the budget, so this ends
+    while (cache->max_bytes && cache->bytes > cache->max_bytes) {
+        fossil_cache_evict_one(cache, index);
+    }
+    return 0;
+}
+
+int32_t fossil_cache_put(fossil_cache_t* cache, fossil_tofu_t key, fossil_tofu_t value) {
+    return fossil_cache_put_hashed(cache, key, value, fossil_cache_hash(key));
+}
+
+static fossil_tofu_t* fossil_cache_get_hashed(fossil_cache_t* cache, fossil_tofu_t key, uint64_t hash) {
+    uint32_t index = fossil_cache_find(cache, key, hash, false);
+    if (index == FOSSIL_CACHE_NIL) {
+        cache->stats.misses++;
+        return cnullptr;
+    }
+
+    cache->stats.hits++;
+    fossil_cache_touch(cache, index);
+    return &cache->entries[index].value;
+}
+
+fossil_tofu_t* fossil_cache_getter(fossil_cache_t* cache, fossil_tofu_t key) {
+    return fossil_cache_get_hashed(cache, key, fossil_cache_hash(key));
+}
+
+bool fossil_cache_contains(const fossil_cache_t* cache, fossil_tofu_t key) {
+    return fossil_cache_find(cache, key, fossil_cache_hash(key), false) != FOSSIL_CACHE_NIL;
+}
+
+static int32_t fossil_cache_remove_hashed(fossil_cache_t* cache, fossil_tofu_t key, fossil_tofu_t* value, uint64_t hash) {
+    uint32_t index = fossil_cache_find(cache, key, hash, false);
+    if (index == FOSSIL_CACHE_NIL) {
+        return -1; // Not found
+    }
+
+    if (value) {
+        *value = cache->entries[index].value;
+    }
+    cache->bytes -= cache->entries[index].bytes;
+    fossil_cache_free_entry(cache, index);
+    return 0;
+}
+
+int32_t fossil_cache_remove(fossil_cache_t* cache, fossil_tofu_t key, fossil_tofu_t* value) {
+    return fossil_cache_remove_hashed(cache, key, value, fossil_cache_hash(key));
+}
+
+void fossil_cache_clear(fossil_cache_t* cache) {
+    if (cache->evict_fn) {
+        for (uint8_t which = FOSSIL_CACHE_T1; which <= FOSSIL_CACHE_T2; ++which) {
+            for (uint32_t index = cache->lists[which].head; index != FOSSIL_CACHE_NIL; index = cache->entries[index].next) {
+                cache->evict_fn(cache->entries[index].key, cache->entries[index].value, cache->evict_data);
+            }
+        }
+    }
+    fossil_cache_reset(cache);
+}
+
+size_t fossil_cache_size(const fossil_cache_t* cache) {
+    return fossil_cache_resident_count(cache);
+}
+
+size_t fossil_cache_bytes(const fossil_cache_t* cache) {
+    return cache->bytes;
+}
+
+fossil_cache_stats_t fossil_cache_stats(const fossil_cache_t* cache) {
+    return cache->stats;
+}
+
+void fossil_cache_reset_stats(fossil_cache_t* cache) {
+    memset(&cache->stats, 0, sizeof(cache->stats));
+}
+
+bool fossil_cache_not_empty(const fossil_cache_t* cache) {
+    return fossil_cache_resident_count(cache) != 0;
+}
+
+bool fossil_cache_not_cnullptr(const fossil_cache_t* cache) {
+    return cache != cnullptr;
+}
+
+bool fossil_cache_is_empty(const fossil_cache_t* cache) {
+    return fossil_cache_resident_count(cache) == 0;
+}
+
+bool fossil_cache_is_cnullptr(const fossil_cache_t* cache) {
+    return cache == cnullptr;
+}
+
+// *****************************************************************************
+// Sharded cache
+// *****************************************************************************
+
+// Shards use the high hash bits, the shard tables use the low ones.
+static inline fossil_cache_shard_t* fossil_cache_shard_for(fossil_cache_sharded_t* cache, uint64_t hash) {
+    return &cache->shards[(hash >> 40) & (cache->shard_count - 1)];
+}
+
+fossil_cache_sharded_t* fossil_cache_sharded_create(char* type, fossil_cache_policy_t policy, size_t capacity, size_t shard_count) {
+    if (shard_count == 0 || capacity < shard_count) {
+        return cnullptr;
+    }
+
+    size_t count = 1;
+    while (count < shard_count) {
+        count <<= 1;
+    }
+
+    fossil_cache_sharded_t* cache = (fossil_cache_sharded_t*)malloc(sizeof(fossil_cache_sharded_t));
+    if (!cache) {
+        return cnullptr;
+    }
+    cache->shards = (fossil_cache_shard_t*)calloc(count, sizeof(fossil_cache_shard_t));
+    if (!cache->shards) {
+        free(cache);
+        return cnullptr;
+    }
+    cache->shard_count = count;
+    cache->type = type;
+
+    size_t per_shard = (capacity + count - 1) / count;
+    for (size_t i = 0; i < count; ++i) {
+        cache->shards[i].cache = fossil_cache_create(type, policy, per_shard);
+        if (!cache->shards[i].cache || fossil_mutex_create(&cache->shards[i].lock) != 0) {
+            fossil_cache_erase(cache->shards[i].cache);
+            cache->shard_count = i;
+            fossil_cache_sharded_erase(cache);
+            return cnullptr;
+        }
+    }
+    return cache;
+}
+
+void fossil_cache_sharded_erase(fossil_cache_sharded_t* cache) {
+    if (!cache) return;
+
+    for (size_t i = 0; i < cache->shard_count; ++i) {
+        fossil_cache_erase(cache->shards[i].cache);
+        fossil_mutex_erase(&cache->shards[i].lock);
+    }
+    free(cache->shards);
+    free(cache);
+}
+
+int32_t fossil_cache_sharded_set_budget(fossil_cache_sharded_t* cache, size_t max_bytes, fossil_cache_size_fn size_fn, void* user_data) {
+    if (max_bytes != 0 && !size_fn) {
+        return -1;
+    }
+
+    size_t per_shard = max_bytes ? (max_bytes + cache->shard_count - 1) / cache->shard_count : 0;
+    for (size_t i = 0; i < cache->shard_count; ++i) {
+        fossil_mutex_lock(&cache->shards[i].lock);
+        fossil_cache_set_budget(cache->shards[i].cache, per_shard, size_fn, user_data);
+        fossil_mutex_unlock(&cache->shards[i].lock);
+    }
+    return 0;
+}
+
+void fossil_cache_sharded_set_evict_callback(fossil_cache_sharded_t* cache, fossil_cache_evict_fn evict_fn, void* user_data) {
+    for (size_t i = 0; i < cache->shard_count; ++i) {
+        fossil_mutex_lock(&cache->shards[i].lock);
+        fossil_cache_set_evict_callback(cache->shards[i].cache, evict_fn, user_data);
+        fossil_mutex_unlock(&cache->shards[i].lock);
+    }
+}
+
+int32_t fossil_cache_sharded_put(fossil_cache_sharded_t* cache, fossil_tofu_t key, fossil_tofu_t value) {
+    uint64_t hash = fossil_cache_hash(key);
+    fossil_cache_shard_t* shard = fossil_cache_shard_for(cache, hash);
+    fossil_mutex_lock(&shard->lock);
+    int32_t result = fossil_cache_put_hashed(shard->cache, key, value, hash);
+    fossil_mutex_unlock(&shard->lock);
+    return result;
+}
+
+int32_t fossil_cache_sharded_get(fossil_cache_sharded_t* cache, fossil_tofu_t key, fossil_tofu_t* value) {
+    uint64_t hash = fossil_cache_hash(key);
+    fossil_cache_shard_t* shard = fossil_cache_shard_for(cache, hash);
+    fossil_mutex_lock(&shard->lock);
+    fossil_tofu_t* found = fossil_cache_get_hashed(shard->cache, key, hash);
+    if (found) {
+        *value = *found;
+    }
+    fossil_mutex_unlock(&shard->lock);
+    return found ? 0 : -1;
+}
+
+int32_t fossil_cache_sharded_remove(fossil_cache_sharded_t* cache, fossil_tofu_t key, fossil_tofu_t* value) {
+    uint64_t hash = fossil_cache_hash(key);
+    fossil_cache_shard_t* shard = fossil_cache_shard_for(cache, hash);
+    fossil_mutex_lock(&shard->lock);
+    int32_t result = fossil_cache_remove_hashed(shard->cache, key, value, hash);
+    fossil_mutex_unlock(&shard->lock);
+    return result;
+}
+
+size_t fossil_cache_sharded_size(fossil_cache_sharded_t* cache) {
+    size_t size = 0;
+    for (size_t i = 0; i < cache->shard_count; ++i) {
+        fossil_mutex_lock(&cache->shards[i].lock);
+        size += fossil_cache_size(cache->shards[i].cache);
+        fossil_mutex_unlock(&cache->shards[i].lock);
+    }
+    return size;
+}
+
+fossil_cache_stats_t fossil_cache_sharded_stats(fossil_cache_sharded_t* cache) {
+    fossil_cache_stats_t total = { 0, 0, 0, 0 };
+    for (size_t i = 0; i < cache->shard_count; ++i) {
+        fossil_mutex_lock(&cache->shards[i].lock);
+        fossil_cache_stats_t stats = fossil_cache_stats(cache->shards[i].cache);
+        fossil_mutex_unlock(&cache->shards[i].lock);
+        total.hits += stats.hits;
+        total.misses += stats.misses;
+        total.insertions += stats.insertions;
+        total.evictions += stats.evictions;
+    }
+    return total;
+}
@@ -12,16 +12,169 @@ Description:
 */
 #include "fossil/structure/dlist.h"
 
+// Compare integer tofus inline so block scans stay in a tight loop.
+static bool fossil_dlist_matches(const fossil_tofu_t* element, const fossil_tofu_t* data) {
+    if (element->type != data->type) {
+        return false;
+    }
+    switch (data->type) {
+        case FOSSIL_TOFU_TYPE_INT:
+        case FOSSIL_TOFU_TYPE_UINT:
+        case FOSSIL_TOFU_TYPE_HEX:
+        case FOSSIL_TOFU_TYPE_OCTAL:
+            return element->value.uint_val == data->value.uint_val;
+        default:
+            return fossil_tofu_equals(*element, *data);
+    }
+}
+
+// Allocate an empty block for the unrolled list.
+static fossil_dlist_block_t* fossil_dlist_block_create(void) {
+    fossil_dlist_block_t* block = (fossil_dlist_block_t*)malloc(sizeof(fossil_dlist_block_t));
+    if (block) {
+        block->count = 0;
+        block->prev = cnullptr;
+        block->next = cnullptr;
+    }
+    return block;
+}
+
+// Link a new block after the given one, or at the head when after is null.
+static void fossil_dlist_block_link(fossil_dlist_t* dlist, fossil_dlist_block_t* after, fossil_dlist_block_t* block) {
+    block->prev = after;
+    block->next = after ? after->next : dlist->head_block;
+    if (block->next) {
+        block->next->prev = block;
+    } else {
+        dlist->tail_block = block;
+    }
+    if (after) {
+        after->next = block;
+    } else {
+        dlist->head_block = block;
+    }
+}
+
+static void fossil_dlist_block_unlink(fossil_dlist_t* dlist, fossil_dlist_block_t* block) {
+    if (block->prev) {
+        block->prev->next = block->next;
+    } else {
+        dlist->head_block = block->next;
+    }
+    if (block->next) {
+        block->next->prev = block->prev;
+    } else {
+        dlist->tail_block = block->prev;
+    }
+    free(block);
+}
+
+// Refill an underfull block from its successor, merging the two when they fit in one block.
+static void fossil_dlist_block_rebalance(fossil_dlist_t* dlist, fossil_dlist_block_t* block) {
+    fossil_dlist_block_t* next = block->next;
+    if (!next || block->count >= FOSSIL_DLIST_BLOCK_SIZE / 2) {
+        return;
+    }
+
+    if (block->count + next->count <= FOSSIL_DLIST_BLOCK_SIZE) {
+        memcpy(&block->data[block->count], next->data, next->count * sizeof(fossil_tofu_t));
+        block->count += next->count;
+        fossil_dlist_block_unlink(dlist, next);
+        return;
+    }
+
+    size_t moved = (block->count + next->count) / 2 - block->count;
+    memcpy(&block->data[block->count], next->data, moved * sizeof(fossil_tofu_t));
+    memmove(next->data, &next->data[moved], (next->count - moved) * sizeof(fossil_tofu_t));
+    block->count += moved;
+    next->count -= moved;
+}
+
+// Insert data at offset within a block, splitting the block when it is full.
+// Returns the block that received the data and stores its offset there, or null on failure.
+static fossil_dlist_block_t* fossil_dlist_block_insert(fossil_dlist_t* dlist, fossil_dlist_block_t* block, size_t* offset, fossil_tofu_t data) {
+    size_t index = *offset;
+    if (block->count == FOSSIL_DLIST_BLOCK_SIZE) {
+        // Split the full block in half and insert into the half that owns the position.
+        fossil_dlist_block_t* upper = fossil_dlist_block_create();
+        if (!upper) {
+            return cnullptr;  // Allocation failed
+        }
+        size_t half = FOSSIL_DLIST_BLOCK_SIZE / 2;
+        memcpy(upper->data, &block->data[half], (FOSSIL_DLIST_BLOCK_SIZE - half) * sizeof(fossil_tofu_t));
+        upper->count = FOSSIL_DLIST_BLOCK_SIZE - half;
+        block->count = half;
+        fossil_dlist_block_link(dlist, block, upper);
+        if (index > half) {
+            block = upper;
+            index -= half;
+        }
+    }
+
+    memmove(&block->data[index + 1], &block->data[index], (block->count - index) * sizeof(fossil_tofu_t));
+    block->data[index] = data;
+    block->count++;
+    dlist->size++;
+    *offset = index;
+    return block;
+}
+
+// Remove the data at offset within a block, freeing or rebalancing the block.
+static void fossil_dlist_block_remove(fossil_dlist_t* dlist, fossil_dlist_block_t* block, size_t offset, fossil_tofu_t* data) {
+    *data = block->data[offset];
+    memmove(&block->data[offset], &block->data[offset + 1], (block->count - offset - 1) * sizeof(fossil_tofu_t));
+    block->count--;
+    dlist->size--;
+
+    if (block->count == 0) {
+        fossil_dlist_block_unlink(dlist, block);
+    } else {
+        fossil_dlist_block_rebalance(dlist, block);
+    }
+}
+
+// Swap the direction of the block chain and the element order inside each block.
+static void fossil_dlist_reverse_blocks(fossil_dlist_t* dlist) {
+    fossil_dlist_block_t* block = dlist->head_block;
+    while (block) {
+        fossil_dlist_block_t* next = block->next;
+        for (size_t i = 0; i < block->count / 2; ++i) {
+            fossil_tofu_t temp = block->data[i];
+            block->data[i] = block->data[block->count - i - 1];
+            block->data[block->count - i - 1] = temp;
+        }
+        block->next = block->prev;
+        block->prev = next;
+        block = next;
+    }
+
+    block = dlist->head_block;
+    dlist->head_block = dlist->tail_block;
+    dlist->tail_block = block;
+}
+
 fossil_dlist_t* fossil_dlist_create(char* type) {
     fossil_dlist_t* dlist = (fossil_dlist_t*)malloc(sizeof(fossil_dlist_t));
     if (dlist) {
         dlist->head = cnullptr;
         dlist->tail = cnullptr;
+        dlist->head_block = cnullptr;
+        dlist->tail_block = cnullptr;
+        dlist->size = 0;
+        dlist->unrolled = false;
         dlist->type = type;  // Assuming type is a static string or managed separately
     }
     return dlist;
 }
 
+fossil_dlist_t* fossil_dlist_create_unrolled(char* type) {
+    fossil_dlist_t* dlist = fossil_dlist_create(type);
+    if (dlist) {
+        dlist->unrolled = true;
+    }
+    return dlist;
+}
+
 void fossil_dlist_erase(fossil_dlist_t* dlist) {
     if (!dlist) return;
 
@@ -33,10 +186,34 @@ void fossil_dlist_erase(fossil_dlist_t* dlist) {
     }
     dlist->head = cnullptr;
     dlist->tail = cnullptr;
+
+    fossil_dlist_block_t* block = dlist->head_block;
+    while (block) {
+        fossil_dlist_block_t* next = block->next;
+        free(block);
+        block = next;
+    }
+    dlist->head_block = cnullptr;
+    dlist->tail_block = cnullptr;
     free(dlist);
 }
 
 int32_t fossil_dlist_insert(fossil_dlist_t* dlist, fossil_tofu_t data) {
+    if (dlist->unrolled) {
+        fossil_dlist_block_t* tail = dlist->tail_block;
+        if (!tail || tail->count == FOSSIL_DLIST_BLOCK_SIZE) {
+            tail = fossil_dlist_block_create();
+            if (!tail) {
+                return -1;  // Allocation failed
+            }
+            fossil_dlist_block_link(dlist, dlist->tail_block, tail);
+        }
+
+        tail->data[tail->count++] = data;
+        dlist->size++;
+        return 0;  // Success
+    }
+
     fossil_dlist_node_t* new_node = (fossil_dlist_node_t*)malloc(sizeof(fossil_dlist_node_t));
     if (!new_node) {
         return -1;  // Allocation failed
@@ -65,6 +242,16 @@ int32_t fossil_dlist_remove(fossil_dlist_t* dlist, fossil_tofu_t* data) {
         return -1;  // Empty list
     }
 
+    if (dlist->unrolled) {
+        fossil_dlist_block_t* tail = dlist->tail_block;
+        *data = tail->data[--tail->count];
+        dlist->size--;
+        if (tail->count == 0) {
+            fossil_dlist_block_unlink(dlist, tail);
+        }
+        return 0;  // Success
+    }
+
     fossil_dlist_node_t* node_to_remove = dlist->tail;
 
     if (node_to_remove == dlist->head) {
@@ -82,7 +269,100 @@ int32_t fossil_dlist_remove(fossil_dlist_t* dlist, fossil_tofu_t* data) {
     return 0;  // Success
 }
 
+int32_t fossil_dlist_insert_at(fossil_dlist_t* dlist, size_t index, fossil_tofu_t data) {
+    if (!dlist->unrolled) {
+        fossil_dlist_node_t* next = dlist->head;
+        for (size_t i = 0; next && i < index; ++i) {
+            next = next->next;
+        }
+        if (!next) {
+            // Past the last node only the end itself is a valid position
+            return index == fossil_dlist_size(dlist) ? fossil_dlist_insert(dlist, data) : -1;
+        }
+
+        fossil_dlist_node_t* new_node = (fossil_dlist_node_t*)malloc(sizeof(fossil_dlist_node_t));
+        if (!new_node) {
+            return -1;  // Allocation failed
+        }
+        new_node->data = data;
+        new_node->next = next;
+        new_node->prev = next->prev;
+        if (next->prev) {
+            next->prev->next = new_node;
+        } else {
+            dlist->head = new_node;
+        }
+        next->prev = new_node;
+        return 0;  // Success
+    }
+
+    if (index > dlist->size) {
+        return -1;  // Out of range
+    }
+    if (index == dlist->size) {
+        return fossil_dlist_insert(dlist, data);
+    }
+
+    fossil_dlist_block_t* block = dlist->head_block;
+    while (index >= block->count) {
+        index -= block->count;
+        block = block->next;
+    }
+
+    return fossil_dlist_block_insert(dlist, block, &index, data) ? 0 : -1;
+}
+
+int32_t fossil_dlist_remove_at(fossil_dlist_t* dlist, size_t index, fossil_tofu_t* data) {
+    if (!dlist->unrolled) {
+        fossil_dlist_node_t* node_to_remove = dlist->head;
+        for (size_t i = 0; node_to_remove && i < index; ++i) {
+            node_to_remove = node_to_remove->next;
+        }
+        if (!node_to_remove) {
+            return -1;  // Out of range
+        }
+
+        if (node_to_remove->prev) {
+            node_to_remove->prev->next = node_to_remove->next;
+        } else {
+            dlist->head = node_to_remove->next;
+        }
+        if (node_to_remove->next) {
+            node_to_remove->next->prev = node_to_remove->prev;
+        } else {
+            dlist->tail = node_to_remove->prev;
+        }
+        *data = node_to_remove->data;
+        free(node_to_remove);
+        return 0;  // Success
+    }
+
+    if (index >= dlist->size) {
+        return -1;  // Out of range
+    }
+
+    fossil_dlist_block_t* block = dlist->head_block;
+    while (index >= block->count) {
+        index -= block->count;
+        block = block->next;
+    }
+
+    fossil_dlist_block_remove(dlist, block, index, data);
+    return 0;  // Success
+}
+
 int32_t fossil_dlist_search(const fossil_dlist_t* dlist, fossil_tofu_t data) {
+    if (dlist->unrolled) {
+        for (const fossil_dlist_block_t* block = dlist->head_block; block; block = block->next) {
+            for (size_t i = 0; i < block->count; ++i) {
+                if (fossil_dlist_matches(&block->data[i], &data)) {
+                    return 0;  // Found
+                }
+            }
+        }
+        return -1;  // Not found
+    }
+
     fossil_dlist_node_t* current = dlist->head;
     while (current) {
         if (fossil_tofu_equals(current->data, data)) {
@@ -94,6 +374,11 @@ int32_t fossil_dlist_search(const fossil_dlist_t* dlist, fossil_tofu_t data) {
 }
 
 void fossil_dlist_reverse_forward(fossil_dlist_t* dlist) {
+    if (dlist->unrolled) {
+        fossil_dlist_reverse_blocks(dlist);
+        return;
+    }
+
     fossil_dlist_node_t* current = dlist->head;
     fossil_dlist_node_t* temp = cnullptr;
 
@@ -111,6 +396,11 @@ void fossil_dlist_reverse_forward(fossil_dlist_t* dlist) {
 }
 
 void fossil_dlist_reverse_backward(fossil_dlist_t* dlist) {
+    if (dlist->unrolled) {
+        fossil_dlist_reverse_blocks(dlist);
+        return;
+    }
+
     fossil_dlist_node_t* current = dlist->tail;
     fossil_dlist_node_t* temp = cnullptr;
 
@@ -128,6 +418,10 @@ void fossil_dlist_reverse_backward(fossil_dlist_t* dlist) {
 }
 
 size_t fossil_dlist_size(const fossil_dlist_t* dlist) {
+    if (dlist->unrolled) {
+        return dlist->size;
+    }
+
     size_t count = 0;
     fossil_dlist_node_t* current = dlist->head;
     while (current) {
@@ -138,6 +432,17 @@ size_t fossil_dlist_size(const fossil_dlist_t* dlist) {
 }
 
 fossil_tofu_t* fossil_dlist_getter(fossil_dlist_t* dlist, fossil_tofu_t data) {
+    if (dlist->unrolled) {
+        for (fossil_dlist_block_t* block = dlist->head_block; block; block = block->next) {
+            for (size_t i = 0; i < block->count; ++i) {
+                if (fossil_dlist_matches(&block->data[i], &data)) {
+                    return &(block->data[i]);  // Return pointer to found data
+                }
+            }
+        }
+        return cnullptr;  // Not found
+    }
+
     fossil_dlist_node_t* current = dlist->head;
     while (current) {
         if (fossil_tofu_equals(current->data, data)) {
@@ -149,6 +454,15 @@ fossil_tofu_t* fossil_dlist_getter(fossil_dlist_t* dlist, fossil_tofu_t data) {
 }
 
 int32_t fossil_dlist_setter(fossil_dlist_t* dlist, fossil_tofu_t data) {
+    if (dlist->unrolled) {
+        fossil_tofu_t* found = fossil_dlist_getter(dlist, data);
+        if (!found) {
+            return -1;  // Not found
+        }
+        *found = data;  // Update data
+        return 0;  // Success
+    }
+
     fossil_dlist_node_t* current = dlist->head;
     while (current) {
         if (fossil_tofu_equals(current->data, data)) {
@@ -161,6 +475,9 @@ int32_t fossil_dlist_setter(fossil_dlist_t* dlist, fossil_tofu_t data) {
 }
 
 bool fossil_dlist_not_empty(const fossil_dlist_t* dlist) {
+    if (dlist != cnullptr && dlist->unrolled) {
+        return dlist->size != 0;
+    }
     return (dlist != cnullptr && dlist->head != cnullptr);
 }
 
@@ -169,9 +486,144 @@ bool fossil_dlist_not_cnullptr(const fossil_dlist_t* dlist) {
 }
 
 bool fossil_dlist_is_empty(const fossil_dlist_t* dlist) {
+    if (dlist != cnullptr && dlist->unrolled) {
+        return dlist->size == 0;
+    }
     return (dlist == cnullptr || dlist->head == cnullptr);
 }
 
 bool fossil_dlist_is_cnullptr(const fossil_dlist_t* dlist) {
     return (dlist == cnullptr);
 }
+
+fossil_dlist_cursor_t fossil_dlist_cursor_begin(fossil_dlist_t* dlist) {
+    fossil_dlist_cursor_t cursor = { dlist, dlist->head, dlist->head_block, 0 };
+    return cursor;
+}
+
+fossil_dlist_cursor_t fossil_dlist_cursor_end(fossil_dlist_t* dlist) {
+    fossil_dlist_cursor_t cursor = { dlist, cnullptr, cnullptr, 0 };
+    return cursor;
+}
+
+bool fossil_dlist_cursor_valid(const fossil_dlist_cursor_t* cursor) {
+    return cursor->dlist->unrolled ? cursor->block != cnullptr : cursor->node != cnullptr;
+}
+
+void fossil_dlist_cursor_next(fossil_dlist_cursor_t* cursor) {
+    if (!cursor->dlist->unrolled) {
+        if (cursor->node) {
+            cursor->node = cursor->node->next;
+        }
+        return;
+    }
+
+    if (cursor->block && ++cursor->offset >= cursor->block->count) {
+        cursor->block = cursor->block->next;
+        cursor->offset = 0;
+    }
+}
+
+void fossil_dlist_cursor_prev(fossil_dlist_cursor_t* cursor) {
+    fossil_dlist_t* dlist = cursor->dlist;
+    if (!dlist->unrolled) {
+        // From the end this moves to the tail, and from the head it wraps to the end.
+        cursor->node = cursor->node ? cursor->node->prev : dlist->tail;
+        return;
+    }
+
+    if (cursor->block && cursor->offset > 0) {
+        cursor->offset--;
+        return;
+    }
+    cursor->block = cursor->block ? cursor->block->prev : dlist->tail_block;
+    cursor->offset = cursor->block ? cursor->block->count - 1 : 0;
+}
+
+fossil_tofu_t* fossil_dlist_cursor_deref(const fossil_dlist_cursor_t* cursor) {
+    if (cursor->dlist->unrolled) {
+        return cursor->block ? &cursor->block->data[cursor->offset] : cnullptr;
+    }
+    return cursor->node ? &cursor->node->data : cnullptr;
+}
+
+int32_t fossil_dlist_cursor_insert_after(fossil_dlist_cursor_t* cursor, fossil_tofu_t data) {
+    if (!fossil_dlist_cursor_valid(cursor)) {
+        return -1;  // Cursor is at the end
+    }
+
+    fossil_dlist_t* dlist = cursor->dlist;
+    if (!dlist->unrolled) {
+        fossil_dlist_node_t* new_node = (fossil_dlist_node_t*)malloc(sizeof(fossil_dlist_node_t));
+        if (!new_node) {
+            return -1;  // Allocation failed
+        }
+        new_node->data = data;
+        new_node->prev = cursor->node;
+        new_node->next = cursor->node->next;
+        if (new_node->next) {
+            new_node->next->prev = new_node;
+        } else {
+            dlist->tail = new_node;
+        }
+        cursor->node->next = new_node;
+        return 0;  // Success
+    }
+
+    // The cursor's element sits just before the new one, which may now be in the split-off half.
+    size_t offset = cursor->offset + 1;
+    fossil_dlist_block_t* block = fossil_dlist_block_insert(dlist, cursor->block, &offset, data);
+    if (!block) {
+        return -1;  // Allocation failed
+    }
+    cursor->block = block;
+    cursor->offset = offset - 1;
+    return 0;  // Success
+}
+
+int32_t fossil_dlist_cursor_erase(fossil_dlist_cursor_t* cursor, fossil_tofu_t* data) {
+    if (!fossil_dlist_cursor_valid(cursor)) {
+        return -1;  // Cursor is at the end
+    }
+
+    fossil_dlist_t* dlist = cursor->dlist;
+    if (!dlist->unrolled) {
+        fossil_dlist_node_t* node_to_remove = cursor->node;
+        if (node_to_remove->prev) {
+            node_to_remove->prev->next = node_to_remove->next;
+        } else {
+            dlist->head = node_to_remove->next;
+        }
+        if (node_to_remove->next) {
+            node_to_remove->next->prev = node_to_remove->prev;
+        } else {
+            dlist->tail = node_to_remove->prev;
+        }
+        cursor->node = node_to_remove->next;
+        *data = node_to_remove->data;
+        free(node_to_remove);
+        return 0;  // Success
+    }
+
+    fossil_dlist_block_t* next_block = cursor->block->next;
+    bool last_in_block = cursor->block->count == 1;
+    fossil_dlist_block_remove(dlist, cursor->block, cursor->offset, data);
+    if (last_in_block) {
+        cursor->block = next_block;
+        cursor->offset = 0;
+    } else if (cursor->offset >= cursor->block->count) {
+        cursor->block = cursor->block->next;
+        cursor->offset = 0;
+    }
+    return 0;  // Success
+}
+
+fossil_tofu_iteratorof_t fossil_dlist_cursor_span(const fossil_dlist_cursor_t* cursor) {
+    if (!fossil_dlist_cursor_valid(cursor)) {
+        return fossil_tofu_iteratorof_create(cnullptr, 0);
+    }
+    if (cursor->dlist->unrolled) {
+        return fossil_tofu_iteratorof_create(&cursor->block->data[cursor->offset], cursor->block->count - cursor->offset);
+    }
+    return fossil_tofu_iteratorof_create(&cursor->node->data, 1);
+}
@@ -145,3 +145,83 @@ bool fossil_dqueue_is_empty(const fossil_dqueue_t* dqueue) {
 bool fossil_dqueue_is_cnullptr(const fossil_dqueue_t* dqueue) {
     return dqueue == cnullptr;
 }
+
+fossil_dqueue_cursor_t fossil_dqueue_cursor_begin(fossil_dqueue_t* dqueue) {
+    fossil_dqueue_cursor_t cursor = { dqueue, dqueue->front };
+    return cursor;
+}
+
+fossil_dqueue_cursor_t fossil_dqueue_cursor_end(fossil_dqueue_t* dqueue) {
+    fossil_dqueue_cursor_t cursor = { dqueue, cnullptr };
+    return cursor;
+}
+
+bool fossil_dqueue_cursor_valid(const fossil_dqueue_cursor_t* cursor) {
+    return cursor->node != cnullptr;
+}
+
+void fossil_dqueue_cursor_next(fossil_dqueue_cursor_t* cursor) {
+    if (cursor->node) {
+        cursor->node = cursor->node->next;
+    }
+}
+
+void fossil_dqueue_cursor_prev(fossil_dqueue_cursor_t* cursor) {
+    // From the end this moves to the rear, and from the front it wraps to the end.
+    cursor->node = cursor->node ? cursor->node->prev : cursor->dqueue->rear;
+}
+
+fossil_tofu_t* fossil_dqueue_cursor_deref(const fossil_dqueue_cursor_t* cursor) {
+    return cursor->node ? &cursor->node->data : cnullptr;
+}
+
+int32_t fossil_dqueue_cursor_insert_after(fossil_dqueue_cursor_t* cursor, fossil_tofu_t data) {
+    if (!cursor->node) {
+        return -1;  // Cursor is at the end
+    }
+
+    fossil_dqueue_node_t* new_node = (fossil_dqueue_node_t*)malloc(sizeof(fossil_dqueue_node_t));
+    if (!new_node) {
+        return -1;  // Allocation failed
+    }
+
+    new_node->data = data;
+    new_node->prev = cursor->node;
+    new_node->next = cursor->node->next;
+    if (new_node->next) {
+        new_node->next->prev = new_node;
+    } else {
+        cursor->dqueue->rear = new_node;
+    }
+    cursor->node->next = new_node;
+    return 0;  // Success
+}
+
+int32_t fossil_dqueue_cursor_erase(fossil_dqueue_cursor_t* cursor, fossil_tofu_t* data) {
+    if (!cursor->node) {
+        return -1;  // Cursor is at the end
+    }
+
+    fossil_dqueue_node_t* node_to_remove = cursor->node;
+    if (node_to_remove->prev) {
+        node_to_remove->prev->next = node_to_remove->next;
+    } else {
+        cursor->dqueue->front = node_to_remove->next;
+    }
+    if (node_to_remove->next) {
+        node_to_remove->next->prev = node_to_remove->prev;
+    } else {
+        cursor->dqueue->rear = node_to_remove->prev;
+    }
+    cursor->node = node_to_remove->next;
+    *data = node_to_remove->data;
+    free(node_to_remove);
+    return 0;  // Success
+}
+
+fossil_tofu_iteratorof_t fossil_dqueue_cursor_span(const fossil_dqueue_cursor_t* cursor) {
+    if (!cursor->node) {
+        return fossil_tofu_iteratorof_create(cnullptr, 0);
+    }
+    return fossil_tofu_iteratorof_create(&cursor->node->data, 1);
+}
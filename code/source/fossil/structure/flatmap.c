@@ -0,0 +1,135 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#include "fossil/structure/flatmap.h"
+
+fossil_flatmap_t* fossil_flatmap_create(char* type) {
+    fossil_flatmap_t* map = (fossil_flatmap_t*)malloc(sizeof(fossil_flatmap_t));
+    if (map == cnullptr) {
+        return cnullptr;
+    }
+
+    map->keys = fossil_flatset_create(type);
+    map->values = fossil_vector_create(type);
+    if (map->keys == cnullptr || map->values == cnullptr) {
+        fossil_flatset_erase(map->keys);
+        fossil_vector_erase(map->values);
+        free(map);
+        return cnullptr;
+    }
+    map->type = type;
+    return map;
+}
+
+fossil_flatmap_t* fossil_flatmap_create_from(char* type, const fossil_tofu_t* keys, const fossil_tofu_t* values, size_t count) {
+    if (count != 0 && (keys == cnullptr || values == cnullptr)) {
+        return cnullptr;
+    }
+
+    fossil_flatmap_t* map = (fossil_flatmap_t*)malloc(sizeof(fossil_flatmap_t));
+    if (map == cnullptr) {
+        return cnullptr;
+    }
+
+    // Sort the keys once, then place each value by lookup in input order so the last pair wins.
+    map->keys = fossil_flatset_create_from(type, keys, count);
+    map->values = fossil_vector_create(type);
+    map->type = type;
+    fossil_tofu_t ghost = { 0 };
+    if (map->keys == cnullptr || map->values == cnullptr ||
+        fossil_vector_resize(map->values, fossil_flatset_size(map->keys), ghost) != 0) {
+        fossil_flatmap_erase(map);
+        return cnullptr;
+    }
+
+    fossil_flatset_reindex(map->keys);
+    for (size_t i = 0; i < count; ++i) {
+        map->values->data[fossil_flatset_search(map->keys, keys[i])] = values[i];
+    }
+    return map;
+}
+
+void fossil_flatmap_erase(fossil_flatmap_t* map) {
+    if (map == cnullptr) {
+        return;
+    }
+
+    fossil_flatset_erase(map->keys);
+    fossil_vector_erase(map->values);
+    free(map);
+}
+
+int32_t fossil_flatmap_insert(fossil_flatmap_t* map, fossil_tofu_t key, fossil_tofu_t value) {
+    size_t index = fossil_flatset_lower_bound(map->keys, key);
+    if (index < fossil_flatset_size(map->keys) && fossil_flatset_compare(*fossil_flatset_getter(map->keys, index), key) == 0) {
+        map->values->data[index] = value;
+        return 0;
+    }
+
+    if (fossil_vector_insert(map->values, index, value) != 0) {
+        return -1;  // Allocation failed
+    }
+    if (fossil_flatset_insert(map->keys, key) != 0) {
+        fossil_vector_remove_at(map->values, index);
+        return -1;  // Allocation failed
+    }
+    return 0;
+}
+
+int32_t fossil_flatmap_remove(fossil_flatmap_t* map, fossil_tofu_t key) {
+    size_t index = fossil_flatset_lower_bound(map->keys, key);
+    if (fossil_flatset_remove(map->keys, key) != 0) {
+        return -1;  // Not found
+    }
+    fossil_vector_remove_at(map->values, index);
+    return 0;
+}
+
+fossil_tofu_t* fossil_flatmap_getter(fossil_flatmap_t* map, fossil_tofu_t key) {
+    int32_t index = fossil_flatset_search(map->keys, key);
+    if (index < 0) {
+        return cnullptr;  // Not found
+    }
+    return &map->values->data[index];
+}
+
+bool fossil_flatmap_contains(fossil_flatmap_t* map, fossil_tofu_t key) {
+    return fossil_flatset_contains(map->keys, key);
+}
+
+size_t fossil_flatmap_size(const fossil_flatmap_t* map) {
+    return fossil_flatset_size(map->keys);
+}
+
+void fossil_flatmap_set_layout(fossil_flatmap_t* map, fossil_flatset_layout_t layout) {
+    fossil_flatset_set_layout(map->keys, layout);
+}
+
+int32_t fossil_flatmap_reindex(fossil_flatmap_t* map) {
+    return fossil_flatset_reindex(map->keys);
+}
+
+bool fossil_flatmap_not_empty(const fossil_flatmap_t* map) {
+    return fossil_flatset_not_empty(map->keys);
+}
+
+bool fossil_flatmap_not_cnullptr(const fossil_flatmap_t* map) {
+    return map != cnullptr;
+}
+
+bool fossil_flatmap_is_empty(const fossil_flatmap_t* map) {
+    return fossil_flatset_is_empty(map->keys);
+}
+
+bool fossil_flatmap_is_cnullptr(const fossil_flatmap_t* map) {
+    return map == cnullptr;
+}
@@ -0,0 +1,412 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#include "fossil/structure/flatset.h"
+#include <wchar.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// Windows left after narrowing before the packed search finishes with a linear count
+#define FOSSIL_FLATSET_SCAN_WIDTH 16
+
+// Total order over tofus: by type first, then by value.
+static int fossil_flatset_order(const fossil_tofu_t* a, const fossil_tofu_t* b) {
+    if (a->type != b->type) {
+        return a->type < b->type ? -1 : 1;
+    }
+
+    switch (a->type) {
+        case FOSSIL_TOFU_TYPE_INT:
+            return (a->value.int_val > b->value.int_val) - (a->value.int_val < b->value.int_val);
+        case FOSSIL_TOFU_TYPE_UINT:
+        case FOSSIL_TOFU_TYPE_HEX:
+        case FOSSIL_TOFU_TYPE_OCTAL:
+        case FOSSIL_TOFU_TYPE_SIZE:
+            return (a->value.uint_val > b->value.uint_val) - (a->value.uint_val < b->value.uint_val);
+        case FOSSIL_TOFU_TYPE_FLOAT:
+            return (a->value.float_val > b->value.float_val) - (a->value.float_val < b->value.float_val);
+        case FOSSIL_TOFU_TYPE_DOUBLE:
+            return (a->value.double_val > b->value.double_val) - (a->value.double_val < b->value.double_val);
+        case FOSSIL_TOFU_TYPE_BSTR:
+        case FOSSIL_TOFU_TYPE_CSTR: {
+            const char* sa = a->type == FOSSIL_TOFU_TYPE_BSTR ? a->value.byte_string_val : a->value.c_string_val;
+            const char* sb = b->type == FOSSIL_TOFU_TYPE_BSTR ? b->value.byte_string_val : b->value.c_string_val;
+            if (!sa || !sb) {
+                return (sa != cnullptr) - (sb != cnullptr);
+            }
+            int result = strcmp(sa, sb);
+            return (result > 0) - (result < 0);
+        }
+        case FOSSIL_TOFU_TYPE_WSTR: {
+            if (!a->value.wide_string_val || !b->value.wide_string_val) {
+                return (a->value.wide_string_val != cnullptr) - (b->value.wide_string_val != cnullptr);
+            }
+            int result = wcscmp(a->value.wide_string_val, b->value.wide_string_val);
+            return (result > 0) - (result < 0);
+        }
+        case FOSSIL_TOFU_TYPE_BCHAR: {
+            if (!a->value.byte_val || !b->value.byte_val) {
+                return (a->value.byte_val != cnullptr) - (b->value.byte_val != cnullptr);
+            }
+            int result = strcmp((const char*)a->value.byte_val, (const char*)b->value.byte_val);
+            return (result > 0) - (result < 0);
+        }
+        case FOSSIL_TOFU_TYPE_CCHAR:
+            return (a->value.char_val > b->value.char_val) - (a->value.char_val < b->value.char_val);
+        case FOSSIL_TOFU_TYPE_WCHAR:
+            return (a->value.wchar_val > b->value.wchar_val) - (a->value.wchar_val < b->value.wchar_val);
+        case FOSSIL_TOFU_TYPE_BOOL:
+            return (a->value.bool_val > b->value.bool_val) - (a->value.bool_val < b->value.bool_val);
+        default:
+            return 0;
+    }
+}
+
+int32_t fossil_flatset_compare(fossil_tofu_t a, fossil_tofu_t b) {
+    return fossil_flatset_order(&a, &b);
+}
+
+static int fossil_flatset_qsort_compare(const void* a, const void* b) {
+    return fossil_flatset_order((const fossil_tofu_t*)a, (const fossil_tofu_t*)b);
+}
+
+// Integer tofus that can be mirrored as int64_t keys without changing their order.
+static bool fossil_flatset_packable(fossil_tofu_type_t type) {
+    return type == FOSSIL_TOFU_TYPE_INT || type == FOSSIL_TOFU_TYPE_UINT ||
+           type == FOSSIL_TOFU_TYPE_HEX || type == FOSSIL_TOFU_TYPE_OCTAL;
+}
+
+// Unsigned values are biased so that signed comparison keeps their order.
+static int64_t fossil_flatset_pack(const fossil_tofu_t* tofu) {
+    if (tofu->type == FOSSIL_TOFU_TYPE_INT) {
+        return tofu->value.int_val;
+    }
+    return (int64_t)(tofu->value.uint_val ^ UINT64_C(0x8000000000000000));
+}
+
+#if defined(__AVX2__)
+// Count the lanes set in a four-lane compare mask; MSVC defines __AVX2__ but has no GCC builtins.
+static inline size_t fossil_flatset_lanes(unsigned mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (size_t)__builtin_popcount(mask);
+#else
+    return (mask & 1u) + (mask >> 1 & 1u) + (mask >> 2 & 1u) + (mask >> 3 & 1u);
+#endif
+}
+#endif
+
+// Count the keys in [keys, keys + count) that are less than key.
+static size_t fossil_flatset_count_less(const int64_t* keys, size_t count, int64_t key) {
+    size_t less = 0;
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i needle = _mm256_set1_epi64x(key);
+    for (; i + 4 <= count; i += 4) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(keys + i));
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(needle, block)));
+        less += fossil_flatset_lanes((unsigned)mask);
+    }
+#endif
+    for (; i < count; ++i) {
+        less += keys[i] < key;
+    }
+    return less;
+}
+
+// Branchless binary search over the sorted tofus.
+static size_t fossil_flatset_search_sorted(const fossil_tofu_t* items, size_t size, const fossil_tofu_t* key) {
+    if (size == 0) {
+        return 0;
+    }
+
+    const fossil_tofu_t* base = items;
+    size_t length = size;
+    while (length > 1) {
+        size_t half = length / 2;
+        base = fossil_flatset_order(&base[half], key) < 0 ? &base[half] : base;
+        length -= half;
+    }
+    return (size_t)(base - items) + (fossil_flatset_order(base, key) < 0);
+}
+
+// Branchless narrowing over the packed keys, finished by a SIMD count of the last window.
+static size_t fossil_flatset_search_packed(const int64_t* keys, size_t size, int64_t key) {
+    size_t low = 0;
+    size_t length = size;
+    while (length > FOSSIL_FLATSET_SCAN_WIDTH) {
+        size_t half = length / 2;
+        low = keys[low + half] < key ? low + half : low;
+        length -= half;
+    }
+    return low + fossil_flatset_count_less(keys + low, length, key);
+}
+
+// Turn the final Eytzinger slot into the slot of the lower bound (0 when every key is less).
+static size_t fossil_flatset_eytzinger_slot(size_t slot) {
+    while (slot & 1) {
+        slot >>= 1;
+    }
+    return slot >> 1;
+}
+
+static size_t fossil_flatset_search_eytzinger_packed(const fossil_flatset_t* set, size_t size, int64_t key) {
+    const int64_t* tree = set->keys;
+    size_t slot = 1;
+    while (slot <= size) {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(tree + slot * 8);
+#endif
+        slot = 2 * slot + (tree[slot] < key);
+    }
+    slot = fossil_flatset_eytzinger_slot(slot);
+    return slot == 0 ? size : set->ranks[slot];
+}
+
+static size_t fossil_flatset_search_eytzinger(const fossil_flatset_t* set, size_t size, const fossil_tofu_t* key) {
+    const fossil_tofu_t* tree = set->tree;
+    size_t slot = 1;
+    while (slot <= size) {
+        slot = 2 * slot + (fossil_flatset_order(&tree[slot], key) < 0);
+    }
+    slot = fossil_flatset_eytzinger_slot(slot);
+    return slot == 0 ? size : set->ranks[slot];
+}
+
+// Fill the BFS-ordered slots from an in-order walk of the sorted elements.
+static size_t fossil_flatset_build_eytzinger(fossil_flatset_t* set, size_t next, size_t slot) {
+    size_t size = set->items->size;
+    if (slot > size) {
+        return next;
+    }
+
+    next = fossil_flatset_build_eytzinger(set, next, 2 * slot);
+    if (set->packed) {
+        set->keys[slot] = fossil_flatset_pack(&set->items->data[next]);
+    } else {
+        set->tree[slot] = set->items->data[next];
+    }
+    set->ranks[slot] = next;
+    return fossil_flatset_build_eytzinger(set, next + 1, 2 * slot + 1);
+}
+
+static void fossil_flatset_release_index(fossil_flatset_t* set) {
+    free(set->keys);
+    free(set->tree);
+    free(set->ranks);
+    set->keys = cnullptr;
+    set->tree = cnullptr;
+    set->ranks = cnullptr;
+    set->packed = false;
+    set->dirty = true;
+}
+
+fossil_flatset_t* fossil_flatset_create(char* type) {
+    fossil_flatset_t* set = (fossil_flatset_t*)malloc(sizeof(fossil_flatset_t));
+    if (set == cnullptr) {
+        return cnullptr;
+    }
+
+    set->items = fossil_vector_create(type);
+    if (set->items == cnullptr) {
+        free(set);
+        return cnullptr;
+    }
+    set->layout = FOSSIL_FLATSET_SORTED;
+    set->dirty = true;
+    set->packed = false;
+    set->keys = cnullptr;
+    set->tree = cnullptr;
+    set->ranks = cnullptr;
+    set->type = type;
+    return set;
+}
+
+fossil_flatset_t* fossil_flatset_create_from(char* type, const fossil_tofu_t* elements, size_t count) {
+    fossil_flatset_t* set = fossil_flatset_create(type);
+    if (set == cnullptr) {
+        return cnullptr;
+    }
+    if (count == 0) {
+        return set;
+    }
+    if (elements == cnullptr || fossil_vector_append(set->items, elements, count) != 0) {
+        fossil_flatset_erase(set);
+        return cnullptr;
+    }
+
+    // Sort once and drop duplicates in place instead of inserting one at a time.
+    fossil_tofu_t* data = set->items->data;
+    qsort(data, count, sizeof(fossil_tofu_t), fossil_flatset_qsort_compare);
+    size_t unique = 1;
+    for (size_t i = 1; i < count; ++i) {
+        if (fossil_flatset_order(&data[unique - 1], &data[i]) != 0) {
+            data[unique++] = data[i];
+        }
+    }
+    set->items->size = unique;
+    return set;
+}
+
+void fossil_flatset_erase(fossil_flatset_t* set) {
+    if (set == cnullptr) {
+        return;
+    }
+
+    fossil_flatset_release_index(set);
+    fossil_vector_erase(set->items);
+    free(set);
+}
+
+int32_t fossil_flatset_reindex(fossil_flatset_t* set) {
+    fossil_flatset_release_index(set);
+
+    const fossil_vector_t* items = set->items;
+    size_t size = items->size;
+    if (size == 0) {
+        set->dirty = false;
+        return 0;
+    }
+
+    // Packing only pays off when every element is an integer of one type.
+    bool packed = fossil_flatset_packable(items->data[0].type);
+    for (size_t i = 1; packed && i < size; ++i) {
+        packed = items->data[i].type == items->data[0].type;
+    }
+    set->packed = packed;
+
+    if (set->layout == FOSSIL_FLATSET_EYTZINGER) {
+        set->ranks = (size_t*)malloc((size + 1) * sizeof(size_t));
+        if (packed) {
+            set->keys = (int64_t*)malloc((size + 1) * sizeof(int64_t));
+        } else {
+            set->tree = (fossil_tofu_t*)malloc((size + 1) * sizeof(fossil_tofu_t));
+        }
+        if (set->ranks == cnullptr || (packed ? set->keys == cnullptr : set->tree == cnullptr)) {
+            fossil_flatset_release_index(set);
+            return -1;
+        }
+        fossil_flatset_build_eytzinger(set, 0, 1);
+    } else if (packed) {
+        set->keys = (int64_t*)malloc(size * sizeof(int64_t));
+        if (set->keys == cnullptr) {
+            fossil_flatset_release_index(set);
+            return -1;
+        }
+        for (size_t i = 0; i < size; ++i) {
+            set->keys[i] = fossil_flatset_pack(&items->data[i]);
+        }
+    }
+
+    set->dirty = false;
+    return 0;
+}
+
+size_t fossil_flatset_lower_bound(fossil_flatset_t* set, fossil_tofu_t data) {
+    const fossil_vector_t* items = set->items;
+    size_t size = items->size;
+    if (size == 0) {
+        return 0;
+    }
+    if (set->dirty) {
+        // The sorted elements are always searchable; rebuilding is left to lookups.
+        return fossil_flatset_search_sorted(items->data, size, &data);
+    }
+
+    if (set->packed) {
+        // Every element shares one type, so a different type sorts before or after all of them.
+        fossil_tofu_type_t type = items->data[0].type;
+        if (data.type != type) {
+            return data.type < type ? 0 : size;
+        }
+        int64_t key = fossil_flatset_pack(&data);
+        if (set->layout == FOSSIL_FLATSET_EYTZINGER) {
+            return fossil_flatset_search_eytzinger_packed(set, size, key);
+        }
+        return fossil_flatset_search_packed(set->keys, size, key);
+    }
+
+    if (set->layout == FOSSIL_FLATSET_EYTZINGER) {
+        return fossil_flatset_search_eytzinger(set, size, &data);
+    }
+    return fossil_flatset_search_sorted(items->data, size, &data);
+}
+
+int32_t fossil_flatset_search(fossil_flatset_t* set, fossil_tofu_t data) {
+    if (set->dirty) {
+        fossil_flatset_reindex(set);
+    }
+
+    size_t index = fossil_flatset_lower_bound(set, data);
+    if (index < set->items->size && fossil_flatset_order(&set->items->data[index], &data) == 0) {
+        return (int32_t)index;
+    }
+    return -1;  // Not found
+}
+
+bool fossil_flatset_contains(fossil_flatset_t* set, fossil_tofu_t data) {
+    return fossil_flatset_search(set, data) >= 0;
+}
+
+int32_t fossil_flatset_insert(fossil_flatset_t* set, fossil_tofu_t data) {
+    size_t index = fossil_flatset_lower_bound(set, data);
+    if (index < set->items->size && fossil_flatset_order(&set->items->data[index], &data) == 0) {
+        return -1;  // Already present
+    }
+    if (fossil_vector_insert(set->items, index, data) != 0) {
+        return -1;  // Allocation failed
+    }
+    set->dirty = true;
+    return 0;
+}
+
+int32_t fossil_flatset_remove(fossil_flatset_t* set, fossil_tofu_t data) {
+    size_t index = fossil_flatset_lower_bound(set, data);
+    if (index >= set->items->size || fossil_flatset_order(&set->items->data[index], &data) != 0) {
+        return -1;  // Not found
+    }
+    fossil_vector_remove_at(set->items, index);
+    set->dirty = true;
+    return 0;
+}
+
+fossil_tofu_t* fossil_flatset_getter(const fossil_flatset_t* set, size_t index) {
+    return fossil_vector_getter(set->items, index);
+}
+
+size_t fossil_flatset_size(const fossil_flatset_t* set) {
+    return set->items->size;
+}
+
+void fossil_flatset_set_layout(fossil_flatset_t* set, fossil_flatset_layout_t layout) {
+    if (set->layout != layout) {
+        fossil_flatset_release_index(set);
+        set->layout = layout;
+    }
+}
+
+bool fossil_flatset_not_empty(const fossil_flatset_t* set) {
+    return set->items->size != 0;
+}
+
+bool fossil_flatset_not_cnullptr(const fossil_flatset_t* set) {
+    return set != cnullptr;
+}
+
+bool fossil_flatset_is_empty(const fossil_flatset_t* set) {
+    return set->items->size == 0;
+}
+
+bool fossil_flatset_is_cnullptr(const fossil_flatset_t* set) {
+    return set == cnullptr;
+}
@@ -12,15 +12,120 @@ Description:
 */
 #include "fossil/structure/flist.h"
 
+// Compare integer tofus inline so block scans stay in a tight loop.
+static bool fossil_flist_matches(const fossil_tofu_t* element, const fossil_tofu_t* data) {
+    if (element->type != data->type) {
+        return false;
+    }
+    switch (data->type) {
+        case FOSSIL_TOFU_TYPE_INT:
+        case FOSSIL_TOFU_TYPE_UINT:
+        case FOSSIL_TOFU_TYPE_HEX:
+        case FOSSIL_TOFU_TYPE_OCTAL:
+            return element->value.uint_val == data->value.uint_val;
+        default:
+            return fossil_tofu_equals(*element, *data);
+    }
+}
+
+// Allocate an empty block for the unrolled list.
+static fossil_flist_block_t* fossil_flist_block_create(void) {
+    fossil_flist_block_t* block = (fossil_flist_block_t*)malloc(sizeof(fossil_flist_block_t));
+    if (block) {
+        block->count = 0;
+        block->next = cnullptr;
+    }
+    return block;
+}
+
+// Refill an underfull block from its successor, merging the two when they fit in one block.
+static void fossil_flist_block_rebalance(fossil_flist_block_t* block) {
+    fossil_flist_block_t* next = block->next;
+    if (!next || block->count >= FOSSIL_FLIST_BLOCK_SIZE / 2) {
+        return;
+    }
+
+    if (block->count + next->count <= FOSSIL_FLIST_BLOCK_SIZE) {
+        memcpy(&block->data[block->count], next->data, next->count * sizeof(fossil_tofu_t));
+        block->count += next->count;
+        block->next = next->next;
+        free(next);
+        return;
+    }
+
+    size_t moved = (block->count + next->count) / 2 - block->count;
+    memcpy(&block->data[block->count], next->data, moved * sizeof(fossil_tofu_t));
+    memmove(next->data, &next->data[moved], (next->count - moved) * sizeof(fossil_tofu_t));
+    block->count += moved;
+    next->count -= moved;
+}
+
+// Insert data at offset within a block, splitting the block when it is full.
+// Returns the block that received the data and stores its offset there, or null on failure.
+static fossil_flist_block_t* fossil_flist_block_insert(fossil_flist_t* flist, fossil_flist_block_t* block, size_t* offset, fossil_tofu_t data) {
+    size_t index = *offset;
+    if (block->count == FOSSIL_FLIST_BLOCK_SIZE) {
+        // Split the full block in half and insert into the half that owns the position.
+        fossil_flist_block_t* upper = fossil_flist_block_create();
+        if (!upper) {
+            return cnullptr;  // Allocation failed
+        }
+        size_t half = FOSSIL_FLIST_BLOCK_SIZE / 2;
+        memcpy(upper->data, &block->data[half], (FOSSIL_FLIST_BLOCK_SIZE - half) * sizeof(fossil_tofu_t));
+        upper->count = FOSSIL_FLIST_BLOCK_SIZE - half;
+        upper->next = block->next;
+        block->count = half;
+        block->next = upper;
+        if (index > half) {
+            block = upper;
+            index -= half;
+        }
+    }
+
+    memmove(&block->data[index + 1], &block->data[index], (block->count - index) * sizeof(fossil_tofu_t));
+    block->data[index] = data;
+    block->count++;
+    flist->size++;
+    *offset = index;
+    return block;
+}
+
+// Remove the data at offset within a block linked from link, freeing or rebalancing the block.
+static void fossil_flist_block_remove(fossil_flist_t* flist, fossil_flist_block_t** link, size_t offset, fossil_tofu_t* data) {
+    fossil_flist_block_t* block = *link;
+    *data = block->data[offset];
+    memmove(&block->data[offset], &block->data[offset + 1], (block->count - offset - 1) * sizeof(fossil_tofu_t));
+    block->count--;
+    flist->size--;
+
+    if (block->count == 0) {
+        *link = block->next;
+        free(block);
+    } else {
+        fossil_flist_block_rebalance(block);
+    }
+}
+
 fossil_flist_t* fossil_flist_create(char* type) {
     fossil_flist_t* flist = (fossil_flist_t*)malloc(sizeof(fossil_flist_t));
     if (flist) {
         flist->head = cnullptr;
+        flist->blocks = cnullptr;
+        flist->size = 0;
+        flist->unrolled = false;
         flist->type = type;  // Assuming type is a static string or managed separately
     }
     return flist;
 }
 
+fossil_flist_t* fossil_flist_create_unrolled(char* type) {
+    fossil_flist_t* flist = fossil_flist_create(type);
+    if (flist) {
+        flist->unrolled = true;
+    }
+    return flist;
+}
+
 void fossil_flist_erase(fossil_flist_t* flist) {
     if (!flist) return;
 
@@ -31,10 +136,36 @@ void fossil_flist_erase(fossil_flist_t* flist) {
         current = next;
     }
     flist->head = cnullptr;
+
+    fossil_flist_block_t* block = flist->blocks;
+    while (block) {
+        fossil_flist_block_t* next = block->next;
+        free(block);
+        block = next;
+    }
+    flist->blocks = cnullptr;
     free(flist);
 }
 
 int32_t fossil_flist_insert(fossil_flist_t* flist, fossil_tofu_t data) {
+    if (flist->unrolled) {
+        fossil_flist_block_t* head = flist->blocks;
+        if (!head || head->count == FOSSIL_FLIST_BLOCK_SIZE) {
+            head = fossil_flist_block_create();
+            if (!head) {
+                return -1;  // Allocation failed
+            }
+            head->next = flist->blocks;
+            flist->blocks = head;
+        }
+
+        memmove(&head->data[1], &head->data[0], head->count * sizeof(fossil_tofu_t));
+        head->data[0] = data;
+        head->count++;
+        flist->size++;
+        return 0;  // Success
+    }
+
     fossil_flist_node_t* new_node = (fossil_flist_node_t*)malloc(sizeof(fossil_flist_node_t));
     if (!new_node) {
         return -1;  // Allocation failed
@@ -51,6 +182,9 @@ int32_t fossil_flist_remove(fossil_flist_t* flist, fossil_tofu_t* data) {
     if (fossil_flist_is_cnullptr(flist)) {
         return -1;  // Empty list
     }
+    if (flist->unrolled) {
+        return fossil_flist_remove_at(flist, 0, data);
+    }
 
     fossil_flist_node_t* node_to_remove = flist->head;
     *data = node_to_remove->data;
@@ -60,7 +194,87 @@ int32_t fossil_flist_remove(fossil_flist_t* flist, fossil_tofu_t* data) {
     return 0;  // Success
 }
 
+int32_t fossil_flist_insert_at(fossil_flist_t* flist, size_t index, fossil_tofu_t data) {
+    if (index == 0) {
+        return fossil_flist_insert(flist, data);
+    }
+
+    if (!flist->unrolled) {
+        fossil_flist_node_t* prev = flist->head;
+        for (size_t i = 1; prev && i < index; ++i) {
+            prev = prev->next;
+        }
+        if (!prev) {
+            return -1;  // Out of range
+        }
+
+        fossil_flist_node_t* new_node = (fossil_flist_node_t*)malloc(sizeof(fossil_flist_node_t));
+        if (!new_node) {
+            return -1;  // Allocation failed
+        }
+        new_node->data = data;
+        new_node->next = prev->next;
+        prev->next = new_node;
+        return 0;  // Success
+    }
+
+    if (index > flist->size) {
+        return -1;  // Out of range
+    }
+
+    // Appending at the end of a block is preferred over the start of the next one.
+    fossil_flist_block_t* block = flist->blocks;
+    while (index > block->count) {
+        index -= block->count;
+        block = block->next;
+    }
+
+    return fossil_flist_block_insert(flist, block, &index, data) ? 0 : -1;
+}
+
+int32_t fossil_flist_remove_at(fossil_flist_t* flist, size_t index, fossil_tofu_t* data) {
+    if (!flist->unrolled) {
+        fossil_flist_node_t** link = &flist->head;
+        for (size_t i = 0; *link && i < index; ++i) {
+            link = &(*link)->next;
+        }
+        if (!*link) {
+            return -1;  // Out of range
+        }
+
+        fossil_flist_node_t* node_to_remove = *link;
+        *data = node_to_remove->data;
+        *link = node_to_remove->next;
+        free(node_to_remove);
+        return 0;  // Success
+    }
+
+    if (index >= flist->size) {
+        return -1;  // Out of range
+    }
+
+    fossil_flist_block_t** link = &flist->blocks;
+    while (index >= (*link)->count) {
+        index -= (*link)->count;
+        link = &(*link)->next;
+    }
+
+    fossil_flist_block_remove(flist, link, index, data);
+    return 0;  // Success
+}
+
 int32_t fossil_flist_search(const fossil_flist_t* flist, fossil_tofu_t data) {
+    if (flist->unrolled) {
+        for (const fossil_flist_block_t* block = flist->blocks; block; block = block->next) {
+            for (size_t i = 0; i < block->count; ++i) {
+                if (fossil_flist_matches(&block->data[i], &data)) {
+                    return 0;  // Found
+                }
+            }
+        }
+        return -1;  // Not found
+    }
+
     fossil_flist_node_t* current = flist->head;
     while (current) {
         if (fossil_tofu_equals(current->data, data)) {
@@ -72,6 +286,25 @@ int32_t fossil_flist_search(const fossil_flist_t* flist, fossil_tofu_t data) {
 }
 
 void fossil_flist_reverse_forward(fossil_flist_t* flist) {
+    if (flist->unrolled) {
+        // Reverse the block chain and the elements inside each block.
+        fossil_flist_block_t* prev_block = cnullptr;
+        fossil_flist_block_t* block = flist->blocks;
+        while (block) {
+            fossil_flist_block_t* next_block = block->next;
+            for (size_t i = 0; i < block->count / 2; ++i) {
+                fossil_tofu_t temp = block->data[i];
+                block->data[i] = block->data[block->count - i - 1];
+                block->data[block->count - i - 1] = temp;
+            }
+            block->next = prev_block;
+            prev_block = block;
+            block = next_block;
+        }
+        flist->blocks = prev_block;
+        return;
+    }
+
     fossil_flist_node_t* prev = cnullptr;
     fossil_flist_node_t* current = flist->head;
     fossil_flist_node_t* next = cnullptr;
@@ -91,6 +324,10 @@ void fossil_flist_reverse_backward(fossil_flist_t* flist) {
 }
 
 size_t fossil_flist_size(const fossil_flist_t* flist) {
+    if (flist->unrolled) {
+        return flist->size;
+    }
+
     size_t count = 0;
     fossil_flist_node_t* current = flist->head;
     while (current) {
@@ -101,6 +338,17 @@ size_t fossil_flist_size(const fossil_flist_t* flist) {
 }
 
 fossil_tofu_t* fossil_flist_getter(fossil_flist_t* flist, fossil_tofu_t data) {
+    if (flist->unrolled) {
+        for (fossil_flist_block_t* block = flist->blocks; block; block = block->next) {
+            for (size_t i = 0; i < block->count; ++i) {
+                if (fossil_flist_matches(&block->data[i], &data)) {
+                    return &(block->data[i]);  // Return pointer to found data
+                }
+            }
+        }
+        return cnullptr;  // Not found
+    }
+
     fossil_flist_node_t* current = flist->head;
     while (current) {
         if (fossil_tofu_equals(current->data, data)) {
@@ -112,6 +360,15 @@ fossil_tofu_t* fossil_flist_getter(fossil_flist_t* flist, fossil_tofu_t data) {
 }
 
 int32_t fossil_flist_setter(fossil_flist_t* flist, fossil_tofu_t data) {
+    if (flist->unrolled) {
+        fossil_tofu_t* found = fossil_flist_getter(flist, data);
+        if (!found) {
+            return -1;  // Not found
+        }
+        *found = data;  // Update data
+        return 0;  // Success
+    }
+
     fossil_flist_node_t* current = flist->head;
     while (current) {
         if (fossil_tofu_equals(current->data, data)) {
@@ -124,7 +381,7 @@ int32_t fossil_flist_setter(fossil_flist_t* flist, fossil_tofu_t data) {
 }
 
 bool fossil_flist_not_empty(const fossil_flist_t* flist) {
-    return flist->head != cnullptr;
+    return flist->unrolled ? flist->size != 0 : flist->head != cnullptr;
 }
 
 bool fossil_flist_not_cnullptr(const fossil_flist_t* flist) {
@@ -132,9 +389,164 @@ bool fossil_flist_not_cnullptr(const fossil_flist_t* flist) {
 }
 
 bool fossil_flist_is_empty(const fossil_flist_t* flist) {
-    return flist->head == cnullptr;
+    return flist->unrolled ? flist->size == 0 : flist->head == cnullptr;
 }
 
 bool fossil_flist_is_cnullptr(const fossil_flist_t* flist) {
     return flist == cnullptr;
 }
+
+// Find the node linked before target, or the last node when target is null.
+static fossil_flist_node_t* fossil_flist_node_before(const fossil_flist_t* flist, const fossil_flist_node_t* target) {
+    fossil_flist_node_t* prev = cnullptr;
+    for (fossil_flist_node_t* node = flist->head; node != target; node = node->next) {
+        prev = node;
+    }
+    return prev;
+}
+
+// Find the block linked before target, or the last block when target is null.
+static fossil_flist_block_t* fossil_flist_block_before(const fossil_flist_t* flist, const fossil_flist_block_t* target) {
+    fossil_flist_block_t* prev = cnullptr;
+    for (fossil_flist_block_t* block = flist->blocks; block != target; block = block->next) {
+        prev = block;
+    }
+    return prev;
+}
+
+fossil_flist_cursor_t fossil_flist_cursor_begin(fossil_flist_t* flist) {
+    fossil_flist_cursor_t cursor = { flist, flist->head, cnullptr, flist->blocks, cnullptr, 0 };
+    return cursor;
+}
+
+fossil_flist_cursor_t fossil_flist_cursor_end(fossil_flist_t* flist) {
+    fossil_flist_cursor_t cursor = { flist, cnullptr, cnullptr, cnullptr, cnullptr, 0 };
+    if (flist->unrolled) {
+        cursor.prev_block = fossil_flist_block_before(flist, cnullptr);
+    } else {
+        cursor.prev = fossil_flist_node_before(flist, cnullptr);
+    }
+    return cursor;
+}
+
+bool fossil_flist_cursor_valid(const fossil_flist_cursor_t* cursor) {
+    return cursor->flist->unrolled ? cursor->block != cnullptr : cursor->node != cnullptr;
+}
+
+void fossil_flist_cursor_next(fossil_flist_cursor_t* cursor) {
+    if (!cursor->flist->unrolled) {
+        if (cursor->node) {
+            cursor->prev = cursor->node;
+            cursor->node = cursor->node->next;
+        }
+        return;
+    }
+
+    if (cursor->block && ++cursor->offset >= cursor->block->count) {
+        cursor->prev_block = cursor->block;
+        cursor->block = cursor->block->next;
+        cursor->offset = 0;
+    }
+}
+
+void fossil_flist_cursor_prev(fossil_flist_cursor_t* cursor) {
+    fossil_flist_t* flist = cursor->flist;
+    if (!flist->unrolled) {
+        if (cursor->node == flist->head) {
+            *cursor = fossil_flist_cursor_end(flist);  // Before the head wraps to the end
+            return;
+        }
+        cursor->node = cursor->prev;
+        cursor->prev = fossil_flist_node_before(flist, cursor->node);
+        return;
+    }
+
+    if (cursor->block && cursor->offset > 0) {
+        cursor->offset--;
+        return;
+    }
+    if (cursor->block == flist->blocks) {
+        *cursor = fossil_flist_cursor_end(flist);  // Before the head wraps to the end
+        return;
+    }
+    cursor->block = cursor->prev_block;
+    cursor->offset = cursor->block->count - 1;
+    cursor->prev_block = fossil_flist_block_before(flist, cursor->block);
+}
+
+fossil_tofu_t* fossil_flist_cursor_deref(const fossil_flist_cursor_t* cursor) {
+    if (cursor->flist->unrolled) {
+        return cursor->block ? &cursor->block->data[cursor->offset] : cnullptr;
+    }
+    return cursor->node ? &cursor->node->data : cnullptr;
+}
+
+int32_t fossil_flist_cursor_insert_after(fossil_flist_cursor_t* cursor, fossil_tofu_t data) {
+    if (!fossil_flist_cursor_valid(cursor)) {
+        return -1;  // Cursor is at the end
+    }
+
+    if (!cursor->flist->unrolled) {
+        fossil_flist_node_t* new_node = (fossil_flist_node_t*)malloc(sizeof(fossil_flist_node_t));
+        if (!new_node) {
+            return -1;  // Allocation failed
+        }
+        new_node->data = data;
+        new_node->next = cursor->node->next;
+        cursor->node->next = new_node;
+        return 0;  // Success
+    }
+
+    // The cursor's element sits just before the new one, which may now be in the split-off half.
+    size_t offset = cursor->offset + 1;
+    fossil_flist_block_t* block = fossil_flist_block_insert(cursor->flist, cursor->block, &offset, data);
+    if (!block) {
+        return -1;  // Allocation failed
+    }
+    if (block != cursor->block) {
+        cursor->prev_block = cursor->block;
+        cursor->block = block;
+    }
+    cursor->offset = offset - 1;
+    return 0;  // Success
+}
+
+int32_t fossil_flist_cursor_erase(fossil_flist_cursor_t* cursor, fossil_tofu_t* data) {
+    if (!fossil_flist_cursor_valid(cursor)) {
+        return -1;  // Cursor is at the end
+    }
+
+    fossil_flist_t* flist = cursor->flist;
+    if (!flist->unrolled) {
+        fossil_flist_node_t* node_to_remove = cursor->node;
+        *(cursor->prev ? &cursor->prev->next : &flist->head) = node_to_remove->next;
+        cursor->node = node_to_remove->next;
+        *data = node_to_remove->data;
+        free(node_to_remove);
+        return 0;  // Success
+    }
+
+    fossil_flist_block_t** link = cursor->prev_block ? &cursor->prev_block->next : &flist->blocks;
+    fossil_flist_block_t* next_block = cursor->block->next;
+    bool last_in_block = cursor->block->count == 1;
+    fossil_flist_block_remove(flist, link, cursor->offset, data);
+    if (last_in_block) {
+        cursor->block = next_block;
+        cursor->offset = 0;
+    } else if (cursor->offset >= cursor->block->count) {
+        cursor->prev_block = cursor->block;
+        cursor->block = cursor->block->next;
+        cursor->offset = 0;
+    }
+    return 0;  // Success
+}
+
+fossil_tofu_iteratorof_t fossil_flist_cursor_span(const fossil_flist_cursor_t* cursor) {
+    if (!fossil_flist_cursor_valid(cursor)) {
+        return fossil_tofu_iteratorof_create(cnullptr, 0);
+    }
+    if (cursor->flist->unrolled) {
+        return fossil_tofu_iteratorof_create(&cursor->block->data[cursor->offset], cursor->block->count - cursor->offset);
+    }
+    return fossil_tofu_iteratorof_create(&cursor->node->data, 1);
+}
@@ -0,0 +1,241 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#include "fossil/structure/intrusive.h"
+
+// *****************************************************************************
+// Forward list
+// *****************************************************************************
+
+void fossil_iflist_init(fossil_iflist_t* list) {
+    list->head = cnullptr;
+    list->size = 0;
+}
+
+void fossil_iflist_push_front(fossil_iflist_t* list, fossil_iflist_link_t* link) {
+    link->next = list->head;
+    list->head = link;
+    list->size++;
+}
+
+fossil_iflist_link_t* fossil_iflist_pop_front(fossil_iflist_t* list) {
+    return fossil_iflist_remove_after(list, cnullptr);
+}
+
+void fossil_iflist_insert_after(fossil_iflist_t* list, fossil_iflist_link_t* pos, fossil_iflist_link_t* link) {
+    if (pos == cnullptr) {
+        fossil_iflist_push_front(list, link);
+        return;
+    }
+    link->next = pos->next;
+    pos->next = link;
+    list->size++;
+}
+
+fossil_iflist_link_t* fossil_iflist_remove_after(fossil_iflist_t* list, fossil_iflist_link_t* pos) {
+    fossil_iflist_link_t** slot = pos ? &pos->next : &list->head;
+    fossil_iflist_link_t* link = *slot;
+    if (link == cnullptr) {
+        return cnullptr;
+    }
+    *slot = link->next;
+    link->next = cnullptr;
+    list->size--;
+    return link;
+}
+
+int32_t fossil_iflist_remove(fossil_iflist_t* list, fossil_iflist_link_t* link) {
+    fossil_iflist_link_t* prev = cnullptr;
+    for (fossil_iflist_link_t* current = list->head; current; current = current->next) {
+        if (current == link) {
+            fossil_iflist_remove_after(list, prev);
+            return 0;
+        }
+        prev = current;
+    }
+    return -1;  // Not in the list
+}
+
+void fossil_iflist_reverse(fossil_iflist_t* list) {
+    fossil_iflist_link_t* prev = cnullptr;
+    fossil_iflist_link_t* current = list->head;
+    while (current) {
+        fossil_iflist_link_t* next = current->next;
+        current->next = prev;
+        prev = current;
+        current = next;
+    }
+    list->head = prev;
+}
+
+size_t fossil_iflist_size(const fossil_iflist_t* list) {
+    return list->size;
+}
+
+bool fossil_iflist_not_empty(const fossil_iflist_t* list) {
+    return list != cnullptr && list->head != cnullptr;
+}
+
+bool fossil_iflist_not_cnullptr(const fossil_iflist_t* list) {
+    return list != cnullptr;
+}
+
+bool fossil_iflist_is_empty(const fossil_iflist_t* list) {
+    return list == cnullptr || list->head == cnullptr;
+}
+
+bool fossil_iflist_is_cnullptr(const fossil_iflist_t* list) {
+    return list == cnullptr;
+}
+
+// *****************************************************************************
+// Doubly linked list
+// *****************************************************************************
+
+void fossil_idlist_init(fossil_idlist_t* list) {
+    list->head = cnullptr;
+    list->tail = cnullptr;
+    list->size = 0;
+}
+
+void fossil_idlist_push_front(fossil_idlist_t* list, fossil_idlist_link_t* link) {
+    fossil_idlist_insert_before(list, list->head, link);
+}
+
+void fossil_idlist_push_back(fossil_idlist_t* list, fossil_idlist_link_t* link) {
+    fossil_idlist_insert_after(list, list->tail, link);
+}
+
+fossil_idlist_link_t* fossil_idlist_pop_front(fossil_idlist_t* list) {
+    fossil_idlist_link_t* link = list->head;
+    if (link) {
+        fossil_idlist_remove(list, link);
+    }
+    return link;
+}
+
+fossil_idlist_link_t* fossil_idlist_pop_back(fossil_idlist_t* list) {
+    fossil_idlist_link_t* link = list->tail;
+    if (link) {
+        fossil_idlist_remove(list, link);
+    }
+    return link;
+}
+
+void fossil_idlist_insert_before(fossil_idlist_t* list, fossil_idlist_link_t* pos, fossil_idlist_link_t* link) {
+    if (pos == cnullptr) {
+        // Insert at the back
+        link->prev = list->tail;
+        link->next = cnullptr;
+        if (list->tail) {
+            list->tail->next = link;
+        } else {
+            list->head = link;
+        }
+        list->tail = link;
+    } else {
+        link->prev = pos->prev;
+        link->next = pos;
+        if (pos->prev) {
+            pos->prev->next = link;
+        } else {
+            list->head = link;
+        }
+        pos->prev = link;
+    }
+    list->size++;
+}
+
+void fossil_idlist_insert_after(fossil_idlist_t* list, fossil_idlist_link_t* pos, fossil_idlist_link_t* link) {
+    // A null next position means pos is the tail, which inserts at the back
+    fossil_idlist_insert_before(list, pos ? pos->next : list->head, link);
+}
+
+void fossil_idlist_remove(fossil_idlist_t* list, fossil_idlist_link_t* link) {
+    if (link->prev) {
+        link->prev->next = link->next;
+    } else {
+        list->head = link->next;
+    }
+    if (link->next) {
+        link->next->prev = link->prev;
+    } else {
+        list->tail = link->prev;
+    }
+    link->prev = cnullptr;
+    link->next = cnullptr;
+    list->size--;
+}
+
+size_t fossil_idlist_size(const fossil_idlist_t* list) {
+    return list->size;
+}
+
+bool fossil_idlist_not_empty(const fossil_idlist_t* list) {
+    return list != cnullptr && list->head != cnullptr;
+}
+
+bool fossil_idlist_not_cnullptr(const fossil_idlist_t* list) {
+    return list != cnullptr;
+}
+
+bool fossil_idlist_is_empty(const fossil_idlist_t* list) {
+    return list == cnullptr || list->head == cnullptr;
+}
+
+bool fossil_idlist_is_cnullptr(const fossil_idlist_t* list) {
+    return list == cnullptr;
+}
+
+// *****************************************************************************
+// Queue
+// *****************************************************************************
+
+void fossil_iqueue_init(fossil_iqueue_t* queue) {
+    fossil_idlist_init(&queue->list);
+}
+
+void fossil_iqueue_insert(fossil_iqueue_t* queue, fossil_idlist_link_t* link) {
+    fossil_idlist_push_back(&queue->list, link);
+}
+
+fossil_idlist_link_t* fossil_iqueue_remove(fossil_iqueue_t* queue) {
+    return fossil_idlist_pop_front(&queue->list);
+}
+
+fossil_idlist_link_t* fossil_iqueue_peek(const fossil_iqueue_t* queue) {
+    return queue->list.head;
+}
+
+void fossil_iqueue_unlink(fossil_iqueue_t* queue, fossil_idlist_link_t* link) {
+    fossil_idlist_remove(&queue->list, link);
+}
+
+size_t fossil_iqueue_size(const fossil_iqueue_t* queue) {
+    return queue->list.size;
+}
+
+bool fossil_iqueue_not_empty(const fossil_iqueue_t* queue) {
+    return queue != cnullptr && queue->list.head != cnullptr;
+}
+
+bool fossil_iqueue_not_cnullptr(const fossil_iqueue_t* queue) {
+    return queue != cnullptr;
+}
+
+bool fossil_iqueue_is_empty(const fossil_iqueue_t* queue) {
+    return queue == cnullptr || queue->list.head == cnullptr;
+}
+
+bool fossil_iqueue_is_cnullptr(const fossil_iqueue_t* queue) {
+    return queue == cnullptr;
+}
@@ -147,3 +147,87 @@ bool fossil_pqueue_is_empty(const fossil_pqueue_t* pqueue) {
 bool fossil_pqueue_is_cnullptr(const fossil_pqueue_t* pqueue) {
     return pqueue == cnullptr;
 }
+
+// Find the node linked before target, or the last node when target is null.
+static fossil_pqueue_node_t* fossil_pqueue_node_before(const fossil_pqueue_t* pqueue, const fossil_pqueue_node_t* target) {
+    fossil_pqueue_node_t* prev = cnullptr;
+    for (fossil_pqueue_node_t* node = pqueue->front; node != target; node = node->next) {
+        prev = node;
+    }
+    return prev;
+}
+
+fossil_pqueue_cursor_t fossil_pqueue_cursor_begin(fossil_pqueue_t* pqueue) {
+    fossil_pqueue_cursor_t cursor = { pqueue, pqueue->front, cnullptr };
+    return cursor;
+}
+
+fossil_pqueue_cursor_t fossil_pqueue_cursor_end(fossil_pqueue_t* pqueue) {
+    fossil_pqueue_cursor_t cursor = { pqueue, cnullptr, fossil_pqueue_node_before(pqueue, cnullptr) };
+    return cursor;
+}
+
+bool fossil_pqueue_cursor_valid(const fossil_pqueue_cursor_t* cursor) {
+    return cursor->node != cnullptr;
+}
+
+void fossil_pqueue_cursor_next(fossil_pqueue_cursor_t* cursor) {
+    if (cursor->node) {
+        cursor->prev = cursor->node;
+        cursor->node = cursor->node->next;
+    }
+}
+
+void fossil_pqueue_cursor_prev(fossil_pqueue_cursor_t* cursor) {
+    if (cursor->node == cursor->pqueue->front) {
+        *cursor = fossil_pqueue_cursor_end(cursor->pqueue);  // Before the front wraps to the end
+        return;
+    }
+    cursor->node = cursor->prev;
+    cursor->prev = fossil_pqueue_node_before(cursor->pqueue, cursor->node);
+}
+
+fossil_tofu_t* fossil_pqueue_cursor_deref(const fossil_pqueue_cursor_t* cursor) {
+    return cursor->node ? &cursor->node->data : cnullptr;
+}
+
+int32_t fossil_pqueue_cursor_insert_after(fossil_pqueue_cursor_t* cursor, fossil_tofu_t data) {
+    if (!cursor->node) {
+        return -1;  // Cursor is at the end
+    }
+
+    fossil_pqueue_node_t* new_node = (fossil_pqueue_node_t*)malloc(sizeof(fossil_pqueue_node_t));
+    if (!new_node) {
+        return -1;  // Allocation failed
+    }
+
+    new_node->data = data;
+    new_node->priority = cursor->node->priority;
+    new_node->next = cursor->node->next;
+    cursor->node->next = new_node;
+    return 0;  // Success
+}
+
+int32_t fossil_pqueue_cursor_erase(fossil_pqueue_cursor_t* cursor, fossil_tofu_t* data) {
+    if (!cursor->node) {
+        return -1;  // Cursor is at the end
+    }
+
+    fossil_pqueue_node_t* node_to_remove = cursor->node;
+    if (cursor->prev) {
+        cursor->prev->next = node_to_remove->next;
+    } else {
+        cursor->pqueue->front = node_to_remove->next;
+    }
+    cursor->node = node_to_remove->next;
+    *data = node_to_remove->data;
+    free(node_to_remove);
+    return 0;  // Success
+}
+
+fossil_tofu_iteratorof_t fossil_pqueue_cursor_span(const fossil_pqueue_cursor_t* cursor) {
+    if (!cursor->node) {
+        return fossil_tofu_iteratorof_create(cnullptr, 0);
+    }
+    return fossil_tofu_iteratorof_create(&cursor->node->data, 1);
+}
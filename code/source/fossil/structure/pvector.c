@@ -0,0 +1,466 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#include "fossil/structure/pvector.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FOSSIL_PVECTOR_MASK (FOSSIL_PVECTOR_WIDTH - 1)
+
+struct fossil_pvector_node_t {
+    atomic_size_t refs; // Versions and parent slots referencing the node
+};
+
+// Interior node, its children are one level down
+typedef struct {
+    fossil_pvector_node_t base;
+    fossil_pvector_node_t* children[FOSSIL_PVECTOR_WIDTH];
+} fossil_pvector_branch_t;
+
+// Leaf node holding the elements
+typedef struct {
+    fossil_pvector_node_t base;
+    fossil_tofu_t data[FOSSIL_PVECTOR_WIDTH];
+} fossil_pvector_leaf_t;
+
+static inline fossil_pvector_node_t** fossil_pvector_children(fossil_pvector_node_t* node) {
+    return ((fossil_pvector_branch_t*)node)->children;
+}
+
+static inline fossil_tofu_t* fossil_pvector_data(fossil_pvector_node_t* node) {
+    return ((fossil_pvector_leaf_t*)node)->data;
+}
+
+// Index of the first element stored in the tail.
+static inline size_t fossil_pvector_tailoff(size_t size) {
+    return size < FOSSIL_PVECTOR_WIDTH ? 0 : ((size - 1) >> FOSSIL_PVECTOR_BITS) << FOSSIL_PVECTOR_BITS;
+}
+
+// Allocate a node with one reference. Level 0 is a leaf, anything above is a branch.
+static fossil_pvector_node_t* fossil_pvector_node_alloc(uint32_t level) {
+    fossil_pvector_node_t* node = level ? (fossil_pvector_node_t*)calloc(1, sizeof(fossil_pvector_branch_t))
+                                        : (fossil_pvector_node_t*)malloc(sizeof(fossil_pvector_leaf_t));
+    if (node) {
+        atomic_init(&node->refs, 1);
+    }
+    return node;
+}
+
+static void fossil_pvector_node_retain(fossil_pvector_node_t* node) {
+    if (node) {
+        atomic_fetch_add_explicit(&node->refs, 1, memory_order_relaxed);
+    }
+}
+
+static void fossil_pvector_node_release(fossil_pvector_node_t* node, uint32_t level) {
+    if (!node || atomic_fetch_sub_explicit(&node->refs, 1, memory_order_acq_rel) != 1) {
+        return;
+    }
+    if (level > 0) {
+        for (size_t i = 0; i < FOSSIL_PVECTOR_WIDTH; ++i) {
+            fossil_pvector_node_release(fossil_pvector_children(node)[i], level - FOSSIL_PVECTOR_BITS);
+        }
+    }
+    free(node);
+}
+
+// Trade the caller's reference to node for a node nobody else references, copying it if it is
+// shared. On allocation failure the caller keeps its reference and NULL is returned.
+static fossil_pvector_node_t* fossil_pvector_node_unique(fossil_pvector_node_t* node, uint32_t level) {
+    if (atomic_load_explicit(&node->refs, memory_order_acquire) == 1) {
+        return node;
+    }
+
+    fossil_pvector_node_t* copy = fossil_pvector_node_alloc(level);
+    if (!copy) {
+        return cnullptr;
+    }
+    if (level > 0) {
+        for (size_t i = 0; i < FOSSIL_PVECTOR_WIDTH; ++i) {
+            fossil_pvector_node_t* child = fossil_pvector_children(node)[i];
+            fossil_pvector_node_retain(child);
+            fossil_pvector_children(copy)[i] = child;
+        }
+    } else {
+        memcpy(fossil_pvector_data(copy), fossil_pvector_data(node), sizeof(((fossil_pvector_leaf_t*)0)->data));
+    }
+    fossil_pvector_node_release(node, level);
+    return copy;
+}
+
+// Find the leaf holding the element at index.
+static fossil_pvector_node_t* fossil_pvector_leaf_for(const fossil_pvector_t* pvector, size_t index) {
+    if (index >= fossil_pvector_tailoff(pvector->size)) {
+        return pvector->tail;
+    }
+
+    fossil_pvector_node_t* node = pvector->root;
+    for (uint32_t level = pvector->shift; level > 0; level -= FOSSIL_PVECTOR_BITS) {
+        node = fossil_pvector_children(node)[(index >> level) & FOSSIL_PVECTOR_MASK];
+    }
+    return node;
+}
+
+// Build a chain of single-child branches from level down to the leaf.
+static fossil_pvector_node_t* fossil_pvector_new_path(uint32_t level, fossil_pvector_node_t* leaf) {
+    if (level == 0) {
+        return leaf;
+    }
+
+    fossil_pvector_node_t* node = fossil_pvector_node_alloc(level);
+    if (!node) {
+        return cnullptr;
+    }
+    fossil_pvector_node_t* child = fossil_pvector_new_path(level - FOSSIL_PVECTOR_BITS, leaf);
+    if (!child) {
+        free(node);
+        return cnullptr;
+    }
+    fossil_pvector_children(node)[0] = child;
+    return node;
+}
+
+// Hang a full leaf into the unique branch node, copying shared nodes along the way.
+static int32_t fossil_pvector_push_leaf(size_t index, uint32_t level, fossil_pvector_node_t* node, fossil_pvector_node_t* leaf) {
+    fossil_pvector_node_t** slot = &fossil_pvector_children(node)[(index >> level) & FOSSIL_PVECTOR_MASK];
+    if (level == FOSSIL_PVECTOR_BITS) {
+        *slot = leaf;
+        return 0;
+    }
+
+    if (*slot) {
+        fossil_pvector_node_t* child = fossil_pvector_node_unique(*slot, level - FOSSIL_PVECTOR_BITS);
+        if (!child) {
+            return -1; // Allocation failed
+        }
+        *slot = child;
+        return fossil_pvector_push_leaf(index, level - FOSSIL_PVECTOR_BITS, child, leaf);
+    }
+
+    fossil_pvector_node_t* path = fossil_pvector_new_path(level - FOSSIL_PVECTOR_BITS, leaf);
+    if (!path) {
+        return -1; // Allocation failed
+    }
+    *slot = path;
+    return 0;
+}
+
+// Move the full tail into the trie, growing the trie by a level when the root is full.
+static int32_t fossil_pvector_push_tail(fossil_pvector_t* pvector) {
+    uint32_t shift = pvector->shift;
+    if (pvector->root && (pvector->size >> FOSSIL_PVECTOR_BITS) > ((size_t)1 << shift)) {
+        fossil_pvector_node_t* root = fossil_pvector_node_alloc(shift + FOSSIL_PVECTOR_BITS);
+        fossil_pvector_node_t* path = root ? fossil_pvector_new_path(shift, pvector->tail) : cnullptr;
+        if (!path) {
+            free(root);
+            return -1; // Allocation failed
+        }
+        fossil_pvector_children(root)[0] = pvector->root;
+        fossil_pvector_children(root)[1] = path;
+        pvector->root = root;
+        pvector->shift = shift + FOSSIL_PVECTOR_BITS;
+        return 0;
+    }
+
+    fossil_pvector_node_t* root = pvector->root ? fossil_pvector_node_unique(pvector->root, shift)
+                                                : fossil_pvector_node_alloc(shift);
+    if (!root) {
+        return -1; // Allocation failed
+    }
+    pvector->root = root;
+    return fossil_pvector_push_leaf(pvector->size - 1, shift, root, pvector->tail);
+}
+
+// Make every branch on the path to the leaf holding index unique, leaving the leaf shared.
+static int32_t fossil_pvector_unique_path(fossil_pvector_t* pvector, size_t index) {
+    fossil_pvector_node_t* node = fossil_pvector_node_unique(pvector->root, pvector->shift);
+    if (!node) {
+        return -1; // Allocation failed
+    }
+    pvector->root = node;
+
+    for (uint32_t level = pvector->shift; level > FOSSIL_PVECTOR_BITS; level -= FOSSIL_PVECTOR_BITS) {
+        fossil_pvector_node_t** slot = &fossil_pvector_children(node)[(index >> level) & FOSSIL_PVECTOR_MASK];
+        node = fossil_pvector_node_unique(*slot, level - FOSSIL_PVECTOR_BITS);
+        if (!node) {
+            return -1; // Allocation failed
+        }
+        *slot = node;
+    }
+    return 0;
+}
+
+// Drop the rightmost leaf from a unique path. Returns true when the node was left empty.
+static bool fossil_pvector_pop_leaf(size_t index, uint32_t level, fossil_pvector_node_t* node) {
+    size_t subidx = (index >> level) & FOSSIL_PVECTOR_MASK;
+    fossil_pvector_node_t** slot = &fossil_pvector_children(node)[subidx];
+    if (level == FOSSIL_PVECTOR_BITS || fossil_pvector_pop_leaf(index, level - FOSSIL_PVECTOR_BITS, *slot)) {
+        fossil_pvector_node_release(*slot, level - FOSSIL_PVECTOR_BITS);
+        *slot = cnullptr;
+    }
+    return subidx == 0 && !*slot;
+}
+
+fossil_pvector_t* fossil_pvector_create(char* type) {
+    fossil_pvector_t* pvector = (fossil_pvector_t*)malloc(sizeof(fossil_pvector_t));
+    if (pvector) {
+        pvector->root = cnullptr;
+        pvector->tail = cnullptr;
+        pvector->size = 0;
+        pvector->shift = FOSSIL_PVECTOR_BITS;
+        pvector->transient = false;
+        pvector->type = type;
+    }
+    return pvector;
+}
+
+fossil_pvector_t* fossil_pvector_create_from(char* type, const fossil_tofu_t* elements, size_t count) {
+    if (count != 0 && !elements) {
+        return cnullptr;
+    }
+
+    fossil_pvector_t* pvector = fossil_pvector_create(type);
+    if (!pvector) {
+        return cnullptr;
+    }
+
+    pvector->transient = true;
+    for (size_t i = 0; i < count; ++i) {
+        if (fossil_pvector_transient_push_back(pvector, elements[i]) != 0) {
+            fossil_pvector_erase(pvector);
+            return cnullptr; // Allocation failed
+        }
+    }
+    pvector->transient = false;
+    return pvector;
+}
+
+void fossil_pvector_erase(fossil_pvector_t* pvector) {
+    if (!pvector) return;
+
+    fossil_pvector_node_release(pvector->root, pvector->shift);
+    fossil_pvector_node_release(pvector->tail, 0);
+    free(pvector);
+}
+
+fossil_pvector_t* fossil_pvector_snapshot(const fossil_pvector_t* pvector) {
+    fossil_pvector_t* snapshot = (fossil_pvector_t*)malloc(sizeof(fossil_pvector_t));
+    if (!snapshot) {
+        return cnullptr;
+    }
+
+    *snapshot = *pvector;
+    snapshot->transient = false;
+    fossil_pvector_node_retain(snapshot->root);
+    fossil_pvector_node_retain(snapshot->tail);
+    return snapshot;
+}
+
+const fossil_tofu_t* fossil_pvector_getter(const fossil_pvector_t* pvector, size_t index) {
+    if (index >= pvector->size) {
+        return cnullptr;
+    }
+    return &fossil_pvector_data(fossil_pvector_leaf_for(pvector, index))[index & FOSSIL_PVECTOR_MASK];
+}
+
+fossil_tofu_iteratorof_t fossil_pvector_span(const fossil_pvector_t* pvector, size_t index) {
+    if (index >= pvector->size) {
+        return fossil_tofu_iteratorof_create(cnullptr, 0);
+    }
+
+    size_t leaf_start = index & ~(size_t)FOSSIL_PVECTOR_MASK;
+    size_t leaf_end = pvector->size - leaf_start < FOSSIL_PVECTOR_WIDTH ? pvector->size : leaf_start + FOSSIL_PVECTOR_WIDTH;
+    fossil_tofu_t* data = fossil_pvector_data(fossil_pvector_leaf_for(pvector, index));
+    return fossil_tofu_iteratorof_create(&data[index - leaf_start], leaf_end - index);
+}
+
+size_t fossil_pvector_size(const fossil_pvector_t* pvector) {
+    return pvector->size;
+}
+
+fossil_pvector_t* fossil_pvector_set(const fossil_pvector_t* pvector, size_t index, fossil_tofu_t data) {
+    fossil_pvector_t* next = fossil_pvector_transient(pvector);
+    if (!next) {
+        return cnullptr;
+    }
+    if (fossil_pvector_transient_set(next, index, data) != 0) {
+        fossil_pvector_erase(next);
+        return cnullptr;
+    }
+    next->transient = false;
+    return next;
+}
+
+fossil_pvector_t* fossil_pvector_push_back(const fossil_pvector_t* pvector, fossil_tofu_t data) {
+    fossil_pvector_t* next = fossil_pvector_transient(pvector);
+    if (!next) {
+        return cnullptr;
+    }
+    if (fossil_pvector_transient_push_back(next, data) != 0) {
+        fossil_pvector_erase(next);
+        return cnullptr;
+    }
+    next->transient = false;
+    return next;
+}
+
+fossil_pvector_t* fossil_pvector_pop_back(const fossil_pvector_t* pvector) {
+    fossil_pvector_t* next = fossil_pvector_transient(pvector);
+    if (!next) {
+        return cnullptr;
+    }
+    if (fossil_pvector_transient_pop_back(next, cnullptr) != 0) {
+        fossil_pvector_erase(next);
+        return cnullptr;
+    }
+    next->transient = false;
+    return next;
+}
+
+fossil_pvector_t* fossil_pvector_transient(const fossil_pvector_t* pvector) {
+    fossil_pvector_t* transient = fossil_pvector_snapshot(pvector);
+    if (transient) {
+        transient->transient = true;
+    }
+    return transient;
+}
+
+void fossil_pvector_persistent(fossil_pvector_t* pvector) {
+    pvector->transient = false;
+}
+
+int32_t fossil_pvector_transient_set(fossil_pvector_t* pvector, size_t index, fossil_tofu_t data) {
+    if (!pvector->transient || index >= pvector->size) {
+        return -1; // Not transient or index out of range
+    }
+
+    if (index >= fossil_pvector_tailoff(pvector->size)) {
+        fossil_pvector_node_t* tail = fossil_pvector_node_unique(pvector->tail, 0);
+        if (!tail) {
+            return -1; // Allocation failed
+        }
+        pvector->tail = tail;
+        fossil_pvector_data(tail)[index & FOSSIL_PVECTOR_MASK] = data;
+        return 0;
+    }
+
+    if (fossil_pvector_unique_path(pvector, index) != 0) {
+        return -1; // Allocation failed
+    }
+    fossil_pvector_node_t* node = pvector->root;
+    for (uint32_t level = pvector->shift; level > FOSSIL_PVECTOR_BITS; level -= FOSSIL_PVECTOR_BITS) {
+        node = fossil_pvector_children(node)[(index >> level) & FOSSIL_PVECTOR_MASK];
+    }
+    fossil_pvector_node_t** slot = &fossil_pvector_children(node)[(index >> FOSSIL_PVECTOR_BITS) & FOSSIL_PVECTOR_MASK];
+    fossil_pvector_node_t* leaf = fossil_pvector_node_unique(*slot, 0);
+    if (!leaf) {
+        return -1; // Allocation failed
+    }
+    *slot = leaf;
+    fossil_pvector_data(leaf)[index & FOSSIL_PVECTOR_MASK] = data;
+    return 0;
+}
+
+int32_t fossil_pvector_transient_push_back(fossil_pvector_t* pvector, fossil_tofu_t data) {
+    if (!pvector->transient) {
+        return -1; // Not transient
+    }
+
+    size_t tail_size = pvector->size - fossil_pvector_tailoff(pvector->size);
+    if (pvector->tail && tail_size < FOSSIL_PVECTOR_WIDTH) {
+        fossil_pvector_node_t* tail = fossil_pvector_node_unique(pvector->tail, 0);
+        if (!tail) {
+            return -1; // Allocation failed
+        }
+        pvector->tail = tail;
+        fossil_pvector_data(tail)[tail_size] = data;
+        pvector->size++;
+        return 0;
+    }
+
+    // The tail is full (or missing), so it moves into the trie and a fresh leaf takes its place.
+    fossil_pvector_node_t* tail = fossil_pvector_node_alloc(0);
+    if (!tail) {
+        return -1; // Allocation failed
+    }
+    if (pvector->tail && fossil_pvector_push_tail(pvector) != 0) {
+        free(tail);
+        return -1; // Allocation failed
+    }
+    fossil_pvector_data(tail)[0] = data;
+    pvector->tail = tail;
+    pvector->size++;
+    return 0;
+}
+
+int32_t fossil_pvector_transient_pop_back(fossil_pvector_t* pvector, fossil_tofu_t* data) {
+    if (!pvector->transient || pvector->size == 0) {
+        return -1; // Not transient or empty
+    }
+
+    size_t tailoff = fossil_pvector_tailoff(pvector->size);
+    if (data) {
+        *data = fossil_pvector_data(pvector->tail)[pvector->size - 1 - tailoff];
+    }
+
+    // Slots past the size are never read, so a shared tail can simply be shortened.
+    if (pvector->size - tailoff > 1 || pvector->size == 1) {
+        if (--pvector->size == 0) {
+            fossil_pvector_node_release(pvector->tail, 0);
+            pvector->tail = cnullptr;
+        }
+        return 0;
+    }
+
+    // The tail empties, so the rightmost leaf of the trie becomes the new tail.
+    size_t index = pvector->size - 2;
+    if (fossil_pvector_unique_path(pvector, index) != 0) {
+        return -1; // Allocation failed
+    }
+    fossil_pvector_node_t* tail = fossil_pvector_leaf_for(pvector, index);
+    fossil_pvector_node_retain(tail);
+
+    if (fossil_pvector_pop_leaf(index, pvector->shift, pvector->root)) {
+        fossil_pvector_node_release(pvector->root, pvector->shift);
+        pvector->root = cnullptr;
+        pvector->shift = FOSSIL_PVECTOR_BITS;
+    }
+    while (pvector->shift > FOSSIL_PVECTOR_BITS && !fossil_pvector_children(pvector->root)[1]) {
+        fossil_pvector_node_t* child = fossil_pvector_children(pvector->root)[0];
+        fossil_pvector_node_retain(child);
+        fossil_pvector_node_release(pvector->root, pvector->shift);
+        pvector->root = child;
+        pvector->shift -= FOSSIL_PVECTOR_BITS;
+    }
+
+    fossil_pvector_node_release(pvector->tail, 0);
+    pvector->tail = tail;
+    pvector->size--;
+    return 0;
+}
+
+bool fossil_pvector_not_empty(const fossil_pvector_t* pvector) {
+    return pvector->size != 0;
+}
+
+bool fossil_pvector_not_cnullptr(const fossil_pvector_t* pvector) {
+    return pvector != cnullptr;
+}
+
+bool fossil_pvector_is_empty(const fossil_pvector_t* pvector) {
+    return pvector->size == 0;
+}
+
+bool fossil_pvector_is_cnullptr(const fossil_pvector_t* pvector) {
+    return pvector == cnullptr;
+}
@@ -135,3 +135,92 @@ bool fossil_queue_is_empty(const fossil_queue_t* queue) {
 bool fossil_queue_is_cnullptr(const fossil_queue_t* queue) {
     return queue == cnullptr;
 }
+
+// Find the node linked before target, or the last node when target is null.
+static fossil_queue_node_t* fossil_queue_node_before(const fossil_queue_t* queue, const fossil_queue_node_t* target) {
+    fossil_queue_node_t* prev = cnullptr;
+    for (fossil_queue_node_t* node = queue->front; node != target; node = node->next) {
+        prev = node;
+    }
+    return prev;
+}
+
+fossil_queue_cursor_t fossil_queue_cursor_begin(fossil_queue_t* queue) {
+    fossil_queue_cursor_t cursor = { queue, queue->front, cnullptr };
+    return cursor;
+}
+
+fossil_queue_cursor_t fossil_queue_cursor_end(fossil_queue_t* queue) {
+    fossil_queue_cursor_t cursor = { queue, cnullptr, queue->rear };
+    return cursor;
+}
+
+bool fossil_queue_cursor_valid(const fossil_queue_cursor_t* cursor) {
+    return cursor->node != cnullptr;
+}
+
+void fossil_queue_cursor_next(fossil_queue_cursor_t* cursor) {
+    if (cursor->node) {
+        cursor->prev = cursor->node;
+        cursor->node = cursor->node->next;
+    }
+}
+
+void fossil_queue_cursor_prev(fossil_queue_cursor_t* cursor) {
+    if (cursor->node == cursor->queue->front) {
+        *cursor = fossil_queue_cursor_end(cursor->queue);  // Before the front wraps to the end
+        return;
+    }
+    cursor->node = cursor->prev;
+    cursor->prev = fossil_queue_node_before(cursor->queue, cursor->node);
+}
+
+fossil_tofu_t* fossil_queue_cursor_deref(const fossil_queue_cursor_t* cursor) {
+    return cursor->node ? &cursor->node->data : cnullptr;
+}
+
+int32_t fossil_queue_cursor_insert_after(fossil_queue_cursor_t* cursor, fossil_tofu_t data) {
+    if (!cursor->node) {
+        return -1;  // Cursor is at the end
+    }
+
+    fossil_queue_node_t* new_node = (fossil_queue_node_t*)malloc(sizeof(fossil_queue_node_t));
+    if (!new_node) {
+        return -1;  // Allocation failed
+    }
+
+    new_node->data = data;
+    new_node->next = cursor->node->next;
+    cursor->node->next = new_node;
+    if (cursor->queue->rear == cursor->node) {
+        cursor->queue->rear = new_node;
+    }
+    return 0;  // Success
+}
+
+int32_t fossil_queue_cursor_erase(fossil_queue_cursor_t* cursor, fossil_tofu_t* data) {
+    if (!cursor->node) {
+        return -1;  // Cursor is at the end
+    }
+
+    fossil_queue_node_t* node_to_remove = cursor->node;
+    if (cursor->prev) {
+        cursor->prev->next = node_to_remove->next;
+    } else {
+        cursor->queue->front = node_to_remove->next;
+    }
+    if (cursor->queue->rear == node_to_remove) {
+        cursor->queue->rear = cursor->prev;
+    }
+    cursor->node = node_to_remove->next;
+    *data = node_to_remove->data;
+    free(node_to_remove);
+    return 0;  // Success
+}
+
+fossil_tofu_iteratorof_t fossil_queue_cursor_span(const fossil_queue_cursor_t* cursor) {
+    if (!cursor->node) {
+        return fossil_tofu_iteratorof_create(cnullptr, 0);
+    }
+    return fossil_tofu_iteratorof_create(&cursor->node->data, 1);
+}
@@ -0,0 +1,1068 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L // for mmap and fstat
+#endif
+#include "fossil/structure/serialize.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#define FOSSIL_SERIALIZE_STAGE 4096
+#define FOSSIL_SERIALIZE_RESERVE ((size_t)1 << 20) // Most elements or characters reserved up front from a stream
+
+static const uint8_t fossil_serialize_magic[4] = { 'F', 'O', 'S', 'L' };
+
+// Staged writer over a stream
+typedef struct {
+    fossil_fstream_t* stream;
+    uint8_t stage[FOSSIL_SERIALIZE_STAGE];
+    size_t length;
+    bool failed;
+} fossil_serialize_writer_t;
+
+// Reader over a stream or a buffer
+typedef struct {
+    fossil_fstream_t* stream;          // Stream source, null when reading a buffer
+    fossil_serialize_buffer_t* buffer; // Buffer source, null when reading a stream
+    size_t start;                      // Buffer offset of the record, restored on failure
+    uint8_t stage[FOSSIL_SERIALIZE_STAGE];
+    size_t length;                     // Staged bytes
+    size_t position;                   // Staged bytes consumed
+    size_t consumed;                   // Bytes consumed since the reader was opened
+    bool failed;
+} fossil_serialize_reader_t;
+
+// *****************************************************************************
+// Encoding helpers
+// *****************************************************************************
+
+static size_t fossil_serialize_encode_varint(uint8_t* out, uint64_t value) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        out[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = (uint8_t)value;
+    return length;
+}
+
+static uint64_t fossil_serialize_zigzag(int64_t value) {
+    return value < 0 ? ~((uint64_t)value << 1) : (uint64_t)value << 1;
+}
+
+static int64_t fossil_serialize_unzigzag(uint64_t value) {
+    return (int64_t)((value >> 1) ^ (~(value & 1) + 1));
+}
+
+static bool fossil_serialize_is_string(fossil_tofu_type_t type) {
+    return type == FOSSIL_TOFU_TYPE_BSTR || type == FOSSIL_TOFU_TYPE_CSTR || type == FOSSIL_TOFU_TYPE_BCHAR;
+}
+
+static char* fossil_serialize_string_of(const fossil_tofu_t* tofu) {
+    switch (tofu->type) {
+        case FOSSIL_TOFU_TYPE_BSTR:
+            return tofu->value.byte_string_val;
+        case FOSSIL_TOFU_TYPE_CSTR:
+            return tofu->value.c_string_val;
+        default:
+            return (char*)tofu->value.byte_val;
+    }
+}
+
+// *****************************************************************************
+// Writer
+// *****************************************************************************
+
+static void fossil_serialize_writer_init(fossil_serialize_writer_t* writer, fossil_fstream_t* stream) {
+    writer->stream = stream;
+    writer->length = 0;
+    writer->failed = stream == cnullptr || stream->file == cnullptr;
+}
+
+static void fossil_serialize_writer_flush(fossil_serialize_writer_t* writer) {
+    if (writer->failed || writer->length == 0) {
+        return;
+    }
+    // The stream reports errors as negative codes cast to size_t, so only an exact count is success
+    if (fossil_fstream_write(writer->stream, writer->stage, 1, writer->length) != writer->length) {
+        writer->failed = true;
+    }
+    writer->length = 0;
+}
+
+static void fossil_serialize_write_bytes(fossil_serialize_writer_t* writer, const void* data, size_t size) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    while (size > 0 && !writer->failed) {
+        if (writer->length == FOSSIL_SERIALIZE_STAGE) {
+            fossil_serialize_writer_flush(writer);
+            continue;
+        }
+        size_t chunk = FOSSIL_SERIALIZE_STAGE - writer->length;
+        if (chunk > size) {
+            chunk = size;
+        }
+        memcpy(writer->stage + writer->length, bytes, chunk);
+        writer->length += chunk;
+        bytes += chunk;
+        size -= chunk;
+    }
+}
+
+static void fossil_serialize_write_byte(fossil_serialize_writer_t* writer, uint8_t value) {
+    fossil_serialize_write_bytes(writer, &value, 1);
+}
+
+static void fossil_serialize_write_varint(fossil_serialize_writer_t* writer, uint64_t value) {
+    uint8_t bytes[10];
+    fossil_serialize_write_bytes(writer, bytes, fossil_serialize_encode_varint(bytes, value));
+}
+
+static void fossil_serialize_write_fixed(fossil_serialize_writer_t* writer, uint64_t value, size_t size) {
+    uint8_t bytes[8];
+    for (size_t i = 0; i < size; i++) {
+        bytes[i] = (uint8_t)(value >> (8 * i));
+    }
+    fossil_serialize_write_bytes(writer, bytes, size);
+}
+
+static void fossil_serialize_write_header(fossil_serialize_writer_t* writer, fossil_serialize_kind_t kind, size_t count) {
+    uint8_t header[32];
+    size_t length = fossil_serialize_encode_varint(header, FOSSIL_SERIALIZE_VERSION);
+    length += fossil_serialize_encode_varint(header + length, (uint64_t)kind);
+    length += fossil_serialize_encode_varint(header + length, (uint64_t)count);
+
+    fossil_serialize_write_bytes(writer, fossil_serialize_magic, sizeof(fossil_serialize_magic));
+    fossil_serialize_write_varint(writer, length);
+    fossil_serialize_write_bytes(writer, header, length);
+}
+
+static void fossil_serialize_write_tofu(fossil_serialize_writer_t* writer, const fossil_tofu_t* tofu) {
+    if ((uint32_t)tofu->type > FOSSIL_TOFU_TYPE_BOOL) {
+        writer->failed = true;
+        return;
+    }
+    fossil_serialize_write_byte(writer, (uint8_t)tofu->type);
+
+    switch (tofu->type) {
+        case FOSSIL_TOFU_TYPE_INT:
+            fossil_serialize_write_varint(writer, fossil_serialize_zigzag(tofu->value.int_val));
+            break;
+        case FOSSIL_TOFU_TYPE_UINT:
+        case FOSSIL_TOFU_TYPE_HEX:
+        case FOSSIL_TOFU_TYPE_OCTAL:
+        case FOSSIL_TOFU_TYPE_SIZE:
+            fossil_serialize_write_varint(writer, tofu->value.uint_val);
+            break;
+        case FOSSIL_TOFU_TYPE_FLOAT: {
+            uint32_t bits;
+            memcpy(&bits, &tofu->value.float_val, sizeof(bits));
+            fossil_serialize_write_fixed(writer, bits, sizeof(bits));
+            break;
+        }
+        case FOSSIL_TOFU_TYPE_DOUBLE: {
+            uint64_t bits;
+            memcpy(&bits, &tofu->value.double_val, sizeof(bits));
+            fossil_serialize_write_fixed(writer, bits, sizeof(bits));
+            break;
+        }
+        case FOSSIL_TOFU_TYPE_BSTR:
+        case FOSSIL_TOFU_TYPE_CSTR:
+        case FOSSIL_TOFU_TYPE_BCHAR: {
+            const char* string = fossil_serialize_string_of(tofu);
+            size_t length = string ? strlen(string) : 0;
+            fossil_serialize_write_varint(writer, length);
+            if (length > 0) {
+                fossil_serialize_write_bytes(writer, string, length);
+            }
+            fossil_serialize_write_byte(writer, 0);
+            break;
+        }
+        case FOSSIL_TOFU_TYPE_WSTR: {
+            const wchar_t* string = tofu->value.wide_string_val;
+            size_t length = string ? wcslen(string) : 0;
+            fossil_serialize_write_varint(writer, length);
+            for (size_t i = 0; i < length; i++) {
+                fossil_serialize_write_varint(writer, (uint32_t)string[i]);
+            }
+            break;
+        }
+        case FOSSIL_TOFU_TYPE_CCHAR:
+            fossil_serialize_write_byte(writer, (uint8_t)tofu->value.char_val);
+            break;
+        case FOSSIL_TOFU_TYPE_WCHAR:
+            fossil_serialize_write_varint(writer, (uint32_t)tofu->value.wchar_val);
+            break;
+        case FOSSIL_TOFU_TYPE_BOOL:
+            fossil_serialize_write_byte(writer, tofu->value.bool_val ? 1 : 0);
+            break;
+        default:
+            // Ghosts carry no payload
+            break;
+    }
+}
+
+static int32_t fossil_serialize_writer_finish(fossil_serialize_writer_t* writer) {
+    fossil_serialize_writer_flush(writer);
+    return writer->failed ? -1 : 0;
+}
+
+// *****************************************************************************
+// Reader
+// *****************************************************************************
+
+static void fossil_serialize_reader_stream(fossil_serialize_reader_t* reader, fossil_fstream_t* stream) {
+    reader->stream = stream;
+    reader->buffer = cnullptr;
+    reader->start = 0;
+    reader->length = 0;
+    reader->position = 0;
+    reader->consumed = 0;
+    reader->failed = stream == cnullptr || stream->file == cnullptr;
+}
+
+static void fossil_serialize_reader_buffer(fossil_serialize_reader_t* reader, fossil_serialize_buffer_t* buffer) {
+    reader->stream = cnullptr;
+    reader->buffer = buffer;
+    reader->start = buffer ? buffer->offset : 0;
+    reader->length = 0;
+    reader->position = 0;
+    reader->consumed = 0;
+    reader->failed = buffer == cnullptr || buffer->offset > buffer->size;
+}
+
+// Bytes a buffer reader has left, or SIZE_MAX for a stream
+static size_t fossil_serialize_remaining(const fossil_serialize_reader_t* reader) {
+    if (reader->buffer == cnullptr) {
+        return SIZE_MAX;
+    }
+    return reader->buffer->size - reader->buffer->offset;
+}
+
+static void fossil_serialize_read_bytes(fossil_serialize_reader_t* reader, void* data, size_t size) {
+    if (reader->failed) {
+        return;
+    }
+
+    if (reader->buffer) {
+        if (size > fossil_serialize_remaining(reader)) {
+            reader->failed = true;
+            return;
+        }
+        if (data) {
+            memcpy(data, reader->buffer->data + reader->buffer->offset, size);
+        }
+        reader->buffer->offset += size;
+        reader->consumed += size;
+        return;
+    }
+
+    uint8_t* bytes = (uint8_t*)data;
+    while (size > 0) {
+        if (reader->position == reader->length) {
+            size_t count = fossil_fstream_read(reader->stream, reader->stage, 1, FOSSIL_SERIALIZE_STAGE);
+            if (count == 0 || count > FOSSIL_SERIALIZE_STAGE) {
+                // End of stream or read error
+                reader->failed = true;
+                return;
+            }
+            reader->length = count;
+            reader->position = 0;
+        }
+        size_t chunk = reader->length - reader->position;
+        if (chunk > size) {
+            chunk = size;
+        }
+        if (bytes) {
+            memcpy(bytes, reader->stage + reader->position, chunk);
+            bytes += chunk;
+        }
+        reader->position += chunk;
+        reader->consumed += chunk;
+        size -= chunk;
+    }
+}
+
+static uint8_t fossil_serialize_read_byte(fossil_serialize_reader_t* reader) {
+    uint8_t value = 0;
+    fossil_serialize_read_bytes(reader, &value, 1);
+    return value;
+}
+
+static uint64_t fossil_serialize_read_varint(fossil_serialize_reader_t* reader) {
+    uint64_t value = 0;
+    for (uint32_t shift = 0; shift < 64 && !reader->failed; shift += 7) {
+        uint8_t byte = fossil_serialize_read_byte(reader);
+        if (shift == 63 && byte > 1) {
+            break; // Overflows 64 bits
+        }
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+    reader->failed = true;
+    return 0;
+}
+
+static uint64_t fossil_serialize_read_fixed(fossil_serialize_reader_t* reader, size_t size) {
+    uint8_t bytes[8] = { 0 };
+    uint64_t value = 0;
+    fossil_serialize_read_bytes(reader, bytes, size);
+    for (size_t i = 0; i < size; i++) {
+        value |= (uint64_t)bytes[i] << (8 * i);
+    }
+    return value;
+}
+
+// Read a length-prefixed string, borrowing it from a buffer or copying it from a stream
+static char* fossil_serialize_read_string(fossil_serialize_reader_t* reader) {
+    uint64_t length = fossil_serialize_read_varint(reader);
+    if (reader->failed || length >= fossil_serialize_remaining(reader)) {
+        reader->failed = true;
+        return cnullptr;
+    }
+
+    if (reader->buffer) {
+        char* string = (char*)(reader->buffer->data + reader->buffer->offset);
+        if (string[length] != '\0' || memchr(string, '\0', (size_t)length) != cnullptr) {
+            reader->failed = true;
+            return cnullptr;
+        }
+        fossil_serialize_read_bytes(reader, cnullptr, (size_t)length + 1);
+        return string;
+    }
+
+    // A stream cannot vouch for the length, so the copy only grows as bytes arrive
+    size_t total = (size_t)length + 1;
+    size_t capacity = total < FOSSIL_SERIALIZE_RESERVE ? total : FOSSIL_SERIALIZE_RESERVE;
+    char* string = (char*)malloc(capacity);
+    if (string == cnullptr) {
+        reader->failed = true;
+        return cnullptr;
+    }
+    fossil_serialize_read_bytes(reader, string, capacity);
+    while (capacity < total && !reader->failed) {
+        size_t grown = capacity > total / 2 ? total : capacity * 2;
+        char* larger = (char*)realloc(string, grown);
+        if (larger == cnullptr) {
+            free(string);
+            reader->failed = true;
+            return cnullptr;
+        }
+        string = larger;
+        fossil_serialize_read_bytes(reader, string + capacity, grown - capacity);
+        capacity = grown;
+    }
+    if (reader->failed || string[length] != '\0' || memchr(string, '\0', (size_t)length) != cnullptr) {
+        free(string);
+        reader->failed = true;
+        return cnullptr;
+    }
+    return string;
+}
+
+static wchar_t* fossil_serialize_read_wide(fossil_serialize_reader_t* reader) {
+    uint64_t length = fossil_serialize_read_varint(reader);
+    if (reader->failed || length > fossil_serialize_remaining(reader) || length >= SIZE_MAX / sizeof(wchar_t)) {
+        reader->failed = true;
+        return cnullptr;
+    }
+
+    // Every code point takes at least a byte, but a stream cannot vouch for the length either
+    size_t capacity = length < FOSSIL_SERIALIZE_RESERVE ? (size_t)length : FOSSIL_SERIALIZE_RESERVE;
+    wchar_t* string = (wchar_t*)malloc((capacity + 1) * sizeof(wchar_t));
+    if (string == cnullptr) {
+        reader->failed = true;
+        return cnullptr;
+    }
+    for (size_t i = 0; i < length; i++) {
+        if (i == capacity) {
+            capacity = capacity > length / 2 ? (size_t)length : capacity * 2;
+            wchar_t* larger = (wchar_t*)realloc(string, (capacity + 1) * sizeof(wchar_t));
+            if (larger == cnullptr) {
+                free(string);
+                reader->failed = true;
+                return cnullptr;
+            }
+            string = larger;
+        }
+        uint64_t code = fossil_serialize_read_varint(reader);
+        if (reader->failed || code == 0 || code > UINT32_MAX) {
+            free(string);
+            reader->failed = true;
+            return cnullptr;
+        }
+        string[i] = (wchar_t)code;
+    }
+    string[length] = L'\0';
+    return string;
+}
+
+static void fossil_serialize_read_tofu(fossil_serialize_reader_t* reader, fossil_tofu_t* tofu) {
+    memset(tofu, 0, sizeof(*tofu));
+    uint8_t type = fossil_serialize_read_byte(reader);
+    if (reader->failed || type > FOSSIL_TOFU_TYPE_BOOL) {
+        reader->failed = true;
+        return;
+    }
+    tofu->type = (fossil_tofu_type_t)type;
+    tofu->is_cached = false;
+
+    switch (tofu->type) {
+        case FOSSIL_TOFU_TYPE_INT:
+            tofu->value.int_val = fossil_serialize_unzigzag(fossil_serialize_read_varint(reader));
+            break;
+        case FOSSIL_TOFU_TYPE_UINT:
+        case FOSSIL_TOFU_TYPE_HEX:
+        case FOSSIL_TOFU_TYPE_OCTAL:
+        case FOSSIL_TOFU_TYPE_SIZE:
+            tofu->value.uint_val = fossil_serialize_read_varint(reader);
+            break;
+        case FOSSIL_TOFU_TYPE_FLOAT: {
+            uint32_t bits = (uint32_t)fossil_serialize_read_fixed(reader, sizeof(bits));
+            memcpy(&tofu->value.float_val, &bits, sizeof(bits));
+            break;
+        }
+        case FOSSIL_TOFU_TYPE_DOUBLE: {
+            uint64_t bits = fossil_serialize_read_fixed(reader, sizeof(bits));
+            memcpy(&tofu->value.double_val, &bits, sizeof(bits));
+            break;
+        }
+        case FOSSIL_TOFU_TYPE_BSTR:
+            tofu->value.byte_string_val = fossil_serialize_read_string(reader);
+            break;
+        case FOSSIL_TOFU_TYPE_CSTR:
+            tofu->value.c_string_val = fossil_serialize_read_string(reader);
+            break;
+        case FOSSIL_TOFU_TYPE_BCHAR:
+            tofu->value.byte_val = (uint8_t*)fossil_serialize_read_string(reader);
+            break;
+        case FOSSIL_TOFU_TYPE_WSTR:
+            tofu->value.wide_string_val = fossil_serialize_read_wide(reader);
+            break;
+        case FOSSIL_TOFU_TYPE_CCHAR:
+            tofu->value.char_val = (char)fossil_serialize_read_byte(reader);
+            break;
+        case FOSSIL_TOFU_TYPE_WCHAR: {
+            uint64_t code = fossil_serialize_read_varint(reader);
+            if (code > UINT32_MAX) {
+                reader->failed = true;
+            }
+            tofu->value.wchar_val = (wchar_t)code;
+            break;
+        }
+        case FOSSIL_TOFU_TYPE_BOOL:
+            tofu->value.bool_val = fossil_serialize_read_byte(reader) != 0;
+            break;
+        default:
+            // Ghosts carry no payload
+            break;
+    }
+}
+
+// Free what a decoded tofu owns; strings viewed in a buffer are borrowed
+static void fossil_serialize_release(const fossil_serialize_reader_t* reader, fossil_tofu_t* tofu) {
+    if (reader->buffer && fossil_serialize_is_string(tofu->type)) {
+        return;
+    }
+    fossil_tofu_erase(tofu);
+}
+
+// Read and check a record header, returning the element count
+static size_t fossil_serialize_read_header(fossil_serialize_reader_t* reader, fossil_serialize_kind_t kind) {
+    uint8_t magic[sizeof(fossil_serialize_magic)];
+    fossil_serialize_read_bytes(reader, magic, sizeof(magic));
+    if (reader->failed || memcmp(magic, fossil_serialize_magic, sizeof(magic)) != 0) {
+        reader->failed = true;
+        return 0;
+    }
+
+    uint64_t length = fossil_serialize_read_varint(reader);
+    size_t start = reader->consumed;
+    uint64_t version = fossil_serialize_read_varint(reader);
+    uint64_t found = fossil_serialize_read_varint(reader);
+    uint64_t count = fossil_serialize_read_varint(reader);
+    size_t used = reader->consumed - start;
+    if (reader->failed || used > length || version == 0 || version > FOSSIL_SERIALIZE_VERSION ||
+        found != (uint64_t)kind || count > SIZE_MAX) {
+        reader->failed = true;
+        return 0;
+    }
+
+    // Skip header fields added by newer writers
+    uint64_t extra = length - used;
+    if (extra > fossil_serialize_remaining(reader)) {
+        reader->failed = true;
+        return 0;
+    }
+    uint8_t scratch[64];
+    while (extra > 0 && !reader->failed) {
+        size_t chunk = extra > sizeof(scratch) ? sizeof(scratch) : (size_t)extra;
+        fossil_serialize_read_bytes(reader, scratch, chunk);
+        extra -= chunk;
+    }
+
+    // Every element takes at least a type byte
+    size_t width = kind == FOSSIL_SERIALIZE_MAPOF ? 2 : 1;
+    if (count > fossil_serialize_remaining(reader) / width) {
+        reader->failed = true;
+        return 0;
+    }
+    return (size_t)count;
+}
+
+// Give unread staged bytes back to the stream, or rewind the buffer after a failure
+static int32_t fossil_serialize_reader_finish(fossil_serialize_reader_t* reader) {
+    if (reader->stream && reader->position < reader->length) {
+        int64_t unread = (int64_t)(reader->length - reader->position);
+        if (fossil_fstream_seek(reader->stream, -unread, SEEK_CUR) != 0) {
+            reader->failed = true;
+        }
+        reader->length = 0;
+        reader->position = 0;
+    }
+    if (reader->buffer && reader->failed) {
+        reader->buffer->offset = reader->start;
+    }
+    return reader->failed ? -1 : 0;
+}
+
+static size_t fossil_serialize_reserve(const fossil_serialize_reader_t* reader, size_t count) {
+    if (reader->stream && count > FOSSIL_SERIALIZE_RESERVE) {
+        return FOSSIL_SERIALIZE_RESERVE;
+    }
+    return count;
+}
+
+// *****************************************************************************
+// Buffer functions
+// *****************************************************************************
+
+void fossil_serialize_buffer_init(fossil_serialize_buffer_t* buffer, const void* data, size_t size) {
+    if (buffer == cnullptr) return;
+
+    buffer->data = (const uint8_t*)data;
+    buffer->size = data ? size : 0;
+    buffer->offset = 0;
+    buffer->mapping = cnullptr;
+}
+
+int32_t fossil_serialize_buffer_map(fossil_serialize_buffer_t* buffer, const char* filename) {
+    if (buffer == cnullptr || filename == cnullptr) {
+        return -1;
+    }
+    fossil_serialize_buffer_init(buffer, cnullptr, 0);
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, cnullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, cnullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return -1;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || (uint64_t)size.QuadPart > SIZE_MAX) {
+        CloseHandle(file);
+        return -1;
+    }
+    if (size.QuadPart == 0) {
+        CloseHandle(file);
+        return 0;
+    }
+    HANDLE mapping = CreateFileMappingA(file, cnullptr, PAGE_READONLY, 0, 0, cnullptr);
+    CloseHandle(file);
+    if (mapping == cnullptr) {
+        return -1;
+    }
+    // The view keeps the mapping object alive after its handle is closed
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (view == cnullptr) {
+        return -1;
+    }
+    buffer->data = (const uint8_t*)view;
+    buffer->size = (size_t)size.QuadPart;
+    buffer->mapping = view;
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < 0 || (uint64_t)info.st_size > SIZE_MAX) {
+        close(fd);
+        return -1;
+    }
+    if (info.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+    void* view = mmap(cnullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) {
+        return -1;
+    }
+    buffer->data = (const uint8_t*)view;
+    buffer->size = (size_t)info.st_size;
+    buffer->mapping = view;
+#endif
+    return 0;
+}
+
+void fossil_serialize_buffer_unmap(fossil_serialize_buffer_t* buffer) {
+    if (buffer == cnullptr) return;
+
+    if (buffer->mapping) {
+#ifdef _WIN32
+        UnmapViewOfFile(buffer->mapping);
+#else
+        munmap(buffer->mapping, buffer->size);
+#endif
+    }
+    fossil_serialize_buffer_init(buffer, cnullptr, 0);
+}
+
+// *****************************************************************************
+// Tofu functions
+// *****************************************************************************
+
+int32_t fossil_serialize_save_tofu(fossil_fstream_t* stream, fossil_tofu_t tofu) {
+    fossil_serialize_writer_t* writer = (fossil_serialize_writer_t*)malloc(sizeof(fossil_serialize_writer_t));
+    if (writer == cnullptr) {
+        return -1;
+    }
+    fossil_serialize_writer_init(writer, stream);
+    fossil_serialize_write_header(writer, FOSSIL_SERIALIZE_TOFU, 1);
+    fossil_serialize_write_tofu(writer, &tofu);
+
+    int32_t result = fossil_serialize_writer_finish(writer);
+    free(writer);
+    return result;
+}
+
+static int32_t fossil_serialize_read_single(fossil_serialize_reader_t* reader, fossil_tofu_t* tofu) {
+    if (tofu == cnullptr) {
+        reader->failed = true;
+    }
+    size_t count = fossil_serialize_read_header(reader, FOSSIL_SERIALIZE_TOFU);
+    if (!reader->failed && count != 1) {
+        reader->failed = true;
+    }
+
+    fossil_tofu_t element = { 0 };
+    if (!reader->failed) {
+        fossil_serialize_read_tofu(reader, &element);
+        if (reader->failed) {
+            fossil_serialize_release(reader, &element);
+        }
+    }
+    if (fossil_serialize_reader_finish(reader) != 0) {
+        return -1;
+    }
+    *tofu = element;
+    return 0;
+}
+
+int32_t fossil_serialize_load_tofu(fossil_fstream_t* stream, fossil_tofu_t* tofu) {
+    fossil_serialize_reader_t* reader = (fossil_serialize_reader_t*)malloc(sizeof(fossil_serialize_reader_t));
+    if (reader == cnullptr) {
+        return -1;
+    }
+    fossil_serialize_reader_stream(reader, stream);
+
+    int32_t result = fossil_serialize_read_single(reader, tofu);
+    free(reader);
+    return result;
+}
+
+int32_t fossil_serialize_view_tofu(fossil_serialize_buffer_t* buffer, fossil_tofu_t* tofu) {
+    fossil_serialize_reader_t reader;
+    fossil_serialize_reader_buffer(&reader, buffer);
+    return fossil_serialize_read_single(&reader, tofu);
+}
+
+// *****************************************************************************
+// Container functions
+// *****************************************************************************
+
+// Save the elements of a contiguous array as a record
+static int32_t fossil_serialize_save_array(fossil_fstream_t* stream, fossil_serialize_kind_t kind, const fossil_tofu_t* data, size_t count) {
+    fossil_serialize_writer_t* writer = (fossil_serialize_writer_t*)malloc(sizeof(fossil_serialize_writer_t));
+    if (writer == cnullptr) {
+        return -1;
+    }
+    fossil_serialize_writer_init(writer, stream);
+    fossil_serialize_write_header(writer, kind, count);
+    for (size_t i = 0; i < count && !writer->failed; i++) {
+        fossil_serialize_write_tofu(writer, &data[i]);
+    }
+
+    int32_t result = fossil_serialize_writer_finish(writer);
+    free(writer);
+    return result;
+}
+
+// Read the elements of a record into a vector
+static void fossil_serialize_read_elements(fossil_serialize_reader_t* reader, fossil_serialize_kind_t kind, fossil_vector_t* items, bool ascending) {
+    size_t count = fossil_serialize_read_header(reader, kind);
+    if (reader->failed) {
+        return;
+    }
+    if (fossil_vector_reserve(items, fossil_serialize_reserve(reader, count)) != 0) {
+        reader->failed = true;
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        fossil_tofu_t element;
+        fossil_serialize_read_tofu(reader, &element);
+        if (!reader->failed && ascending && items->size > 0 &&
+            fossil_flatset_compare(items->data[items->size - 1], element) >= 0) {
+            reader->failed = true; // Out of order or duplicate
+        }
+        if (reader->failed || fossil_vector_insert(items, items->size, element) != 0) {
+            fossil_serialize_release(reader, &element);
+            reader->failed = true;
+            break;
+        }
+    }
+
+    if (reader->failed) {
+        for (size_t i = 0; i < items->size; i++) {
+            fossil_serialize_release(reader, &items->data[i]);
+        }
+        items->size = 0;
+    }
+}
+
+static fossil_vector_t* fossil_serialize_read_vector(fossil_serialize_reader_t* reader, char* type) {
+    fossil_vector_t* vector = fossil_vector_create(type);
+    if (vector == cnullptr) {
+        reader->failed = true;
+    } else {
+        fossil_serialize_read_elements(reader, FOSSIL_SERIALIZE_VECTOR, vector, false);
+    }
+    if (fossil_serialize_reader_finish(reader) != 0) {
+        fossil_vector_erase(vector);
+        return cnullptr;
+    }
+    return vector;
+}
+
+int32_t fossil_serialize_save_vector(fossil_fstream_t* stream, const fossil_vector_t* vector) {
+    if (vector == cnullptr) {
+        return -1;
+    }
+    return fossil_serialize_save_array(stream, FOSSIL_SERIALIZE_VECTOR, vector->data, vector->size);
+}
+
+fossil_vector_t* fossil_serialize_load_vector(fossil_fstream_t* stream, char* type) {
+    fossil_serialize_reader_t* reader = (fossil_serialize_reader_t*)malloc(sizeof(fossil_serialize_reader_t));
+    if (reader == cnullptr) {
+        return cnullptr;
+    }
+    fossil_serialize_reader_stream(reader, stream);
+
+    fossil_vector_t* vector = fossil_serialize_read_vector(reader, type);
+    free(reader);
+    return vector;
+}
+
+fossil_vector_t* fossil_serialize_view_vector(fossil_serialize_buffer_t* buffer, char* type) {
+    fossil_serialize_reader_t reader;
+    fossil_serialize_reader_buffer(&reader, buffer);
+    return fossil_serialize_read_vector(&reader, type);
+}
+
+int32_t fossil_serialize_save_set(fossil_fstream_t* stream, const fossil_set_t* set) {
+    if (set == cnullptr) {
+        return -1;
+    }
+    fossil_serialize_writer_t* writer = (fossil_serialize_writer_t*)malloc(sizeof(fossil_serialize_writer_t));
+    if (writer == cnullptr) {
+        return -1;
+    }
+    size_t count = 0;
+    for (const fossil_set_node_t* node = set->head; node; node = node->next) {
+        count++;
+    }
+
+    fossil_serialize_writer_init(writer, stream);
+    fossil_serialize_write_header(writer, FOSSIL_SERIALIZE_SET, count);
+    for (const fossil_set_node_t* node = set->head; node && !writer->failed; node = node->next) {
+        fossil_serialize_write_tofu(writer, &node->data);
+    }
+
+    int32_t result = fossil_serialize_writer_finish(writer);
+    free(writer);
+    return result;
+}
+
+static fossil_set_t* fossil_serialize_read_set(fossil_serialize_reader_t* reader, char* type) {
+    fossil_set_t* set = fossil_set_create(type);
+    size_t count = 0;
+    if (set == cnullptr) {
+        reader->failed = true;
+    } else {
+        count = fossil_serialize_read_header(reader, FOSSIL_SERIALIZE_SET);
+    }
+
+    // Link the nodes in saved order; the writer's set already held no duplicates
+    fossil_set_node_t** tail = set ? &set->head : cnullptr;
+    for (size_t i = 0; i < count && !reader->failed; i++) {
+        fossil_set_node_t* node = (fossil_set_node_t*)malloc(sizeof(fossil_set_node_t));
+        if (node == cnullptr) {
+            reader->failed = true;
+            break;
+        }
+        fossil_serialize_read_tofu(reader, &node->data);
+        if (reader->failed) {
+            fossil_serialize_release(reader, &node->data);
+            free(node);
+            break;
+        }
+        node->next = cnullptr;
+        *tail = node;
+        tail = &node->next;
+    }
+
+    if (fossil_serialize_reader_finish(reader) != 0) {
+        if (set) {
+            for (fossil_set_node_t* node = set->head; node; node = node->next) {
+                fossil_serialize_release(reader, &node->data);
+            }
+            fossil_set_erase(set);
+        }
+        return cnullptr;
+    }
+    return set;
+}
+
+fossil_set_t* fossil_serialize_load_set(fossil_fstream_t* stream, char* type) {
+    fossil_serialize_reader_t* reader = (fossil_serialize_reader_t*)malloc(sizeof(fossil_serialize_reader_t));
+    if (reader == cnullptr) {
+        return cnullptr;
+    }
+    fossil_serialize_reader_stream(reader, stream);
+
+    fossil_set_t* set = fossil_serialize_read_set(reader, type);
+    free(reader);
+    return set;
+}
+
+fossil_set_t* fossil_serialize_view_set(fossil_serialize_buffer_t* buffer, char* type) {
+    fossil_serialize_reader_t reader;
+    fossil_serialize_reader_buffer(&reader, buffer);
+    return fossil_serialize_read_set(&reader, type);
+}
+
+int32_t fossil_serialize_save_queue(fossil_fstream_t* stream, const fossil_queue_t* queue) {
+    if (queue == cnullptr) {
+        return -1;
+    }
+    fossil_serialize_writer_t* writer = (fossil_serialize_writer_t*)malloc(sizeof(fossil_serialize_writer_t));
+    if (writer == cnullptr) {
+        return -1;
+    }
+    size_t count = 0;
+    for (const fossil_queue_node_t* node = queue->front; node; node = node->next) {
+        count++;
+    }
+
+    fossil_serialize_writer_init(writer, stream);
+    fossil_serialize_write_header(writer, FOSSIL_SERIALIZE_QUEUE, count);
+    for (const fossil_queue_node_t* node = queue->front; node && !writer->failed; node = node->next) {
+        fossil_serialize_write_tofu(writer, &node->data);
+    }
+
+    int32_t result = fossil_serialize_writer_finish(writer);
+    free(writer);
+    return result;
+}
+
+static fossil_queue_t* fossil_serialize_read_queue(fossil_serialize_reader_t* reader, char* type) {
+    fossil_queue_t* queue = fossil_queue_create(type);
+    size_t count = 0;
+    if (queue == cnullptr) {
+        reader->failed = true;
+    } else {
+        count = fossil_serialize_read_header(reader, FOSSIL_SERIALIZE_QUEUE);
+    }
+
+    for (size_t i = 0; i < count && !reader->failed; i++) {
+        fossil_tofu_t element;
+        fossil_serialize_read_tofu(reader, &element);
+        if (reader->failed || fossil_queue_insert(queue, element) != 0) {
+            fossil_serialize_release(reader, &element);
+            reader->failed = true;
+        }
+    }
+
+    if (fossil_serialize_reader_finish(reader) != 0) {
+        if (queue) {
+            for (fossil_queue_node_t* node = queue->front; node; node = node->next) {
+                fossil_serialize_release(reader, &node->data);
+            }
+            fossil_queue_erase(queue);
+        }
+        return cnullptr;
+    }
+    return queue;
+}
+
+fossil_queue_t* fossil_serialize_load_queue(fossil_fstream_t* stream, char* type) {
+    fossil_serialize_reader_t* reader = (fossil_serialize_reader_t*)malloc(sizeof(fossil_serialize_reader_t));
+    if (reader == cnullptr) {
+        return cnullptr;
+    }
+    fossil_serialize_reader_stream(reader, stream);
+
+    fossil_queue_t* queue = fossil_serialize_read_queue(reader, type);
+    free(reader);
+    return queue;
+}
+
+fossil_queue_t* fossil_serialize_view_queue(fossil_serialize_buffer_t* buffer, char* type) {
+    fossil_serialize_reader_t reader;
+    fossil_serialize_reader_buffer(&reader, buffer);
+    return fossil_serialize_read_queue(&reader, type);
+}
+
+int32_t fossil_serialize_save_mapof(fossil_fstream_t* stream, const fossil_tofu_mapof_t* map) {
+    if (map == cnullptr) {
+        return -1;
+    }
+    fossil_serialize_writer_t* writer = (fossil_serialize_writer_t*)malloc(sizeof(fossil_serialize_writer_t));
+    if (writer == cnullptr) {
+        return -1;
+    }
+    fossil_serialize_writer_init(writer, stream);
+    fossil_serialize_write_header(writer, FOSSIL_SERIALIZE_MAPOF, map->size);
+    for (size_t i = 0; i < map->size && !writer->failed; i++) {
+        fossil_serialize_write_tofu(writer, &map->keys[i]);
+        fossil_serialize_write_tofu(writer, &map->values[i]);
+    }
+
+    int32_t result = fossil_serialize_writer_finish(writer);
+    free(writer);
+    return result;
+}
+
+static int32_t fossil_serialize_read_mapof(fossil_serialize_reader_t* reader, fossil_tofu_mapof_t* map) {
+    if (map == cnullptr) {
+        reader->failed = true;
+    }
+    size_t count = fossil_serialize_read_header(reader, FOSSIL_SERIALIZE_MAPOF);
+
+    // The map doubles its capacity when full, so it must start with room for one pair
+    size_t capacity = fossil_serialize_reserve(reader, count);
+    fossil_tofu_mapof_t loaded = fossil_tofu_mapof_create(capacity > 0 ? capacity : 1);
+    if (loaded.keys == cnullptr || loaded.values == cnullptr) {
+        reader->failed = true;
+    }
+
+    for (size_t i = 0; i < count && !reader->failed; i++) {
+        fossil_tofu_t key;
+        fossil_tofu_t value;
+        fossil_serialize_read_tofu(reader, &key);
+        if (reader->failed) {
+            fossil_serialize_release(reader, &key);
+            break;
+        }
+        fossil_serialize_read_tofu(reader, &value);
+        if (reader->failed) {
+            fossil_serialize_release(reader, &key);
+            fossil_serialize_release(reader, &value);
+            break;
+        }
+        fossil_tofu_mapof_add(&loaded, key, value);
+    }
+
+    if (fossil_serialize_reader_finish(reader) != 0) {
+        for (size_t i = 0; i < loaded.size; i++) {
+            fossil_serialize_release(reader, &loaded.keys[i]);
+            fossil_serialize_release(reader, &loaded.values[i]);
+        }
+        fossil_tofu_mapof_erase(&loaded);
+        return -1;
+    }
+    *map = loaded;
+    return 0;
+}
+
+int32_t fossil_serialize_load_mapof(fossil_fstream_t* stream, fossil_tofu_mapof_t* map) {
+    fossil_serialize_reader_t* reader = (fossil_serialize_reader_t*)malloc(sizeof(fossil_serialize_reader_t));
+    if (reader == cnullptr) {
+        return -1;
+    }
+    fossil_serialize_reader_stream(reader, stream);
+
+    int32_t result = fossil_serialize_read_mapof(reader, map);
+    free(reader);
+    return result;
+}
+
+int32_t fossil_serialize_view_mapof(fossil_serialize_buffer_t* buffer, fossil_tofu_mapof_t* map) {
+    fossil_serialize_reader_t reader;
+    fossil_serialize_reader_buffer(&reader, buffer);
+    return fossil_serialize_read_mapof(&reader, map);
+}
+
+int32_t fossil_serialize_save_flatset(fossil_fstream_t* stream, const fossil_flatset_t* set) {
+    if (set == cnullptr) {
+        return -1;
+    }
+    return fossil_serialize_save_array(stream, FOSSIL_SERIALIZE_FLATSET, set->items->data, set->items->size);
+}
+
+static fossil_flatset_t* fossil_serialize_read_flatset(fossil_serialize_reader_t* reader, char* type) {
+    fossil_flatset_t* set = fossil_flatset_create(type);
+    if (set == cnullptr) {
+        reader->failed = true;
+    } else {
+        // The elements are already sorted, so they go straight into the items and the index is rebuilt lazily
+        fossil_serialize_read_elements(reader, FOSSIL_SERIALIZE_FLATSET, set->items, true);
+        set->dirty = true;
+    }
+    if (fossil_serialize_reader_finish(reader) != 0) {
+        fossil_flatset_erase(set);
+        return cnullptr;
+    }
+    return set;
+}
+
+fossil_flatset_t* fossil_serialize_load_flatset(fossil_fstream_t* stream, char* type) {
+    fossil_serialize_reader_t* reader = (fossil_serialize_reader_t*)malloc(sizeof(fossil_serialize_reader_t));
+    if (reader == cnullptr) {
+        return cnullptr;
+    }
+    fossil_serialize_reader_stream(reader, stream);
+
+    fossil_flatset_t* set = fossil_serialize_read_flatset(reader, type);
+    free(reader);
+    return set;
+}
+
+fossil_flatset_t* fossil_serialize_view_flatset(fossil_serialize_buffer_t* buffer, char* type) {
+    fossil_serialize_reader_t reader;
+    fossil_serialize_reader_buffer(&reader, buffer);
+    return fossil_serialize_read_flatset(&reader, type);
+}
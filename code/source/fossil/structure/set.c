@@ -134,3 +134,89 @@ bool fossil_set_is_empty(const fossil_set_t* set) {
 bool fossil_set_is_cnullptr(const fossil_set_t* set) {
     return set == cnullptr;
 }
+
+// Find the node linked before target, or the last node when target is null.
+static fossil_set_node_t* fossil_set_node_before(const fossil_set_t* set, const fossil_set_node_t* target) {
+    fossil_set_node_t* prev = cnullptr;
+    for (fossil_set_node_t* node = set->head; node != target; node = node->next) {
+        prev = node;
+    }
+    return prev;
+}
+
+fossil_set_cursor_t fossil_set_cursor_begin(fossil_set_t* set) {
+    fossil_set_cursor_t cursor = { set, set->head, cnullptr };
+    return cursor;
+}
+
+fossil_set_cursor_t fossil_set_cursor_end(fossil_set_t* set) {
+    fossil_set_cursor_t cursor = { set, cnullptr, fossil_set_node_before(set, cnullptr) };
+    return cursor;
+}
+
+bool fossil_set_cursor_valid(const fossil_set_cursor_t* cursor) {
+    return cursor->node != cnullptr;
+}
+
+void fossil_set_cursor_next(fossil_set_cursor_t* cursor) {
+    if (cursor->node) {
+        cursor->prev = cursor->node;
+        cursor->node = cursor->node->next;
+    }
+}
+
+void fossil_set_cursor_prev(fossil_set_cursor_t* cursor) {
+    if (cursor->node == cursor->set->head) {
+        *cursor = fossil_set_cursor_end(cursor->set);  // Before the head wraps to the end
+        return;
+    }
+    cursor->node = cursor->prev;
+    cursor->prev = fossil_set_node_before(cursor->set, cursor->node);
+}
+
+fossil_tofu_t* fossil_set_cursor_deref(const fossil_set_cursor_t* cursor) {
+    return cursor->node ? &cursor->node->data : cnullptr;
+}
+
+int32_t fossil_set_cursor_insert_after(fossil_set_cursor_t* cursor, fossil_tofu_t data) {
+    if (!cursor->node) {
+        return -1;  // Cursor is at the end
+    }
+    if (fossil_set_contains(cursor->set, data)) {
+        return -1;  // Duplicate element, insert fails
+    }
+
+    fossil_set_node_t* new_node = (fossil_set_node_t*)malloc(sizeof(fossil_set_node_t));
+    if (!new_node) {
+        return -1;  // Allocation failed
+    }
+
+    new_node->data = data;
+    new_node->next = cursor->node->next;
+    cursor->node->next = new_node;
+    return 0;  // Success
+}
+
+int32_t fossil_set_cursor_erase(fossil_set_cursor_t* cursor, fossil_tofu_t* data) {
+    if (!cursor->node) {
+        return -1;  // Cursor is at the end
+    }
+
+    fossil_set_node_t* node_to_remove = cursor->node;
+    if (cursor->prev) {
+        cursor->prev->next = node_to_remove->next;
+    } else {
+        cursor->set->head = node_to_remove->next;
+    }
+    cursor->node = node_to_remove->next;
+    *data = node_to_remove->data;
+    free(node_to_remove);
+    return 0;  // Success
+}
+
+fossil_tofu_iteratorof_t fossil_set_cursor_span(const fossil_set_cursor_t* cursor) {
+    if (!cursor->node) {
+        return fossil_tofu_iteratorof_create(cnullptr, 0);
+    }
+    return fossil_tofu_iteratorof_create(&cursor->node->data, 1);
+}
@@ -12,12 +12,62 @@ Description:
 */
 #include "fossil/structure/stack.h"
 
+// Make room for at least min_capacity elements, doubling an array stack as needed.
+static int32_t fossil_stack_grow(fossil_stack_t* stack, size_t min_capacity) {
+    if (min_capacity <= stack->capacity) {
+        return 0;
+    }
+    if (stack->mode == FOSSIL_STACK_FIXED) {
+        return -1; // Fixed capacity
+    }
+
+    size_t new_capacity = stack->capacity ? stack->capacity * 2 : FOSSIL_STACK_INITIAL_CAPACITY;
+    if (new_capacity < min_capacity) {
+        new_capacity = min_capacity;
+    }
+    return fossil_stack_reserve(stack, new_capacity);
+}
+
 fossil_stack_t* fossil_stack_create(char* type) {
     fossil_stack_t* stack = (fossil_stack_t*)malloc(sizeof(fossil_stack_t));
     if (stack) {
         stack->type = type; // Assuming type is a static string or managed separately
         stack->top = cnullptr;
+        stack->data = cnullptr;
+        stack->size = 0;
+        stack->capacity = 0;
+        stack->mode = FOSSIL_STACK_LINKED;
+        stack->owns_data = false;
+    }
+    return stack;
+}
+
+fossil_stack_t* fossil_stack_create_array(char* type) {
+    fossil_stack_t* stack = fossil_stack_create(type);
+    if (stack) {
+        stack->mode = FOSSIL_STACK_ARRAY;
+        stack->owns_data = true;
+    }
+    return stack;
+}
+
+fossil_stack_t* fossil_stack_create_fixed(char* type, fossil_tofu_t* buffer, size_t capacity) {
+    fossil_stack_t* stack = fossil_stack_create(type);
+    if (!stack) {
+        return cnullptr;
+    }
+
+    stack->mode = FOSSIL_STACK_FIXED;
+    stack->owns_data = buffer == cnullptr;
+    stack->data = buffer;
+    if (!buffer && capacity > 0) {
+        stack->data = (fossil_tofu_t*)malloc(capacity * sizeof(fossil_tofu_t));
+        if (!stack->data) {
+            free(stack);
+            return cnullptr; // Allocation failed
+        }
     }
+    stack->capacity = capacity;
     return stack;
 }
 
@@ -31,10 +81,23 @@ void fossil_stack_erase(fossil_stack_t* stack) {
         current = next;
     }
     stack->top = cnullptr;
+
+    if (stack->owns_data) {
+        free(stack->data);
+    }
+    stack->data = cnullptr;
     free(stack);
 }
 
 int32_t fossil_stack_insert(fossil_stack_t* stack, fossil_tofu_t data) {
+    if (stack->mode != FOSSIL_STACK_LINKED) {
+        if (stack->size == stack->capacity && fossil_stack_grow(stack, stack->size + 1) != 0) {
+            return -1; // Allocation failed or stack is full
+        }
+        stack->data[stack->size++] = data;
+        return 0; // Success
+    }
+
     fossil_stack_node_t* new_node = (fossil_stack_node_t*)malloc(sizeof(fossil_stack_node_t));
     if (!new_node) {
         return -1; // Allocation failed
@@ -48,6 +111,14 @@ int32_t fossil_stack_insert(fossil_stack_t* stack, fossil_tofu_t data) {
 }
 
 int32_t fossil_stack_remove(fossil_stack_t* stack, fossil_tofu_t* data) {
+    if (stack->mode != FOSSIL_STACK_LINKED) {
+        if (stack->size == 0) {
+            return -1; // Stack is empty
+        }
+        *data = stack->data[--stack->size];
+        return 0; // Success
+    }
+
     if (!stack->top) {
         return -1; // Stack is empty
     }
@@ -61,6 +132,15 @@ int32_t fossil_stack_remove(fossil_stack_t* stack, fossil_tofu_t* data) {
 }
 
 int32_t fossil_stack_search(const fossil_stack_t* stack, fossil_tofu_t data) {
+    if (stack->mode != FOSSIL_STACK_LINKED) {
+        for (size_t i = stack->size; i-- > 0;) {
+            if (fossil_tofu_equals(stack->data[i], data)) {
+                return 0; // Found
+            }
+        }
+        return -1; // Not found
+    }
+
     fossil_stack_node_t* current = stack->top;
     while (current) {
         if (fossil_tofu_equals(current->data, data)) {
@@ -72,6 +152,10 @@ int32_t fossil_stack_search(const fossil_stack_t* stack, fossil_tofu_t data) {
 }
 
 size_t fossil_stack_size(const fossil_stack_t* stack) {
+    if (stack->mode != FOSSIL_STACK_LINKED) {
+        return stack->size;
+    }
+
     size_t count = 0;
     fossil_stack_node_t* current = stack->top;
     while (current) {
@@ -82,6 +166,15 @@ size_t fossil_stack_size(const fossil_stack_t* stack) {
 }
 
 fossil_tofu_t* fossil_stack_getter(fossil_stack_t* stack, fossil_tofu_t data) {
+    if (stack->mode != FOSSIL_STACK_LINKED) {
+        for (size_t i = stack->size; i-- > 0;) {
+            if (fossil_tofu_equals(stack->data[i], data)) {
+                return &(stack->data[i]); // Return pointer to found data
+            }
+        }
+        return cnullptr; // Not found
+    }
+
     fossil_stack_node_t* current = stack->top;
     while (current) {
         if (fossil_tofu_equals(current->data, data)) {
@@ -93,6 +186,15 @@ fossil_tofu_t* fossil_stack_getter(fossil_stack_t* stack, fossil_tofu_t data) {
 }
 
 int32_t fossil_stack_setter(fossil_stack_t* stack, fossil_tofu_t data) {
+    if (stack->mode != FOSSIL_STACK_LINKED) {
+        fossil_tofu_t* found = fossil_stack_getter(stack, data);
+        if (!found) {
+            return -1; // Not found
+        }
+        *found = data; // Update data
+        return 0; // Success
+    }
+
     fossil_stack_node_t* current = stack->top;
     while (current) {
         if (fossil_tofu_equals(current->data, data)) {
@@ -105,7 +207,7 @@ int32_t fossil_stack_setter(fossil_stack_t* stack, fossil_tofu_t data) {
 }
 
 bool fossil_stack_not_empty(const fossil_stack_t* stack) {
-    return stack->top != cnullptr;
+    return stack->mode != FOSSIL_STACK_LINKED ? stack->size != 0 : stack->top != cnullptr;
 }
 
 bool fossil_stack_not_cnullptr(const fossil_stack_t* stack) {
@@ -113,7 +215,7 @@ bool fossil_stack_not_cnullptr(const fossil_stack_t* stack) {
 }
 
 bool fossil_stack_is_empty(const fossil_stack_t* stack) {
-    return stack->top == cnullptr;
+    return stack->mode != FOSSIL_STACK_LINKED ? stack->size == 0 : stack->top == cnullptr;
 }
 
 bool fossil_stack_is_cnullptr(const fossil_stack_t* stack) {
@@ -121,8 +223,260 @@ bool fossil_stack_is_cnullptr(const fossil_stack_t* stack) {
 }
 
 fossil_tofu_t fossil_stack_top(fossil_stack_t* stack, fossil_tofu_t default_value) {
+    if (stack->mode != FOSSIL_STACK_LINKED) {
+        return stack->size ? stack->data[stack->size - 1] : default_value;
+    }
     if (!stack->top) {
         return default_value; // Stack is empty
     }
     return stack->top->data;
 }
+
+int32_t fossil_stack_peek(const fossil_stack_t* stack, size_t depth, fossil_tofu_t* data) {
+    if (stack->mode != FOSSIL_STACK_LINKED) {
+        if (depth >= stack->size) {
+            return -1; // Not enough elements
+        }
+        *data = stack->data[stack->size - 1 - depth];
+        return 0; // Success
+    }
+
+    fossil_stack_node_t* current = stack->top;
+    for (size_t i = 0; current && i < depth; ++i) {
+        current = current->next;
+    }
+    if (!current) {
+        return -1; // Not enough elements
+    }
+    *data = current->data;
+    return 0; // Success
+}
+
+int32_t fossil_stack_push_n(fossil_stack_t* stack, const fossil_tofu_t* elements, size_t count) {
+    if (count == 0) {
+        return 0;
+    }
+    if (!elements) {
+        return -1;
+    }
+
+    if (stack->mode != FOSSIL_STACK_LINKED) {
+        if (count > SIZE_MAX - stack->size || fossil_stack_grow(stack, stack->size + count) != 0) {
+            return -1; // Allocation failed or stack is full
+        }
+        memcpy(&stack->data[stack->size], elements, count * sizeof(fossil_tofu_t));
+        stack->size += count;
+        return 0; // Success
+    }
+
+    // Build the chain first so a failed allocation leaves the stack untouched.
+    fossil_stack_node_t* chain = stack->top;
+    for (size_t i = 0; i < count; ++i) {
+        fossil_stack_node_t* new_node = (fossil_stack_node_t*)malloc(sizeof(fossil_stack_node_t));
+        if (!new_node) {
+            while (chain != stack->top) {
+                fossil_stack_node_t* next = chain->next;
+                free(chain);
+                chain = next;
+            }
+            return -1; // Allocation failed
+        }
+        new_node->data = elements[i];
+        new_node->next = chain;
+        chain = new_node;
+    }
+    stack->top = chain;
+    return 0; // Success
+}
+
+int32_t fossil_stack_pop_n(fossil_stack_t* stack, fossil_tofu_t* elements, size_t count) {
+    if (count == 0) {
+        return 0;
+    }
+    if (!elements || fossil_stack_size(stack) < count) {
+        return -1; // Not enough elements
+    }
+
+    if (stack->mode != FOSSIL_STACK_LINKED) {
+        for (size_t i = 0; i < count; ++i) {
+            elements[i] = stack->data[stack->size - 1 - i];
+        }
+        stack->size -= count;
+        return 0; // Success
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        fossil_stack_node_t* top_node = stack->top;
+        elements[i] = top_node->data;
+        stack->top = top_node->next;
+        free(top_node);
+    }
+    return 0; // Success
+}
+
+int32_t fossil_stack_reserve(fossil_stack_t* stack, size_t capacity) {
+    if (stack->mode == FOSSIL_STACK_LINKED || capacity <= stack->capacity) {
+        return 0; // Linked stacks allocate per element
+    }
+    if (stack->mode == FOSSIL_STACK_FIXED) {
+        return -1; // Fixed capacity
+    }
+
+    fossil_tofu_t* new_data = (fossil_tofu_t*)realloc(stack->data, capacity * sizeof(fossil_tofu_t));
+    if (!new_data) {
+        return -1; // Allocation failed
+    }
+    stack->data = new_data;
+    stack->capacity = capacity;
+    return 0; // Success
+}
+
+size_t fossil_stack_capacity(const fossil_stack_t* stack) {
+    return stack->capacity;
+}
+
+// Find the node linked below target, or the bottom node when target is null.
+static fossil_stack_node_t* fossil_stack_node_before(const fossil_stack_t* stack, const fossil_stack_node_t* target) {
+    fossil_stack_node_t* prev = cnullptr;
+    for (fossil_stack_node_t* node = stack->top; node != target; node = node->next) {
+        prev = node;
+    }
+    return prev;
+}
+
+fossil_stack_cursor_t fossil_stack_cursor_begin(fossil_stack_t* stack) {
+    fossil_stack_cursor_t cursor = { stack, stack->top, cnullptr, 0 };
+    return cursor;
+}
+
+fossil_stack_cursor_t fossil_stack_cursor_end(fossil_stack_t* stack) {
+    fossil_stack_cursor_t cursor = { stack, cnullptr, cnullptr, stack->size };
+    if (stack->mode == FOSSIL_STACK_LINKED) {
+        cursor.prev = fossil_stack_node_before(stack, cnullptr);
+    }
+    return cursor;
+}
+
+bool fossil_stack_cursor_valid(const fossil_stack_cursor_t* cursor) {
+    if (cursor->stack->mode != FOSSIL_STACK_LINKED) {
+        return cursor->depth < cursor->stack->size;
+    }
+    return cursor->node != cnullptr;
+}
+
+void fossil_stack_cursor_next(fossil_stack_cursor_t* cursor) {
+    if (cursor->stack->mode != FOSSIL_STACK_LINKED) {
+        if (cursor->depth < cursor->stack->size) {
+            cursor->depth++;
+        }
+        return;
+    }
+
+    if (cursor->node) {
+        cursor->prev = cursor->node;
+        cursor->node = cursor->node->next;
+    }
+}
+
+void fossil_stack_cursor_prev(fossil_stack_cursor_t* cursor) {
+    if (cursor->stack->mode != FOSSIL_STACK_LINKED) {
+        cursor->depth = cursor->depth == 0 ? cursor->stack->size : cursor->depth - 1;
+        return;
+    }
+
+    if (cursor->node == cursor->stack->top) {
+        *cursor = fossil_stack_cursor_end(cursor->stack); // Before the top wraps to the end
+        return;
+    }
+    cursor->node = cursor->prev;
+    cursor->prev = fossil_stack_node_before(cursor->stack, cursor->node);
+}
+
+fossil_tofu_t* fossil_stack_cursor_deref(const fossil_stack_cursor_t* cursor) {
+    if (cursor->stack->mode != FOSSIL_STACK_LINKED) {
+        if (cursor->depth >= cursor->stack->size) {
+            return cnullptr;
+        }
+        return &cursor->stack->data[cursor->stack->size - 1 - cursor->depth];
+    }
+    return cursor->node ? &cursor->node->data : cnullptr;
+}
+
+int32_t fossil_stack_cursor_insert_after(fossil_stack_cursor_t* cursor, fossil_tofu_t data) {
+    fossil_stack_t* stack = cursor->stack;
+    if (stack->mode != FOSSIL_STACK_LINKED) {
+        if (cursor->depth >= stack->size) {
+            return -1; // Cursor is at the end
+        }
+        if (stack->size == stack->capacity && fossil_stack_grow(stack, stack->size + 1) != 0) {
+            return -1; // Allocation failed or stack is full
+        }
+
+        // The new element goes just below the cursor, so the cursor keeps its depth.
+        size_t index = stack->size - 1 - cursor->depth;
+        memmove(&stack->data[index + 1], &stack->data[index], (stack->size - index) * sizeof(fossil_tofu_t));
+        stack->data[index] = data;
+        stack->size++;
+        return 0; // Success
+    }
+
+    if (!cursor->node) {
+        return -1; // Cursor is at the end
+    }
+
+    fossil_stack_node_t* new_node = (fossil_stack_node_t*)malloc(sizeof(fossil_stack_node_t));
+    if (!new_node) {
+        return -1; // Allocation failed
+    }
+
+    new_node->data = data;
+    new_node->next = cursor->node->next;
+    cursor->node->next = new_node;
+    return 0; // Success
+}
+
+int32_t fossil_stack_cursor_erase(fossil_stack_cursor_t* cursor, fossil_tofu_t* data) {
+    fossil_stack_t* stack = cursor->stack;
+    if (stack->mode != FOSSIL_STACK_LINKED) {
+        if (cursor->depth >= stack->size) {
+            return -1; // Cursor is at the end
+        }
+
+        // The element below slides up into the cursor's depth.
+        size_t index = stack->size - 1 - cursor->depth;
+        *data = stack->data[index];
+        memmove(&stack->data[index], &stack->data[index + 1], (stack->size - index - 1) * sizeof(fossil_tofu_t));
+        stack->size--;
+        return 0; // Success
+    }
+
+    if (!cursor->node) {
+        return -1; // Cursor is at the end
+    }
+
+    fossil_stack_node_t* node_to_remove = cursor->node;
+    if (cursor->prev) {
+        cursor->prev->next = node_to_remove->next;
+    } else {
+        stack->top = node_to_remove->next;
+    }
+    cursor->node = node_to_remove->next;
+    *data = node_to_remove->data;
+    free(node_to_remove);
+    return 0; // Success
+}
+
+fossil_tofu_iteratorof_t fossil_stack_cursor_span(const fossil_stack_cursor_t* cursor) {
+    if (cursor->stack->mode != FOSSIL_STACK_LINKED) {
+        if (cursor->depth >= cursor->stack->size) {
+            return fossil_tofu_iteratorof_create(cnullptr, 0);
+        }
+        // Elements are stored bottom first, so the next one down is not after the cursor in memory
+        return fossil_tofu_iteratorof_create(&cursor->stack->data[cursor->stack->size - 1 - cursor->depth], 1);
+    }
+
+    if (!cursor->node) {
+        return fossil_tofu_iteratorof_create(cnullptr, 0);
+    }
+    return fossil_tofu_iteratorof_create(&cursor->node->data, 1);
+}
@@ -12,6 +12,24 @@ Description:
 */
 #include "fossil/structure/vector.h"
 
+// Grow the storage so that at least min_capacity elements fit.
+static int32_t fossil_vector_grow(fossil_vector_t* vector, size_t min_capacity) {
+    if (min_capacity <= vector->capacity) {
+        return 0;
+    }
+
+    size_t new_capacity = vector->capacity == 0
+        ? INITIAL_CAPACITY
+        : (size_t)((double)vector->capacity * vector->growth_factor);
+    if (new_capacity <= vector->capacity) {
+        new_capacity = vector->capacity + 1;
+    }
+    if (new_capacity < min_capacity) {
+        new_capacity = min_capacity;
+    }
+    return fossil_vector_reserve(vector, new_capacity);
+}
+
 fossil_vector_t* fossil_vector_create(char* type) {
     fossil_vector_t* vector = (fossil_vector_t*)malloc(sizeof(fossil_vector_t));
     if (vector) {
@@ -19,6 +37,7 @@ fossil_vector_t* fossil_vector_create(char* type) {
         vector->size = 0;
         vector->capacity = 0;
         vector->type = type; // Assuming type is a static string or managed separately
+        vector->growth_factor = FOSSIL_VECTOR_GROWTH_FACTOR;
     }
     return vector;
 }
@@ -34,20 +53,57 @@ void fossil_vector_erase(fossil_vector_t* vector) {
 }
 
 void fossil_vector_push_back(fossil_vector_t* vector, fossil_tofu_t element) {
-    if (vector->size >= vector->capacity) {
-        size_t new_capacity = vector->capacity == 0 ? 1 : vector->capacity * 2;
-        fossil_tofu_t* new_data = (fossil_tofu_t*)realloc(vector->data, new_capacity * sizeof(fossil_tofu_t));
-        if (!new_data) {
-            // Handle allocation failure
-            return;
-        }
-        vector->data = new_data;
-        vector->capacity = new_capacity;
+    if (fossil_vector_grow(vector, vector->size + 1) != 0) {
+        // Handle allocation failure
+        return;
     }
 
     vector->data[vector->size++] = element;
 }
 
+int32_t fossil_vector_append(fossil_vector_t* vector, const fossil_tofu_t* elements, size_t count) {
+    return fossil_vector_insert_range(vector, vector->size, elements, count);
+}
+
+int32_t fossil_vector_insert(fossil_vector_t* vector, size_t index, fossil_tofu_t element) {
+    return fossil_vector_insert_range(vector, index, &element, 1);
+}
+
+int32_t fossil_vector_insert_range(fossil_vector_t* vector, size_t index, const fossil_tofu_t* elements, size_t count) {
+    if (index > vector->size) {
+        return -1;  // Out of range
+    }
+    if (count == 0) {
+        return 0;
+    }
+    if (!elements || fossil_vector_grow(vector, vector->size + count) != 0) {
+        return -1;  // Allocation failed
+    }
+
+    memmove(&vector->data[index + count], &vector->data[index], (vector->size - index) * sizeof(fossil_tofu_t));
+    memcpy(&vector->data[index], elements, count * sizeof(fossil_tofu_t));
+    vector->size += count;
+    return 0;
+}
+
+int32_t fossil_vector_remove_at(fossil_vector_t* vector, size_t index) {
+    return fossil_vector_remove_range(vector, index, 1);
+}
+
+int32_t fossil_vector_remove_range(fossil_vector_t* vector, size_t first, size_t count) {
+    if (first > vector->size || count > vector->size - first) {
+        return -1;  // Out of range
+    }
+
+    memmove(&vector->data[first], &vector->data[first + count], (vector->size - first - count) * sizeof(fossil_tofu_t));
+    vector->size -= count;
+    return 0;
+}
+
+void fossil_vector_clear(fossil_vector_t* vector) {
+    vector->size = 0;
+}
+
 int fossil_vector_search(const fossil_vector_t* vector, fossil_tofu_t target) {
     for (size_t i = 0; i < vector->size; ++i) {
         if (fossil_tofu_equals(vector->data[i], target)) {
@@ -98,9 +154,117 @@ size_t fossil_vector_size(const fossil_vector_t* vector) {
     return vector->size;
 }
 
+size_t fossil_vector_capacity(const fossil_vector_t* vector) {
+    return vector->capacity;
+}
+
+int32_t fossil_vector_reserve(fossil_vector_t* vector, size_t capacity) {
+    if (capacity <= vector->capacity) {
+        return 0;
+    }
+
+    fossil_tofu_t* new_data = (fossil_tofu_t*)realloc(vector->data, capacity * sizeof(fossil_tofu_t));
+    if (!new_data) {
+        return -1;  // Allocation failed
+    }
+    vector->data = new_data;
+    vector->capacity = capacity;
+    return 0;
+}
+
+int32_t fossil_vector_resize(fossil_vector_t* vector, size_t size, fossil_tofu_t value) {
+    if (fossil_vector_reserve(vector, size) != 0) {
+        return -1;  // Allocation failed
+    }
+
+    for (size_t i = vector->size; i < size; ++i) {
+        vector->data[i] = value;
+    }
+    vector->size = size;
+    return 0;
+}
+
+int32_t fossil_vector_shrink_to_fit(fossil_vector_t* vector) {
+    if (vector->size == vector->capacity) {
+        return 0;
+    }
+    if (vector->size == 0) {
+        free(vector->data);
+        vector->data = cnullptr;
+        vector->capacity = 0;
+        return 0;
+    }
+
+    fossil_tofu_t* new_data = (fossil_tofu_t*)realloc(vector->data, vector->size * sizeof(fossil_tofu_t));
+    if (!new_data) {
+        return -1;  // Allocation failed
+    }
+    vector->data = new_data;
+    vector->capacity = vector->size;
+    return 0;
+}
+
+int32_t fossil_vector_set_growth_factor(fossil_vector_t* vector, double factor) {
+    if (!(factor > 1.0)) {
+        return -1;  // Growth factor must grow the vector
+    }
+    vector->growth_factor = factor;
+    return 0;
+}
+
 void fossil_vector_peek(const fossil_vector_t* vector) {
     for (size_t i = 0; i < vector->size; ++i) {
         fossil_tofu_print(vector->data[i]);
     }
 }
 
+
+fossil_vector_cursor_t fossil_vector_cursor_begin(fossil_vector_t* vector) {
+    fossil_vector_cursor_t cursor = { vector, 0 };
+    return cursor;
+}
+
+fossil_vector_cursor_t fossil_vector_cursor_end(fossil_vector_t* vector) {
+    fossil_vector_cursor_t cursor = { vector, vector->size };
+    return cursor;
+}
+
+bool fossil_vector_cursor_valid(const fossil_vector_cursor_t* cursor) {
+    return cursor->index < cursor->vector->size;
+}
+
+void fossil_vector_cursor_next(fossil_vector_cursor_t* cursor) {
+    if (cursor->index < cursor->vector->size) {
+        cursor->index++;
+    }
+}
+
+void fossil_vector_cursor_prev(fossil_vector_cursor_t* cursor) {
+    cursor->index = cursor->index == 0 ? cursor->vector->size : cursor->index - 1;
+}
+
+fossil_tofu_t* fossil_vector_cursor_deref(const fossil_vector_cursor_t* cursor) {
+    return fossil_vector_getter(cursor->vector, cursor->index);
+}
+
+int32_t fossil_vector_cursor_insert_after(fossil_vector_cursor_t* cursor, fossil_tofu_t data) {
+    if (!fossil_vector_cursor_valid(cursor)) {
+        return -1;  // Cursor is at the end
+    }
+    return fossil_vector_insert(cursor->vector, cursor->index + 1, data);
+}
+
+int32_t fossil_vector_cursor_erase(fossil_vector_cursor_t* cursor, fossil_tofu_t* data) {
+    if (!fossil_vector_cursor_valid(cursor)) {
+        return -1;  // Cursor is at the end
+    }
+    *data = cursor->vector->data[cursor->index];
+    return fossil_vector_remove_at(cursor->vector, cursor->index);
+}
+
+fossil_tofu_iteratorof_t fossil_vector_cursor_span(const fossil_vector_cursor_t* cursor) {
+    if (!fossil_vector_cursor_valid(cursor)) {
+        return fossil_tofu_iteratorof_create(cnullptr, 0);
+    }
+    return fossil_tofu_iteratorof_create(&cursor->vector->data[cursor->index], cursor->vector->size - cursor->index);
+}
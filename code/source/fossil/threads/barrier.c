@@ -12,28 +12,43 @@ Description:
 */
 #include "fossil/threads/barrier.h"
 #include "fossil/common/common.h"
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+static inline void barrier_pause(void) {
+#if defined(_MSC_VER)
+    YieldProcessor();
+#elif defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
 
 // Implement barrier functions
 int32_t fossil_barrier_create(fossil_xbarrier_t *barrier, uint32_t count) {
-    if (!barrier) return FOSSIL_ERROR;
+    return fossil_barrier_create_mode(barrier, count, FOSSIL_BARRIER_BLOCKING);
+}
+
+int32_t fossil_barrier_create_mode(fossil_xbarrier_t *barrier, uint32_t count, fossil_xbarrier_mode_t mode) {
+    if (!barrier || count == 0) return FOSSIL_ERROR;
 
 #ifdef _WIN32
-    // Initialize the barrier using CreateEvent
-    barrier->semaphore = CreateSemaphore(cnullptr, 0, count, cnullptr);
-    if (barrier->semaphore == cnullptr) return FOSSIL_ERROR;
-    barrier->count = ATOMIC_VAR_INIT(0);
-    barrier->total = ATOMIC_VAR_INIT(count);
     InitializeCriticalSection(&barrier->mutex);
+    InitializeConditionVariable(&barrier->cond);
 #else
-    // Initialize the barrier using pthread_mutex_init and pthread_cond_init
     if (pthread_mutex_init(&(barrier->mutex), cnullptr) != 0) return FOSSIL_ERROR;
     if (pthread_cond_init(&(barrier->cond), cnullptr) != 0) {
         pthread_mutex_destroy(&(barrier->mutex));
         return FOSSIL_ERROR;
     }
-    atomic_init(&(barrier->count), 0);
-    atomic_init(&(barrier->total), count);
 #endif
+    atomic_init(&(barrier->count), 0);
+    atomic_init(&(barrier->total), (int)count);
+    atomic_init(&(barrier->generation), 0);
+    atomic_init(&(barrier->sleepers), 0);
+    barrier->mode = mode;
 
     return FOSSIL_SUCCESS;
 }
@@ -42,11 +57,9 @@ int32_t fossil_barrier_erase(fossil_xbarrier_t *barrier) {
     if (!barrier) return FOSSIL_ERROR;
 
 #ifdef _WIN32
-    // Destroy the barrier using CloseHandle and DeleteCriticalSection
-    CloseHandle(barrier->semaphore);
+    // Condition variables need no cleanup on Windows
     DeleteCriticalSection(&barrier->mutex);
 #else
-    // Destroy the barrier using pthread_mutex_destroy and pthread_cond_destroy
     pthread_mutex_destroy(&(barrier->mutex));
     pthread_cond_destroy(&(barrier->cond));
 #endif
@@ -57,36 +70,54 @@ int32_t fossil_barrier_erase(fossil_xbarrier_t *barrier) {
 int32_t fossil_barrier_wait(fossil_xbarrier_t *barrier) {
     if (!barrier) return FOSSIL_ERROR;
 
+    // Read the generation before arriving: it cannot advance until this thread has arrived
+    unsigned int generation = atomic_load_explicit(&(barrier->generation), memory_order_acquire);
+
+    if (atomic_fetch_add_explicit(&(barrier->count), 1, memory_order_acq_rel) + 1 >= atomic_load(&(barrier->total))) {
+        // Reset before publishing the new generation, so released threads can arrive again at once
+        atomic_store_explicit(&(barrier->count), 0, memory_order_relaxed);
+        atomic_fetch_add(&(barrier->generation), 1);
+        if (atomic_load(&(barrier->sleepers)) > 0) {
 #ifdef _WIN32
-    // Wait on the barrier using WaitForSingleObject
-    WaitForSingleObject(barrier->semaphore, INFINITE);
-    EnterCriticalSection(&barrier->mutex);
-    int count = atomic_fetch_add(&(barrier->count), 1) + 1;
-    LeaveCriticalSection(&barrier->mutex);
-    if (count >= atomic_load(&(barrier->total))) {
-        for (int i = 0; i < count - 1; ++i) {
-            ReleaseSemaphore(barrier->semaphore, 1, cnullptr);
+            EnterCriticalSection(&barrier->mutex);
+            WakeAllConditionVariable(&barrier->cond);
+            LeaveCriticalSection(&barrier->mutex);
+#else
+            pthread_mutex_lock(&(barrier->mutex));
+            pthread_cond_broadcast(&(barrier->cond));
+            pthread_mutex_unlock(&(barrier->mutex));
+#endif
+        }
+        return FOSSIL_SUCCESS; // This thread completed the phase
+    }
+
+    if (barrier->mode == FOSSIL_BARRIER_SPINNING) {
+        for (uint32_t i = 0; i < FOSSIL_BARRIER_SPIN_LIMIT; ++i) {
+            if (atomic_load_explicit(&(barrier->generation), memory_order_acquire) != generation) {
+                return FOSSIL_FAILURE;
+            }
+            barrier_pause();
         }
-        atomic_store(&(barrier->count), 0);
-        return FOSSIL_SUCCESS; // Barrier was passed without tripping
     }
-    else {
-        WaitForSingleObject(barrier->semaphore, INFINITE);
-        return FOSSIL_FAILURE; // Barrier was tripped
+
+    // Sleep until the generation changes; the sleeper count is raised before the last check,
+    // so the releasing thread either sees it or this check sees the new generation
+#ifdef _WIN32
+    EnterCriticalSection(&barrier->mutex);
+    atomic_fetch_add(&(barrier->sleepers), 1);
+    while (atomic_load(&(barrier->generation)) == generation) {
+        SleepConditionVariableCS(&barrier->cond, &barrier->mutex, INFINITE);
     }
+    atomic_fetch_sub(&(barrier->sleepers), 1);
+    LeaveCriticalSection(&barrier->mutex);
 #else
-    // Wait on the barrier using pthread_mutex_lock and pthread_cond_wait
     pthread_mutex_lock(&(barrier->mutex));
-    atomic_fetch_add(&(barrier->count), 1);
-    if (atomic_load(&(barrier->count)) >= atomic_load(&(barrier->total))) {
-        pthread_cond_broadcast(&(barrier->cond));
-        atomic_store(&(barrier->count), 0);
-        pthread_mutex_unlock(&(barrier->mutex));
-        return FOSSIL_SUCCESS; // Barrier was passed without tripping
-    } else {
+    atomic_fetch_add(&(barrier->sleepers), 1);
+    while (atomic_load(&(barrier->generation)) == generation) {
         pthread_cond_wait(&(barrier->cond), &(barrier->mutex));
-        pthread_mutex_unlock(&(barrier->mutex));
-        return FOSSIL_FAILURE; // Barrier was tripped
     }
+    atomic_fetch_sub(&(barrier->sleepers), 1);
+    pthread_mutex_unlock(&(barrier->mutex));
 #endif
+    return FOSSIL_FAILURE; // Another thread completed the phase
 }
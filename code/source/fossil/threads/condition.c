@@ -10,6 +10,9 @@ Description:
     feel free to contact Michael at michaelbrockus@gmail.com.
 ==============================================================================
 */
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L // for clock_gettime
+#endif
 #include "fossil/threads/condition.h"
 #include "fossil/common/common.h"
 
@@ -60,6 +63,24 @@ int32_t fossil_cond_wait(fossil_xcond_t *cond, fossil_xmutex_t *mutex) {
 #endif
 }
 
+int32_t fossil_cond_timedwait(fossil_xcond_t *cond, fossil_xmutex_t *mutex, uint32_t milliseconds) {
+    if (!cond || !mutex) return FOSSIL_ERROR;
+
+#ifdef _WIN32
+    return SleepConditionVariableCS(cond, *mutex, milliseconds) ? FOSSIL_SUCCESS : FOSSIL_ERROR;
+#else
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += milliseconds / 1000;
+    deadline.tv_nsec += (long)(milliseconds % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec += 1;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    return pthread_cond_timedwait(cond, mutex, &deadline) == 0 ? FOSSIL_SUCCESS : FOSSIL_ERROR;
+#endif
+}
+
 int32_t fossil_cond_signal(fossil_xcond_t *cond) {
     if (!cond) return FOSSIL_ERROR;
 
@@ -0,0 +1,227 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#include "fossil/threads/epoch.h"
+#include "fossil/common/common.h"
+#include <stdlib.h>
+
+#define FOSSIL_EPOCH_BAGS 3 // Objects retired in the current epoch and the two before it
+
+typedef struct {
+    void *ptr;
+    fossil_xtask_func_t free_func;
+} epoch_retired_t;
+
+// Objects retired by one thread in one epoch
+typedef struct {
+    uint64_t epoch;
+    epoch_retired_t *items;
+    size_t count;
+    size_t capacity;
+} epoch_bag_t;
+
+struct fossil_xepoch_record_t {
+    atomic_uint_fast64_t state;         // Epoch seen on entry, shifted left, low bit set inside a critical section
+    atomic_int in_use;                  // Set while a thread owns the record
+    fossil_xepoch_record_t *next;       // Fixed once the record is published
+    uint32_t nesting;
+    size_t retired;                     // Retirements since the last attempt to reclaim
+    epoch_bag_t bags[FOSSIL_EPOCH_BAGS];
+    char pad[FOSSIL_EPOCH_CACHE_LINE];  // Keeps the next allocation off the state of this one
+};
+
+// Runs at thread exit through the thread-local key; the record keeps its bags for the next owner
+static void epoch_thread_exit(void *arg) {
+    fossil_xepoch_record_t *record = (fossil_xepoch_record_t *)arg;
+    record->nesting = 0;
+    atomic_store_explicit(&record->state, 0, memory_order_release);
+    atomic_store_explicit(&record->in_use, 0, memory_order_release);
+}
+
+/**
+ * @brief Gets the calling thread's record, adopting a free one or publishing a new one on first use.
+ *
+ * @param domain Pointer to the domain.
+ * @return fossil_xepoch_record_t* The record, or NULL if the thread cannot be registered.
+ */
+static fossil_xepoch_record_t *epoch_record(fossil_xepoch_domain_t *domain) {
+    fossil_xepoch_record_t *record = (fossil_xepoch_record_t *)fossil_thread_local_get(domain->key);
+    if (record) {
+        return record;
+    }
+
+    for (record = atomic_load(&domain->records); record; record = record->next) {
+        int expected = 0;
+        if (atomic_load_explicit(&record->in_use, memory_order_relaxed) == 0 &&
+            atomic_compare_exchange_strong(&record->in_use, &expected, 1)) {
+            break;
+        }
+    }
+    if (!record) {
+        record = (fossil_xepoch_record_t *)calloc(1, sizeof(fossil_xepoch_record_t));
+        if (!record) {
+            return NULL;
+        }
+        for (int i = 0; i < FOSSIL_EPOCH_BAGS; ++i) {
+            record->bags[i].epoch = (uint64_t)i;
+        }
+        atomic_init(&record->state, 0);
+        atomic_init(&record->in_use, 1);
+        fossil_xepoch_record_t *head = atomic_load(&domain->records);
+        do {
+            record->next = head;
+        } while (!atomic_compare_exchange_weak(&domain->records, &head, record));
+    }
+
+    if (fossil_thread_local_set(domain->key, record) != 0) {
+        atomic_store(&record->in_use, 0);
+        return NULL;
+    }
+    return record;
+}
+
+static size_t epoch_bag_free(epoch_bag_t *bag) {
+    size_t freed = bag->count;
+    for (size_t i = 0; i < bag->count; ++i) {
+        bag->items[i].free_func(bag->items[i].ptr);
+    }
+    bag->count = 0;
+    return freed;
+}
+
+int32_t fossil_epoch_domain_create(fossil_xepoch_domain_t *domain, size_t threshold) {
+    if (!domain) return FOSSIL_ERROR;
+
+    atomic_init(&domain->epoch, 0);
+    atomic_init(&domain->records, NULL);
+    domain->threshold = threshold ? threshold : FOSSIL_EPOCH_DEFAULT_THRESHOLD;
+    return fossil_thread_local_create(&domain->key, epoch_thread_exit) == 0 ? FOSSIL_SUCCESS : FOSSIL_ERROR;
+}
+
+int32_t fossil_epoch_domain_erase(fossil_xepoch_domain_t *domain) {
+    if (!domain) return FOSSIL_ERROR;
+
+    // Deleting the key first keeps exiting threads from touching records that are about to go
+    fossil_thread_local_erase(domain->key);
+    fossil_xepoch_record_t *record = atomic_exchange(&domain->records, NULL);
+    while (record) {
+        fossil_xepoch_record_t *next = record->next;
+        for (int i = 0; i < FOSSIL_EPOCH_BAGS; ++i) {
+            epoch_bag_free(&record->bags[i]);
+            free(record->bags[i].items);
+        }
+        free(record);
+        record = next;
+    }
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_epoch_enter(fossil_xepoch_domain_t *domain) {
+    if (!domain) return FOSSIL_ERROR;
+    fossil_xepoch_record_t *record = epoch_record(domain);
+    if (!record) return FOSSIL_ERROR;
+
+    if (record->nesting++ == 0) {
+        // The fence keeps the loads of the critical section from moving above the announcement
+        uint64_t epoch = atomic_load_explicit(&domain->epoch, memory_order_relaxed);
+        atomic_store_explicit(&record->state, (epoch << 1) | 1u, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+    }
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_epoch_exit(fossil_xepoch_domain_t *domain) {
+    if (!domain) return FOSSIL_ERROR;
+    fossil_xepoch_record_t *record = (fossil_xepoch_record_t *)fossil_thread_local_get(domain->key);
+    if (!record || record->nesting == 0) return FOSSIL_ERROR;
+
+    if (--record->nesting == 0) {
+        atomic_store_explicit(&record->state, 0, memory_order_release);
+    }
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_epoch_retire(fossil_xepoch_domain_t *domain, void *ptr, fossil_xtask_func_t free_func) {
+    if (!domain || !free_func) return FOSSIL_ERROR;
+    fossil_xepoch_record_t *record = epoch_record(domain);
+    if (!record) return FOSSIL_ERROR;
+
+    // Read after the object was unlinked, so no reader that entered at this epoch or later can reach it
+    uint64_t epoch = atomic_load(&domain->epoch);
+    epoch_bag_t *bag = &record->bags[epoch % FOSSIL_EPOCH_BAGS];
+    if (bag->epoch != epoch) {
+        // Whatever the bag holds is at least three epochs old
+        epoch_bag_free(bag);
+        bag->epoch = epoch;
+    }
+    if (bag->count == bag->capacity) {
+        size_t capacity = bag->capacity ? bag->capacity * 2 : domain->threshold;
+        epoch_retired_t *items = (epoch_retired_t *)realloc(bag->items, sizeof(epoch_retired_t) * capacity);
+        if (!items) return FOSSIL_ERROR;
+        bag->items = items;
+        bag->capacity = capacity;
+    }
+    bag->items[bag->count].ptr = ptr;
+    bag->items[bag->count].free_func = free_func;
+    bag->count++;
+
+    if (++record->retired >= domain->threshold) {
+        fossil_epoch_reclaim(domain);
+    }
+    return FOSSIL_SUCCESS;
+}
+
+size_t fossil_epoch_reclaim(fossil_xepoch_domain_t *domain) {
+    if (!domain) return 0;
+    fossil_xepoch_record_t *record = epoch_record(domain);
+    if (!record) return 0;
+    record->retired = 0;
+
+    // The epoch moves on once every thread inside a critical section has seen the current one
+    uint64_t epoch = atomic_load(&domain->epoch);
+    bool quiescent = true;
+    atomic_thread_fence(memory_order_seq_cst);
+    for (fossil_xepoch_record_t *other = atomic_load(&domain->records); other; other = other->next) {
+        uint64_t state = atomic_load_explicit(&other->state, memory_order_acquire);
+        if ((state & 1u) && (state >> 1) != epoch) {
+            quiescent = false;
+            break;
+        }
+    }
+    if (quiescent) {
+        uint_fast64_t expected = epoch;
+        if (atomic_compare_exchange_strong(&domain->epoch, &expected, epoch + 1)) {
+            epoch++;
+        } else {
+            epoch = expected;
+        }
+    }
+
+    size_t freed = 0;
+    for (int i = 0; i < FOSSIL_EPOCH_BAGS; ++i) {
+        if (record->bags[i].count > 0 && record->bags[i].epoch + 2 <= epoch) {
+            freed += epoch_bag_free(&record->bags[i]);
+        }
+    }
+    return freed;
+}
+
+int32_t fossil_epoch_unregister(fossil_xepoch_domain_t *domain) {
+    if (!domain) return FOSSIL_ERROR;
+    fossil_xepoch_record_t *record = (fossil_xepoch_record_t *)fossil_thread_local_get(domain->key);
+    if (!record) return FOSSIL_SUCCESS;
+    if (record->nesting > 0) return FOSSIL_ERROR;
+
+    fossil_thread_local_set(domain->key, NULL);
+    epoch_thread_exit(record);
+    return FOSSIL_SUCCESS;
+}
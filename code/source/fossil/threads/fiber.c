@@ -0,0 +1,1059 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifdef __linux__
+#define _GNU_SOURCE // for MAP_ANONYMOUS, MAP_STACK and ucontext
+#elif defined(__APPLE__)
+#define _DARWIN_C_SOURCE // for MAP_ANON
+#endif
+#include "fossil/threads/fiber.h"
+#include "fossil/threads/thread.h"
+#include "fossil/threads/timer.h"
+#include "fossil/common/common.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Context switching: Windows fibers, hand-written switches on x86-64 and AArch64, ucontext
+// elsewhere. Defining FOSSIL_FIBER_USE_UCONTEXT forces ucontext on any POSIX system.
+#if defined(_WIN32)
+#define FIBER_WINDOWS
+#elif !defined(FOSSIL_FIBER_USE_UCONTEXT) && (defined(__GNUC__) || defined(__clang__)) && \
+      (defined(__x86_64__) || defined(__aarch64__)) && (defined(__ELF__) || defined(__APPLE__))
+#define FIBER_ASM
+#else
+#define FIBER_UCONTEXT
+#endif
+
+#ifndef _WIN32
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#ifdef FIBER_UCONTEXT
+#include <ucontext.h>
+#endif
+
+#if !defined(_WIN32) && !defined(MAP_ANONYMOUS)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+#if defined(_MSC_VER)
+#define FIBER_NOINLINE __declspec(noinline)
+#elif defined(__GNUC__) || defined(__clang__)
+#define FIBER_NOINLINE __attribute__((noinline))
+#else
+#define FIBER_NOINLINE
+#endif
+
+// ThreadSanitizer has to be told about every stack switch, or it mixes up the fibers' histories
+#if defined(__SANITIZE_THREAD__)
+#define FIBER_TSAN
+#elif defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+#define FIBER_TSAN
+#endif
+#endif
+#ifdef FIBER_TSAN
+void *__tsan_get_current_fiber(void);
+void *__tsan_create_fiber(unsigned flags);
+void __tsan_destroy_fiber(void *fiber);
+void __tsan_switch_to_fiber(void *fiber, unsigned flags);
+#endif
+
+#define FIBER_MXCSR_DEFAULT 0x1F80u // All SSE exceptions masked, round to nearest
+#define FIBER_FPUCW_DEFAULT 0x037Fu // All x87 exceptions masked, extended precision
+
+typedef enum {
+    FIBER_YIELD,                        // Back to the end of the run queue
+    FIBER_PARK,                         // Waiting to be notified
+    FIBER_SLEEP,                        // Waiting on the scheduler's timer wheel
+    FIBER_DONE                          // Finished; the worker wakes its joiner
+} fiber_action_t;
+
+// Park handshake between a fiber's worker and its waker: whichever comes second makes it runnable
+typedef enum {
+    FIBER_RUNNING,
+    FIBER_PARKED,                       // Off its stack, not yet notified
+    FIBER_NOTIFIED                      // Notified before its worker saw it park
+} fiber_park_t;
+
+typedef struct {
+#if defined(FIBER_WINDOWS)
+    LPVOID handle;
+#elif defined(FIBER_UCONTEXT)
+    ucontext_t context;
+#else
+    void *sp;                           // Saved stack pointer, callee-saved registers are on the stack
+#endif
+#ifdef FIBER_TSAN
+    void *tsan;
+#endif
+} fiber_context_t;
+
+typedef struct {
+    fossil_xfiber_scheduler_t *scheduler;
+    fiber_context_t context;            // The worker thread's own context, between fibers
+    fossil_xfiber_t *running;
+    fiber_action_t action;              // Why the running fiber switched back
+    fossil_xthread_t thread;
+} fiber_worker_t;
+
+struct fossil_xfiber_waiter_t {
+    fossil_xfiber_waiter_t *next;
+    fossil_xfiber_t *fiber;             // NULL for a thread, which waits on the primitive's condition
+    int32_t woken;
+};
+
+struct fossil_xfiber_t {
+    fossil_xfiber_scheduler_t *scheduler;
+    fossil_xfiber_t *next;              // Run queue or cache link
+    fiber_context_t context;
+    fiber_worker_t *worker;             // Worker the fiber last ran on
+    atomic_int park;                    // A fiber_park_t
+    fossil_xtask_func_t func;
+    void *arg;
+    fossil_xtimer_t timer;              // Wakes the fiber from a sleep
+    uint32_t sleep_ms;
+    void *stack;                        // Start of the mapping, guard page included
+    size_t mapped;
+    fossil_xmutex_t lock;               // Guards the fields below
+    fossil_xcond_t cond;                // Wakes a joining thread
+    int32_t done;
+    int32_t detached;
+    fossil_xfiber_waiter_t *joiner;
+};
+
+struct fossil_xfiber_scheduler_t {
+    fossil_xmutex_t mutex;              // Guards the run queue, the cache and the counters
+    fossil_xcond_t wake;                // Wakes idle workers
+    fossil_xcond_t drained;             // Signalled when the last fiber finishes
+    fossil_xfiber_t *head;              // Run queue
+    fossil_xfiber_t *tail;
+    atomic_size_t runnable;             // Length of the run queue, read without the lock by yield
+    size_t live;                        // Fibers spawned and not yet finished
+    int32_t idle;
+    int32_t shutdown;
+    fossil_xfiber_t *cache;             // Released fibers, stacks included
+    size_t cached;
+    size_t stack_size;
+    size_t page_size;
+    fossil_xtimer_wheel_t timers;
+    fiber_worker_t *workers;
+    int32_t worker_count;
+};
+
+static _Thread_local fiber_worker_t *fiber_current_worker = NULL;
+
+// Kept out of line so that code resumed on another worker never reuses a cached address of the thread-local
+static FIBER_NOINLINE fiber_worker_t *fiber_worker_get(void) {
+    return fiber_current_worker;
+}
+
+static void fiber_timer_fired(void *arg);
+
+static fossil_xfiber_t *fiber_self(void) {
+    fiber_worker_t *worker = fiber_worker_get();
+    return worker ? worker->running : NULL;
+}
+
+// *****************************************************************************
+// Context switch
+// *****************************************************************************
+
+#if defined(FIBER_ASM)
+
+void fossil_fiber_switch_context(void **save_sp, void *next_sp);
+
+#if defined(__APPLE__)
+#define FIBER_ASM_PROLOGUE ".text\n.globl _fossil_fiber_switch_context\n.private_extern _fossil_fiber_switch_context\n.p2align 4\n_fossil_fiber_switch_context:\n"
+#define FIBER_ASM_EPILOGUE ""
+#else
+#define FIBER_ASM_PROLOGUE ".text\n.globl fossil_fiber_switch_context\n.hidden fossil_fiber_switch_context\n" \
+                           ".type fossil_fiber_switch_context, %function\n.p2align 4\nfossil_fiber_switch_context:\n"
+#define FIBER_ASM_EPILOGUE ".size fossil_fiber_switch_context, .-fossil_fiber_switch_context\n"
+#endif
+
+#if defined(__x86_64__)
+// System V: rbx, rbp and r12-r15 are callee-saved, plus the SSE and x87 control words
+__asm__(
+    FIBER_ASM_PROLOGUE
+    "    pushq %rbp\n"
+    "    pushq %rbx\n"
+    "    pushq %r12\n"
+    "    pushq %r13\n"
+    "    pushq %r14\n"
+    "    pushq %r15\n"
+    "    subq $8, %rsp\n"
+    "    stmxcsr (%rsp)\n"
+    "    fnstcw 4(%rsp)\n"
+    "    movq %rsp, (%rdi)\n"
+    "    movq %rsi, %rsp\n"
+    "    ldmxcsr (%rsp)\n"
+    "    fldcw 4(%rsp)\n"
+    "    addq $8, %rsp\n"
+    "    popq %r15\n"
+    "    popq %r14\n"
+    "    popq %r13\n"
+    "    popq %r12\n"
+    "    popq %rbx\n"
+    "    popq %rbp\n"
+    "    ret\n"
+    FIBER_ASM_EPILOGUE
+);
+#define FIBER_FRAME_SIZE 64             // Control words, six registers, return address
+#else
+// AAPCS64: x19-x28, the frame pointer, the link register and the low halves of v8-v15
+__asm__(
+    FIBER_ASM_PROLOGUE
+    "    sub sp, sp, #160\n"
+    "    stp x19, x20, [sp, #0]\n"
+    "    stp x21, x22, [sp, #16]\n"
+    "    stp x23, x24, [sp, #32]\n"
+    "    stp x25, x26, [sp, #48]\n"
+    "    stp x27, x28, [sp, #64]\n"
+    "    stp x29, x30, [sp, #80]\n"
+    "    stp d8, d9, [sp, #96]\n"
+    "    stp d10, d11, [sp, #112]\n"
+    "    stp d12, d13, [sp, #128]\n"
+    "    stp d14, d15, [sp, #144]\n"
+    "    mov x9, sp\n"
+    "    str x9, [x0]\n"
+    "    mov sp, x1\n"
+    "    ldp x19, x20, [sp, #0]\n"
+    "    ldp x21, x22, [sp, #16]\n"
+    "    ldp x23, x24, [sp, #32]\n"
+    "    ldp x25, x26, [sp, #48]\n"
+    "    ldp x27, x28, [sp, #64]\n"
+    "    ldp x29, x30, [sp, #80]\n"
+    "    ldp d8, d9, [sp, #96]\n"
+    "    ldp d10, d11, [sp, #112]\n"
+    "    ldp d12, d13, [sp, #128]\n"
+    "    ldp d14, d15, [sp, #144]\n"
+    "    add sp, sp, #160\n"
+    "    ret\n"
+    FIBER_ASM_EPILOGUE
+);
+#define FIBER_FRAME_SIZE 160
+#endif
+
+#endif // FIBER_ASM
+
+static void fiber_switch(fiber_context_t *from, fiber_context_t *to) {
+#ifdef FIBER_TSAN
+    __tsan_switch_to_fiber(to->tsan, 0);
+#endif
+#if defined(FIBER_WINDOWS)
+    (void)from;
+    SwitchToFiber(to->handle);
+#elif defined(FIBER_UCONTEXT)
+    swapcontext(&from->context, &to->context);
+#else
+    fossil_fiber_switch_context(&from->sp, to->sp);
+#endif
+}
+
+static void fiber_suspend(fossil_xfiber_t *fiber, fiber_action_t action) {
+    fiber_worker_t *worker = fiber->worker;
+    worker->action = action;
+    fiber_switch(&fiber->context, &worker->context);
+}
+
+// First code run on a fresh fiber stack; it never returns, the finished fiber is simply never resumed
+static void fiber_entry(void) {
+    fossil_xfiber_t *fiber = fiber_self();
+    fiber->func(fiber->arg);
+    fiber_suspend(fiber, FIBER_DONE);
+}
+
+#ifdef FIBER_WINDOWS
+static VOID CALLBACK fiber_start(LPVOID param) {
+    (void)param;
+    fiber_entry();
+}
+#endif
+
+/**
+ * @brief Sets up a fiber's context so that switching to it runs fiber_entry on an empty stack.
+ *
+ * @param fiber Pointer to the fiber.
+ * @return int32_t 0 on success, -1 otherwise.
+ */
+static int32_t fiber_prepare(fossil_xfiber_t *fiber) {
+#ifdef FIBER_TSAN
+    // A finished fiber never returns from fiber_entry, so a reused one needs a fresh sanitizer stack
+    if (fiber->context.tsan) {
+        __tsan_destroy_fiber(fiber->context.tsan);
+    }
+    fiber->context.tsan = __tsan_create_fiber(0);
+#endif
+#if defined(FIBER_WINDOWS)
+    fiber->context.handle = CreateFiber(fiber->scheduler->stack_size, fiber_start, NULL);
+    return fiber->context.handle ? FOSSIL_SUCCESS : FOSSIL_ERROR;
+#else
+    uintptr_t top = (uintptr_t)fiber & ~(uintptr_t)15;
+#if defined(FIBER_UCONTEXT)
+    char *base = (char *)fiber->stack + fiber->scheduler->page_size;
+    if (getcontext(&fiber->context.context) != 0) {
+        return FOSSIL_ERROR;
+    }
+    fiber->context.context.uc_stack.ss_sp = base;
+    fiber->context.context.uc_stack.ss_size = (size_t)(top - (uintptr_t)base);
+    fiber->context.context.uc_link = NULL;
+    makecontext(&fiber->context.context, fiber_entry, 0);
+#else
+    void (*entry)(void) = fiber_entry;
+#if defined(__x86_64__)
+    // Returning into fiber_entry leaves rsp 8 past a 16-byte boundary, as if it had been called
+    uint64_t *frame = (uint64_t *)(top - FIBER_FRAME_SIZE - 8);
+    uint32_t control[2] = {FIBER_MXCSR_DEFAULT, FIBER_FPUCW_DEFAULT};
+    memset(frame, 0, FIBER_FRAME_SIZE);
+    memcpy(&frame[0], control, sizeof(control));
+    memcpy(&frame[7], &entry, sizeof(entry));
+#else
+    uint64_t *frame = (uint64_t *)(top - FIBER_FRAME_SIZE);
+    memset(frame, 0, FIBER_FRAME_SIZE);
+    memcpy(&frame[11], &entry, sizeof(entry)); // x30, loaded by the pair at offset 80
+#endif
+    fiber->context.sp = frame;
+#endif
+    return FOSSIL_SUCCESS;
+#endif
+}
+
+// *****************************************************************************
+// Fiber memory
+// *****************************************************************************
+
+/**
+ * @brief Maps a fiber: a guard page, the stack, and the fiber itself at the top of the stack.
+ *
+ * @param scheduler Pointer to the scheduler.
+ * @return fossil_xfiber_t* The fiber, or NULL on failure.
+ */
+static fossil_xfiber_t *fiber_map(fossil_xfiber_scheduler_t *scheduler) {
+#ifdef FIBER_WINDOWS
+    fossil_xfiber_t *fiber = (fossil_xfiber_t *)calloc(1, sizeof(fossil_xfiber_t));
+    if (!fiber) {
+        return NULL;
+    }
+#else
+    size_t page = scheduler->page_size;
+    size_t mapped = page + (scheduler->stack_size + sizeof(fossil_xfiber_t) + 64 + page - 1) / page * page;
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_STACK
+    flags |= MAP_STACK;
+#endif
+    void *stack = mmap(NULL, mapped, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (stack == MAP_FAILED) {
+        return NULL;
+    }
+    if (mprotect(stack, page, PROT_NONE) != 0) {
+        munmap(stack, mapped);
+        return NULL;
+    }
+    uintptr_t end = (uintptr_t)stack + mapped - sizeof(fossil_xfiber_t);
+    fossil_xfiber_t *fiber = (fossil_xfiber_t *)(end & ~(uintptr_t)63);
+    memset(fiber, 0, sizeof(fossil_xfiber_t));
+    fiber->stack = stack;
+    fiber->mapped = mapped;
+#endif
+    fiber->scheduler = scheduler;
+    fossil_timer_init(&fiber->timer, fiber_timer_fired, fiber);
+    if (fossil_mutex_create(&fiber->lock) == 0) {
+        if (fossil_cond_create(&fiber->cond) == 0) {
+            return fiber;
+        }
+        fossil_mutex_erase(&fiber->lock);
+    }
+#ifdef FIBER_WINDOWS
+    free(fiber);
+#else
+    munmap(fiber->stack, fiber->mapped);
+#endif
+    return NULL;
+}
+
+static void fiber_unmap(fossil_xfiber_t *fiber) {
+#ifdef FIBER_TSAN
+    if (fiber->context.tsan) {
+        __tsan_destroy_fiber(fiber->context.tsan);
+    }
+#endif
+    fossil_cond_erase(&fiber->cond);
+    fossil_mutex_erase(&fiber->lock);
+#ifdef FIBER_WINDOWS
+    free(fiber);
+#else
+    munmap(fiber->stack, fiber->mapped);
+#endif
+}
+
+static fossil_xfiber_t *fiber_alloc(fossil_xfiber_scheduler_t *scheduler) {
+    fossil_mutex_lock(&scheduler->mutex);
+    fossil_xfiber_t *fiber = scheduler->cache;
+    if (fiber) {
+        scheduler->cache = fiber->next;
+        scheduler->cached--;
+    }
+    fossil_mutex_unlock(&scheduler->mutex);
+    return fiber ? fiber : fiber_map(scheduler);
+}
+
+// Returns a finished fiber that nobody refers to any more to the cache
+static void fiber_release(fossil_xfiber_t *fiber) {
+    fossil_xfiber_scheduler_t *scheduler = fiber->scheduler;
+#ifdef FIBER_WINDOWS
+    DeleteFiber(fiber->context.handle);
+    fiber->context.handle = NULL;
+#endif
+    fossil_mutex_lock(&scheduler->mutex);
+    if (scheduler->cached < FOSSIL_FIBER_STACK_CACHE) {
+        fiber->next = scheduler->cache;
+        scheduler->cache = fiber;
+        scheduler->cached++;
+        fiber = NULL;
+    }
+    fossil_mutex_unlock(&scheduler->mutex);
+    if (fiber) {
+        fiber_unmap(fiber);
+    }
+}
+
+// *****************************************************************************
+// Scheduling
+// *****************************************************************************
+
+static void fiber_ready(fossil_xfiber_t *fiber) {
+    fossil_xfiber_scheduler_t *scheduler = fiber->scheduler;
+    fiber->next = NULL;
+    fossil_mutex_lock(&scheduler->mutex);
+    if (scheduler->tail) {
+        scheduler->tail->next = fiber;
+    } else {
+        scheduler->head = fiber;
+    }
+    scheduler->tail = fiber;
+    atomic_fetch_add_explicit(&scheduler->runnable, 1, memory_order_relaxed);
+    if (scheduler->idle > 0) {
+        fossil_cond_signal(&scheduler->wake);
+    }
+    fossil_mutex_unlock(&scheduler->mutex);
+}
+
+static void fiber_timer_fired(void *arg) {
+    fiber_ready((fossil_xfiber_t *)arg);
+}
+
+// Makes a parking fiber runnable; if its worker has not seen it park yet, the worker does it instead
+static void fiber_notify(fossil_xfiber_t *fiber) {
+    if (atomic_exchange(&fiber->park, FIBER_NOTIFIED) == FIBER_PARKED) {
+        atomic_store(&fiber->park, FIBER_RUNNING);
+        fiber_ready(fiber);
+    }
+}
+
+static void fiber_wake(fossil_xcond_t *cond, fossil_xfiber_waiter_t *waiter) {
+    fossil_xfiber_t *fiber = waiter->fiber;
+    waiter->woken = 1;
+    if (fiber) {
+        fiber_notify(fiber);
+    } else {
+        fossil_cond_broadcast(cond);
+    }
+}
+
+/**
+ * @brief Waits until a waiter is woken. Called with the primitive's lock held, returns with it released.
+ *
+ * A fiber may be woken as soon as it lets go of the lock, before it is off its stack; the park
+ * handshake keeps it from being resumed until its worker has switched away from it.
+ */
+static void fiber_block(fossil_xmutex_t *lock, fossil_xcond_t *cond, fossil_xfiber_waiter_t *waiter) {
+    if (waiter->fiber) {
+        fossil_mutex_unlock(lock);
+        fiber_suspend(waiter->fiber, FIBER_PARK);
+        return;
+    }
+    while (!waiter->woken) {
+        fossil_cond_wait(cond, lock);
+    }
+    fossil_mutex_unlock(lock);
+}
+
+static void fiber_waiter_push(fossil_xfiber_waiter_t **head, fossil_xfiber_waiter_t **tail, fossil_xfiber_waiter_t *waiter) {
+    waiter->next = NULL;
+    if (*tail) {
+        (*tail)->next = waiter;
+    } else {
+        *head = waiter;
+    }
+    *tail = waiter;
+}
+
+static fossil_xfiber_waiter_t *fiber_waiter_pop(fossil_xfiber_waiter_t **head, fossil_xfiber_waiter_t **tail) {
+    fossil_xfiber_waiter_t *waiter = *head;
+    if (waiter) {
+        *head = waiter->next;
+        if (!*head) {
+            *tail = NULL;
+        }
+    }
+    return waiter;
+}
+
+// Runs on the worker once a finished fiber is off its stack
+static void fiber_finish(fossil_xfiber_t *fiber) {
+    fossil_xfiber_scheduler_t *scheduler = fiber->scheduler;
+    fossil_mutex_lock(&fiber->lock);
+    fiber->done = 1;
+    int32_t detached = fiber->detached;
+    if (fiber->joiner) {
+        fiber_wake(&fiber->cond, fiber->joiner);
+    }
+    fossil_mutex_unlock(&fiber->lock);
+    if (detached) {
+        fiber_release(fiber);
+    }
+
+    fossil_mutex_lock(&scheduler->mutex);
+    if (--scheduler->live == 0) {
+        fossil_cond_broadcast(&scheduler->drained);
+    }
+    fossil_mutex_unlock(&scheduler->mutex);
+}
+
+static void fiber_worker_main(void *arg) {
+    fiber_worker_t *worker = (fiber_worker_t *)arg;
+    fossil_xfiber_scheduler_t *scheduler = worker->scheduler;
+    fiber_current_worker = worker;
+#ifdef FIBER_TSAN
+    worker->context.tsan = __tsan_get_current_fiber();
+#endif
+#ifdef FIBER_WINDOWS
+    worker->context.handle = ConvertThreadToFiber(NULL);
+    if (!worker->context.handle) {
+        return;
+    }
+#endif
+
+    fossil_mutex_lock(&scheduler->mutex);
+    for (;;) {
+        while (!scheduler->head && !scheduler->shutdown) {
+            scheduler->idle++;
+            fossil_cond_wait(&scheduler->wake, &scheduler->mutex);
+            scheduler->idle--;
+        }
+        fossil_xfiber_t *fiber = scheduler->head;
+        if (!fiber) {
+            break;
+        }
+        scheduler->head = fiber->next;
+        if (!scheduler->head) {
+            scheduler->tail = NULL;
+        }
+        atomic_fetch_sub_explicit(&scheduler->runnable, 1, memory_order_relaxed);
+        fossil_mutex_unlock(&scheduler->mutex);
+
+        fiber->worker = worker;
+        worker->running = fiber;
+        fiber_switch(&worker->context, &fiber->context);
+        worker->running = NULL;
+
+        switch (worker->action) {
+            case FIBER_YIELD:
+                fiber->next = NULL;
+                fossil_mutex_lock(&scheduler->mutex);
+                if (scheduler->tail) {
+                    scheduler->tail->next = fiber;
+                } else {
+                    scheduler->head = fiber;
+                }
+                scheduler->tail = fiber;
+                atomic_fetch_add_explicit(&scheduler->runnable, 1, memory_order_relaxed);
+                continue;
+            case FIBER_PARK:
+                if (atomic_exchange(&fiber->park, FIBER_PARKED) == FIBER_NOTIFIED) {
+                    atomic_store(&fiber->park, FIBER_RUNNING);
+                    fiber_ready(fiber);
+                }
+                break;
+            case FIBER_SLEEP:
+                if (fossil_timer_start(&scheduler->timers, &fiber->timer, fiber->sleep_ms, 0) != 0) {
+                    fiber_ready(fiber);
+                }
+                break;
+            default:
+                fiber_finish(fiber);
+                break;
+        }
+        fossil_mutex_lock(&scheduler->mutex);
+    }
+    fossil_mutex_unlock(&scheduler->mutex);
+
+#ifdef FIBER_WINDOWS
+    ConvertFiberToThread();
+#endif
+    fiber_current_worker = NULL;
+}
+
+// *****************************************************************************
+// Scheduler
+// *****************************************************************************
+
+fossil_xfiber_scheduler_t* fossil_fiber_scheduler_create(int32_t workers, size_t stack_size) {
+    if (workers <= 0) {
+        return NULL;
+    }
+    fossil_xfiber_scheduler_t *scheduler = (fossil_xfiber_scheduler_t *)calloc(1, sizeof(fossil_xfiber_scheduler_t));
+    if (!scheduler) {
+        return NULL;
+    }
+    scheduler->workers = (fiber_worker_t *)calloc((size_t)workers, sizeof(fiber_worker_t));
+    if (!scheduler->workers) {
+        free(scheduler);
+        return NULL;
+    }
+    atomic_init(&scheduler->runnable, 0);
+    scheduler->stack_size = stack_size ? stack_size : FOSSIL_FIBER_DEFAULT_STACK;
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    scheduler->page_size = info.dwPageSize;
+#else
+    long page = sysconf(_SC_PAGESIZE);
+    scheduler->page_size = page > 0 ? (size_t)page : 4096;
+#endif
+
+    if (fossil_mutex_create(&scheduler->mutex) != 0) {
+        free(scheduler->workers);
+        free(scheduler);
+        return NULL;
+    }
+    if (fossil_cond_create(&scheduler->wake) != 0) {
+        fossil_mutex_erase(&scheduler->mutex);
+        free(scheduler->workers);
+        free(scheduler);
+        return NULL;
+    }
+    if (fossil_cond_create(&scheduler->drained) != 0) {
+        fossil_cond_erase(&scheduler->wake);
+        fossil_mutex_erase(&scheduler->mutex);
+        free(scheduler->workers);
+        free(scheduler);
+        return NULL;
+    }
+    if (fossil_timer_wheel_create(&scheduler->timers, NULL, FOSSIL_TIMER_DEFAULT_TICK_US) != 0) {
+        fossil_cond_erase(&scheduler->drained);
+        fossil_cond_erase(&scheduler->wake);
+        fossil_mutex_erase(&scheduler->mutex);
+        free(scheduler->workers);
+        free(scheduler);
+        return NULL;
+    }
+
+    for (int32_t i = 0; i < workers; ++i) {
+        fiber_worker_t *worker = &scheduler->workers[i];
+        fossil_xtask_t task = {fiber_worker_main, worker};
+        worker->scheduler = scheduler;
+        if (fossil_thread_create(&worker->thread, NULL, task) != 0) {
+            // Nothing has been spawned yet, so erasing stops and joins the workers that did start
+            fossil_fiber_scheduler_erase(scheduler);
+            return NULL;
+        }
+        scheduler->worker_count++;
+    }
+    return scheduler;
+}
+
+int32_t fossil_fiber_scheduler_erase(fossil_xfiber_scheduler_t *scheduler) {
+    fiber_worker_t *worker = fiber_worker_get();
+    if (!scheduler || (worker && worker->scheduler == scheduler)) {
+        return FOSSIL_ERROR;
+    }
+
+    fossil_mutex_lock(&scheduler->mutex);
+    while (scheduler->live > 0) {
+        fossil_cond_wait(&scheduler->drained, &scheduler->mutex);
+    }
+    scheduler->shutdown = 1;
+    fossil_cond_broadcast(&scheduler->wake);
+    fossil_mutex_unlock(&scheduler->mutex);
+    for (int32_t i = 0; i < scheduler->worker_count; ++i) {
+        fossil_thread_join(scheduler->workers[i].thread, NULL);
+    }
+    fossil_timer_wheel_erase(&scheduler->timers);
+
+    while (scheduler->cache) {
+        fossil_xfiber_t *fiber = scheduler->cache;
+        scheduler->cache = fiber->next;
+        fiber_unmap(fiber);
+    }
+    fossil_cond_erase(&scheduler->drained);
+    fossil_cond_erase(&scheduler->wake);
+    fossil_mutex_erase(&scheduler->mutex);
+    free(scheduler->workers);
+    free(scheduler);
+    return FOSSIL_SUCCESS;
+}
+
+// *****************************************************************************
+// Fibers
+// *****************************************************************************
+
+fossil_xfiber_t* fossil_fiber_spawn(fossil_xfiber_scheduler_t *scheduler, fossil_xtask_func_t task_func, void *arg) {
+    if (!scheduler || !task_func) {
+        return NULL;
+    }
+    fossil_xfiber_t *fiber = fiber_alloc(scheduler);
+    if (!fiber) {
+        return NULL;
+    }
+    fiber->func = task_func;
+    fiber->arg = arg;
+    fiber->done = 0;
+    fiber->detached = 0;
+    fiber->joiner = NULL;
+    atomic_init(&fiber->park, FIBER_RUNNING);
+    if (fiber_prepare(fiber) != 0) {
+        fiber_release(fiber);
+        return NULL;
+    }
+
+    fossil_mutex_lock(&scheduler->mutex);
+    scheduler->live++;
+    fossil_mutex_unlock(&scheduler->mutex);
+    fiber_ready(fiber);
+    return fiber;
+}
+
+int32_t fossil_fiber_join(fossil_xfiber_t *fiber) {
+    fossil_xfiber_t *self = fiber_self();
+    if (!fiber || fiber == self) {
+        return FOSSIL_ERROR;
+    }
+
+    fossil_mutex_lock(&fiber->lock);
+    if (fiber->done) {
+        fossil_mutex_unlock(&fiber->lock);
+    } else {
+        fossil_xfiber_waiter_t waiter = {NULL, self, 0};
+        fiber->joiner = &waiter;
+        fiber_block(&fiber->lock, &fiber->cond, &waiter);
+        // The finishing worker wakes us while it still holds the lock; wait for it to let go before the fiber is freed
+        fossil_mutex_lock(&fiber->lock);
+        fossil_mutex_unlock(&fiber->lock);
+    }
+    fiber_release(fiber);
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_fiber_detach(fossil_xfiber_t *fiber) {
+    if (!fiber) {
+        return FOSSIL_ERROR;
+    }
+
+    fossil_mutex_lock(&fiber->lock);
+    int32_t done = fiber->done;
+    fiber->detached = 1;
+    fossil_mutex_unlock(&fiber->lock);
+    if (done) {
+        fiber_release(fiber);
+    }
+    return FOSSIL_SUCCESS;
+}
+
+void fossil_fiber_yield(void) {
+    fossil_xfiber_t *self = fiber_self();
+    if (!self) {
+#ifdef _WIN32
+        SwitchToThread();
+#else
+        sched_yield();
+#endif
+        return;
+    }
+    if (atomic_load_explicit(&self->scheduler->runnable, memory_order_relaxed) > 0) {
+        fiber_suspend(self, FIBER_YIELD);
+    }
+}
+
+void fossil_fiber_sleep(uint32_t milliseconds) {
+    fossil_xfiber_t *self = fiber_self();
+    if (!self) {
+        fossil_task_delay_milliseconds(milliseconds);
+    } else if (milliseconds == 0) {
+        fossil_fiber_yield();
+    } else {
+        self->sleep_ms = milliseconds;
+        fiber_suspend(self, FIBER_SLEEP);
+    }
+}
+
+fossil_xfiber_t* fossil_fiber_current(void) {
+    return fiber_self();
+}
+
+// *****************************************************************************
+// Mutex
+// *****************************************************************************
+
+int32_t fossil_fiber_mutex_create(fossil_xfiber_mutex_t *mutex) {
+    if (!mutex) {
+        return FOSSIL_ERROR;
+    }
+    mutex->locked = 0;
+    mutex->head = NULL;
+    mutex->tail = NULL;
+    if (fossil_mutex_create(&mutex->lock) != 0) {
+        return FOSSIL_ERROR;
+    }
+    if (fossil_cond_create(&mutex->cond) != 0) {
+        fossil_mutex_erase(&mutex->lock);
+        return FOSSIL_ERROR;
+    }
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_fiber_mutex_erase(fossil_xfiber_mutex_t *mutex) {
+    if (!mutex || mutex->locked || mutex->head) {
+        return FOSSIL_ERROR;
+    }
+    fossil_cond_erase(&mutex->cond);
+    fossil_mutex_erase(&mutex->lock);
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_fiber_mutex_lock(fossil_xfiber_mutex_t *mutex) {
+    if (!mutex) {
+        return FOSSIL_ERROR;
+    }
+
+    fossil_mutex_lock(&mutex->lock);
+    if (!mutex->locked) {
+        mutex->locked = 1;
+        fossil_mutex_unlock(&mutex->lock);
+        return FOSSIL_SUCCESS;
+    }
+    // Unlock hands the mutex straight to the first waiter, so a woken waiter owns it
+    fossil_xfiber_waiter_t waiter = {NULL, fiber_self(), 0};
+    fiber_waiter_push(&mutex->head, &mutex->tail, &waiter);
+    fiber_block(&mutex->lock, &mutex->cond, &waiter);
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_fiber_mutex_trylock(fossil_xfiber_mutex_t *mutex) {
+    if (!mutex) {
+        return FOSSIL_ERROR;
+    }
+
+    fossil_mutex_lock(&mutex->lock);
+    int32_t acquired = !mutex->locked;
+    mutex->locked = 1;
+    fossil_mutex_unlock(&mutex->lock);
+    return acquired ? FOSSIL_SUCCESS : FOSSIL_ERROR;
+}
+
+int32_t fossil_fiber_mutex_unlock(fossil_xfiber_mutex_t *mutex) {
+    if (!mutex) {
+        return FOSSIL_ERROR;
+    }
+
+    fossil_mutex_lock(&mutex->lock);
+    if (!mutex->locked) {
+        fossil_mutex_unlock(&mutex->lock);
+        return FOSSIL_ERROR;
+    }
+    fossil_xfiber_waiter_t *waiter = fiber_waiter_pop(&mutex->head, &mutex->tail);
+    if (waiter) {
+        fiber_wake(&mutex->cond, waiter);
+    } else {
+        mutex->locked = 0;
+    }
+    fossil_mutex_unlock(&mutex->lock);
+    return FOSSIL_SUCCESS;
+}
+
+// *****************************************************************************
+// Condition variable
+// *****************************************************************************
+
+int32_t fossil_fiber_cond_create(fossil_xfiber_cond_t *cond) {
+    if (!cond) {
+        return FOSSIL_ERROR;
+    }
+    cond->head = NULL;
+    cond->tail = NULL;
+    if (fossil_mutex_create(&cond->lock) != 0) {
+        return FOSSIL_ERROR;
+    }
+    if (fossil_cond_create(&cond->cond) != 0) {
+        fossil_mutex_erase(&cond->lock);
+        return FOSSIL_ERROR;
+    }
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_fiber_cond_erase(fossil_xfiber_cond_t *cond) {
+    if (!cond || cond->head) {
+        return FOSSIL_ERROR;
+    }
+    fossil_cond_erase(&cond->cond);
+    fossil_mutex_erase(&cond->lock);
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_fiber_cond_wait(fossil_xfiber_cond_t *cond, fossil_xfiber_mutex_t *mutex) {
+    if (!cond || !mutex) {
+        return FOSSIL_ERROR;
+    }
+
+    // Queued before the mutex is released, so a signal sent once the caller lets go is not lost
+    fossil_xfiber_waiter_t waiter = {NULL, fiber_self(), 0};
+    fossil_mutex_lock(&cond->lock);
+    fiber_waiter_push(&cond->head, &cond->tail, &waiter);
+    fossil_fiber_mutex_unlock(mutex);
+    fiber_block(&cond->lock, &cond->cond, &waiter);
+    return fossil_fiber_mutex_lock(mutex);
+}
+
+int32_t fossil_fiber_cond_signal(fossil_xfiber_cond_t *cond) {
+    if (!cond) {
+        return FOSSIL_ERROR;
+    }
+
+    fossil_mutex_lock(&cond->lock);
+    fossil_xfiber_waiter_t *waiter = fiber_waiter_pop(&cond->head, &cond->tail);
+    if (waiter) {
+        fiber_wake(&cond->cond, waiter);
+    }
+    fossil_mutex_unlock(&cond->lock);
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_fiber_cond_broadcast(fossil_xfiber_cond_t *cond) {
+    if (!cond) {
+        return FOSSIL_ERROR;
+    }
+
+    fossil_mutex_lock(&cond->lock);
+    fossil_xfiber_waiter_t *waiter;
+    while ((waiter = fiber_waiter_pop(&cond->head, &cond->tail)) != NULL) {
+        fiber_wake(&cond->cond, waiter);
+    }
+    fossil_mutex_unlock(&cond->lock);
+    return FOSSIL_SUCCESS;
+}
+
+// *****************************************************************************
+// Channel
+// *****************************************************************************
+
+int32_t fossil_fiber_channel_create(fossil_xfiber_channel_t *channel, size_t capacity) {
+    if (!channel || capacity == 0) {
+        return FOSSIL_ERROR;
+    }
+    channel->items = (void **)malloc(sizeof(void *) * capacity);
+    if (!channel->items) {
+        return FOSSIL_ERROR;
+    }
+    channel->capacity = capacity;
+    channel->head = 0;
+    channel->count = 0;
+    channel->closed = 0;
+
+    if (fossil_fiber_mutex_create(&channel->mutex) != 0) {
+        free(channel->items);
+        channel->items = NULL;
+        return FOSSIL_ERROR;
+    }
+    if (fossil_fiber_cond_create(&channel->not_empty) != 0) {
+        fossil_fiber_mutex_erase(&channel->mutex);
+        free(channel->items);
+        channel->items = NULL;
+        return FOSSIL_ERROR;
+    }
+    if (fossil_fiber_cond_create(&channel->not_full) != 0) {
+        fossil_fiber_cond_erase(&channel->not_empty);
+        fossil_fiber_mutex_erase(&channel->mutex);
+        free(channel->items);
+        channel->items = NULL;
+        return FOSSIL_ERROR;
+    }
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_fiber_channel_erase(fossil_xfiber_channel_t *channel) {
+    if (!channel || !channel->items) {
+        return FOSSIL_ERROR;
+    }
+    fossil_fiber_cond_erase(&channel->not_full);
+    fossil_fiber_cond_erase(&channel->not_empty);
+    fossil_fiber_mutex_erase(&channel->mutex);
+    free(channel->items);
+    channel->items = NULL;
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_fiber_channel_send(fossil_xfiber_channel_t *channel, void *item) {
+    if (!channel) {
+        return FOSSIL_ERROR;
+    }
+
+    fossil_fiber_mutex_lock(&channel->mutex);
+    while (channel->count == channel->capacity && !channel->closed) {
+        fossil_fiber_cond_wait(&channel->not_full, &channel->mutex);
+    }
+    if (channel->closed) {
+        fossil_fiber_mutex_unlock(&channel->mutex);
+        return FOSSIL_ERROR;
+    }
+    channel->items[(channel->head + channel->count) % channel->capacity] = item;
+    channel->count++;
+    fossil_fiber_cond_signal(&channel->not_empty);
+    fossil_fiber_mutex_unlock(&channel->mutex);
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_fiber_channel_recv(fossil_xfiber_channel_t *channel, void **item) {
+    if (!channel || !item) {
+        return FOSSIL_ERROR;
+    }
+
+    fossil_fiber_mutex_lock(&channel->mutex);
+    while (channel->count == 0 && !channel->closed) {
+        fossil_fiber_cond_wait(&channel->not_empty, &channel->mutex);
+    }
+    if (channel->count == 0) {
+        fossil_fiber_mutex_unlock(&channel->mutex);
+        return FOSSIL_ERROR;
+    }
+    *item = channel->items[channel->head];
+    channel->head = (channel->head + 1) % channel->capacity;
+    channel->count--;
+    fossil_fiber_cond_signal(&channel->not_full);
+    fossil_fiber_mutex_unlock(&channel->mutex);
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_fiber_channel_close(fossil_xfiber_channel_t *channel) {
+    if (!channel) {
+        return FOSSIL_ERROR;
+    }
+
+    fossil_fiber_mutex_lock(&channel->mutex);
+    channel->closed = 1;
+    fossil_fiber_cond_broadcast(&channel->not_empty);
+    fossil_fiber_cond_broadcast(&channel->not_full);
+    fossil_fiber_mutex_unlock(&channel->mutex);
+    return FOSSIL_SUCCESS;
+}
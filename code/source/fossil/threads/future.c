@@ -0,0 +1,338 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L // for clock_gettime
+#endif
+#include "fossil/threads/future.h"
+#include "fossil/common/common.h"
+#include <stdalign.h>
+#include <stdlib.h>
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+typedef enum {
+    FOSSIL_FUTURE_TASK,
+    FOSSIL_FUTURE_PROMISE,
+    FOSSIL_FUTURE_THEN,
+    FOSSIL_FUTURE_ALL,
+    FOSSIL_FUTURE_ANY
+} fossil_xfuture_kind_t;
+
+// Registration of a future on one of the futures it depends on
+typedef struct fossil_xfuture_link_t {
+    struct fossil_xfuture_link_t *next;
+    fossil_xfuture_t *dependent;
+} fossil_xfuture_link_t;
+
+// The task, its result, its waiters and any payload live in this one allocation
+struct fossil_xfuture_t {
+    fossil_xmutex_t mutex;
+    fossil_xcond_t cond;
+    atomic_int ready;
+    atomic_int refs;
+    atomic_size_t remaining;        // Sources not yet complete, for when_all and when_any
+    fossil_xfuture_kind_t kind;
+    fossil_xfuture_func_t func;
+    fossil_xfuture_then_func_t then_func;
+    void *arg;
+    void *input;                    // Result of the source of a continuation
+    void *result;
+    fossil_xthread_pool_t *pool;
+    fossil_xfuture_link_t *waiters; // Dependents to notify on completion, guarded by mutex
+    void (*destroy)(void *payload);
+    size_t link_count;
+    fossil_xfuture_link_t links[];  // This future's registrations on its sources
+};
+
+static void future_notify(fossil_xfuture_t *dependent, fossil_xfuture_t *source, void *result);
+
+// Offset of the payload, after the links and aligned for any type
+static size_t future_payload_offset(size_t link_count) {
+    size_t offset = sizeof(fossil_xfuture_t) + sizeof(fossil_xfuture_link_t) * link_count;
+    size_t align = alignof(max_align_t);
+    return (offset + align - 1) / align * align;
+}
+
+static fossil_xfuture_t* future_alloc(fossil_xfuture_kind_t kind, size_t link_count, size_t payload_size, int refs) {
+    size_t size = payload_size ? future_payload_offset(link_count) + payload_size
+                               : sizeof(fossil_xfuture_t) + sizeof(fossil_xfuture_link_t) * link_count;
+    fossil_xfuture_t *future = (fossil_xfuture_t*)calloc(1, size);
+    if (!future) return cnullptr;
+
+    if (fossil_mutex_create(&future->mutex) != 0) {
+        free(future);
+        return cnullptr;
+    }
+    if (fossil_cond_create(&future->cond) != 0) {
+        fossil_mutex_erase(&future->mutex);
+        free(future);
+        return cnullptr;
+    }
+    atomic_init(&future->ready, 0);
+    atomic_init(&future->refs, refs);
+    atomic_init(&future->remaining, link_count);
+    future->kind = kind;
+    future->link_count = link_count;
+    return future;
+}
+
+static void future_release(fossil_xfuture_t *future) {
+    if (atomic_fetch_sub_explicit(&future->refs, 1, memory_order_acq_rel) != 1) return;
+
+    // Dependents of a future that never completed will never complete either
+    fossil_xfuture_link_t *link = future->waiters;
+    while (link) {
+        fossil_xfuture_link_t *next = link->next;
+        future_release(link->dependent);
+        link = next;
+    }
+    if (future->destroy) {
+        future->destroy((char*)future + future_payload_offset(future->link_count));
+    }
+    fossil_cond_erase(&future->cond);
+    fossil_mutex_erase(&future->mutex);
+    free(future);
+}
+
+static int32_t future_complete(fossil_xfuture_t *future, void *result) {
+    fossil_mutex_lock(&future->mutex);
+    if (atomic_load_explicit(&future->ready, memory_order_relaxed)) {
+        fossil_mutex_unlock(&future->mutex);
+        return FOSSIL_ERROR;
+    }
+    future->result = result;
+    atomic_store_explicit(&future->ready, 1, memory_order_release);
+    fossil_xfuture_link_t *link = future->waiters;
+    future->waiters = cnullptr;
+    fossil_cond_broadcast(&future->cond);
+    fossil_mutex_unlock(&future->mutex);
+
+    // A notified dependent may free itself and the link with it
+    while (link) {
+        fossil_xfuture_link_t *next = link->next;
+        future_notify(link->dependent, future, result);
+        link = next;
+    }
+    return FOSSIL_SUCCESS;
+}
+
+static void future_run(void *arg) {
+    fossil_xfuture_t *future = (fossil_xfuture_t*)arg;
+    void *result = future->kind == FOSSIL_FUTURE_THEN ? future->then_func(future->input, future->arg)
+                                                      : future->func(future->arg);
+    future_complete(future, result);
+    future_release(future);
+}
+
+// Queue a future's task, which owns one reference; a full pool runs it on this thread instead
+static void future_schedule(fossil_xfuture_t *future) {
+    if (fossil_thread_pool_add_task(future->pool, future_run, future) != FOSSIL_SUCCESS) {
+        future_run(future);
+    }
+}
+
+static void future_notify(fossil_xfuture_t *dependent, fossil_xfuture_t *source, void *result) {
+    switch (dependent->kind) {
+        case FOSSIL_FUTURE_THEN:
+            // The link's reference passes to the task
+            dependent->input = result;
+            future_schedule(dependent);
+            return;
+        case FOSSIL_FUTURE_ALL:
+            if (atomic_fetch_sub(&dependent->remaining, 1) == 1) {
+                future_complete(dependent, (void*)(uintptr_t)dependent->link_count);
+            }
+            break;
+        case FOSSIL_FUTURE_ANY:
+            if (atomic_exchange(&dependent->remaining, 0) != 0) {
+                future_complete(dependent, source);
+            }
+            break;
+        default:
+            break;
+    }
+    future_release(dependent);
+}
+
+// Register a dependent on a source, or notify it at once if the source is complete
+static void future_register(fossil_xfuture_t *source, fossil_xfuture_link_t *link) {
+    fossil_mutex_lock(&source->mutex);
+    if (!atomic_load_explicit(&source->ready, memory_order_relaxed)) {
+        link->next = source->waiters;
+        source->waiters = link;
+        fossil_mutex_unlock(&source->mutex);
+        return;
+    }
+    fossil_mutex_unlock(&source->mutex);
+    future_notify(link->dependent, source, source->result);
+}
+
+// *****************************************************************************
+// Submission
+// *****************************************************************************
+
+fossil_xfuture_t* fossil_thread_pool_submit(fossil_xthread_pool_t *pool, fossil_xfuture_func_t func, void *arg) {
+    if (!pool || !func) return cnullptr;
+
+    // One reference for the caller, one for the task
+    fossil_xfuture_t *future = future_alloc(FOSSIL_FUTURE_TASK, 0, 0, 2);
+    if (!future) return cnullptr;
+    future->func = func;
+    future->arg = arg;
+    future->pool = pool;
+    future_schedule(future);
+    return future;
+}
+
+fossil_xfuture_t* fossil_thread_pool_submit_payload(fossil_xthread_pool_t *pool, fossil_xfuture_func_t func,
+                                                    size_t payload_size, void (*init)(void *payload, void *ctx),
+                                                    void *ctx, void (*destroy)(void *payload)) {
+    if (!pool || !func || payload_size == 0) return cnullptr;
+
+    fossil_xfuture_t *future = future_alloc(FOSSIL_FUTURE_TASK, 0, payload_size, 2);
+    if (!future) return cnullptr;
+    void *payload = (char*)future + future_payload_offset(0);
+    if (init) {
+        init(payload, ctx);
+    }
+    future->func = func;
+    future->arg = payload;
+    future->pool = pool;
+    future->destroy = destroy;
+    future_schedule(future);
+    return future;
+}
+
+// *****************************************************************************
+// Promises and results
+// *****************************************************************************
+
+fossil_xfuture_t* fossil_future_create(void) {
+    return future_alloc(FOSSIL_FUTURE_PROMISE, 0, 0, 1);
+}
+
+int32_t fossil_future_set(fossil_xfuture_t *future, void *result) {
+    if (!future || future->kind != FOSSIL_FUTURE_PROMISE) return FOSSIL_ERROR;
+    return future_complete(future, result);
+}
+
+void fossil_future_erase(fossil_xfuture_t *future) {
+    if (future) {
+        future_release(future);
+    }
+}
+
+bool fossil_future_is_ready(const fossil_xfuture_t *future) {
+    return future && atomic_load_explicit(&future->ready, memory_order_acquire);
+}
+
+int32_t fossil_future_wait(fossil_xfuture_t *future) {
+    if (!future) return FOSSIL_ERROR;
+    if (fossil_future_is_ready(future)) return FOSSIL_SUCCESS;
+
+    fossil_mutex_lock(&future->mutex);
+    while (!atomic_load_explicit(&future->ready, memory_order_relaxed)) {
+        fossil_cond_wait(&future->cond, &future->mutex);
+    }
+    fossil_mutex_unlock(&future->mutex);
+    return FOSSIL_SUCCESS;
+}
+
+static uint64_t future_now_ms(void) {
+#ifdef _WIN32
+    return (uint64_t)GetTickCount64();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000u + (uint64_t)now.tv_nsec / 1000000u;
+#endif
+}
+
+int32_t fossil_future_wait_for(fossil_xfuture_t *future, uint32_t milliseconds) {
+    if (!future) return FOSSIL_ERROR;
+    if (fossil_future_is_ready(future)) return FOSSIL_SUCCESS;
+
+    // Spurious wakes and signals for other waiters go back to sleep for what is left of the timeout
+    uint64_t deadline = future_now_ms() + milliseconds;
+    fossil_mutex_lock(&future->mutex);
+    while (!atomic_load_explicit(&future->ready, memory_order_relaxed)) {
+        uint64_t now = future_now_ms();
+        if (now >= deadline) break;
+        fossil_cond_timedwait(&future->cond, &future->mutex, (uint32_t)(deadline - now));
+    }
+    int ready = atomic_load_explicit(&future->ready, memory_order_relaxed);
+    fossil_mutex_unlock(&future->mutex);
+    return ready ? FOSSIL_SUCCESS : FOSSIL_ERROR;
+}
+
+void* fossil_future_get(fossil_xfuture_t *future) {
+    if (fossil_future_wait(future) != FOSSIL_SUCCESS) return cnullptr;
+    return future->result;
+}
+
+// *****************************************************************************
+// Continuations and combinators
+// *****************************************************************************
+
+fossil_xfuture_t* fossil_future_then(fossil_xfuture_t *future, fossil_xthread_pool_t *pool,
+                                     fossil_xfuture_then_func_t func, void *arg) {
+    if (!future || !pool || !func) return cnullptr;
+
+    // One reference for the caller, one for the link, which passes to the task
+    fossil_xfuture_t *next = future_alloc(FOSSIL_FUTURE_THEN, 1, 0, 2);
+    if (!next) return cnullptr;
+    next->then_func = func;
+    next->arg = arg;
+    next->pool = pool;
+    next->links[0].dependent = next;
+    future_register(future, &next->links[0]);
+    return next;
+}
+
+static fossil_xfuture_t* future_combine(fossil_xfuture_kind_t kind, fossil_xfuture_t **futures, size_t count) {
+    // One reference for the caller and one for each link until its source completes
+    fossil_xfuture_t *combined = future_alloc(kind, count, 0, (int)count + 1);
+    if (!combined) return cnullptr;
+    if (kind == FOSSIL_FUTURE_ANY) {
+        atomic_store(&combined->remaining, 1);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        combined->links[i].dependent = combined;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        future_register(futures[i], &combined->links[i]);
+    }
+    return combined;
+}
+
+fossil_xfuture_t* fossil_future_when_all(fossil_xfuture_t **futures, size_t count) {
+    if (count > 0 && !futures) return cnullptr;
+    for (size_t i = 0; i < count; ++i) {
+        if (!futures[i]) return cnullptr;
+    }
+
+    fossil_xfuture_t *combined = future_combine(FOSSIL_FUTURE_ALL, futures, count);
+    if (combined && count == 0) {
+        future_complete(combined, cnullptr);
+    }
+    return combined;
+}
+
+fossil_xfuture_t* fossil_future_when_any(fossil_xfuture_t **futures, size_t count) {
+    if (count == 0 || !futures) return cnullptr;
+    for (size_t i = 0; i < count; ++i) {
+        if (!futures[i]) return cnullptr;
+    }
+    return future_combine(FOSSIL_FUTURE_ANY, futures, count);
+}
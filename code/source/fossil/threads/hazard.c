@@ -0,0 +1,248 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#include "fossil/threads/hazard.h"
+#include "fossil/common/common.h"
+#include <stdlib.h>
+
+#define FOSSIL_HAZARD_CACHE_LINE 64
+
+typedef struct {
+    void *ptr;
+    fossil_xtask_func_t free_func;
+} hazard_retired_t;
+
+struct fossil_xhazard_record_t {
+    _Atomic(void *) slots[FOSSIL_HAZARD_SLOTS];
+    atomic_int in_use;                  // Set while a thread owns the record
+    fossil_xhazard_record_t *next;      // Fixed once the record is published
+    hazard_retired_t *retired;
+    size_t count;
+    size_t capacity;
+    void **scratch;                     // Hazard pointers collected by a scan
+    size_t scratch_capacity;
+    char pad[FOSSIL_HAZARD_CACHE_LINE]; // Keeps the next allocation off the slots of this one
+};
+
+// Runs at thread exit through the thread-local key; the record keeps its retired list for the next owner
+static void hazard_thread_exit(void *arg) {
+    fossil_xhazard_record_t *record = (fossil_xhazard_record_t *)arg;
+    for (size_t i = 0; i < FOSSIL_HAZARD_SLOTS; ++i) {
+        atomic_store_explicit(&record->slots[i], NULL, memory_order_release);
+    }
+    atomic_store_explicit(&record->in_use, 0, memory_order_release);
+}
+
+/**
+ * @brief Gets the calling thread's record, adopting a free one or publishing a new one on first use.
+ *
+ * @param domain Pointer to the domain.
+ * @return fossil_xhazard_record_t* The record, or NULL if the thread cannot be registered.
+ */
+static fossil_xhazard_record_t *hazard_record(fossil_xhazard_domain_t *domain) {
+    fossil_xhazard_record_t *record = (fossil_xhazard_record_t *)fossil_thread_local_get(domain->key);
+    if (record) {
+        return record;
+    }
+
+    for (record = atomic_load(&domain->records); record; record = record->next) {
+        int expected = 0;
+        if (atomic_load_explicit(&record->in_use, memory_order_relaxed) == 0 &&
+            atomic_compare_exchange_strong(&record->in_use, &expected, 1)) {
+            break;
+        }
+    }
+    if (!record) {
+        record = (fossil_xhazard_record_t *)calloc(1, sizeof(fossil_xhazard_record_t));
+        if (!record) {
+            return NULL;
+        }
+        for (size_t i = 0; i < FOSSIL_HAZARD_SLOTS; ++i) {
+            atomic_init(&record->slots[i], NULL);
+        }
+        atomic_init(&record->in_use, 1);
+        fossil_xhazard_record_t *head = atomic_load(&domain->records);
+        do {
+            record->next = head;
+        } while (!atomic_compare_exchange_weak(&domain->records, &head, record));
+        atomic_fetch_add(&domain->record_count, 1);
+    }
+
+    if (fossil_thread_local_set(domain->key, record) != 0) {
+        atomic_store(&record->in_use, 0);
+        return NULL;
+    }
+    return record;
+}
+
+static int hazard_compare(const void *a, const void *b) {
+    uintptr_t x = (uintptr_t)*(void *const *)a, y = (uintptr_t)*(void *const *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Frees the record's retired objects that no slot of any thread holds.
+ *
+ * @param domain Pointer to the domain.
+ * @param record The calling thread's record.
+ * @return size_t The number of objects freed.
+ */
+static size_t hazard_scan(fossil_xhazard_domain_t *domain, fossil_xhazard_record_t *record) {
+    // Pairs with the fence in protect: a slot published before the object was unlinked is seen here
+    atomic_thread_fence(memory_order_seq_cst);
+
+    // The list only grows at the head, so the records from this snapshot on are fixed; a thread
+    // that registers later cannot validate a pointer to an object that was unlinked before the scan
+    fossil_xhazard_record_t *head = atomic_load(&domain->records);
+    size_t needed = 0;
+    for (fossil_xhazard_record_t *other = head; other; other = other->next) {
+        needed += FOSSIL_HAZARD_SLOTS;
+    }
+    if (needed > record->scratch_capacity) {
+        void **scratch = (void **)realloc(record->scratch, sizeof(void *) * needed);
+        if (!scratch) {
+            return 0;
+        }
+        record->scratch = scratch;
+        record->scratch_capacity = needed;
+    }
+    size_t hazards = 0;
+    for (fossil_xhazard_record_t *other = head; other; other = other->next) {
+        for (size_t i = 0; i < FOSSIL_HAZARD_SLOTS; ++i) {
+            void *ptr = atomic_load_explicit(&other->slots[i], memory_order_acquire);
+            if (ptr) {
+                record->scratch[hazards++] = ptr;
+            }
+        }
+    }
+    qsort(record->scratch, hazards, sizeof(void *), hazard_compare);
+
+    // Objects still protected are kept, in order, at the front of the list
+    size_t kept = 0, count = record->count;
+    record->count = 0;
+    for (size_t i = 0; i < count; ++i) {
+        hazard_retired_t item = record->retired[i];
+        if (hazards > 0 && bsearch(&item.ptr, record->scratch, hazards, sizeof(void *), hazard_compare)) {
+            record->retired[kept++] = item;
+        } else {
+            item.free_func(item.ptr);
+        }
+    }
+    record->count = kept;
+    return count - kept;
+}
+
+int32_t fossil_hazard_domain_create(fossil_xhazard_domain_t *domain, size_t threshold) {
+    if (!domain) return FOSSIL_ERROR;
+
+    atomic_init(&domain->records, NULL);
+    atomic_init(&domain->record_count, 0);
+    domain->threshold = threshold ? threshold : FOSSIL_HAZARD_DEFAULT_THRESHOLD;
+    return fossil_thread_local_create(&domain->key, hazard_thread_exit) == 0 ? FOSSIL_SUCCESS : FOSSIL_ERROR;
+}
+
+int32_t fossil_hazard_domain_erase(fossil_xhazard_domain_t *domain) {
+    if (!domain) return FOSSIL_ERROR;
+
+    // Deleting the key first keeps exiting threads from touching records that are about to go
+    fossil_thread_local_erase(domain->key);
+    fossil_xhazard_record_t *record = atomic_exchange(&domain->records, NULL);
+    while (record) {
+        fossil_xhazard_record_t *next = record->next;
+        for (size_t i = 0; i < record->count; ++i) {
+            record->retired[i].free_func(record->retired[i].ptr);
+        }
+        free(record->retired);
+        free(record->scratch);
+        free(record);
+        record = next;
+    }
+    atomic_store(&domain->record_count, 0);
+    return FOSSIL_SUCCESS;
+}
+
+void* fossil_hazard_protect(fossil_xhazard_domain_t *domain, size_t slot, _Atomic(void *) *source) {
+    if (!domain || !source || slot >= FOSSIL_HAZARD_SLOTS) return NULL;
+    fossil_xhazard_record_t *record = hazard_record(domain);
+    if (!record) return NULL;
+
+    // Published, then checked: if the source still holds the pointer, no scan can have missed it
+    void *ptr = atomic_load_explicit(source, memory_order_relaxed);
+    for (;;) {
+        atomic_store_explicit(&record->slots[slot], ptr, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        void *current = atomic_load_explicit(source, memory_order_acquire);
+        if (current == ptr) {
+            return ptr;
+        }
+        ptr = current;
+    }
+}
+
+int32_t fossil_hazard_set(fossil_xhazard_domain_t *domain, size_t slot, void *ptr) {
+    if (!domain || slot >= FOSSIL_HAZARD_SLOTS) return FOSSIL_ERROR;
+    fossil_xhazard_record_t *record = hazard_record(domain);
+    if (!record) return FOSSIL_ERROR;
+
+    atomic_store_explicit(&record->slots[slot], ptr, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_hazard_clear(fossil_xhazard_domain_t *domain, size_t slot) {
+    if (!domain || slot >= FOSSIL_HAZARD_SLOTS) return FOSSIL_ERROR;
+    fossil_xhazard_record_t *record = (fossil_xhazard_record_t *)fossil_thread_local_get(domain->key);
+    if (!record) return FOSSIL_ERROR;
+
+    atomic_store_explicit(&record->slots[slot], NULL, memory_order_release);
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_hazard_retire(fossil_xhazard_domain_t *domain, void *ptr, fossil_xtask_func_t free_func) {
+    if (!domain || !free_func) return FOSSIL_ERROR;
+    fossil_xhazard_record_t *record = hazard_record(domain);
+    if (!record) return FOSSIL_ERROR;
+
+    if (record->count == record->capacity) {
+        size_t capacity = record->capacity ? record->capacity * 2 : domain->threshold;
+        hazard_retired_t *retired = (hazard_retired_t *)realloc(record->retired, sizeof(hazard_retired_t) * capacity);
+        if (!retired) return FOSSIL_ERROR;
+        record->retired = retired;
+        record->capacity = capacity;
+    }
+    record->retired[record->count].ptr = ptr;
+    record->retired[record->count].free_func = free_func;
+    record->count++;
+
+    size_t limit = 2 * FOSSIL_HAZARD_SLOTS * atomic_load_explicit(&domain->record_count, memory_order_relaxed);
+    if (record->count >= (limit > domain->threshold ? limit : domain->threshold)) {
+        hazard_scan(domain, record);
+    }
+    return FOSSIL_SUCCESS;
+}
+
+size_t fossil_hazard_reclaim(fossil_xhazard_domain_t *domain) {
+    if (!domain) return 0;
+    fossil_xhazard_record_t *record = hazard_record(domain);
+    if (!record || record->count == 0) return 0;
+    return hazard_scan(domain, record);
+}
+
+int32_t fossil_hazard_unregister(fossil_xhazard_domain_t *domain) {
+    if (!domain) return FOSSIL_ERROR;
+    fossil_xhazard_record_t *record = (fossil_xhazard_record_t *)fossil_thread_local_get(domain->key);
+    if (!record) return FOSSIL_SUCCESS;
+
+    fossil_thread_local_set(domain->key, NULL);
+    hazard_thread_exit(record);
+    return FOSSIL_SUCCESS;
+}
@@ -0,0 +1,365 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#include "fossil/threads/parallel.h"
+#include "fossil/common/common.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FOSSIL_PARALLEL_SPLIT 8        // Dynamic chunks per participant when the grain is picked automatically
+#define FOSSIL_PARALLEL_MAX_CHUNKS 64  // Most ordered chunks per participant, bounding the partial values
+#define FOSSIL_PARALLEL_SCAN_SPLIT 4   // Scan chunks per participant
+#define FOSSIL_PARALLEL_HELPER_BATCH 64
+
+typedef struct fossil_xparallel_job_t fossil_xparallel_job_t;
+
+// Runs one chunk; index is the chunk number for ordered chunks and -1 for guided ones
+typedef void (*fossil_xparallel_chunk_func_t)(fossil_xparallel_job_t *job, int64_t index, int64_t begin, int64_t end);
+
+// Shared state of one parallel pass, freed by the last of the caller and its helpers
+struct fossil_xparallel_job_t {
+    fossil_xmutex_t mutex;
+    fossil_xcond_t cond;
+    atomic_int refs;
+    _Atomic int64_t next;  // Next chunk index, or next position when guided
+    _Atomic int64_t done;  // Iterations finished
+    int64_t count;
+    int64_t chunk;         // Size of an ordered chunk
+    int64_t chunks;        // Number of ordered chunks
+    int64_t grain;         // Smallest guided chunk
+    int32_t participants;
+    bool guided;
+    fossil_xparallel_chunk_func_t run;
+    void *data;
+};
+
+// Arguments of the public functions, read by the chunk functions
+typedef struct {
+    int64_t begin;
+    fossil_xparallel_func_t fn;
+    fossil_xparallel_reduce_func_t reduce_fn;
+    fossil_xparallel_combine_func_t combine;
+    void *ctx;
+    const unsigned char *input;
+    unsigned char *output;
+    size_t value_size;
+    const void *identity;
+    unsigned char *values;   // Chunk partials, or chunk totals then offsets for scans
+    unsigned char *scratch;  // One value per chunk, so in-place scans read each input before overwriting it
+    bool inclusive;
+} fossil_xparallel_args_t;
+
+// *****************************************************************************
+// Executor
+// *****************************************************************************
+
+static void parallel_release(fossil_xparallel_job_t *job) {
+    if (atomic_fetch_sub_explicit(&job->refs, 1, memory_order_acq_rel) != 1) return;
+    fossil_cond_erase(&job->cond);
+    fossil_mutex_erase(&job->mutex);
+    free(job);
+}
+
+static bool parallel_claim(fossil_xparallel_job_t *job, int64_t *index, int64_t *begin, int64_t *end) {
+    if (!job->guided) {
+        int64_t i = atomic_fetch_add(&job->next, 1);
+        if (i >= job->chunks) return false;
+        *index = i;
+        *begin = i * job->chunk;
+        *end = *begin + job->chunk < job->count ? *begin + job->chunk : job->count;
+        return true;
+    }
+
+    int64_t position = atomic_load(&job->next);
+    while (position < job->count) {
+        // Guided: take a share of what is left, at least the grain
+        int64_t size = (job->count - position) / (2 * (int64_t)job->participants);
+        if (size < job->grain) size = job->grain;
+        int64_t stop = job->count - position > size ? position + size : job->count;
+        if (atomic_compare_exchange_weak(&job->next, &position, stop)) {
+            *index = -1;
+            *begin = position;
+            *end = stop;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void parallel_work(fossil_xparallel_job_t *job) {
+    int64_t index, begin, end;
+    while (parallel_claim(job, &index, &begin, &end)) {
+        job->run(job, index, begin, end);
+        if (atomic_fetch_add(&job->done, end - begin) + (end - begin) == job->count) {
+            fossil_mutex_lock(&job->mutex);
+            fossil_cond_broadcast(&job->cond);
+            fossil_mutex_unlock(&job->mutex);
+        }
+    }
+}
+
+static void parallel_helper(void *arg) {
+    fossil_xparallel_job_t *job = (fossil_xparallel_job_t*)arg;
+    parallel_work(job);
+    parallel_release(job);
+}
+
+// Rounds up without adding to the count, which may be close to INT64_MAX
+static int64_t parallel_chunk_count(int64_t count, int64_t chunk) {
+    return count / chunk + (count % chunk != 0);
+}
+
+/**
+ * @brief Runs a pass over count iterations on the caller and on helpers lent by the pool.
+ *
+ * Helpers that start after every chunk is claimed return at once, and the caller only waits for
+ * chunks that are already running, so a busy or nested pool never blocks the pass.
+ *
+ * @param pool The pool that lends helpers, or NULL.
+ * @param count The number of iterations.
+ * @param chunk The size of an ordered chunk, or 0 for guided chunks.
+ * @param grain The smallest guided chunk.
+ * @param run The chunk function.
+ * @param data The arguments read by the chunk function.
+ * @return int32_t 0 on success, -1 on allocation failure.
+ */
+static int32_t parallel_execute(fossil_xthread_pool_t *pool, int64_t count, int64_t chunk, int64_t grain,
+                                fossil_xparallel_chunk_func_t run, void *data) {
+    if (count <= 0) return FOSSIL_SUCCESS;
+
+    // A chunk or grain past the count is one chunk, and clamping keeps the bounds from overflowing
+    if (chunk > count) chunk = count;
+    if (grain > count) grain = count;
+    int64_t units = parallel_chunk_count(count, chunk > 0 ? chunk : grain);
+    int32_t helpers = pool ? pool->thread_count : 0;
+    if (helpers > units - 1) helpers = (int32_t)(units - 1);
+
+    fossil_xparallel_job_t *job = (fossil_xparallel_job_t*)malloc(sizeof(fossil_xparallel_job_t));
+    if (!job) return FOSSIL_ERROR;
+    if (fossil_mutex_create(&job->mutex) != 0) {
+        free(job);
+        return FOSSIL_ERROR;
+    }
+    if (fossil_cond_create(&job->cond) != 0) {
+        fossil_mutex_erase(&job->mutex);
+        free(job);
+        return FOSSIL_ERROR;
+    }
+    atomic_init(&job->refs, 1 + helpers);
+    atomic_init(&job->next, 0);
+    atomic_init(&job->done, 0);
+    job->count = count;
+    job->chunk = chunk;
+    job->chunks = chunk > 0 ? units : 0;
+    job->grain = grain;
+    job->participants = (pool ? pool->thread_count : 0) + 1;
+    job->guided = chunk == 0;
+    job->run = run;
+    job->data = data;
+
+    // Lend helpers without waiting for queue space; the caller covers whatever they miss
+    fossil_xtask_t tasks[FOSSIL_PARALLEL_HELPER_BATCH];
+    for (int32_t i = 0; i < FOSSIL_PARALLEL_HELPER_BATCH; ++i) {
+        tasks[i].task_func = parallel_helper;
+        tasks[i].arg = job;
+    }
+    int32_t lent = 0;
+    while (lent < helpers) {
+        int32_t batch = helpers - lent < FOSSIL_PARALLEL_HELPER_BATCH ? helpers - lent : FOSSIL_PARALLEL_HELPER_BATCH;
+        int32_t added = fossil_thread_pool_add_tasks(pool, tasks, batch, 0);
+        if (added <= 0) break;
+        lent += added;
+        if (added < batch) break;
+    }
+    if (lent < helpers) {
+        atomic_fetch_sub(&job->refs, helpers - lent);
+    }
+
+    parallel_work(job);
+
+    if (atomic_load(&job->done) < count) {
+        fossil_mutex_lock(&job->mutex);
+        while (atomic_load(&job->done) < count) {
+            fossil_cond_wait(&job->cond, &job->mutex);
+        }
+        fossil_mutex_unlock(&job->mutex);
+    }
+    parallel_release(job);
+    return FOSSIL_SUCCESS;
+}
+
+static int32_t parallel_participants(fossil_xthread_pool_t *pool) {
+    return (pool ? pool->thread_count : 0) + 1;
+}
+
+// Size of ordered chunks for a schedule, capped so the partial values stay bounded
+static int64_t parallel_chunk_size(fossil_xthread_pool_t *pool, int64_t count, int64_t grain, fossil_xparallel_schedule_t schedule) {
+    int64_t participants = parallel_participants(pool);
+    int64_t chunk;
+    if (schedule == FOSSIL_PARALLEL_STATIC) {
+        chunk = parallel_chunk_count(count, participants);
+        if (chunk < grain) chunk = grain;
+    } else {
+        chunk = grain > 0 ? grain : count / (participants * FOSSIL_PARALLEL_SPLIT);
+        int64_t smallest = parallel_chunk_count(count, participants * FOSSIL_PARALLEL_MAX_CHUNKS);
+        if (chunk < smallest) chunk = smallest;
+    }
+    if (chunk > count) chunk = count;
+    return chunk > 0 ? chunk : 1;
+}
+
+// *****************************************************************************
+// Loops
+// *****************************************************************************
+
+static void parallel_for_chunk(fossil_xparallel_job_t *job, int64_t index, int64_t begin, int64_t end) {
+    (void)index;
+    fossil_xparallel_args_t *args = (fossil_xparallel_args_t*)job->data;
+    args->fn(args->begin + begin, args->begin + end, args->ctx);
+}
+
+int32_t fossil_parallel_for(fossil_xthread_pool_t *pool, int64_t begin, int64_t end, int64_t grain,
+                            fossil_xparallel_func_t fn, void *ctx) {
+    return fossil_parallel_for_schedule(pool, begin, end, grain, FOSSIL_PARALLEL_DYNAMIC, fn, ctx);
+}
+
+int32_t fossil_parallel_for_schedule(fossil_xthread_pool_t *pool, int64_t begin, int64_t end, int64_t grain,
+                                     fossil_xparallel_schedule_t schedule, fossil_xparallel_func_t fn, void *ctx) {
+    if (!fn || grain < 0) return FOSSIL_ERROR;
+    if (end <= begin) return FOSSIL_SUCCESS;
+
+    int64_t count = end - begin;
+    fossil_xparallel_args_t args = { .begin = begin, .fn = fn, .ctx = ctx };
+    if (schedule == FOSSIL_PARALLEL_STATIC) {
+        return parallel_execute(pool, count, parallel_chunk_size(pool, count, grain, schedule), 0, parallel_for_chunk, &args);
+    }
+    if (grain == 0) {
+        grain = count / (parallel_participants(pool) * FOSSIL_PARALLEL_SPLIT);
+        if (grain < 1) grain = 1;
+    }
+    return parallel_execute(pool, count, 0, grain, parallel_for_chunk, &args);
+}
+
+static void parallel_reduce_chunk(fossil_xparallel_job_t *job, int64_t index, int64_t begin, int64_t end) {
+    fossil_xparallel_args_t *args = (fossil_xparallel_args_t*)job->data;
+    unsigned char *partial = args->values + (size_t)index * args->value_size;
+    memcpy(partial, args->identity, args->value_size);
+    args->reduce_fn(args->begin + begin, args->begin + end, partial, args->ctx);
+}
+
+int32_t fossil_parallel_reduce(fossil_xthread_pool_t *pool, int64_t begin, int64_t end, int64_t grain,
+                               fossil_xparallel_schedule_t schedule, void *result, size_t value_size,
+                               const void *identity, fossil_xparallel_reduce_func_t fn,
+                               fossil_xparallel_combine_func_t combine, void *ctx) {
+    if (!result || value_size == 0 || !identity || !fn || !combine || grain < 0) return FOSSIL_ERROR;
+
+    memcpy(result, identity, value_size);
+    if (end <= begin) return FOSSIL_SUCCESS;
+
+    int64_t count = end - begin;
+    int64_t chunk = parallel_chunk_size(pool, count, grain, schedule);
+    int64_t chunks = parallel_chunk_count(count, chunk);
+    fossil_xparallel_args_t args = {
+        .begin = begin, .reduce_fn = fn, .combine = combine, .ctx = ctx,
+        .value_size = value_size, .identity = identity
+    };
+    args.values = (unsigned char*)malloc((size_t)chunks * value_size);
+    if (!args.values) return FOSSIL_ERROR;
+
+    int32_t status = parallel_execute(pool, count, chunk, 0, parallel_reduce_chunk, &args);
+    if (status == FOSSIL_SUCCESS) {
+        for (int64_t i = 0; i < chunks; ++i) {
+            combine(result, args.values + (size_t)i * value_size, ctx);
+        }
+    }
+    free(args.values);
+    return status;
+}
+
+// *****************************************************************************
+// Scans
+// *****************************************************************************
+
+static void parallel_scan_total(fossil_xparallel_job_t *job, int64_t index, int64_t begin, int64_t end) {
+    fossil_xparallel_args_t *args = (fossil_xparallel_args_t*)job->data;
+    unsigned char *total = args->values + (size_t)index * args->value_size;
+    memcpy(total, args->identity, args->value_size);
+    for (int64_t i = begin; i < end; ++i) {
+        args->combine(total, args->input + (size_t)i * args->value_size, args->ctx);
+    }
+}
+
+static void parallel_scan_chunk(fossil_xparallel_job_t *job, int64_t index, int64_t begin, int64_t end) {
+    fossil_xparallel_args_t *args = (fossil_xparallel_args_t*)job->data;
+    size_t size = args->value_size;
+    unsigned char *running = args->values + (size_t)index * size;  // Starts as the chunk's offset
+    unsigned char *value = args->scratch + (size_t)index * size;
+    for (int64_t i = begin; i < end; ++i) {
+        memcpy(value, args->input + (size_t)i * size, size);
+        if (args->inclusive) {
+            args->combine(running, value, args->ctx);
+            memcpy(args->output + (size_t)i * size, running, size);
+        } else {
+            memcpy(args->output + (size_t)i * size, running, size);
+            args->combine(running, value, args->ctx);
+        }
+    }
+}
+
+static int32_t parallel_scan(fossil_xthread_pool_t *pool, const void *input, void *output, size_t count,
+                             size_t value_size, const void *identity, fossil_xparallel_combine_func_t combine,
+                             void *ctx, bool inclusive) {
+    if (!input || !output || value_size == 0 || !identity || !combine || count > INT64_MAX) return FOSSIL_ERROR;
+    if (count == 0) return FOSSIL_SUCCESS;
+
+    int64_t n = (int64_t)count;
+    int64_t pieces = (int64_t)parallel_participants(pool) * FOSSIL_PARALLEL_SCAN_SPLIT;
+    int64_t chunk = parallel_chunk_count(n, pieces);
+    int64_t chunks = parallel_chunk_count(n, chunk);
+    fossil_xparallel_args_t args = {
+        .combine = combine, .ctx = ctx, .input = (const unsigned char*)input, .output = (unsigned char*)output,
+        .value_size = value_size, .identity = identity, .inclusive = inclusive
+    };
+    args.values = (unsigned char*)malloc((size_t)(chunks * 2 + 2) * value_size);
+    if (!args.values) return FOSSIL_ERROR;
+    args.scratch = args.values + (size_t)chunks * value_size;
+
+    // Pass one totals each chunk, the totals then become exclusive offsets, and pass two scans each chunk
+    int32_t status = parallel_execute(pool, n, chunk, 0, parallel_scan_total, &args);
+    if (status == FOSSIL_SUCCESS) {
+        unsigned char *running = args.scratch + (size_t)chunks * value_size;
+        unsigned char *total = running + value_size;
+        memcpy(running, identity, value_size);
+        for (int64_t i = 0; i < chunks; ++i) {
+            unsigned char *slot = args.values + (size_t)i * value_size;
+            memcpy(total, slot, value_size);
+            memcpy(slot, running, value_size);
+            combine(running, total, ctx);
+        }
+        status = parallel_execute(pool, n, chunk, 0, parallel_scan_chunk, &args);
+    }
+    free(args.values);
+    return status;
+}
+
+int32_t fossil_parallel_inclusive_scan(fossil_xthread_pool_t *pool, const void *input, void *output, size_t count,
+                                       size_t value_size, const void *identity,
+                                       fossil_xparallel_combine_func_t combine, void *ctx) {
+    return parallel_scan(pool, input, output, count, value_size, identity, combine, ctx, true);
+}
+
+int32_t fossil_parallel_exclusive_scan(fossil_xthread_pool_t *pool, const void *input, void *output, size_t count,
+                                       size_t value_size, const void *identity,
+                                       fossil_xparallel_combine_func_t combine, void *ctx) {
+    return parallel_scan(pool, input, output, count, value_size, identity, combine, ctx, false);
+}
@@ -0,0 +1,167 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#include "fossil/threads/rwlock.h"
+#include "fossil/common/common.h"
+#include <stdbool.h>
+
+// Threads take reader stripes in turn, so up to FOSSIL_RWLOCK_STRIPES readers never share a counter
+static atomic_uint rwlock_next_stripe;
+static _Thread_local int rwlock_stripe = -1;
+
+static fossil_xrwlock_stripe_t *rwlock_thread_stripe(fossil_xrwlock_t *lock) {
+    if (rwlock_stripe < 0) {
+        rwlock_stripe = (int)(atomic_fetch_add_explicit(&rwlock_next_stripe, 1, memory_order_relaxed) % FOSSIL_RWLOCK_STRIPES);
+    }
+    return &lock->stripes[rwlock_stripe];
+}
+
+static long rwlock_readers(fossil_xrwlock_t *lock) {
+    long readers = 0;
+    for (int i = 0; i < FOSSIL_RWLOCK_STRIPES; ++i) {
+        readers += atomic_load(&lock->stripes[i].readers);
+    }
+    return readers;
+}
+
+static void rwlock_wake(fossil_xrwlock_t *lock) {
+    fossil_mutex_lock(&lock->mutex);
+    fossil_cond_broadcast(&lock->cond);
+    fossil_mutex_unlock(&lock->mutex);
+}
+
+/**
+ * @brief Registers a reader on its stripe unless a writer is present.
+ *
+ * The add and the check are sequentially consistent, pairing with the writer's store and
+ * sum: either the writer counts this reader or this reader sees the writer.
+ *
+ * @param lock Pointer to the lock.
+ * @param stripe The calling thread's stripe.
+ * @return bool true if the read lock is held.
+ */
+static bool rwlock_enter(fossil_xrwlock_t *lock, fossil_xrwlock_stripe_t *stripe) {
+    atomic_fetch_add(&stripe->readers, 1);
+    if (!atomic_load(&lock->writer)) {
+        return true;
+    }
+    atomic_fetch_sub(&stripe->readers, 1);
+    if (atomic_load(&lock->writer)) {
+        rwlock_wake(lock); // The writer may be waiting for this stripe to drain
+    }
+    return false;
+}
+
+int32_t fossil_rwlock_create(fossil_xrwlock_t *lock) {
+    if (!lock) return FOSSIL_ERROR;
+
+    for (int i = 0; i < FOSSIL_RWLOCK_STRIPES; ++i) {
+        atomic_init(&lock->stripes[i].readers, 0);
+    }
+    atomic_init(&lock->writer, 0);
+    atomic_init(&lock->waiting, 0);
+    if (fossil_mutex_create(&lock->write_mutex) != 0) return FOSSIL_ERROR;
+    if (fossil_mutex_create(&lock->mutex) != 0) {
+        fossil_mutex_erase(&lock->write_mutex);
+        return FOSSIL_ERROR;
+    }
+    if (fossil_cond_create(&lock->cond) != 0) {
+        fossil_mutex_erase(&lock->mutex);
+        fossil_mutex_erase(&lock->write_mutex);
+        return FOSSIL_ERROR;
+    }
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_rwlock_erase(fossil_xrwlock_t *lock) {
+    if (!lock) return FOSSIL_ERROR;
+
+    fossil_cond_erase(&lock->cond);
+    fossil_mutex_erase(&lock->mutex);
+    fossil_mutex_erase(&lock->write_mutex);
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_rwlock_rdlock(fossil_xrwlock_t *lock) {
+    if (!lock) return FOSSIL_ERROR;
+
+    fossil_xrwlock_stripe_t *stripe = rwlock_thread_stripe(lock);
+    while (!rwlock_enter(lock, stripe)) {
+        // Sleep until the writer leaves; it checks waiting after clearing its flag
+        fossil_mutex_lock(&lock->mutex);
+        atomic_fetch_add(&lock->waiting, 1);
+        while (atomic_load(&lock->writer)) {
+            fossil_cond_wait(&lock->cond, &lock->mutex);
+        }
+        atomic_fetch_sub(&lock->waiting, 1);
+        fossil_mutex_unlock(&lock->mutex);
+    }
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_rwlock_rdunlock(fossil_xrwlock_t *lock) {
+    if (!lock) return FOSSIL_ERROR;
+
+    atomic_fetch_sub(&rwlock_thread_stripe(lock)->readers, 1);
+    if (atomic_load(&lock->writer)) {
+        rwlock_wake(lock);
+    }
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_rwlock_tryrdlock(fossil_xrwlock_t *lock) {
+    if (!lock) return FOSSIL_ERROR;
+
+    return rwlock_enter(lock, rwlock_thread_stripe(lock)) ? FOSSIL_SUCCESS : FOSSIL_ERROR;
+}
+
+int32_t fossil_rwlock_wrlock(fossil_xrwlock_t *lock) {
+    if (!lock) return FOSSIL_ERROR;
+
+    fossil_mutex_lock(&lock->write_mutex);
+    atomic_store(&lock->writer, 1);
+
+    // New readers now back off; wait for the ones already inside
+    fossil_mutex_lock(&lock->mutex);
+    while (rwlock_readers(lock) > 0) {
+        fossil_cond_wait(&lock->cond, &lock->mutex);
+    }
+    fossil_mutex_unlock(&lock->mutex);
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_rwlock_wrunlock(fossil_xrwlock_t *lock) {
+    if (!lock) return FOSSIL_ERROR;
+
+    atomic_store(&lock->writer, 0);
+    if (atomic_load(&lock->waiting) > 0) {
+        rwlock_wake(lock);
+    }
+    fossil_mutex_unlock(&lock->write_mutex);
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_rwlock_trywrlock(fossil_xrwlock_t *lock) {
+    if (!lock) return FOSSIL_ERROR;
+
+    if (fossil_mutex_trylock(&lock->write_mutex) != 0) {
+        return FOSSIL_ERROR;
+    }
+    atomic_store(&lock->writer, 1);
+    if (rwlock_readers(lock) == 0) {
+        return FOSSIL_SUCCESS;
+    }
+
+    // Readers are inside: step back and let any reader that saw the flag in
+    fossil_rwlock_wrunlock(lock);
+    return FOSSIL_ERROR;
+}
@@ -10,69 +10,109 @@ Description:
     feel free to contact Michael at michaelbrockus@gmail.com.
 ==============================================================================
 */
+#ifdef __linux__
+#define _GNU_SOURCE // for syscall
+#endif
 #include "fossil/threads/semaphores.h"
 #include "fossil/common/common.h"
+#include <stdbool.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Sleep while *word still equals expected; spurious returns are handled by the caller's loop
+static void sem_futex_wait(atomic_int *word, int expected) {
+    syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, expected, cnullptr, cnullptr, 0);
+}
+
+static void sem_futex_wake(atomic_int *word, int count) {
+    syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, count, cnullptr, cnullptr, 0);
+}
+#endif
+
+// Take one unit if the count is positive
+static bool sem_try_acquire(fossil_xsem_t *sem) {
+    int value = atomic_load_explicit(&sem->value, memory_order_relaxed);
+    while (value > 0) {
+        if (atomic_compare_exchange_weak_explicit(&sem->value, &value, value - 1,
+                                                  memory_order_acquire, memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
 
 int32_t fossil_sem_create(fossil_xsem_t *sem, uint32_t value) {
     if (!sem) return FOSSIL_ERROR;
 
-    atomic_init(&sem->value, value);
+    atomic_init(&sem->value, (int)value);
+    atomic_init(&sem->waiters, 0);
+#ifndef __linux__
     if (fossil_mutex_create(&sem->mutex) != 0) return FOSSIL_ERROR;
     if (fossil_cond_create(&sem->cond) != 0) {
         fossil_mutex_erase(&sem->mutex);
         return FOSSIL_ERROR;
     }
+#endif
     return FOSSIL_SUCCESS;
 }
 
 int32_t fossil_sem_erase(fossil_xsem_t *sem) {
     if (!sem) return FOSSIL_ERROR;
 
+#ifndef __linux__
     fossil_cond_erase(&sem->cond);
     fossil_mutex_erase(&sem->mutex);
+#endif
     return FOSSIL_SUCCESS;
 }
 
 int32_t fossil_sem_wait(fossil_xsem_t *sem) {
     if (!sem) return FOSSIL_ERROR;
 
-    fossil_mutex_lock(&sem->mutex);
+    if (sem_try_acquire(sem)) {
+        return FOSSIL_SUCCESS;
+    }
 
-    while (atomic_load(&sem->value) <= 0) {
+    // Announce the waiter before the final check, so a post either sees it or is seen by the check
+    atomic_fetch_add(&sem->waiters, 1);
+#ifdef __linux__
+    while (!sem_try_acquire(sem)) {
+        sem_futex_wait(&sem->value, 0);
+    }
+#else
+    fossil_mutex_lock(&sem->mutex);
+    while (!sem_try_acquire(sem)) {
         fossil_cond_wait(&sem->cond, &sem->mutex);
     }
-
-    atomic_fetch_sub(&sem->value, 1);
-
     fossil_mutex_unlock(&sem->mutex);
-
+#endif
+    atomic_fetch_sub(&sem->waiters, 1);
     return FOSSIL_SUCCESS;
 }
 
 int32_t fossil_sem_post(fossil_xsem_t *sem) {
     if (!sem) return FOSSIL_ERROR;
 
-    fossil_mutex_lock(&sem->mutex);
-
     atomic_fetch_add(&sem->value, 1);
+    if (atomic_load(&sem->waiters) == 0) {
+        return FOSSIL_SUCCESS;
+    }
+#ifdef __linux__
+    sem_futex_wake(&sem->value, 1);
+#else
+    // Taking the mutex orders the signal after a waiter's check, so the wakeup is not lost
+    fossil_mutex_lock(&sem->mutex);
     fossil_cond_signal(&sem->cond);
-
     fossil_mutex_unlock(&sem->mutex);
-
+#endif
     return FOSSIL_SUCCESS;
 }
 
 int32_t fossil_sem_trywait(fossil_xsem_t *sem) {
     if (!sem) return FOSSIL_ERROR;
 
-    fossil_mutex_lock(&sem->mutex);
-
-    if (atomic_load(&sem->value) > 0) {
-        atomic_fetch_sub(&sem->value, 1);
-        fossil_mutex_unlock(&sem->mutex);
-        return FOSSIL_SUCCESS;
-    } else {
-        fossil_mutex_unlock(&sem->mutex);
-        return FOSSIL_ERROR; // Semaphore value is zero, cannot decrement
-    }
+    // Semaphore value is zero, cannot decrement
+    return sem_try_acquire(sem) ? FOSSIL_SUCCESS : FOSSIL_ERROR;
 }
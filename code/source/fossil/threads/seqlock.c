@@ -0,0 +1,134 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L // for sched_yield
+#endif
+#include "fossil/threads/seqlock.h"
+#include "fossil/common/common.h"
+#include <string.h>
+#ifndef _WIN32
+#include <sched.h>
+#endif
+
+#define FOSSIL_SEQLOCK_SPINS 128 // Reads of an odd sequence before a reader yields to the writer
+
+int32_t fossil_seqlock_create(fossil_xseqlock_t *lock) {
+    if (!lock) return FOSSIL_ERROR;
+
+    atomic_init(&lock->sequence, 0);
+    return fossil_mutex_create(&lock->mutex) == 0 ? FOSSIL_SUCCESS : FOSSIL_ERROR;
+}
+
+int32_t fossil_seqlock_erase(fossil_xseqlock_t *lock) {
+    if (!lock) return FOSSIL_ERROR;
+
+    fossil_mutex_erase(&lock->mutex);
+    return FOSSIL_SUCCESS;
+}
+
+uint32_t fossil_seqlock_read_begin(const fossil_xseqlock_t *lock) {
+    uint32_t spins = 0;
+    unsigned int sequence;
+    while ((sequence = atomic_load_explicit(&lock->sequence, memory_order_acquire)) & 1u) {
+        if (++spins >= FOSSIL_SEQLOCK_SPINS) {
+#ifdef _WIN32
+            SwitchToThread();
+#else
+            sched_yield();
+#endif
+        }
+    }
+    return sequence;
+}
+
+bool fossil_seqlock_read_retry(const fossil_xseqlock_t *lock, uint32_t sequence) {
+    // Keeps the data loads before the second read of the sequence
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&lock->sequence, memory_order_relaxed) != sequence;
+}
+
+int32_t fossil_seqlock_write_lock(fossil_xseqlock_t *lock) {
+    if (!lock) return FOSSIL_ERROR;
+
+    fossil_mutex_lock(&lock->mutex);
+    unsigned int sequence = atomic_load_explicit(&lock->sequence, memory_order_relaxed);
+    atomic_store_explicit(&lock->sequence, sequence + 1, memory_order_relaxed);
+
+    // Keeps the data stores after the odd sequence
+    atomic_thread_fence(memory_order_release);
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_seqlock_write_unlock(fossil_xseqlock_t *lock) {
+    if (!lock) return FOSSIL_ERROR;
+
+    unsigned int sequence = atomic_load_explicit(&lock->sequence, memory_order_relaxed);
+    atomic_store_explicit(&lock->sequence, sequence + 1, memory_order_release);
+    fossil_mutex_unlock(&lock->mutex);
+    return FOSSIL_SUCCESS;
+}
+
+// Copies go through relaxed atomic loads and stores, word by word when aligned, so a torn
+// read is merely discarded rather than a data race
+void fossil_seqlock_load(void *dst, const void *src, size_t size) {
+    unsigned char *out = (unsigned char*)dst;
+    const unsigned char *in = (const unsigned char*)src;
+    if ((((uintptr_t)out | (uintptr_t)in) % sizeof(uintptr_t)) == 0) {
+        for (; size >= sizeof(uintptr_t); size -= sizeof(uintptr_t)) {
+            uintptr_t word = atomic_load_explicit((const _Atomic uintptr_t*)in, memory_order_relaxed);
+            memcpy(out, &word, sizeof(word));
+            out += sizeof(uintptr_t);
+            in += sizeof(uintptr_t);
+        }
+    }
+    for (; size > 0; --size) {
+        *out++ = atomic_load_explicit((const _Atomic unsigned char*)in++, memory_order_relaxed);
+    }
+}
+
+void fossil_seqlock_store(void *dst, const void *src, size_t size) {
+    unsigned char *out = (unsigned char*)dst;
+    const unsigned char *in = (const unsigned char*)src;
+    if ((((uintptr_t)out | (uintptr_t)in) % sizeof(uintptr_t)) == 0) {
+        for (; size >= sizeof(uintptr_t); size -= sizeof(uintptr_t)) {
+            uintptr_t word;
+            memcpy(&word, in, sizeof(word));
+            atomic_store_explicit((_Atomic uintptr_t*)out, word, memory_order_relaxed);
+            out += sizeof(uintptr_t);
+            in += sizeof(uintptr_t);
+        }
+    }
+    for (; size > 0; --size) {
+        atomic_store_explicit((_Atomic unsigned char*)out++, *in++, memory_order_relaxed);
+    }
+}
+
+int32_t fossil_seqlock_read(const fossil_xseqlock_t *lock, void *dst, const void *data, size_t size) {
+    if (!lock || !dst || !data) return FOSSIL_ERROR;
+
+    uint32_t sequence;
+    do {
+        sequence = fossil_seqlock_read_begin(lock);
+        fossil_seqlock_load(dst, data, size);
+    } while (fossil_seqlock_read_retry(lock, sequence));
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_seqlock_write(fossil_xseqlock_t *lock, void *data, const void *src, size_t size) {
+    if (!lock || !data || !src) return FOSSIL_ERROR;
+
+    fossil_seqlock_write_lock(lock);
+    fossil_seqlock_store(data, src, size);
+    fossil_seqlock_write_unlock(lock);
+    return FOSSIL_SUCCESS;
+}
@@ -10,8 +10,51 @@ Description:
     feel free to contact Michael at michaelbrockus@gmail.com.
 ==============================================================================
 */
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L // for sched_yield
+#endif
 #include "fossil/threads/spinlocks.h"
 #include "fossil/common/common.h"
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+#ifndef _WIN32
+#include <sched.h>
+#endif
+
+#define FOSSIL_SPIN_BACKOFF_MAX 1024  // Longest run of pauses before a waiter yields instead
+#define FOSSIL_TICKET_BACKOFF 64      // Pauses per thread ahead in a ticket lock line
+
+// Tell the CPU this is a spin-wait loop, which saves power and frees the core for a sibling thread
+static inline void spin_pause(void) {
+#if defined(_MSC_VER)
+    YieldProcessor();
+#elif defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+static void spin_yield(void) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+// Pause for the current delay and double it; past the limit the holder is likely descheduled, so yield
+static void spin_backoff(uint32_t *delay) {
+    if (*delay >= FOSSIL_SPIN_BACKOFF_MAX) {
+        spin_yield();
+        return;
+    }
+    for (uint32_t i = 0; i < *delay; ++i) {
+        spin_pause();
+    }
+    *delay *= 2;
+}
 
 int32_t fossil_spinlock_create(fossil_xspinlock_t *lock) {
     if (!lock) return FOSSIL_ERROR;
@@ -20,7 +63,7 @@ int32_t fossil_spinlock_create(fossil_xspinlock_t *lock) {
     InitializeCriticalSection(lock);
     return FOSSIL_SUCCESS;
 #else
-    atomic_flag_clear(lock);
+    atomic_init(lock, 0);
     return FOSSIL_SUCCESS;
 #endif
 }
@@ -44,8 +87,12 @@ int32_t fossil_spinlock_lock(fossil_xspinlock_t *lock) {
     EnterCriticalSection(lock);
     return FOSSIL_SUCCESS;
 #else
-    while (atomic_flag_test_and_set(lock)) {
-        // Spin until the lock is acquired
+    uint32_t delay = 1;
+    while (atomic_exchange_explicit(lock, 1, memory_order_acquire)) {
+        // Wait on a plain load, which stays in the local cache until the holder releases
+        do {
+            spin_backoff(&delay);
+        } while (atomic_load_explicit(lock, memory_order_relaxed));
     }
     return FOSSIL_SUCCESS;
 #endif
@@ -58,7 +105,7 @@ int32_t fossil_spinlock_unlock(fossil_xspinlock_t *lock) {
     LeaveCriticalSection(lock);
     return FOSSIL_SUCCESS;
 #else
-    atomic_flag_clear(lock);
+    atomic_store_explicit(lock, 0, memory_order_release);
     return FOSSIL_SUCCESS;
 #endif
 }
@@ -70,10 +117,149 @@ int32_t fossil_spinlock_trylock(fossil_xspinlock_t *lock) {
     // Windows does not have a trylock function for CRITICAL_SECTION
     return FOSSIL_ERROR;
 #else
-    if (atomic_flag_test_and_set(lock)) {
+    if (atomic_load_explicit(lock, memory_order_relaxed) ||
+        atomic_exchange_explicit(lock, 1, memory_order_acquire)) {
         return FOSSIL_ERROR; // Lock was not acquired
     } else {
         return FOSSIL_SUCCESS; // Lock acquired successfully
     }
 #endif
 }
+
+// *****************************************************************************
+// Ticket lock
+// *****************************************************************************
+
+int32_t fossil_ticketlock_create(fossil_xticketlock_t *lock) {
+    if (!lock) return FOSSIL_ERROR;
+
+    atomic_init(&lock->next, 0);
+    atomic_init(&lock->serving, 0);
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_ticketlock_erase(fossil_xticketlock_t *lock) {
+    if (!lock) return FOSSIL_ERROR;
+
+    // Nothing to release
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_ticketlock_lock(fossil_xticketlock_t *lock) {
+    if (!lock) return FOSSIL_ERROR;
+
+    unsigned int ticket = atomic_fetch_add_explicit(&lock->next, 1, memory_order_relaxed);
+    uint32_t waited = 0;
+    for (;;) {
+        unsigned int serving = atomic_load_explicit(&lock->serving, memory_order_acquire);
+        if (serving == ticket) {
+            return FOSSIL_SUCCESS;
+        }
+
+        // Every thread ahead holds the lock once before this one, so wait in proportion to the line;
+        // a long wait means a thread ahead is descheduled, so give up the CPU instead
+        uint32_t ahead = ticket - serving;
+        if (waited >= FOSSIL_SPIN_BACKOFF_MAX || ahead >= FOSSIL_SPIN_BACKOFF_MAX / FOSSIL_TICKET_BACKOFF) {
+            spin_yield();
+            continue;
+        }
+        for (uint32_t i = 0; i < ahead * FOSSIL_TICKET_BACKOFF; ++i) {
+            spin_pause();
+        }
+        waited += ahead * FOSSIL_TICKET_BACKOFF;
+    }
+}
+
+int32_t fossil_ticketlock_unlock(fossil_xticketlock_t *lock) {
+    if (!lock) return FOSSIL_ERROR;
+
+    // Only the holder writes serving
+    unsigned int serving = atomic_load_explicit(&lock->serving, memory_order_relaxed);
+    atomic_store_explicit(&lock->serving, serving + 1, memory_order_release);
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_ticketlock_trylock(fossil_xticketlock_t *lock) {
+    if (!lock) return FOSSIL_ERROR;
+
+    // Take a ticket only if it would be served at once
+    unsigned int serving = atomic_load_explicit(&lock->serving, memory_order_acquire);
+    unsigned int ticket = serving;
+    if (!atomic_compare_exchange_strong_explicit(&lock->next, &ticket, serving + 1,
+                                                 memory_order_acquire, memory_order_relaxed)) {
+        return FOSSIL_ERROR;
+    }
+    return FOSSIL_SUCCESS;
+}
+
+// *****************************************************************************
+// MCS queue lock
+// *****************************************************************************
+
+int32_t fossil_mcslock_create(fossil_xmcslock_t *lock) {
+    if (!lock) return FOSSIL_ERROR;
+
+    atomic_init(&lock->tail, cnullptr);
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_mcslock_erase(fossil_xmcslock_t *lock) {
+    if (!lock) return FOSSIL_ERROR;
+
+    // Nothing to release; the nodes belong to their threads
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_mcslock_lock(fossil_xmcslock_t *lock, fossil_xmcs_node_t *node) {
+    if (!lock || !node) return FOSSIL_ERROR;
+
+    atomic_store_explicit(&node->next, cnullptr, memory_order_relaxed);
+    atomic_store_explicit(&node->locked, 1, memory_order_relaxed);
+    fossil_xmcs_node_t *previous = atomic_exchange_explicit(&lock->tail, node, memory_order_acq_rel);
+    if (!previous) {
+        return FOSSIL_SUCCESS;
+    }
+
+    // Join the queue, then spin on this node only until the predecessor hands over the lock
+    atomic_store_explicit(&previous->next, node, memory_order_release);
+    uint32_t delay = 1;
+    while (atomic_load_explicit(&node->locked, memory_order_acquire)) {
+        spin_backoff(&delay);
+    }
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_mcslock_unlock(fossil_xmcslock_t *lock, fossil_xmcs_node_t *node) {
+    if (!lock || !node) return FOSSIL_ERROR;
+
+    fossil_xmcs_node_t *next = atomic_load_explicit(&node->next, memory_order_acquire);
+    if (!next) {
+        // No known successor: release the lock if this node is still the last one
+        fossil_xmcs_node_t *expected = node;
+        if (atomic_compare_exchange_strong_explicit(&lock->tail, &expected, cnullptr,
+                                                    memory_order_release, memory_order_relaxed)) {
+            return FOSSIL_SUCCESS;
+        }
+
+        // A successor has taken the tail but not linked itself yet
+        uint32_t delay = 1;
+        while (!(next = atomic_load_explicit(&node->next, memory_order_acquire))) {
+            spin_backoff(&delay);
+        }
+    }
+    atomic_store_explicit(&next->locked, 0, memory_order_release);
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_mcslock_trylock(fossil_xmcslock_t *lock, fossil_xmcs_node_t *node) {
+    if (!lock || !node) return FOSSIL_ERROR;
+
+    atomic_store_explicit(&node->next, cnullptr, memory_order_relaxed);
+    atomic_store_explicit(&node->locked, 0, memory_order_relaxed);
+    fossil_xmcs_node_t *expected = cnullptr;
+    if (!atomic_compare_exchange_strong_explicit(&lock->tail, &expected, node,
+                                                 memory_order_acquire, memory_order_relaxed)) {
+        return FOSSIL_ERROR;
+    }
+    return FOSSIL_SUCCESS;
+}
@@ -0,0 +1,48 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L // for nanosleep
+#endif
+#include "fossil/threads/task.h"
+#ifndef _WIN32
+#include <errno.h>
+#endif
+
+// Sleeps for the whole delay, resuming after signals on POSIX and beyond the DWORD range on Windows
+static void task_delay(uint64_t milliseconds) {
+#ifdef _WIN32
+    while (milliseconds >= INFINITE) {
+        Sleep(INFINITE - 1);
+        milliseconds -= INFINITE - 1;
+    }
+    Sleep((DWORD)milliseconds);
+#else
+    struct timespec remaining;
+    remaining.tv_sec = (time_t)(milliseconds / 1000u);
+    remaining.tv_nsec = (long)(milliseconds % 1000u) * 1000000L;
+    while (nanosleep(&remaining, &remaining) != 0 && errno == EINTR) {
+    }
+#endif
+}
+
+void fossil_task_delay_seconds(uint32_t seconds) {
+    task_delay((uint64_t)seconds * 1000u);
+}
+
+void fossil_task_delay_minutes(uint32_t minutes) {
+    task_delay((uint64_t)minutes * 60000u);
+}
+
+void fossil_task_delay_milliseconds(uint32_t milliseconds) {
+    task_delay(milliseconds);
+}
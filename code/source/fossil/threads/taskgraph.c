@@ -0,0 +1,478 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L // for clock_gettime
+#endif
+#include "fossil/threads/taskgraph.h"
+#include "fossil/common/common.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+struct fossil_xtask_node_t {
+    fossil_xtask_graph_t *graph;
+    char *name;
+    fossil_xtask_func_t func;
+    void *arg;
+    fossil_xtask_graph_t *subgraph;     // Graph run by this node, or NULL
+    fossil_xtask_node_t **successors;
+    size_t successor_count;
+    size_t successor_capacity;
+    size_t index;
+    int32_t predecessors;               // Number of inputs, fixed while the graph is built
+    atomic_int pending;                 // Inputs not yet finished in the current run
+    uint64_t start_ns;                  // Monotonic times of the last run, 0 until set
+    uint64_t end_ns;
+};
+
+struct fossil_xtask_graph_t {
+    fossil_xmutex_t mutex;
+    fossil_xcond_t cond;
+    fossil_xtask_node_t **nodes;
+    size_t count;
+    size_t capacity;
+    fossil_xtask_node_t **order;        // Topological order, valid while checked is set
+    fossil_xtask_node_t **roots;        // Nodes without inputs
+    size_t root_count;
+    bool checked;
+    bool visiting;                      // Set while checking, to find graphs that contain themselves
+    atomic_size_t remaining;            // Nodes not yet finished in the current run
+    fossil_xthread_pool_t *pool;
+    fossil_xtask_node_t *parent;        // Node running this graph as a sub-graph, or NULL
+    bool finished;                      // Guarded by mutex
+    uint64_t start_ns;
+};
+
+static void graph_node_run(void *arg);
+
+static uint64_t graph_now_ns(void) {
+#ifdef _WIN32
+    LARGE_INTEGER now, frequency;
+    QueryPerformanceCounter(&now);
+    QueryPerformanceFrequency(&frequency);
+    return (uint64_t)(now.QuadPart / frequency.QuadPart) * 1000000000u +
+           (uint64_t)(now.QuadPart % frequency.QuadPart) * 1000000000u / (uint64_t)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+#endif
+}
+
+/**
+ * @brief Computes the topological order and the roots of a graph and checks its sub-graphs.
+ *
+ * @param graph Pointer to the graph.
+ * @return int32_t 0 on success, -1 if the graph or a sub-graph has a cycle.
+ */
+static int32_t graph_check(fossil_xtask_graph_t *graph) {
+    if (graph->visiting) return FOSSIL_ERROR; // The graph contains itself
+    graph->visiting = true;
+
+    if (!graph->checked && graph->count > 0) {
+        fossil_xtask_node_t **order = (fossil_xtask_node_t**)realloc(graph->order, sizeof(*order) * graph->count);
+        if (order) graph->order = order;
+        fossil_xtask_node_t **roots = (fossil_xtask_node_t**)realloc(graph->roots, sizeof(*roots) * graph->count);
+        if (roots) graph->roots = roots;
+        int32_t *inputs = (int32_t*)malloc(sizeof(int32_t) * graph->count);
+        if (!order || !roots || !inputs) {
+            free(inputs);
+            graph->visiting = false;
+            return FOSSIL_ERROR;
+        }
+
+        // Kahn's algorithm: a node is placed once all of its inputs are
+        size_t placed = 0;
+        graph->root_count = 0;
+        for (size_t i = 0; i < graph->count; ++i) {
+            inputs[i] = graph->nodes[i]->predecessors;
+            if (inputs[i] == 0) {
+                order[placed++] = graph->nodes[i];
+                roots[graph->root_count++] = graph->nodes[i];
+            }
+        }
+        for (size_t head = 0; head < placed; ++head) {
+            fossil_xtask_node_t *node = order[head];
+            for (size_t i = 0; i < node->successor_count; ++i) {
+                fossil_xtask_node_t *next = node->successors[i];
+                if (--inputs[next->index] == 0) {
+                    order[placed++] = next;
+                }
+            }
+        }
+        free(inputs);
+        if (placed < graph->count) {
+            graph->visiting = false;
+            return FOSSIL_ERROR;
+        }
+        graph->checked = true;
+    }
+
+    // Sub-graphs are checked on every run since they can change after this graph was checked
+    for (size_t i = 0; i < graph->count; ++i) {
+        if (graph->nodes[i]->subgraph && graph_check(graph->nodes[i]->subgraph) != FOSSIL_SUCCESS) {
+            graph->visiting = false;
+            return FOSSIL_ERROR;
+        }
+    }
+    graph->visiting = false;
+    return FOSSIL_SUCCESS;
+}
+
+// Queue a ready node; a full pool runs it on this thread instead
+static void graph_schedule(fossil_xtask_node_t *node) {
+    if (fossil_thread_pool_add_task(node->graph->pool, graph_node_run, node) != FOSSIL_SUCCESS) {
+        graph_node_run(node);
+    }
+}
+
+static fossil_xtask_node_t *graph_node_complete(fossil_xtask_node_t *node);
+
+/**
+ * @brief Ends a run whose nodes have all finished.
+ *
+ * @param graph Pointer to the graph.
+ * @return fossil_xtask_node_t* A node of the parent graph that became ready, or NULL.
+ */
+static fossil_xtask_node_t *graph_finish(fossil_xtask_graph_t *graph) {
+    if (graph->parent) {
+        return graph_node_complete(graph->parent);
+    }
+
+    // The caller may erase the graph once it sees finished, so nothing touches it after the unlock
+    fossil_mutex_lock(&graph->mutex);
+    graph->finished = true;
+    fossil_cond_broadcast(&graph->cond);
+    fossil_mutex_unlock(&graph->mutex);
+    return cnullptr;
+}
+
+/**
+ * @brief Starts a run of a graph, queueing all roots but the first.
+ *
+ * @param graph Pointer to the graph.
+ * @param pool Pointer to the thread pool.
+ * @param parent The node running the graph as a sub-graph, or NULL.
+ * @return fossil_xtask_node_t* The node the caller runs next, or NULL.
+ */
+static fossil_xtask_node_t *graph_start(fossil_xtask_graph_t *graph, fossil_xthread_pool_t *pool,
+                                        fossil_xtask_node_t *parent) {
+    graph->pool = pool;
+    graph->parent = parent;
+    graph->finished = false;
+    graph->start_ns = graph_now_ns();
+    for (size_t i = 0; i < graph->count; ++i) {
+        fossil_xtask_node_t *node = graph->nodes[i];
+        atomic_store_explicit(&node->pending, node->predecessors, memory_order_relaxed);
+        node->start_ns = 0;
+        node->end_ns = 0;
+    }
+    if (graph->count == 0) {
+        return graph_finish(graph);
+    }
+    atomic_store_explicit(&graph->remaining, graph->count, memory_order_relaxed);
+
+    // The first root is still pending, so the run cannot end while the others are queued
+    fossil_xtask_node_t *first = graph->roots[0];
+    for (size_t i = 1; i < graph->root_count; ++i) {
+        graph_schedule(graph->roots[i]);
+    }
+    return first;
+}
+
+/**
+ * @brief Marks a node finished, queueing the dependents it made ready.
+ *
+ * @param node Pointer to the node.
+ * @return fossil_xtask_node_t* A ready node the caller runs next, or NULL.
+ */
+static fossil_xtask_node_t *graph_node_complete(fossil_xtask_node_t *node) {
+    fossil_xtask_graph_t *graph = node->graph;
+    fossil_xtask_node_t *next = cnullptr;
+    node->end_ns = graph_now_ns();
+
+    for (size_t i = 0; i < node->successor_count; ++i) {
+        fossil_xtask_node_t *successor = node->successors[i];
+        if (atomic_fetch_sub_explicit(&successor->pending, 1, memory_order_acq_rel) == 1) {
+            if (!next) {
+                next = successor; // Keep one on this thread rather than a round trip through the queue
+            } else {
+                graph_schedule(successor);
+            }
+        }
+    }
+
+    if (atomic_fetch_sub_explicit(&graph->remaining, 1, memory_order_acq_rel) == 1) {
+        // Only reached by the last node, which has no dependents left to run
+        return graph_finish(graph);
+    }
+    return next;
+}
+
+static void graph_node_run(void *arg) {
+    fossil_xtask_node_t *node = (fossil_xtask_node_t*)arg;
+    while (node) {
+        node->start_ns = graph_now_ns();
+        if (node->subgraph) {
+            // The sub-graph completes this node when its last node finishes
+            node = graph_start(node->subgraph, node->graph->pool, node);
+        } else {
+            node->func(node->arg);
+            node = graph_node_complete(node);
+        }
+    }
+}
+
+// *****************************************************************************
+// Building
+// *****************************************************************************
+
+fossil_xtask_graph_t* fossil_task_graph_create(void) {
+    fossil_xtask_graph_t *graph = (fossil_xtask_graph_t*)calloc(1, sizeof(fossil_xtask_graph_t));
+    if (!graph) return cnullptr;
+
+    if (fossil_mutex_create(&graph->mutex) != 0) {
+        free(graph);
+        return cnullptr;
+    }
+    if (fossil_cond_create(&graph->cond) != 0) {
+        fossil_mutex_erase(&graph->mutex);
+        free(graph);
+        return cnullptr;
+    }
+    atomic_init(&graph->remaining, 0);
+    return graph;
+}
+
+void fossil_task_graph_erase(fossil_xtask_graph_t *graph) {
+    if (!graph) return;
+
+    for (size_t i = 0; i < graph->count; ++i) {
+        free(graph->nodes[i]->successors);
+        free(graph->nodes[i]->name);
+        free(graph->nodes[i]);
+    }
+    free(graph->nodes);
+    free(graph->order);
+    free(graph->roots);
+    fossil_cond_erase(&graph->cond);
+    fossil_mutex_erase(&graph->mutex);
+    free(graph);
+}
+
+static fossil_xtask_node_t* graph_add(fossil_xtask_graph_t *graph, const char *name) {
+    if (graph->count == graph->capacity) {
+        size_t capacity = graph->capacity ? graph->capacity * 2 : 16;
+        fossil_xtask_node_t **nodes = (fossil_xtask_node_t**)realloc(graph->nodes, sizeof(*nodes) * capacity);
+        if (!nodes) return cnullptr;
+        graph->nodes = nodes;
+        graph->capacity = capacity;
+    }
+
+    fossil_xtask_node_t *node = (fossil_xtask_node_t*)calloc(1, sizeof(fossil_xtask_node_t));
+    if (!node) return cnullptr;
+    if (name) {
+        size_t length = strlen(name);
+        node->name = (char*)malloc(length + 1);
+        if (!node->name) {
+            free(node);
+            return cnullptr;
+        }
+        memcpy(node->name, name, length + 1);
+    }
+    node->graph = graph;
+    node->index = graph->count;
+    atomic_init(&node->pending, 0);
+    graph->nodes[graph->count++] = node;
+    graph->checked = false;
+    return node;
+}
+
+fossil_xtask_node_t* fossil_task_graph_add_node(fossil_xtask_graph_t *graph, const char *name,
+                                                fossil_xtask_func_t task_func, void *arg) {
+    if (!graph || !task_func) return cnullptr;
+
+    fossil_xtask_node_t *node = graph_add(graph, name);
+    if (node) {
+        node->func = task_func;
+        node->arg = arg;
+    }
+    return node;
+}
+
+fossil_xtask_node_t* fossil_task_graph_add_subgraph(fossil_xtask_graph_t *graph, const char *name,
+                                                    fossil_xtask_graph_t *subgraph) {
+    if (!graph || !subgraph || subgraph == graph) return cnullptr;
+
+    fossil_xtask_node_t *node = graph_add(graph, name);
+    if (node) {
+        node->subgraph = subgraph;
+    }
+    return node;
+}
+
+int32_t fossil_task_graph_add_edge(fossil_xtask_graph_t *graph, fossil_xtask_node_t *from, fossil_xtask_node_t *to) {
+    if (!graph || !from || !to || from == to || from->graph != graph || to->graph != graph) {
+        return FOSSIL_ERROR;
+    }
+
+    if (from->successor_count == from->successor_capacity) {
+        size_t capacity = from->successor_capacity ? from->successor_capacity * 2 : 4;
+        fossil_xtask_node_t **successors = (fossil_xtask_node_t**)realloc(from->successors,
+                                                                          sizeof(*successors) * capacity);
+        if (!successors) return FOSSIL_ERROR;
+        from->successors = successors;
+        from->successor_capacity = capacity;
+    }
+    from->successors[from->successor_count++] = to;
+    to->predecessors++;
+    graph->checked = false;
+    return FOSSIL_SUCCESS;
+}
+
+// *****************************************************************************
+// Running
+// *****************************************************************************
+
+int32_t fossil_task_graph_run(fossil_xtask_graph_t *graph, fossil_xthread_pool_t *pool) {
+    if (!graph || !pool) return FOSSIL_ERROR;
+    if (graph_check(graph) != FOSSIL_SUCCESS) return FOSSIL_ERROR;
+
+    // The caller works through one chain of the graph, then waits for the rest
+    graph_node_run(graph_start(graph, pool, cnullptr));
+
+    fossil_mutex_lock(&graph->mutex);
+    while (!graph->finished) {
+        fossil_cond_wait(&graph->cond, &graph->mutex);
+    }
+    fossil_mutex_unlock(&graph->mutex);
+    return FOSSIL_SUCCESS;
+}
+
+size_t fossil_task_graph_size(const fossil_xtask_graph_t *graph) {
+    return graph ? graph->count : 0;
+}
+
+// *****************************************************************************
+// Timing
+// *****************************************************************************
+
+int32_t fossil_task_graph_node_time(const fossil_xtask_node_t *node, int64_t *start_ns, int64_t *end_ns) {
+    if (!node || node->end_ns == 0) return FOSSIL_ERROR;
+
+    if (start_ns) *start_ns = (int64_t)(node->start_ns - node->graph->start_ns);
+    if (end_ns) *end_ns = (int64_t)(node->end_ns - node->graph->start_ns);
+    return FOSSIL_SUCCESS;
+}
+
+static void graph_write_name(FILE *file, const fossil_xtask_node_t *node) {
+    if (!node->name) {
+        fprintf(file, "\"node%zu\"", node->index);
+        return;
+    }
+    fputc('"', file);
+    for (const unsigned char *c = (const unsigned char*)node->name; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            fprintf(file, "\\%c", *c);
+        } else if (*c < 0x20) {
+            fprintf(file, "\\u%04x", *c);
+        } else {
+            fputc(*c, file);
+        }
+    }
+    fputc('"', file);
+}
+
+int32_t fossil_task_graph_export_json(const fossil_xtask_graph_t *graph, const char *filename) {
+    if (!graph || !filename) return FOSSIL_ERROR;
+    if (graph->count > 0 && !graph->checked) return FOSSIL_ERROR; // Never run since it last changed
+
+    // Longest path by duration: best[i] is the most time spent on any chain ending at node i
+    uint64_t *best = cnullptr;
+    size_t *previous = cnullptr;
+    if (graph->count > 0) {
+        best = (uint64_t*)malloc(sizeof(uint64_t) * graph->count);
+        previous = (size_t*)malloc(sizeof(size_t) * graph->count);
+        if (!best || !previous) {
+            free(best);
+            free(previous);
+            return FOSSIL_ERROR;
+        }
+    }
+    for (size_t i = 0; i < graph->count; ++i) {
+        const fossil_xtask_node_t *node = graph->nodes[i];
+        best[i] = node->end_ns ? node->end_ns - node->start_ns : 0;
+        previous[i] = SIZE_MAX;
+    }
+    for (size_t i = 0; i < graph->count; ++i) {
+        const fossil_xtask_node_t *node = graph->order[i];
+        for (size_t j = 0; j < node->successor_count; ++j) {
+            const fossil_xtask_node_t *next = node->successors[j];
+            uint64_t length = best[node->index] + (next->end_ns ? next->end_ns - next->start_ns : 0);
+            if (length > best[next->index]) {
+                best[next->index] = length;
+                previous[next->index] = node->index;
+            }
+        }
+    }
+    size_t last = SIZE_MAX;
+    uint64_t makespan = 0;
+    for (size_t i = 0; i < graph->count; ++i) {
+        if (last == SIZE_MAX || best[i] > best[last]) last = i;
+        if (graph->nodes[i]->end_ns && graph->nodes[i]->end_ns - graph->start_ns > makespan) {
+            makespan = graph->nodes[i]->end_ns - graph->start_ns;
+        }
+    }
+
+    FILE *file = fopen(filename, "w");
+    if (!file) {
+        free(best);
+        free(previous);
+        return FOSSIL_ERROR;
+    }
+
+    fprintf(file, "{\n  \"makespan_ns\": %llu,\n  \"nodes\": [", (unsigned long long)makespan);
+    for (size_t i = 0; i < graph->count; ++i) {
+        const fossil_xtask_node_t *node = graph->nodes[i];
+        int64_t start = 0, end = 0;
+        fossil_task_graph_node_time(node, &start, &end);
+        fprintf(file, "%s\n    {\"index\": %zu, \"name\": ", i ? "," : "", i);
+        graph_write_name(file, node);
+        fprintf(file, ", \"subgraph\": %s, \"start_ns\": %lld, \"end_ns\": %lld, \"duration_ns\": %lld, \"successors\": [",
+                node->subgraph ? "true" : "false", (long long)start, (long long)end, (long long)(end - start));
+        for (size_t j = 0; j < node->successor_count; ++j) {
+            fprintf(file, "%s%zu", j ? ", " : "", node->successors[j]->index);
+        }
+        fprintf(file, "]}");
+    }
+    fprintf(file, "\n  ],\n  \"critical_path\": {\"duration_ns\": %llu, \"nodes\": [",
+            (unsigned long long)(last == SIZE_MAX ? 0 : best[last]));
+
+    // The path is found from its last node back, so best is reused to hold it in reverse
+    size_t length = 0;
+    for (size_t i = last; i != SIZE_MAX; i = previous[i]) {
+        best[length++] = i;
+    }
+    for (size_t k = 0; k < length; ++k) {
+        fprintf(file, "%s%zu", k ? ", " : "", (size_t)best[length - 1 - k]);
+    }
+    fprintf(file, "]}\n}\n");
+
+    free(best);
+    free(previous);
+    return fclose(file) == 0 ? FOSSIL_SUCCESS : FOSSIL_ERROR;
+}
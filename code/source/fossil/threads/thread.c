@@ -10,68 +10,160 @@ Description:
     feel free to contact Michael at michaelbrockus@gmail.com.
 ==============================================================================
 */
+#ifdef __linux__
+#define _GNU_SOURCE // for the pthread affinity and naming extensions
+#endif
 #include "fossil/threads/thread.h"
 #include "fossil/common/common.h"
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <limits.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+// What the new thread needs from its creator, owned by the new thread once it starts
+typedef struct {
+    fossil_xtask_t task;
+    char name[FOSSIL_THREAD_NAME_MAX];
+} fossil_xthread_start_t;
 
 // Platform-specific thread start routine function
 #ifdef _WIN32
 DWORD WINAPI thread_start_routine(LPVOID arg) {
-    fossil_xtask_t task = *(fossil_xtask_t*)arg;
-    fossil_xtask_func_t task_func = task.task_func;
-    fossil_xtask_arg_t task_arg = task.arg;
-    if (task_func) {
-        task_func(task_arg);
+    fossil_xthread_start_t *start = (fossil_xthread_start_t*)arg;
+    fossil_xtask_t task = start->task;
+    free(start);
+    if (task.task_func) {
+        task.task_func(task.arg);
     }
     return FOSSIL_SUCCESS;
 }
 #else
 void* thread_start_routine(void *arg) {
-    fossil_xtask_t task = *(fossil_xtask_t*)arg;
-    fossil_xtask_func_t task_func = task.task_func;
-    fossil_xtask_arg_t task_arg = task.arg;
-    if (task_func) {
-        task_func(task_arg);
+    fossil_xthread_start_t *start = (fossil_xthread_start_t*)arg;
+    fossil_xtask_t task = start->task;
+    if (start->name[0] != '\0') {
+        fossil_thread_set_name(start->name);
+    }
+    free(start);
+    if (task.task_func) {
+        task.task_func(task.arg);
     }
     return NULL;
 }
 #endif
 
-int32_t fossil_thread_create(fossil_xthread_t *thread, fossil_xthread_attr_t *attr, fossil_xtask_t task) {
-    if (!thread || !task.task_func) return FOSSIL_ERROR;
+#ifdef _WIN32
+// SetThreadDescription only exists from Windows 10 1607, so it is looked up at run time
+typedef HRESULT (WINAPI *thread_set_description_t)(HANDLE, PCWSTR);
 
-    // Create a new thread attribute if not provided
-    fossil_xthread_attr_t default_attr;
-    fossil_xthread_attr_t *used_attr = attr;
+static int32_t thread_name_handle(HANDLE thread, const char *name) {
+    thread_set_description_t set_description = (thread_set_description_t)(void (*)(void))
+        GetProcAddress(GetModuleHandleW(L"kernel32.dll"), "SetThreadDescription");
+    wchar_t wide[FOSSIL_THREAD_NAME_MAX];
+    if (!set_description || MultiByteToWideChar(CP_UTF8, 0, name, -1, wide, FOSSIL_THREAD_NAME_MAX) == 0) {
+        return FOSSIL_ERROR;
+    }
+    return SUCCEEDED(set_description(thread, wide)) ? FOSSIL_SUCCESS : FOSSIL_ERROR;
+}
 
-    if (!attr) {
-        if (fossil_thread_attr_create(&default_attr) != FOSSIL_SUCCESS) {
-            return FOSSIL_ERROR;
+// Only CPUs of the first processor group fit in an affinity mask
+static DWORD_PTR thread_cpu_mask(const fossil_xcpu_set_t *cpus) {
+    DWORD_PTR mask = 0;
+    for (int32_t cpu = 0; cpu < (int32_t)(sizeof(DWORD_PTR) * 8); ++cpu) {
+        if (fossil_cpu_set_has(cpus, cpu)) {
+            mask |= (DWORD_PTR)1 << cpu;
         }
-        used_attr = &default_attr;
     }
+    return mask;
+}
 
-    // Create the thread using the provided attributes and start routine
-    #ifdef _WIN32
-    *thread = CreateThread(NULL, used_attr->stack_size, thread_start_routine, (LPVOID)&task, 0, NULL);
-    #else
-    int32_t result = pthread_create(thread, used_attr, thread_start_routine, (void *)&task);
-    if (result != 0) {
-        if (!attr) {
-            fossil_thread_attr_erase(&default_attr);
+static void thread_cpu_set_from_mask(fossil_xcpu_set_t *cpus, ULONGLONG mask) {
+    fossil_cpu_set_zero(cpus);
+    for (int32_t cpu = 0; cpu < 64; ++cpu) {
+        if (mask & ((ULONGLONG)1 << cpu)) {
+            fossil_cpu_set_add(cpus, cpu);
         }
-        return FOSSIL_ERROR;
     }
-    #endif
+}
+#elif defined(__linux__)
+static void thread_cpu_set_native(const fossil_xcpu_set_t *cpus, cpu_set_t *native) {
+    CPU_ZERO(native);
+    for (int32_t cpu = 0; cpu < FOSSIL_THREAD_MAX_CPUS && cpu < CPU_SETSIZE; ++cpu) {
+        if (fossil_cpu_set_has(cpus, cpu)) {
+            CPU_SET(cpu, native);
+        }
+    }
+}
+
+/**
+ * @brief Reads a sysfs list such as "0-3,8-11" into a set.
+ *
+ * @param path The sysfs file.
+ * @param set Pointer to store the numbers in the list.
+ * @return int32_t 0 if successful, -1 if the file cannot be read.
+ */
+static int32_t thread_read_sysfs_list(const char *path, fossil_xcpu_set_t *set) {
+    FILE *file = fopen(path, "r");
+    if (!file) return FOSSIL_ERROR;
+
+    fossil_cpu_set_zero(set);
+    int first, last;
+    while (fscanf(file, "%d", &first) == 1) {
+        last = first;
+        int separator = fgetc(file);
+        if (separator == '-') {
+            if (fscanf(file, "%d", &last) != 1) break;
+            separator = fgetc(file);
+        }
+        for (int number = first; number <= last; ++number) {
+            fossil_cpu_set_add(set, number);
+        }
+        if (separator != ',') break;
+    }
+    fclose(file);
+    return FOSSIL_SUCCESS;
+}
+#endif
+
+int32_t fossil_thread_create(fossil_xthread_t *thread, fossil_xthread_attr_t *attr, fossil_xtask_t task) {
+    if (!thread || !task.task_func) return FOSSIL_ERROR;
 
-    // Destroy the default thread attribute if created
-    if (!attr) {
-        fossil_thread_attr_erase(&default_attr);
+    // The creator may return before the thread starts, so the task goes on the heap
+    fossil_xthread_start_t *start = (fossil_xthread_start_t*)malloc(sizeof(fossil_xthread_start_t));
+    if (!start) return FOSSIL_ERROR;
+    start->task = task;
+    start->name[0] = '\0';
+    if (attr) {
+        memcpy(start->name, attr->name, FOSSIL_THREAD_NAME_MAX);
     }
 
     #ifdef _WIN32
-    return (*thread != NULL) ? FOSSIL_SUCCESS : FOSSIL_ERROR;
+    // Start suspended so affinity and name are in place before the task runs
+    DWORD stack_size = attr ? attr->stack_size : 0;
+    DWORD flags = CREATE_SUSPENDED | (stack_size ? STACK_SIZE_PARAM_IS_A_RESERVATION : 0);
+    *thread = CreateThread(NULL, stack_size, thread_start_routine, (LPVOID)start, flags, NULL);
+    if (*thread == NULL) {
+        free(start);
+        return FOSSIL_ERROR;
+    }
+    if (attr && attr->affinity_mask) {
+        SetThreadAffinityMask(*thread, attr->affinity_mask);
+    }
+    if (attr && attr->name[0] != '\0') {
+        thread_name_handle(*thread, attr->name);
+    }
+    ResumeThread(*thread);
+    return FOSSIL_SUCCESS;
     #else
+    int32_t result = pthread_create(thread, attr ? &attr->native : NULL, thread_start_routine, (void *)start);
+    if (result != 0) {
+        free(start);
+        return FOSSIL_ERROR;
+    }
     return FOSSIL_SUCCESS;
     #endif
 }
@@ -118,9 +210,12 @@ int32_t fossil_thread_attr_create(fossil_xthread_attr_t *attr) {
 #ifdef _WIN32
     attr->stack_size = 0;
     attr->detach_state = 0;
+    attr->affinity_mask = 0;
+    attr->name[0] = '\0';
     return FOSSIL_SUCCESS;
 #else
-    return pthread_attr_init(attr) == 0 ? FOSSIL_SUCCESS : FOSSIL_ERROR;
+    attr->name[0] = '\0';
+    return pthread_attr_init(&attr->native) == 0 ? FOSSIL_SUCCESS : FOSSIL_ERROR;
 #endif
 }
 
@@ -131,6 +226,209 @@ int32_t fossil_thread_attr_erase(fossil_xthread_attr_t *attr) {
     // No cleanup required for Windows attributes
     return FOSSIL_SUCCESS;
 #else
-    return pthread_attr_destroy(attr) == 0 ? FOSSIL_SUCCESS : FOSSIL_ERROR;
+    return pthread_attr_destroy(&attr->native) == 0 ? FOSSIL_SUCCESS : FOSSIL_ERROR;
+#endif
+}
+
+int32_t fossil_thread_attr_set_stack_size(fossil_xthread_attr_t *attr, size_t bytes) {
+    if (!attr) return FOSSIL_ERROR;
+
+#ifdef _WIN32
+    if (bytes > MAXDWORD) return FOSSIL_ERROR;
+    attr->stack_size = (DWORD)bytes;
+    return FOSSIL_SUCCESS;
+#else
+    if (bytes == 0) {
+        // pthread has no way back to the default, so start over with fresh attributes
+        fossil_xthread_attr_t fresh;
+        if (pthread_attr_init(&fresh.native) != 0) return FOSSIL_ERROR;
+        size_t size;
+        pthread_attr_getstacksize(&fresh.native, &size);
+        pthread_attr_destroy(&fresh.native);
+        return pthread_attr_setstacksize(&attr->native, size) == 0 ? FOSSIL_SUCCESS : FOSSIL_ERROR;
+    }
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+#ifdef PTHREAD_STACK_MIN
+    if (bytes < (size_t)PTHREAD_STACK_MIN) bytes = (size_t)PTHREAD_STACK_MIN;
+#endif
+    bytes = (bytes + page - 1) / page * page;
+    return pthread_attr_setstacksize(&attr->native, bytes) == 0 ? FOSSIL_SUCCESS : FOSSIL_ERROR;
+#endif
+}
+
+int32_t fossil_thread_attr_set_affinity(fossil_xthread_attr_t *attr, const fossil_xcpu_set_t *cpus) {
+    if (!attr) return FOSSIL_ERROR;
+
+#ifdef _WIN32
+    if (!cpus) {
+        attr->affinity_mask = 0;
+        return FOSSIL_SUCCESS;
+    }
+    DWORD_PTR mask = thread_cpu_mask(cpus);
+    if (mask == 0) return FOSSIL_ERROR;
+    attr->affinity_mask = mask;
+    return FOSSIL_SUCCESS;
+#elif defined(__linux__)
+    if (!cpus) {
+        // glibc drops the affinity from the attributes when given an empty set size
+        cpu_set_t none;
+        CPU_ZERO(&none);
+        return pthread_attr_setaffinity_np(&attr->native, 0, &none) == 0 ? FOSSIL_SUCCESS : FOSSIL_ERROR;
+    }
+    if (fossil_cpu_set_count(cpus) == 0) return FOSSIL_ERROR;
+    cpu_set_t native;
+    thread_cpu_set_native(cpus, &native);
+    return pthread_attr_setaffinity_np(&attr->native, sizeof(native), &native) == 0 ? FOSSIL_SUCCESS : FOSSIL_ERROR;
+#else
+    return cpus ? FOSSIL_ERROR : FOSSIL_SUCCESS;
+#endif
+}
+
+int32_t fossil_thread_attr_set_name(fossil_xthread_attr_t *attr, const char *name) {
+    if (!attr) return FOSSIL_ERROR;
+
+    snprintf(attr->name, sizeof(attr->name), "%s", name ? name : "");
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_thread_set_affinity(const fossil_xcpu_set_t *cpus) {
+    if (!cpus || fossil_cpu_set_count(cpus) == 0) return FOSSIL_ERROR;
+
+#ifdef _WIN32
+    DWORD_PTR mask = thread_cpu_mask(cpus);
+    return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0 ? FOSSIL_SUCCESS : FOSSIL_ERROR;
+#elif defined(__linux__)
+    cpu_set_t native;
+    thread_cpu_set_native(cpus, &native);
+    return pthread_setaffinity_np(pthread_self(), sizeof(native), &native) == 0 ? FOSSIL_SUCCESS : FOSSIL_ERROR;
+#else
+    return FOSSIL_ERROR;
+#endif
+}
+
+int32_t fossil_thread_get_affinity(fossil_xcpu_set_t *cpus) {
+    if (!cpus) return FOSSIL_ERROR;
+
+#ifdef _WIN32
+    DWORD_PTR process_mask, system_mask;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask)) return FOSSIL_ERROR;
+    thread_cpu_set_from_mask(cpus, (ULONGLONG)process_mask);
+    return FOSSIL_SUCCESS;
+#elif defined(__linux__)
+    cpu_set_t native;
+    if (pthread_getaffinity_np(pthread_self(), sizeof(native), &native) != 0) return FOSSIL_ERROR;
+    fossil_cpu_set_zero(cpus);
+    for (int32_t cpu = 0; cpu < FOSSIL_THREAD_MAX_CPUS && cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &native)) {
+            fossil_cpu_set_add(cpus, cpu);
+        }
+    }
+    return FOSSIL_SUCCESS;
+#else
+    int32_t count = fossil_thread_cpu_count();
+    fossil_cpu_set_zero(cpus);
+    for (int32_t cpu = 0; cpu < count; ++cpu) {
+        fossil_cpu_set_add(cpus, cpu);
+    }
+    return FOSSIL_SUCCESS;
+#endif
+}
+
+int32_t fossil_thread_set_name(const char *name) {
+    if (!name) return FOSSIL_ERROR;
+
+    char cut[FOSSIL_THREAD_NAME_MAX];
+    snprintf(cut, sizeof(cut), "%s", name);
+#ifdef _WIN32
+    return thread_name_handle(GetCurrentThread(), cut);
+#elif defined(__linux__)
+    return pthread_setname_np(pthread_self(), cut) == 0 ? FOSSIL_SUCCESS : FOSSIL_ERROR;
+#elif defined(__APPLE__)
+    return pthread_setname_np(cut) == 0 ? FOSSIL_SUCCESS : FOSSIL_ERROR;
+#else
+    return FOSSIL_ERROR;
+#endif
+}
+
+int32_t fossil_thread_cpu_count(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int32_t)info.dwNumberOfProcessors : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int32_t)count : 1;
+#endif
+}
+
+int32_t fossil_thread_numa_node_count(void) {
+#ifdef _WIN32
+    ULONG highest;
+    return GetNumaHighestNodeNumber(&highest) ? (int32_t)highest + 1 : 1;
+#elif defined(__linux__)
+    fossil_xcpu_set_t nodes;
+    if (thread_read_sysfs_list("/sys/devices/system/node/online", &nodes) != FOSSIL_SUCCESS) return 1;
+    int32_t count = fossil_cpu_set_count(&nodes);
+    return count > 0 ? count : 1;
+#else
+    return 1;
+#endif
+}
+
+int32_t fossil_thread_numa_node_cpus(int32_t node, fossil_xcpu_set_t *cpus) {
+    if (!cpus || node < 0 || node >= fossil_thread_numa_node_count()) return FOSSIL_ERROR;
+
+#ifdef _WIN32
+    ULONGLONG mask;
+    if (!GetNumaNodeProcessorMask((UCHAR)node, &mask)) return FOSSIL_ERROR;
+    thread_cpu_set_from_mask(cpus, mask);
+    return FOSSIL_SUCCESS;
+#elif defined(__linux__)
+    // Online nodes may be numbered with gaps, so find the node-th one
+    fossil_xcpu_set_t nodes;
+    if (thread_read_sysfs_list("/sys/devices/system/node/online", &nodes) != FOSSIL_SUCCESS) {
+        return fossil_thread_get_affinity(cpus);
+    }
+    for (int32_t id = 0; id < FOSSIL_THREAD_MAX_CPUS; ++id) {
+        if (fossil_cpu_set_has(&nodes, id) && node-- == 0) {
+            char path[64];
+            snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", (int)id);
+            return thread_read_sysfs_list(path, cpus);
+        }
+    }
+    return FOSSIL_ERROR;
+#else
+    return fossil_thread_get_affinity(cpus);
 #endif
 }
+
+void fossil_cpu_set_zero(fossil_xcpu_set_t *cpus) {
+    if (cpus) {
+        memset(cpus, 0, sizeof(*cpus));
+    }
+}
+
+int32_t fossil_cpu_set_add(fossil_xcpu_set_t *cpus, int32_t cpu) {
+    if (!cpus || cpu < 0 || cpu >= FOSSIL_THREAD_MAX_CPUS) return FOSSIL_ERROR;
+
+    cpus->bits[cpu / 64] |= (uint64_t)1 << (cpu % 64);
+    return FOSSIL_SUCCESS;
+}
+
+bool fossil_cpu_set_has(const fossil_xcpu_set_t *cpus, int32_t cpu) {
+    if (!cpus || cpu < 0 || cpu >= FOSSIL_THREAD_MAX_CPUS) return false;
+
+    return (cpus->bits[cpu / 64] >> (cpu % 64)) & 1u;
+}
+
+int32_t fossil_cpu_set_count(const fossil_xcpu_set_t *cpus) {
+    if (!cpus) return 0;
+
+    int32_t count = 0;
+    for (size_t i = 0; i < sizeof(cpus->bits) / sizeof(cpus->bits[0]); ++i) {
+        for (uint64_t word = cpus->bits[i]; word; word &= word - 1) {
+            ++count;
+        }
+    }
+    return count;
+}
@@ -10,9 +10,197 @@ Description:
     feel free to contact Michael at michaelbrockus@gmail.com.
 ==============================================================================
 */
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L // for clock_gettime
+#endif
 #include "fossil/threads/threadpool.h"
 #include "fossil/common/common.h"
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#ifndef _WIN32
+#include <sched.h>
+#include <time.h>
+#endif
+
+#define FOSSIL_POOL_CACHE_LINE 64
+#define FOSSIL_POOL_STEAL_BATCH 32
+
+// Task slot of a deque buffer; every word is atomic so a thief can read a slot the owner is writing
+typedef struct {
+    atomic_uintptr_t task_func;
+    atomic_uintptr_t arg;
+    atomic_uint_fast64_t enqueued;  // Submission time when the pool has metrics, 0 otherwise
+} fossil_xdeque_slot_t;
+
+// Circular buffer of a Chase-Lev deque, replaced by a larger one when full
+typedef struct fossil_xdeque_buffer_t {
+    int64_t mask;
+    struct fossil_xdeque_buffer_t *retired; // Smaller buffers this one replaced, freed with the pool
+    fossil_xdeque_slot_t slots[];
+} fossil_xdeque_buffer_t;
+
+// The owner pushes and pops at the bottom, thieves take from the top; each end gets its own cache line
+struct fossil_xthread_worker_t {
+    _Atomic int64_t top;
+    char top_pad[FOSSIL_POOL_CACHE_LINE - sizeof(int64_t)];
+    _Atomic int64_t bottom;
+    _Atomic(fossil_xdeque_buffer_t*) buffer;
+    fossil_xthread_pool_t *pool;
+    uint32_t seed;
+    char bottom_pad[FOSSIL_POOL_CACHE_LINE - sizeof(int64_t) - 2 * sizeof(void*) - sizeof(uint32_t)];
+};
+
+// Histogram written by one worker only; readers load its words while it runs
+typedef struct {
+    atomic_uint_fast64_t count;
+    atomic_uint_fast64_t sum_ns;
+    atomic_uint_fast64_t min_ns;
+    atomic_uint_fast64_t max_ns;
+    atomic_uint_fast64_t buckets[FOSSIL_THREAD_POOL_HISTOGRAM_BUCKETS];
+} fossil_xstats_histogram_t;
+
+// Counters of one worker, written by that worker only so timing a task touches no shared line
+typedef struct {
+    atomic_uint_fast64_t completed;
+    atomic_uint_fast64_t busy_ns;
+    atomic_uint_fast64_t idle_ns;
+    atomic_uint_fast64_t idle_since;    // Start of the current wait, 0 while running a task
+    atomic_uint_fast64_t running_since; // Start of the current task, 0 while waiting
+    atomic_uint_fast64_t submitted;     // Tasks this worker pushed on its own deque
+    atomic_int peak_depth;              // Largest queue depth seen when pushing them
+    fossil_xstats_histogram_t wait;
+    fossil_xstats_histogram_t run;
+    char pad[FOSSIL_POOL_CACHE_LINE];   // Keeps the next worker's counters off the last line of these
+} fossil_xworker_stats_t;
+
+struct fossil_xthread_pool_stats_t {
+    uint64_t submitted;                 // Tasks added to the shared queue; these three are guarded by the queue mutex
+    uint64_t rejected;
+    int32_t peak_depth;
+    fossil_xworker_stats_t workers[];
+};
+
+// Worker running on the current thread, so tasks spawned by a task go to its deque
+static _Thread_local fossil_xthread_worker_t *current_worker = NULL;
+
+// *****************************************************************************
+// Metrics
+// *****************************************************************************
+
+static uint64_t thread_pool_now_ns(void) {
+#ifdef _WIN32
+    LARGE_INTEGER now, frequency;
+    QueryPerformanceCounter(&now);
+    QueryPerformanceFrequency(&frequency);
+    return (uint64_t)(now.QuadPart / frequency.QuadPart) * 1000000000u +
+           (uint64_t)(now.QuadPart % frequency.QuadPart) * 1000000000u / (uint64_t)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+#endif
+}
+
+// Adds to a counter that only the calling thread writes, without a locked instruction
+static inline void stats_add(atomic_uint_fast64_t *counter, uint64_t value) {
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + value, memory_order_relaxed);
+}
+
+static size_t histogram_bucket(uint64_t ns) {
+    if (ns < FOSSIL_THREAD_POOL_HISTOGRAM_SUB_BUCKETS) return (size_t)ns;
+#if defined(__GNUC__) || defined(__clang__)
+    int exponent = 63 - __builtin_clzll(ns);
+#else
+    int exponent = 0;
+    for (uint64_t value = ns; value > 1; value >>= 1) ++exponent;
+#endif
+    if (exponent >= 40) return FOSSIL_THREAD_POOL_HISTOGRAM_BUCKETS - 1;
+    // The four bits below the leading one pick the sub-bucket
+    return (size_t)(exponent - 3) * FOSSIL_THREAD_POOL_HISTOGRAM_SUB_BUCKETS + (size_t)((ns >> (exponent - 4)) & 15u);
+}
+
+// The lowest value of a bucket
+static uint64_t histogram_bucket_low(size_t bucket) {
+    if (bucket < FOSSIL_THREAD_POOL_HISTOGRAM_SUB_BUCKETS) return bucket;
+    int shift = (int)(bucket / FOSSIL_THREAD_POOL_HISTOGRAM_SUB_BUCKETS) - 1;
+    return (uint64_t)(FOSSIL_THREAD_POOL_HISTOGRAM_SUB_BUCKETS + bucket % FOSSIL_THREAD_POOL_HISTOGRAM_SUB_BUCKETS) << shift;
+}
+
+// The highest value of a bucket
+static uint64_t histogram_bucket_high(size_t bucket) {
+    if (bucket < FOSSIL_THREAD_POOL_HISTOGRAM_SUB_BUCKETS) return bucket;
+    if (bucket == FOSSIL_THREAD_POOL_HISTOGRAM_BUCKETS - 1) return UINT64_MAX;
+    int shift = (int)(bucket / FOSSIL_THREAD_POOL_HISTOGRAM_SUB_BUCKETS) - 1;
+    return histogram_bucket_low(bucket) + ((uint64_t)1 << shift) - 1;
+}
+
+static void histogram_record(fossil_xstats_histogram_t *histogram, uint64_t ns) {
+    stats_add(&histogram->buckets[histogram_bucket(ns)], 1);
+    stats_add(&histogram->count, 1);
+    stats_add(&histogram->sum_ns, ns);
+    if (ns < atomic_load_explicit(&histogram->min_ns, memory_order_relaxed)) {
+        atomic_store_explicit(&histogram->min_ns, ns, memory_order_relaxed);
+    }
+    if (ns > atomic_load_explicit(&histogram->max_ns, memory_order_relaxed)) {
+        atomic_store_explicit(&histogram->max_ns, ns, memory_order_relaxed);
+    }
+}
+
+// Adds a worker's histogram to a snapshot
+static void histogram_merge(fossil_xthread_pool_histogram_t *out, fossil_xstats_histogram_t *histogram) {
+    uint64_t count = atomic_load_explicit(&histogram->count, memory_order_relaxed);
+    if (count == 0) return;
+    uint64_t min = atomic_load_explicit(&histogram->min_ns, memory_order_relaxed);
+    uint64_t max = atomic_load_explicit(&histogram->max_ns, memory_order_relaxed);
+    if (out->count == 0 || min < out->min_ns) out->min_ns = min;
+    if (max > out->max_ns) out->max_ns = max;
+    out->count += count;
+    out->sum_ns += atomic_load_explicit(&histogram->sum_ns, memory_order_relaxed);
+    for (size_t i = 0; i < FOSSIL_THREAD_POOL_HISTOGRAM_BUCKETS; ++i) {
+        out->buckets[i] += atomic_load_explicit(&histogram->buckets[i], memory_order_relaxed);
+    }
+}
+
+// The counters of a worker, which starts waiting now, or NULL if the pool has no metrics
+static fossil_xworker_stats_t *thread_pool_worker_stats(fossil_xthread_pool_t *pool, int32_t index) {
+    if (!pool->stats) return NULL;
+    fossil_xworker_stats_t *stats = &pool->stats->workers[index];
+    atomic_store_explicit(&stats->idle_since, thread_pool_now_ns(), memory_order_relaxed);
+    return stats;
+}
+
+/**
+ * @brief Runs a task, timing its wait in the queue and its run when the pool has metrics.
+ *
+ * @param stats The running worker's counters, or NULL.
+ * @param task The task to run.
+ * @param enqueued The task's submission time.
+ * @return void
+ */
+static inline void thread_pool_run(fossil_xworker_stats_t *stats, fossil_xtask_t task, uint64_t enqueued) {
+    if (!stats) {
+        task.task_func(task.arg);
+        return;
+    }
+
+    uint64_t start = thread_pool_now_ns();
+    uint64_t idle_since = atomic_load_explicit(&stats->idle_since, memory_order_relaxed);
+    atomic_store_explicit(&stats->running_since, start, memory_order_relaxed);
+    atomic_store_explicit(&stats->idle_since, 0, memory_order_relaxed);
+    stats_add(&stats->idle_ns, start - idle_since);
+    histogram_record(&stats->wait, start > enqueued ? start - enqueued : 0);
+
+    task.task_func(task.arg);
+
+    uint64_t finish = thread_pool_now_ns();
+    stats_add(&stats->busy_ns, finish - start);
+    histogram_record(&stats->run, finish - start);
+    stats_add(&stats->completed, 1);
+    atomic_store_explicit(&stats->running_since, 0, memory_order_relaxed);
+    atomic_store_explicit(&stats->idle_since, finish, memory_order_relaxed);
+}
 
 /**
  * @brief Platform-independent worker function for the thread pool.
@@ -22,25 +210,423 @@ Description:
  */
 static inline void thread_pool_worker(fossil_xtask_arg_t arg) {
     fossil_xthread_pool_t* pool = (fossil_xthread_pool_t*)arg;
+    fossil_xworker_stats_t *stats = thread_pool_worker_stats(pool, atomic_fetch_add(&pool->next_worker, 1));
     while (1) {
         fossil_mutex_lock(&pool->queue_mutex);
         while (atomic_load(&pool->task_count) == 0 && !atomic_load(&pool->shutdown)) {
+            atomic_fetch_add(&pool->sleepers, 1);
             fossil_cond_wait(&pool->queue_cond, &pool->queue_mutex);
+            atomic_fetch_sub(&pool->sleepers, 1);
         }
         if (atomic_load(&pool->shutdown) && atomic_load(&pool->task_count) == 0) {
             fossil_mutex_unlock(&pool->queue_mutex);
             break;
         }
         fossil_xtask_t task = pool->task_queue[pool->queue_front];
+        uint64_t enqueued = pool->enqueue_times ? pool->enqueue_times[pool->queue_front] : 0;
         pool->queue_front = (pool->queue_front + 1) % pool->queue_size;
         atomic_fetch_sub(&pool->task_count, 1);
+        if (pool->space_waiters > 0) {
+            fossil_cond_signal(&pool->space_cond);
+        }
         fossil_mutex_unlock(&pool->queue_mutex);
-        task.task_func(task.arg);
+        thread_pool_run(stats, task, enqueued);
     }
 }
 
-int32_t fossil_thread_pool_create(fossil_xthread_pool_t *pool, int32_t thread_count, int32_t queue_size) {
-    if (!pool || thread_count <= 0 || queue_size <= 0) return FOSSIL_ERROR;
+// *****************************************************************************
+// Work-stealing deque
+// *****************************************************************************
+
+static fossil_xdeque_buffer_t* deque_buffer_create(int64_t capacity) {
+    fossil_xdeque_buffer_t *buffer = (fossil_xdeque_buffer_t*)malloc(sizeof(fossil_xdeque_buffer_t) + sizeof(fossil_xdeque_slot_t) * (size_t)capacity);
+    if (!buffer) return NULL;
+    buffer->mask = capacity - 1;
+    buffer->retired = NULL;
+    return buffer;
+}
+
+static inline void deque_slot_store(fossil_xdeque_buffer_t *buffer, int64_t index, fossil_xtask_t task, uint64_t enqueued) {
+    fossil_xdeque_slot_t *slot = &buffer->slots[index & buffer->mask];
+    atomic_store_explicit(&slot->task_func, (uintptr_t)task.task_func, memory_order_relaxed);
+    atomic_store_explicit(&slot->arg, (uintptr_t)task.arg, memory_order_relaxed);
+    atomic_store_explicit(&slot->enqueued, enqueued, memory_order_relaxed);
+}
+
+static inline fossil_xtask_t deque_slot_load(fossil_xdeque_buffer_t *buffer, int64_t index, uint64_t *enqueued) {
+    fossil_xdeque_slot_t *slot = &buffer->slots[index & buffer->mask];
+    fossil_xtask_t task;
+    task.task_func = (fossil_xtask_func_t)atomic_load_explicit(&slot->task_func, memory_order_relaxed);
+    task.arg = (fossil_xtask_arg_t)atomic_load_explicit(&slot->arg, memory_order_relaxed);
+    *enqueued = atomic_load_explicit(&slot->enqueued, memory_order_relaxed);
+    return task;
+}
+
+/**
+ * @brief Pushes a task at the bottom of a worker's deque. Only the owner may push.
+ *
+ * @param worker The worker owning the deque.
+ * @param task The task to push.
+ * @param enqueued The task's submission time.
+ * @return bool false if the deque was full and could not grow.
+ */
+static bool deque_push(fossil_xthread_worker_t *worker, fossil_xtask_t task, uint64_t enqueued) {
+    int64_t bottom = atomic_load_explicit(&worker->bottom, memory_order_relaxed);
+    int64_t top = atomic_load_explicit(&worker->top, memory_order_acquire);
+    fossil_xdeque_buffer_t *buffer = atomic_load_explicit(&worker->buffer, memory_order_relaxed);
+
+    if (bottom - top > buffer->mask) {
+        // Thieves may still read the old buffer, so it is kept until the pool is erased
+        fossil_xdeque_buffer_t *grown = deque_buffer_create((buffer->mask + 1) * 2);
+        if (!grown) return false;
+        for (int64_t i = top; i < bottom; ++i) {
+            uint64_t moved_enqueued;
+            fossil_xtask_t moved = deque_slot_load(buffer, i, &moved_enqueued);
+            deque_slot_store(grown, i, moved, moved_enqueued);
+        }
+        grown->retired = buffer;
+        atomic_store_explicit(&worker->buffer, grown, memory_order_release);
+        buffer = grown;
+    }
+
+    deque_slot_store(buffer, bottom, task, enqueued);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_relaxed);
+    return true;
+}
+
+/**
+ * @brief Pops the most recently pushed task from a worker's deque. Only the owner may pop.
+ *
+ * @param worker The worker owning the deque.
+ * @param task Pointer to store the task.
+ * @param enqueued Pointer to store the task's submission time.
+ * @return bool true if a task was popped.
+ */
+static bool deque_pop(fossil_xthread_worker_t *worker, fossil_xtask_t *task, uint64_t *enqueued) {
+    int64_t bottom = atomic_load_explicit(&worker->bottom, memory_order_relaxed) - 1;
+    fossil_xdeque_buffer_t *buffer = atomic_load_explicit(&worker->buffer, memory_order_relaxed);
+    atomic_store_explicit(&worker->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t top = atomic_load_explicit(&worker->top, memory_order_relaxed);
+
+    if (top > bottom) {
+        atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_relaxed);
+        return false;
+    }
+
+    *task = deque_slot_load(buffer, bottom, enqueued);
+    if (top == bottom) {
+        // Last task, race the thieves for it
+        bool won = atomic_compare_exchange_strong_explicit(&worker->top, &top, top + 1,
+                                                           memory_order_seq_cst, memory_order_relaxed);
+        atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_relaxed);
+        return won;
+    }
+    return true;
+}
+
+/**
+ * @brief Steals the oldest task from another worker's deque.
+ *
+ * @param victim The worker to steal from.
+ * @param task Pointer to store the task.
+ * @param enqueued Pointer to store the task's submission time.
+ * @return int 1 if a task was stolen, 0 if the deque was empty, -1 if another thread won the race.
+ */
+static int deque_steal(fossil_xthread_worker_t *victim, fossil_xtask_t *task, uint64_t *enqueued) {
+    int64_t top = atomic_load_explicit(&victim->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t bottom = atomic_load_explicit(&victim->bottom, memory_order_acquire);
+
+    if (top >= bottom) return 0;
+
+    fossil_xdeque_buffer_t *buffer = atomic_load_explicit(&victim->buffer, memory_order_acquire);
+    uint64_t stolen_enqueued;
+    fossil_xtask_t stolen = deque_slot_load(buffer, top, &stolen_enqueued);
+    if (!atomic_compare_exchange_strong_explicit(&victim->top, &top, top + 1,
+                                                 memory_order_seq_cst, memory_order_relaxed)) {
+        return -1;
+    }
+    *task = stolen;
+    *enqueued = stolen_enqueued;
+    return 1;
+}
+
+// *****************************************************************************
+// Work-stealing worker
+// *****************************************************************************
+
+static inline void thread_pool_yield(void) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+static inline uint32_t thread_pool_random(fossil_xthread_worker_t *worker) {
+    // xorshift32
+    uint32_t x = worker->seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    worker->seed = x;
+    return x;
+}
+
+/**
+ * @brief Tries to steal a task, starting from a random victim and visiting every other worker once.
+ *
+ * @param pool Pointer to the thread pool structure.
+ * @param self The stealing worker.
+ * @param task Pointer to store the task.
+ * @param enqueued Pointer to store the task's submission time.
+ * @return bool true if a task was stolen.
+ */
+static bool thread_pool_steal(fossil_xthread_pool_t *pool, fossil_xthread_worker_t *self, fossil_xtask_t *task, uint64_t *enqueued) {
+    int32_t count = pool->thread_count;
+    if (count < 2) return false;
+
+    int32_t start = (int32_t)(thread_pool_random(self) % (uint32_t)count);
+    bool contended = true;
+    while (contended) {
+        contended = false;
+        for (int32_t i = 0; i < count; ++i) {
+            fossil_xthread_worker_t *victim = &pool->workers[(start + i) % count];
+            if (victim == self) continue;
+            int result = deque_steal(victim, task, enqueued);
+            if (result > 0) return true;
+            if (result < 0) contended = true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Moves a batch of tasks from the shared queue to a worker's deque. The queue mutex must be held.
+ *
+ * @param pool Pointer to the thread pool structure.
+ * @param self The worker taking the batch.
+ * @param task Pointer to store the first task of the batch, which is run instead of pushed.
+ * @param enqueued Pointer to store the first task's submission time.
+ * @return bool true if the shared queue held a task.
+ */
+static bool thread_pool_take_batch(fossil_xthread_pool_t *pool, fossil_xthread_worker_t *self, fossil_xtask_t *task, uint64_t *enqueued) {
+    int32_t queued = (pool->queue_rear - pool->queue_front + pool->queue_size) % pool->queue_size;
+    if (queued == 0) return false;
+
+    // Take half of the queue so the other workers get a share without stealing
+    int32_t batch = queued / 2;
+    if (batch < 1) batch = 1;
+    if (batch > FOSSIL_POOL_STEAL_BATCH) batch = FOSSIL_POOL_STEAL_BATCH;
+
+    *task = pool->task_queue[pool->queue_front];
+    *enqueued = pool->enqueue_times ? pool->enqueue_times[pool->queue_front] : 0;
+    pool->queue_front = (pool->queue_front + 1) % pool->queue_size;
+    for (int32_t i = 1; i < batch; ++i) {
+        uint64_t time = pool->enqueue_times ? pool->enqueue_times[pool->queue_front] : 0;
+        if (!deque_push(self, pool->task_queue[pool->queue_front], time)) break;
+        pool->queue_front = (pool->queue_front + 1) % pool->queue_size;
+    }
+    if (pool->space_waiters > 0) {
+        fossil_cond_broadcast(&pool->space_cond);
+    }
+    return true;
+}
+
+/**
+ * @brief Worker function of a work-stealing thread pool.
+ *
+ * The worker runs its own tasks newest first, then steals, then takes a batch from the shared
+ * queue, and sleeps only when no task is left anywhere in the pool.
+ *
+ * @param arg Pointer to the thread pool structure.
+ * @return void
+ */
+static void thread_pool_steal_worker(fossil_xtask_arg_t arg) {
+    fossil_xthread_pool_t* pool = (fossil_xthread_pool_t*)arg;
+    int32_t index = atomic_fetch_add(&pool->next_worker, 1);
+    fossil_xthread_worker_t *self = &pool->workers[index];
+    fossil_xworker_stats_t *stats = thread_pool_worker_stats(pool, index);
+    current_worker = self;
+
+    if (pool->placed) {
+        // Now that this thread is pinned, trade the deque the creator allocated for one first touched
+        // here; thieves only read the buffer once this worker has pushed, so nobody holds the old one
+        fossil_xdeque_buffer_t *buffer = atomic_load_explicit(&self->buffer, memory_order_relaxed);
+        fossil_xdeque_buffer_t *local = deque_buffer_create(buffer->mask + 1);
+        if (local) {
+            memset(local->slots, 0, sizeof(fossil_xdeque_slot_t) * (size_t)(local->mask + 1));
+            atomic_store_explicit(&self->buffer, local, memory_order_release);
+            free(buffer);
+        }
+    }
+
+    while (1) {
+        fossil_xtask_t task;
+        uint64_t enqueued;
+        if (deque_pop(self, &task, &enqueued) || thread_pool_steal(pool, self, &task, &enqueued)) {
+            atomic_fetch_sub(&pool->task_count, 1);
+            thread_pool_run(stats, task, enqueued);
+            continue;
+        }
+
+        fossil_mutex_lock(&pool->queue_mutex);
+        if (thread_pool_take_batch(pool, self, &task, &enqueued)) {
+            fossil_mutex_unlock(&pool->queue_mutex);
+            atomic_fetch_sub(&pool->task_count, 1);
+            thread_pool_run(stats, task, enqueued);
+            continue;
+        }
+        if (atomic_load(&pool->task_count) > 0) {
+            // A task is counted but not yet visible in a deque
+            fossil_mutex_unlock(&pool->queue_mutex);
+            thread_pool_yield();
+            continue;
+        }
+        if (atomic_load(&pool->shutdown)) {
+            fossil_mutex_unlock(&pool->queue_mutex);
+            break;
+        }
+
+        // Announce the sleeper before checking again, so a worker pushing to its deque either sees it or is seen
+        atomic_fetch_add(&pool->sleepers, 1);
+        if (atomic_load(&pool->task_count) <= 0 && !atomic_load(&pool->shutdown)) {
+            fossil_cond_wait(&pool->queue_cond, &pool->queue_mutex);
+        }
+        atomic_fetch_sub(&pool->sleepers, 1);
+        fossil_mutex_unlock(&pool->queue_mutex);
+    }
+
+    current_worker = NULL;
+}
+
+static void thread_pool_free_workers(fossil_xthread_pool_t *pool, int32_t count) {
+    if (!pool->workers) return;
+    for (int32_t i = 0; i < count; ++i) {
+        fossil_xdeque_buffer_t *buffer = atomic_load(&pool->workers[i].buffer);
+        while (buffer) {
+            fossil_xdeque_buffer_t *retired = buffer->retired;
+            free(buffer);
+            buffer = retired;
+        }
+    }
+    free(pool->workers);
+    pool->workers = NULL;
+}
+
+static void thread_pool_free_stats(fossil_xthread_pool_t *pool) {
+    free(pool->stats);
+    free(pool->enqueue_times);
+    pool->stats = NULL;
+    pool->enqueue_times = NULL;
+}
+
+static int32_t thread_pool_create_stats(fossil_xthread_pool_t *pool, int32_t thread_count, int32_t queue_size) {
+    pool->stats = (fossil_xthread_pool_stats_t*)calloc(1, sizeof(fossil_xthread_pool_stats_t) + sizeof(fossil_xworker_stats_t) * (size_t)thread_count);
+    pool->enqueue_times = (uint64_t*)malloc(sizeof(uint64_t) * (size_t)queue_size);
+    if (!pool->stats || !pool->enqueue_times) {
+        thread_pool_free_stats(pool);
+        return FOSSIL_ERROR;
+    }
+    for (int32_t i = 0; i < thread_count; ++i) {
+        atomic_init(&pool->stats->workers[i].wait.min_ns, UINT64_MAX);
+        atomic_init(&pool->stats->workers[i].run.min_ns, UINT64_MAX);
+    }
+    return FOSSIL_SUCCESS;
+}
+
+static int32_t thread_pool_create_workers(fossil_xthread_pool_t *pool, int32_t thread_count, int32_t queue_size) {
+    int64_t capacity = 16;
+    while (capacity < queue_size) capacity *= 2;
+
+    pool->workers = (fossil_xthread_worker_t*)calloc((size_t)thread_count, sizeof(fossil_xthread_worker_t));
+    if (!pool->workers) return FOSSIL_ERROR;
+
+    for (int32_t i = 0; i < thread_count; ++i) {
+        fossil_xthread_worker_t *worker = &pool->workers[i];
+        fossil_xdeque_buffer_t *buffer = deque_buffer_create(capacity);
+        if (!buffer) {
+            thread_pool_free_workers(pool, i);
+            return FOSSIL_ERROR;
+        }
+        atomic_init(&worker->top, 0);
+        atomic_init(&worker->bottom, 0);
+        atomic_init(&worker->buffer, buffer);
+        worker->pool = pool;
+        worker->seed = 2463534242u + (uint32_t)i * 2654435761u;
+    }
+    return FOSSIL_SUCCESS;
+}
+
+// *****************************************************************************
+// Thread pool
+// *****************************************************************************
+
+/**
+ * @brief Prepares the thread attributes of one worker from the pool options.
+ *
+ * Placement is best effort: a worker whose CPUs cannot be set runs unpinned.
+ *
+ * @param options The pool options.
+ * @param allowed The CPUs the creating thread may use.
+ * @param index The worker's index.
+ * @param attr Pointer to the attributes to initialize.
+ * @return int32_t 0 if successful, -1 if the attributes could not be created.
+ */
+static int32_t thread_pool_worker_attr(const fossil_xthread_pool_options_t *options, const fossil_xcpu_set_t *allowed,
+                                       int32_t index, fossil_xthread_attr_t *attr) {
+    if (fossil_thread_attr_create(attr) != FOSSIL_SUCCESS) return FOSSIL_ERROR;
+
+    if (options->stack_size > 0 && fossil_thread_attr_set_stack_size(attr, options->stack_size) != FOSSIL_SUCCESS) {
+        fossil_thread_attr_erase(attr);
+        return FOSSIL_ERROR;
+    }
+    if (options->name) {
+        char name[64];
+        snprintf(name, sizeof(name), "%s-%d", options->name, (int)index);
+        fossil_thread_attr_set_name(attr, name);
+    }
+
+    fossil_xcpu_set_t cpus;
+    fossil_cpu_set_zero(&cpus);
+    if (options->placement == FOSSIL_THREAD_POOL_PLACE_COMPACT && fossil_cpu_set_count(allowed) > 0) {
+        int32_t nth = index % fossil_cpu_set_count(allowed);
+        for (int32_t cpu = 0; cpu < FOSSIL_THREAD_MAX_CPUS; ++cpu) {
+            if (fossil_cpu_set_has(allowed, cpu) && nth-- == 0) {
+                fossil_cpu_set_add(&cpus, cpu);
+                break;
+            }
+        }
+    } else if (options->placement == FOSSIL_THREAD_POOL_PLACE_SPREAD) {
+        fossil_xcpu_set_t node;
+        if (fossil_thread_numa_node_cpus(index % fossil_thread_numa_node_count(), &node) == FOSSIL_SUCCESS) {
+            for (size_t i = 0; i < sizeof(cpus.bits) / sizeof(cpus.bits[0]); ++i) {
+                cpus.bits[i] = node.bits[i] & allowed->bits[i];
+            }
+            if (fossil_cpu_set_count(&cpus) == 0) {
+                cpus = node; // The creator is kept off this node, so let the worker decide
+            }
+        }
+    }
+    if (fossil_cpu_set_count(&cpus) > 0) {
+        fossil_thread_attr_set_affinity(attr, &cpus);
+    }
+    return FOSSIL_SUCCESS;
+}
+
+static int32_t thread_pool_create(fossil_xthread_pool_t *pool, const fossil_xthread_pool_options_t *options) {
+    if (!pool || !options || options->thread_count <= 0 || options->queue_size <= 0) return FOSSIL_ERROR;
+
+    int32_t thread_count = options->thread_count;
+    int32_t queue_size = options->queue_size;
+    bool stealing = options->stealing;
+    fossil_xcpu_set_t allowed;
+    fossil_cpu_set_zero(&allowed);
+    if (options->placement != FOSSIL_THREAD_POOL_PLACE_NONE && fossil_thread_get_affinity(&allowed) != FOSSIL_SUCCESS) {
+        return FOSSIL_ERROR;
+    }
 
     pool->threads = (fossil_xthread_t*)malloc(sizeof(fossil_xthread_t) * thread_count);
     if (!pool->threads) return FOSSIL_ERROR;
@@ -49,8 +635,16 @@ int32_t fossil_thread_pool_create(fossil_xthread_pool_t *pool, int32_t thread_co
     pool->queue_size = queue_size;
     pool->queue_front = 0;
     pool->queue_rear = 0;
+    pool->workers = NULL;
+    pool->space_waiters = 0;
+    pool->growable = 0;
     atomic_init(&pool->shutdown, 0);
     atomic_init(&pool->task_count, 0);
+    atomic_init(&pool->sleepers, 0);
+    atomic_init(&pool->next_worker, 0);
+    pool->placed = options->placement != FOSSIL_THREAD_POOL_PLACE_NONE;
+    pool->stats = NULL;
+    pool->enqueue_times = NULL;
 
     pool->task_queue = (fossil_xtask_t*)malloc(sizeof(fossil_xtask_t) * queue_size);
     if (!pool->task_queue) {
@@ -59,7 +653,26 @@ int32_t fossil_thread_pool_create(fossil_xthread_pool_t *pool, int32_t thread_co
         return FOSSIL_ERROR;
     }
 
+    if (options->metrics && thread_pool_create_stats(pool, thread_count, queue_size) != FOSSIL_SUCCESS) {
+        free(pool->threads);
+        free(pool->task_queue);
+        pool->threads = NULL;
+        pool->task_queue = NULL;
+        return FOSSIL_ERROR;
+    }
+
+    if (stealing && thread_pool_create_workers(pool, thread_count, queue_size) != FOSSIL_SUCCESS) {
+        thread_pool_free_stats(pool);
+        free(pool->threads);
+        free(pool->task_queue);
+        pool->threads = NULL;
+        pool->task_queue = NULL;
+        return FOSSIL_ERROR;
+    }
+
     if (fossil_mutex_create(&pool->queue_mutex) != 0) {
+        thread_pool_free_workers(pool, thread_count);
+        thread_pool_free_stats(pool);
         free(pool->threads);
         free(pool->task_queue);
         pool->threads = NULL;
@@ -69,6 +682,20 @@ int32_t fossil_thread_pool_create(fossil_xthread_pool_t *pool, int32_t thread_co
 
     if (fossil_cond_create(&pool->queue_cond) != 0) {
         fossil_mutex_erase(&pool->queue_mutex);
+        thread_pool_free_workers(pool, thread_count);
+        thread_pool_free_stats(pool);
+        free(pool->threads);
+        free(pool->task_queue);
+        pool->threads = NULL;
+        pool->task_queue = NULL;
+        return FOSSIL_ERROR;
+    }
+
+    if (fossil_cond_create(&pool->space_cond) != 0) {
+        fossil_cond_erase(&pool->queue_cond);
+        fossil_mutex_erase(&pool->queue_mutex);
+        thread_pool_free_workers(pool, thread_count);
+        thread_pool_free_stats(pool);
         free(pool->threads);
         free(pool->task_queue);
         pool->threads = NULL;
@@ -76,9 +703,17 @@ int32_t fossil_thread_pool_create(fossil_xthread_pool_t *pool, int32_t thread_co
         return FOSSIL_ERROR;
     }
 
+    fossil_xtask_func_t worker = stealing ? (fossil_xtask_func_t)thread_pool_steal_worker
+                                          : (fossil_xtask_func_t)thread_pool_worker;
     for (int i = 0; i < thread_count; ++i) {
-        fossil_xtask_t task = { .task_func = (fossil_xtask_func_t)thread_pool_worker, .arg = pool };
-        if (fossil_thread_create(&pool->threads[i], NULL, task) != FOSSIL_SUCCESS) {
+        fossil_xtask_t task = { .task_func = worker, .arg = pool };
+        fossil_xthread_attr_t attr;
+        int32_t result = thread_pool_worker_attr(options, &allowed, i, &attr);
+        if (result == FOSSIL_SUCCESS) {
+            result = fossil_thread_create(&pool->threads[i], &attr, task);
+            fossil_thread_attr_erase(&attr);
+        }
+        if (result != FOSSIL_SUCCESS) {
             atomic_store(&pool->shutdown, 1);
             fossil_mutex_lock(&pool->queue_mutex);
             fossil_cond_broadcast(&pool->queue_cond);
@@ -89,6 +724,9 @@ int32_t fossil_thread_pool_create(fossil_xthread_pool_t *pool, int32_t thread_co
             }
             fossil_mutex_erase(&pool->queue_mutex);
             fossil_cond_erase(&pool->queue_cond);
+            fossil_cond_erase(&pool->space_cond);
+            thread_pool_free_workers(pool, thread_count);
+            thread_pool_free_stats(pool);
             free(pool->threads);
             free(pool->task_queue);
             pool->threads = NULL;
@@ -100,6 +738,20 @@ int32_t fossil_thread_pool_create(fossil_xthread_pool_t *pool, int32_t thread_co
     return FOSSIL_SUCCESS;
 }
 
+int32_t fossil_thread_pool_create(fossil_xthread_pool_t *pool, int32_t thread_count, int32_t queue_size) {
+    fossil_xthread_pool_options_t options = { .thread_count = thread_count, .queue_size = queue_size };
+    return thread_pool_create(pool, &options);
+}
+
+int32_t fossil_thread_pool_create_stealing(fossil_xthread_pool_t *pool, int32_t thread_count, int32_t queue_size) {
+    fossil_xthread_pool_options_t options = { .thread_count = thread_count, .queue_size = queue_size, .stealing = true };
+    return thread_pool_create(pool, &options);
+}
+
+int32_t fossil_thread_pool_create_options(fossil_xthread_pool_t *pool, const fossil_xthread_pool_options_t *options) {
+    return thread_pool_create(pool, options);
+}
+
 int32_t fossil_thread_pool_erase(fossil_xthread_pool_t *pool) {
     if (!pool) return FOSSIL_ERROR;
 
@@ -107,35 +759,352 @@ int32_t fossil_thread_pool_erase(fossil_xthread_pool_t *pool) {
 
     fossil_mutex_lock(&pool->queue_mutex);
     fossil_cond_broadcast(&pool->queue_cond);
+    fossil_cond_broadcast(&pool->space_cond);
     fossil_mutex_unlock(&pool->queue_mutex);
 
     for (int i = 0; i < pool->thread_count; ++i) {
         fossil_thread_join(pool->threads[i], NULL);
     }
 
+    thread_pool_free_workers(pool, pool->thread_count);
+    thread_pool_free_stats(pool);
     free(pool->threads);
     free(pool->task_queue);
     fossil_mutex_erase(&pool->queue_mutex);
     fossil_cond_erase(&pool->queue_cond);
+    fossil_cond_erase(&pool->space_cond);
 
     return FOSSIL_SUCCESS;
 }
 
+// *****************************************************************************
+// Submission
+// *****************************************************************************
+
+static uint64_t thread_pool_now_ms(void) {
+#ifdef _WIN32
+    return (uint64_t)GetTickCount64();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000u + (uint64_t)now.tv_nsec / 1000000u;
+#endif
+}
+
+/**
+ * @brief Doubles the shared queue, keeping its tasks in order. The queue mutex must be held.
+ *
+ * @param pool Pointer to the thread pool structure.
+ * @return bool false if the queue could not grow.
+ */
+static bool thread_pool_grow(fossil_xthread_pool_t *pool) {
+    if (pool->queue_size > INT32_MAX / 2) return false;
+
+    int32_t size = pool->queue_size * 2;
+    fossil_xtask_t *queue = (fossil_xtask_t*)malloc(sizeof(fossil_xtask_t) * (size_t)size);
+    if (!queue) return false;
+    uint64_t *times = NULL;
+    if (pool->enqueue_times) {
+        times = (uint64_t*)malloc(sizeof(uint64_t) * (size_t)size);
+        if (!times) {
+            free(queue);
+            return false;
+        }
+    }
+
+    int32_t queued = (pool->queue_rear - pool->queue_front + pool->queue_size) % pool->queue_size;
+    int32_t first = pool->queue_size - pool->queue_front;
+    if (first > queued) first = queued;
+    memcpy(queue, pool->task_queue + pool->queue_front, sizeof(fossil_xtask_t) * (size_t)first);
+    memcpy(queue + first, pool->task_queue, sizeof(fossil_xtask_t) * (size_t)(queued - first));
+    if (times) {
+        memcpy(times, pool->enqueue_times + pool->queue_front, sizeof(uint64_t) * (size_t)first);
+        memcpy(times + first, pool->enqueue_times, sizeof(uint64_t) * (size_t)(queued - first));
+        free(pool->enqueue_times);
+        pool->enqueue_times = times;
+    }
+
+    free(pool->task_queue);
+    pool->task_queue = queue;
+    pool->queue_size = size;
+    pool->queue_front = 0;
+    pool->queue_rear = queued;
+    return true;
+}
+
+// Wakes up to count idle workers. The queue mutex must be held.
+static void thread_pool_wake(fossil_xthread_pool_t *pool, int32_t count) {
+    int32_t sleepers = atomic_load(&pool->sleepers);
+    if (count >= sleepers) {
+        if (sleepers > 0) {
+            fossil_cond_broadcast(&pool->queue_cond);
+        }
+        return;
+    }
+    for (int32_t i = 0; i < count; ++i) {
+        fossil_cond_signal(&pool->queue_cond);
+    }
+}
+
+/**
+ * @brief Adds tasks to the pool, waiting for space in the shared queue for at most the given time.
+ *
+ * @param pool Pointer to the thread pool structure.
+ * @param tasks The tasks to add, in order.
+ * @param count The number of tasks.
+ * @param milliseconds The longest time to wait for space, or FOSSIL_THREAD_POOL_WAIT_FOREVER.
+ * @return int32_t The number of tasks added.
+ */
+static int32_t thread_pool_enqueue(fossil_xthread_pool_t *pool, const fossil_xtask_t *tasks, int32_t count, int32_t milliseconds) {
+    int32_t added = 0;
+
+    fossil_xthread_worker_t *self = current_worker;
+    if (self && self->pool == pool) {
+        // Spawned by a task of this pool, keep them on the worker's deque
+        uint64_t now = pool->stats ? thread_pool_now_ns() : 0;
+        int32_t depth = 0;
+        for (; added < count; ++added) {
+            depth = atomic_fetch_add(&pool->task_count, 1) + 1;
+            if (!deque_push(self, tasks[added], now)) {
+                atomic_fetch_sub(&pool->task_count, 1);
+                break;
+            }
+        }
+        if (pool->stats && added > 0) {
+            fossil_xworker_stats_t *stats = &pool->stats->workers[self - pool->workers];
+            stats_add(&stats->submitted, (uint64_t)added);
+            if (depth > atomic_load_explicit(&stats->peak_depth, memory_order_relaxed)) {
+                atomic_store_explicit(&stats->peak_depth, depth, memory_order_relaxed);
+            }
+        }
+        if (added > 0 && atomic_load(&pool->sleepers) > 0) {
+            fossil_mutex_lock(&pool->queue_mutex);
+            thread_pool_wake(pool, added);
+            fossil_mutex_unlock(&pool->queue_mutex);
+        }
+        if (added == count) return added;
+    }
+
+    uint64_t deadline = milliseconds > 0 ? thread_pool_now_ms() + (uint64_t)milliseconds : 0;
+
+    fossil_mutex_lock(&pool->queue_mutex);
+    while (added < count) {
+        int32_t start = added;
+        uint64_t submitted = pool->stats ? thread_pool_now_ns() : 0;
+        while (added < count) {
+            if ((pool->queue_rear + 1) % pool->queue_size == pool->queue_front &&
+                !(pool->growable && thread_pool_grow(pool))) {
+                break; // Queue is full
+            }
+            if (pool->enqueue_times) {
+                pool->enqueue_times[pool->queue_rear] = submitted;
+            }
+            pool->task_queue[pool->queue_rear] = tasks[added++];
+            pool->queue_rear = (pool->queue_rear + 1) % pool->queue_size;
+        }
+        if (added > start) {
+            int32_t depth = atomic_fetch_add(&pool->task_count, added - start) + added - start;
+            thread_pool_wake(pool, added - start);
+            if (pool->stats) {
+                pool->stats->submitted += (uint64_t)(added - start);
+                if (depth > pool->stats->peak_depth) pool->stats->peak_depth = depth;
+            }
+        }
+        if (added == count || milliseconds == 0 || atomic_load(&pool->shutdown)) break;
+        uint64_t now = milliseconds > 0 ? thread_pool_now_ms() : 0;
+        if (milliseconds > 0 && now >= deadline) break;
+
+        // Park until a worker takes a task from the queue
+        pool->space_waiters++;
+        if (milliseconds < 0) {
+            fossil_cond_wait(&pool->space_cond, &pool->queue_mutex);
+        } else {
+            fossil_cond_timedwait(&pool->space_cond, &pool->queue_mutex, (uint32_t)(deadline - now));
+        }
+        pool->space_waiters--;
+    }
+    if (pool->stats) {
+        pool->stats->rejected += (uint64_t)(count - added);
+    }
+    fossil_mutex_unlock(&pool->queue_mutex);
+
+    return added;
+}
+
 int32_t fossil_thread_pool_add_task(fossil_xthread_pool_t *pool, fossil_xtask_func_t task_func, void *arg) {
     if (!pool || !task_func) return FOSSIL_ERROR;
 
+    fossil_xtask_t new_task = { .task_func = task_func, .arg = arg };
+    return thread_pool_enqueue(pool, &new_task, 1, 0) == 1 ? FOSSIL_SUCCESS : FOSSIL_ERROR;
+}
+
+int32_t fossil_thread_pool_add_task_wait(fossil_xthread_pool_t *pool, fossil_xtask_func_t task_func, void *arg, int32_t milliseconds) {
+    if (!pool || !task_func) return FOSSIL_ERROR;
+
+    fossil_xtask_t new_task = { .task_func = task_func, .arg = arg };
+    return thread_pool_enqueue(pool, &new_task, 1, milliseconds) == 1 ? FOSSIL_SUCCESS : FOSSIL_ERROR;
+}
+
+int32_t fossil_thread_pool_add_tasks(fossil_xthread_pool_t *pool, const fossil_xtask_t *tasks, int32_t count, int32_t milliseconds) {
+    if (!pool || count < 0 || (count > 0 && !tasks)) return FOSSIL_ERROR;
+    for (int32_t i = 0; i < count; ++i) {
+        if (!tasks[i].task_func) return FOSSIL_ERROR;
+    }
+    return thread_pool_enqueue(pool, tasks, count, milliseconds);
+}
+
+int32_t fossil_thread_pool_set_growable(fossil_xthread_pool_t *pool, bool growable) {
+    if (!pool) return FOSSIL_ERROR;
+
     fossil_mutex_lock(&pool->queue_mutex);
-    if ((pool->queue_rear + 1) % pool->queue_size == pool->queue_front) {
-        fossil_mutex_unlock(&pool->queue_mutex);
-        return FOSSIL_ERROR; // Queue is full
+    pool->growable = growable ? 1 : 0;
+    if (growable && pool->space_waiters > 0) {
+        fossil_cond_broadcast(&pool->space_cond);
+    }
+    fossil_mutex_unlock(&pool->queue_mutex);
+    return FOSSIL_SUCCESS;
+}
+
+// *****************************************************************************
+// Metrics snapshots
+// *****************************************************************************
+
+static void thread_pool_worker_snapshot(fossil_xworker_stats_t *stats, uint64_t now, fossil_xthread_pool_worker_metrics_t *metrics) {
+    metrics->completed = atomic_load_explicit(&stats->completed, memory_order_relaxed);
+    metrics->busy_ns = atomic_load_explicit(&stats->busy_ns, memory_order_relaxed);
+    metrics->idle_ns = atomic_load_explicit(&stats->idle_ns, memory_order_relaxed);
+
+    // Count the task or the wait in progress as well
+    uint64_t running_since = atomic_load_explicit(&stats->running_since, memory_order_relaxed);
+    uint64_t idle_since = atomic_load_explicit(&stats->idle_since, memory_order_relaxed);
+    if (running_since && now > running_since) {
+        metrics->busy_ns += now - running_since;
+    } else if (idle_since && now > idle_since) {
+        metrics->idle_ns += now - idle_since;
     }
+}
 
-    fossil_xtask_t new_task = { .task_func = task_func, .arg = arg };
-    pool->task_queue[pool->queue_rear] = new_task;
-    pool->queue_rear = (pool->queue_rear + 1) % pool->queue_size;
-    atomic_fetch_add(&pool->task_count, 1);
-    fossil_cond_signal(&pool->queue_cond);
+int32_t fossil_thread_pool_metrics(fossil_xthread_pool_t *pool, fossil_xthread_pool_metrics_t *metrics) {
+    if (!pool || !metrics || !pool->stats) return FOSSIL_ERROR;
+
+    memset(metrics, 0, sizeof(*metrics));
+    fossil_mutex_lock(&pool->queue_mutex);
+    metrics->submitted = pool->stats->submitted;
+    metrics->rejected = pool->stats->rejected;
+    metrics->peak_queue_depth = pool->stats->peak_depth;
     fossil_mutex_unlock(&pool->queue_mutex);
 
+    int32_t depth = atomic_load(&pool->task_count);
+    metrics->queue_depth = depth > 0 ? depth : 0;
+
+    uint64_t now = thread_pool_now_ns();
+    for (int32_t i = 0; i < pool->thread_count; ++i) {
+        fossil_xworker_stats_t *stats = &pool->stats->workers[i];
+        fossil_xthread_pool_worker_metrics_t worker;
+        thread_pool_worker_snapshot(stats, now, &worker);
+        metrics->completed += worker.completed;
+        metrics->busy_ns += worker.busy_ns;
+        metrics->idle_ns += worker.idle_ns;
+        metrics->submitted += atomic_load_explicit(&stats->submitted, memory_order_relaxed);
+        int32_t peak = atomic_load_explicit(&stats->peak_depth, memory_order_relaxed);
+        if (peak > metrics->peak_queue_depth) metrics->peak_queue_depth = peak;
+        histogram_merge(&metrics->wait, &stats->wait);
+        histogram_merge(&metrics->run, &stats->run);
+    }
     return FOSSIL_SUCCESS;
 }
+
+int32_t fossil_thread_pool_worker_metrics(fossil_xthread_pool_t *pool, int32_t worker, fossil_xthread_pool_worker_metrics_t *metrics) {
+    if (!pool || !metrics || !pool->stats || worker < 0 || worker >= pool->thread_count) return FOSSIL_ERROR;
+
+    thread_pool_worker_snapshot(&pool->stats->workers[worker], thread_pool_now_ns(), metrics);
+    return FOSSIL_SUCCESS;
+}
+
+uint64_t fossil_thread_pool_histogram_percentile(const fossil_xthread_pool_histogram_t *histogram, double percentile) {
+    if (!histogram || histogram->count == 0) return 0;
+    if (percentile < 0.0) percentile = 0.0;
+    if (percentile > 100.0) percentile = 100.0;
+
+    // The rank of the value that the percentile falls on, counting from 1
+    double target = percentile / 100.0 * (double)histogram->count;
+    uint64_t rank = (uint64_t)target;
+    if ((double)rank < target || rank == 0) ++rank;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < FOSSIL_THREAD_POOL_HISTOGRAM_BUCKETS; ++i) {
+        seen += histogram->buckets[i];
+        if (seen >= rank) {
+            uint64_t high = histogram_bucket_high(i);
+            return high < histogram->max_ns ? high : histogram->max_ns;
+        }
+    }
+    return histogram->max_ns;
+}
+
+static void thread_pool_write_histogram(FILE *file, const char *name, const fossil_xthread_pool_histogram_t *histogram) {
+    fprintf(file, "  \"%s\": {\"count\": %llu, \"mean\": %.1f, \"min\": %llu, \"p50\": %llu, \"p90\": %llu, "
+            "\"p99\": %llu, \"p999\": %llu, \"max\": %llu,\n    \"buckets\": [",
+            name, (unsigned long long)histogram->count,
+            histogram->count ? (double)histogram->sum_ns / (double)histogram->count : 0.0,
+            (unsigned long long)histogram->min_ns,
+            (unsigned long long)fossil_thread_pool_histogram_percentile(histogram, 50.0),
+            (unsigned long long)fossil_thread_pool_histogram_percentile(histogram, 90.0),
+            (unsigned long long)fossil_thread_pool_histogram_percentile(histogram, 99.0),
+            (unsigned long long)fossil_thread_pool_histogram_percentile(histogram, 99.9),
+            (unsigned long long)histogram->max_ns);
+
+    // Non-empty buckets only, as [lowest value, count]
+    bool first = true;
+    for (size_t i = 0; i < FOSSIL_THREAD_POOL_HISTOGRAM_BUCKETS; ++i) {
+        if (histogram->buckets[i] == 0) continue;
+        fprintf(file, "%s[%llu, %llu]", first ? "" : ", ", (unsigned long long)histogram_bucket_low(i),
+                (unsigned long long)histogram->buckets[i]);
+        first = false;
+    }
+    fprintf(file, "]}");
+}
+
+int32_t fossil_thread_pool_metrics_export_json(fossil_xthread_pool_t *pool, const char *filename) {
+    if (!filename) return FOSSIL_ERROR;
+
+    // The snapshot holds two histograms, too large to keep on the stack of a small thread
+    fossil_xthread_pool_metrics_t *metrics = (fossil_xthread_pool_metrics_t*)malloc(sizeof(fossil_xthread_pool_metrics_t));
+    if (!metrics) return FOSSIL_ERROR;
+    if (fossil_thread_pool_metrics(pool, metrics) != FOSSIL_SUCCESS) {
+        free(metrics);
+        return FOSSIL_ERROR;
+    }
+
+    FILE *file = fopen(filename, "w");
+    if (!file) {
+        free(metrics);
+        return FOSSIL_ERROR;
+    }
+
+    uint64_t total = metrics->busy_ns + metrics->idle_ns;
+    fprintf(file, "{\n  \"threads\": %d,\n  \"submitted\": %llu,\n  \"rejected\": %llu,\n  \"completed\": %llu,\n"
+            "  \"queue_depth\": %d,\n  \"peak_queue_depth\": %d,\n  \"busy_ns\": %llu,\n  \"idle_ns\": %llu,\n"
+            "  \"utilization\": %.4f,\n",
+            (int)pool->thread_count, (unsigned long long)metrics->submitted, (unsigned long long)metrics->rejected,
+            (unsigned long long)metrics->completed, (int)metrics->queue_depth, (int)metrics->peak_queue_depth,
+            (unsigned long long)metrics->busy_ns, (unsigned long long)metrics->idle_ns,
+            total ? (double)metrics->busy_ns / (double)total : 0.0);
+    thread_pool_write_histogram(file, "wait_ns", &metrics->wait);
+    fprintf(file, ",\n");
+    thread_pool_write_histogram(file, "run_ns", &metrics->run);
+    fprintf(file, ",\n  \"workers\": [");
+
+    uint64_t now = thread_pool_now_ns();
+    for (int32_t i = 0; i < pool->thread_count; ++i) {
+        fossil_xthread_pool_worker_metrics_t worker;
+        thread_pool_worker_snapshot(&pool->stats->workers[i], now, &worker);
+        fprintf(file, "%s\n    {\"worker\": %d, \"completed\": %llu, \"busy_ns\": %llu, \"idle_ns\": %llu}",
+                i ? "," : "", (int)i, (unsigned long long)worker.completed,
+                (unsigned long long)worker.busy_ns, (unsigned long long)worker.idle_ns);
+    }
+    fprintf(file, "\n  ]\n}\n");
+
+    free(metrics);
+    return fclose(file) == 0 ? FOSSIL_SUCCESS : FOSSIL_ERROR;
+}
@@ -0,0 +1,439 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifdef __linux__
+#define _GNU_SOURCE // for timerfd
+#elif !defined(_WIN32)
+#define _POSIX_C_SOURCE 200809L // for clock_gettime
+#endif
+#include "fossil/threads/timer.h"
+#include "fossil/common/common.h"
+#include <string.h>
+#ifdef __linux__
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+#define FOSSIL_TIMER_WHEEL_MASK (FOSSIL_TIMER_WHEEL_SLOTS - 1)
+#define FOSSIL_TIMER_BATCH 256 // Due tasks handed to the pool at once
+
+static uint64_t timer_now_ns(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)(counter.QuadPart / frequency.QuadPart) * 1000000000u +
+           (uint64_t)(counter.QuadPart % frequency.QuadPart) * 1000000000u / (uint64_t)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+#endif
+}
+
+// The last tick that has started
+static uint64_t timer_wheel_current(const fossil_xtimer_wheel_t *wheel) {
+    return (timer_now_ns() - wheel->origin_ns) / wheel->tick_ns;
+}
+
+static void timer_unlink(fossil_xtimer_t *timer) {
+    *timer->pprev = timer->next;
+    if (timer->next) {
+        timer->next->pprev = timer->pprev;
+    }
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+/**
+ * @brief Links a timer into the slot for its expiry, relative to the next tick to process.
+ *
+ * A timer goes on the lowest level whose span covers its delay. Delays beyond the top level
+ * are parked in its furthest slot and placed again when that slot cascades. The mutex must be held.
+ *
+ * @param wheel Pointer to the timer wheel.
+ * @param timer The timer to link, which must not be pending.
+ */
+static void timer_wheel_insert(fossil_xtimer_wheel_t *wheel, fossil_xtimer_t *timer) {
+    uint64_t expires = timer->expires < wheel->now ? wheel->now : timer->expires;
+    uint64_t delta = expires - wheel->now;
+    int level = 0;
+    while (level < FOSSIL_TIMER_WHEEL_LEVELS - 1 && delta >= (uint64_t)1 << (FOSSIL_TIMER_WHEEL_BITS * (level + 1))) {
+        ++level;
+    }
+    uint64_t span = (uint64_t)1 << (FOSSIL_TIMER_WHEEL_BITS * FOSSIL_TIMER_WHEEL_LEVELS);
+    if (delta >= span) {
+        expires = wheel->now + span - 1;
+    }
+
+    fossil_xtimer_t **slot = &wheel->slots[level][(expires >> (FOSSIL_TIMER_WHEEL_BITS * level)) & FOSSIL_TIMER_WHEEL_MASK];
+    timer->next = *slot;
+    if (timer->next) {
+        timer->next->pprev = &timer->next;
+    }
+    timer->pprev = slot;
+    *slot = timer;
+}
+
+/**
+ * @brief Moves the timers of one slot down the wheel. The mutex must be held.
+ *
+ * @param wheel Pointer to the timer wheel.
+ * @param level The level of the slot, at least 1.
+ * @return bool true if the slot was the first of its level, so the level above cascades too.
+ */
+static bool timer_wheel_cascade(fossil_xtimer_wheel_t *wheel, int level) {
+    size_t index = (size_t)(wheel->now >> (FOSSIL_TIMER_WHEEL_BITS * level)) & FOSSIL_TIMER_WHEEL_MASK;
+    fossil_xtimer_t *timer = wheel->slots[level][index];
+    wheel->slots[level][index] = NULL;
+    while (timer) {
+        fossil_xtimer_t *next = timer->next;
+        timer->pprev = NULL;
+        timer_wheel_insert(wheel, timer);
+        timer = next;
+    }
+    return index == 0;
+}
+
+/**
+ * @brief Gets the tick the timer thread must wake at. The mutex must be held.
+ *
+ * Only level 0 is searched, up to the next cascade, where timers from higher levels may come
+ * down; an idle wheel sleeps until a timer is started.
+ *
+ * @param wheel Pointer to the timer wheel.
+ * @return uint64_t The tick to wake at, or UINT64_MAX to sleep until woken.
+ */
+static uint64_t timer_wheel_next(const fossil_xtimer_wheel_t *wheel) {
+    if (wheel->pending == 0) return UINT64_MAX;
+
+    uint64_t tick = wheel->now;
+    if ((tick & FOSSIL_TIMER_WHEEL_MASK) == 0) return tick;
+    do {
+        if (wheel->slots[0][tick & FOSSIL_TIMER_WHEEL_MASK]) return tick;
+        ++tick;
+    } while (tick & FOSSIL_TIMER_WHEEL_MASK);
+    return tick;
+}
+
+// Sets the tick the timer thread sleeps until and wakes it to sleep again. The mutex must be held.
+static void timer_wheel_arm(fossil_xtimer_wheel_t *wheel, uint64_t tick) {
+    wheel->wake = tick;
+#ifdef __linux__
+    if (wheel->timer_fd >= 0) {
+        struct itimerspec spec;
+        memset(&spec, 0, sizeof(spec));
+        if (tick != UINT64_MAX) {
+            uint64_t deadline = wheel->origin_ns + tick * wheel->tick_ns;
+            spec.it_value.tv_sec = (time_t)(deadline / 1000000000u);
+            spec.it_value.tv_nsec = (long)(deadline % 1000000000u);
+        }
+        timerfd_settime(wheel->timer_fd, TFD_TIMER_ABSTIME, &spec, NULL);
+        return;
+    }
+#endif
+    fossil_cond_signal(&wheel->cond);
+}
+
+// Sleeps until the armed tick or until woken. The mutex must be held and is held again on return.
+static void timer_wheel_sleep(fossil_xtimer_wheel_t *wheel) {
+#ifdef __linux__
+    if (wheel->timer_fd >= 0) {
+        uint64_t expirations;
+        fossil_mutex_unlock(&wheel->mutex);
+        ssize_t result = read(wheel->timer_fd, &expirations, sizeof(expirations));
+        (void)result; // Woken by a signal or re-armed, the wheel is checked either way
+        fossil_mutex_lock(&wheel->mutex);
+        return;
+    }
+#endif
+    if (wheel->wake == UINT64_MAX) {
+        fossil_cond_wait(&wheel->cond, &wheel->mutex);
+        return;
+    }
+    uint64_t deadline = wheel->origin_ns + wheel->wake * wheel->tick_ns;
+    uint64_t now = timer_now_ns();
+    if (now < deadline) {
+        uint64_t milliseconds = (deadline - now + 999999u) / 1000000u;
+        fossil_cond_timedwait(&wheel->cond, &wheel->mutex, milliseconds > UINT32_MAX ? UINT32_MAX : (uint32_t)milliseconds);
+    }
+}
+
+// Runs due tasks on the pool, or on this thread if there is no pool or it is shutting down
+static void timer_wheel_submit(fossil_xtimer_wheel_t *wheel, const fossil_xtask_t *tasks, int32_t count) {
+    int32_t added = 0;
+    if (wheel->pool) {
+        added = fossil_thread_pool_add_tasks(wheel->pool, tasks, count, FOSSIL_THREAD_POOL_WAIT_FOREVER);
+        if (added < 0) added = 0;
+    }
+    for (int32_t i = added; i < count; ++i) {
+        tasks[i].task_func(tasks[i].arg);
+    }
+}
+
+// Pushes a timer on a list the timer thread keeps aside, where it stays pending and can be stopped
+static void timer_list_push(fossil_xtimer_t **list, fossil_xtimer_t *timer) {
+    timer->next = *list;
+    if (timer->next) {
+        timer->next->pprev = &timer->next;
+    }
+    timer->pprev = list;
+    *list = timer;
+}
+
+/**
+ * @brief Fires every timer due up to a tick, re-arming periodic timers.
+ *
+ * The mutex must be held; it is released while a full batch of tasks is submitted. Each slot is
+ * taken off the wheel before its timers fire, and periodic timers go back only once it is empty,
+ * so a timer re-armed or started into the slot being drained waits for the next turn of the wheel.
+ *
+ * @param wheel Pointer to the timer wheel.
+ * @param target The last tick to process.
+ * @param batch Room for FOSSIL_TIMER_BATCH tasks.
+ * @return int32_t The number of tasks left in the batch.
+ */
+static int32_t timer_wheel_advance(fossil_xtimer_wheel_t *wheel, uint64_t target, fossil_xtask_t *batch) {
+    int32_t count = 0;
+    while (wheel->now <= target && !wheel->shutdown) {
+        size_t index = (size_t)(wheel->now & FOSSIL_TIMER_WHEEL_MASK);
+        if (index == 0) {
+            for (int level = 1; level < FOSSIL_TIMER_WHEEL_LEVELS && timer_wheel_cascade(wheel, level); ++level) {
+            }
+        }
+        uint64_t tick = wheel->now++;
+
+        // Both lists live on this stack and are emptied before the next tick; stopping a timer unlinks it from either
+        fossil_xtimer_t *due = wheel->slots[0][index];
+        fossil_xtimer_t *rearm = NULL;
+        wheel->slots[0][index] = NULL;
+        if (due) {
+            due->pprev = &due;
+        }
+
+        fossil_xtimer_t *timer;
+        while ((timer = due) != NULL && !wheel->shutdown) {
+            timer_unlink(timer);
+            batch[count++] = timer->task;
+            if (timer->period > 0) {
+                timer->expires = tick + timer->period;
+                timer_list_push(&rearm, timer);
+            } else {
+                wheel->pending--;
+            }
+            if (count == FOSSIL_TIMER_BATCH) {
+                fossil_mutex_unlock(&wheel->mutex);
+                timer_wheel_submit(wheel, batch, count);
+                fossil_mutex_lock(&wheel->mutex);
+                count = 0;
+            }
+        }
+
+        // Timers left by a shutdown go back too, so erasing the wheel finds them
+        while ((timer = due) != NULL) {
+            timer_unlink(timer);
+            timer_wheel_insert(wheel, timer);
+        }
+        while ((timer = rearm) != NULL) {
+            timer_unlink(timer);
+            timer_wheel_insert(wheel, timer);
+        }
+    }
+    return count;
+}
+
+static void timer_wheel_thread(fossil_xtask_arg_t arg) {
+    fossil_xtimer_wheel_t *wheel = (fossil_xtimer_wheel_t*)arg;
+    fossil_xtask_t batch[FOSSIL_TIMER_BATCH];
+
+    fossil_mutex_lock(&wheel->mutex);
+    while (!wheel->shutdown) {
+        int32_t count = timer_wheel_advance(wheel, timer_wheel_current(wheel), batch);
+        if (count > 0) {
+            fossil_mutex_unlock(&wheel->mutex);
+            timer_wheel_submit(wheel, batch, count);
+            fossil_mutex_lock(&wheel->mutex);
+            continue; // More timers may be due by now
+        }
+        if (wheel->shutdown) break;
+        timer_wheel_arm(wheel, timer_wheel_next(wheel));
+        timer_wheel_sleep(wheel);
+    }
+    fossil_mutex_unlock(&wheel->mutex);
+}
+
+static void timer_wheel_close(fossil_xtimer_wheel_t *wheel) {
+#ifdef __linux__
+    if (wheel->timer_fd >= 0) {
+        close(wheel->timer_fd);
+        wheel->timer_fd = -1;
+    }
+#else
+    (void)wheel;
+#endif
+}
+
+int32_t fossil_timer_wheel_create(fossil_xtimer_wheel_t *wheel, fossil_xthread_pool_t *pool, uint32_t tick_us) {
+    if (!wheel) return FOSSIL_ERROR;
+
+    memset(wheel->slots, 0, sizeof(wheel->slots));
+    wheel->now = 0;
+    wheel->wake = UINT64_MAX;
+    wheel->tick_ns = (uint64_t)(tick_us ? tick_us : FOSSIL_TIMER_DEFAULT_TICK_US) * 1000u;
+    wheel->origin_ns = timer_now_ns();
+    wheel->pending = 0;
+    wheel->pool = pool;
+    wheel->shutdown = 0;
+    wheel->timer_fd = -1;
+#ifdef __linux__
+    // Without a timerfd the timer thread sleeps on the condition variable in whole milliseconds
+    wheel->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+#endif
+
+    if (fossil_mutex_create(&wheel->mutex) != 0) {
+        timer_wheel_close(wheel);
+        return FOSSIL_ERROR;
+    }
+    if (fossil_cond_create(&wheel->cond) != 0) {
+        fossil_mutex_erase(&wheel->mutex);
+        timer_wheel_close(wheel);
+        return FOSSIL_ERROR;
+    }
+
+    fossil_xthread_attr_t attr;
+    int32_t result = fossil_thread_attr_create(&attr);
+    if (result == FOSSIL_SUCCESS) {
+        fossil_thread_attr_set_name(&attr, "fossil-timer");
+        fossil_xtask_t task = { .task_func = (fossil_xtask_func_t)timer_wheel_thread, .arg = wheel };
+        result = fossil_thread_create(&wheel->thread, &attr, task);
+        fossil_thread_attr_erase(&attr);
+    }
+    if (result != FOSSIL_SUCCESS) {
+        fossil_cond_erase(&wheel->cond);
+        fossil_mutex_erase(&wheel->mutex);
+        timer_wheel_close(wheel);
+        return FOSSIL_ERROR;
+    }
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_timer_wheel_erase(fossil_xtimer_wheel_t *wheel) {
+    if (!wheel) return FOSSIL_ERROR;
+
+    fossil_mutex_lock(&wheel->mutex);
+    wheel->shutdown = 1;
+    timer_wheel_arm(wheel, 0);
+    fossil_mutex_unlock(&wheel->mutex);
+    fossil_thread_join(wheel->thread, NULL);
+
+    // Leave the dropped timers ready to be started on another wheel
+    for (int level = 0; level < FOSSIL_TIMER_WHEEL_LEVELS; ++level) {
+        for (size_t index = 0; index < FOSSIL_TIMER_WHEEL_SLOTS; ++index) {
+            fossil_xtimer_t *timer = wheel->slots[level][index];
+            while (timer) {
+                fossil_xtimer_t *next = timer->next;
+                timer->next = NULL;
+                timer->pprev = NULL;
+                timer = next;
+            }
+            wheel->slots[level][index] = NULL;
+        }
+    }
+    wheel->pending = 0;
+
+    timer_wheel_close(wheel);
+    fossil_cond_erase(&wheel->cond);
+    fossil_mutex_erase(&wheel->mutex);
+    return FOSSIL_SUCCESS;
+}
+
+size_t fossil_timer_wheel_pending(fossil_xtimer_wheel_t *wheel) {
+    if (!wheel) return 0;
+
+    fossil_mutex_lock(&wheel->mutex);
+    size_t pending = wheel->pending;
+    fossil_mutex_unlock(&wheel->mutex);
+    return pending;
+}
+
+int32_t fossil_timer_init(fossil_xtimer_t *timer, fossil_xtask_func_t task_func, void *arg) {
+    if (!timer || !task_func) return FOSSIL_ERROR;
+
+    timer->next = NULL;
+    timer->pprev = NULL;
+    timer->expires = 0;
+    timer->period = 0;
+    timer->task.task_func = task_func;
+    timer->task.arg = (fossil_xtask_arg_t)arg;
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_timer_start(fossil_xtimer_wheel_t *wheel, fossil_xtimer_t *timer, uint32_t delay_ms, uint32_t period_ms) {
+    if (!wheel || !timer || !timer->task.task_func) return FOSSIL_ERROR;
+
+    fossil_mutex_lock(&wheel->mutex);
+    if (wheel->shutdown) {
+        fossil_mutex_unlock(&wheel->mutex);
+        return FOSSIL_ERROR;
+    }
+
+    // First tick that starts at or after the delay
+    uint64_t elapsed = timer_now_ns() - wheel->origin_ns;
+    uint64_t expires = (elapsed + (uint64_t)delay_ms * 1000000u + wheel->tick_ns - 1) / wheel->tick_ns;
+    uint64_t period = ((uint64_t)period_ms * 1000000u + wheel->tick_ns - 1) / wheel->tick_ns;
+
+    if (timer->pprev) {
+        timer_unlink(timer);
+    } else {
+        if (wheel->pending == 0 && wheel->now < elapsed / wheel->tick_ns) {
+            // Nothing is waiting on the ticks an idle wheel slept through, so skip them
+            wheel->now = elapsed / wheel->tick_ns;
+        }
+        wheel->pending++;
+    }
+    timer->expires = expires;
+    timer->period = period;
+    timer_wheel_insert(wheel, timer);
+
+    uint64_t due = expires < wheel->now ? wheel->now : expires;
+    if (due < wheel->wake) {
+        timer_wheel_arm(wheel, due);
+    }
+    fossil_mutex_unlock(&wheel->mutex);
+    return FOSSIL_SUCCESS;
+}
+
+int32_t fossil_timer_cancel(fossil_xtimer_wheel_t *wheel, fossil_xtimer_t *timer) {
+    if (!wheel || !timer) return FOSSIL_ERROR;
+
+    fossil_mutex_lock(&wheel->mutex);
+    int32_t result = FOSSIL_ERROR;
+    if (timer->pprev) {
+        timer_unlink(timer);
+        wheel->pending--;
+        result = FOSSIL_SUCCESS;
+    }
+    fossil_mutex_unlock(&wheel->mutex);
+    return result;
+}
+
+bool fossil_timer_pending(fossil_xtimer_wheel_t *wheel, fossil_xtimer_t *timer) {
+    if (!wheel || !timer) return false;
+
+    fossil_mutex_lock(&wheel->mutex);
+    bool pending = timer->pprev != NULL;
+    fossil_mutex_unlock(&wheel->mutex);
+    return pending;
+}
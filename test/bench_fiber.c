@@ -0,0 +1,300 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef _WIN32
+#define _GNU_SOURCE // for clock_gettime
+#endif
+#include <fossil/common/common.h>
+#include <fossil/threads/fiber.h>
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+/**
+ * Fiber benchmark, run by `meson test --benchmark` when with_bench is enabled.
+ *
+ * Three loops on a scheduler with a single worker, so every operation is a real switch:
+ * two fibers yielding to each other, two fibers passing a token through a pair of channels
+ * of capacity one, which parks and wakes a fiber per message, and spawning and joining
+ * short fibers. Each result is the best of several runs in ns per operation.
+ *
+ * A last stress loop runs on a scheduler with several workers: parent fibers each spawn more
+ * children than the stack cache holds and then join them, so finished fibers are unmapped
+ * while joiners on other workers wake up. It reports ns per child and fails the run if a
+ * child is lost.
+ *
+ * Options:
+ *   --json <path>         Write the results as JSON (default bench_fiber.json)
+ *   --ops <n>             Operations per loop (default 1048576)
+ */
+
+#define BENCH_REPEAT 3 // Runs per loop, the fastest is reported
+#define BENCH_LOOPS 3
+#define BENCH_STRESS_WORKERS 4
+#define BENCH_STRESS_PARENTS 4
+#define BENCH_STRESS_CHILDREN 600 // Per parent and cycle, more than FOSSIL_FIBER_STACK_CACHE
+#define BENCH_STRESS_CYCLES 8
+
+static const char* bench_loop_names[BENCH_LOOPS] = {"yield", "channel", "spawn_join"};
+
+static double bench_now_ns(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart * 1e9 / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1e9 + (double)now.tv_nsec;
+#endif
+}
+
+// *****************************************************************************
+// Loops
+// *****************************************************************************
+
+static fossil_xfiber_scheduler_t* bench_scheduler;
+static long bench_ops;
+static fossil_xfiber_channel_t bench_ping;
+static fossil_xfiber_channel_t bench_pong;
+static atomic_long bench_sink;
+static atomic_bool bench_failed;
+
+static void bench_yielder(void* arg) {
+    (void)arg;
+    for (long i = 0; i < bench_ops / 2; i++) {
+        fossil_fiber_yield();
+    }
+}
+
+static void bench_pinger(void* arg) {
+    (void)arg;
+    void* token = cnullptr;
+    for (long i = 0; i < bench_ops / 2; i++) {
+        fossil_fiber_channel_send(&bench_ping, token);
+        fossil_fiber_channel_recv(&bench_pong, &token);
+    }
+}
+
+static void bench_ponger(void* arg) {
+    (void)arg;
+    void* token = cnullptr;
+    for (long i = 0; i < bench_ops / 2; i++) {
+        fossil_fiber_channel_recv(&bench_ping, &token);
+        fossil_fiber_channel_send(&bench_pong, token);
+    }
+}
+
+static void bench_short(void* arg) {
+    atomic_fetch_add_explicit(&bench_sink, (long)(intptr_t)arg, memory_order_relaxed);
+}
+
+static void bench_spawner(void* arg) {
+    (void)arg;
+    for (long i = 0; i < bench_ops; i++) {
+        fossil_fiber_join(fossil_fiber_spawn(bench_scheduler, bench_short, (void*)(intptr_t)1));
+    }
+}
+
+static fossil_xtask_func_t bench_loops[BENCH_LOOPS][2] = {
+    {bench_yielder, bench_yielder},
+    {bench_pinger, bench_ponger},
+    {bench_spawner, cnullptr}
+};
+
+// Spawns the fibers of a loop from the only worker, so none of them starts before the others exist
+static void bench_driver(void* arg) {
+    fossil_xtask_func_t* funcs = (fossil_xtask_func_t*)arg;
+    fossil_xfiber_t* fibers[2] = {cnullptr, cnullptr};
+    for (int i = 0; i < 2 && funcs[i] != cnullptr; i++) {
+        fibers[i] = fossil_fiber_spawn(bench_scheduler, funcs[i], cnullptr);
+    }
+    for (int i = 0; i < 2; i++) {
+        if (fibers[i] != cnullptr) {
+            fossil_fiber_join(fibers[i]);
+        } else if (funcs[i] != cnullptr) {
+            atomic_store(&bench_failed, true);
+        }
+    }
+}
+
+// A stress child yields once, so its parent usually has to park in join and be woken by its end
+static void bench_wide_child(void* arg) {
+    fossil_fiber_yield();
+    bench_short(arg);
+}
+
+// Spawns a wide batch of children, then joins them all, cycle after cycle
+static void bench_wide_parent(void* arg) {
+    fossil_xfiber_scheduler_t* scheduler = (fossil_xfiber_scheduler_t*)arg;
+    fossil_xfiber_t** children = (fossil_xfiber_t**)malloc(sizeof(fossil_xfiber_t*) * BENCH_STRESS_CHILDREN);
+    if (children == cnullptr) {
+        atomic_store(&bench_failed, true);
+        return;
+    }
+    for (int cycle = 0; cycle < BENCH_STRESS_CYCLES; cycle++) {
+        for (int i = 0; i < BENCH_STRESS_CHILDREN; i++) {
+            children[i] = fossil_fiber_spawn(scheduler, bench_wide_child, (void*)(intptr_t)1);
+        }
+        // Newest first, so the joins mostly find children that have not finished
+        for (int i = BENCH_STRESS_CHILDREN - 1; i >= 0; i--) {
+            if (children[i] == cnullptr) {
+                atomic_store(&bench_failed, true);
+            } else {
+                fossil_fiber_join(children[i]);
+            }
+        }
+    }
+    free(children);
+}
+
+/**
+ * Run the spawn/join stress loop on its own multi-worker scheduler.
+ *
+ * @return The elapsed time in nanoseconds, or a negative value if a fiber was lost.
+ */
+static double bench_stress(void) {
+    fossil_xfiber_scheduler_t* scheduler = fossil_fiber_scheduler_create(BENCH_STRESS_WORKERS, 0);
+    if (scheduler == cnullptr) {
+        return -1.0;
+    }
+    atomic_store(&bench_failed, false);
+    atomic_store(&bench_sink, 0);
+
+    double start = bench_now_ns();
+    fossil_xfiber_t* parents[BENCH_STRESS_PARENTS];
+    for (int i = 0; i < BENCH_STRESS_PARENTS; i++) {
+        parents[i] = fossil_fiber_spawn(scheduler, bench_wide_parent, scheduler);
+    }
+    for (int i = 0; i < BENCH_STRESS_PARENTS; i++) {
+        if (parents[i] == cnullptr) {
+            atomic_store(&bench_failed, true);
+        } else {
+            fossil_fiber_join(parents[i]);
+        }
+    }
+    double elapsed = bench_now_ns() - start;
+    fossil_fiber_scheduler_erase(scheduler);
+
+    long expected = (long)BENCH_STRESS_PARENTS * BENCH_STRESS_CYCLES * BENCH_STRESS_CHILDREN;
+    return atomic_load(&bench_failed) || atomic_load(&bench_sink) != expected ? -1.0 : elapsed;
+}
+
+/**
+ * Run one loop.
+ *
+ * @param loop The index of the loop.
+ * @return     The elapsed time in nanoseconds, or a negative value if the run failed.
+ */
+static double bench_run(int loop) {
+    atomic_store(&bench_failed, false);
+    double start = bench_now_ns();
+    fossil_xfiber_t* driver = fossil_fiber_spawn(bench_scheduler, bench_driver, bench_loops[loop]);
+    if (driver == cnullptr) {
+        return -1.0;
+    }
+    fossil_fiber_join(driver);
+    double elapsed = bench_now_ns() - start;
+    return atomic_load(&bench_failed) ? -1.0 : elapsed;
+}
+
+// *****************************************************************************
+// Driver
+// *****************************************************************************
+
+int main(int argc, char** argv) {
+    const char* json_path = "bench_fiber.json";
+    long ops = 1L << 20;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--ops") == 0 && i + 1 < argc) {
+            ops = strtol(argv[++i], cnullptr, 10);
+        } else {
+            fprintf(stderr, "usage: %s [--json path] [--ops n]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (ops < 2) {
+        fprintf(stderr, "ops must be at least 2\n");
+        return 1;
+    }
+    bench_ops = ops;
+
+    bench_scheduler = fossil_fiber_scheduler_create(1, 0);
+    if (bench_scheduler == cnullptr || fossil_fiber_channel_create(&bench_ping, 1) != 0 ||
+        fossil_fiber_channel_create(&bench_pong, 1) != 0) {
+        fprintf(stderr, "cannot create the scheduler and channels\n");
+        return 1;
+    }
+
+    FILE* json = fopen(json_path, "w");
+    if (json == cnullptr) {
+        fprintf(stderr, "cannot open %s\n", json_path);
+        return 1;
+    }
+    fprintf(json, "{\n  \"benchmark\": \"fiber\",\n  \"ops\": %ld,\n  \"results\": [", ops);
+
+    int status = 0;
+    bool first = true;
+    for (int loop = 0; loop < BENCH_LOOPS; loop++) {
+        double best = 0.0;
+        for (int run = 0; run < BENCH_REPEAT; run++) {
+            double elapsed = bench_run(loop);
+            if (elapsed < 0) {
+                best = 0.0;
+                break;
+            }
+            if (best == 0.0 || elapsed < best) {
+                best = elapsed;
+            }
+        }
+        if (best == 0.0) {
+            fprintf(stderr, "%s: cannot spawn fibers\n", bench_loop_names[loop]);
+            status = 1;
+            continue;
+        }
+
+        double ns_per_op = best / (double)ops;
+        printf("%-12s %10.1f ns/op\n", bench_loop_names[loop], ns_per_op);
+        fprintf(json, "%s\n    {\"loop\": \"%s\", \"ns_per_op\": %.3f}", first ? "" : ",", bench_loop_names[loop], ns_per_op);
+        first = false;
+    }
+
+    double stress = bench_stress();
+    if (stress < 0) {
+        fprintf(stderr, "spawn_join_stress: fibers were lost\n");
+        status = 1;
+    } else {
+        double ns_per_op = stress / ((double)BENCH_STRESS_PARENTS * BENCH_STRESS_CYCLES * BENCH_STRESS_CHILDREN);
+        printf("%-12s %10.1f ns/op\n", "spawn_join_stress", ns_per_op);
+        fprintf(json, "%s\n    {\"loop\": \"spawn_join_stress\", \"ns_per_op\": %.3f}", first ? "" : ",", ns_per_op);
+    }
+
+    fprintf(json, "\n  ]\n}\n");
+    fclose(json);
+    fossil_fiber_channel_erase(&bench_ping);
+    fossil_fiber_channel_erase(&bench_pong);
+    fossil_fiber_scheduler_erase(bench_scheduler);
+    return status;
+}
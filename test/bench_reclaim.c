@@ -0,0 +1,357 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef _WIN32
+#define _GNU_SOURCE // for clock_gettime and sched_yield
+#endif
+#include <fossil/common/common.h>
+#include <fossil/threads/epoch.h>
+#include <fossil/threads/hazard.h>
+#include <fossil/threads/mutexs.h>
+#include <fossil/threads/threadpool.h>
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sched.h>
+#include <time.h>
+#endif
+
+/**
+ * Memory reclamation benchmark and stress test, run by `meson test --benchmark` when with_bench
+ * is enabled.
+ *
+ * Every thread pushes a node onto a shared Treiber stack and pops one off, over and over. The
+ * lock-free stack is run with epoch-based reclamation and with hazard pointers, and a stack
+ * under a mutex is the baseline, at 1 to 64 threads. Reclaimed nodes are poisoned and kept
+ * until the end of the run instead of being handed back to the allocator, so a pop that reads
+ * a node after it was reclaimed is caught rather than silently reading reused memory; any such
+ * read fails the run. Each result reports the best of several runs as ns per operation and
+ * operations per second.
+ *
+ * Options:
+ *   --json <path>         Write the results as JSON (default bench_reclaim.json)
+ *   --ops <n>             Operations per run, split across the threads (default 1048576)
+ *   --max-threads <n>     Skip thread counts above n (default 64)
+ *   --stress              Yield inside every 64th pop, between loading the top node and reading
+ *                         it, to force the interleavings that expose early reclamation; the
+ *                         timings are then meaningless
+ */
+
+#define BENCH_REPEAT 3         // Runs per configuration, the fastest is reported
+#define BENCH_MAX_THREADS 64
+#define BENCH_LIVE 0x11FE11FEu // Magic of a node that is in the stack or being popped
+#define BENCH_DEAD 0xDEADDEADu // Magic of a reclaimed node
+
+typedef enum {
+    BENCH_MUTEX,
+    BENCH_EPOCH,
+    BENCH_HAZARD,
+    BENCH_SCHEMES
+} bench_scheme_t;
+
+static const char* bench_scheme_names[BENCH_SCHEMES] = {"mutex", "epoch", "hazard"};
+
+typedef struct bench_node_t {
+    struct bench_node_t* next;
+    atomic_uint magic;
+    struct bench_node_t* grave;        // Link in the list of reclaimed nodes
+} bench_node_t;
+
+static double bench_now_ns(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart * 1e9 / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1e9 + (double)now.tv_nsec;
+#endif
+}
+
+static void bench_yield(void) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+// *****************************************************************************
+// Stack
+// *****************************************************************************
+
+static bench_scheme_t bench_scheme;
+static fossil_xmutex_t bench_mutex;
+static fossil_xepoch_domain_t bench_epoch;
+static fossil_xhazard_domain_t bench_hazard;
+
+static _Atomic(void*) bench_head;
+static _Atomic(bench_node_t*) bench_graveyard;
+static long bench_ops_per_thread;
+static bool bench_stress;
+static int32_t bench_threads;
+static atomic_int bench_arrived;         // Threads at the start line
+static atomic_int bench_finished;
+static atomic_long bench_violations;     // Reclaimed nodes read by a pop
+
+// The free function of both schemes: poison the node and keep it until the run is over
+static void bench_reclaim(void* ptr) {
+    bench_node_t* node = (bench_node_t*)ptr;
+    atomic_store_explicit(&node->magic, BENCH_DEAD, memory_order_relaxed);
+    bench_node_t* grave = atomic_load_explicit(&bench_graveyard, memory_order_relaxed);
+    do {
+        node->grave = grave;
+    } while (!atomic_compare_exchange_weak(&bench_graveyard, &grave, node));
+}
+
+static void bench_push(void) {
+    bench_node_t* node = (bench_node_t*)malloc(sizeof(bench_node_t));
+    if (node == cnullptr) {
+        return;
+    }
+    atomic_init(&node->magic, BENCH_LIVE);
+    node->grave = cnullptr;
+    if (bench_scheme == BENCH_MUTEX) {
+        fossil_mutex_lock(&bench_mutex);
+        node->next = (bench_node_t*)atomic_load_explicit(&bench_head, memory_order_relaxed);
+        atomic_store_explicit(&bench_head, node, memory_order_relaxed);
+        fossil_mutex_unlock(&bench_mutex);
+        return;
+    }
+    void* head = atomic_load(&bench_head);
+    do {
+        node->next = (bench_node_t*)head;
+    } while (!atomic_compare_exchange_weak(&bench_head, &head, node));
+}
+
+static long bench_pop(bool pause) {
+    bench_node_t* top;
+    long violations = 0;
+    switch (bench_scheme) {
+        case BENCH_MUTEX:
+            fossil_mutex_lock(&bench_mutex);
+            top = (bench_node_t*)atomic_load_explicit(&bench_head, memory_order_relaxed);
+            if (top != cnullptr) {
+                atomic_store_explicit(&bench_head, top->next, memory_order_relaxed);
+            }
+            fossil_mutex_unlock(&bench_mutex);
+            if (top != cnullptr) {
+                bench_reclaim(top);
+            }
+            return 0;
+        case BENCH_EPOCH: {
+            fossil_epoch_enter(&bench_epoch);
+            void* expected = atomic_load(&bench_head);
+            for (top = (bench_node_t*)expected; top != cnullptr; top = (bench_node_t*)expected) {
+                if (pause) {
+                    bench_yield();
+                }
+                violations += atomic_load_explicit(&top->magic, memory_order_relaxed) != BENCH_LIVE;
+                if (atomic_compare_exchange_weak(&bench_head, &expected, top->next)) {
+                    break;
+                }
+            }
+            fossil_epoch_exit(&bench_epoch);
+            if (top != cnullptr) {
+                fossil_epoch_retire(&bench_epoch, top, bench_reclaim);
+            }
+            return violations;
+        }
+        default:
+            for (;;) {
+                top = (bench_node_t*)fossil_hazard_protect(&bench_hazard, 0, &bench_head);
+                if (top == cnullptr) {
+                    break;
+                }
+                if (pause) {
+                    bench_yield();
+                }
+                violations += atomic_load_explicit(&top->magic, memory_order_relaxed) != BENCH_LIVE;
+                void* expected = top;
+                if (atomic_compare_exchange_strong(&bench_head, &expected, top->next)) {
+                    break;
+                }
+            }
+            fossil_hazard_clear(&bench_hazard, 0);
+            if (top != cnullptr) {
+                fossil_hazard_retire(&bench_hazard, top, bench_reclaim);
+            }
+            return violations;
+    }
+}
+
+// A pool task; the start line makes sure every thread runs on its own worker
+static void bench_worker(void* arg) {
+    (void)arg;
+    long violations = 0;
+
+    atomic_fetch_add(&bench_arrived, 1);
+    while (atomic_load(&bench_arrived) < bench_threads) {
+        bench_yield();
+    }
+    for (long i = 0; i < bench_ops_per_thread / 2; i++) {
+        bench_push();
+        violations += bench_pop(bench_stress && (i & 63) == 0);
+    }
+    atomic_fetch_add(&bench_violations, violations);
+    atomic_fetch_add(&bench_finished, 1);
+}
+
+// Frees the nodes left in the stack and the nodes reclaimed so far; with every thread idle, no one can read them.
+// Nodes still retired in the domains are reclaimed in a later run or when the domains are erased.
+static void bench_drain(void) {
+    bench_node_t* node = (bench_node_t*)atomic_exchange(&bench_head, cnullptr);
+    while (node != cnullptr) {
+        bench_node_t* next = node->next;
+        free(node);
+        node = next;
+    }
+    node = atomic_exchange(&bench_graveyard, cnullptr);
+    while (node != cnullptr) {
+        bench_node_t* next = node->grave;
+        free(node);
+        node = next;
+    }
+}
+
+/**
+ * Run all threads against one scheme.
+ *
+ * @param pool    The pool whose workers run the threads.
+ * @param threads The number of threads.
+ * @param ops     Operations per thread.
+ * @return        The elapsed time in nanoseconds, or a negative value if the run failed.
+ */
+static double bench_run(fossil_xthread_pool_t* pool, int32_t threads, long ops) {
+    bench_threads = threads;
+    bench_ops_per_thread = ops;
+    atomic_store(&bench_arrived, 0);
+    atomic_store(&bench_finished, 0);
+    atomic_store(&bench_violations, 0);
+
+    double start = bench_now_ns();
+    for (int32_t i = 0; i < threads; i++) {
+        if (fossil_thread_pool_add_task(pool, bench_worker, cnullptr) != 0) {
+            return -1.0;
+        }
+    }
+    while (atomic_load(&bench_finished) < threads) {
+        bench_yield();
+    }
+    double elapsed = bench_now_ns() - start;
+    bench_drain();
+
+    if (atomic_load(&bench_violations) != 0) {
+        fprintf(stderr, "%s: %ld reads of reclaimed nodes\n", bench_scheme_names[bench_scheme],
+                (long)atomic_load(&bench_violations));
+        return -1.0;
+    }
+    return elapsed;
+}
+
+// *****************************************************************************
+// Driver
+// *****************************************************************************
+
+int main(int argc, char** argv) {
+    const char* json_path = "bench_reclaim.json";
+    long ops = 1L << 20;
+    long max_threads = BENCH_MAX_THREADS;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--ops") == 0 && i + 1 < argc) {
+            ops = strtol(argv[++i], cnullptr, 10);
+        } else if (strcmp(argv[i], "--max-threads") == 0 && i + 1 < argc) {
+            max_threads = strtol(argv[++i], cnullptr, 10);
+        } else if (strcmp(argv[i], "--stress") == 0) {
+            bench_stress = true;
+        } else {
+            fprintf(stderr, "usage: %s [--json path] [--ops n] [--max-threads n] [--stress]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (ops <= 0 || max_threads > BENCH_MAX_THREADS) {
+        fprintf(stderr, "ops must be positive and max-threads at most %d\n", BENCH_MAX_THREADS);
+        return 1;
+    }
+
+    if (fossil_mutex_create(&bench_mutex) != 0 || fossil_epoch_domain_create(&bench_epoch, 0) != 0 ||
+        fossil_hazard_domain_create(&bench_hazard, 0) != 0) {
+        fprintf(stderr, "cannot create the mutex and domains\n");
+        return 1;
+    }
+
+    FILE* json = fopen(json_path, "w");
+    if (json == cnullptr) {
+        fprintf(stderr, "cannot open %s\n", json_path);
+        return 1;
+    }
+    fprintf(json, "{\n  \"benchmark\": \"reclaim\",\n  \"ops\": %ld,\n  \"results\": [", ops);
+
+    int status = 0;
+    bool first = true;
+    for (int32_t threads = 1; threads <= max_threads; threads *= 2) {
+        fossil_xthread_pool_t pool;
+        if (fossil_thread_pool_create(&pool, threads, BENCH_MAX_THREADS * 2) != 0) {
+            fprintf(stderr, "pool failed at %d threads\n", threads);
+            break;
+        }
+        long per_thread = ops / threads > 1 ? ops / threads : 2;
+
+        for (int scheme = 0; scheme < BENCH_SCHEMES; scheme++) {
+            bench_scheme = (bench_scheme_t)scheme;
+            double best = 0.0;
+            for (int run = 0; run < BENCH_REPEAT; run++) {
+                double elapsed = bench_run(&pool, threads, per_thread);
+                if (elapsed < 0) {
+                    best = 0.0;
+                    status = 1;
+                    break;
+                }
+                if (best == 0.0 || elapsed < best) {
+                    best = elapsed;
+                }
+            }
+            if (best == 0.0) {
+                continue;
+            }
+
+            long total = per_thread / 2 * 2 * threads;
+            double ns_per_op = best / (double)total;
+            double ops_per_sec = (double)total * 1e9 / best;
+            printf("%-8s %3d threads %10.1f ns/op %14.0f ops/s\n", bench_scheme_names[scheme], threads, ns_per_op, ops_per_sec);
+            fprintf(json, "%s\n    {\"scheme\": \"%s\", \"threads\": %d, \"ops\": %ld, \"ns_per_op\": %.3f, \"ops_per_sec\": %.1f}",
+                    first ? "" : ",", bench_scheme_names[scheme], threads, total, ns_per_op, ops_per_sec);
+            first = false;
+        }
+        fossil_thread_pool_erase(&pool);
+    }
+
+    fprintf(json, "\n  ]\n}\n");
+    fclose(json);
+    fossil_mutex_erase(&bench_mutex);
+    fossil_epoch_domain_erase(&bench_epoch);
+    fossil_hazard_domain_erase(&bench_hazard);
+    bench_drain();
+    return status;
+}
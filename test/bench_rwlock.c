@@ -0,0 +1,346 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef _WIN32
+#define _GNU_SOURCE // for clock_gettime, sched_yield and pthread_rwlock_t
+#endif
+#include <fossil/common/common.h>
+#include <fossil/threads/mutexs.h>
+#include <fossil/threads/rwlock.h>
+#include <fossil/threads/seqlock.h>
+#include <fossil/threads/threadpool.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#endif
+
+/**
+ * Read-mostly lock benchmark, run by `meson test --benchmark` when with_bench is enabled.
+ *
+ * Every thread reads a small config record under a lock and, once every so many reads,
+ * rewrites it. The same loop runs over the mutex, the POSIX reader-writer lock where it
+ * exists, fossil_xrwlock_t and fossil_xseqlock_t at 1 to 64 threads, so the results show
+ * how each one scales with readers. Each result reports the best of several runs as ns per
+ * operation and operations per second, and readers check that they never see a torn record.
+ *
+ * Options:
+ *   --json <path>         Write the results as JSON (default bench_rwlock.json)
+ *   --ops <n>             Operations per run, split across the threads (default 1048576)
+ *   --write-every <n>     One write per n operations (default 1000)
+ *   --max-threads <n>     Skip thread counts above n (default 64)
+ */
+
+#define BENCH_REPEAT 3         // Runs per configuration, the fastest is reported
+#define BENCH_MAX_THREADS 64
+#define BENCH_FIELDS 8         // Words in the config record
+
+typedef enum {
+    BENCH_MUTEX,
+#ifndef _WIN32
+    BENCH_PTHREAD_RWLOCK,
+#endif
+    BENCH_RWLOCK,
+    BENCH_SEQLOCK,
+    BENCH_LOCKS
+} bench_lock_t;
+
+static const char* bench_lock_names[BENCH_LOCKS] = {
+    "mutex",
+#ifndef _WIN32
+    "pthread_rwlock",
+#endif
+    "rwlock",
+    "seqlock"
+};
+
+// Every field holds the version plus its index, so a torn read is easy to spot
+typedef struct {
+    uint64_t fields[BENCH_FIELDS];
+} bench_record_t;
+
+static double bench_now_ns(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart * 1e9 / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1e9 + (double)now.tv_nsec;
+#endif
+}
+
+static void bench_yield(void) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+// *****************************************************************************
+// Read-mostly loop
+// *****************************************************************************
+
+static bench_lock_t bench_kind;
+static fossil_xmutex_t bench_mutex;
+#ifndef _WIN32
+static pthread_rwlock_t bench_pthread_rwlock;
+#endif
+static fossil_xrwlock_t bench_rwlock;
+static fossil_xseqlock_t bench_seqlock;
+
+static bench_record_t bench_record;
+static long bench_ops_per_thread;
+static long bench_write_every;
+static int32_t bench_threads;
+static atomic_int bench_arrived;         // Threads at the start line
+static atomic_int bench_finished;
+static atomic_long bench_torn;           // Inconsistent records seen by readers
+static atomic_ullong bench_sink;         // Keeps the reads alive
+
+static void bench_fill(bench_record_t* record, uint64_t version) {
+    for (int i = 0; i < BENCH_FIELDS; i++) {
+        record->fields[i] = version + (uint64_t)i;
+    }
+}
+
+static bool bench_consistent(const bench_record_t* record) {
+    for (int i = 1; i < BENCH_FIELDS; i++) {
+        if (record->fields[i] != record->fields[0] + (uint64_t)i) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void bench_read(bench_record_t* copy) {
+    switch (bench_kind) {
+        case BENCH_MUTEX:
+            fossil_mutex_lock(&bench_mutex);
+            *copy = bench_record;
+            fossil_mutex_unlock(&bench_mutex);
+            break;
+#ifndef _WIN32
+        case BENCH_PTHREAD_RWLOCK:
+            pthread_rwlock_rdlock(&bench_pthread_rwlock);
+            *copy = bench_record;
+            pthread_rwlock_unlock(&bench_pthread_rwlock);
+            break;
+#endif
+        case BENCH_RWLOCK:
+            fossil_rwlock_rdlock(&bench_rwlock);
+            *copy = bench_record;
+            fossil_rwlock_rdunlock(&bench_rwlock);
+            break;
+        default:
+            fossil_seqlock_read(&bench_seqlock, copy, &bench_record, sizeof(*copy));
+            break;
+    }
+}
+
+static void bench_write(uint64_t version) {
+    bench_record_t next;
+    bench_fill(&next, version);
+    switch (bench_kind) {
+        case BENCH_MUTEX:
+            fossil_mutex_lock(&bench_mutex);
+            bench_record = next;
+            fossil_mutex_unlock(&bench_mutex);
+            break;
+#ifndef _WIN32
+        case BENCH_PTHREAD_RWLOCK:
+            pthread_rwlock_wrlock(&bench_pthread_rwlock);
+            bench_record = next;
+            pthread_rwlock_unlock(&bench_pthread_rwlock);
+            break;
+#endif
+        case BENCH_RWLOCK:
+            fossil_rwlock_wrlock(&bench_rwlock);
+            bench_record = next;
+            fossil_rwlock_wrunlock(&bench_rwlock);
+            break;
+        default:
+            fossil_seqlock_write(&bench_seqlock, &bench_record, &next, sizeof(next));
+            break;
+    }
+}
+
+// A pool task; the start line makes sure every thread runs on its own worker
+static void bench_worker(void* arg) {
+    uint64_t version = (uint64_t)(uintptr_t)arg << 32;
+    uint64_t sum = 0;
+    long torn = 0;
+
+    atomic_fetch_add(&bench_arrived, 1);
+    while (atomic_load(&bench_arrived) < bench_threads) {
+        bench_yield();
+    }
+    for (long i = 0; i < bench_ops_per_thread; i++) {
+        if (bench_write_every > 0 && i % bench_write_every == bench_write_every - 1) {
+            bench_write(++version);
+        } else {
+            bench_record_t copy;
+            bench_read(&copy);
+            torn += !bench_consistent(&copy);
+            sum += copy.fields[BENCH_FIELDS - 1];
+        }
+    }
+    atomic_fetch_add(&bench_torn, torn);
+    atomic_fetch_add_explicit(&bench_sink, sum, memory_order_relaxed);
+    atomic_fetch_add(&bench_finished, 1);
+}
+
+/**
+ * Run all threads against one lock.
+ *
+ * @param pool    The pool whose workers run the threads.
+ * @param threads The number of threads.
+ * @param ops     Operations per thread.
+ * @return        The elapsed time in nanoseconds, or a negative value if the run failed.
+ */
+static double bench_run(fossil_xthread_pool_t* pool, int32_t threads, long ops) {
+    bench_fill(&bench_record, 0);
+    bench_threads = threads;
+    bench_ops_per_thread = ops;
+    atomic_store(&bench_arrived, 0);
+    atomic_store(&bench_finished, 0);
+    atomic_store(&bench_torn, 0);
+
+    double start = bench_now_ns();
+    for (int32_t i = 0; i < threads; i++) {
+        if (fossil_thread_pool_add_task(pool, bench_worker, (void*)(uintptr_t)(i + 1)) != 0) {
+            // Let the workers already queued past the start line and wait for them, or erasing the pool hangs
+            fprintf(stderr, "%s: cannot queue thread %d of %d\n", bench_lock_names[bench_kind], i + 1, threads);
+            atomic_fetch_add(&bench_arrived, threads - i);
+            while (atomic_load(&bench_finished) < i) {
+                bench_yield();
+            }
+            return -1.0;
+        }
+    }
+    while (atomic_load(&bench_finished) < threads) {
+        bench_yield();
+    }
+    double elapsed = bench_now_ns() - start;
+
+    if (atomic_load(&bench_torn) != 0) {
+        fprintf(stderr, "%s: %ld torn reads\n", bench_lock_names[bench_kind], (long)atomic_load(&bench_torn));
+        return -1.0;
+    }
+    return elapsed;
+}
+
+// *****************************************************************************
+// Driver
+// *****************************************************************************
+
+int main(int argc, char** argv) {
+    const char* json_path = "bench_rwlock.json";
+    long ops = 1L << 20;
+    long write_every = 1000;
+    long max_threads = BENCH_MAX_THREADS;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--ops") == 0 && i + 1 < argc) {
+            ops = strtol(argv[++i], cnullptr, 10);
+        } else if (strcmp(argv[i], "--write-every") == 0 && i + 1 < argc) {
+            write_every = strtol(argv[++i], cnullptr, 10);
+        } else if (strcmp(argv[i], "--max-threads") == 0 && i + 1 < argc) {
+            max_threads = strtol(argv[++i], cnullptr, 10);
+        } else {
+            fprintf(stderr, "usage: %s [--json path] [--ops n] [--write-every n] [--max-threads n]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (ops <= 0 || write_every < 0 || max_threads > BENCH_MAX_THREADS) {
+        fprintf(stderr, "ops must be positive and max-threads at most %d\n", BENCH_MAX_THREADS);
+        return 1;
+    }
+    bench_write_every = write_every;
+
+    if (fossil_mutex_create(&bench_mutex) != 0 || fossil_rwlock_create(&bench_rwlock) != 0 ||
+        fossil_seqlock_create(&bench_seqlock) != 0) {
+        fprintf(stderr, "cannot create locks\n");
+        return 1;
+    }
+#ifndef _WIN32
+    pthread_rwlock_init(&bench_pthread_rwlock, cnullptr);
+#endif
+
+    FILE* json = fopen(json_path, "w");
+    if (json == cnullptr) {
+        fprintf(stderr, "cannot open %s\n", json_path);
+        return 1;
+    }
+    fprintf(json, "{\n  \"benchmark\": \"rwlock\",\n  \"ops\": %ld,\n  \"write_every\": %ld,\n  \"results\": [",
+            ops, write_every);
+
+    bool first = true;
+    for (int32_t threads = 1; threads <= max_threads; threads *= 2) {
+        fossil_xthread_pool_t pool;
+        if (fossil_thread_pool_create(&pool, threads, BENCH_MAX_THREADS * 2) != 0) {
+            fprintf(stderr, "pool failed at %d threads\n", threads);
+            break;
+        }
+        long per_thread = ops / threads > 0 ? ops / threads : 1;
+
+        for (int kind = 0; kind < BENCH_LOCKS; kind++) {
+            bench_kind = (bench_lock_t)kind;
+            double best = 0.0;
+            for (int run = 0; run < BENCH_REPEAT; run++) {
+                double elapsed = bench_run(&pool, threads, per_thread);
+                if (elapsed < 0) {
+                    best = 0.0;
+                    break;
+                }
+                if (best == 0.0 || elapsed < best) {
+                    best = elapsed;
+                }
+            }
+            if (best == 0.0) {
+                continue;
+            }
+
+            long total = per_thread * threads;
+            double ns_per_op = best / (double)total;
+            double ops_per_sec = (double)total * 1e9 / best;
+            printf("%-15s %3d threads %10.1f ns/op %14.0f ops/s\n", bench_lock_names[kind], threads, ns_per_op, ops_per_sec);
+            fprintf(json, "%s\n    {\"lock\": \"%s\", \"threads\": %d, \"ops\": %ld, \"ns_per_op\": %.3f, \"ops_per_sec\": %.1f}",
+                    first ? "" : ",", bench_lock_names[kind], threads, total, ns_per_op, ops_per_sec);
+            first = false;
+        }
+        fossil_thread_pool_erase(&pool);
+    }
+
+    fprintf(json, "\n  ]\n}\n");
+    fclose(json);
+#ifndef _WIN32
+    pthread_rwlock_destroy(&bench_pthread_rwlock);
+#endif
+    fossil_mutex_erase(&bench_mutex);
+    fossil_rwlock_erase(&bench_rwlock);
+    fossil_seqlock_erase(&bench_seqlock);
+    return 0;
+}
@@ -0,0 +1,312 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef _WIN32
+#define _GNU_SOURCE // for clock_gettime and sched_yield
+#endif
+#include <fossil/common/common.h>
+#include <fossil/threads/condition.h>
+#include <fossil/threads/mutexs.h>
+#include <fossil/threads/semaphores.h>
+#include <fossil/threads/threadpool.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sched.h>
+#include <semaphore.h>
+#include <time.h>
+#endif
+
+/**
+ * Semaphore latency benchmark, run by `meson test --benchmark` when with_bench is enabled.
+ *
+ * Two threads bounce a token through a pair of semaphores, so every round trip is two
+ * posts that each wake a sleeping thread. A second loop posts and waits on one thread,
+ * which only ever takes the uncontended path. Both run over fossil_xsem_t, over the
+ * mutex and condition variable semaphore it replaced, and over POSIX sem_t where it
+ * exists. Each result reports the best of several runs in ns per operation.
+ *
+ * Options:
+ *   --json <path>         Write the results as JSON (default bench_semaphores.json)
+ *   --rounds <n>          Round trips per ping-pong run (default 100000)
+ */
+
+#define BENCH_REPEAT 3             // Runs per configuration, the fastest is reported
+#define BENCH_UNCONTENDED 10000000 // Post and wait pairs per uncontended run
+
+static double bench_now_ns(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart * 1e9 / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1e9 + (double)now.tv_nsec;
+#endif
+}
+
+static void bench_yield(void) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+// *****************************************************************************
+// Mutex and condition variable semaphore, the baseline
+// *****************************************************************************
+
+typedef struct {
+    int value;
+    fossil_xmutex_t mutex;
+    fossil_xcond_t cond;
+} bench_condsem_t;
+
+static void bench_condsem_create(bench_condsem_t* sem) {
+    sem->value = 0;
+    fossil_mutex_create(&sem->mutex);
+    fossil_cond_create(&sem->cond);
+}
+
+static void bench_condsem_erase(bench_condsem_t* sem) {
+    fossil_cond_erase(&sem->cond);
+    fossil_mutex_erase(&sem->mutex);
+}
+
+static void bench_condsem_wait(bench_condsem_t* sem) {
+    fossil_mutex_lock(&sem->mutex);
+    while (sem->value <= 0) {
+        fossil_cond_wait(&sem->cond, &sem->mutex);
+    }
+    sem->value--;
+    fossil_mutex_unlock(&sem->mutex);
+}
+
+static void bench_condsem_post(bench_condsem_t* sem) {
+    fossil_mutex_lock(&sem->mutex);
+    sem->value++;
+    fossil_cond_signal(&sem->cond);
+    fossil_mutex_unlock(&sem->mutex);
+}
+
+// *****************************************************************************
+// Semaphore kinds
+// *****************************************************************************
+
+typedef enum {
+    BENCH_FOSSIL,
+    BENCH_CONDSEM,
+#ifndef _WIN32
+    BENCH_POSIX,
+#endif
+    BENCH_KINDS
+} bench_kind_t;
+
+static const char* bench_kind_names[] = { "fossil_sem", "mutex_cond", "posix_sem" };
+
+typedef struct {
+    bench_kind_t kind;
+    fossil_xsem_t fossil;
+    bench_condsem_t condsem;
+#ifndef _WIN32
+    sem_t posix;
+#endif
+} bench_sem_t;
+
+static void bench_sem_create(bench_sem_t* sem, bench_kind_t kind) {
+    sem->kind = kind;
+    switch (kind) {
+        case BENCH_FOSSIL: fossil_sem_create(&sem->fossil, 0); break;
+        case BENCH_CONDSEM: bench_condsem_create(&sem->condsem); break;
+#ifndef _WIN32
+        default: sem_init(&sem->posix, 0, 0); break;
+#else
+        default: break;
+#endif
+    }
+}
+
+static void bench_sem_erase(bench_sem_t* sem) {
+    switch (sem->kind) {
+        case BENCH_FOSSIL: fossil_sem_erase(&sem->fossil); break;
+        case BENCH_CONDSEM: bench_condsem_erase(&sem->condsem); break;
+#ifndef _WIN32
+        default: sem_destroy(&sem->posix); break;
+#else
+        default: break;
+#endif
+    }
+}
+
+static void bench_sem_wait(bench_sem_t* sem) {
+    switch (sem->kind) {
+        case BENCH_FOSSIL: fossil_sem_wait(&sem->fossil); break;
+        case BENCH_CONDSEM: bench_condsem_wait(&sem->condsem); break;
+#ifndef _WIN32
+        default: sem_wait(&sem->posix); break;
+#else
+        default: break;
+#endif
+    }
+}
+
+static void bench_sem_post(bench_sem_t* sem) {
+    switch (sem->kind) {
+        case BENCH_FOSSIL: fossil_sem_post(&sem->fossil); break;
+        case BENCH_CONDSEM: bench_condsem_post(&sem->condsem); break;
+#ifndef _WIN32
+        default: sem_post(&sem->posix); break;
+#else
+        default: break;
+#endif
+    }
+}
+
+// *****************************************************************************
+// Ping-pong and uncontended loops
+// *****************************************************************************
+
+static bench_sem_t bench_ping;
+static bench_sem_t bench_pong;
+static long bench_rounds;
+static atomic_bool bench_done;
+
+// Runs on a pool worker and answers every ping with a pong
+static void bench_ponger(void* arg) {
+    (void)arg;
+    for (long i = 0; i < bench_rounds; i++) {
+        bench_sem_wait(&bench_ping);
+        bench_sem_post(&bench_pong);
+    }
+    atomic_store(&bench_done, true);
+}
+
+/**
+ * Bounce a token between this thread and a pool worker.
+ *
+ * @param pool   The pool whose single worker answers.
+ * @param kind   The semaphore implementation.
+ * @param rounds The number of round trips.
+ * @return       The elapsed time in nanoseconds, or a negative value if the pool failed.
+ */
+static double bench_ping_pong(fossil_xthread_pool_t* pool, bench_kind_t kind, long rounds) {
+    bench_sem_create(&bench_ping, kind);
+    bench_sem_create(&bench_pong, kind);
+    bench_rounds = rounds;
+    atomic_store(&bench_done, false);
+
+    if (fossil_thread_pool_add_task(pool, bench_ponger, cnullptr) != 0) {
+        bench_sem_erase(&bench_ping);
+        bench_sem_erase(&bench_pong);
+        return -1.0;
+    }
+    double start = bench_now_ns();
+    for (long i = 0; i < rounds; i++) {
+        bench_sem_post(&bench_ping);
+        bench_sem_wait(&bench_pong);
+    }
+    double elapsed = bench_now_ns() - start;
+
+    while (!atomic_load(&bench_done)) {
+        bench_yield();
+    }
+    bench_sem_erase(&bench_ping);
+    bench_sem_erase(&bench_pong);
+    return elapsed;
+}
+
+// Post then wait on one thread, so the count is always positive when waiting
+static double bench_uncontended(bench_kind_t kind) {
+    bench_sem_t sem;
+    bench_sem_create(&sem, kind);
+    double start = bench_now_ns();
+    for (long i = 0; i < BENCH_UNCONTENDED; i++) {
+        bench_sem_post(&sem);
+        bench_sem_wait(&sem);
+    }
+    double elapsed = bench_now_ns() - start;
+    bench_sem_erase(&sem);
+    return elapsed;
+}
+
+// *****************************************************************************
+// Driver
+// *****************************************************************************
+
+int main(int argc, char** argv) {
+    const char* json_path = "bench_semaphores.json";
+    long rounds = 100000;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc) {
+            rounds = strtol(argv[++i], cnullptr, 10);
+        } else {
+            fprintf(stderr, "usage: %s [--json path] [--rounds n]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (rounds <= 0) {
+        fprintf(stderr, "rounds must be positive\n");
+        return 1;
+    }
+
+    fossil_xthread_pool_t pool;
+    if (fossil_thread_pool_create(&pool, 1, 4) != 0) {
+        fprintf(stderr, "cannot create pool\n");
+        return 1;
+    }
+    FILE* json = fopen(json_path, "w");
+    if (json == cnullptr) {
+        fprintf(stderr, "cannot open %s\n", json_path);
+        fossil_thread_pool_erase(&pool);
+        return 1;
+    }
+    fprintf(json, "{\n  \"benchmark\": \"semaphores\",\n  \"rounds\": %ld,\n  \"results\": [", rounds);
+
+    for (int kind = 0; kind < BENCH_KINDS; kind++) {
+        double best_pong = 0.0;
+        double best_fast = 0.0;
+        for (int run = 0; run < BENCH_REPEAT; run++) {
+            double pong = bench_ping_pong(&pool, (bench_kind_t)kind, rounds);
+            double fast = bench_uncontended((bench_kind_t)kind);
+            if (pong > 0 && (best_pong == 0.0 || pong < best_pong)) {
+                best_pong = pong;
+            }
+            if (best_fast == 0.0 || fast < best_fast) {
+                best_fast = fast;
+            }
+        }
+
+        double round_trip_ns = best_pong / (double)rounds;
+        double pair_ns = best_fast / (double)BENCH_UNCONTENDED;
+        printf("%-11s %10.1f ns/round trip %8.2f ns/uncontended post+wait\n",
+               bench_kind_names[kind], round_trip_ns, pair_ns);
+        fprintf(json, "%s\n    {\"semaphore\": \"%s\", \"round_trip_ns\": %.3f, \"uncontended_pair_ns\": %.3f}",
+                kind ? "," : "", bench_kind_names[kind], round_trip_ns, pair_ns);
+    }
+
+    fprintf(json, "\n  ]\n}\n");
+    fclose(json);
+    fossil_thread_pool_erase(&pool);
+    return 0;
+}
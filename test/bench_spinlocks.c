@@ -0,0 +1,310 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef _WIN32
+#define _GNU_SOURCE // for clock_gettime and sched_yield
+#endif
+#include <fossil/common/common.h>
+#include <fossil/threads/mutexs.h>
+#include <fossil/threads/spinlocks.h>
+#include <fossil/threads/thread.h>
+#include <fossil/threads/threadpool.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sched.h>
+#include <time.h>
+#endif
+
+/**
+ * Lock contention benchmark, run by `meson test --benchmark` when with_bench is enabled.
+ *
+ * Every thread repeatedly takes one shared lock, bumps a counter and does a little work in
+ * the critical section, then a little outside it. The same loop runs over the mutex, the
+ * test-and-test-and-set spinlock, the ticket lock and the MCS lock at 1 thread up to one per
+ * online CPU. Spinning locks slow down by orders of magnitude once threads outnumber CPUs,
+ * so larger counts only run when asked for.
+ * Each result reports the best of several runs as ns per acquisition and acquisitions per
+ * second, and the spread between the busiest and the idlest thread over a fixed time slice
+ * as a fairness measure.
+ *
+ * Options:
+ *   --json <path>         Write the results as JSON (default bench_spinlocks.json)
+ *   --ops <n>             Acquisitions per run, split across the threads (default 1048576)
+ *   --max-threads <n>     Skip thread counts above n (default the online CPUs, at most 64)
+ */
+
+#define BENCH_INSIDE_WORK 16    // Iterations of arithmetic while holding the lock
+#define BENCH_OUTSIDE_WORK 64   // Iterations of arithmetic between acquisitions
+#define BENCH_REPEAT 3          // Runs per configuration, the fastest is reported
+#define BENCH_MAX_THREADS 64
+
+typedef enum {
+    BENCH_MUTEX,
+    BENCH_SPINLOCK,
+    BENCH_TICKET,
+    BENCH_MCS,
+    BENCH_LOCKS
+} bench_lock_t;
+
+static const char* bench_lock_names[BENCH_LOCKS] = { "mutex", "spinlock", "ticket", "mcs" };
+
+static double bench_now_ns(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart * 1e9 / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1e9 + (double)now.tv_nsec;
+#endif
+}
+
+static void bench_yield(void) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+// *****************************************************************************
+// Contended loop
+// *****************************************************************************
+
+static bench_lock_t bench_kind;
+static fossil_xmutex_t bench_mutex;
+static fossil_xspinlock_t bench_spinlock;
+static fossil_xticketlock_t bench_ticket;
+static fossil_xmcslock_t bench_mcs;
+
+static uint64_t bench_counter;           // Guarded by the lock under test
+static long bench_ops_per_thread;
+static int32_t bench_threads;
+static atomic_int bench_arrived;         // Threads at the start line
+static atomic_int bench_finished;
+static atomic_bool bench_stop;           // Ends a timed fairness run
+static long bench_counts[BENCH_MAX_THREADS];
+static atomic_ullong bench_sink;         // Keeps the work alive
+
+static uint64_t bench_work(uint64_t x, int iterations) {
+    for (int i = 0; i < iterations; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+    }
+    return x;
+}
+
+static void bench_acquire(fossil_xmcs_node_t* node) {
+    switch (bench_kind) {
+        case BENCH_MUTEX: fossil_mutex_lock(&bench_mutex); break;
+        case BENCH_SPINLOCK: fossil_spinlock_lock(&bench_spinlock); break;
+        case BENCH_TICKET: fossil_ticketlock_lock(&bench_ticket); break;
+        default: fossil_mcslock_lock(&bench_mcs, node); break;
+    }
+}
+
+static void bench_release(fossil_xmcs_node_t* node) {
+    switch (bench_kind) {
+        case BENCH_MUTEX: fossil_mutex_unlock(&bench_mutex); break;
+        case BENCH_SPINLOCK: fossil_spinlock_unlock(&bench_spinlock); break;
+        case BENCH_TICKET: fossil_ticketlock_unlock(&bench_ticket); break;
+        default: fossil_mcslock_unlock(&bench_mcs, node); break;
+    }
+}
+
+// A pool task; the start line makes sure every contender runs on its own worker
+static void bench_contend(void* arg) {
+    int index = (int)(uintptr_t)arg;
+    fossil_xmcs_node_t node;
+    uint64_t x = (uint64_t)(uintptr_t)&node | 1;
+    long count = 0;
+
+    atomic_fetch_add(&bench_arrived, 1);
+    while (atomic_load(&bench_arrived) < bench_threads) {
+        bench_yield();
+    }
+    while (bench_ops_per_thread > 0 ? count < bench_ops_per_thread : !atomic_load_explicit(&bench_stop, memory_order_relaxed)) {
+        bench_acquire(&node);
+        bench_counter++;
+        x = bench_work(x, BENCH_INSIDE_WORK);
+        bench_release(&node);
+        x = bench_work(x, BENCH_OUTSIDE_WORK);
+        count++;
+    }
+    bench_counts[index] = count;
+    atomic_fetch_add_explicit(&bench_sink, x, memory_order_relaxed);
+    atomic_fetch_add(&bench_finished, 1);
+}
+
+/**
+ * Run all threads against one lock.
+ *
+ * @param pool     The pool whose workers run the contenders.
+ * @param threads  The number of contending threads.
+ * @param ops      Acquisitions per thread, or 0 to run for duration_ms instead.
+ * @param duration_ms How long a timed run lasts.
+ * @return         The elapsed time in nanoseconds, or a negative value if the run failed.
+ */
+static double bench_run(fossil_xthread_pool_t* pool, int32_t threads, long ops, int duration_ms) {
+    bench_counter = 0;
+    bench_threads = threads;
+    bench_ops_per_thread = ops;
+    atomic_store(&bench_arrived, 0);
+    atomic_store(&bench_finished, 0);
+    atomic_store(&bench_stop, false);
+
+    double start = bench_now_ns();
+    for (int32_t i = 0; i < threads; i++) {
+        if (fossil_thread_pool_add_task(pool, bench_contend, (void*)(uintptr_t)i) != 0) {
+            // Let the contenders already queued past the start line and wait for them, or erasing the pool hangs
+            fprintf(stderr, "%s: cannot queue thread %d of %d\n", bench_lock_names[bench_kind], i + 1, threads);
+            atomic_store(&bench_stop, true);
+            atomic_fetch_add(&bench_arrived, threads - i);
+            while (atomic_load(&bench_finished) < i) {
+                bench_yield();
+            }
+            return -1.0;
+        }
+    }
+    if (ops == 0) {
+        while (bench_now_ns() - start < duration_ms * 1e6) {
+            bench_yield();
+        }
+        atomic_store(&bench_stop, true);
+    }
+    while (atomic_load(&bench_finished) < threads) {
+        bench_yield();
+    }
+    double elapsed = bench_now_ns() - start;
+
+    long total = 0;
+    for (int32_t i = 0; i < threads; i++) {
+        total += bench_counts[i];
+    }
+    if (bench_counter != (uint64_t)total) {
+        fprintf(stderr, "%s: lost updates, %llu of %ld\n", bench_lock_names[bench_kind],
+                (unsigned long long)bench_counter, total);
+        return -1.0;
+    }
+    return elapsed;
+}
+
+// *****************************************************************************
+// Driver
+// *****************************************************************************
+
+int main(int argc, char** argv) {
+    const char* json_path = "bench_spinlocks.json";
+    long ops = 1L << 20;
+    long max_threads = fossil_thread_cpu_count();
+    if (max_threads > BENCH_MAX_THREADS) {
+        max_threads = BENCH_MAX_THREADS;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--ops") == 0 && i + 1 < argc) {
+            ops = strtol(argv[++i], cnullptr, 10);
+        } else if (strcmp(argv[i], "--max-threads") == 0 && i + 1 < argc) {
+            max_threads = strtol(argv[++i], cnullptr, 10);
+        } else {
+            fprintf(stderr, "usage: %s [--json path] [--ops n] [--max-threads n]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (ops <= 0 || max_threads > BENCH_MAX_THREADS) {
+        fprintf(stderr, "ops must be positive and max-threads at most %d\n", BENCH_MAX_THREADS);
+        return 1;
+    }
+
+    if (fossil_mutex_create(&bench_mutex) != 0 || fossil_spinlock_create(&bench_spinlock) != 0 ||
+        fossil_ticketlock_create(&bench_ticket) != 0 || fossil_mcslock_create(&bench_mcs) != 0) {
+        fprintf(stderr, "cannot create locks\n");
+        return 1;
+    }
+
+    FILE* json = fopen(json_path, "w");
+    if (json == cnullptr) {
+        fprintf(stderr, "cannot open %s\n", json_path);
+        return 1;
+    }
+    fprintf(json, "{\n  \"benchmark\": \"spinlocks\",\n  \"ops\": %ld,\n  \"results\": [", ops);
+
+    bool first = true;
+    for (int32_t threads = 1; threads <= max_threads; threads *= 2) {
+        fossil_xthread_pool_t pool;
+        if (fossil_thread_pool_create(&pool, threads, BENCH_MAX_THREADS * 2) != 0) {
+            fprintf(stderr, "pool failed at %d threads\n", threads);
+            break;
+        }
+        long per_thread = ops / threads > 0 ? ops / threads : 1;
+
+        for (int kind = 0; kind < BENCH_LOCKS; kind++) {
+            bench_kind = (bench_lock_t)kind;
+            double best = 0.0;
+            for (int run = 0; run < BENCH_REPEAT; run++) {
+                double elapsed = bench_run(&pool, threads, per_thread, 0);
+                if (elapsed < 0) {
+                    best = 0.0;
+                    break;
+                }
+                if (best == 0.0 || elapsed < best) {
+                    best = elapsed;
+                }
+            }
+            if (best == 0.0) {
+                continue;
+            }
+
+            // Fairness: how unevenly a fixed time slice is shared
+            long low = 0, high = 0;
+            if (bench_run(&pool, threads, 0, 100) >= 0) {
+                low = high = bench_counts[0];
+                for (int32_t i = 1; i < threads; i++) {
+                    low = bench_counts[i] < low ? bench_counts[i] : low;
+                    high = bench_counts[i] > high ? bench_counts[i] : high;
+                }
+            }
+            double spread = low > 0 ? (double)high / (double)low : 0.0;
+
+            long total = per_thread * threads;
+            double ns_per_op = best / (double)total;
+            double ops_per_sec = (double)total * 1e9 / best;
+            printf("%-9s %3d threads %10.1f ns/op %14.0f ops/s %8.2f max/min\n",
+                   bench_lock_names[kind], threads, ns_per_op, ops_per_sec, spread);
+            fprintf(json, "%s\n    {\"lock\": \"%s\", \"threads\": %d, \"ops\": %ld, \"ns_per_op\": %.3f, "
+                    "\"ops_per_sec\": %.1f, \"max_min_ratio\": %.3f}",
+                    first ? "" : ",", bench_lock_names[kind], threads, total, ns_per_op, ops_per_sec, spread);
+            first = false;
+        }
+        fossil_thread_pool_erase(&pool);
+    }
+
+    fprintf(json, "\n  ]\n}\n");
+    fclose(json);
+    fossil_mutex_erase(&bench_mutex);
+    fossil_spinlock_erase(&bench_spinlock);
+    fossil_ticketlock_erase(&bench_ticket);
+    fossil_mcslock_erase(&bench_mcs);
+    return 0;
+}
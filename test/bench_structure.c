@@ -0,0 +1,824 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef _WIN32
+#define _GNU_SOURCE // for clock_gettime, getrusage and malloc_usable_size
+#endif
+#include <fossil/generic/arrayof.h>
+#include <fossil/generic/mapof.h>
+#include <fossil/structure/cache.h>
+#include <fossil/structure/dlist.h>
+#include <fossil/structure/dqueue.h>
+#include <fossil/structure/flatmap.h>
+#include <fossil/structure/flatset.h>
+#include <fossil/structure/flist.h>
+#include <fossil/structure/intrusive.h>
+#include <fossil/structure/pqueue.h>
+#include <fossil/structure/pvector.h>
+#include <fossil/structure/queue.h>
+#include <fossil/structure/set.h>
+#include <fossil/structure/stack.h>
+#include <fossil/structure/vector.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <time.h>
+#endif
+
+/**
+ * Structure micro-benchmarks, run by `meson test --benchmark` when with_bench is enabled.
+ *
+ * Every container is filled with int tofus at sizes from 1e3 to 1e7 and timed for insert,
+ * lookup, remove, iterate and erase. Keys come in three patterns: sequential, shuffled with
+ * uniform random lookups, and shuffled with Zipf-skewed lookups. Each result reports ns/op,
+ * allocations/op and the peak heap of the run, plus the process peak RSS.
+ *
+ * Options:
+ *   --json <path>     Write the results as JSON (default bench_structure.json)
+ *   --max-size <n>    Skip sizes above n (default 10000000)
+ *   --filter <name>   Only run containers whose name contains the text
+ */
+
+#define BENCH_SAMPLE 1000            // Most operations timed for lookups and removals that scan
+#define BENCH_SCAN_BUDGET 100000000  // Elements a sampled scan may visit in total
+
+// *****************************************************************************
+// Allocation tracking
+// *****************************************************************************
+
+static size_t bench_allocs = 0;
+static size_t bench_live = 0;
+static size_t bench_peak = 0;
+static bool bench_tracking = false;
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+
+// Interpose the allocator so the library's allocations are counted too
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void __libc_free(void* ptr);
+
+#define BENCH_COUNTS_ALLOCS 1
+
+static void bench_track(void* ptr, size_t before) {
+    if (!bench_tracking) {
+        return;
+    }
+    size_t after = ptr ? malloc_usable_size(ptr) : 0;
+    bench_live = bench_live + after >= before ? bench_live + after - before : 0;
+    if (bench_live > bench_peak) {
+        bench_peak = bench_live;
+    }
+}
+
+void* malloc(size_t size) {
+    void* ptr = __libc_malloc(size);
+    bench_allocs++;
+    bench_track(ptr, 0);
+    return ptr;
+}
+
+void* calloc(size_t count, size_t size) {
+    void* ptr = __libc_calloc(count, size);
+    bench_allocs++;
+    bench_track(ptr, 0);
+    return ptr;
+}
+
+void* realloc(void* ptr, size_t size) {
+    size_t before = ptr ? malloc_usable_size(ptr) : 0;
+    void* result = __libc_realloc(ptr, size);
+    bench_allocs++;
+    if (result || size == 0) {
+        bench_track(result, before);
+    }
+    return result;
+}
+
+void free(void* ptr) {
+    if (ptr) {
+        bench_track(cnullptr, malloc_usable_size(ptr));
+    }
+    __libc_free(ptr);
+}
+#else
+#define BENCH_COUNTS_ALLOCS 0
+#endif
+
+static size_t bench_peak_rss_kb(void) {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return (size_t)(counters.PeakWorkingSetSize / 1024);
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return (size_t)usage.ru_maxrss / 1024; // Bytes on macOS
+#else
+    return (size_t)usage.ru_maxrss;
+#endif
+#endif
+}
+
+static double bench_now_ns(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart * 1e9 / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1e9 + (double)now.tv_nsec;
+#endif
+}
+
+// *****************************************************************************
+// Key patterns
+// *****************************************************************************
+
+typedef enum {
+    BENCH_SEQUENTIAL,
+    BENCH_RANDOM,
+    BENCH_ZIPF
+} bench_pattern_t;
+
+static const char* bench_pattern_names[] = { "sequential", "random", "zipf" };
+
+static uint64_t bench_rng = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t bench_random(void) {
+    // xorshift64*
+    bench_rng ^= bench_rng >> 12;
+    bench_rng ^= bench_rng << 25;
+    bench_rng ^= bench_rng >> 27;
+    return bench_rng * 0x2545F4914F6CDD1DULL;
+}
+
+static double bench_uniform(void) {
+    return (double)(bench_random() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Zipf generator with theta 0.99 (Gray et al., "Quickly generating billion-record synthetic databases")
+typedef struct {
+    size_t n;
+    double theta;
+    double alpha;
+    double zetan;
+    double eta;
+} bench_zipf_t;
+
+static void bench_zipf_init(bench_zipf_t* zipf, size_t n) {
+    zipf->n = n;
+    zipf->theta = 0.99;
+    zipf->zetan = 0.0;
+    for (size_t i = 1; i <= n; i++) {
+        zipf->zetan += 1.0 / pow((double)i, zipf->theta);
+    }
+    double zeta2 = 1.0 + 1.0 / pow(2.0, zipf->theta);
+    zipf->alpha = 1.0 / (1.0 - zipf->theta);
+    zipf->eta = (1.0 - pow(2.0 / (double)n, 1.0 - zipf->theta)) / (1.0 - zeta2 / zipf->zetan);
+}
+
+static size_t bench_zipf_next(const bench_zipf_t* zipf) {
+    double u = bench_uniform();
+    double uz = u * zipf->zetan;
+    if (uz < 1.0) {
+        return 0;
+    }
+    if (uz < 1.0 + pow(0.5, zipf->theta)) {
+        return 1;
+    }
+    size_t rank = (size_t)((double)zipf->n * pow(zipf->eta * u - zipf->eta + 1.0, zipf->alpha));
+    return rank < zipf->n ? rank : zipf->n - 1;
+}
+
+// Keys to insert, in insertion order, and keys to look up
+typedef struct {
+    int64_t* inserts;
+    int64_t* lookups;
+    size_t size;
+} bench_keys_t;
+
+static int32_t bench_keys_init(bench_keys_t* keys, bench_pattern_t pattern, size_t size) {
+    keys->size = size;
+    keys->inserts = (int64_t*)malloc(size * sizeof(int64_t));
+    keys->lookups = (int64_t*)malloc(size * sizeof(int64_t));
+    if (keys->inserts == cnullptr || keys->lookups == cnullptr) {
+        free(keys->inserts);
+        free(keys->lookups);
+        return -1;
+    }
+
+    for (size_t i = 0; i < size; i++) {
+        keys->inserts[i] = (int64_t)i;
+    }
+    if (pattern != BENCH_SEQUENTIAL) {
+        for (size_t i = size - 1; i > 0; i--) {
+            size_t j = (size_t)(bench_random() % (i + 1));
+            int64_t swap = keys->inserts[i];
+            keys->inserts[i] = keys->inserts[j];
+            keys->inserts[j] = swap;
+        }
+    }
+
+    if (pattern == BENCH_SEQUENTIAL) {
+        memcpy(keys->lookups, keys->inserts, size * sizeof(int64_t));
+    } else if (pattern == BENCH_RANDOM) {
+        for (size_t i = 0; i < size; i++) {
+            keys->lookups[i] = (int64_t)(bench_random() % size);
+        }
+    } else {
+        // Hot ranks map through the shuffled order so hot keys are scattered
+        bench_zipf_t zipf;
+        bench_zipf_init(&zipf, size);
+        for (size_t i = 0; i < size; i++) {
+            keys->lookups[i] = keys->inserts[bench_zipf_next(&zipf)];
+        }
+    }
+    return 0;
+}
+
+static void bench_keys_erase(bench_keys_t* keys) {
+    free(keys->inserts);
+    free(keys->lookups);
+}
+
+static fossil_tofu_t bench_tofu(int64_t key) {
+    fossil_tofu_t tofu;
+    memset(&tofu, 0, sizeof(tofu));
+    tofu.type = FOSSIL_TOFU_TYPE_INT;
+    tofu.value.int_val = key;
+    return tofu;
+}
+
+// *****************************************************************************
+// Container adapters
+// *****************************************************************************
+
+// Operations of one container under test; a null remove or iterate is not supported
+typedef struct {
+    const char* name;
+    size_t max_size;    // Largest size that finishes in reasonable time
+    bool scan_lookup;   // Lookups walk the container, so only a sample is timed
+    bool scan_remove;   // Removals walk the container, so only a sample is timed
+    const char* remove; // What remove means: "key", "front" or "back"
+    void* (*create)(size_t size);
+    void (*insert)(void* container, int64_t key);
+    bool (*lookup)(void* container, int64_t key);
+    void (*remove_fn)(void* container, int64_t key);
+    int64_t (*iterate)(void* container);
+    void (*erase)(void* container);
+} bench_container_t;
+
+// Vector
+static void* bench_vector_create(size_t size) { (void)size; return fossil_vector_create("int"); }
+static void bench_vector_insert(void* c, int64_t key) { fossil_vector_push_back((fossil_vector_t*)c, bench_tofu(key)); }
+static bool bench_vector_lookup(void* c, int64_t key) { return fossil_vector_search((fossil_vector_t*)c, bench_tofu(key)) >= 0; }
+static void bench_vector_remove(void* c, int64_t key) {
+    int index = fossil_vector_search((fossil_vector_t*)c, bench_tofu(key));
+    if (index >= 0) {
+        fossil_vector_remove_at((fossil_vector_t*)c, (size_t)index);
+    }
+}
+static int64_t bench_vector_iterate(void* c) {
+    int64_t sum = 0;
+    for (fossil_vector_cursor_t it = fossil_vector_cursor_begin((fossil_vector_t*)c); fossil_vector_cursor_valid(&it); fossil_vector_cursor_next(&it)) {
+        sum += fossil_vector_cursor_deref(&it)->value.int_val;
+    }
+    return sum;
+}
+static void bench_vector_erase(void* c) { fossil_vector_erase((fossil_vector_t*)c); }
+
+// Forward list
+static void* bench_flist_create(size_t size) { (void)size; return fossil_flist_create("int"); }
+static void* bench_flist_create_unrolled(size_t size) { (void)size; return fossil_flist_create_unrolled("int"); }
+static void bench_flist_insert(void* c, int64_t key) { fossil_flist_insert((fossil_flist_t*)c, bench_tofu(key)); }
+static bool bench_flist_lookup(void* c, int64_t key) { return fossil_flist_search((fossil_flist_t*)c, bench_tofu(key)) == 0; }
+static void bench_flist_remove(void* c, int64_t key) { fossil_tofu_t data; (void)key; fossil_flist_remove((fossil_flist_t*)c, &data); }
+static int64_t bench_flist_iterate(void* c) {
+    int64_t sum = 0;
+    for (fossil_flist_cursor_t it = fossil_flist_cursor_begin((fossil_flist_t*)c); fossil_flist_cursor_valid(&it); fossil_flist_cursor_next(&it)) {
+        sum += fossil_flist_cursor_deref(&it)->value.int_val;
+    }
+    return sum;
+}
+static void bench_flist_erase(void* c) { fossil_flist_erase((fossil_flist_t*)c); }
+
+// Doubly linked list
+static void* bench_dlist_create(size_t size) { (void)size; return fossil_dlist_create("int"); }
+static void* bench_dlist_create_unrolled(size_t size) { (void)size; return fossil_dlist_create_unrolled("int"); }
+static void bench_dlist_insert(void* c, int64_t key) { fossil_dlist_insert((fossil_dlist_t*)c, bench_tofu(key)); }
+static bool bench_dlist_lookup(void* c, int64_t key) { return fossil_dlist_search((fossil_dlist_t*)c, bench_tofu(key)) == 0; }
+static void bench_dlist_remove(void* c, int64_t key) { fossil_tofu_t data; (void)key; fossil_dlist_remove((fossil_dlist_t*)c, &data); }
+static int64_t bench_dlist_iterate(void* c) {
+    int64_t sum = 0;
+    for (fossil_dlist_cursor_t it = fossil_dlist_cursor_begin((fossil_dlist_t*)c); fossil_dlist_cursor_valid(&it); fossil_dlist_cursor_next(&it)) {
+        sum += fossil_dlist_cursor_deref(&it)->value.int_val;
+    }
+    return sum;
+}
+static void bench_dlist_erase(void* c) { fossil_dlist_erase((fossil_dlist_t*)c); }
+
+// Queue
+static void* bench_queue_create(size_t size) { (void)size; return fossil_queue_create("int"); }
+static void bench_queue_insert(void* c, int64_t key) { fossil_queue_insert((fossil_queue_t*)c, bench_tofu(key)); }
+static bool bench_queue_lookup(void* c, int64_t key) { return fossil_queue_search((fossil_queue_t*)c, bench_tofu(key)) == 0; }
+static void bench_queue_remove(void* c, int64_t key) { fossil_tofu_t data; (void)key; fossil_queue_remove((fossil_queue_t*)c, &data); }
+static int64_t bench_queue_iterate(void* c) {
+    int64_t sum = 0;
+    for (fossil_queue_cursor_t it = fossil_queue_cursor_begin((fossil_queue_t*)c); fossil_queue_cursor_valid(&it); fossil_queue_cursor_next(&it)) {
+        sum += fossil_queue_cursor_deref(&it)->value.int_val;
+    }
+    return sum;
+}
+static void bench_queue_erase(void* c) { fossil_queue_erase((fossil_queue_t*)c); }
+
+// Double-ended queue
+static void* bench_dqueue_create(size_t size) { (void)size; return fossil_dqueue_create("int"); }
+static void bench_dqueue_insert(void* c, int64_t key) { fossil_dqueue_insert((fossil_dqueue_t*)c, bench_tofu(key)); }
+static bool bench_dqueue_lookup(void* c, int64_t key) { return fossil_dqueue_search((fossil_dqueue_t*)c, bench_tofu(key)) == 0; }
+static void bench_dqueue_remove(void* c, int64_t key) { fossil_tofu_t data; (void)key; fossil_dqueue_remove((fossil_dqueue_t*)c, &data); }
+static int64_t bench_dqueue_iterate(void* c) {
+    int64_t sum = 0;
+    for (fossil_dqueue_cursor_t it = fossil_dqueue_cursor_begin((fossil_dqueue_t*)c); fossil_dqueue_cursor_valid(&it); fossil_dqueue_cursor_next(&it)) {
+        sum += fossil_dqueue_cursor_deref(&it)->value.int_val;
+    }
+    return sum;
+}
+static void bench_dqueue_erase(void* c) { fossil_dqueue_erase((fossil_dqueue_t*)c); }
+
+// Priority queue, prioritized by key
+static void* bench_pqueue_create(size_t size) { (void)size; return fossil_pqueue_create("int"); }
+static void bench_pqueue_insert(void* c, int64_t key) { fossil_pqueue_insert((fossil_pqueue_t*)c, bench_tofu(key), (int32_t)key); }
+static bool bench_pqueue_lookup(void* c, int64_t key) { return fossil_pqueue_search((fossil_pqueue_t*)c, bench_tofu(key), (int32_t)key) == 0; }
+static void bench_pqueue_remove(void* c, int64_t key) { fossil_tofu_t data; fossil_pqueue_remove((fossil_pqueue_t*)c, &data, (int32_t)key); }
+static int64_t bench_pqueue_iterate(void* c) {
+    int64_t sum = 0;
+    for (fossil_pqueue_cursor_t it = fossil_pqueue_cursor_begin((fossil_pqueue_t*)c); fossil_pqueue_cursor_valid(&it); fossil_pqueue_cursor_next(&it)) {
+        sum += fossil_pqueue_cursor_deref(&it)->value.int_val;
+    }
+    return sum;
+}
+static void bench_pqueue_erase(void* c) { fossil_pqueue_erase((fossil_pqueue_t*)c); }
+
+// Stack
+static void* bench_stack_create(size_t size) { (void)size; return fossil_stack_create("int"); }
+static void* bench_stack_create_array(size_t size) { (void)size; return fossil_stack_create_array("int"); }
+static void bench_stack_insert(void* c, int64_t key) { fossil_stack_insert((fossil_stack_t*)c, bench_tofu(key)); }
+static bool bench_stack_lookup(void* c, int64_t key) { return fossil_stack_search((fossil_stack_t*)c, bench_tofu(key)) == 0; }
+static void bench_stack_remove(void* c, int64_t key) { fossil_tofu_t data; (void)key; fossil_stack_remove((fossil_stack_t*)c, &data); }
+static int64_t bench_stack_iterate(void* c) {
+    int64_t sum = 0;
+    for (fossil_stack_cursor_t it = fossil_stack_cursor_begin((fossil_stack_t*)c); fossil_stack_cursor_valid(&it); fossil_stack_cursor_next(&it)) {
+        sum += fossil_stack_cursor_deref(&it)->value.int_val;
+    }
+    return sum;
+}
+static void bench_stack_erase(void* c) { fossil_stack_erase((fossil_stack_t*)c); }
+
+// Set
+static void* bench_set_create(size_t size) { (void)size; return fossil_set_create("int"); }
+static void bench_set_insert(void* c, int64_t key) { fossil_set_insert((fossil_set_t*)c, bench_tofu(key)); }
+static bool bench_set_lookup(void* c, int64_t key) { return fossil_set_contains((fossil_set_t*)c, bench_tofu(key)); }
+static void bench_set_remove(void* c, int64_t key) { fossil_set_remove((fossil_set_t*)c, bench_tofu(key)); }
+static int64_t bench_set_iterate(void* c) {
+    int64_t sum = 0;
+    for (fossil_set_cursor_t it = fossil_set_cursor_begin((fossil_set_t*)c); fossil_set_cursor_valid(&it); fossil_set_cursor_next(&it)) {
+        sum += fossil_set_cursor_deref(&it)->value.int_val;
+    }
+    return sum;
+}
+static void bench_set_erase(void* c) { fossil_set_erase((fossil_set_t*)c); }
+
+// Flat set
+static void* bench_flatset_create(size_t size) { (void)size; return fossil_flatset_create("int"); }
+static void bench_flatset_insert(void* c, int64_t key) { fossil_flatset_insert((fossil_flatset_t*)c, bench_tofu(key)); }
+static bool bench_flatset_lookup(void* c, int64_t key) { return fossil_flatset_contains((fossil_flatset_t*)c, bench_tofu(key)); }
+static void bench_flatset_remove(void* c, int64_t key) { fossil_flatset_remove((fossil_flatset_t*)c, bench_tofu(key)); }
+static int64_t bench_flatset_iterate(void* c) {
+    fossil_flatset_t* set = (fossil_flatset_t*)c;
+    int64_t sum = 0;
+    for (size_t i = 0; i < fossil_flatset_size(set); i++) {
+        sum += fossil_flatset_getter(set, i)->value.int_val;
+    }
+    return sum;
+}
+static void bench_flatset_erase(void* c) { fossil_flatset_erase((fossil_flatset_t*)c); }
+
+// Flat map
+static void* bench_flatmap_create(size_t size) { (void)size; return fossil_flatmap_create("int"); }
+static void bench_flatmap_insert(void* c, int64_t key) { fossil_flatmap_insert((fossil_flatmap_t*)c, bench_tofu(key), bench_tofu(key)); }
+static bool bench_flatmap_lookup(void* c, int64_t key) { return fossil_flatmap_getter((fossil_flatmap_t*)c, bench_tofu(key)) != cnullptr; }
+static void bench_flatmap_remove(void* c, int64_t key) { fossil_flatmap_remove((fossil_flatmap_t*)c, bench_tofu(key)); }
+static int64_t bench_flatmap_iterate(void* c) {
+    fossil_flatmap_t* map = (fossil_flatmap_t*)c;
+    int64_t sum = 0;
+    for (size_t i = 0; i < map->values->size; i++) {
+        sum += map->values->data[i].value.int_val;
+    }
+    return sum;
+}
+static void bench_flatmap_erase(void* c) { fossil_flatmap_erase((fossil_flatmap_t*)c); }
+
+// Persistent vector, updated through a transient; keys are indices
+static void* bench_pvector_create(size_t size) {
+    (void)size;
+    fossil_pvector_t* empty = fossil_pvector_create("int");
+    fossil_pvector_t* transient = empty ? fossil_pvector_transient(empty) : cnullptr;
+    fossil_pvector_erase(empty);
+    return transient;
+}
+static void bench_pvector_insert(void* c, int64_t key) { fossil_pvector_transient_push_back((fossil_pvector_t*)c, bench_tofu(key)); }
+static bool bench_pvector_lookup(void* c, int64_t key) { return fossil_pvector_getter((fossil_pvector_t*)c, (size_t)key) != cnullptr; }
+static void bench_pvector_remove(void* c, int64_t key) { (void)key; fossil_pvector_transient_pop_back((fossil_pvector_t*)c, cnullptr); }
+static int64_t bench_pvector_iterate(void* c) {
+    fossil_pvector_t* pvector = (fossil_pvector_t*)c;
+    int64_t sum = 0;
+    for (size_t i = 0; i < fossil_pvector_size(pvector);) {
+        fossil_tofu_iteratorof_t span = fossil_pvector_span(pvector, i);
+        for (size_t j = 0; j < span.size; j++) {
+            sum += span.array[j].value.int_val;
+        }
+        i += span.size;
+    }
+    return sum;
+}
+static void bench_pvector_erase(void* c) { fossil_pvector_erase((fossil_pvector_t*)c); }
+
+// Caches, sized to hold every key
+static void* bench_cache_create_lru(size_t size) { return fossil_cache_create("int", FOSSIL_CACHE_LRU, size); }
+static void* bench_cache_create_clock(size_t size) { return fossil_cache_create("int", FOSSIL_CACHE_CLOCK, size); }
+static void* bench_cache_create_arc(size_t size) { return fossil_cache_create("int", FOSSIL_CACHE_ARC, size); }
+static void bench_cache_insert(void* c, int64_t key) { fossil_cache_put((fossil_cache_t*)c, bench_tofu(key), bench_tofu(key)); }
+static bool bench_cache_lookup(void* c, int64_t key) { return fossil_cache_getter((fossil_cache_t*)c, bench_tofu(key)) != cnullptr; }
+static void bench_cache_remove(void* c, int64_t key) { fossil_cache_remove((fossil_cache_t*)c, bench_tofu(key), cnullptr); }
+static void bench_cache_erase(void* c) { fossil_cache_erase((fossil_cache_t*)c); }
+
+// Intrusive containers over preallocated records; keys index the records
+typedef struct {
+    int64_t key;
+    fossil_iflist_link_t flink;
+    fossil_idlist_link_t dlink;
+} bench_record_t;
+
+typedef struct {
+    bench_record_t* records;
+    fossil_iflist_t flist;
+    fossil_idlist_t dlist;
+    fossil_iqueue_t queue;
+} bench_intrusive_t;
+
+static void* bench_intrusive_create(size_t size) {
+    bench_intrusive_t* state = (bench_intrusive_t*)malloc(sizeof(bench_intrusive_t));
+    if (state == cnullptr) {
+        return cnullptr;
+    }
+    state->records = (bench_record_t*)calloc(size, sizeof(bench_record_t));
+    if (state->records == cnullptr) {
+        free(state);
+        return cnullptr;
+    }
+    for (size_t i = 0; i < size; i++) {
+        state->records[i].key = (int64_t)i;
+    }
+    fossil_iflist_init(&state->flist);
+    fossil_idlist_init(&state->dlist);
+    fossil_iqueue_init(&state->queue);
+    return state;
+}
+static void bench_intrusive_erase(void* c) {
+    bench_intrusive_t* state = (bench_intrusive_t*)c;
+    free(state->records);
+    free(state);
+}
+
+static void bench_iflist_insert(void* c, int64_t key) {
+    bench_intrusive_t* state = (bench_intrusive_t*)c;
+    fossil_iflist_push_front(&state->flist, &state->records[key].flink);
+}
+static bool bench_iflist_lookup(void* c, int64_t key) {
+    for (fossil_iflist_link_t* link = ((bench_intrusive_t*)c)->flist.head; link; link = link->next) {
+        if (FOSSIL_CONTAINER_OF(link, bench_record_t, flink)->key == key) {
+            return true;
+        }
+    }
+    return false;
+}
+static void bench_iflist_remove(void* c, int64_t key) {
+    bench_intrusive_t* state = (bench_intrusive_t*)c;
+    fossil_iflist_remove(&state->flist, &state->records[key].flink);
+}
+static int64_t bench_iflist_iterate(void* c) {
+    int64_t sum = 0;
+    for (fossil_iflist_link_t* link = ((bench_intrusive_t*)c)->flist.head; link; link = link->next) {
+        sum += FOSSIL_CONTAINER_OF(link, bench_record_t, flink)->key;
+    }
+    return sum;
+}
+
+static void bench_idlist_insert(void* c, int64_t key) {
+    bench_intrusive_t* state = (bench_intrusive_t*)c;
+    fossil_idlist_push_back(&state->dlist, &state->records[key].dlink);
+}
+static bool bench_idlist_lookup(void* c, int64_t key) {
+    for (fossil_idlist_link_t* link = ((bench_intrusive_t*)c)->dlist.head; link; link = link->next) {
+        if (FOSSIL_CONTAINER_OF(link, bench_record_t, dlink)->key == key) {
+            return true;
+        }
+    }
+    return false;
+}
+static void bench_idlist_remove(void* c, int64_t key) {
+    bench_intrusive_t* state = (bench_intrusive_t*)c;
+    fossil_idlist_remove(&state->dlist, &state->records[key].dlink);
+}
+static int64_t bench_idlist_iterate(void* c) {
+    int64_t sum = 0;
+    for (fossil_idlist_link_t* link = ((bench_intrusive_t*)c)->dlist.head; link; link = link->next) {
+        sum += FOSSIL_CONTAINER_OF(link, bench_record_t, dlink)->key;
+    }
+    return sum;
+}
+
+static void bench_iqueue_insert(void* c, int64_t key) {
+    bench_intrusive_t* state = (bench_intrusive_t*)c;
+    fossil_iqueue_insert(&state->queue, &state->records[key].dlink);
+}
+static bool bench_iqueue_lookup(void* c, int64_t key) {
+    for (fossil_idlist_link_t* link = fossil_iqueue_peek(&((bench_intrusive_t*)c)->queue); link; link = link->next) {
+        if (FOSSIL_CONTAINER_OF(link, bench_record_t, dlink)->key == key) {
+            return true;
+        }
+    }
+    return false;
+}
+static void bench_iqueue_remove(void* c, int64_t key) {
+    bench_intrusive_t* state = (bench_intrusive_t*)c;
+    fossil_iqueue_unlink(&state->queue, &state->records[key].dlink);
+}
+static int64_t bench_iqueue_iterate(void* c) {
+    int64_t sum = 0;
+    for (fossil_idlist_link_t* link = fossil_iqueue_peek(&((bench_intrusive_t*)c)->queue); link; link = link->next) {
+        sum += FOSSIL_CONTAINER_OF(link, bench_record_t, dlink)->key;
+    }
+    return sum;
+}
+
+// Generic array of tofus; keys are indices
+static void* bench_arrayof_create(size_t size) {
+    (void)size;
+    fossil_tofu_arrayof_t* array = (fossil_tofu_arrayof_t*)malloc(sizeof(fossil_tofu_arrayof_t));
+    if (array) {
+        *array = fossil_tofu_arrayof_create("int", 0);
+    }
+    return array;
+}
+static void bench_arrayof_insert(void* c, int64_t key) { fossil_tofu_arrayof_add((fossil_tofu_arrayof_t*)c, bench_tofu(key)); }
+static bool bench_arrayof_lookup(void* c, int64_t key) {
+    return fossil_tofu_arrayof_get((fossil_tofu_arrayof_t*)c, (size_t)key).type == FOSSIL_TOFU_TYPE_INT;
+}
+static int64_t bench_arrayof_iterate(void* c) {
+    fossil_tofu_arrayof_t* array = (fossil_tofu_arrayof_t*)c;
+    int64_t sum = 0;
+    for (size_t i = 0; i < fossil_tofu_arrayof_size(array); i++) {
+        sum += fossil_tofu_arrayof_get(array, i).value.int_val;
+    }
+    return sum;
+}
+static void bench_arrayof_erase(void* c) {
+    fossil_tofu_arrayof_erase((fossil_tofu_arrayof_t*)c);
+    free(c);
+}
+
+// Generic map of tofus
+static void* bench_mapof_create(size_t size) {
+    (void)size;
+    fossil_tofu_mapof_t* map = (fossil_tofu_mapof_t*)malloc(sizeof(fossil_tofu_mapof_t));
+    if (map) {
+        *map = fossil_tofu_mapof_create(1);
+    }
+    return map;
+}
+static void bench_mapof_insert(void* c, int64_t key) { fossil_tofu_mapof_add((fossil_tofu_mapof_t*)c, bench_tofu(key), bench_tofu(key)); }
+static bool bench_mapof_lookup(void* c, int64_t key) { return fossil_tofu_mapof_contains((fossil_tofu_mapof_t*)c, bench_tofu(key)); }
+static void bench_mapof_remove(void* c, int64_t key) { fossil_tofu_mapof_remove((fossil_tofu_mapof_t*)c, bench_tofu(key)); }
+static int64_t bench_mapof_iterate(void* c) {
+    fossil_tofu_mapof_t* map = (fossil_tofu_mapof_t*)c;
+    int64_t sum = 0;
+    for (size_t i = 0; i < map->size; i++) {
+        sum += map->values[i].value.int_val;
+    }
+    return sum;
+}
+static void bench_mapof_erase(void* c) {
+    fossil_tofu_mapof_erase((fossil_tofu_mapof_t*)c);
+    free(c);
+}
+
+#define BENCH_ALL ((size_t)10000000)
+
+static const bench_container_t bench_containers[] = {
+    { "vector", BENCH_ALL, true, true, "key", bench_vector_create, bench_vector_insert, bench_vector_lookup, bench_vector_remove, bench_vector_iterate, bench_vector_erase },
+    { "flist", BENCH_ALL, true, false, "front", bench_flist_create, bench_flist_insert, bench_flist_lookup, bench_flist_remove, bench_flist_iterate, bench_flist_erase },
+    { "flist_unrolled", BENCH_ALL, true, false, "front", bench_flist_create_unrolled, bench_flist_insert, bench_flist_lookup, bench_flist_remove, bench_flist_iterate, bench_flist_erase },
+    { "dlist", BENCH_ALL, true, false, "front", bench_dlist_create, bench_dlist_insert, bench_dlist_lookup, bench_dlist_remove, bench_dlist_iterate, bench_dlist_erase },
+    { "dlist_unrolled", BENCH_ALL, true, false, "front", bench_dlist_create_unrolled, bench_dlist_insert, bench_dlist_lookup, bench_dlist_remove, bench_dlist_iterate, bench_dlist_erase },
+    { "queue", BENCH_ALL, true, false, "front", bench_queue_create, bench_queue_insert, bench_queue_lookup, bench_queue_remove, bench_queue_iterate, bench_queue_erase },
+    { "dqueue", BENCH_ALL, true, false, "front", bench_dqueue_create, bench_dqueue_insert, bench_dqueue_lookup, bench_dqueue_remove, bench_dqueue_iterate, bench_dqueue_erase },
+    { "pqueue", 10000, true, true, "key", bench_pqueue_create, bench_pqueue_insert, bench_pqueue_lookup, bench_pqueue_remove, bench_pqueue_iterate, bench_pqueue_erase },
+    { "stack", BENCH_ALL, true, false, "front", bench_stack_create, bench_stack_insert, bench_stack_lookup, bench_stack_remove, bench_stack_iterate, bench_stack_erase },
+    { "stack_array", BENCH_ALL, true, false, "front", bench_stack_create_array, bench_stack_insert, bench_stack_lookup, bench_stack_remove, bench_stack_iterate, bench_stack_erase },
+    { "set", 10000, true, true, "key", bench_set_create, bench_set_insert, bench_set_lookup, bench_set_remove, bench_set_iterate, bench_set_erase },
+    { "flatset", 100000, false, false, "key", bench_flatset_create, bench_flatset_insert, bench_flatset_lookup, bench_flatset_remove, bench_flatset_iterate, bench_flatset_erase },
+    { "flatmap", 100000, false, false, "key", bench_flatmap_create, bench_flatmap_insert, bench_flatmap_lookup, bench_flatmap_remove, bench_flatmap_iterate, bench_flatmap_erase },
+    { "pvector", BENCH_ALL, false, false, "back", bench_pvector_create, bench_pvector_insert, bench_pvector_lookup, bench_pvector_remove, bench_pvector_iterate, bench_pvector_erase },
+    { "cache_lru", BENCH_ALL, false, false, "key", bench_cache_create_lru, bench_cache_insert, bench_cache_lookup, bench_cache_remove, cnullptr, bench_cache_erase },
+    { "cache_clock", BENCH_ALL, false, false, "key", bench_cache_create_clock, bench_cache_insert, bench_cache_lookup, bench_cache_remove, cnullptr, bench_cache_erase },
+    { "cache_arc", BENCH_ALL, false, false, "key", bench_cache_create_arc, bench_cache_insert, bench_cache_lookup, bench_cache_remove, cnullptr, bench_cache_erase },
+    { "iflist", BENCH_ALL, true, true, "key", bench_intrusive_create, bench_iflist_insert, bench_iflist_lookup, bench_iflist_remove, bench_iflist_iterate, bench_intrusive_erase },
+    { "idlist", BENCH_ALL, true, false, "key", bench_intrusive_create, bench_idlist_insert, bench_idlist_lookup, bench_idlist_remove, bench_idlist_iterate, bench_intrusive_erase },
+    { "iqueue", BENCH_ALL, true, false, "key", bench_intrusive_create, bench_iqueue_insert, bench_iqueue_lookup, bench_iqueue_remove, bench_iqueue_iterate, bench_intrusive_erase },
+    { "arrayof", BENCH_ALL, false, false, cnullptr, bench_arrayof_create, bench_arrayof_insert, bench_arrayof_lookup, cnullptr, bench_arrayof_iterate, bench_arrayof_erase },
+    { "mapof", BENCH_ALL, true, true, "key", bench_mapof_create, bench_mapof_insert, bench_mapof_lookup, bench_mapof_remove, bench_mapof_iterate, bench_mapof_erase },
+};
+
+// *****************************************************************************
+// Driver
+// *****************************************************************************
+
+typedef struct {
+    double start_ns;
+    size_t start_allocs;
+} bench_timer_t;
+
+static FILE* bench_json = cnullptr;
+static bool bench_first_result = true;
+static volatile int64_t bench_sink = 0; // Keeps results alive so loops are not optimized out
+
+static void bench_begin(bench_timer_t* timer) {
+    bench_peak = bench_live;
+    bench_tracking = true;
+    timer->start_allocs = bench_allocs;
+    timer->start_ns = bench_now_ns();
+}
+
+static void bench_end(const bench_timer_t* timer, const bench_container_t* container, bench_pattern_t pattern,
+                      size_t size, const char* op, size_t ops) {
+    double elapsed = bench_now_ns() - timer->start_ns;
+    size_t allocs = bench_allocs - timer->start_allocs;
+    bench_tracking = false;
+
+    double ns_per_op = ops ? elapsed / (double)ops : 0.0;
+    double allocs_per_op = ops ? (double)allocs / (double)ops : 0.0;
+    size_t peak_rss = bench_peak_rss_kb();
+
+    printf("%-15s %-10s %9zu %-8s %12.2f ns/op", container->name, bench_pattern_names[pattern], size, op, ns_per_op);
+    if (BENCH_COUNTS_ALLOCS) {
+        printf(" %8.3f allocs/op %12zu peak heap B", allocs_per_op, bench_peak);
+    }
+    printf(" %10zu peak RSS KB\n", peak_rss);
+
+    if (bench_json) {
+        fprintf(bench_json, "%s\n    {\"container\": \"%s\", \"pattern\": \"%s\", \"size\": %zu, \"op\": \"%s\", "
+                "\"ops\": %zu, \"ns_per_op\": %.3f, ",
+                bench_first_result ? "" : ",", container->name, bench_pattern_names[pattern], size, op, ops, ns_per_op);
+        if (BENCH_COUNTS_ALLOCS) {
+            fprintf(bench_json, "\"allocs_per_op\": %.4f, \"peak_heap_bytes\": %zu, ", allocs_per_op, bench_peak);
+        } else {
+            fprintf(bench_json, "\"allocs_per_op\": null, \"peak_heap_bytes\": null, ");
+        }
+        fprintf(bench_json, "\"peak_rss_kb\": %zu}", peak_rss);
+        bench_first_result = false;
+    }
+}
+
+// Number of scanning operations to time, shrinking with size so every run stays bounded
+static size_t bench_scan_ops(size_t size) {
+    size_t ops = BENCH_SCAN_BUDGET / size;
+    if (ops > BENCH_SAMPLE) {
+        ops = BENCH_SAMPLE;
+    }
+    if (ops < 10) {
+        ops = 10;
+    }
+    return ops < size ? ops : size;
+}
+
+static void bench_run(const bench_container_t* container, bench_pattern_t pattern, const bench_keys_t* keys) {
+    size_t size = keys->size;
+    bench_timer_t timer;
+    void* c = container->create(size);
+    if (c == cnullptr) {
+        fprintf(stderr, "%s: create failed at size %zu\n", container->name, size);
+        return;
+    }
+
+    bench_begin(&timer);
+    for (size_t i = 0; i < size; i++) {
+        container->insert(c, keys->inserts[i]);
+    }
+    bench_end(&timer, container, pattern, size, "insert", size);
+
+    size_t ops = container->scan_lookup ? bench_scan_ops(size) : size;
+    int64_t found = 0;
+    bench_begin(&timer);
+    for (size_t i = 0; i < ops; i++) {
+        found += container->lookup(c, keys->lookups[i]);
+    }
+    bench_end(&timer, container, pattern, size, "lookup", ops);
+    bench_sink += found;
+
+    if (container->iterate) {
+        bench_begin(&timer);
+        bench_sink += container->iterate(c);
+        bench_end(&timer, container, pattern, size, "iterate", size);
+    }
+
+    if (container->remove_fn) {
+        // Removals follow insertion order; scanning containers remove a sample from the far end
+        ops = container->scan_remove ? bench_scan_ops(size) : size;
+        bench_begin(&timer);
+        for (size_t i = 0; i < ops; i++) {
+            container->remove_fn(c, keys->inserts[size - 1 - i]);
+        }
+        bench_end(&timer, container, pattern, size, "remove", ops);
+    }
+
+    bench_begin(&timer);
+    container->erase(c);
+    bench_end(&timer, container, pattern, size, "erase", size);
+}
+
+int main(int argc, char** argv) {
+    const char* json_path = "bench_structure.json";
+    const char* filter = cnullptr;
+    size_t max_size = BENCH_ALL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--max-size") == 0 && i + 1 < argc) {
+            max_size = (size_t)strtoull(argv[++i], cnullptr, 10);
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--json path] [--max-size n] [--filter name]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    bench_json = fopen(json_path, "w");
+    if (bench_json == cnullptr) {
+        fprintf(stderr, "cannot open %s\n", json_path);
+        return 1;
+    }
+    fprintf(bench_json, "{\n  \"benchmark\": \"structure\",\n  \"counts_allocations\": %s,\n  \"results\": [",
+            BENCH_COUNTS_ALLOCS ? "true" : "false");
+
+    for (size_t size = 1000; size <= max_size; size *= 10) {
+        for (int pattern = BENCH_SEQUENTIAL; pattern <= BENCH_ZIPF; pattern++) {
+            bench_keys_t keys;
+            if (bench_keys_init(&keys, (bench_pattern_t)pattern, size) != 0) {
+                fprintf(stderr, "out of memory for %zu keys\n", size);
+                continue;
+            }
+            for (size_t i = 0; i < sizeof(bench_containers) / sizeof(bench_containers[0]); i++) {
+                const bench_container_t* container = &bench_containers[i];
+                if (size > container->max_size || (filter && strstr(container->name, filter) == cnullptr)) {
+                    continue;
+                }
+                bench_run(container, (bench_pattern_t)pattern, &keys);
+            }
+            bench_keys_erase(&keys);
+        }
+    }
+
+    fprintf(bench_json, "\n  ]\n}\n");
+    fclose(bench_json);
+    return 0;
+}
@@ -0,0 +1,238 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef _WIN32
+#define _GNU_SOURCE // for clock_gettime and sched_yield
+#endif
+#include <fossil/common/common.h>
+#include <fossil/threads/threadpool.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sched.h>
+#include <time.h>
+#endif
+
+/**
+ * Thread pool fork/join benchmark, run by `meson test --benchmark` when with_bench is enabled.
+ *
+ * Every task of a binary tree adds its two children to the pool from inside a worker, and
+ * the leaves do a little arithmetic. The same tree runs on the classic pool, where all tasks
+ * share one locked queue, and on the work-stealing pool, at 1 to 64 threads. A task that the
+ * classic pool rejects because its queue is full runs inline in the task that spawned it.
+ * Each result reports the best of several runs as ns per task and tasks per second.
+ *
+ * Options:
+ *   --json <path>         Write the results as JSON (default bench_threads.json)
+ *   --depth <n>           Depth of the task tree (default 16, 2^(n+1)-1 tasks)
+ *   --max-threads <n>     Skip thread counts above n (default 64)
+ *   --metrics             Create the pools with metrics, to measure their cost, and report the
+ *                         queue wait and run time percentiles and the worker utilization
+ */
+
+#define BENCH_QUEUE_SIZE 1024  // Shared queue of the classic pool, and initial deque size
+#define BENCH_LEAF_WORK 256    // Iterations of arithmetic per leaf
+#define BENCH_REPEAT 3         // Runs per configuration, the fastest is reported
+
+static double bench_now_ns(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart * 1e9 / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1e9 + (double)now.tv_nsec;
+#endif
+}
+
+static void bench_yield(void) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+// *****************************************************************************
+// Fork/join tree
+// *****************************************************************************
+
+static fossil_xthread_pool_t bench_pool;
+static atomic_long bench_pending;        // Tasks spawned but not finished
+static atomic_ullong bench_sink;         // Keeps the leaf work alive
+static atomic_long bench_inline;         // Tasks run inline because the pool rejected them
+static bool bench_metrics;
+static fossil_xthread_pool_metrics_t bench_snapshot; // Metrics of the last run
+
+static void bench_node(void* arg);
+
+static void bench_spawn(uintptr_t depth) {
+    atomic_fetch_add(&bench_pending, 1);
+    if (fossil_thread_pool_add_task(&bench_pool, bench_node, (void*)depth) != 0) {
+        atomic_fetch_add(&bench_inline, 1);
+        bench_node((void*)depth);
+    }
+}
+
+static void bench_node(void* arg) {
+    uintptr_t depth = (uintptr_t)arg;
+    if (depth == 0) {
+        uint64_t x = (uint64_t)(uintptr_t)&depth | 1;
+        for (int i = 0; i < BENCH_LEAF_WORK; i++) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+        }
+        atomic_fetch_add_explicit(&bench_sink, x, memory_order_relaxed);
+    } else {
+        bench_spawn(depth - 1);
+        bench_spawn(depth - 1);
+    }
+    atomic_fetch_sub(&bench_pending, 1);
+}
+
+/**
+ * Run one tree on a fresh pool.
+ *
+ * @param stealing Whether to create the work-stealing pool.
+ * @param threads  The number of workers.
+ * @param depth    The depth of the tree.
+ * @return         The elapsed time in nanoseconds, or a negative value if the pool failed.
+ */
+static double bench_fork_join(bool stealing, int32_t threads, uintptr_t depth) {
+    fossil_xthread_pool_options_t options = {
+        .thread_count = threads, .queue_size = BENCH_QUEUE_SIZE, .stealing = stealing, .metrics = bench_metrics
+    };
+    if (fossil_thread_pool_create_options(&bench_pool, &options) != 0) {
+        return -1.0;
+    }
+
+    double start = bench_now_ns();
+    atomic_store(&bench_pending, 1);
+    if (fossil_thread_pool_add_task(&bench_pool, bench_node, (void*)depth) != 0) {
+        fossil_thread_pool_erase(&bench_pool);
+        return -1.0;
+    }
+    while (atomic_load(&bench_pending) > 0) {
+        bench_yield();
+    }
+    double elapsed = bench_now_ns() - start;
+
+    if (bench_metrics) {
+        fossil_thread_pool_metrics(&bench_pool, &bench_snapshot);
+    }
+    fossil_thread_pool_erase(&bench_pool);
+    return elapsed;
+}
+
+// *****************************************************************************
+// Driver
+// *****************************************************************************
+
+int main(int argc, char** argv) {
+    const char* json_path = "bench_threads.json";
+    unsigned long depth = 16;
+    long max_threads = 64;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--depth") == 0 && i + 1 < argc) {
+            depth = strtoul(argv[++i], cnullptr, 10);
+        } else if (strcmp(argv[i], "--max-threads") == 0 && i + 1 < argc) {
+            max_threads = strtol(argv[++i], cnullptr, 10);
+        } else if (strcmp(argv[i], "--metrics") == 0) {
+            bench_metrics = true;
+        } else {
+            fprintf(stderr, "usage: %s [--json path] [--depth n] [--max-threads n] [--metrics]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (depth > 30) {
+        fprintf(stderr, "depth %lu is too large\n", depth);
+        return 1;
+    }
+
+    FILE* json = fopen(json_path, "w");
+    if (json == cnullptr) {
+        fprintf(stderr, "cannot open %s\n", json_path);
+        return 1;
+    }
+    fprintf(json, "{\n  \"benchmark\": \"threads\",\n  \"depth\": %lu,\n  \"metrics\": %s,\n  \"results\": [",
+            depth, bench_metrics ? "true" : "false");
+
+    size_t tasks = ((size_t)2 << depth) - 1;
+    bool first = true;
+    for (int32_t threads = 1; threads <= max_threads; threads *= 2) {
+        double best[2] = { 0.0, 0.0 };
+        for (int stealing = 0; stealing <= 1; stealing++) {
+            const char* name = stealing ? "stealing" : "classic";
+            long inlined = 0;
+            uint64_t wait_p50 = 0, wait_p99 = 0, run_p99 = 0;
+            double utilization = 0.0;
+            for (int run = 0; run < BENCH_REPEAT; run++) {
+                atomic_store(&bench_inline, 0);
+                double elapsed = bench_fork_join(stealing, threads, depth);
+                if (elapsed < 0) {
+                    fprintf(stderr, "%s: pool failed at %d threads\n", name, threads);
+                    break;
+                }
+                if (best[stealing] == 0.0 || elapsed < best[stealing]) {
+                    best[stealing] = elapsed;
+                    inlined = atomic_load(&bench_inline);
+                    if (bench_metrics) {
+                        uint64_t total = bench_snapshot.busy_ns + bench_snapshot.idle_ns;
+                        wait_p50 = fossil_thread_pool_histogram_percentile(&bench_snapshot.wait, 50.0);
+                        wait_p99 = fossil_thread_pool_histogram_percentile(&bench_snapshot.wait, 99.0);
+                        run_p99 = fossil_thread_pool_histogram_percentile(&bench_snapshot.run, 99.0);
+                        utilization = total ? (double)bench_snapshot.busy_ns / (double)total : 0.0;
+                    }
+                }
+            }
+            if (best[stealing] == 0.0) {
+                continue;
+            }
+
+            double ns_per_task = best[stealing] / (double)tasks;
+            double tasks_per_sec = (double)tasks * 1e9 / best[stealing];
+            printf("%-9s %3d threads %10zu tasks %10.1f ns/task %14.0f tasks/s %8ld inline\n",
+                   name, threads, tasks, ns_per_task, tasks_per_sec, inlined);
+            fprintf(json, "%s\n    {\"pool\": \"%s\", \"threads\": %d, \"tasks\": %zu, \"ns_per_task\": %.3f, "
+                    "\"tasks_per_sec\": %.1f, \"inline_tasks\": %ld",
+                    first ? "" : ",", name, threads, tasks, ns_per_task, tasks_per_sec, inlined);
+            if (bench_metrics) {
+                printf("%-9s %3d threads wait p50 %llu ns p99 %llu ns, run p99 %llu ns, %.0f%% busy\n", "", threads,
+                       (unsigned long long)wait_p50, (unsigned long long)wait_p99, (unsigned long long)run_p99,
+                       utilization * 100.0);
+                fprintf(json, ", \"wait_p50_ns\": %llu, \"wait_p99_ns\": %llu, \"run_p99_ns\": %llu, \"utilization\": %.4f",
+                        (unsigned long long)wait_p50, (unsigned long long)wait_p99, (unsigned long long)run_p99, utilization);
+            }
+            fprintf(json, "}");
+            first = false;
+        }
+        if (best[0] > 0.0 && best[1] > 0.0) {
+            printf("%-9s %3d threads %10.2fx\n", "speedup", threads, best[0] / best[1]);
+        }
+    }
+
+    fprintf(json, "\n  ]\n}\n");
+    fclose(json);
+    return 0;
+}
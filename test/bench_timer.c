@@ -0,0 +1,335 @@
+/*
+==============================================================================
+Author: Michael Gene Brockus (Dreamer)
+Email: michaelbrockus@gmail.com
+Organization: Fossil Logic
+Description:
+    This file is part of the Fossil Logic project, where innovation meets
+    excellence in software development. Michael Gene Brockus, also known as
+    "Dreamer," is a dedicated contributor to this project. For any inquiries,
+    feel free to contact Michael at michaelbrockus@gmail.com.
+==============================================================================
+*/
+#ifndef _WIN32
+#define _GNU_SOURCE // for clock_gettime
+#endif
+#include <fossil/common/common.h>
+#include <fossil/threads/threadpool.h>
+#include <fossil/threads/timer.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+/**
+ * Timer wheel benchmark, run by `meson test --benchmark` when with_bench is enabled.
+ *
+ * The first part keeps a large number of timeouts pending, with delays from one second to
+ * an hour, and times starting, moving and cancelling them, which is what a server does with
+ * connection timeouts that almost never fire. The second part lets timers with delays spread
+ * over one second fire on a thread pool and reports how late they ran. Operation costs are
+ * the best of several runs in ns per operation; lateness is in microseconds.
+ *
+ * A last check runs on a wheel with a one millisecond tick and no pool, so tasks run on the
+ * timer thread while it drains a slot. Periodic timers with periods around one turn of the
+ * wheel must fire once per period, and timers started by tasks of a slot that is being drained,
+ * with a deadline that falls in that same slot one turn later, must not fire early. The run
+ * fails if either goes wrong.
+ *
+ * Options:
+ *   --json <path>         Write the results as JSON (default bench_timer.json)
+ *   --timers <n>          Pending timers (default 1048576)
+ *   --fire <n>            Timers that fire in the lateness run (default 10000)
+ *   --tick-us <n>         Tick of the wheel in microseconds (default 1000)
+ */
+
+#define BENCH_REPEAT 3        // Runs per configuration, the fastest is reported
+#define BENCH_FIRE_SPREAD 1000 // Delays of the lateness run, in milliseconds
+#define BENCH_TURN_RUN 1100    // How long the periodic timers of the last check run, in milliseconds
+#define BENCH_TURN_CHAIN 1024  // Timers that start another from their task, more than one batch
+
+static double bench_now_ns(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart * 1e9 / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1e9 + (double)now.tv_nsec;
+#endif
+}
+
+// *****************************************************************************
+// Pending timeouts
+// *****************************************************************************
+
+static void bench_never(void* arg) {
+    (void)arg;
+}
+
+typedef struct {
+    double start;
+    double move;
+    double cancel;
+} bench_ops_t;
+
+/**
+ * Start, move and cancel every timer once.
+ *
+ * @param wheel  The wheel to use.
+ * @param timers The timers.
+ * @param count  The number of timers.
+ * @param ops    Where to store the ns per operation of each step.
+ */
+static void bench_pending(fossil_xtimer_wheel_t* wheel, fossil_xtimer_t* timers, long count, bench_ops_t* ops) {
+    uint32_t seed = 2463534242u;
+    double start = bench_now_ns();
+    for (long i = 0; i < count; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        fossil_timer_start(wheel, &timers[i], 1000u + seed % 3600000u, 0);
+    }
+    double started = bench_now_ns();
+    for (long i = 0; i < count; i++) {
+        fossil_timer_start(wheel, &timers[i], 2000u + (uint32_t)i % 3600000u, 0);
+    }
+    double moved = bench_now_ns();
+    for (long i = 0; i < count; i++) {
+        fossil_timer_cancel(wheel, &timers[i]);
+    }
+    double cancelled = bench_now_ns();
+
+    ops->start = (started - start) / (double)count;
+    ops->move = (moved - started) / (double)count;
+    ops->cancel = (cancelled - moved) / (double)count;
+}
+
+// *****************************************************************************
+// Lateness
+// *****************************************************************************
+
+typedef struct {
+    fossil_xtimer_t timer;
+    double deadline;
+    double fired;
+} bench_firing_t;
+
+static atomic_long bench_fired;
+
+static void bench_fire(void* arg) {
+    bench_firing_t* firing = (bench_firing_t*)arg;
+    firing->fired = bench_now_ns();
+    atomic_fetch_add(&bench_fired, 1);
+}
+
+static int bench_compare(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// *****************************************************************************
+// Wheel turns
+// *****************************************************************************
+
+typedef struct {
+    fossil_xtimer_t timer;
+    uint32_t period;
+    atomic_long count;
+} bench_periodic_t;
+
+typedef struct {
+    fossil_xtimer_wheel_t* wheel;
+    fossil_xtimer_t timer;
+    fossil_xtimer_t follow;
+    double started;
+    double fired;
+} bench_chain_t;
+
+static atomic_long bench_followed;
+
+static void bench_tick(void* arg) {
+    atomic_fetch_add(&((bench_periodic_t*)arg)->count, 1);
+}
+
+static void bench_follow(void* arg) {
+    bench_chain_t* chain = (bench_chain_t*)arg;
+    chain->fired = bench_now_ns();
+    atomic_fetch_add(&bench_followed, 1);
+}
+
+// Lands one turn later in the slot the timer thread is draining, if it is not running late
+static void bench_chain(void* arg) {
+    bench_chain_t* chain = (bench_chain_t*)arg;
+    chain->started = bench_now_ns();
+    fossil_timer_start(chain->wheel, &chain->follow, FOSSIL_TIMER_WHEEL_SLOTS - 1, 0);
+}
+
+/**
+ * Run periodic timers around one turn of the wheel, then the chained timers.
+ *
+ * @param counts Where to store how often each periodic timer fired.
+ * @return       The number of chained timers that fired early, or a negative value on failure.
+ */
+static long bench_turns(long counts[3]) {
+    static bench_periodic_t periodic[3];
+    static bench_chain_t chains[BENCH_TURN_CHAIN];
+    fossil_xtimer_wheel_t wheel;
+    if (fossil_timer_wheel_create(&wheel, cnullptr, 1000) != 0) {
+        return -1;
+    }
+
+    for (int i = 0; i < 3; i++) {
+        periodic[i].period = FOSSIL_TIMER_WHEEL_SLOTS - 1 + (uint32_t)i;
+        atomic_store(&periodic[i].count, 0);
+        fossil_timer_init(&periodic[i].timer, bench_tick, &periodic[i]);
+        fossil_timer_start(&wheel, &periodic[i].timer, periodic[i].period, periodic[i].period);
+    }
+    fossil_task_delay_milliseconds(BENCH_TURN_RUN);
+    for (int i = 0; i < 3; i++) {
+        fossil_timer_cancel(&wheel, &periodic[i].timer);
+        counts[i] = atomic_load(&periodic[i].count);
+    }
+
+    atomic_store(&bench_followed, 0);
+    for (long i = 0; i < BENCH_TURN_CHAIN; i++) {
+        chains[i].wheel = &wheel;
+        fossil_timer_init(&chains[i].timer, bench_chain, &chains[i]);
+        fossil_timer_init(&chains[i].follow, bench_follow, &chains[i]);
+    }
+    for (long i = 0; i < BENCH_TURN_CHAIN; i++) {
+        fossil_timer_start(&wheel, &chains[i].timer, 10, 0);
+    }
+    while (atomic_load(&bench_followed) < BENCH_TURN_CHAIN) {
+        fossil_task_delay_milliseconds(10);
+    }
+    fossil_timer_wheel_erase(&wheel);
+
+    long early = 0;
+    for (long i = 0; i < BENCH_TURN_CHAIN; i++) {
+        early += chains[i].fired - chains[i].started < (double)(FOSSIL_TIMER_WHEEL_SLOTS - 1) * 1e6;
+    }
+    return early;
+}
+
+// *****************************************************************************
+// Driver
+// *****************************************************************************
+
+int main(int argc, char** argv) {
+    const char* json_path = "bench_timer.json";
+    long count = 1L << 20;
+    long fire = 10000;
+    long tick_us = FOSSIL_TIMER_DEFAULT_TICK_US;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--timers") == 0 && i + 1 < argc) {
+            count = strtol(argv[++i], cnullptr, 10);
+        } else if (strcmp(argv[i], "--fire") == 0 && i + 1 < argc) {
+            fire = strtol(argv[++i], cnullptr, 10);
+        } else if (strcmp(argv[i], "--tick-us") == 0 && i + 1 < argc) {
+            tick_us = strtol(argv[++i], cnullptr, 10);
+        } else {
+            fprintf(stderr, "usage: %s [--json path] [--timers n] [--fire n] [--tick-us n]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (count <= 0 || fire <= 0 || tick_us <= 0) {
+        fprintf(stderr, "timers, fire and tick-us must be positive\n");
+        return 1;
+    }
+
+    fossil_xthread_pool_t pool;
+    fossil_xtimer_wheel_t wheel;
+    if (fossil_thread_pool_create(&pool, 2, 1024) != 0 || fossil_timer_wheel_create(&wheel, &pool, (uint32_t)tick_us) != 0) {
+        fprintf(stderr, "cannot create the pool and wheel\n");
+        return 1;
+    }
+
+    fossil_xtimer_t* timers = (fossil_xtimer_t*)malloc(sizeof(fossil_xtimer_t) * (size_t)count);
+    bench_firing_t* firings = (bench_firing_t*)malloc(sizeof(bench_firing_t) * (size_t)fire);
+    double* late = (double*)malloc(sizeof(double) * (size_t)fire);
+    if (timers == cnullptr || firings == cnullptr || late == cnullptr) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    for (long i = 0; i < count; i++) {
+        fossil_timer_init(&timers[i], bench_never, cnullptr);
+    }
+
+    bench_ops_t best = {0.0, 0.0, 0.0};
+    for (int run = 0; run < BENCH_REPEAT; run++) {
+        bench_ops_t ops;
+        bench_pending(&wheel, timers, count, &ops);
+        if (run == 0 || ops.start < best.start) best.start = ops.start;
+        if (run == 0 || ops.move < best.move) best.move = ops.move;
+        if (run == 0 || ops.cancel < best.cancel) best.cancel = ops.cancel;
+    }
+    printf("%ld pending: start %.1f ns/op, move %.1f ns/op, cancel %.1f ns/op\n", count, best.start, best.move, best.cancel);
+
+    // Spread the deadlines evenly over the spread so the pool is never the bottleneck
+    atomic_store(&bench_fired, 0);
+    for (long i = 0; i < fire; i++) {
+        uint32_t delay = (uint32_t)(i * BENCH_FIRE_SPREAD / fire);
+        fossil_timer_init(&firings[i].timer, bench_fire, &firings[i]);
+        firings[i].deadline = bench_now_ns() + (double)delay * 1e6;
+        fossil_timer_start(&wheel, &firings[i].timer, delay, 0);
+    }
+    while (atomic_load(&bench_fired) < fire) {
+        fossil_task_delay_milliseconds(10);
+    }
+    long early = 0;
+    for (long i = 0; i < fire; i++) {
+        late[i] = (firings[i].fired - firings[i].deadline) / 1e3;
+        early += late[i] < 0.0;
+    }
+    qsort(late, (size_t)fire, sizeof(double), bench_compare);
+    double p50 = late[fire / 2], p99 = late[fire * 99 / 100], max = late[fire - 1];
+    printf("%ld fired: late p50 %.1f us, p99 %.1f us, max %.1f us, %ld early\n", fire, p50, p99, max, early);
+
+    long counts[3] = {0, 0, 0};
+    long turn_early = bench_turns(counts);
+    bool turn_ok = turn_early == 0;
+    for (int i = 0; i < 3; i++) {
+        long most = BENCH_TURN_RUN / (FOSSIL_TIMER_WHEEL_SLOTS - 1 + i);
+        turn_ok = turn_ok && counts[i] >= most - 1 && counts[i] <= most;
+    }
+    if (turn_early < 0) {
+        fprintf(stderr, "cannot create the wheel for the turn check\n");
+    } else {
+        printf("period %d/%d/%d ticks fired %ld/%ld/%ld times, %ld of %d chained early\n", FOSSIL_TIMER_WHEEL_SLOTS - 1,
+               FOSSIL_TIMER_WHEEL_SLOTS, FOSSIL_TIMER_WHEEL_SLOTS + 1, counts[0], counts[1], counts[2], turn_early,
+               BENCH_TURN_CHAIN);
+    }
+
+    FILE* json = fopen(json_path, "w");
+    if (json == cnullptr) {
+        fprintf(stderr, "cannot open %s\n", json_path);
+        return 1;
+    }
+    fprintf(json, "{\n  \"benchmark\": \"timer\",\n  \"tick_us\": %ld,\n  \"pending\": %ld,\n", tick_us, count);
+    fprintf(json, "  \"ns_per_op\": {\"start\": %.3f, \"move\": %.3f, \"cancel\": %.3f},\n", best.start, best.move, best.cancel);
+    fprintf(json, "  \"fired\": %ld,\n  \"late_us\": {\"p50\": %.1f, \"p99\": %.1f, \"max\": %.1f},\n  \"early\": %ld,\n",
+            fire, p50, p99, max, early);
+    fprintf(json, "  \"turns\": {\"periodic\": [%ld, %ld, %ld], \"chained_early\": %ld}\n}\n", counts[0], counts[1], counts[2],
+            turn_early);
+    fclose(json);
+
+    fossil_timer_wheel_erase(&wheel);
+    fossil_thread_pool_erase(&pool);
+    free(timers);
+    free(firings);
+    free(late);
+    return early == 0 && turn_ok ? 0 : 1;
+}
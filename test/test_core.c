@@ -12,6 +12,7 @@ Description:
 */
 #include <fossil/core/arguments.h>
 #include <fossil/core/bitwise.h>
+#include <fossil/core/bitmap.h>
 #include <fossil/core/command.h>
 #include <fossil/core/datetime.h>
 #include <fossil/core/filesystem.h>
@@ -198,6 +199,152 @@ FOSSIL_TEST(test_fossil_binary_toggle_bits) {
     ASSUME_ITS_EQUAL_U64(0xFFFFFFFFFFFFFFF0, fossil_binary_toggle_bits64(0x000000000000000F));
 }
 
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test bitmap containers
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_FIXTURE(core_bitmap_fixture);
+fossil_bitmap_t* mock_bitmap;
+
+FOSSIL_SETUP(core_bitmap_fixture) {
+    mock_bitmap = fossil_bitmap_create();
+}
+
+FOSSIL_TEARDOWN(core_bitmap_fixture) {
+    fossil_bitmap_erase(mock_bitmap);
+}
+
+FOSSIL_TEST(test_bitset_set_and_rank) {
+    fossil_bitset_t* bitset = fossil_bitset_create(0);
+    for (size_t i = 0; i < 1000; i += 3) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_bitset_set(bitset, i));
+    }
+
+    ASSUME_ITS_EQUAL_SIZE(334, fossil_bitset_count(bitset));
+    ASSUME_ITS_TRUE(fossil_bitset_test(bitset, 999));
+    ASSUME_ITS_FALSE(fossil_bitset_test(bitset, 998));
+    ASSUME_ITS_EQUAL_SIZE(4, fossil_bitset_rank(bitset, 10));
+
+    size_t index = 0;
+    ASSUME_ITS_TRUE(fossil_bitset_select(bitset, 4, &index));
+    ASSUME_ITS_EQUAL_SIZE(12, index);
+    ASSUME_ITS_TRUE(fossil_bitset_next(bitset, 13, &index));
+    ASSUME_ITS_EQUAL_SIZE(15, index);
+
+    fossil_bitset_erase(bitset);
+}
+
+FOSSIL_TEST(test_bitset_algebra) {
+    fossil_bitset_t* threes = fossil_bitset_create(0);
+    fossil_bitset_t* fives = fossil_bitset_create(0);
+    for (size_t i = 0; i < 300; i += 3) fossil_bitset_set(threes, i);
+    for (size_t i = 0; i < 300; i += 5) fossil_bitset_set(fives, i);
+
+    fossil_bitset_and(threes, fives);
+    ASSUME_ITS_EQUAL_SIZE(20, fossil_bitset_count(threes));
+    fossil_bitset_or(threes, fives);
+    ASSUME_ITS_EQUAL_SIZE(60, fossil_bitset_count(threes));
+    fossil_bitset_andnot(threes, fives);
+    ASSUME_ITS_EQUAL_SIZE(0, fossil_bitset_count(threes));
+
+    fossil_bitset_erase(threes);
+    fossil_bitset_erase(fives);
+}
+
+FOSSIL_TEST(test_bitmap_add_and_contains) {
+    ASSUME_ITS_EQUAL_I32(0, fossil_bitmap_add(mock_bitmap, 7));
+    ASSUME_ITS_EQUAL_I32(0, fossil_bitmap_add(mock_bitmap, 70000));
+    ASSUME_ITS_EQUAL_I32(0, fossil_bitmap_add(mock_bitmap, 7));
+
+    ASSUME_ITS_EQUAL_U64(2, fossil_bitmap_cardinality(mock_bitmap));
+    ASSUME_ITS_TRUE(fossil_bitmap_contains(mock_bitmap, 70000));
+    ASSUME_ITS_FALSE(fossil_bitmap_contains(mock_bitmap, 8));
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_bitmap_remove(mock_bitmap, 7));
+    ASSUME_ITS_EQUAL_I32(-1, fossil_bitmap_remove(mock_bitmap, 7));
+    ASSUME_ITS_EQUAL_U64(1, fossil_bitmap_cardinality(mock_bitmap));
+}
+
+FOSSIL_TEST(test_bitmap_containers) {
+    // Sparse chunk stays an array, dense chunk becomes a bitset, range becomes runs
+    fossil_bitmap_add(mock_bitmap, 1);
+    for (uint32_t i = 0; i < 10000; ++i) {
+        fossil_bitmap_add(mock_bitmap, 65536 + i * 2);
+    }
+    fossil_bitmap_add_range(mock_bitmap, 131072, 196607);
+
+    ASSUME_ITS_EQUAL_SIZE(3, mock_bitmap->size);
+    ASSUME_ITS_EQUAL_I32(FOSSIL_BITMAP_ARRAY, mock_bitmap->containers[0].kind);
+    ASSUME_ITS_EQUAL_I32(FOSSIL_BITMAP_BITSET, mock_bitmap->containers[1].kind);
+    ASSUME_ITS_EQUAL_I32(FOSSIL_BITMAP_RUN, mock_bitmap->containers[2].kind);
+    ASSUME_ITS_EQUAL_U64(1 + 10000 + 65536, fossil_bitmap_cardinality(mock_bitmap));
+    ASSUME_ITS_TRUE(fossil_bitmap_contains(mock_bitmap, 150000));
+}
+
+FOSSIL_TEST(test_bitmap_algebra) {
+    fossil_bitmap_t* other = fossil_bitmap_create();
+    fossil_bitmap_add_range(mock_bitmap, 0, 99999);
+    for (uint32_t i = 50000; i < 150000; i += 10) {
+        fossil_bitmap_add(other, i);
+    }
+
+    fossil_bitmap_t* both = fossil_bitmap_and(mock_bitmap, other);
+    fossil_bitmap_t* either = fossil_bitmap_or(mock_bitmap, other);
+    fossil_bitmap_t* one = fossil_bitmap_xor(mock_bitmap, other);
+    fossil_bitmap_t* left = fossil_bitmap_andnot(mock_bitmap, other);
+
+    ASSUME_ITS_EQUAL_U64(5000, fossil_bitmap_cardinality(both));
+    ASSUME_ITS_EQUAL_U64(105000, fossil_bitmap_cardinality(either));
+    ASSUME_ITS_EQUAL_U64(100000, fossil_bitmap_cardinality(one));
+    ASSUME_ITS_EQUAL_U64(95000, fossil_bitmap_cardinality(left));
+
+    fossil_bitmap_erase(both);
+    fossil_bitmap_erase(either);
+    fossil_bitmap_erase(one);
+    fossil_bitmap_erase(left);
+    fossil_bitmap_erase(other);
+}
+
+FOSSIL_TEST(test_bitmap_rank_select_iterate) {
+    uint32_t values[] = {3, 9, 65540, 1000000};
+    for (size_t i = 0; i < 4; ++i) {
+        fossil_bitmap_add(mock_bitmap, values[i]);
+    }
+
+    ASSUME_ITS_EQUAL_U64(2, fossil_bitmap_rank(mock_bitmap, 65539));
+    ASSUME_ITS_EQUAL_U64(3, fossil_bitmap_rank(mock_bitmap, 65540));
+
+    uint32_t value = 0;
+    ASSUME_ITS_TRUE(fossil_bitmap_select(mock_bitmap, 3, &value));
+    ASSUME_ITS_EQUAL_U32(1000000, value);
+    ASSUME_ITS_FALSE(fossil_bitmap_select(mock_bitmap, 4, &value));
+
+    fossil_bitmap_iterator_t it = fossil_bitmap_iterator_create(mock_bitmap);
+    size_t count = 0;
+    while (fossil_bitmap_iterator_next(&it, &value)) {
+        ASSUME_ITS_EQUAL_U32(values[count], value);
+        count++;
+    }
+    ASSUME_ITS_EQUAL_SIZE(4, count);
+}
+
+FOSSIL_TEST(test_bitmap_serialize) {
+    fossil_bitmap_add_range(mock_bitmap, 10, 200000);
+    fossil_bitmap_add(mock_bitmap, 4000000);
+
+    size_t size = fossil_bitmap_serialized_size(mock_bitmap);
+    uint8_t* buffer = (uint8_t*)malloc(size);
+    ASSUME_ITS_EQUAL_SIZE(size, fossil_bitmap_serialize(mock_bitmap, buffer, size));
+
+    fossil_bitmap_t* loaded = fossil_bitmap_deserialize(buffer, size);
+    ASSUME_NOT_CNULL(loaded);
+    ASSUME_ITS_TRUE(fossil_bitmap_equals(mock_bitmap, loaded));
+    ASSUME_ITS_CNULL(fossil_bitmap_deserialize(buffer, size - 1));
+
+    fossil_bitmap_erase(loaded);
+    free(buffer);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test host system
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -537,6 +684,15 @@ FOSSIL_TEST_GROUP(c_core_tests) {
     ADD_TESTF(test_fossil_binary_right_shift, core_bitwise_fixture);
     ADD_TESTF(test_fossil_binary_toggle_bits, core_bitwise_fixture);
 
+    // Core Bitmap Fixture
+    ADD_TESTF(test_bitset_set_and_rank, core_bitmap_fixture);
+    ADD_TESTF(test_bitset_algebra, core_bitmap_fixture);
+    ADD_TESTF(test_bitmap_add_and_contains, core_bitmap_fixture);
+    ADD_TESTF(test_bitmap_containers, core_bitmap_fixture);
+    ADD_TESTF(test_bitmap_algebra, core_bitmap_fixture);
+    ADD_TESTF(test_bitmap_rank_select_iterate, core_bitmap_fixture);
+    ADD_TESTF(test_bitmap_serialize, core_bitmap_fixture);
+
     // Core Host System Fixture
     ADD_TESTF(test_fossil_hostsys_get, core_hostsystem_fixture);
     ADD_TESTF(test_fossil_hostsys_endian, core_hostsystem_fixture);
@@ -10,11 +10,17 @@ Description:
     feel free to contact Michael at michaelbrockus@gmail.com.
 ==============================================================================
 */
+#include <fossil/structure/cache.h>
 #include <fossil/structure/dlist.h>
 #include <fossil/structure/dqueue.h>
+#include <fossil/structure/flatmap.h>
+#include <fossil/structure/flatset.h>
 #include <fossil/structure/flist.h>
+#include <fossil/structure/intrusive.h>
 #include <fossil/structure/pqueue.h>
+#include <fossil/structure/pvector.h>
 #include <fossil/structure/queue.h>
+#include <fossil/structure/serialize.h>
 #include <fossil/structure/set.h>
 #include <fossil/structure/stack.h>
 #include <fossil/structure/vector.h>
@@ -141,6 +147,76 @@ FOSSIL_TEST(test_dlist_reverse_backward) {
     ASSUME_ITS_EQUAL_I32(5, retrievedElement->value.int_val);
 }
 
+FOSSIL_TEST(test_dlist_unrolled_insert_at_and_remove_at) {
+    fossil_dlist_t* dlist = fossil_dlist_create_unrolled("int");
+    ASSUME_NOT_CNULL(dlist);
+
+    // Append 0..99 at the tail, then splice -1 into the middle of a full block
+    for (int64_t i = 0; i < 100; ++i) {
+        fossil_tofu_t element = fossil_tofu_create("int", "0");
+        element.value.int_val = i;
+        ASSUME_ITS_EQUAL_I32(0, fossil_dlist_insert(dlist, element));
+    }
+    ASSUME_ITS_EQUAL_I32(0, fossil_dlist_insert_at(dlist, 20, fossil_tofu_create("int", "-1")));
+    ASSUME_ITS_EQUAL_SIZE(101, fossil_dlist_size(dlist));
+    ASSUME_NOT_CNULL(fossil_dlist_getter(dlist, fossil_tofu_create("int", "-1")));
+
+    fossil_tofu_t removed;
+    ASSUME_ITS_EQUAL_I32(0, fossil_dlist_remove_at(dlist, 20, &removed));
+    ASSUME_ITS_EQUAL_I32(-1, removed.value.int_val);
+
+    // Reversed, the tail holds the oldest element
+    fossil_dlist_reverse_backward(dlist);
+    for (int64_t i = 0; i < 100; ++i) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_dlist_remove(dlist, &removed));
+        ASSUME_ITS_EQUAL_I32(i, removed.value.int_val);
+    }
+    ASSUME_ITS_TRUE(fossil_dlist_is_empty(dlist));
+    fossil_dlist_erase(dlist);
+}
+
+FOSSIL_TEST(test_dlist_unrolled_cursor_walk) {
+    fossil_dlist_t* dlist = fossil_dlist_create_unrolled("int");
+    ASSUME_NOT_CNULL(dlist);
+    for (int64_t i = 0; i < 40; ++i) {
+        fossil_tofu_t element = fossil_tofu_create("int", "0");
+        element.value.int_val = i;
+        ASSUME_ITS_EQUAL_I32(0, fossil_dlist_insert(dlist, element));
+    }
+
+    // The span covers the rest of the cursor's block
+    fossil_dlist_cursor_t cursor = fossil_dlist_cursor_begin(dlist);
+    fossil_tofu_iteratorof_t span = fossil_dlist_cursor_span(&cursor);
+    ASSUME_ITS_TRUE(span.size >= 1 && span.size <= FOSSIL_DLIST_BLOCK_SIZE);
+    ASSUME_ITS_EQUAL_I32(0, span.array[0].value.int_val);
+
+    // Erase the even elements in place and tag each odd one with a follower
+    fossil_tofu_t removed;
+    while (fossil_dlist_cursor_valid(&cursor)) {
+        if (fossil_dlist_cursor_deref(&cursor)->value.int_val % 2 == 0) {
+            ASSUME_ITS_EQUAL_I32(0, fossil_dlist_cursor_erase(&cursor, &removed));
+            continue;
+        }
+        ASSUME_ITS_EQUAL_I32(0, fossil_dlist_cursor_insert_after(&cursor, fossil_tofu_create("int", "-1")));
+        fossil_dlist_cursor_next(&cursor);
+        fossil_dlist_cursor_next(&cursor);
+    }
+    ASSUME_ITS_EQUAL_I32(-1, fossil_dlist_cursor_erase(&cursor, &removed));
+    ASSUME_ITS_EQUAL_SIZE(40, fossil_dlist_size(dlist));
+
+    // Walking backwards from the end visits -1, 39, -1, 37, ...
+    cursor = fossil_dlist_cursor_end(dlist);
+    for (int64_t i = 39; i > 0; i -= 2) {
+        fossil_dlist_cursor_prev(&cursor);
+        ASSUME_ITS_EQUAL_I32(-1, fossil_dlist_cursor_deref(&cursor)->value.int_val);
+        fossil_dlist_cursor_prev(&cursor);
+        ASSUME_ITS_EQUAL_I32(i, fossil_dlist_cursor_deref(&cursor)->value.int_val);
+    }
+    fossil_dlist_cursor_prev(&cursor);
+    ASSUME_ITS_FALSE(fossil_dlist_cursor_valid(&cursor));
+    fossil_dlist_erase(dlist);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Double Queue
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -348,6 +424,37 @@ FOSSIL_TEST(test_flist_reverse_backward) {
     ASSUME_ITS_EQUAL_I32(42, retrievedElement->value.int_val);
 }
 
+FOSSIL_TEST(test_flist_unrolled_insert_at_and_remove_at) {
+    fossil_flist_t* flist = fossil_flist_create_unrolled("int");
+    ASSUME_NOT_CNULL(flist);
+    ASSUME_ITS_TRUE(fossil_flist_is_empty(flist));
+
+    // Push 0..99 onto the head, then splice -1 into the middle of a full block
+    for (int64_t i = 0; i < 100; ++i) {
+        fossil_tofu_t element = fossil_tofu_create("int", "0");
+        element.value.int_val = i;
+        ASSUME_ITS_EQUAL_I32(0, fossil_flist_insert(flist, element));
+    }
+    ASSUME_ITS_EQUAL_I32(0, fossil_flist_insert_at(flist, 50, fossil_tofu_create("int", "-1")));
+    ASSUME_ITS_EQUAL_I32(-1, fossil_flist_insert_at(flist, 102, fossil_tofu_create("int", "-1")));
+    ASSUME_ITS_EQUAL_SIZE(101, fossil_flist_size(flist));
+    ASSUME_ITS_TRUE(fossil_flist_search(flist, fossil_tofu_create("int", "-1")) == 0);
+
+    fossil_tofu_t removed;
+    ASSUME_ITS_EQUAL_I32(0, fossil_flist_remove_at(flist, 50, &removed));
+    ASSUME_ITS_EQUAL_I32(-1, removed.value.int_val);
+    ASSUME_ITS_EQUAL_I32(-1, fossil_flist_remove_at(flist, 100, &removed));
+
+    // Reversed, the head holds the oldest element again
+    fossil_flist_reverse_forward(flist);
+    for (int64_t i = 0; i < 100; ++i) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_flist_remove(flist, &removed));
+        ASSUME_ITS_EQUAL_I32(i, removed.value.int_val);
+    }
+    ASSUME_ITS_TRUE(fossil_flist_is_empty(flist));
+    fossil_flist_erase(flist);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Priority Queue
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -417,6 +524,79 @@ FOSSIL_TEST(test_pqueue_not_empty_and_is_empty) {
     ASSUME_ITS_TRUE(fossil_pqueue_remove(mock_pqueue, &removedElement, removedPriority));
 }
 
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Persistent Vector
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_FIXTURE(struct_pvector_fixture);
+fossil_pvector_t* mock_pvector;
+
+FOSSIL_SETUP(struct_pvector_fixture) {
+    mock_pvector = fossil_pvector_create("int");
+}
+
+FOSSIL_TEARDOWN(struct_pvector_fixture) {
+    fossil_pvector_erase(mock_pvector);
+}
+
+FOSSIL_TEST(test_pvector_versions_share_nodes) {
+    fossil_pvector_t* first = fossil_pvector_push_back(mock_pvector, fossil_tofu_create("int", "1"));
+    ASSUME_NOT_CNULL(first);
+    fossil_pvector_t* second = fossil_pvector_set(first, 0, fossil_tofu_create("int", "2"));
+    ASSUME_NOT_CNULL(second);
+
+    // Older versions keep their contents
+    ASSUME_ITS_EQUAL_SIZE(0, fossil_pvector_size(mock_pvector));
+    ASSUME_ITS_EQUAL_I32(1, fossil_pvector_getter(first, 0)->value.int_val);
+    ASSUME_ITS_EQUAL_I32(2, fossil_pvector_getter(second, 0)->value.int_val);
+    ASSUME_ITS_CNULL(fossil_pvector_set(first, 1, fossil_tofu_create("int", "3")));
+    ASSUME_ITS_CNULL(fossil_pvector_pop_back(mock_pvector));
+
+    // A snapshot shares the trie until one side is updated
+    fossil_pvector_t* snapshot = fossil_pvector_snapshot(second);
+    ASSUME_ITS_TRUE(snapshot->tail == second->tail);
+    fossil_pvector_t* popped = fossil_pvector_pop_back(snapshot);
+    ASSUME_ITS_TRUE(fossil_pvector_is_empty(popped));
+    ASSUME_ITS_EQUAL_I32(2, fossil_pvector_getter(snapshot, 0)->value.int_val);
+
+    fossil_pvector_erase(popped);
+    fossil_pvector_erase(snapshot);
+    fossil_pvector_erase(second);
+    fossil_pvector_erase(first);
+}
+
+FOSSIL_TEST(test_pvector_transient_batch) {
+    fossil_pvector_t* transient = fossil_pvector_transient(mock_pvector);
+    ASSUME_NOT_CNULL(transient);
+    for (int64_t i = 0; i < 2000; ++i) {
+        fossil_tofu_t element = fossil_tofu_create("int", "0");
+        element.value.int_val = i;
+        ASSUME_ITS_EQUAL_I32(0, fossil_pvector_transient_push_back(transient, element));
+    }
+    fossil_pvector_persistent(transient);
+    ASSUME_ITS_EQUAL_I32(-1, fossil_pvector_transient_push_back(transient, fossil_tofu_create("int", "0")));
+
+    // Updating a copy leaves the original batch untouched
+    fossil_pvector_t* copy = fossil_pvector_transient(transient);
+    ASSUME_ITS_EQUAL_I32(0, fossil_pvector_transient_set(copy, 1500, fossil_tofu_create("int", "-1")));
+    fossil_tofu_t removed;
+    ASSUME_ITS_EQUAL_I32(0, fossil_pvector_transient_pop_back(copy, &removed));
+    ASSUME_ITS_EQUAL_I32(1999, removed.value.int_val);
+    ASSUME_ITS_EQUAL_I32(-1, fossil_pvector_getter(copy, 1500)->value.int_val);
+    ASSUME_ITS_EQUAL_I32(1500, fossil_pvector_getter(transient, 1500)->value.int_val);
+
+    // Spans walk whole leaves
+    size_t total = 0;
+    for (size_t i = 0; i < fossil_pvector_size(transient); i += fossil_pvector_span(transient, i).size) {
+        ASSUME_ITS_EQUAL_I32((int32_t)i, fossil_pvector_span(transient, i).array[0].value.int_val);
+        total += fossil_pvector_span(transient, i).size;
+    }
+    ASSUME_ITS_EQUAL_SIZE(2000, total);
+
+    fossil_pvector_erase(copy);
+    fossil_pvector_erase(transient);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Queue
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -494,6 +674,28 @@ FOSSIL_TEST(test_queue_not_empty_and_is_empty) {
     fossil_tofu_erase(&element);
 }
 
+FOSSIL_TEST(test_queue_cursor_insert_after_and_erase) {
+    fossil_queue_insert(mock_queue, fossil_tofu_create("int", "1"));
+    fossil_queue_insert(mock_queue, fossil_tofu_create("int", "3"));
+
+    // Insert after the rear, then erase the front through the cursor
+    fossil_queue_cursor_t cursor = fossil_queue_cursor_begin(mock_queue);
+    fossil_queue_cursor_next(&cursor);
+    ASSUME_ITS_EQUAL_I32(0, fossil_queue_cursor_insert_after(&cursor, fossil_tofu_create("int", "4")));
+    ASSUME_ITS_EQUAL_I32(4, mock_queue->rear->data.value.int_val);
+
+    cursor = fossil_queue_cursor_begin(mock_queue);
+    fossil_tofu_t removed;
+    ASSUME_ITS_EQUAL_I32(0, fossil_queue_cursor_erase(&cursor, &removed));
+    ASSUME_ITS_EQUAL_I32(1, removed.value.int_val);
+    ASSUME_ITS_EQUAL_I32(3, fossil_queue_cursor_deref(&cursor)->value.int_val);
+
+    cursor = fossil_queue_cursor_end(mock_queue);
+    ASSUME_ITS_EQUAL_I32(-1, fossil_queue_cursor_insert_after(&cursor, fossil_tofu_create("int", "5")));
+    ASSUME_ITS_EQUAL_SIZE(0, fossil_queue_cursor_span(&cursor).size);
+    ASSUME_ITS_EQUAL_SIZE(2, fossil_queue_size(mock_queue));
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Set
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -638,6 +840,82 @@ FOSSIL_TEST(test_stack_remove) {
     fossil_tofu_erase(&element3);
 }
 
+FOSSIL_TEST(test_stack_array_push_pop_and_peek) {
+    fossil_stack_t* stack = fossil_stack_create_array("int");
+    ASSUME_NOT_CNULL(stack);
+    ASSUME_ITS_EQUAL_I32(0, fossil_stack_reserve(stack, 64));
+    ASSUME_ITS_EQUAL_SIZE(64, fossil_stack_capacity(stack));
+
+    fossil_tofu_t elements[3] = {
+        fossil_tofu_create("int", "1"),
+        fossil_tofu_create("int", "2"),
+        fossil_tofu_create("int", "3")
+    };
+    ASSUME_ITS_EQUAL_I32(0, fossil_stack_push_n(stack, elements, 3));
+    ASSUME_ITS_EQUAL_I32(0, fossil_stack_insert(stack, fossil_tofu_create("int", "4")));
+    ASSUME_ITS_EQUAL_SIZE(4, fossil_stack_size(stack));
+
+    fossil_tofu_t peeked;
+    ASSUME_ITS_EQUAL_I32(0, fossil_stack_peek(stack, 1, &peeked));
+    ASSUME_ITS_EQUAL_I32(3, peeked.value.int_val);
+    ASSUME_ITS_EQUAL_I32(-1, fossil_stack_peek(stack, 4, &peeked));
+    ASSUME_ITS_EQUAL_I32(4, fossil_stack_top(stack, peeked).value.int_val);
+
+    // A cursor span starts at the cursor element, like every other container's
+    fossil_stack_cursor_t cursor = fossil_stack_cursor_begin(stack);
+    fossil_tofu_iteratorof_t span = fossil_stack_cursor_span(&cursor);
+    ASSUME_ITS_EQUAL_SIZE(1, span.size);
+    ASSUME_ITS_EQUAL_I32(4, span.array[0].value.int_val);
+    fossil_stack_cursor_next(&cursor);
+    ASSUME_ITS_EQUAL_I32(3, fossil_stack_cursor_span(&cursor).array[0].value.int_val);
+
+    // Popped spans come out top first
+    fossil_tofu_t popped[4];
+    ASSUME_ITS_EQUAL_I32(-1, fossil_stack_pop_n(stack, popped, 5));
+    ASSUME_ITS_EQUAL_I32(0, fossil_stack_pop_n(stack, popped, 4));
+    ASSUME_ITS_EQUAL_I32(4, popped[0].value.int_val);
+    ASSUME_ITS_EQUAL_I32(1, popped[3].value.int_val);
+    ASSUME_ITS_TRUE(fossil_stack_is_empty(stack));
+    fossil_stack_erase(stack);
+}
+
+FOSSIL_TEST(test_stack_fixed_capacity) {
+    fossil_tofu_t buffer[2];
+    fossil_stack_t* stack = fossil_stack_create_fixed("int", buffer, 2);
+    ASSUME_NOT_CNULL(stack);
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_stack_insert(stack, fossil_tofu_create("int", "7")));
+    ASSUME_ITS_EQUAL_I32(0, fossil_stack_insert(stack, fossil_tofu_create("int", "8")));
+    ASSUME_ITS_EQUAL_I32(-1, fossil_stack_insert(stack, fossil_tofu_create("int", "9")));
+    ASSUME_ITS_EQUAL_I32(-1, fossil_stack_reserve(stack, 3));
+    ASSUME_ITS_EQUAL_SIZE(2, fossil_stack_size(stack));
+    ASSUME_ITS_TRUE(fossil_stack_search(stack, fossil_tofu_create("int", "7")) == 0);
+
+    fossil_tofu_t removed;
+    ASSUME_ITS_EQUAL_I32(0, fossil_stack_remove(stack, &removed));
+    ASSUME_ITS_EQUAL_I32(8, removed.value.int_val);
+    ASSUME_ITS_EQUAL_I32(8, buffer[1].value.int_val);
+    fossil_stack_erase(stack);
+}
+
+FOSSIL_TEST(test_stack_linked_peek_and_spans) {
+    fossil_tofu_t elements[2] = {
+        fossil_tofu_create("int", "5"),
+        fossil_tofu_create("int", "6")
+    };
+    ASSUME_ITS_EQUAL_I32(0, fossil_stack_push_n(mock_stack, elements, 2));
+
+    fossil_tofu_t peeked;
+    ASSUME_ITS_EQUAL_I32(0, fossil_stack_peek(mock_stack, 0, &peeked));
+    ASSUME_ITS_EQUAL_I32(6, peeked.value.int_val);
+
+    fossil_tofu_t popped[2];
+    ASSUME_ITS_EQUAL_I32(0, fossil_stack_pop_n(mock_stack, popped, 2));
+    ASSUME_ITS_EQUAL_I32(6, popped[0].value.int_val);
+    ASSUME_ITS_EQUAL_I32(5, popped[1].value.int_val);
+    ASSUME_ITS_TRUE(fossil_stack_is_empty(mock_stack));
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Vector
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -699,6 +977,611 @@ FOSSIL_TEST(test_vector_search) {
     fossil_tofu_erase(&element3);
 }
 
+FOSSIL_TEST(test_vector_reserve_and_shrink) {
+    // Reserving the final size means pushing never reallocates
+    ASSUME_ITS_EQUAL_I32(0, fossil_vector_reserve(mock_vector, 100));
+    fossil_tofu_t* data = mock_vector->data;
+    for (int i = 0; i < 100; ++i) {
+        fossil_vector_push_back(mock_vector, fossil_tofu_create("int", "7"));
+    }
+    ASSUME_ITS_TRUE(data == mock_vector->data);
+    ASSUME_ITS_EQUAL_SIZE(100, fossil_vector_capacity(mock_vector));
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_vector_remove_range(mock_vector, 10, 80));
+    ASSUME_ITS_EQUAL_I32(0, fossil_vector_shrink_to_fit(mock_vector));
+    ASSUME_ITS_EQUAL_SIZE(20, fossil_vector_capacity(mock_vector));
+}
+
+FOSSIL_TEST(test_vector_insert_and_remove) {
+    fossil_tofu_t elements[3] = {
+        fossil_tofu_create("int", "1"),
+        fossil_tofu_create("int", "2"),
+        fossil_tofu_create("int", "3")
+    };
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_vector_append(mock_vector, elements, 3));
+    ASSUME_ITS_EQUAL_I32(0, fossil_vector_insert(mock_vector, 1, fossil_tofu_create("int", "9")));
+    ASSUME_ITS_EQUAL_I32(0, fossil_vector_insert_range(mock_vector, 0, elements, 2));
+    ASSUME_ITS_EQUAL_I32(-1, fossil_vector_insert(mock_vector, 42, elements[0]));
+
+    // 1 2 1 9 2 3
+    ASSUME_ITS_EQUAL_SIZE(6, fossil_vector_size(mock_vector));
+    ASSUME_ITS_EQUAL_I32(9, mock_vector->data[3].value.int_val);
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_vector_remove_at(mock_vector, 3));
+    ASSUME_ITS_EQUAL_I32(0, fossil_vector_remove_range(mock_vector, 0, 2));
+    ASSUME_ITS_EQUAL_I32(-1, fossil_vector_remove_range(mock_vector, 2, 5));
+
+    // 1 2 3
+    ASSUME_ITS_EQUAL_SIZE(3, fossil_vector_size(mock_vector));
+    ASSUME_ITS_EQUAL_I32(1, mock_vector->data[0].value.int_val);
+    ASSUME_ITS_EQUAL_I32(3, mock_vector->data[2].value.int_val);
+}
+
+FOSSIL_TEST(test_vector_resize_and_growth) {
+    ASSUME_ITS_EQUAL_I32(-1, fossil_vector_set_growth_factor(mock_vector, 1.0));
+    ASSUME_ITS_EQUAL_I32(0, fossil_vector_set_growth_factor(mock_vector, 1.5));
+
+    fossil_vector_push_back(mock_vector, fossil_tofu_create("int", "1"));
+    ASSUME_ITS_EQUAL_SIZE(INITIAL_CAPACITY, fossil_vector_capacity(mock_vector));
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_vector_resize(mock_vector, 11, fossil_tofu_create("int", "5")));
+    ASSUME_ITS_EQUAL_SIZE(11, fossil_vector_size(mock_vector));
+    ASSUME_ITS_EQUAL_I32(5, mock_vector->data[10].value.int_val);
+
+    fossil_vector_push_back(mock_vector, fossil_tofu_create("int", "1"));
+    ASSUME_ITS_EQUAL_SIZE(16, fossil_vector_capacity(mock_vector));
+}
+
+FOSSIL_TEST(test_vector_cursor_span_and_erase) {
+    for (int64_t i = 0; i < 5; ++i) {
+        fossil_tofu_t element = fossil_tofu_create("int", "0");
+        element.value.int_val = i;
+        fossil_vector_push_back(mock_vector, element);
+    }
+
+    fossil_vector_cursor_t cursor = fossil_vector_cursor_begin(mock_vector);
+    fossil_vector_cursor_next(&cursor);
+    fossil_tofu_iteratorof_t span = fossil_vector_cursor_span(&cursor);
+    ASSUME_ITS_EQUAL_SIZE(4, span.size);
+    ASSUME_ITS_EQUAL_I32(1, span.array[0].value.int_val);
+
+    fossil_tofu_t removed;
+    ASSUME_ITS_EQUAL_I32(0, fossil_vector_cursor_erase(&cursor, &removed));
+    ASSUME_ITS_EQUAL_I32(1, removed.value.int_val);
+    ASSUME_ITS_EQUAL_I32(2, fossil_vector_cursor_deref(&cursor)->value.int_val);
+    ASSUME_ITS_EQUAL_I32(0, fossil_vector_cursor_insert_after(&cursor, fossil_tofu_create("int", "9")));
+    ASSUME_ITS_EQUAL_I32(9, mock_vector->data[2].value.int_val);
+
+    fossil_vector_cursor_prev(&cursor);
+    fossil_vector_cursor_prev(&cursor);
+    ASSUME_ITS_FALSE(fossil_vector_cursor_valid(&cursor));
+    ASSUME_ITS_CNULL(fossil_vector_cursor_deref(&cursor));
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Flat Set and Map
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_FIXTURE(struct_flat_fixture);
+fossil_flatset_t* mock_flatset;
+fossil_flatmap_t* mock_flatmap;
+
+FOSSIL_SETUP(struct_flat_fixture) {
+    mock_flatset = fossil_flatset_create("int");
+    mock_flatmap = fossil_flatmap_create("int");
+}
+
+FOSSIL_TEARDOWN(struct_flat_fixture) {
+    fossil_flatset_erase(mock_flatset);
+    fossil_flatmap_erase(mock_flatmap);
+}
+
+FOSSIL_TEST(test_flatset_insert_and_search) {
+    ASSUME_ITS_EQUAL_I32(0, fossil_flatset_insert(mock_flatset, fossil_tofu_create("int", "42")));
+    ASSUME_ITS_EQUAL_I32(0, fossil_flatset_insert(mock_flatset, fossil_tofu_create("int", "-7")));
+    ASSUME_ITS_EQUAL_I32(0, fossil_flatset_insert(mock_flatset, fossil_tofu_create("int", "10")));
+    ASSUME_ITS_EQUAL_I32(-1, fossil_flatset_insert(mock_flatset, fossil_tofu_create("int", "10")));
+
+    // Elements are kept in ascending order
+    ASSUME_ITS_EQUAL_SIZE(3, fossil_flatset_size(mock_flatset));
+    ASSUME_ITS_EQUAL_I32(-7, fossil_flatset_getter(mock_flatset, 0)->value.int_val);
+    ASSUME_ITS_EQUAL_I32(10, fossil_flatset_getter(mock_flatset, 1)->value.int_val);
+    ASSUME_ITS_EQUAL_I32(42, fossil_flatset_getter(mock_flatset, 2)->value.int_val);
+
+    ASSUME_ITS_EQUAL_I32(2, fossil_flatset_search(mock_flatset, fossil_tofu_create("int", "42")));
+    ASSUME_ITS_EQUAL_I32(-1, fossil_flatset_search(mock_flatset, fossil_tofu_create("int", "11")));
+    ASSUME_ITS_EQUAL_SIZE(2, fossil_flatset_lower_bound(mock_flatset, fossil_tofu_create("int", "11")));
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_flatset_remove(mock_flatset, fossil_tofu_create("int", "10")));
+    ASSUME_ITS_EQUAL_I32(-1, fossil_flatset_remove(mock_flatset, fossil_tofu_create("int", "10")));
+    ASSUME_ITS_FALSE(fossil_flatset_contains(mock_flatset, fossil_tofu_create("int", "10")));
+    ASSUME_ITS_TRUE(fossil_flatset_contains(mock_flatset, fossil_tofu_create("int", "-7")));
+}
+
+FOSSIL_TEST(test_flatset_create_from_and_layouts) {
+    // Unsorted input with duplicates: the odd numbers 1..199, each given twice
+    fossil_tofu_t elements[200];
+    for (size_t i = 0; i < 200; ++i) {
+        elements[i] = fossil_tofu_create("int", "0");
+        elements[i].value.int_val = (int64_t)(((i * 37) % 100) * 2 + 1);
+    }
+
+    fossil_flatset_t* set = fossil_flatset_create_from("int", elements, 200);
+    ASSUME_NOT_CNULL(set);
+    ASSUME_ITS_EQUAL_SIZE(100, fossil_flatset_size(set));
+
+    fossil_flatset_layout_t layouts[2] = { FOSSIL_FLATSET_SORTED, FOSSIL_FLATSET_EYTZINGER };
+    for (size_t layout = 0; layout < 2; ++layout) {
+        fossil_flatset_set_layout(set, layouts[layout]);
+        ASSUME_ITS_EQUAL_I32(0, fossil_flatset_reindex(set));
+        for (int64_t value = -1; value <= 201; ++value) {
+            fossil_tofu_t probe = fossil_tofu_create("int", "0");
+            probe.value.int_val = value;
+            int32_t expected = (value > 0 && value < 200 && value % 2 == 1) ? (int32_t)(value / 2) : -1;
+            ASSUME_ITS_EQUAL_I32(expected, fossil_flatset_search(set, probe));
+        }
+    }
+
+    // Keys of another type sort by type, before or after every int
+    ASSUME_ITS_EQUAL_SIZE(100, fossil_flatset_lower_bound(set, fossil_tofu_create("uint", "3")));
+    fossil_flatset_erase(set);
+}
+
+FOSSIL_TEST(test_flatset_strings_eytzinger) {
+    fossil_tofu_t elements[5] = {
+        fossil_tofu_create("cstr", "pear"),
+        fossil_tofu_create("cstr", "apple"),
+        fossil_tofu_create("cstr", "fig"),
+        fossil_tofu_create("cstr", "kiwi"),
+        fossil_tofu_create("cstr", "apple")
+    };
+    fossil_flatset_t* set = fossil_flatset_create_from("cstr", elements, 5);
+    fossil_flatset_set_layout(set, FOSSIL_FLATSET_EYTZINGER);
+
+    ASSUME_ITS_EQUAL_SIZE(4, fossil_flatset_size(set));
+    ASSUME_ITS_EQUAL_I32(0, fossil_flatset_search(set, elements[1]));
+    ASSUME_ITS_EQUAL_I32(2, fossil_flatset_search(set, elements[3]));
+    ASSUME_ITS_EQUAL_I32(3, fossil_flatset_search(set, elements[0]));
+    fossil_tofu_t missing = fossil_tofu_create("cstr", "plum");
+    ASSUME_ITS_FALSE(fossil_flatset_contains(set, missing));
+    fossil_tofu_erase(&missing);
+
+    fossil_flatset_erase(set);
+    for (size_t i = 0; i < 5; ++i) {
+        fossil_tofu_erase(&elements[i]);
+    }
+}
+
+FOSSIL_TEST(test_flatmap_insert_and_getter) {
+    ASSUME_ITS_EQUAL_I32(0, fossil_flatmap_insert(mock_flatmap, fossil_tofu_create("int", "3"), fossil_tofu_create("int", "30")));
+    ASSUME_ITS_EQUAL_I32(0, fossil_flatmap_insert(mock_flatmap, fossil_tofu_create("int", "1"), fossil_tofu_create("int", "10")));
+    ASSUME_ITS_EQUAL_I32(0, fossil_flatmap_insert(mock_flatmap, fossil_tofu_create("int", "2"), fossil_tofu_create("int", "20")));
+    ASSUME_ITS_EQUAL_I32(0, fossil_flatmap_insert(mock_flatmap, fossil_tofu_create("int", "1"), fossil_tofu_create("int", "11")));
+    ASSUME_ITS_EQUAL_SIZE(3, fossil_flatmap_size(mock_flatmap));
+
+    ASSUME_ITS_EQUAL_I32(11, fossil_flatmap_getter(mock_flatmap, fossil_tofu_create("int", "1"))->value.int_val);
+    ASSUME_ITS_EQUAL_I32(20, fossil_flatmap_getter(mock_flatmap, fossil_tofu_create("int", "2"))->value.int_val);
+    ASSUME_ITS_EQUAL_I32(30, fossil_flatmap_getter(mock_flatmap, fossil_tofu_create("int", "3"))->value.int_val);
+    ASSUME_ITS_CNULL(fossil_flatmap_getter(mock_flatmap, fossil_tofu_create("int", "4")));
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_flatmap_remove(mock_flatmap, fossil_tofu_create("int", "2")));
+    ASSUME_ITS_EQUAL_I32(-1, fossil_flatmap_remove(mock_flatmap, fossil_tofu_create("int", "2")));
+    ASSUME_ITS_FALSE(fossil_flatmap_contains(mock_flatmap, fossil_tofu_create("int", "2")));
+    ASSUME_ITS_EQUAL_I32(30, fossil_flatmap_getter(mock_flatmap, fossil_tofu_create("int", "3"))->value.int_val);
+}
+
+FOSSIL_TEST(test_flatmap_create_from) {
+    fossil_tofu_t keys[4] = {
+        fossil_tofu_create("int", "9"),
+        fossil_tofu_create("int", "4"),
+        fossil_tofu_create("int", "9"),
+        fossil_tofu_create("int", "1")
+    };
+    fossil_tofu_t values[4] = {
+        fossil_tofu_create("int", "90"),
+        fossil_tofu_create("int", "40"),
+        fossil_tofu_create("int", "99"),
+        fossil_tofu_create("int", "10")
+    };
+    fossil_flatmap_t* map = fossil_flatmap_create_from("int", keys, values, 4);
+    ASSUME_NOT_CNULL(map);
+    fossil_flatmap_set_layout(map, FOSSIL_FLATSET_EYTZINGER);
+
+    // The last pair for a duplicate key wins
+    ASSUME_ITS_EQUAL_SIZE(3, fossil_flatmap_size(map));
+    ASSUME_ITS_EQUAL_I32(99, fossil_flatmap_getter(map, keys[0])->value.int_val);
+    ASSUME_ITS_EQUAL_I32(40, fossil_flatmap_getter(map, keys[1])->value.int_val);
+    ASSUME_ITS_EQUAL_I32(10, fossil_flatmap_getter(map, keys[3])->value.int_val);
+    fossil_flatmap_erase(map);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cache
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_FIXTURE(struct_cache_fixture);
+fossil_cache_t* mock_cache;
+
+FOSSIL_SETUP(struct_cache_fixture) {
+    mock_cache = fossil_cache_create("int", FOSSIL_CACHE_LRU, 3);
+}
+
+FOSSIL_TEARDOWN(struct_cache_fixture) {
+    fossil_cache_erase(mock_cache);
+}
+
+static size_t test_cache_value_bytes(fossil_tofu_t key, fossil_tofu_t value, void* user_data) {
+    (void)key;
+    (void)user_data;
+    return (size_t)value.value.int_val;
+}
+
+static void test_cache_count_evictions(fossil_tofu_t key, fossil_tofu_t value, void* user_data) {
+    (void)key;
+    (void)value;
+    ++*(int*)user_data;
+}
+
+FOSSIL_TEST(test_cache_lru_eviction_order) {
+    fossil_cache_put(mock_cache, fossil_tofu_create("int", "1"), fossil_tofu_create("int", "10"));
+    fossil_cache_put(mock_cache, fossil_tofu_create("int", "2"), fossil_tofu_create("int", "20"));
+    fossil_cache_put(mock_cache, fossil_tofu_create("int", "3"), fossil_tofu_create("int", "30"));
+
+    // Using 1 makes 2 the least recently used entry
+    ASSUME_ITS_EQUAL_I32(10, fossil_cache_getter(mock_cache, fossil_tofu_create("int", "1"))->value.int_val);
+    fossil_cache_put(mock_cache, fossil_tofu_create("int", "4"), fossil_tofu_create("int", "40"));
+    ASSUME_ITS_FALSE(fossil_cache_contains(mock_cache, fossil_tofu_create("int", "2")));
+    ASSUME_ITS_TRUE(fossil_cache_contains(mock_cache, fossil_tofu_create("int", "1")));
+    ASSUME_ITS_CNULL(fossil_cache_getter(mock_cache, fossil_tofu_create("int", "2")));
+
+    fossil_cache_stats_t stats = fossil_cache_stats(mock_cache);
+    ASSUME_ITS_EQUAL_SIZE(1, stats.hits);
+    ASSUME_ITS_EQUAL_SIZE(1, stats.misses);
+    ASSUME_ITS_EQUAL_SIZE(4, stats.insertions);
+    ASSUME_ITS_EQUAL_SIZE(1, stats.evictions);
+
+    fossil_tofu_t removed;
+    ASSUME_ITS_EQUAL_I32(0, fossil_cache_remove(mock_cache, fossil_tofu_create("int", "3"), &removed));
+    ASSUME_ITS_EQUAL_I32(30, removed.value.int_val);
+    ASSUME_ITS_EQUAL_SIZE(2, fossil_cache_size(mock_cache));
+}
+
+FOSSIL_TEST(test_cache_clock_second_chance) {
+    fossil_cache_t* cache = fossil_cache_create("int", FOSSIL_CACHE_CLOCK, 2);
+    ASSUME_NOT_CNULL(cache);
+    fossil_cache_put(cache, fossil_tofu_create("int", "1"), fossil_tofu_create("int", "10"));
+    fossil_cache_put(cache, fossil_tofu_create("int", "2"), fossil_tofu_create("int", "20"));
+
+    // The referenced oldest entry survives and the hand evicts the next one
+    ASSUME_NOT_CNULL(fossil_cache_getter(cache, fossil_tofu_create("int", "1")));
+    fossil_cache_put(cache, fossil_tofu_create("int", "3"), fossil_tofu_create("int", "30"));
+    ASSUME_ITS_TRUE(fossil_cache_contains(cache, fossil_tofu_create("int", "1")));
+    ASSUME_ITS_FALSE(fossil_cache_contains(cache, fossil_tofu_create("int", "2")));
+    fossil_cache_erase(cache);
+}
+
+FOSSIL_TEST(test_cache_arc_budget_and_evict_callback) {
+    fossil_cache_t* cache = fossil_cache_create("int", FOSSIL_CACHE_ARC, 8);
+    ASSUME_NOT_CNULL(cache);
+    int evicted = 0;
+    fossil_cache_set_evict_callback(cache, test_cache_count_evictions, &evicted);
+    ASSUME_ITS_EQUAL_I32(-1, fossil_cache_set_budget(cache, 100, cnullptr, cnullptr));
+    ASSUME_ITS_EQUAL_I32(0, fossil_cache_set_budget(cache, 100, test_cache_value_bytes, cnullptr));
+
+    // Four 40-byte values cannot share a 100-byte budget
+    for (int64_t i = 0; i < 4; ++i) {
+        fossil_tofu_t key = fossil_tofu_create("int", "0");
+        key.value.int_val = i;
+        ASSUME_ITS_EQUAL_I32(0, fossil_cache_put(cache, key, fossil_tofu_create("int", "40")));
+    }
+    ASSUME_ITS_EQUAL_I32(-1, fossil_cache_put(cache, fossil_tofu_create("int", "9"), fossil_tofu_create("int", "101")));
+    ASSUME_ITS_EQUAL_SIZE(2, fossil_cache_size(cache));
+    ASSUME_ITS_EQUAL_SIZE(80, fossil_cache_bytes(cache));
+    ASSUME_ITS_EQUAL_I32(2, evicted);
+
+    // Replacing a value hands the old pair to the callback as well
+    fossil_cache_put(cache, fossil_tofu_create("int", "3"), fossil_tofu_create("int", "10"));
+    ASSUME_ITS_EQUAL_I32(3, evicted);
+    ASSUME_ITS_EQUAL_SIZE(50, fossil_cache_bytes(cache));
+    fossil_cache_erase(cache);
+    ASSUME_ITS_EQUAL_I32(5, evicted);
+}
+
+FOSSIL_TEST(test_cache_arc_budget_keeps_new_pair) {
+    fossil_cache_t* cache = fossil_cache_create("int", FOSSIL_CACHE_ARC, 8);
+    ASSUME_NOT_CNULL(cache);
+    ASSUME_ITS_EQUAL_I32(0, fossil_cache_set_budget(cache, 100, test_cache_value_bytes, cnullptr));
+
+    // Key 1 is alone in T1, the list ARC would shrink, so the budget must evict key 0 from T2
+    ASSUME_ITS_EQUAL_I32(0, fossil_cache_put(cache, fossil_tofu_create("int", "0"), fossil_tofu_create("int", "40")));
+    ASSUME_NOT_CNULL(fossil_cache_getter(cache, fossil_tofu_create("int", "0")));
+    ASSUME_ITS_EQUAL_I32(0, fossil_cache_put(cache, fossil_tofu_create("int", "1"), fossil_tofu_create("int", "70")));
+    ASSUME_ITS_TRUE(fossil_cache_contains(cache, fossil_tofu_create("int", "1")));
+    ASSUME_ITS_FALSE(fossil_cache_contains(cache, fossil_tofu_create("int", "0")));
+    ASSUME_ITS_EQUAL_SIZE(70, fossil_cache_bytes(cache));
+
+    // A ghost hit lands alone in T2 and must survive the budget as well
+    ASSUME_ITS_EQUAL_I32(0, fossil_cache_put(cache, fossil_tofu_create("int", "0"), fossil_tofu_create("int", "60")));
+    ASSUME_ITS_TRUE(fossil_cache_contains(cache, fossil_tofu_create("int", "0")));
+    ASSUME_ITS_FALSE(fossil_cache_contains(cache, fossil_tofu_create("int", "1")));
+    ASSUME_ITS_EQUAL_SIZE(60, fossil_cache_bytes(cache));
+    fossil_cache_erase(cache);
+}
+
+FOSSIL_TEST(test_cache_sharded_put_and_get) {
+    fossil_cache_sharded_t* cache = fossil_cache_sharded_create("int", FOSSIL_CACHE_LRU, 64, 3);
+    ASSUME_NOT_CNULL(cache);
+    ASSUME_ITS_EQUAL_SIZE(4, cache->shard_count);
+
+    for (int64_t i = 0; i < 16; ++i) {
+        fossil_tofu_t key = fossil_tofu_create("int", "0");
+        key.value.int_val = i;
+        ASSUME_ITS_EQUAL_I32(0, fossil_cache_sharded_put(cache, key, key));
+    }
+    fossil_tofu_t value;
+    ASSUME_ITS_EQUAL_I32(0, fossil_cache_sharded_get(cache, fossil_tofu_create("int", "7"), &value));
+    ASSUME_ITS_EQUAL_I32(7, value.value.int_val);
+    ASSUME_ITS_EQUAL_I32(-1, fossil_cache_sharded_get(cache, fossil_tofu_create("int", "99"), &value));
+    ASSUME_ITS_EQUAL_I32(0, fossil_cache_sharded_remove(cache, fossil_tofu_create("int", "7"), cnullptr));
+    ASSUME_ITS_EQUAL_SIZE(15, fossil_cache_sharded_size(cache));
+
+    fossil_cache_stats_t stats = fossil_cache_sharded_stats(cache);
+    ASSUME_ITS_EQUAL_SIZE(1, stats.hits);
+    ASSUME_ITS_EQUAL_SIZE(1, stats.misses);
+    fossil_cache_sharded_erase(cache);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Serialize
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_FIXTURE(struct_serialize_fixture);
+const char* mock_serialize_file = "serialize_test.bin";
+
+FOSSIL_SETUP(struct_serialize_fixture) {
+    // Setup code if needed
+}
+
+FOSSIL_TEARDOWN(struct_serialize_fixture) {
+    fossil_fstream_delete(mock_serialize_file);
+}
+
+FOSSIL_TEST(test_serialize_records_share_a_stream) {
+    fossil_vector_t* vector = fossil_vector_create("int");
+    fossil_vector_push_back(vector, fossil_tofu_create("int", "-42"));
+    fossil_vector_push_back(vector, fossil_tofu_create("cstr", "fossil"));
+    fossil_vector_push_back(vector, fossil_tofu_create("double", "2.5"));
+    fossil_tofu_t values[] = {
+        fossil_tofu_create("int", "30"), fossil_tofu_create("int", "10"), fossil_tofu_create("int", "20")
+    };
+    fossil_flatset_t* set = fossil_flatset_create_from("int", values, 3);
+    fossil_tofu_mapof_t map = fossil_tofu_mapof_create(1);
+    fossil_tofu_mapof_add(&map, fossil_tofu_create("int", "1"), fossil_tofu_create("cchar", "y"));
+
+    fossil_fstream_t stream;
+    ASSUME_ITS_EQUAL_I32(0, fossil_fstream_open(&stream, mock_serialize_file, "wb"));
+    ASSUME_ITS_EQUAL_I32(0, fossil_serialize_save_vector(&stream, vector));
+    ASSUME_ITS_EQUAL_I32(0, fossil_serialize_save_flatset(&stream, set));
+    ASSUME_ITS_EQUAL_I32(0, fossil_serialize_save_mapof(&stream, &map));
+    fossil_fstream_close(&stream);
+
+    // Loading copies every string, and each load stops at the end of its record
+    ASSUME_ITS_EQUAL_I32(0, fossil_fstream_open(&stream, mock_serialize_file, "rb"));
+    fossil_vector_t* loaded = fossil_serialize_load_vector(&stream, "int");
+    ASSUME_NOT_CNULL(loaded);
+    ASSUME_ITS_EQUAL_SIZE(3, loaded->size);
+    ASSUME_ITS_EQUAL_I32(-42, loaded->data[0].value.int_val);
+    ASSUME_ITS_TRUE(fossil_tofu_equals(vector->data[1], loaded->data[1]));
+    ASSUME_ITS_TRUE(loaded->data[1].value.c_string_val != vector->data[1].value.c_string_val);
+    ASSUME_ITS_TRUE(fossil_tofu_equals(vector->data[2], loaded->data[2]));
+    ASSUME_ITS_CNULL(fossil_serialize_load_vector(&stream, "int")); // Kind mismatch
+    fossil_fstream_close(&stream);
+
+    // A mapped file serves the same records without copying strings
+    fossil_serialize_buffer_t buffer;
+    ASSUME_ITS_EQUAL_I32(0, fossil_serialize_buffer_map(&buffer, mock_serialize_file));
+    fossil_vector_t* viewed = fossil_serialize_view_vector(&buffer, "int");
+    ASSUME_NOT_CNULL(viewed);
+    ASSUME_ITS_TRUE(fossil_tofu_equals(vector->data[1], viewed->data[1]));
+    ASSUME_ITS_TRUE((const uint8_t*)viewed->data[1].value.c_string_val > buffer.data);
+    fossil_flatset_t* viewed_set = fossil_serialize_view_flatset(&buffer, "int");
+    ASSUME_NOT_CNULL(viewed_set);
+    ASSUME_ITS_EQUAL_SIZE(3, fossil_flatset_size(viewed_set));
+    ASSUME_ITS_TRUE(fossil_flatset_contains(viewed_set, fossil_tofu_create("int", "20")));
+    fossil_tofu_mapof_t viewed_map;
+    ASSUME_ITS_EQUAL_I32(0, fossil_serialize_view_mapof(&buffer, &viewed_map));
+    ASSUME_ITS_EQUAL_SIZE(1, viewed_map.size);
+    ASSUME_ITS_EQUAL_I32('y', viewed_map.values[0].value.char_val);
+    ASSUME_ITS_EQUAL_SIZE(buffer.size, buffer.offset);
+
+    fossil_tofu_mapof_erase(&viewed_map);
+    fossil_flatset_erase(viewed_set);
+    fossil_vector_erase(viewed);
+    fossil_serialize_buffer_unmap(&buffer);
+
+    fossil_tofu_erase(&loaded->data[1]);
+    fossil_vector_erase(loaded);
+    fossil_tofu_erase(&vector->data[1]);
+    fossil_vector_erase(vector);
+    fossil_flatset_erase(set);
+    fossil_tofu_mapof_erase(&map);
+}
+
+FOSSIL_TEST(test_serialize_view_wide_string_ends_buffer) {
+    fossil_vector_t* vector = fossil_vector_create("int");
+    fossil_vector_push_back(vector, fossil_tofu_create("int", "7"));
+    fossil_vector_push_back(vector, fossil_tofu_create("wstr", (char*)L"wide"));
+
+    fossil_fstream_t stream;
+    ASSUME_ITS_EQUAL_I32(0, fossil_fstream_open(&stream, mock_serialize_file, "wb"));
+    ASSUME_ITS_EQUAL_I32(0, fossil_serialize_save_vector(&stream, vector));
+    fossil_fstream_close(&stream);
+
+    // The last code point of the wide string is the last byte of the buffer
+    fossil_serialize_buffer_t buffer;
+    ASSUME_ITS_EQUAL_I32(0, fossil_serialize_buffer_map(&buffer, mock_serialize_file));
+    fossil_vector_t* viewed = fossil_serialize_view_vector(&buffer, "int");
+    ASSUME_NOT_CNULL(viewed);
+    ASSUME_ITS_EQUAL_SIZE(2, viewed->size);
+    ASSUME_ITS_TRUE(fossil_tofu_equals(vector->data[1], viewed->data[1]));
+    ASSUME_ITS_EQUAL_SIZE(buffer.size, buffer.offset);
+
+    fossil_tofu_erase(&viewed->data[1]);
+    fossil_vector_erase(viewed);
+    fossil_serialize_buffer_unmap(&buffer);
+    fossil_tofu_erase(&vector->data[1]);
+    fossil_vector_erase(vector);
+}
+
+FOSSIL_TEST(test_serialize_load_rejects_oversized_string) {
+    fossil_vector_t* vector = fossil_vector_create("int");
+    fossil_vector_push_back(vector, fossil_tofu_create("cstr", "ab"));
+
+    fossil_fstream_t stream;
+    ASSUME_ITS_EQUAL_I32(0, fossil_fstream_open(&stream, mock_serialize_file, "wb"));
+    ASSUME_ITS_EQUAL_I32(0, fossil_serialize_save_vector(&stream, vector));
+    fossil_fstream_close(&stream);
+
+    uint8_t bytes[64];
+    ASSUME_ITS_EQUAL_I32(0, fossil_fstream_open(&stream, mock_serialize_file, "rb"));
+    size_t size = fossil_fstream_read(&stream, bytes, 1, sizeof(bytes));
+    fossil_fstream_close(&stream);
+
+    // Claim a terabyte for the string, whose length, "ab" and terminator end the record
+    const uint8_t claim[] = { 0x80, 0x80, 0x80, 0x80, 0x80, 0x20, 'a', 'b' };
+    ASSUME_ITS_EQUAL_I32(0, fossil_fstream_open(&stream, mock_serialize_file, "wb"));
+    fossil_fstream_write(&stream, bytes, 1, size - 4);
+    fossil_fstream_write(&stream, claim, 1, sizeof(claim));
+    fossil_fstream_close(&stream);
+
+    // Loading fails once the stream runs dry instead of allocating the claimed length
+    ASSUME_ITS_EQUAL_I32(0, fossil_fstream_open(&stream, mock_serialize_file, "rb"));
+    ASSUME_ITS_CNULL(fossil_serialize_load_vector(&stream, "int"));
+    fossil_fstream_close(&stream);
+
+    fossil_tofu_erase(&vector->data[0]);
+    fossil_vector_erase(vector);
+}
+
+FOSSIL_TEST(test_serialize_view_rejects_malformed_records) {
+    fossil_queue_t* queue = fossil_queue_create("int");
+    fossil_queue_insert(queue, fossil_tofu_create("int", "1"));
+    fossil_queue_insert(queue, fossil_tofu_create("int", "2"));
+
+    fossil_fstream_t stream;
+    ASSUME_ITS_EQUAL_I32(0, fossil_fstream_open(&stream, mock_serialize_file, "wb"));
+    ASSUME_ITS_EQUAL_I32(0, fossil_serialize_save_queue(&stream, queue));
+    fossil_fstream_close(&stream);
+
+    uint8_t bytes[64];
+    ASSUME_ITS_EQUAL_I32(0, fossil_fstream_open(&stream, mock_serialize_file, "rb"));
+    size_t size = fossil_fstream_read(&stream, bytes, 1, sizeof(bytes));
+    fossil_fstream_close(&stream);
+
+    fossil_serialize_buffer_t buffer;
+    fossil_serialize_buffer_init(&buffer, bytes, size);
+    fossil_queue_t* viewed = fossil_serialize_view_queue(&buffer, "int");
+    ASSUME_NOT_CNULL(viewed);
+    ASSUME_ITS_EQUAL_SIZE(2, fossil_queue_size(viewed));
+    ASSUME_ITS_EQUAL_I32(1, viewed->front->data.value.int_val);
+    fossil_queue_erase(viewed);
+
+    // A truncated record fails without moving the read position
+    fossil_serialize_buffer_init(&buffer, bytes, size - 1);
+    ASSUME_ITS_CNULL(fossil_serialize_view_queue(&buffer, "int"));
+    ASSUME_ITS_EQUAL_SIZE(0, buffer.offset);
+
+    // So does a record written by a newer format version
+    fossil_serialize_buffer_init(&buffer, bytes, size);
+    bytes[5] = FOSSIL_SERIALIZE_VERSION + 1;
+    ASSUME_ITS_CNULL(fossil_serialize_view_queue(&buffer, "int"));
+    ASSUME_ITS_EQUAL_SIZE(0, buffer.offset);
+
+    fossil_queue_erase(queue);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Intrusive
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_FIXTURE(struct_intrusive_fixture);
+
+// Record that can sit in one forward list and one doubly linked list or queue at a time
+typedef struct {
+    int id;
+    fossil_iflist_link_t flink;
+    fossil_idlist_link_t dlink;
+} test_intrusive_record_t;
+
+test_intrusive_record_t mock_records[5];
+
+FOSSIL_SETUP(struct_intrusive_fixture) {
+    for (int i = 0; i < 5; i++) {
+        mock_records[i].id = i;
+    }
+}
+
+FOSSIL_TEARDOWN(struct_intrusive_fixture) {
+    // Records are owned by the test, nothing to free
+}
+
+FOSSIL_TEST(test_idlist_unlink_from_anywhere) {
+    fossil_idlist_t list;
+    fossil_idlist_init(&list);
+    for (int i = 0; i < 5; i++) {
+        fossil_idlist_push_back(&list, &mock_records[i].dlink);
+    }
+    ASSUME_ITS_EQUAL_SIZE(5, fossil_idlist_size(&list));
+
+    // Unlink the middle, the head and the tail given only the records
+    fossil_idlist_remove(&list, &mock_records[2].dlink);
+    fossil_idlist_remove(&list, &mock_records[0].dlink);
+    fossil_idlist_remove(&list, &mock_records[4].dlink);
+    ASSUME_ITS_EQUAL_SIZE(2, fossil_idlist_size(&list));
+    ASSUME_ITS_TRUE(mock_records[2].dlink.next == cnullptr);
+
+    fossil_idlist_insert_after(&list, &mock_records[1].dlink, &mock_records[2].dlink);
+    fossil_idlist_push_front(&list, &mock_records[0].dlink);
+    int expected[] = {0, 1, 2, 3};
+    int index = 0;
+    for (fossil_idlist_link_t* link = list.head; link; link = link->next) {
+        ASSUME_ITS_EQUAL_I32(expected[index++], FOSSIL_CONTAINER_OF(link, test_intrusive_record_t, dlink)->id);
+    }
+    ASSUME_ITS_EQUAL_I32(4, index);
+    ASSUME_ITS_EQUAL_I32(3, FOSSIL_CONTAINER_OF(fossil_idlist_pop_back(&list), test_intrusive_record_t, dlink)->id);
+    ASSUME_ITS_TRUE(list.tail == &mock_records[2].dlink);
+}
+
+FOSSIL_TEST(test_iqueue_and_iflist_without_allocation) {
+    fossil_iqueue_t queue;
+    fossil_iqueue_init(&queue);
+    fossil_iflist_t list;
+    fossil_iflist_init(&list);
+    for (int i = 0; i < 5; i++) {
+        fossil_iqueue_insert(&queue, &mock_records[i].dlink);
+        fossil_iflist_push_front(&list, &mock_records[i].flink);
+    }
+
+    // Cancel one queued record, then drain in FIFO order
+    fossil_iqueue_unlink(&queue, &mock_records[1].dlink);
+    int expected[] = {0, 2, 3, 4};
+    for (int i = 0; i < 4; i++) {
+        fossil_idlist_link_t* link = fossil_iqueue_remove(&queue);
+        ASSUME_ITS_EQUAL_I32(expected[i], FOSSIL_CONTAINER_OF(link, test_intrusive_record_t, dlink)->id);
+    }
+    ASSUME_ITS_TRUE(fossil_iqueue_is_empty(&queue));
+    ASSUME_ITS_CNULL(fossil_iqueue_remove(&queue));
+
+    // The same records stay linked in the forward list through their other link
+    ASSUME_ITS_EQUAL_I32(0, fossil_iflist_remove(&list, &mock_records[3].flink));
+    ASSUME_ITS_EQUAL_I32(-1, fossil_iflist_remove(&list, &mock_records[3].flink));
+    fossil_iflist_reverse(&list);
+    ASSUME_ITS_EQUAL_SIZE(4, fossil_iflist_size(&list));
+    ASSUME_ITS_EQUAL_I32(0, FOSSIL_CONTAINER_OF(fossil_iflist_pop_front(&list), test_intrusive_record_t, flink)->id);
+    ASSUME_ITS_EQUAL_I32(1, FOSSIL_CONTAINER_OF(list.head, test_intrusive_record_t, flink)->id);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -710,6 +1593,13 @@ FOSSIL_TEST_GROUP(c_structure_tests) {
     ADD_TESTF(test_flist_remove, struct_flist_fixture);
     ADD_TESTF(test_flist_reverse_forward, struct_flist_fixture);
     ADD_TESTF(test_flist_reverse_backward, struct_flist_fixture);
+    ADD_TESTF(test_flist_unrolled_insert_at_and_remove_at, struct_flist_fixture);
+    ADD_TESTF(test_dlist_unrolled_insert_at_and_remove_at, struct_dlist_fixture);
+    ADD_TESTF(test_dlist_unrolled_cursor_walk, struct_dlist_fixture);
+
+    // Intrusive Fixture
+    ADD_TESTF(test_idlist_unlink_from_anywhere, struct_intrusive_fixture);
+    ADD_TESTF(test_iqueue_and_iflist_without_allocation, struct_intrusive_fixture);
 
     // Priority Queue Fixture
     ADD_TESTF(test_pqueue_create_and_erase, struct_pqueue_fixture);
@@ -717,11 +1607,16 @@ FOSSIL_TEST_GROUP(c_structure_tests) {
     ADD_TESTF(test_pqueue_remove, struct_pqueue_fixture);
     ADD_TESTF(test_pqueue_not_empty_and_is_empty, struct_pqueue_fixture);
 
+    // Persistent Vector Fixture
+    ADD_TESTF(test_pvector_versions_share_nodes, struct_pvector_fixture);
+    ADD_TESTF(test_pvector_transient_batch, struct_pvector_fixture);
+
     // Queue Fixture
     ADD_TESTF(test_queue_create_and_erase, struct_queue_fixture);
     ADD_TESTF(test_queue_insert_and_size, struct_queue_fixture);
     ADD_TESTF(test_queue_remove, struct_queue_fixture);
     ADD_TESTF(test_queue_not_empty_and_is_empty, struct_queue_fixture);
+    ADD_TESTF(test_queue_cursor_insert_after_and_erase, struct_queue_fixture);
 
     // Set Fixture
     ADD_TESTF(test_set_create_and_erase, struct_set_fixture);
@@ -733,8 +1628,35 @@ FOSSIL_TEST_GROUP(c_structure_tests) {
     ADD_TESTF(test_stack_create_and_erase, struct_stack_fixture);
     ADD_TESTF(test_stack_insert_and_size, struct_stack_fixture);
     ADD_TESTF(test_stack_remove, struct_stack_fixture);
+    ADD_TESTF(test_stack_array_push_pop_and_peek, struct_stack_fixture);
+    ADD_TESTF(test_stack_fixed_capacity, struct_stack_fixture);
+    ADD_TESTF(test_stack_linked_peek_and_spans, struct_stack_fixture);
 
     // Vector Fixture
     ADD_TESTF(test_vector_push_back, struct_vect_fixture);
     ADD_TESTF(test_vector_search, struct_vect_fixture);
+    ADD_TESTF(test_vector_reserve_and_shrink, struct_vect_fixture);
+    ADD_TESTF(test_vector_insert_and_remove, struct_vect_fixture);
+    ADD_TESTF(test_vector_resize_and_growth, struct_vect_fixture);
+    ADD_TESTF(test_vector_cursor_span_and_erase, struct_vect_fixture);
+
+    // Flat Set and Map Fixture
+    ADD_TESTF(test_flatset_insert_and_search, struct_flat_fixture);
+    ADD_TESTF(test_flatset_create_from_and_layouts, struct_flat_fixture);
+    ADD_TESTF(test_flatset_strings_eytzinger, struct_flat_fixture);
+    ADD_TESTF(test_flatmap_insert_and_getter, struct_flat_fixture);
+    ADD_TESTF(test_flatmap_create_from, struct_flat_fixture);
+
+    // Cache Fixture
+    ADD_TESTF(test_cache_lru_eviction_order, struct_cache_fixture);
+    ADD_TESTF(test_cache_clock_second_chance, struct_cache_fixture);
+    ADD_TESTF(test_cache_arc_budget_and_evict_callback, struct_cache_fixture);
+    ADD_TESTF(test_cache_arc_budget_keeps_new_pair, struct_cache_fixture);
+    ADD_TESTF(test_cache_sharded_put_and_get, struct_cache_fixture);
+
+    // Serialize Fixture
+    ADD_TESTF(test_serialize_records_share_a_stream, struct_serialize_fixture);
+    ADD_TESTF(test_serialize_view_wide_string_ends_buffer, struct_serialize_fixture);
+    ADD_TESTF(test_serialize_view_rejects_malformed_records, struct_serialize_fixture);
+    ADD_TESTF(test_serialize_load_rejects_oversized_string, struct_serialize_fixture);
 } // end of tests